@@ -8,9 +8,15 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ Metadata from the main bundle's info dictionary. It's read once, the first
+ time any of it is asked for, and shared from then on.
+ */
 @interface NSBundle (Stripe_AppName)
 
 + (nullable NSString*)stp_applicationName;
++ (nullable NSString*)stp_applicationVersion;
++ (nullable NSString*)stp_applicationBundleIdentifier;
 
 @end
 
@@ -8,10 +8,38 @@
 
 #import "NSBundle+Stripe_AppName.h"
 
+static NSString * const STPApplicationNameKey = @"name";
+static NSString * const STPApplicationVersionKey = @"version";
+static NSString * const STPApplicationBundleIdentifierKey = @"bundle_identifier";
+
 @implementation NSBundle (Stripe_AppName)
 
++ (NSDictionary<NSString *, NSString *> *)stp_applicationMetadata {
+    // None of this changes while the app is running.
+    static NSDictionary<NSString *, NSString *> *metadata;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSBundle *mainBundle = [self mainBundle];
+        NSDictionary *infoDictionary = [mainBundle infoDictionary];
+        NSMutableDictionary<NSString *, NSString *> *values = [NSMutableDictionary dictionary];
+        values[STPApplicationNameKey] = infoDictionary[(NSString *)kCFBundleNameKey];
+        values[STPApplicationVersionKey] = infoDictionary[@"CFBundleShortVersionString"];
+        values[STPApplicationBundleIdentifierKey] = mainBundle.bundleIdentifier;
+        metadata = [values copy];
+    });
+    return metadata;
+}
+
 + (nullable NSString *)stp_applicationName {
-    return [[self mainBundle] infoDictionary][(NSString *)kCFBundleNameKey];
+    return [self stp_applicationMetadata][STPApplicationNameKey];
+}
+
++ (nullable NSString *)stp_applicationVersion {
+    return [self stp_applicationMetadata][STPApplicationVersionKey];
+}
+
++ (nullable NSString *)stp_applicationBundleIdentifier {
+    return [self stp_applicationMetadata][STPApplicationBundleIdentifierKey];
 }
 
 @end
@@ -0,0 +1,24 @@
+//
+//  NSData+Stripe_Gzip.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface NSData (Stripe_Gzip)
+
+/**
+ The receiver compressed in the gzip format (RFC 1952), or nil if zlib fails.
+ */
+- (nullable NSData *)stp_gzippedData;
+
+@end
+
+void linkNSDataGzipCategory(void);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,43 @@
+//
+//  NSData+Stripe_Gzip.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "NSData+Stripe_Gzip.h"
+
+#import <zlib.h>
+
+// Adding 16 to the window bits asks zlib for a gzip header and trailer
+// instead of the zlib ones.
+static int const GzipWindowBits = MAX_WBITS + 16;
+static int const GzipMemoryLevel = 8;
+
+@implementation NSData (Stripe_Gzip)
+
+- (nullable NSData *)stp_gzippedData {
+    if (self.length > UINT_MAX) {
+        return nil;
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GzipWindowBits, GzipMemoryLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+    // deflateBound is enough room to finish in one call.
+    NSMutableData *output = [NSMutableData dataWithLength:deflateBound(&stream, (uLong)self.length)];
+    stream.next_in = (Bytef *)self.bytes;
+    stream.avail_in = (uInt)self.length;
+    stream.next_out = output.mutableBytes;
+    stream.avail_out = (uInt)output.length;
+    int status = deflate(&stream, Z_FINISH);
+    output.length = stream.total_out;
+    deflateEnd(&stream);
+    return (status == Z_STREAM_END) ? output : nil;
+}
+
+@end
+
+void linkNSDataGzipCategory(void){}
@@ -8,31 +8,95 @@
 
 #import "NSDecimalNumber+Stripe_Currency.h"
 
-@implementation NSDecimalNumber (Stripe_Currency)
+// Number of minor-unit digits for currencies that don't use the default of 2
+static NSDictionary<NSString *, NSNumber *> *stp_currencyExponents(void) {
+    static NSDictionary *exponents;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSArray *noDecimalCurrencies = @[@"bif", @"clp", @"djf", @"gnf",
+                                         @"jpy", @"kmf", @"krw", @"mga", @"pyg", @"rwf", @"vnd",
+                                         @"vuv", @"xaf", @"xof", @"xpf"];
+        NSMutableDictionary *table = [NSMutableDictionary dictionary];
+        for (NSString *currency in noDecimalCurrencies) {
+            table[currency] = @0;
+            table[currency.uppercaseString] = @0;
+        }
+        exponents = [table copy];
+    });
+    return exponents;
+}
 
-+ (NSArray *)stp_currenciesWithNoDecimal {
-    return @[@"bif", @"clp",@"djf",@"gnf",
-             @"jpy",@"kmf",@"krw",@"mga",@"pyg",@"rwf",@"vnd",
-             @"vuv",@"xaf",@"xof", @"xpf"];
+static short stp_exponentForCurrency(NSString *currency) {
+    if (currency == nil) {
+        return 2;
+    }
+    NSDictionary *exponents = stp_currencyExponents();
+    NSNumber *exponent = exponents[currency];
+    if (exponent == nil && currency.length == 3) {
+        // Mixed-case codes are the only ones that need a lowercased copy.
+        exponent = exponents[currency.lowercaseString];
+    }
+    return (exponent != nil) ? exponent.shortValue : 2;
 }
 
+static const unsigned long long stp_powersOf10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+static const int stp_maxPowerOf10 = (int)(sizeof(stp_powersOf10) / sizeof(stp_powersOf10[0])) - 1;
+
+/**
+ Converts `decimal * 10^shift` to an integer, truncating any fractional part.
+ Returns NO if the result doesn't fit in an NSInteger.
+ */
+static BOOL stp_integerFromDecimal(NSDecimal decimal, short shift, NSInteger *result) {
+    if (decimal._length == 0) {
+        // Zero, or NaN when _isNegative is set
+        *result = 0;
+        return !decimal._isNegative;
+    }
+    if (decimal._length > 4) {
+        return NO;
+    }
+    unsigned long long mantissa = 0;
+    for (int i = (int)decimal._length - 1; i >= 0; i--) {
+        mantissa = (mantissa << 16) | decimal._mantissa[i];
+    }
+    int exponent = decimal._exponent + shift;
+    if (exponent < 0) {
+        mantissa = (-exponent > stp_maxPowerOf10) ? 0 : mantissa / stp_powersOf10[-exponent];
+    } else if (exponent > 0) {
+        if (exponent > stp_maxPowerOf10 || mantissa > ULLONG_MAX / stp_powersOf10[exponent]) {
+            return NO;
+        }
+        mantissa *= stp_powersOf10[exponent];
+    }
+    if (mantissa > (unsigned long long)NSIntegerMax) {
+        return NO;
+    }
+    *result = decimal._isNegative ? -(NSInteger)mantissa : (NSInteger)mantissa;
+    return YES;
+}
+
+@implementation NSDecimalNumber (Stripe_Currency)
+
 + (NSDecimalNumber *)stp_decimalNumberWithAmount:(NSInteger)amount
                                         currency:(NSString *)currency {
-    NSArray *noDecimalCurrencies = [self stp_currenciesWithNoDecimal];
-    NSDecimalNumber *number = [self decimalNumberWithMantissa:amount exponent:0 isNegative:NO];
-    if ([noDecimalCurrencies containsObject:currency.lowercaseString]) {
-        return number;
-    }
-    return [number decimalNumberByMultiplyingByPowerOf10:-2];
+    BOOL isNegative = amount < 0;
+    unsigned long long mantissa = isNegative ? -(unsigned long long)amount : (unsigned long long)amount;
+    return [self decimalNumberWithMantissa:mantissa
+                                  exponent:-stp_exponentForCurrency(currency)
+                                isNegative:isNegative];
 }
 
 - (NSInteger)stp_amountWithCurrency:(NSString *)currency {
-    NSArray *noDecimalCurrencies = [[self class] stp_currenciesWithNoDecimal];
-    
-    NSDecimalNumber *ourNumber = self;
-    if (![noDecimalCurrencies containsObject:currency.lowercaseString]) {
-        ourNumber = [self decimalNumberByMultiplyingByPowerOf10:2];
+    NSInteger amount = 0;
+    if (stp_integerFromDecimal(self.decimalValue, stp_exponentForCurrency(currency), &amount)) {
+        return amount;
     }
+    NSDecimalNumber *ourNumber = [self decimalNumberByMultiplyingByPowerOf10:stp_exponentForCurrency(currency)];
     return (NSInteger)[ourNumber doubleValue];
 }
 
@@ -12,6 +12,14 @@
 
 - (nullable NSDictionary *)stp_dictionaryByRemovingNullsValidatingRequiredFields:(nonnull NSArray *)requiredFields;
 
+/**
+ Looks up a string in a table whose keys are all lowercase, ignoring the
+ string's case. API values are almost always lowercase already, so the exact
+ lookup is tried first and a lowercased copy is only made if that misses.
+ Returns nil for anything that isn't a string.
+ */
+- (nullable id)stp_objectForLowercaseKeyMatchingString:(nullable id)string;
+
 @end
 
 void linkNSDictionaryCategory(void);
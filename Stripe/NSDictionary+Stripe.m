@@ -8,21 +8,97 @@
 
 #import "NSDictionary+Stripe.h"
 
-@implementation NSDictionary (Stripe)
+/**
+ A read-only view of an API response that hides its NSNull values, so decoding
+ a response containing nulls doesn't have to copy it. Lookups go straight to
+ the wrapped dictionary; only counting and enumeration pay for skipping nulls.
+ */
+@interface STPNullFilteringDictionary : NSDictionary
+- (instancetype)initWithDictionary:(NSDictionary *)dictionary nullCount:(NSUInteger)nullCount;
+@end
 
-- (nullable NSDictionary *)stp_dictionaryByRemovingNullsValidatingRequiredFields:(nonnull NSArray *)requiredFields {
-    NSMutableDictionary *dict = [NSMutableDictionary dictionary];
-    [self enumerateKeysAndObjectsUsingBlock:^(id key, id obj, __unused BOOL *stop) {
-        if (obj != [NSNull null]) {
-            dict[key] = obj;
+@implementation STPNullFilteringDictionary {
+    NSDictionary *_dictionary;
+    NSUInteger _count;
+}
+
+- (instancetype)initWithDictionary:(NSDictionary *)dictionary nullCount:(NSUInteger)nullCount {
+    self = [super init];
+    if (self) {
+        _dictionary = [dictionary copy];
+        _count = dictionary.count - nullCount;
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return _count;
+}
+
+- (id)objectForKey:(id)key {
+    id object = [_dictionary objectForKey:key];
+    return (object == [NSNull null]) ? nil : object;
+}
+
+- (NSEnumerator *)keyEnumerator {
+    NSNull *null = [NSNull null];
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:_count];
+    [_dictionary enumerateKeysAndObjectsUsingBlock:^(id key, id obj, __unused BOOL *stop) {
+        if (obj != null) {
+            [keys addObject:key];
         }
     }];
+    return [keys objectEnumerator];
+}
+
+- (id)copyWithZone:(__unused NSZone *)zone {
+    return self;
+}
+
+@end
+
+@implementation NSDictionary (Stripe)
+
+- (nullable NSDictionary *)stp_dictionaryByRemovingNullsValidatingRequiredFields:(nonnull NSArray *)requiredFields {
+    // Check required fields with direct lookups before building anything, so
+    // an invalid response costs nothing to reject.
+    NSNull *null = [NSNull null];
     for (NSString *key in requiredFields) {
-        if (![[dict allKeys] containsObject:key]) {
+        id value = self[key];
+        if (!value || value == null) {
             return nil;
         }
     }
-    return [dict copy];
+    __block NSUInteger nullCount = 0;
+    [self enumerateKeysAndObjectsUsingBlock:^(__unused id key, id obj, __unused BOOL *stop) {
+        if (obj == null) {
+            nullCount++;
+        }
+    }];
+    if (nullCount == 0) {
+        // Copying an immutable dictionary just retains it.
+        return [self copy];
+    }
+    return [[STPNullFilteringDictionary alloc] initWithDictionary:self nullCount:nullCount];
+}
+
+- (nullable id)stp_objectForLowercaseKeyMatchingString:(nullable id)string {
+    if (![string isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    id object = self[string];
+    if (object) {
+        return object;
+    }
+    static NSCharacterSet *uppercaseLetters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        uppercaseLetters = [NSCharacterSet uppercaseLetterCharacterSet];
+    });
+    if ([(NSString *)string rangeOfCharacterFromSet:uppercaseLetters].location == NSNotFound) {
+        return nil;
+    }
+    return self[[(NSString *)string lowercaseString]];
 }
 
 @end
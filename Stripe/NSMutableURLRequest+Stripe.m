@@ -12,13 +12,22 @@
 @implementation NSMutableURLRequest (Stripe)
 
 - (void)stp_addParametersToURL:(NSDictionary *)parameters {
-    NSString *query = [STPFormEncoder queryStringFromParameters:parameters];
-    NSString *urlString = [self.URL absoluteString];
-    self.URL = [NSURL URLWithString:[urlString stringByAppendingFormat:self.URL.query ? @"&%@" : @"?%@", query]];
+    NSURLComponents *components = [NSURLComponents componentsWithURL:self.URL resolvingAgainstBaseURL:NO];
+    NSMutableData *query = [NSMutableData data];
+    NSString *existingQuery = components.percentEncodedQuery;
+    if (existingQuery) {
+        [query appendData:[existingQuery dataUsingEncoding:NSASCIIStringEncoding]];
+        [query appendBytes:"&" length:1];
+    }
+    // The encoder escapes everything that isn't valid in a query, so its
+    // output can be handed over as-is without being parsed again.
+    [STPFormEncoder appendFormDataFromParameters:parameters toData:query];
+    components.percentEncodedQuery = [[NSString alloc] initWithData:query encoding:NSASCIIStringEncoding];
+    self.URL = components.URL;
 }
 
 - (void)stp_setFormPayload:(NSDictionary *)formPayload {
-    NSData *formData = [[STPFormEncoder queryStringFromParameters:formPayload] dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *formData = [STPFormEncoder formDataFromParameters:formPayload];
     self.HTTPBody = formData;
     [self setValue:[NSString stringWithFormat:@"%lu", (unsigned long)formData.length] forHTTPHeaderField:@"Content-Length"];
     [self setValue:@"application/x-www-form-urlencoded" forHTTPHeaderField:@"Content-Type"];
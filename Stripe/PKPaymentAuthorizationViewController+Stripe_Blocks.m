@@ -10,6 +10,7 @@
 
 #import "PKPaymentAuthorizationViewController+Stripe_Blocks.h"
 #import "STPAPIClient+ApplePay.h"
+#import "STPAddress+Private.h"
 
 FAUXPAS_IGNORED_IN_FILE(APIAvailability)
 
@@ -26,6 +27,10 @@ typedef void (^STPApplePayShippingAddressCompletionBlock)(PKPaymentAuthorization
 @property (nonatomic, copy) STPApplePayTokenHandlerBlock onTokenCreation;
 @property (nonatomic, copy) STPPaymentCompletionBlock onFinish;
 @property (nonatomic) NSError *lastError;
+// The last shipping contact from the sheet, and an address made from it that's
+// kept to ourselves, so the next contact only converts the fields that changed
+@property (nonatomic) PKContact *lastShippingContact;
+@property (nonatomic) STPAddress *lastShippingAddress;
 @property (nonatomic) BOOL didSucceed;
 @end
 
@@ -35,7 +40,8 @@ typedef void (^STPPaymentAuthorizationStatusCallback)(PKPaymentAuthorizationStat
 
 - (void)paymentAuthorizationViewController:(__unused PKPaymentAuthorizationViewController *)controller
                        didAuthorizePayment:(PKPayment *)payment completion:(STPPaymentAuthorizationStatusCallback)completion {
-    self.onPaymentAuthorization(payment);
+    // Start the token request first, so that it's in flight while the host
+    // updates its shipping details and summary.
     [self.apiClient createTokenWithPayment:payment completion:^(STPToken * _Nullable token, NSError * _Nullable error) {
         if (error) {
             self.lastError = error;
@@ -52,6 +58,7 @@ typedef void (^STPPaymentAuthorizationStatusCallback)(PKPaymentAuthorizationStat
             completion(PKPaymentAuthorizationStatusSuccess);
         });
     }];
+    self.onPaymentAuthorization(payment);
 }
 
 - (void)paymentAuthorizationViewController:(__unused PKPaymentAuthorizationViewController *)controller
@@ -65,7 +72,13 @@ typedef void (^STPPaymentAuthorizationStatusCallback)(PKPaymentAuthorizationStat
 - (void)paymentAuthorizationViewController:(__unused PKPaymentAuthorizationViewController *)controller
                   didSelectShippingContact:(PKContact *)contact
                                 completion:(STPApplePayShippingAddressCompletionBlock)completion {
-    STPAddress *stpAddress = [[STPAddress alloc] initWithPKContact:contact];
+    STPAddress *stpAddress = [[STPAddress alloc] initWithPKContact:contact
+                                                   previousContact:self.lastShippingContact
+                                                   previousAddress:self.lastShippingAddress];
+    self.lastShippingContact = contact;
+    self.lastShippingAddress = [[STPAddress alloc] initWithPKContact:contact
+                                                      previousContact:contact
+                                                      previousAddress:stpAddress];
     self.onShippingAddressSelection(stpAddress, ^(STPShippingStatus status, NSArray<PKShippingMethod *>* shippingMethods, NSArray<PKPaymentSummaryItem*> *summaryItems) {
         if (status == STPShippingStatusInvalid) {
             completion(PKPaymentAuthorizationStatusInvalidShippingPostalAddress, shippingMethods, summaryItems);
@@ -18,7 +18,82 @@ FAUXPAS_IGNORED_IN_FILE(APIAvailability)
 
 static NSString *const STPSDKVersion = @"10.0.1";
 
-@class STPBankAccount, STPBankAccountParams, STPCard, STPCardParams, STPSourceParams, STPToken, STPPaymentConfiguration;
+/**
+ *  How many requests `-[STPAPIClient createTokensWithCards:maxConcurrentRequests:itemCompletion:completion:]` keeps in flight when passed 0.
+ */
+FOUNDATION_EXPORT NSUInteger const STPTokenBatchDefaultMaxConcurrentRequests;
+
+@class STPAPIClient, STPAPIRequestMetrics, STPBankAccount, STPBankAccountParams, STPCard, STPCardParams, STPSource, STPSourceParams, STPToken, STPPaymentConfiguration, STPPerformanceSnapshot;
+
+/**
+ *  Receives timing information for the requests an STPAPIClient makes, e.g. to report them to your own monitoring.
+ */
+@protocol STPAPIClientMetricsDelegate <NSObject>
+
+/**
+ *  Called once for every request made by `apiClient`, on its completion queue, after the request's completion block has been called.
+ *
+ *  @param apiClient The client that made the request.
+ *  @param metrics   How long the request spent in each stage. Network stages are only measured on iOS 10 and later, and are 0 before that.
+ */
+- (void)apiClient:(STPAPIClient *)apiClient didFinishRequestWithMetrics:(STPAPIRequestMetrics *)metrics;
+
+@end
+
+/**
+ *  Hears how sources queued with `-[STPAPIClient enqueueSourceWithParams:]` turned out.
+ */
+@protocol STPAPIClientSourceQueueDelegate <NSObject>
+
+/**
+ *  Called on the client's completion queue once a queued source has been created.
+ *
+ *  @param apiClient  The client the source was queued with.
+ *  @param source     The source that was created.
+ *  @param identifier The identifier `enqueueSourceWithParams:` returned for it.
+ */
+- (void)apiClient:(STPAPIClient *)apiClient didCreateQueuedSource:(STPSource *)source identifier:(NSString *)identifier;
+
+/**
+ *  Called on the client's completion queue if Stripe declined to create a queued source, e.g. because its details were invalid. The source is removed from the queue. Network errors never end up here; the source stays queued until it can be sent.
+ *
+ *  @param apiClient  The client the source was queued with.
+ *  @param identifier The identifier `enqueueSourceWithParams:` returned for it.
+ *  @param error      Why the source wasn't created.
+ */
+- (void)apiClient:(STPAPIClient *)apiClient didFailToCreateQueuedSourceWithIdentifier:(NSString *)identifier error:(NSError *)error;
+
+@end
+
+/**
+ *  Hears how sources polled with `-[STPAPIClient startPollingSourceWithId:clientSecret:timeout:completion:]` turned out when the poll finished in the background.
+ */
+@protocol STPAPIClientBackgroundPollingDelegate <NSObject>
+
+/**
+ *  Called on the client's completion queue when a source checked in the background has left the pending state, or its background checks ran out of time, and the poll that started them is no longer running, e.g. because the app was relaunched in the background. A poll that is still running gets the source in its completion block instead, and this isn't called.
+ *
+ *  @param apiClient The client the poll was started with.
+ *  @param source    The latest copy of the source.
+ */
+- (void)apiClient:(STPAPIClient *)apiClient didFinishPollingSourceInBackground:(STPSource *)source;
+
+@end
+
+/**
+ *  Hears about SDK work that held up the main thread for longer than the budget set with `+[Stripe setMainThreadWatchdogDelegate:budget:]`, e.g. to find what's behind dropped frames in your own monitoring.
+ */
+@protocol STPMainThreadWatchdogDelegate <NSObject>
+
+/**
+ *  Called on the main thread, right after the work finished.
+ *
+ *  @param label    What the work was, e.g. `-[STPAddCardViewController createAndSetupViews]`. Blocks are labelled with the symbol of their code, e.g. `__41-[STPPaymentContext didAppear]_block_invoke`, or with its address if the symbol isn't available.
+ *  @param duration How long the work took, in seconds. Work that runs inside other measured work is reported on its own as well as counting towards the outer work.
+ */
+- (void)mainThreadWatchdogDidObserveWork:(NSString *)label duration:(NSTimeInterval)duration;
+
+@end
 
 /**
  A top-level class that imports the rest of the Stripe SDK.
@@ -43,6 +118,67 @@ static NSString *const STPSDKVersion = @"10.0.1";
  */
 + (void)disableAnalytics;
 
+/**
+ *  Puts the SDK in a mode for app extensions, such as iMessage apps and widgets, that only create tokens and sources within tight memory limits. Call this once, before anything else in the SDK, e.g. in your extension's principal class.
+ *
+ *  In extension mode:
+ *  - Analytics and performance timings are disabled, as with `disableAnalytics`, and their upload queue, file and URL session are never created.
+ *  - The SDK never looks up `UIApplication`, so it doesn't ask for background time.
+ *  - Each host's URL session keeps no response cache, and source polling is never set up. Tokenizing only ever uses the one session, for api.stripe.com.
+ *
+ *  The SDK then holds no state that grows with the number of requests. Tokenizing adds well under 1 MB to your extension's footprint on top of the SDK's code, the URL session's own buffers and the responses you keep. Using the prebuilt UI, e.g. STPPaymentCardTextField, adds the memory for its images and views on top of that.
+ */
++ (void)enableExtensionMode;
+
+/**
+ *  Loads the SDK's resource bundle, string table, default theme, card images and country list on a background queue, so that the first STPAddCardViewController, STPPaymentCardTextField or address form you show doesn't have to do this work on the main thread. Call this early, e.g. from your app delegate. This is optional; resources are otherwise loaded the first time they are needed.
+ *
+ *  @param completion Called on the main queue once the resources are ready. May be nil.
+ */
++ (void)prepareResourcesWithCompletion:(nullable void (^)(void))completion;
+
+/**
+ *  Keeps the card brand ranges used by STPCardValidator and STPPaymentCardTextField up to date from a table hosted at `url`, on top of the ranges built into the SDK, so new ranges don't have to wait for an SDK update. The last good copy of the table is saved on the device and used from the next launch on. This is optional; without it, only the built-in ranges are used.
+ *
+ *  @param url Where to fetch the table from. The table is checksummed and is ignored unless it checks out. Only the first call has any effect.
+ */
++ (void)enableRemoteBINRangesWithURL:(NSURL *)url;
+
+/**
+ *  Pins the public keys that the SDK's connections to `host` must present, e.g. `api.stripe.com`. A connection is only used if its certificate chain is valid and one of its certificates has one of these keys; otherwise its requests fail with `NSURLErrorCancelled`. A chain that passed is remembered for an hour, so later connections presenting the same certificates skip evaluating them again. Pins are checked from iOS 10 on; earlier versions can't read a certificate's public key, and use the default evaluation. Background source polling also uses the default evaluation. Pin more than one key, e.g. a backup, so that a certificate change doesn't cut off your app.
+ *
+ *  @param hashes Base64 SHA-256 hashes of each key's SubjectPublicKeyInfo, the `pin-sha256` format of RFC 7469. Keys must be RSA (2048 or 4096 bits) or EC (P-256 or P-384). Pass nil to remove the pins.
+ *  @param host   The host to pin.
+ */
++ (void)setPinnedPublicKeyHashes:(nullable NSArray<NSString *> *)hashes forHost:(NSString *)host;
+
+/**
+ *  Unless analytics are disabled, the SDK times its API requests on the device, and every few minutes reports a summary of the timings (counts and percentiles, not individual requests) with its other analytics. This sets the fraction of requests that are timed.
+ *
+ *  @param sampleRate From 0 (none) to 1 (all, the default).
+ */
++ (void)setNetworkPerformanceSampleRate:(double)sampleRate;
+
+/**
+ *  Like `setNetworkPerformanceSampleRate:`, for how long the SDK's screens take to appear and to add a card.
+ *
+ *  @param sampleRate From 0 (none) to 1 (all, the default).
+ */
++ (void)setInterfacePerformanceSampleRate:(double)sampleRate;
+
+/**
+ *  Counts of the work the SDK has done since the app launched, e.g. requests made and their bytes, time spent decoding responses and image cache hits. Unlike the performance timings above, these are always kept, are never sent anywhere, and are cheap enough to read as often as you like.
+ */
++ (STPPerformanceSnapshot *)performanceSnapshot;
+
+/**
+ *  Times the SDK's work on the main thread, i.e. its main queue callbacks, including API responses and STPPaymentContext delegate calls, and its view controllers setting up their views and appearance, and reports any that takes longer than `budget` to `delegate`. This is off by default, and while it's off measuring costs a single atomic load; while it's on, it costs two clock reads per piece of work. It's fine to turn on in release builds.
+ *
+ *  @param delegate Receives the reports, and is held weakly. Pass nil to turn the watchdog off.
+ *  @param budget   How long work can take, in seconds, before it's reported, e.g. 0.008 for half a frame at 60 fps.
+ */
++ (void)setMainThreadWatchdogDelegate:(nullable id<STPMainThreadWatchdogDelegate>)delegate budget:(NSTimeInterval)budget;
+
 @end
 
 /// A client for making connections to the Stripe API.
@@ -52,6 +188,16 @@ static NSString *const STPSDKVersion = @"10.0.1";
  *  A shared singleton API client. Its API key will be initially equal to [Stripe defaultPublishableKey].
  */
 + (instancetype)sharedClient;
+
+/**
+ *  Returns a client for `publishableKey`, e.g. for a connected account's key, creating it the first time it's asked for. Later calls with the same key return the same client, from any thread, so switching between accounts costs a dictionary lookup. All clients share the SDK's connections to the API, whichever way they were created. The most recently used clients are kept; one that hasn't been used in a while may be released and recreated.
+ *
+ *  The clients are shared, so don't change their publishable key or configuration. A client whose key has changed is replaced the next time its original key is asked for.
+ *
+ *  @param publishableKey The publishable key to make requests with.
+ */
++ (instancetype)clientWithPublishableKey:(NSString *)publishableKey;
+
 - (instancetype)initWithConfiguration:(STPPaymentConfiguration *)configuration NS_DESIGNATED_INITIALIZER;
 - (instancetype)initWithPublishableKey:(NSString *)publishableKey;
 
@@ -65,6 +211,51 @@ static NSString *const STPSDKVersion = @"10.0.1";
  */
 @property (nonatomic, copy) STPPaymentConfiguration *configuration;
 
+/**
+ *  The queue that API responses are parsed and decoded into model objects on. If nil (the default), responses are decoded on the client's URL session delegate queue, which is never the main queue.
+ */
+@property (nonatomic, strong, nullable) dispatch_queue_t decodeQueue;
+
+/**
+ *  The queue that completion blocks passed to this client are called on. Defaults to the main queue. If you set this to another queue, make sure that your completion blocks dispatch back to the main queue before updating any UI.
+ */
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+
+/**
+ *  If set, this client reports how long each of its requests took to the delegate. Requests aren't timed while this is nil.
+ */
+@property (nonatomic, weak, nullable) id<STPAPIClientMetricsDelegate> metricsDelegate;
+
+/**
+ *  If YES, POST bodies of 1KB or more, like sources with large `metadata` or `owner` details, are gzipped and sent with a `Content-Encoding: gzip` header, as long as that makes them smaller. Only turn this on if the server you're sending requests to accepts compressed request bodies. Defaults to NO.
+ */
+@property (nonatomic) BOOL compressesRequestBodies;
+
+/**
+ *  If YES, a source retrieval that is slower than most recent responses from the Stripe API is sent a second time, and whichever copy answers first is used. Retrieving a source has no side effects, so this only costs an occasional extra request, in exchange for a faster answer on a network that sometimes stalls, e.g. while polling a source. Defaults to NO.
+ */
+@property (nonatomic) BOOL hedgesSourceRetrievals;
+
+/**
+ *  If YES, sources polled with `startPollingSourceWithId:clientSecret:timeout:completion:` are checked with long polls: each request asks the server, with a `Prefer: wait` header, to hold its answer until the source changes, so the result arrives as soon as it's ready with fewer requests. Polling falls back to a timer if the server doesn't honor the header. Defaults to NO, which polls on a timer.
+ */
+@property (nonatomic) BOOL longPollsSources NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions");
+
+/**
+ *  Told about the results of sources queued with `enqueueSourceWithParams:`. Queued sources are saved across launches, so set this early, e.g. in your app delegate; setting it starts sending any sources left over from the last launch.
+ */
+@property (nonatomic, weak, nullable) id<STPAPIClientSourceQueueDelegate> sourceQueueDelegate;
+
+/**
+ *  Setting this turns on background polling: when the app leaves the foreground, sources being polled with `startPollingSourceWithId:clientSecret:timeout:completion:` keep being checked for up to an hour with a background URL session, as the system sees fit, and the app is woken or relaunched with the result. The result is passed to the poll's completion block if it's still running, so nothing has to be fetched again when the app returns to the foreground, or to this delegate otherwise. Results are saved across launches, so set this early, e.g. in your app delegate, and call `+[Stripe handleEventsForBackgroundURLSession:completionHandler:]` from `application:handleEventsForBackgroundURLSession:completionHandler:`.
+ */
+@property (nonatomic, weak, nullable) id<STPAPIClientBackgroundPollingDelegate> backgroundPollingDelegate NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions");
+
+/**
+ *  Opens a connection to the Stripe API ahead of time, so that DNS lookup and TCP and TLS setup don't add latency to the next request made with this client, e.g. when your user taps your pay button. This makes a single lightweight request, and does nothing if a previous call is still in progress. STPAddCardViewController and STPPaymentContext call this automatically when they are shown.
+ */
+- (void)prewarmConnection;
+
 @end
 
 #pragma mark Bank Accounts
@@ -79,8 +270,10 @@ static NSString *const STPSDKVersion = @"10.0.1";
  *
  *  @param bankAccount The user's bank account details. Cannot be nil. @see https://stripe.com/docs/api#create_bank_account_token
  *  @param completion  The callback to run with the returned Stripe token (and any errors that may have occurred).
+ *
+ *  @return The task carrying the request. Cancel it to abandon the request; `completion` is then called with an `NSURLErrorCancelled` error.
  */
-- (void)createTokenWithBankAccount:(STPBankAccountParams *)bankAccount completion:(__nullable STPTokenCompletionBlock)completion;
+- (NSURLSessionDataTask *)createTokenWithBankAccount:(STPBankAccountParams *)bankAccount completion:(__nullable STPTokenCompletionBlock)completion;
 
 @end
 
@@ -96,8 +289,27 @@ static NSString *const STPSDKVersion = @"10.0.1";
  *
  *  @param card        The user's card details. Cannot be nil. @see https://stripe.com/docs/api#create_card_token
  *  @param completion  The callback to run with the returned Stripe token (and any errors that may have occurred).
+ *
+ *  @return The task carrying the request. Cancel it to abandon the request; `completion` is then called with an `NSURLErrorCancelled` error.
+ */
+- (NSURLSessionDataTask *)createTokenWithCard:(STPCardParams *)card completion:(nullable STPTokenCompletionBlock)completion;
+
+/**
+ *  Converts many cards into Stripe tokens, e.g. to import cards a customer already has on file. Requests are sent over the client's
+ *  shared session with at most `maxConcurrentRequests` in flight, and analytics are logged once for the whole batch.
+ *
+ *  @param cards                 The cards to tokenize. Cannot be nil.
+ *  @param maxConcurrentRequests How many requests may be in flight at once. Pass 0 to use `STPTokenBatchDefaultMaxConcurrentRequests`.
+ *  @param itemCompletion        The callback to run as each card is tokenized, in the order the responses arrive.
+ *  @param completion            The callback to run with a result for every card once the batch is done.
+ *
+ *  @return The batch's progress, counting the cards that have a result. Cancel it to abandon the batch; cards that haven't been tokenized
+ *  yet get an `NSURLErrorCancelled` error.
  */
-- (void)createTokenWithCard:(STPCardParams *)card completion:(nullable STPTokenCompletionBlock)completion;
+- (NSProgress *)createTokensWithCards:(NSArray<STPCardParams *> *)cards
+                maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                       itemCompletion:(nullable STPTokenBatchItemCompletionBlock)itemCompletion
+                           completion:(STPTokenBatchCompletionBlock)completion;
 
 @end
 
@@ -134,6 +346,20 @@ static NSString *const STPSDKVersion = @"10.0.1";
 
 #pragma mark Sources
 
+/**
+ *  Whether a source retrieval may be answered from the API client's cache of recently created and retrieved sources.
+ */
+typedef NS_ENUM(NSInteger, STPSourceCachePolicy) {
+    /**
+     *  Always fetch the source from Stripe.
+     */
+    STPSourceCachePolicyReloadIgnoringCache,
+    /**
+     *  Use a copy of the source created or retrieved by this client within the last 30 seconds, and only fetch the source if there isn't one.
+     */
+    STPSourceCachePolicyReturnCacheElseLoad,
+};
+
 /**
  *  STPAPIClient extensions for working with Source objects
  */
@@ -144,8 +370,34 @@ static NSString *const STPSDKVersion = @"10.0.1";
  *
  *  @param params      The details of the source to create. Cannot be nil. @see https://stripe.com/docs/api#create_source
  *  @param completion  The callback to run with the returned Source object, or an error.
+ *
+ *  @return The task carrying the request. Cancel it to abandon the request; `completion` is then called with an `NSURLErrorCancelled` error.
+ */
+- (NSURLSessionDataTask *)createSourceWithParams:(STPSourceParams *)params completion:(STPSourceCompletionBlock)completion;
+
+/**
+ *  Queues a source to be created as soon as the Stripe API can be reached, rather than failing while the device is offline. This suits reusable sources, like SEPA Debit, collected somewhere without a connection. Queued sources are saved to disk until they're sent, and each is created at most once, however many times it has to be retried. The result is reported to `sourceQueueDelegate`.
+ *
+ *  @param params The details of the source to create. Cannot be nil.
+ *
+ *  @return An identifier for the queued source, which is passed to `sourceQueueDelegate` along with the result.
  */
-- (void)createSourceWithParams:(STPSourceParams *)params completion:(STPSourceCompletionBlock)completion;
+- (NSString *)enqueueSourceWithParams:(STPSourceParams *)params;
+
+/**
+ *  Creates a card source and then, unless the card doesn't support 3D Secure, a 3D Secure source for it, reporting both in one callback. The second request is sent as soon as the card source is decoded, on the connection the first request opened, rather than after a hop back through your code. @see https://stripe.com/docs/sources/three-d-secure
+ *
+ *  @param card        The user's card details. Cannot be nil.
+ *  @param amount      The amount to charge the customer.
+ *  @param currency    The currency the payment is being created in.
+ *  @param returnURL   The URL the customer should be redirected to after they have successfully verified the payment.
+ *  @param completion  The callback to run with both sources and how long each request took.
+ */
+- (void)createThreeDSecureSourceWithCard:(STPCardParams *)card
+                                  amount:(NSUInteger)amount
+                                currency:(NSString *)currency
+                               returnURL:(NSString *)returnURL
+                              completion:(STPThreeDSecureSourceCompletionBlock)completion;
 
 /**
  *  Retrieves the Source object with the given ID. @see https://stripe.com/docs/api#retrieve_source
@@ -156,6 +408,16 @@ static NSString *const STPSDKVersion = @"10.0.1";
  */
 - (void)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret completion:(STPSourceCompletionBlock)completion;
 
+/**
+ *  Retrieves the Source object with the given ID, from the client's cache if `cachePolicy` allows it. The client remembers the last 32 sources it created, retrieved or polled, so screens showing the same source one after the other don't each wait for the network. @see https://stripe.com/docs/api#retrieve_source
+ *
+ *  @param identifier  The identifier of the source to be retrieved. Cannot be nil.
+ *  @param secret      The client secret of the source. Cannot be nil. A cached source is only used if it has the same client secret.
+ *  @param cachePolicy Whether a cached copy of the source may be used.
+ *  @param completion  The callback to run with the returned Source object, or an error.
+ */
+- (void)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret cachePolicy:(STPSourceCachePolicy)cachePolicy completion:(STPSourceCompletionBlock)completion;
+
 /**
  *  Starts polling the Source object with the given ID. For payment methods that require
  *  additional customer action (e.g. authorizing a payment with their bank), polling
@@ -168,6 +430,9 @@ static NSString *const STPSDKVersion = @"10.0.1";
  *  Note that if a poll is already running for a source, subsequent calls to `startPolling`
  *  with the same source ID will do nothing.
  *
+ *  A client polls at most 32 sources at once. Starting another ends the oldest poll, whose
+ *  completion is called with its latest source and an `STPCancellationError`.
+ *
  *  @param identifier  The identifier of the source to be retrieved. Cannot be nil.
  *  @param secret      The client secret of the source. Cannot be nil.
  *  @param timeout     The timeout for the polling operation, in seconds. Timeouts are capped at 5 minutes.
@@ -183,6 +448,20 @@ static NSString *const STPSDKVersion = @"10.0.1";
  */
 - (void)stopPollingSourceWithId:(NSString *)identifier NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions");;
 
+/**
+ *  Whether to save the state of each source poll on the device as it goes. When this is on, a poll started with `startPollingSourceWithId:clientSecret:timeout:completion:` for a source whose poll didn't finish before the app was terminated, e.g. during a redirect, picks up where it left off: it keeps its original start time, so its timeout covers the time it had left, and its retry count and poll interval. Defaults to NO. Saved states are removed after a day.
+ */
+@property (nonatomic) BOOL persistsSourcePollingState;
+
+/**
+ *  The latest copy of a source fetched by a poll, saved while `persistsSourcePollingState` was on, including in an earlier launch. Use this to show the source's last known status right away, e.g. while `startPollingSourceWithId:clientSecret:timeout:completion:` resumes its poll.
+ *
+ *  @param identifier The identifier of the source.
+ *
+ *  @return The saved source, or nil if there isn't one.
+ */
+- (nullable STPSource *)cachedSourceWithId:(NSString *)identifier;
+
 @end
 
 #pragma mark URL callbacks
@@ -212,4 +491,20 @@ static NSString *const STPSDKVersion = @"10.0.1";
 
 @end
 
+#pragma mark Background sessions
+
+@interface Stripe (STPBackgroundPollingAdditions)
+
+/**
+ *  Call this method from your app delegate's `application:handleEventsForBackgroundURLSession:completionHandler:`, so that sources polled in the background (see `-[STPAPIClient backgroundPollingDelegate]`) can be delivered when the system wakes your app.
+ *
+ *  @param identifier        The identifier of the session your app delegate was given.
+ *  @param completionHandler The completion handler your app delegate was given. Stripe calls it once the session's events have been handled.
+ *
+ *  @return YES if the session is Stripe's and the completion handler will be called. NO otherwise, in which case your app should handle the session itself.
+ */
++ (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier completionHandler:(void (^)(void))completionHandler NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions");
+
+@end
+
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,90 @@
+//
+//  STPAPIRequestMetrics.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Timings for a single request an STPAPIClient made to the Stripe API, from building the request to calling your completion block. Network phases come from `NSURLSessionTaskMetrics`, so they are only available on iOS 10 and later; on earlier versions, and for phases that didn't happen (e.g. DNS and connection setup when an existing connection was reused), they are 0. All durations are in seconds.
+ */
+@interface STPAPIRequestMetrics : NSObject
+
+/**
+ *  The HTTP method of the request, e.g. `POST`.
+ */
+@property (nonatomic, readonly) NSString *HTTPMethod;
+
+/**
+ *  The API endpoint the request was made to, e.g. `tokens` or `sources/src_123`.
+ */
+@property (nonatomic, readonly) NSString *endpoint;
+
+/**
+ *  The HTTP status code of the response, or 0 if no response was received.
+ */
+@property (nonatomic, readonly) NSInteger statusCode;
+
+/**
+ *  The error the request failed with, if any.
+ */
+@property (nonatomic, readonly, nullable) NSError *error;
+
+/**
+ *  Whether the request was sent over a connection that was already open.
+ */
+@property (nonatomic, readonly) BOOL reusedConnection;
+
+/**
+ *  Time spent resolving the API host.
+ */
+@property (nonatomic, readonly) NSTimeInterval domainLookupDuration;
+
+/**
+ *  Time spent opening the connection, including the TLS handshake.
+ */
+@property (nonatomic, readonly) NSTimeInterval connectDuration;
+
+/**
+ *  The part of `connectDuration` spent on the TLS handshake.
+ */
+@property (nonatomic, readonly) NSTimeInterval secureConnectionDuration;
+
+/**
+ *  Time from sending the request to receiving the first byte of the response.
+ */
+@property (nonatomic, readonly) NSTimeInterval timeToFirstByte;
+
+/**
+ *  Time from the first byte of the response to the last.
+ */
+@property (nonatomic, readonly) NSTimeInterval transferDuration;
+
+/**
+ *  Time spent parsing the response and decoding it into model objects.
+ */
+@property (nonatomic, readonly) NSTimeInterval decodeDuration;
+
+/**
+ *  Time the decoded response waited for the completion queue (usually the main queue) before your completion block ran.
+ */
+@property (nonatomic, readonly) NSTimeInterval completionDispatchDelay;
+
+/**
+ *  Time from starting the request to calling your completion block.
+ */
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+
+/**
+ *  The underlying metrics collected by the URL session, for anything not summarized above. Nil before iOS 10, and when the session hadn't delivered them by the time the request finished; the network phases above are 0 in that case.
+ */
+@property (nonatomic, readonly, nullable) NSURLSessionTaskMetrics *taskMetrics NS_AVAILABLE_IOS(10_0);
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -55,6 +55,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, copy, nullable)NSString *managedAccountCurrency;
 
+/**
+ Returns the form to the state it was in when first shown: the card, address, email and Remember Me sections are cleared (or refilled from `prefilledInformation`), and any in-flight email lookup is abandoned. Call this after the view controller has been dismissed if you want to present the same instance again, which is faster than creating a new one.
+ */
+- (void)prepareForReuse;
+
 @end
 
 /**
@@ -19,10 +19,15 @@
 
 #import "STPAPIResponseDecodable.h"
 
-@class CNContact;
+@class CNContact, STPAddress;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ *  A callback to be run with an address imported from a contact.
+ */
+typedef void (^STPAddressImportBlock)(STPAddress *address);
+
 /**
  *  What set of billing address information you need to collect from your user.
  *
@@ -106,6 +111,25 @@ typedef NS_ENUM(NSUInteger, STPBillingAddressFields) {
 
 - (instancetype)initWithCNContact:(CNContact *)contact NS_AVAILABLE_IOS(9_0); FAUXPAS_IGNORED_ON_LINE(APIAvailability);
 
+/**
+ *  Like `initWithCNContact:`, but maps the contact and sanitizes its fields on a
+ *  background queue so that large contacts don't block the main thread.
+ *
+ *  @param contact    The contact to import.
+ *  @param completion Called on the main queue with the imported address.
+ */
++ (void)importAddressFromCNContact:(CNContact *)contact
+                        completion:(STPAddressImportBlock)completion NS_AVAILABLE_IOS(9_0); FAUXPAS_IGNORED_ON_LINE(APIAvailability);
+
+/**
+ *  Like `initWithPKContact:`, but does the mapping on a background queue.
+ *
+ *  @param contact    The contact to import.
+ *  @param completion Called on the main queue with the imported address.
+ */
++ (void)importAddressFromPKContact:(PKContact *)contact
+                        completion:(STPAddressImportBlock)completion NS_AVAILABLE_IOS(9_0); FAUXPAS_IGNORED_ON_LINE(APIAvailability);
+
 - (BOOL)containsRequiredFields:(STPBillingAddressFields)requiredFields;
 - (BOOL)containsRequiredShippingAddressFields:(PKAddressField)requiredFields;
 
@@ -26,6 +26,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 typedef void (^STPCustomerCompletionBlock)(STPCustomer * __nullable customer, NSError * __nullable error);
 
+/**
+ *  Call this block after you're done fetching a page of a customer's sources on your server. You can use the `STPCustomerSourcesDeserializer` class to convert a JSON response into source objects.
+ *
+ *  @param sources      the page of sources, or nil if an error occurred.
+ *  @param hasMore      whether the customer has more sources after this page.
+ *  @param error        any error that occurred while communicating with your server, or nil if your call succeeded
+ */
+typedef void (^STPCustomerSourcesCompletionBlock)(NSArray<id<STPSourceProtocol>> * __nullable sources, BOOL hasMore, NSError * __nullable error);
+
 /**
  *  You should make your application's API client conform to this interface in order to use it with an `STPPaymentContext`. It provides a "bridge" from the prebuilt UI we expose (such as `STPPaymentMethodsViewController`) to your backend to fetch the information it needs to power those views. To read about how to implement this protocol, see https://stripe.com/docs/mobile/ios/standard#prepare-your-api . To see examples of implementing these APIs, see MyAPIClient.swift in our example project and https://github.com/stripe/example-ios-backend .
  */
@@ -55,6 +64,19 @@ typedef void (^STPCustomerCompletionBlock)(STPCustomer * __nullable customer, NS
  */
 - (void)selectDefaultCustomerSource:(id<STPSourceProtocol>)source completion:(STPErrorBlock)completion;
 
+@optional
+
+/**
+ *  Retrieve a page of the customer's sources, for customers with more than `retrieveCustomer:` returns (see `STPCustomer.hasMoreSources`). On your backend, list the sources of the Stripe customer associated with your logged-in user as described at https://stripe.com/docs/api#list_sources , passing `starting_after` and `limit` through, and return the raw JSON response. Back in your iOS app, deserialize it with the `STPCustomerSourcesDeserializer` class. If you implement this, `STPPaymentMethodsViewController` shows the sources from `retrieveCustomer:` first and fetches the rest a page at a time as the user scrolls.
+ *
+ *  @param startingAfter the ID of the last source already shown, or nil for the first page.
+ *  @param limit         the number of sources to return.
+ *  @param completion    call this callback when you're done fetching and parsing the page from your backend. For example, `completion(sources, hasMore, nil)` (if your call succeeds) or `completion(nil, NO, error)` if an error is returned.
+ */
+- (void)retrieveCustomerSourcesStartingAfter:(nullable NSString *)startingAfter
+                                       limit:(NSUInteger)limit
+                                  completion:(STPCustomerSourcesCompletionBlock)completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,49 @@
+//
+//  STPBankAccountValidator.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPCardValidationState.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  This class contains static methods to validate routing numbers and IBANs before they're sent to Stripe, e.g. in `STPBankAccountParams` or `+[STPSourceParams sepaDebitParamsWithName:iban:addressLine1:city:postalCode:country:]`. Spaces are ignored, so formatted input can be passed as is. Like `STPCardValidator`, partial input returns STPCardValidationStateIncomplete as long as it could still become valid, so it can be checked as the user types.
+ */
+@interface STPBankAccountValidator : NSObject
+
+/**
+ *  Validates a routing number for a bank account in `country`. US routing numbers are checked against the ABA prefix ranges and checksum; routing numbers for other countries with a fixed format, such as UK sort codes, are only checked for their length.
+ *
+ *  @param routingNumber The routing number to validate. Ex. @"110000000"
+ *  @param country The two-letter code of the country the bank account is in. Ex. @"US"
+ *
+ *  @return STPCardValidationStateValid if the routing number is valid, STPCardValidationStateInvalid if it's invalid, or STPCardValidationStateIncomplete if it's a prefix of a valid routing number (e.g. @"1100"). Non-empty routing numbers are STPCardValidationStateValid for countries with no known format.
+ */
++ (STPCardValidationState)validationStateForRoutingNumber:(nullable NSString *)routingNumber
+                                                  country:(nullable NSString *)country;
+
+/**
+ *  Validates an IBAN: its country code, its length for that country, and its mod-97 check digits. Lowercase letters are accepted.
+ *
+ *  @param iban The IBAN to validate. Ex. @"DE89 3704 0044 0532 0130 00"
+ *
+ *  @return STPCardValidationStateValid if the IBAN is valid, STPCardValidationStateInvalid if it's invalid, or STPCardValidationStateIncomplete if it's shorter than IBANs for its country and could still become valid (e.g. @"DE89 3704").
+ */
++ (STPCardValidationState)validationStateForIBAN:(nullable NSString *)iban;
+
+/**
+ *  The number of characters, not counting spaces, in IBANs for a country, or 0 if the country doesn't use IBANs.
+ *
+ *  @param country The two-letter country code. Ex. @"DE"
+ */
++ (NSUInteger)lengthOfIBANForCountry:(nullable NSString *)country;
+
+@end
+
+NS_ASSUME_NONNULL_END
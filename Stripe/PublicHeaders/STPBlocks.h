@@ -78,6 +78,22 @@ typedef void (^STPErrorBlock)(NSError * __nullable error);
  */
 typedef void (^STPTokenCompletionBlock)(STPToken * __nullable token, NSError * __nullable error);
 
+/**
+ *  A callback to be run as each card in a batch is tokenized.
+ *
+ *  @param index The index of the card in the batch.
+ *  @param token The Stripe token for the card. Will be nil if an error occurs.
+ *  @param error The error for the card, or nil if none occurred.
+ */
+typedef void (^STPTokenBatchItemCompletionBlock)(NSUInteger index, STPToken * __nullable token, NSError * __nullable error);
+
+/**
+ *  A callback to be run when every card in a batch has been tokenized.
+ *
+ *  @param results An `STPToken` or an `NSError` for each card, in the order the cards were given.
+ */
+typedef void (^STPTokenBatchCompletionBlock)(NSArray * __nonnull results);
+
 /**
  *  A callback to be run with a source response from the Stripe API.
  *
@@ -86,6 +102,17 @@ typedef void (^STPTokenCompletionBlock)(STPToken * __nullable token, NSError * _
  */
 typedef void (^STPSourceCompletionBlock)(STPSource * __nullable source, NSError * __nullable error);
 
+/**
+ *  A callback to be run when creating a card source and its 3D Secure source has finished.
+ *
+ *  @param cardSource The card source, or nil if creating it failed.
+ *  @param threeDSecureSource The 3D Secure source, or nil if it failed, or wasn't created because the card doesn't support 3D Secure.
+ *  @param cardSourceDuration How long the card source request took, in seconds.
+ *  @param threeDSecureSourceDuration How long the 3D Secure source request took, in seconds, or 0 if it wasn't made.
+ *  @param error The error from whichever request failed, or nil if none did.
+ */
+typedef void (^STPThreeDSecureSourceCompletionBlock)(STPSource * __nullable cardSource, STPSource * __nullable threeDSecureSource, NSTimeInterval cardSourceDuration, NSTimeInterval threeDSecureSourceDuration, NSError * __nullable error);
+
 /**
  *  A callback to be run with a validation result and shipping methods for a 
  *  shipping address.
@@ -0,0 +1,89 @@
+//
+//  STPCardNumberSession.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPCardBrand.h"
+#import "STPCardValidationState.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class STPCardNumberSession;
+
+/**
+ *  Receives changes to what an STPCardNumberSession knows about its number. Each method is only called when the value it describes actually changed.
+ */
+@protocol STPCardNumberSessionDelegate <NSObject>
+
+@optional
+
+/**
+ *  Called when the session's `possibleBrands` (and possibly `brand` and `maxLength`) changed.
+ */
+- (void)cardNumberSessionDidChangeBrand:(STPCardNumberSession *)session;
+
+/**
+ *  Called when the session's `validationState` changed.
+ */
+- (void)cardNumberSessionDidChangeValidationState:(STPCardNumberSession *)session;
+
+@end
+
+/**
+ *  Tracks a card number as it is typed, for apps that build their own card entry UI. Instead of looking the whole number up again on every keystroke, the session narrows down the possible brands as digits are added and steps back when they are deleted, and tells its delegate only when something changed.
+ */
+@interface STPCardNumberSession : NSObject
+
+/**
+ *  The delegate to notify of changes.
+ */
+@property (nonatomic, weak, nullable) id<STPCardNumberSessionDelegate> delegate;
+
+/**
+ *  The digits entered so far.
+ */
+@property (nonatomic, copy, readonly) NSString *number;
+
+/**
+ *  The brands (boxed STPCardBrand values) the number could still turn out to be. Empty when no brand matches.
+ */
+@property (nonatomic, copy, readonly) NSSet<NSNumber *> *possibleBrands;
+
+/**
+ *  The number's brand if only one is possible, otherwise STPCardBrandUnknown. Same as `+[STPCardValidator brandForNumber:]`.
+ */
+@property (nonatomic, readonly) STPCardBrand brand;
+
+/**
+ *  The longest a number of `brand` can be. Same as `+[STPCardValidator maxLengthForCardBrand:]`.
+ */
+@property (nonatomic, readonly) NSInteger maxLength;
+
+/**
+ *  The validation state of the number. Same as `+[STPCardValidator validationStateForNumber:validatingCardBrand:]` with brand validation.
+ */
+@property (nonatomic, readonly) STPCardValidationState validationState;
+
+/**
+ *  Adds digits to the end of the number. Non-digit characters are ignored.
+ */
+- (void)appendDigits:(NSString *)digits;
+
+/**
+ *  Removes up to `count` digits from the end of the number.
+ */
+- (void)deleteDigits:(NSUInteger)count;
+
+/**
+ *  Replaces the whole number, e.g. after a paste. Non-digit characters are ignored.
+ */
+- (void)setNumber:(NSString *)number;
+
+@end
+
+NS_ASSUME_NONNULL_END
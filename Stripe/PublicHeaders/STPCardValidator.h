@@ -104,6 +104,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (STPCardValidationState)validationStateForCard:(STPCardParams *)card;
 
+/**
+ *  Validates many cards at once, for example when re-validating stored cards in a background job. The expiration checks for every card are made against the same reference date, and the cards are validated concurrently.
+ *
+ *  @param cards         the card details to validate.
+ *  @param referenceDate the date to check expiration dates against, usually [NSDate date].
+ *
+ *  @return An array with one boxed STPCardValidationState for each card, in the same order as `cards`. Each state has the same meaning as the return value of +validationStateForCard:.
+ */
++ (NSArray<NSNumber *> *)validationStatesForCards:(NSArray<STPCardParams *> *)cards
+                                    referenceDate:(NSDate *)referenceDate;
+
 // Exposed for testing only.
 + (STPCardValidationState)validationStateForExpirationYear:(NSString *)expirationYear
                                                    inMonth:(NSString *)expirationMonth
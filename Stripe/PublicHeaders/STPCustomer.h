@@ -44,6 +44,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, readonly) NSArray<id<STPSourceProtocol>> *sources;
 
+/**
+ *  Whether the customer has more sources than are in `sources`. The Stripe API only includes the first page of a customer's sources; see `-[STPBackendAPIAdapter retrieveCustomerSourcesStartingAfter:limit:completion:]` for fetching the rest.
+ */
+@property(nonatomic, readonly) BOOL hasMoreSources;
+
 @end
 
 /**
@@ -83,4 +88,44 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ Use `STPCustomerSourcesDeserializer` to convert a page of a customer's sources from the Stripe API (see https://stripe.com/docs/api#list_sources ) into source objects. It expects the JSON response to be in the exact same format as the Stripe API.
+ */
+@interface STPCustomerSourcesDeserializer : NSObject
+
+/**
+ *  Initialize a sources deserializer. The `data`, `urlResponse`, and `error` parameters are intended to be passed from an `NSURLSessionDataTask` callback. If `error` is nil after initialization, `sources` will be non-nil (and vice versa).
+ *
+ *  @param data        An `NSData` object representing encoded JSON for a list of sources
+ *  @param urlResponse The URL response obtained from the `NSURLSessionTask`
+ *  @param error       Any error that occurred from the URL session task (if this is non-nil, the `error` property will be set to this value after initialization).
+ */
+- (instancetype)initWithData:(nullable NSData *)data
+                 urlResponse:(nullable NSURLResponse *)urlResponse
+                       error:(nullable NSError *)error;
+
+/**
+ *  Initializes a sources deserializer with a JSON dictionary, in the exact same format as what the Stripe API returns for a list of sources.
+ *
+ *  @param json a JSON dictionary.
+ */
+- (instancetype)initWithJSONResponse:(id)json;
+
+/**
+ *  The sources in the page, if it was successfully parsed. Otherwise, this value will be nil (and the `error` property will explain what went wrong).
+ */
+@property(nonatomic, readonly, nullable)NSArray<id<STPSourceProtocol>> *sources;
+
+/**
+ *  Whether there are more sources after this page.
+ */
+@property(nonatomic, readonly)BOOL hasMore;
+
+/**
+ *  If the deserializer failed to parse the page, this property will explain why (and the `sources` property will be nil).
+ */
+@property(nonatomic, readonly, nullable)NSError *error;
+
+@end
+
 NS_ASSUME_NONNULL_END
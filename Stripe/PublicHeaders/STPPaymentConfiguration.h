@@ -70,6 +70,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic)BOOL smsAutofillDisabled;
 
+/**
+ *  Set this property to `YES` to show a returning user's cards straight away. The prebuilt UI normally waits for your `STPBackendAPIAdapter` to return the customer before showing anything; with this enabled, the customer last returned by the same adapter is shown immediately while a fresh one is fetched in the background, and the list updates if it has changed. Cached customers are held in memory only, and are dropped when their adapter is deallocated. The default value is `NO`.
+ */
+@property(nonatomic)BOOL customerCachingEnabled;
+
+/**
+ *  Set this property to `YES` to ask for shipping methods as soon as the user has entered a valid shipping address, rather than when they tap Next, so the shipping methods can be shown straight away. Your `paymentContext:didUpdateShippingAddress:completion:` (or `shippingAddressViewController:didEnterAddress:completion:`) implementation may then be called for addresses the user goes on to change, and should have no side effects beyond validating the address and returning shipping methods. The default value is `NO`.
+ */
+@property(nonatomic)BOOL shippingMethodsPrefetchingEnabled;
+
+/**
+ *  Set this property to `YES` to create the card token as soon as the user has entered a valid card and billing address, rather than when they tap Done, so that tapping Done hands you the token straight away. The token is thrown away and a new one created if the user edits any field first, so some tokens may be created that you're never given; they expire unused. The default value is `NO`.
+ */
+@property(nonatomic)BOOL speculativeTokenizationEnabled;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -22,6 +22,17 @@ NS_ASSUME_NONNULL_BEGIN
 @class STPPaymentContext, STPAPIClient, STPTheme;
 @protocol STPBackendAPIAdapter, STPPaymentMethod, STPPaymentContextDelegate;
 
+/**
+ *  What changed in a payment context since its delegate was last told. @see -[STPPaymentContextDelegate paymentContext:didChange:]
+ */
+typedef NS_OPTIONS(NSUInteger, STPPaymentContextChanges) {
+    STPPaymentContextChangePaymentMethods = 1 << 0,
+    STPPaymentContextChangeSelectedPaymentMethod = 1 << 1,
+    STPPaymentContextChangeShippingMethods = 1 << 2,
+    STPPaymentContextChangeSelectedShippingMethod = 1 << 3,
+    STPPaymentContextChangeShippingAddress = 1 << 4,
+};
+
 /**
  An `STPPaymentContext` keeps track of all of the state around a payment. It will manage fetching a user's saved payment methods, tracking any information they select, and prompting them for required additional information before completing their purchase. It can be used to power your application's "payment confirmation" page with just a few lines of code.
  
@@ -71,7 +82,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic, strong, nullable)STPUserInformation *prefilledInformation;
 
 /**
- *  The view controller that any additional UI will be presented on. If you have a "checkout view controller" in your app, that should be used as the host view controller.
+ *  The view controller that any additional UI will be presented on. If you have a "checkout view controller" in your app, that should be used as the host view controller. Setting it starts preparing what the payment context's screens need, like the connection to Stripe and card images, so they're ready when you present them.
  */
 @property(nonatomic, weak, nullable)UIViewController *hostViewController;
 
@@ -80,6 +91,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, weak, nullable)id<STPPaymentContextDelegate> delegate;
 
+/**
+ *  The queue the delegate's methods are called on. Defaults to the main queue, where they're called straight away if the context is already on it. Completion blocks passed to the delegate can be called from any queue. The payment context itself should still only be used from the main thread, and the UI it shows is only touched there.
+ */
+@property(nonatomic, strong, null_resettable)dispatch_queue_t delegateQueue;
+
 /**
  *  Whether or not the payment context is currently loading information from the network.
  */
@@ -171,6 +187,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)pushPaymentMethodsViewController;
 
+/**
+ *  Builds the `STPPaymentMethodsViewController` that the next call to `presentPaymentMethodsViewController` or `pushPaymentMethodsViewController` shows, along with its list of payment methods and their cells, so that its animation can start right away. Call this while your checkout summary is on screen, e.g. from its `viewDidAppear:`.
+ *
+ *  The screen is built on the main thread, because UIKit views can't be built anywhere else. This happens as soon as the customer's payment methods have loaded, or straight away if they already have. It's thrown away if the payment methods change before it's shown, e.g. when cached cards are revalidated, and isn't used if `prefilledInformation` has changed since this call.
+ */
+- (void)preparePaymentMethodsViewController;
+
 /**
  *  This creates, configures, and appropriately presents a view controller for 
  *  collecting shipping address and shipping method on top of the payment context's 
@@ -229,7 +252,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)paymentContext:(STPPaymentContext *)paymentContext didFailToLoadWithError:(NSError *)error;
 
 /**
- *  This is called every time the contents of the payment context change. When this is called, you should update your app's UI to reflect the current state of the payment context. For example, if you have a checkout page with a "selected payment method" row, you should update its payment method with `paymentContext.selectedPaymentMethod.label`. If that checkout page has a "buy" button, you should enable/disable it depending on the result of `[paymentContext isReadyForPayment]`.
+ *  This is called every time the contents of the payment context change. Changes made together, e.g. while the customer loads, are delivered in one call on the next turn of the main run loop. When this is called, you should update your app's UI to reflect the current state of the payment context. For example, if you have a checkout page with a "selected payment method" row, you should update its payment method with `paymentContext.selectedPaymentMethod.label`. If that checkout page has a "buy" button, you should enable/disable it depending on the result of `[paymentContext isReadyForPayment]`.
  *
  *  @param paymentContext the payment context that changed
  */
@@ -279,6 +302,14 @@ didCreatePaymentResult:(STPPaymentResult *)paymentResult
 didUpdateShippingAddress:(STPAddress *)address
             completion:(STPShippingMethodsCompletionBlock)completion;
 
+/**
+ *  If implemented, this is called instead of `paymentContextDidChange:`, with what changed, so you only have to update the parts of your UI that depend on it. When the context is first shown, every part is reported as changed.
+ *
+ *  @param paymentContext the payment context that changed
+ *  @param changes        what changed since the last call
+ */
+- (void)paymentContext:(STPPaymentContext *)paymentContext didChange:(STPPaymentContextChanges)changes;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,34 @@
+//
+//  STPPerformanceHUD.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A small overlay, drawn above your app's windows, that shows what the SDK is doing while you work on your integration. Once a second it lists the API requests in flight and how long they've been running, the sources being polled and when each is next checked, the analytics events waiting to be sent, image cache hits and card brand lookups, and the time the SDK has spent on the main thread in the Stripe screen being shown.
+ *
+ *  The overlay doesn't take touches, so the screens beneath it work as usual. Call these methods on the main thread.
+ *
+ *  The HUD is only built into Debug builds of the SDK. In Release builds these methods do nothing, and none of the bookkeeping behind the HUD is compiled in.
+ */
+@interface STPPerformanceHUD : NSObject
+
+/**
+ *  Shows the HUD, if it isn't already showing.
+ */
++ (void)show;
+
+/**
+ *  Hides the HUD, and stops collecting what it shows.
+ */
++ (void)hide;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,89 @@
+//
+//  STPPerformanceSnapshot.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The endpoint key in `requestCounts` for requests to anything other than `tokens` and `sources`.
+ */
+FOUNDATION_EXPORT NSString *const STPPerformanceEndpointOther;
+
+/**
+ *  Counts of the work the SDK has done since the app launched, e.g. to report with your own monitoring without attaching Instruments. Get one with `+[Stripe performanceSnapshot]`, and use `snapshotBySubtractingSnapshot:` for the work done between two snapshots.
+ *
+ *  The counts are kept by every SDK component as it goes, at the cost of a single atomic add each. Counters are independent, so a snapshot taken while requests are in flight may count a request without its response bytes.
+ */
+@interface STPPerformanceSnapshot : NSObject
+
+/**
+ *  Network requests started, by the first component of their API endpoint: `tokens`, `sources` or `STPPerformanceEndpointOther`. Retries and hedged duplicates count as requests of their own. Requests that joined one already in flight don't.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *requestCounts;
+
+/**
+ *  Request body bytes sent to the Stripe API, after compression.
+ */
+@property (nonatomic, readonly) uint64_t bytesSent;
+
+/**
+ *  Response body bytes received from the Stripe API.
+ */
+@property (nonatomic, readonly) uint64_t bytesReceived;
+
+/**
+ *  Total time spent decoding API responses, in seconds.
+ */
+@property (nonatomic, readonly) NSTimeInterval decodeDuration;
+
+/**
+ *  Requests made by STPAPIClient source polling to check on a source.
+ */
+@property (nonatomic, readonly) uint64_t sourcePollCount;
+
+/**
+ *  Callbacks the SDK's internal promises dispatched to another queue.
+ */
+@property (nonatomic, readonly) uint64_t promiseHopCount;
+
+/**
+ *  Lookups of the SDK's images, e.g. card brand images, that found the image already loaded.
+ */
+@property (nonatomic, readonly) uint64_t imageCacheHitCount;
+
+/**
+ *  Lookups of the SDK's images that had to load the image.
+ */
+@property (nonatomic, readonly) uint64_t imageCacheMissCount;
+
+/**
+ *  Lookups of the card brand ranges a card number falls in, e.g. while the user types it.
+ */
+@property (nonatomic, readonly) uint64_t binRangeLookupCount;
+
+/**
+ *  Analytics events delivered.
+ */
+@property (nonatomic, readonly) uint64_t analyticsEventsSentCount;
+
+/**
+ *  Analytics events dropped without being delivered, because too many were waiting, e.g. while offline.
+ */
+@property (nonatomic, readonly) uint64_t analyticsEventsDroppedCount;
+
+/**
+ *  The work done between `snapshot` and this one.
+ *
+ *  @param snapshot An earlier snapshot.
+ */
+- (STPPerformanceSnapshot *)snapshotBySubtractingSnapshot:(STPPerformanceSnapshot *)snapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -8,24 +8,10 @@
 
 #import <Foundation/Foundation.h>
 #import "STPBlocks.h"
+#import "STPRedirectContextState.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
-/**
- Possible states for the redirect context to be in
-
- - STPRedirectContextStateNotStarted: Initialized, but redirect not started
- - STPRedirectContextStateInProgress: Redirect is in progress
- - STPRedirectContextStateCancelled: Redirect has been cancelled programmatically before completing
- - STPRedirectContextStateCompleted: Redirect has completed.
- */
-typedef NS_ENUM(NSUInteger, STPRedirectContextState) {
-    STPRedirectContextStateNotStarted,
-    STPRedirectContextStateInProgress,
-    STPRedirectContextStateCancelled,
-    STPRedirectContextStateCompleted
-};
-
 /**
  A callback run when the context believes the redirect action has been completed.
 
@@ -118,6 +104,17 @@ NS_EXTENSION_UNAVAILABLE("Redirect based sources are not available in extensions
  */
 - (void)startSafariViewControllerRedirectFlowFromViewController:(UIViewController *)presentingViewController NS_AVAILABLE_IOS(9_0);
 
+/**
+ *  Creates the SFSafariViewController for the redirect and starts loading
+ *  the source's redirect page, without presenting anything. A later call to
+ *  `startSafariViewControllerRedirectFlowFromViewController:` then presents
+ *  this controller, with the page already loading. Call this as soon as you
+ *  have the context, if you expect to use the Safari view controller flow.
+ *
+ *  @note This method does nothing if the context is not in the `STPRedirectContextStateNotStarted` state, or has already been prepared.
+ */
+- (void)prepareSafariViewControllerRedirectFlow NS_AVAILABLE_IOS(9_0);
+
 /**
  *  Starts a redirect flow by calling `openURL` to bounce the user out to
  *  the Safari app.
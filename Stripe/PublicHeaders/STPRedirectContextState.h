@@ -0,0 +1,24 @@
+//
+//  STPRedirectContextState.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Possible states for the redirect context to be in
+
+ - STPRedirectContextStateNotStarted: Initialized, but redirect not started
+ - STPRedirectContextStateInProgress: Redirect is in progress
+ - STPRedirectContextStateCancelled: Redirect has been cancelled programmatically before completing
+ - STPRedirectContextStateCompleted: Redirect has completed.
+ */
+typedef NS_ENUM(NSUInteger, STPRedirectContextState) {
+    STPRedirectContextStateNotStarted,
+    STPRedirectContextStateInProgress,
+    STPRedirectContextStateCancelled,
+    STPRedirectContextStateCompleted
+};
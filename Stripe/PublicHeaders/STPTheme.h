@@ -75,6 +75,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, copy, null_resettable)UIFont  *emphasisFont;
 
+/**
+ *  A Boolean value indicating whether the fonts of this theme should be scaled with the user's preferred content size category (Dynamic Type). When enabled, `font`, `emphasisFont`, `smallFont` and `largeFont` return the fonts you set scaled the way Dynamic Type scales body text, and views pick up a new content size category the next time they apply the theme. The default value is NO.
+ */
+@property(nonatomic)BOOL adjustsFontsForContentSizeCategory;
+
 /**
  *  The navigation bar style to use for any view controllers presented modally
  *  by the SDK. The default value will be determined based on the brightness
@@ -0,0 +1,111 @@
+//
+//  STPThreeDSecureFlow.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPRedirectContext.h"
+#import "STPSourceCardDetails.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class STPAPIClient, STPCardParams, STPSource;
+
+/**
+ *  A callback run when an STPThreeDSecureFlow has everything needed to pay with the card.
+ *
+ *  @param cardSource      The card source. Charge it directly if `redirectContext` is nil.
+ *  @param redirectContext A context for the 3D Secure redirect, if the card needs one. Start its redirect flow, and charge the 3D Secure source once it has completed.
+ *  @param error           The error that occurred, if any.
+ */
+typedef void (^STPThreeDSecureFlowCompletionBlock)(STPSource * __nullable cardSource, STPRedirectContext * __nullable redirectContext, NSError * __nullable error);
+
+/**
+ *  Creates the sources for paying with a card, starting while the user is still filling in your form.
+ *
+ *  Paying with a card source that might need 3D Secure takes two requests one after the other: creating the card source, which tells you whether the card needs 3D Secure, and then creating a 3D Secure source for it. Instead of making both once the user submits, call `updateCardParams:` whenever the card fields change. As soon as they're valid, the flow creates the card source, and if the card needs 3D Secure, the 3D Secure source and its redirect context, while the user fills in the rest of the form, e.g. their address. Then call `finishWithCardParams:completion:` on submit, which usually finds everything ready.
+ *
+ *  The card source is created from the card's number, expiration date and CVC only, so that filling in the rest of the form doesn't start it over. Send anything else you need, like the billing address, to your backend along with the source.
+ *
+ *  Use a flow from the main thread only.
+ */
+NS_EXTENSION_UNAVAILABLE("Redirect based sources are not available in extensions")
+@interface STPThreeDSecureFlow : NSObject
+
+/**
+ *  Initializes a flow.
+ *
+ *  @param apiClient          The API client to create sources with.
+ *  @param amount             The amount to charge, in the currency's smallest unit, e.g. cents. Used for the 3D Secure source.
+ *  @param currency           The currency to charge in. Used for the 3D Secure source.
+ *  @param returnURL          The URL the customer should be returned to after 3D Secure. See `+[STPSourceParams threeDSecureParamsWithAmount:currency:returnURL:card:]`.
+ *  @param redirectCompletion The completion block of the redirect contexts the flow creates. See `-[STPRedirectContext initWithSource:completion:]`.
+ */
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                           amount:(NSUInteger)amount
+                         currency:(NSString *)currency
+                        returnURL:(NSString *)returnURL
+               redirectCompletion:(STPRedirectContextCompletionBlock)redirectCompletion;
+
+/**
+ *  Use `initWithAPIClient:amount:currency:returnURL:redirectCompletion:`
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ *  Whether to use 3D Secure for cards where it's optional, as well as those where it's required. The default value is `NO`.
+ */
+@property (nonatomic) BOOL usesThreeDSecureWhenOptional;
+
+/**
+ *  Whether to call `prepareSafariViewControllerRedirectFlow` on the redirect contexts the flow creates, so the 3D Secure page is already loading when you start the redirect. Turn this off if you use `startSafariAppRedirectFlow`. The default value is `YES`.
+ */
+@property (nonatomic) BOOL preparesSafariViewController;
+
+/**
+ *  The card source for the current card, once it's been created.
+ */
+@property (nonatomic, readonly, nullable) STPSource *cardSource;
+
+/**
+ *  Whether the current card supports 3D Secure, once its card source has been created, otherwise `STPSourceCard3DSecureStatusUnknown`.
+ */
+@property (nonatomic, readonly) STPSourceCard3DSecureStatus threeDSecureStatus;
+
+/**
+ *  The 3D Secure source for the current card, once it's been created, if the card needs one.
+ */
+@property (nonatomic, readonly, nullable) STPSource *threeDSecureSource;
+
+/**
+ *  The redirect context for `threeDSecureSource`.
+ */
+@property (nonatomic, readonly, nullable) STPRedirectContext *redirectContext;
+
+/**
+ *  Tells the flow what's currently entered. Call this whenever the card fields change. Once the card is valid, the flow starts creating its sources. Sources created for any other card are dropped.
+ *
+ *  @param cardParams The entered card, or nil if there's none.
+ */
+- (void)updateCardParams:(nullable STPCardParams *)cardParams;
+
+/**
+ *  Hands the sources for `cardParams` to `completion`: right away if they're ready, otherwise once they've been created. If `cardParams` isn't the card the flow already started on, it starts over with it. Later calls to `updateCardParams:` are ignored until `completion` has been called.
+ *
+ *  @param cardParams The card the user submitted.
+ *  @param completion The callback to run with the sources.
+ */
+- (void)finishWithCardParams:(STPCardParams *)cardParams completion:(STPThreeDSecureFlowCompletionBlock)completion;
+
+/**
+ *  Cancels any requests in flight and drops the sources created so far. A pending completion block will not be called.
+ */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -8,6 +8,7 @@
 
 #import "STPAPIClient+ApplePay.h"
 #import "STPAPIClient.h"
+#import "STPAPIRequestMetrics.h"
 #import "STPAPIResponseDecodable.h"
 #import "STPAddCardViewController.h"
 #import "STPAddress.h"
@@ -15,9 +16,11 @@
 #import "STPBackendAPIAdapter.h"
 #import "STPBankAccount.h"
 #import "STPBankAccountParams.h"
+#import "STPBankAccountValidator.h"
 #import "STPBlocks.h"
 #import "STPCard.h"
 #import "STPCardBrand.h"
+#import "STPCardNumberSession.h"
 #import "STPCardParams.h"
 #import "STPCardValidationState.h"
 #import "STPCardValidator.h"
@@ -34,7 +37,10 @@
 #import "STPPaymentMethod.h"
 #import "STPPaymentMethodsViewController.h"
 #import "STPPaymentResult.h"
+#import "STPPerformanceHUD.h"
+#import "STPPerformanceSnapshot.h"
 #import "STPRedirectContext.h"
+#import "STPRedirectContextState.h"
 #import "STPShippingAddressViewController.h"
 #import "STPSource.h"
 #import "STPSourceCardDetails.h"
@@ -46,6 +52,7 @@
 #import "STPSourceSEPADebitDetails.h"
 #import "STPSourceVerification.h"
 #import "STPTheme.h"
+#import "STPThreeDSecureFlow.h"
 #import "STPToken.h"
 #import "STPUserInformation.h"
 #import "StripeError.h"
@@ -6,6 +6,7 @@
 //
 
 #import <AddressBook/AddressBook.h>
+#import <objc/runtime.h>
 
 #import "PKPayment+Stripe.h"
 #import "STPAPIClient+ApplePay.h"
@@ -14,6 +15,8 @@
 
 FAUXPAS_IGNORED_IN_FILE(APIAvailability)
 
+static char kSTPPaymentParametersAssociatedObjectKey;
+
 @implementation STPAPIClient (ApplePay)
 
 - (void)createTokenWithPayment:(PKPayment *)payment completion:(STPTokenCompletionBlock)completion {
@@ -100,10 +103,14 @@ FAUXPAS_IGNORED_IN_FILE(APIAvailability)
 
 + (NSDictionary *)parametersForPayment:(PKPayment *)payment {
     NSCAssert(payment != nil, @"Cannot create a token with a nil payment.");
-    NSString *paymentString =
-    [[NSString alloc] initWithData:payment.token.paymentData encoding:NSUTF8StringEncoding];
+    // A payment never changes, so its parameters are only built once.
+    NSDictionary *cachedParameters = objc_getAssociatedObject(payment, &kSTPPaymentParametersAssociatedObjectKey);
+    if (cachedParameters) {
+        return cachedParameters;
+    }
     NSMutableDictionary *payload = [NSMutableDictionary new];
-    payload[@"pk_token"] = paymentString;
+    // The form encoder escapes the token's JSON straight from the data
+    payload[@"pk_token"] = payment.token.paymentData;
 
     if ([PKContact class]
         && [payment respondsToSelector:@selector(billingContact)]) {
@@ -131,7 +138,9 @@ FAUXPAS_IGNORED_IN_FILE(APIAvailability)
         payload[@"pk_token_transaction_id"] = transactionIdentifier;
     }
 
-    return payload;
+    NSDictionary *parameters = [payload copy];
+    objc_setAssociatedObject(payment, &kSTPPaymentParametersAssociatedObjectKey, parameters, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    return parameters;
 }
 
 
@@ -11,6 +11,8 @@
 #import "STPAPIClient.h"
 #import "STPAPIRequest.h"
 
+@class STPSourceBackgroundPoller, STPSourceCache, STPSourceCreationQueue, STPSourcePollScheduler, STPSourcePoller, STPSourcePollerStateStore;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface STPAPIClient()
@@ -18,14 +20,124 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithPublishableKey:(NSString *)publishableKey
                                baseURL:(NSString *)baseURL;
 
-- (void)createTokenWithParameters:(NSDictionary *)parameters
-                       completion:(STPTokenCompletionBlock)completion;
+- (NSURLSessionDataTask *)createTokenWithParameters:(NSDictionary *)parameters
+                                         completion:(STPTokenCompletionBlock)completion;
 
 - (NSURLSessionDataTask *)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret responseCompletion:(STPAPIResponseBlock)completion;
 
+/**
+ Like `retrieveSourceWithId:clientSecret:responseCompletion:`, for fetching a
+ newer version of `previousSource`. The source is only downloaded if it no
+ longer matches `entityTag`; an unchanged source is reported as a 304 response
+ with no object and no error. A changed one shares whatever it can with
+ `previousSource` (see `-[STPSource updatedObjectFromAPIResponse:]`).
+ */
+- (NSURLSessionDataTask *)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret previousSource:(nullable STPSource *)previousSource entityTag:(nullable NSString *)entityTag responseCompletion:(STPAPIResponseBlock)completion;
+
+/**
+ Like `retrieveSourceWithId:clientSecret:previousSource:entityTag:responseCompletion:`, but asks the
+ server to hold the response for up to `waitInterval` seconds while the source
+ is unchanged. See `+[STPAPIRequest longPollWithAPIClient:...]`.
+ */
+- (NSURLSessionDataTask *)waitForSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret previousSource:(nullable STPSource *)previousSource entityTag:(nullable NSString *)entityTag waitInterval:(NSTimeInterval)waitInterval responseCompletion:(STPAPIResponseBlock)completion;
+
+/**
+ Returns a request for `url` carrying this client's credentials. `urlSession`
+ is shared with other clients, so every request must be built with this.
+ */
+- (NSMutableURLRequest *)configuredRequestForURL:(NSURL *)url;
+
+/**
+ A configured request for `endpoint`, relative to `apiURL`. Each endpoint's
+ request is built once and copied after that, which is cheaper than building
+ the URL and headers again for every poll or token.
+ */
+- (NSMutableURLRequest *)configuredRequestForEndpoint:(NSString *)endpoint;
+
+/**
+ The JSON `X-Stripe-User-Agent` value. It is built once per process and shared
+ by every client, including `STPCheckoutAPIClient`.
+ */
++ (NSString *)stripeUserAgentDetails;
+
+/**
+ The headers every API session is configured with. Built once per process, so
+ each client looks up the same pooled session without re-serializing them.
+ */
++ (NSDictionary<NSString *, NSString *> *)sharedAdditionalHeaders;
+
+/**
+ Counters for the pollers started with `startPollingSourceWithId:`.
+ */
+typedef struct {
+    // Pollers registered now
+    NSUInteger activeCount;
+    // The most that have been registered at once
+    NSUInteger peakCount;
+    // Pollers registered over the client's lifetime
+    NSUInteger registeredCount;
+    // Pollers finished early to keep the registry bounded
+    NSUInteger evictedCount;
+} STPSourcePollerRegistryMetrics;
+
 @property (nonatomic, readwrite) NSURL *apiURL;
 @property (nonatomic, readwrite) NSURLSession *urlSession;
 
+/**
+ Drives every source poller started by this client.
+ */
+@property (nonatomic, readonly) STPSourcePollScheduler *sourcePollScheduler;
+
+/**
+ The sources this client recently created, retrieved or polled, for
+ `retrieveSourceWithId:clientSecret:cachePolicy:completion:`.
+ */
+@property (nonatomic, readonly) STPSourceCache *sourceCache;
+
+/**
+ Sends the sources queued with `enqueueSourceWithParams:`. Created on first
+ use, saving to a file named for the publishable key.
+ */
+@property (nonatomic, readonly) STPSourceCreationQueue *sourceCreationQueue;
+
+/**
+ Called by a poller whenever it stops, so that it's dropped from the registry
+ however it finished.
+ */
+- (void)sourcePollerDidStop:(STPSourcePoller *)poller;
+
+- (STPSourcePollerRegistryMetrics)sourcePollerRegistryMetrics;
+
+/**
+ Saves the state of each source poll. nil unless `persistsSourcePollingState`
+ is on.
+ */
+@property (nonatomic, readonly, nullable) STPSourcePollerStateStore *sourcePollerStateStore;
+
+/**
+ Checks pending sources while the app is in the background. nil until
+ `backgroundPollingDelegate` is first set.
+ */
+@property (nonatomic, readonly, nullable) STPSourceBackgroundPoller *sourceBackgroundPoller;
+
+/**
+ Hands a poll over to `sourceBackgroundPoller`, which checks the source until
+ `deadline`. Returns NO if background polling is off.
+ */
+- (BOOL)startBackgroundPollingSourceWithId:(NSString *)identifier
+                              clientSecret:(NSString *)secret
+                                  deadline:(NSDate *)deadline;
+
+- (void)stopBackgroundPollingSourceWithId:(NSString *)identifier;
+
+/**
+ Called on the main thread by `sourceBackgroundPoller` with a source that's
+ done being checked. Finishes the poll for it if one is still running, and
+ tells `backgroundPollingDelegate` otherwise. Returns NO if there was no one
+ to deliver the source to, so it should be kept for later.
+ */
+- (BOOL)deliverBackgroundPolledSource:(STPSource *)source;
+
 @end
 
 NS_ASSUME_NONNULL_END
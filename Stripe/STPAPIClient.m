@@ -7,22 +7,48 @@
 //
 
 #import <UIKit/UIKit.h>
+#import <stdatomic.h>
 #import <sys/utsname.h>
 
 #import "NSBundle+Stripe_AppName.h"
+#import "NSMutableURLRequest+Stripe.h"
 #import "STPAPIClient+ApplePay.h"
 #import "STPAPIClient.h"
+#import "STPAPIKey.h"
 #import "STPAPIRequest.h"
 #import "STPAnalyticsClient.h"
 #import "STPBankAccount.h"
+#import "STPBundleLocator.h"
 #import "STPCard.h"
+#import "STPCountryList.h"
+#import "STPDispatchFunctions.h"
+#import "STPExtensionMode.h"
 #import "STPFormEncoder.h"
+#import "STPImageLibrary+Private.h"
+#import "STPLocalizationUtils.h"
+#import "STPMainThreadWatchdog.h"
 #import "STPPaymentConfiguration.h"
+#import "STPPaymentConfiguration+Private.h"
+#import "STPPerformanceCounters.h"
+#import "STPPublicKeyPins.h"
+#import "STPRUMCollector.h"
+#import "STPRemoteBINRanges.h"
+#import "STPSignpost.h"
 #import "STPSource+Private.h"
+#import "STPSourceBackgroundPoller.h"
+#import "STPSourceCache.h"
+#import "STPSourceCreationQueue.h"
 #import "STPSourceParams.h"
 #import "STPSourceParams+Private.h"
+#import "STPSourcePollScheduler.h"
 #import "STPSourcePoller.h"
+#import "STPSourcePollerStateStore.h"
+#import "STPTheme.h"
 #import "STPToken.h"
+#import "STPTokenBatch.h"
+#import "STPURLSessionPool.h"
+#import "STPWeakStrongMacros.h"
+#import "StripeError.h"
 
 #if __has_include("Fabric.h")
 #import "Fabric+FABKits.h"
@@ -40,6 +66,13 @@ static NSString *const apiURLBase = @"api.stripe.com/v1";
 static NSString *const tokenEndpoint = @"tokens";
 static NSString *const sourcesEndpoint = @"sources";
 static NSString *const stripeAPIVersion = @"2015-10-12";
+// Polls beyond this many evict the oldest one
+static NSUInteger const MaxSourcePollers = 32;
+static NSUInteger const SourceCacheCapacity = 32;
+static NSTimeInterval const SourceCacheTimeToLive = 30;
+
+// Matches the default session configuration's connections per host.
+NSUInteger const STPTokenBatchDefaultMaxConcurrentRequests = 4;
 
 @implementation Stripe
 
@@ -55,6 +88,62 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     [STPAnalyticsClient disableAnalytics];
 }
 
++ (void)enableExtensionMode {
+    stpSetExtensionModeEnabled(YES);
+    [STPAnalyticsClient disableAnalytics];
+}
+
++ (void)prepareResourcesWithCompletion:(void (^)(void))completion {
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [STPBundleLocator stripeResourcesBundle];
+        // Looking up any key loads and caches the whole string table.
+        [STPLocalizationUtils localizedStripeStringForKey:@"Add a Card"];
+        [STPTheme defaultTheme];
+        [STPImageLibrary preloadImages];
+        [STPCountryList currentList];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), completion);
+        }
+    });
+}
+
++ (void)setPinnedPublicKeyHashes:(NSArray<NSString *> *)hashes forHost:(NSString *)host {
+    [[STPPublicKeyPins sharedPins] setPinnedHashes:hashes forHost:host];
+}
+
++ (void)setNetworkPerformanceSampleRate:(double)sampleRate {
+    [[STPRUMCollector sharedCollector] setSampleRate:sampleRate forCategory:STPRUMCategoryNetwork];
+}
+
++ (void)setInterfacePerformanceSampleRate:(double)sampleRate {
+    [[STPRUMCollector sharedCollector] setSampleRate:sampleRate forCategory:STPRUMCategoryInterface];
+}
+
++ (STPPerformanceSnapshot *)performanceSnapshot {
+    return [STPPerformanceSnapshot currentSnapshot];
+}
+
++ (void)setMainThreadWatchdogDelegate:(id<STPMainThreadWatchdogDelegate>)delegate budget:(NSTimeInterval)budget {
+    [STPMainThreadWatchdog setDelegate:delegate budget:budget];
+}
+
++ (void)enableRemoteBINRangesWithURL:(NSURL *)url {
+    static STPRemoteBINRanges *remoteRanges;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURLSession *session = [[STPURLSessionPool sharedPool] sessionForHost:url.host
+                                                             additionalHeaders:nil
+                                                            networkServiceType:NSURLNetworkServiceTypeBackground];
+        remoteRanges = [[STPRemoteBINRanges alloc] initWithURLSession:session
+                                                            remoteURL:url
+                                                              fileURL:[STPRemoteBINRanges defaultFileURL]];
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+            [remoteRanges installSavedRanges];
+            [remoteRanges refreshWithCompletion:nil];
+        });
+    });
+}
+
 @end
 
 #if __has_include("Fabric.h")
@@ -66,16 +155,47 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 @property (nonatomic, readwrite) NSURLSession *urlSession;
 @property (nonatomic, readwrite) NSMutableDictionary<NSString *,NSObject *>*sourcePollers;
 @property (nonatomic, readwrite) dispatch_queue_t sourcePollersQueue;
+// Identifiers in sourcePollers, oldest registration first
+@property (nonatomic) NSMutableArray<NSString *> *sourcePollerOrder;
+// A token for each poll that has been started but whose poller isn't
+// registered yet. Stopping the poll removes it, so the late registration
+// knows to stop the poller instead. Only touched on sourcePollersQueue.
+@property (nonatomic) NSMutableDictionary<NSString *, NSObject *> *pendingSourcePolls;
+@property (nonatomic, readwrite) STPSourcePollScheduler *sourcePollScheduler;
+@property (nonatomic, readwrite) STPSourceCache *sourceCache;
+@property (nonatomic, readwrite) STPSourceCreationQueue *sourceCreationQueue;
+@property (nonatomic, readwrite, nullable) STPSourceBackgroundPoller *sourceBackgroundPoller;
+@property (nonatomic, readwrite, nullable) STPSourcePollerStateStore *sourcePollerStateStore;
+@property (atomic) NSURLSessionDataTask *prewarmTask;
 @end
 
-@implementation STPAPIClient
+// Polling cycles through source endpoints, so the templates are dropped
+// rather than left to grow.
+static NSUInteger const MaxRequestTemplates = 32;
+
+// How many clients +clientWithPublishableKey: keeps for accounts that aren't
+// currently in use
+static NSUInteger const MaxRegisteredClients = 16;
+
+@implementation STPAPIClient {
+    // Only touched on sourcePollersQueue
+    STPSourcePollerRegistryMetrics _sourcePollerMetrics;
+    // Only touched while synchronized on self. The templates are only valid
+    // for the key and URL they were built with.
+    NSMutableDictionary<NSString *, NSURLRequest *> *_requestTemplates;
+    NSString *_requestTemplatesPublishableKey;
+    NSURL *_requestTemplatesAPIURL;
+}
 
-+ (void)initialize {
-    [STPAnalyticsClient initializeIfNeeded];
 #ifdef STP_STATIC_LIBRARY_BUILD
++ (void)initialize {
+    // The link functions are empty; calling them only makes sure the linker
+    // keeps our categories, so this costs nothing at launch.
+    STPSignpostIntervalBegin("Load categories", self);
     [STPCategoryLoader loadCategories];
-#endif
+    STPSignpostIntervalEnd("Load categories", self);
 }
+#endif
 
 + (instancetype)sharedClient {
     static id sharedClient;
@@ -84,6 +204,62 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     return sharedClient;
 }
 
++ (dispatch_queue_t)registryQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.apiclient.registry", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// Only touched on +registryQueue
++ (NSMutableDictionary<NSString *, STPAPIClient *> *)registeredClients {
+    static NSMutableDictionary *clients;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        clients = [NSMutableDictionary dictionary];
+    });
+    return clients;
+}
+
+// Only touched on +registryQueue. Least recently used first.
++ (NSMutableArray<NSString *> *)registeredClientOrder {
+    static NSMutableArray *order;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        order = [NSMutableArray array];
+    });
+    return order;
+}
+
++ (instancetype)clientWithPublishableKey:(NSString *)publishableKey {
+    NSString *key = [publishableKey copy];
+    __block STPAPIClient *client;
+    dispatch_sync([self registryQueue], ^{
+        NSMutableDictionary<NSString *, STPAPIClient *> *clients = [self registeredClients];
+        NSMutableArray<NSString *> *order = [self registeredClientOrder];
+        client = clients[key];
+        if (client && ![client.publishableKey isEqualToString:key]) {
+            client = nil;
+        }
+        if (client) {
+            [order removeObject:key];
+        } else {
+            // Validated once per key, like the rest of the client's setup
+            client = [[self alloc] initWithPublishableKey:key];
+            clients[key] = client;
+            [order removeObject:key];
+            if (order.count >= MaxRegisteredClients) {
+                [clients removeObjectForKey:order.firstObject];
+                [order removeObjectAtIndex:0];
+            }
+        }
+        [order addObject:key];
+    });
+    return client;
+}
+
 - (instancetype)init {
     return [self initWithConfiguration:[STPPaymentConfiguration sharedConfiguration]];
 }
@@ -100,16 +276,14 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     if (self) {
         _apiURL = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@", apiURLBase]];
         _configuration = configuration;
-        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
-        NSString *auth = [@"Bearer " stringByAppendingString:self.publishableKey];
-        sessionConfiguration.HTTPAdditionalHeaders = @{
-                                                       @"X-Stripe-User-Agent": [self.class stripeUserAgentDetails],
-                                                       @"Stripe-Version": stripeAPIVersion,
-                                                       @"Authorization": auth,
-                                                       };
-        _urlSession = [NSURLSession sessionWithConfiguration:sessionConfiguration];
+        // The session is looked up on first use (see -urlSession), as clients
+        // are often created at launch long before they make a request.
         _sourcePollers = [NSMutableDictionary dictionary];
         _sourcePollersQueue = dispatch_queue_create("com.stripe.sourcepollers", DISPATCH_QUEUE_SERIAL);
+        _sourcePollerOrder = [NSMutableArray array];
+        _pendingSourcePolls = [NSMutableDictionary dictionary];
+        _sourceCache = [[STPSourceCache alloc] initWithCapacity:SourceCacheCapacity timeToLive:SourceCacheTimeToLive];
+        _completionQueue = dispatch_get_main_queue();
     }
     return self;
 }
@@ -123,6 +297,88 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     return self;
 }
 
+- (NSURLSession *)urlSession {
+    @synchronized(self) {
+        if (!_urlSession) {
+            STPSignpostIntervalBegin("URL session lookup", self);
+            // The Authorization header is added to each request instead (see
+            // -configuredRequestForURL:) so that every client shares one session.
+            _urlSession = [[STPURLSessionPool sharedPool] sessionForHost:self.apiURL.host additionalHeaders:[self.class sharedAdditionalHeaders]];
+            STPSignpostIntervalEnd("URL session lookup", self);
+        }
+        return _urlSession;
+    }
+}
+
+- (void)setUrlSession:(NSURLSession *)urlSession {
+    @synchronized(self) {
+        _urlSession = urlSession;
+    }
+}
+
+- (STPSourcePollScheduler *)sourcePollScheduler {
+    // Created on first use, so clients that never poll, e.g. in extensions,
+    // don't observe the app's lifecycle.
+    @synchronized(self) {
+        if (!_sourcePollScheduler) {
+            _sourcePollScheduler = [STPSourcePollScheduler new];
+        }
+        return _sourcePollScheduler;
+    }
+}
+
+- (STPSourceCreationQueue *)sourceCreationQueue {
+    @synchronized(self) {
+        if (!_sourceCreationQueue) {
+            NSURL *fileURL = [STPSourceCreationQueue defaultFileURLForPublishableKey:self.publishableKey ?: @"default"];
+            _sourceCreationQueue = [[STPSourceCreationQueue alloc] initWithAPIClient:self
+                                                                            endpoint:sourcesEndpoint
+                                                                             fileURL:fileURL];
+        }
+        return _sourceCreationQueue;
+    }
+}
+
+- (void)setSourceQueueDelegate:(id<STPAPIClientSourceQueueDelegate>)sourceQueueDelegate {
+    _sourceQueueDelegate = sourceQueueDelegate;
+    if (sourceQueueDelegate) {
+        [self.sourceCreationQueue start];
+    }
+}
+
+- (void)setPersistsSourcePollingState:(BOOL)persistsSourcePollingState {
+    @synchronized(self) {
+        _persistsSourcePollingState = persistsSourcePollingState;
+        if (persistsSourcePollingState && !_sourcePollerStateStore) {
+            NSURL *fileURL = [STPSourcePollerStateStore defaultFileURLForPublishableKey:self.publishableKey ?: @"default"];
+            _sourcePollerStateStore = [[STPSourcePollerStateStore alloc] initWithFileURL:fileURL];
+        }
+    }
+}
+
+- (STPSourcePollerStateStore *)sourcePollerStateStore {
+    @synchronized(self) {
+        return _persistsSourcePollingState ? _sourcePollerStateStore : nil;
+    }
+}
+
+- (STPSource *)cachedSourceWithId:(NSString *)identifier {
+    return [self.sourcePollerStateStore stateForSourceWithId:identifier].latestSource;
+}
+
+- (void)setBackgroundPollingDelegate:(id<STPAPIClientBackgroundPollingDelegate>)backgroundPollingDelegate {
+    _backgroundPollingDelegate = backgroundPollingDelegate;
+    if (backgroundPollingDelegate) {
+        stpDispatchToMainThreadIfNecessary(^{
+            if (!self.sourceBackgroundPoller) {
+                self.sourceBackgroundPoller = [STPSourceBackgroundPoller pollerForPublishableKey:self.publishableKey ?: @"default"];
+            }
+            self.sourceBackgroundPoller.apiClient = self;
+            [self.sourceBackgroundPoller start];
+        });
+    }
+}
+
 - (void)setPublishableKey:(NSString *)publishableKey {
     self.configuration.publishableKey = [publishableKey copy];
 }
@@ -131,23 +387,77 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     return self.configuration.publishableKey;
 }
 
-- (void)createTokenWithParameters:(NSDictionary *)parameters
-                       completion:(STPTokenCompletionBlock)completion {
+- (NSMutableURLRequest *)configuredRequestForURL:(NSURL *)url {
+    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:url];
+    NSString *auth = [@"Bearer " stringByAppendingString:self.publishableKey ?: @""];
+    [request setValue:auth forHTTPHeaderField:@"Authorization"];
+    return request;
+}
+
+- (NSMutableURLRequest *)configuredRequestForEndpoint:(NSString *)endpoint {
+    NSString *publishableKey = [self.configuration configurationSnapshot].publishableKey ?: @"";
+    NSURL *apiURL = self.apiURL;
+    NSURLRequest *template;
+    @synchronized(self) {
+        if (!_requestTemplates || _requestTemplatesAPIURL != apiURL || ![_requestTemplatesPublishableKey isEqualToString:publishableKey]) {
+            _requestTemplates = [NSMutableDictionary dictionary];
+            _requestTemplatesPublishableKey = [publishableKey copy];
+            _requestTemplatesAPIURL = apiURL;
+        }
+        template = _requestTemplates[endpoint];
+    }
+    if (template) {
+        return [template mutableCopy];
+    }
+    NSMutableURLRequest *request = [self configuredRequestForURL:[apiURL URLByAppendingPathComponent:endpoint]];
+    @synchronized(self) {
+        // The key or URL may have changed while this one was built
+        if (_requestTemplatesAPIURL == apiURL && [_requestTemplatesPublishableKey isEqualToString:publishableKey]) {
+            if (_requestTemplates.count >= MaxRequestTemplates) {
+                [_requestTemplates removeAllObjects];
+            }
+            _requestTemplates[endpoint] = [request copy];
+        }
+    }
+    return request;
+}
+
+- (void)prewarmConnection {
+    if (self.prewarmTask.state == NSURLSessionTaskStateRunning) {
+        return;
+    }
+    // A HEAD request has no body to download or decode; all we care about is
+    // leaving an open connection in the session's pool.
+    NSMutableURLRequest *request = [self configuredRequestForURL:self.apiURL];
+    request.HTTPMethod = @"HEAD";
+    NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request completionHandler:^(__unused NSData *data, __unused NSURLResponse *response, __unused NSError *error) {
+        self.prewarmTask = nil;
+    }];
+    self.prewarmTask = task;
+    task.priority = NSURLSessionTaskPriorityLow;
+    [task resume];
+}
+
+- (NSURLSessionDataTask *)createTokenWithParameters:(NSDictionary *)parameters
+                                         completion:(STPTokenCompletionBlock)completion {
     NSCAssert(parameters != nil, @"'parameters' is required to create a token");
     NSCAssert(completion != nil, @"'completion' is required to use the token that is created");
     NSDate *start = [NSDate date];
     NSString *tokenType = [STPAnalyticsClient tokenTypeFromParameters:parameters];
-    [[STPAnalyticsClient sharedClient] logTokenCreationAttemptWithConfiguration:self.configuration
+    // The completion runs on another thread, by which time the configuration
+    // may have changed.
+    STPPaymentConfiguration *configuration = [self.configuration configurationSnapshot];
+    [[STPAnalyticsClient sharedClient] logTokenCreationAttemptWithConfiguration:configuration
                                                                       tokenType:tokenType];
-    [STPAPIRequest<STPToken *> postWithAPIClient:self
-                                        endpoint:tokenEndpoint
-                                      parameters:parameters
-                                      serializer:[STPToken new]
-                                      completion:^(STPToken *object, NSHTTPURLResponse *response, NSError *error) {
-                                          NSDate *end = [NSDate date];
-                                          [[STPAnalyticsClient sharedClient] logRUMWithToken:object configuration:self.configuration response:response start:start end:end];
-                                          completion(object, error);
-                                      }];
+    return [STPAPIRequest<STPToken *> postWithAPIClient:self
+                                               endpoint:tokenEndpoint
+                                             parameters:parameters
+                                             serializer:[STPToken new]
+                                             completion:^(STPToken *object, NSHTTPURLResponse *response, NSError *error) {
+                                                 NSDate *end = [NSDate date];
+                                                 [[STPAnalyticsClient sharedClient] logRUMWithToken:object configuration:configuration response:response start:start end:end];
+                                                 completion(object, error);
+                                             }];
 }
 
 #pragma mark - private helpers
@@ -157,11 +467,11 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 + (void)validateKey:(NSString *)publishableKey {
     NSCAssert(publishableKey != nil && ![publishableKey isEqualToString:@""],
               @"You must use a valid publishable key to create a token. For more info, see https://stripe.com/docs/stripe.js");
-    BOOL secretKey = [publishableKey hasPrefix:@"sk_"];
-    NSCAssert(!secretKey,
+    STPAPIKey *key = [STPAPIKey keyWithString:publishableKey];
+    NSCAssert(key.type != STPAPIKeyTypeSecret,
               @"You are using a secret key to create a token, instead of the publishable one. For more info, see https://stripe.com/docs/stripe.js");
 #ifndef DEBUG
-    if ([publishableKey.lowercaseString hasPrefix:@"pk_test"]) {
+    if (key.type == STPAPIKeyTypePublishable && key.testmode) {
         FAUXPAS_IGNORED_IN_METHOD(NSLogUsed);
         static dispatch_once_t onceToken;
         dispatch_once(&onceToken, ^{
@@ -175,6 +485,28 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 #pragma mark Utility methods -
 
 + (NSString *)stripeUserAgentDetails {
+    // None of this changes while the app is running.
+    static NSString *userAgentDetails;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        userAgentDetails = [self buildStripeUserAgentDetails];
+    });
+    return userAgentDetails;
+}
+
++ (NSDictionary<NSString *, NSString *> *)sharedAdditionalHeaders {
+    static NSDictionary<NSString *, NSString *> *additionalHeaders;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        additionalHeaders = @{
+                              @"X-Stripe-User-Agent": [self stripeUserAgentDetails],
+                              @"Stripe-Version": stripeAPIVersion,
+                              };
+    });
+    return additionalHeaders;
+}
+
++ (NSString *)buildStripeUserAgentDetails {
     NSMutableDictionary *details = [@{
         @"lang": @"objective-c",
         @"bindings_version": STPSDKVersion,
@@ -237,10 +569,10 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 #pragma mark - Bank Accounts
 @implementation STPAPIClient (BankAccounts)
 
-- (void)createTokenWithBankAccount:(STPBankAccountParams *)bankAccount
-                        completion:(STPTokenCompletionBlock)completion {
+- (NSURLSessionDataTask *)createTokenWithBankAccount:(STPBankAccountParams *)bankAccount
+                                          completion:(STPTokenCompletionBlock)completion {
     NSDictionary *params = [STPFormEncoder dictionaryForObject:bankAccount];
-    [self createTokenWithParameters:params completion:completion];
+    return [self createTokenWithParameters:params completion:completion];
 }
 
 @end
@@ -248,16 +580,60 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 #pragma mark - Credit Cards
 @implementation STPAPIClient (CreditCards)
 
-- (void)createTokenWithCard:(STPCard *)card completion:(STPTokenCompletionBlock)completion {
+- (NSURLSessionDataTask *)createTokenWithCard:(STPCard *)card completion:(STPTokenCompletionBlock)completion {
     NSMutableDictionary *params = [[STPFormEncoder dictionaryForObject:card] mutableCopy];
     params[@"muid"] = [STPAnalyticsClient muid];
-    [self createTokenWithParameters:params completion:completion];
+    return [self createTokenWithParameters:params completion:completion];
+}
+
+- (NSProgress *)createTokensWithCards:(NSArray<STPCardParams *> *)cards
+                maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                       itemCompletion:(STPTokenBatchItemCompletionBlock)itemCompletion
+                           completion:(STPTokenBatchCompletionBlock)completion {
+    NSCAssert(cards != nil, @"'cards' is required to create tokens");
+    NSCAssert(completion != nil, @"'completion' is required to use the tokens that are created");
+    STPTokenBatch *batch = [[STPTokenBatch alloc] initWithAPIClient:self
+                                                              cards:cards
+                                              maxConcurrentRequests:maxConcurrentRequests ?: STPTokenBatchDefaultMaxConcurrentRequests
+                                                     itemCompletion:itemCompletion
+                                                         completion:completion];
+    [batch start];
+    return batch.progress;
 }
 
 @end
 
+typedef NS_ENUM(int, STPApplePaySupport) {
+    STPApplePaySupportUnknown,
+    STPApplePaySupportUnavailable,
+    STPApplePaySupportAvailable,
+};
+
+// Checking with PassKit is a round trip to another process, so the answer is
+// kept until the wallet may have changed.
+static _Atomic(int) STPDeviceApplePaySupport = STPApplePaySupportUnknown;
+
 @implementation Stripe (ApplePay)
 
++ (void)observeWalletChanges {
+    static PKPassLibrary *passLibrary;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        void (^invalidate)(NSNotification *) = ^(__unused NSNotification *note) {
+            atomic_store(&STPDeviceApplePaySupport, STPApplePaySupportUnknown);
+        };
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        // The pass library only posts changes while an instance is alive.
+        if ([PKPassLibrary isPassLibraryAvailable]) {
+            passLibrary = [PKPassLibrary new];
+            [center addObserverForName:PKPassLibraryDidChangeNotification object:nil queue:nil usingBlock:invalidate];
+        }
+        // Cards are added in the Wallet or Settings apps, so the user will
+        // have left this one.
+        [center addObserverForName:UIApplicationWillEnterForegroundNotification object:nil queue:nil usingBlock:invalidate];
+    });
+}
+
 + (BOOL)canSubmitPaymentRequest:(PKPaymentRequest *)paymentRequest {
     if (![self deviceSupportsApplePay]) {
         return NO;
@@ -272,15 +648,30 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 }
 
 + (NSArray<NSString *> *)supportedPKPaymentNetworks {
-    NSArray *supportedNetworks = @[PKPaymentNetworkAmex, PKPaymentNetworkMasterCard, PKPaymentNetworkVisa];
-    if ((&PKPaymentNetworkDiscover) != NULL) {
-        supportedNetworks = [supportedNetworks arrayByAddingObject:PKPaymentNetworkDiscover];
-    }
+    static NSArray<NSString *> *supportedNetworks;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSArray *networks = @[PKPaymentNetworkAmex, PKPaymentNetworkMasterCard, PKPaymentNetworkVisa];
+        if ((&PKPaymentNetworkDiscover) != NULL) {
+            networks = [networks arrayByAddingObject:PKPaymentNetworkDiscover];
+        }
+        supportedNetworks = networks;
+    });
     return supportedNetworks;
 }
 
 + (BOOL)deviceSupportsApplePay {
-    return [PKPaymentAuthorizationViewController class] && [PKPaymentAuthorizationViewController canMakePaymentsUsingNetworks:[self supportedPKPaymentNetworks]];
+    if (![PKPaymentAuthorizationViewController class]) {
+        return NO;
+    }
+    [self observeWalletChanges];
+    int support = atomic_load(&STPDeviceApplePaySupport);
+    if (support == STPApplePaySupportUnknown) {
+        BOOL canMakePayments = [PKPaymentAuthorizationViewController canMakePaymentsUsingNetworks:[self supportedPKPaymentNetworks]];
+        support = canMakePayments ? STPApplePaySupportAvailable : STPApplePaySupportUnavailable;
+        atomic_store(&STPDeviceApplePaySupport, support);
+    }
+    return support == STPApplePaySupportAvailable;
 }
 
 + (PKPaymentRequest *)paymentRequestWithMerchantIdentifier:(NSString *)merchantIdentifier {
@@ -299,21 +690,91 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
 
 @implementation STPAPIClient (Sources)
 
-- (void)createSourceWithParams:(STPSourceParams *)sourceParams completion:(STPSourceCompletionBlock)completion {
+- (NSURLSessionDataTask *)createSourceWithParams:(STPSourceParams *)sourceParams completion:(STPSourceCompletionBlock)completion {
     NSCAssert(sourceParams != nil, @"'params' is required to create a source");
     NSCAssert(completion != nil, @"'completion' is required to use the source that is created");
+    return [self createSourceWithParams:sourceParams completionQueue:nil completion:completion];
+}
+
+/**
+ Creates a source, calling back on `completionQueue` if given, or on the
+ client's usual completion queue.
+ */
+- (NSURLSessionDataTask *)createSourceWithParams:(STPSourceParams *)sourceParams
+                                 completionQueue:(dispatch_queue_t)completionQueue
+                                      completion:(STPSourceCompletionBlock)completion {
+    NSDictionary *params = [self parametersForSourceParams:sourceParams];
+    STPSourceCache *sourceCache = self.sourceCache;
+    return [STPAPIRequest<STPSource *> postWithAPIClient:self
+                                                endpoint:sourcesEndpoint
+                                              parameters:params
+                                              serializer:[STPSource new]
+                                         completionQueue:completionQueue
+                                              completion:^(STPSource *object, __unused NSHTTPURLResponse *response, NSError *error) {
+                                                  if (object) {
+                                                      [sourceCache addSource:object];
+                                                  }
+                                                  completion(object, error);
+                                              }];
+}
+
+- (NSString *)enqueueSourceWithParams:(STPSourceParams *)sourceParams {
+    NSCAssert(sourceParams != nil, @"'params' is required to create a source");
+    NSDictionary *params = [self parametersForSourceParams:sourceParams];
+    return [self.sourceCreationQueue enqueueFormData:[STPFormEncoder formDataFromParameters:params]];
+}
+
+/**
+ Logs a creation attempt for `sourceParams` and returns the parameters to
+ POST for it.
+ */
+- (NSDictionary *)parametersForSourceParams:(STPSourceParams *)sourceParams {
     NSString *sourceType = [STPSource stringFromType:sourceParams.type];
-    [[STPAnalyticsClient sharedClient] logSourceCreationAttemptWithConfiguration:self.configuration
+    STPPaymentConfiguration *configuration = [self.configuration configurationSnapshot];
+    [[STPAnalyticsClient sharedClient] logSourceCreationAttemptWithConfiguration:configuration
                                                                       sourceType:sourceType];
-    sourceParams.redirectMerchantName = self.configuration.companyName ?: [NSBundle stp_applicationName];
-    NSDictionary *params = [STPFormEncoder dictionaryForObject:sourceParams];
-    [STPAPIRequest<STPSource *> postWithAPIClient:self
-                                         endpoint:sourcesEndpoint
-                                       parameters:params
-                                       serializer:[STPSource new]
-                                       completion:^(STPSource *object, __unused NSHTTPURLResponse *response, NSError *error) {
-                                           completion(object, error);
-                                       }];
+    sourceParams.redirectMerchantName = configuration.companyName ?: [NSBundle stp_applicationName];
+    return [sourceParams formParameters];
+}
+
+- (void)createThreeDSecureSourceWithCard:(STPCardParams *)card
+                                  amount:(NSUInteger)amount
+                                currency:(NSString *)currency
+                               returnURL:(NSString *)returnURL
+                              completion:(STPThreeDSecureSourceCompletionBlock)completion {
+    NSCAssert(card != nil, @"'card' is required to create a source");
+    NSCAssert(completion != nil, @"'completion' is required to use the sources that are created");
+    dispatch_queue_t completionQueue = self.completionQueue ?: dispatch_get_main_queue();
+    void (^finish)(STPSource *, STPSource *, NSTimeInterval, NSTimeInterval, NSError *) = ^(STPSource *cardSource, STPSource *threeDSecureSource, NSTimeInterval cardDuration, NSTimeInterval threeDSecureDuration, NSError *error) {
+        dispatch_block_t block = ^{
+            completion(cardSource, threeDSecureSource, cardDuration, threeDSecureDuration, error);
+        };
+        if (completionQueue == dispatch_get_main_queue()) {
+            stpDispatchToMainThreadIfNecessary(block);
+        } else {
+            dispatch_async(completionQueue, block);
+        }
+    };
+    // Both stages call back on a background queue, so the second request goes
+    // out as soon as the first is decoded rather than waiting its turn on the
+    // main thread.
+    dispatch_queue_t stageQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+    CFAbsoluteTime cardStart = CFAbsoluteTimeGetCurrent();
+    [self createSourceWithParams:[STPSourceParams cardParamsWithCard:card] completionQueue:stageQueue completion:^(STPSource *cardSource, NSError *cardError) {
+        NSTimeInterval cardDuration = CFAbsoluteTimeGetCurrent() - cardStart;
+        if (cardError || cardSource.cardDetails.threeDSecure == STPSourceCard3DSecureStatusNotSupported) {
+            finish(cardSource, nil, cardDuration, 0, cardError);
+            return;
+        }
+        CFAbsoluteTime threeDSecureStart = CFAbsoluteTimeGetCurrent();
+        STPSourceParams *threeDSecureParams = [STPSourceParams threeDSecureParamsWithAmount:amount
+                                                                                   currency:currency
+                                                                                  returnURL:returnURL
+                                                                                       card:cardSource.stripeID];
+        [self createSourceWithParams:threeDSecureParams completionQueue:stageQueue completion:^(STPSource *threeDSecureSource, NSError *threeDSecureError) {
+            finish(cardSource, threeDSecureSource, cardDuration, CFAbsoluteTimeGetCurrent() - threeDSecureStart, threeDSecureError);
+        }];
+    }];
 }
 
 - (void)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret completion:(STPSourceCompletionBlock)completion {
@@ -325,36 +786,210 @@ static NSString *const stripeAPIVersion = @"2015-10-12";
     }];
 }
 
+- (void)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret cachePolicy:(STPSourceCachePolicy)cachePolicy completion:(STPSourceCompletionBlock)completion {
+    NSCAssert(identifier != nil, @"'identifier' is required to retrieve a source");
+    NSCAssert(secret != nil, @"'secret' is required to retrieve a source");
+    NSCAssert(completion != nil, @"'completion' is required to use the source that is retrieved");
+    STPSource *cachedSource = nil;
+    if (cachePolicy == STPSourceCachePolicyReturnCacheElseLoad) {
+        cachedSource = [self.sourceCache sourceWithId:identifier clientSecret:secret];
+    }
+    if (cachedSource) {
+        dispatch_async(self.completionQueue, ^{
+            completion(cachedSource, nil);
+        });
+        return;
+    }
+    [self retrieveSourceWithId:identifier clientSecret:secret completion:completion];
+}
+
 - (NSURLSessionDataTask *)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret responseCompletion:(STPAPIResponseBlock)completion {
+    return [self retrieveSourceWithId:identifier clientSecret:secret previousSource:nil entityTag:nil responseCompletion:completion];
+}
+
+- (NSURLSessionDataTask *)retrieveSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret previousSource:(STPSource *)previousSource entityTag:(NSString *)entityTag responseCompletion:(STPAPIResponseBlock)completion {
     NSString *endpoint = [NSString stringWithFormat:@"%@/%@", sourcesEndpoint, identifier];
     NSDictionary *parameters = @{@"client_secret": secret};
     return [STPAPIRequest<STPSource *> getWithAPIClient:self
                                                endpoint:endpoint
                                              parameters:parameters
-                                             serializer:[STPSource new]
-                                             completion:completion];
+                                              entityTag:entityTag
+                                                 hedged:self.hedgesSourceRetrievals
+                                             serializer:previousSource ?: [STPSource new]
+                                             completion:[self sourceCachingResponseCompletion:completion previousSource:previousSource]];
+}
+
+- (NSURLSessionDataTask *)waitForSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret previousSource:(STPSource *)previousSource entityTag:(NSString *)entityTag waitInterval:(NSTimeInterval)waitInterval responseCompletion:(STPAPIResponseBlock)completion {
+    NSString *endpoint = [NSString stringWithFormat:@"%@/%@", sourcesEndpoint, identifier];
+    NSDictionary *parameters = @{@"client_secret": secret};
+    return [STPAPIRequest<STPSource *> longPollWithAPIClient:self
+                                                    endpoint:endpoint
+                                                  parameters:parameters
+                                                   entityTag:entityTag
+                                                waitInterval:waitInterval
+                                                  serializer:previousSource ?: [STPSource new]
+                                                  completion:[self sourceCachingResponseCompletion:completion previousSource:previousSource]];
+}
+
+/**
+ Wraps `completion` to add each fetched source to `sourceCache`. A 304
+ response means `previousSource` is still current, so that's added instead.
+ */
+- (STPAPIResponseBlock)sourceCachingResponseCompletion:(STPAPIResponseBlock)completion previousSource:(STPSource *)previousSource {
+    STPSourceCache *sourceCache = self.sourceCache;
+    return ^(STPSource *object, NSHTTPURLResponse *response, NSError *error) {
+        if (object) {
+            [sourceCache addSource:object];
+        } else if (previousSource && !error && response.statusCode == 304) {
+            [sourceCache addSource:previousSource];
+        }
+        completion(object, response, error);
+    };
 }
 
 - (void)startPollingSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret timeout:(NSTimeInterval)timeout completion:(STPSourceCompletionBlock)completion {
-    [self stopPollingSourceWithId:identifier];
-    STPSourcePoller *poller = [[STPSourcePoller alloc] initWithAPIClient:self
-                                                            clientSecret:secret
-                                                                sourceID:identifier
-                                                                 timeout:timeout
-                                                              completion:completion];
-    dispatch_async(self.sourcePollersQueue, ^{
-        self.sourcePollers[identifier] = poller;
+    NSObject *pendingPoll = [NSObject new];
+    dispatch_sync(self.sourcePollersQueue, ^{
+        [self stopRegisteredSourcePollerWithId:identifier];
+        self.pendingSourcePolls[identifier] = pendingPoll;
+    });
+    // Pollers share a main run loop scheduler, so they're only touched
+    // on the main thread.
+    stpDispatchToMainThreadIfNecessary(^{
+        STPSourcePoller *poller = [[STPSourcePoller alloc] initWithAPIClient:self
+                                                                clientSecret:secret
+                                                                    sourceID:identifier
+                                                                     timeout:timeout
+                                                                      engine:self.longPollsSources ? STPSourcePollerEngineLongPoll : STPSourcePollerEngineTimer
+                                                                  completion:completion];
+        dispatch_async(self.sourcePollersQueue, ^{
+            if (self.pendingSourcePolls[identifier] != pendingPoll) {
+                // Stopped, or started again, before it got here
+                stpDispatchToMainThreadIfNecessary(^{
+                    [poller stopPolling];
+                });
+                return;
+            }
+            [self.pendingSourcePolls removeObjectForKey:identifier];
+            [self registerSourcePoller:poller identifier:identifier];
+        });
     });
 }
 
+// Only called on sourcePollersQueue
+- (void)registerSourcePoller:(STPSourcePoller *)poller identifier:(NSString *)identifier {
+    [self.sourcePollerOrder removeObject:identifier];
+    self.sourcePollers[identifier] = poller;
+    [self.sourcePollerOrder addObject:identifier];
+    _sourcePollerMetrics.registeredCount++;
+    // The oldest poll is the most likely to have been abandoned, so it
+    // makes way. It finishes with a cancellation error rather than as if it
+    // had timed out, since its source may still change.
+    while (self.sourcePollers.count > MaxSourcePollers) {
+        NSString *oldestIdentifier = self.sourcePollerOrder.firstObject;
+        STPSourcePoller *oldestPoller = (STPSourcePoller *)self.sourcePollers[oldestIdentifier];
+        [self.sourcePollerOrder removeObjectAtIndex:0];
+        self.sourcePollers[oldestIdentifier] = nil;
+        _sourcePollerMetrics.evictedCount++;
+        NSError *error = [self.class sourcePollerEvictedError];
+        stpDispatchToMainThreadIfNecessary(^{
+            [oldestPoller finishPollingWithError:error];
+        });
+    }
+    _sourcePollerMetrics.activeCount = self.sourcePollers.count;
+    _sourcePollerMetrics.peakCount = MAX(_sourcePollerMetrics.peakCount, _sourcePollerMetrics.activeCount);
+    STPSignpostEvent("Source pollers", "%lu", (unsigned long)_sourcePollerMetrics.activeCount);
+}
+
++ (NSError *)sourcePollerEvictedError {
+    NSDictionary *userInfo = @{
+                               NSLocalizedDescriptionKey: STPLocalizedString(@"The operation was cancelled", @"Error message for network request being cancelled."),
+                               STPErrorMessageKey: [NSString stringWithFormat:@"Polling was stopped to make way for newer polls, as no more than %lu sources are polled at once.", (unsigned long)MaxSourcePollers],
+                               };
+    return [NSError errorWithDomain:StripeDomain code:STPCancellationError userInfo:userInfo];
+}
+
+// Only called on sourcePollersQueue. Leaves a newer poll for the same
+// source in place.
+- (void)unregisterSourcePoller:(STPSourcePoller *)poller identifier:(NSString *)identifier {
+    STPSourcePoller *registeredPoller = (STPSourcePoller *)self.sourcePollers[identifier];
+    if (!registeredPoller || (poller && registeredPoller != poller)) {
+        return;
+    }
+    self.sourcePollers[identifier] = nil;
+    [self.sourcePollerOrder removeObject:identifier];
+    _sourcePollerMetrics.activeCount = self.sourcePollers.count;
+    STPSignpostEvent("Source pollers", "%lu", (unsigned long)_sourcePollerMetrics.activeCount);
+}
+
 - (void)stopPollingSourceWithId:(NSString *)identifier {
     dispatch_async(self.sourcePollersQueue, ^{
-        STPSourcePoller *poller = (STPSourcePoller *)self.sourcePollers[identifier];
-        if (poller) {
+        [self.pendingSourcePolls removeObjectForKey:identifier];
+        [self stopRegisteredSourcePollerWithId:identifier];
+    });
+}
+
+// Only called on sourcePollersQueue
+- (void)stopRegisteredSourcePollerWithId:(NSString *)identifier {
+    STPSourcePoller *poller = (STPSourcePoller *)self.sourcePollers[identifier];
+    if (poller) {
+        [self unregisterSourcePoller:nil identifier:identifier];
+        stpDispatchToMainThreadIfNecessary(^{
             [poller stopPolling];
-            self.sourcePollers[identifier] = nil;
-        }
+        });
+    }
+}
+
+- (void)sourcePollerDidStop:(STPSourcePoller *)poller {
+    NSString *identifier = poller.sourceID;
+    dispatch_async(self.sourcePollersQueue, ^{
+        [self unregisterSourcePoller:poller identifier:identifier];
+    });
+}
+
+- (STPSourcePollerRegistryMetrics)sourcePollerRegistryMetrics {
+    __block STPSourcePollerRegistryMetrics metrics;
+    dispatch_sync(self.sourcePollersQueue, ^{
+        metrics = self->_sourcePollerMetrics;
+    });
+    return metrics;
+}
+
+- (BOOL)startBackgroundPollingSourceWithId:(NSString *)identifier clientSecret:(NSString *)secret deadline:(NSDate *)deadline {
+    STPSourceBackgroundPoller *backgroundPoller = self.sourceBackgroundPoller;
+    if (!backgroundPoller) {
+        return NO;
+    }
+    NSString *endpoint = [NSString stringWithFormat:@"%@/%@", sourcesEndpoint, identifier];
+    NSMutableURLRequest *request = [self configuredRequestForEndpoint:endpoint];
+    [request stp_addParametersToURL:@{@"client_secret": secret}];
+    request.HTTPMethod = @"GET";
+    [backgroundPoller startPollingSourceWithId:identifier request:request deadline:deadline];
+    return YES;
+}
+
+- (void)stopBackgroundPollingSourceWithId:(NSString *)identifier {
+    [self.sourceBackgroundPoller stopPollingSourceWithId:identifier];
+}
+
+- (BOOL)deliverBackgroundPolledSource:(STPSource *)source {
+    [self.sourceCache addSource:source];
+    __block STPSourcePoller *poller;
+    dispatch_sync(self.sourcePollersQueue, ^{
+        poller = (STPSourcePoller *)self.sourcePollers[source.stripeID];
+    });
+    if (poller) {
+        [poller finishPollingWithSource:source];
+        return YES;
+    }
+    id<STPAPIClientBackgroundPollingDelegate> delegate = self.backgroundPollingDelegate;
+    if (!delegate) {
+        return NO;
+    }
+    dispatch_async(self.completionQueue, ^{
+        [delegate apiClient:self didFinishPollingSourceInBackground:source];
     });
+    return YES;
 }
 
 @end
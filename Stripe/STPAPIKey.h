@@ -0,0 +1,48 @@
+//
+//  STPAPIKey.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, STPAPIKeyType) {
+    STPAPIKeyTypeUnknown,
+    STPAPIKeyTypePublishable,
+    STPAPIKeyTypeSecret,
+    STPAPIKeyTypeRestricted,
+};
+
+/**
+ What can be told about an API key from its prefix. Keys are parsed once per
+ key string and shared, so clients created for the same key don't re-parse it.
+ */
+@interface STPAPIKey : NSObject
+
+/**
+ The parsed key for `string`, from a cache shared by the whole process.
+ */
++ (instancetype)keyWithString:(NSString *)string;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, copy, readonly) NSString *string;
+@property (nonatomic, readonly) STPAPIKeyType type;
+
+/**
+ YES for `pk_live_` style keys, NO for test keys and keys of unknown mode.
+ */
+@property (nonatomic, readonly, getter=isLivemode) BOOL livemode;
+
+/**
+ YES for `pk_test_` style keys.
+ */
+@property (nonatomic, readonly, getter=isTestmode) BOOL testmode;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,78 @@
+//
+//  STPAPIKey.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPAPIKey.h"
+
+@interface STPAPIKey ()
+@property (nonatomic, copy, readwrite) NSString *string;
+@property (nonatomic, readwrite) STPAPIKeyType type;
+@property (nonatomic, readwrite) BOOL livemode;
+@property (nonatomic, readwrite) BOOL testmode;
+@end
+
+@implementation STPAPIKey
+
++ (instancetype)keyWithString:(NSString *)string {
+    static NSCache<NSString *, STPAPIKey *> *keys;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        keys = [NSCache new];
+        keys.name = @"com.stripe.apikeys";
+    });
+    NSString *keyString = string ?: @"";
+    STPAPIKey *key = [keys objectForKey:keyString];
+    if (!key) {
+        key = [[self alloc] initWithString:keyString];
+        [keys setObject:key forKey:keyString];
+    }
+    return key;
+}
+
+- (instancetype)initWithString:(NSString *)string {
+    self = [super init];
+    if (self) {
+        _string = [string copy];
+        // Keys are lowercase, but this used to be matched case-insensitively
+        NSString *lowercaseString = string.lowercaseString;
+        if ([lowercaseString hasPrefix:@"pk_"]) {
+            _type = STPAPIKeyTypePublishable;
+        } else if ([lowercaseString hasPrefix:@"sk_"]) {
+            _type = STPAPIKeyTypeSecret;
+        } else if ([lowercaseString hasPrefix:@"rk_"]) {
+            _type = STPAPIKeyTypeRestricted;
+        }
+        if (_type != STPAPIKeyTypeUnknown) {
+            NSString *mode = [lowercaseString substringFromIndex:3];
+            _testmode = [mode hasPrefix:@"test"];
+            _livemode = [mode hasPrefix:@"live"];
+        }
+    }
+    return self;
+}
+
+- (NSString *)description {
+    NSString *type;
+    switch (self.type) {
+        case STPAPIKeyTypePublishable:
+            type = @"publishable";
+            break;
+        case STPAPIKeyTypeSecret:
+            type = @"secret";
+            break;
+        case STPAPIKeyTypeRestricted:
+            type = @"restricted";
+            break;
+        case STPAPIKeyTypeUnknown:
+            type = @"unknown";
+            break;
+    }
+    NSString *mode = self.livemode ? @"live" : (self.testmode ? @"test" : @"unknown");
+    return [NSString stringWithFormat:@"<%@: %p; type = %@; mode = %@>", NSStringFromClass([self class]), self, type, mode];
+}
+
+@end
@@ -10,20 +10,145 @@
 #import "STPAPIResponseDecodable.h"
 @class STPAPIClient;
 
+/**
+ Implemented by serializers that can decode a response as an update of
+ themselves, keeping whatever was decoded from fields that haven't changed.
+ Pass the object from the previous response as the serializer to use it.
+ */
+@protocol STPAPIResponseUpdatable <STPAPIResponseDecodable>
+
+- (id<STPAPIResponseDecodable>)updatedObjectFromAPIResponse:(NSDictionary *)response;
+
+@end
+
 @interface STPAPIRequest<__covariant ResponseType:id<STPAPIResponseDecodable>> : NSObject
 
 typedef void(^STPAPIResponseBlock)(ResponseType object, NSHTTPURLResponse *response, NSError *error);
 
+/**
+ Requests other than long polls time out sooner than the session default once
+ their host has answered a few quickly, so a stalled connection is given up
+ on (and for a POST, retried) in seconds rather than a minute.
+
+ POSTs carry an `Idempotency-Key`, and are retried with jittered backoff after
+ a dropped connection, a timeout or a 5xx, up to three attempts in all and none
+ starting more than 30 seconds after the first. The returned task stands for
+ every attempt: cancelling it cancels the attempt in flight and any retry not
+ yet sent, and the completion gets `NSURLErrorCancelled`.
+ */
++ (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
+                                   endpoint:(NSString *)endpoint
+                                 parameters:(NSDictionary *)parameters
+                                 serializer:(ResponseType)serializer
+                                 completion:(STPAPIResponseBlock)completion;
+
+/**
+ A POST whose completion runs on `completionQueue` instead of the client's
+ completion queue, for chaining a follow-up request without a trip through
+ the main thread. Pass nil to use the client's queue.
+ */
 + (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
                                    endpoint:(NSString *)endpoint
                                  parameters:(NSDictionary *)parameters
                                  serializer:(ResponseType)serializer
+                            completionQueue:(dispatch_queue_t)completionQueue
+                                 completion:(STPAPIResponseBlock)completion;
+
+/**
+ A POST of an already form-encoded body, sent with `idempotencyKey` rather
+ than a newly generated one, for replaying a request saved earlier.
+ */
++ (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
+                                   endpoint:(NSString *)endpoint
+                                   formData:(NSData *)formData
+                             idempotencyKey:(NSString *)idempotencyKey
+                                 serializer:(ResponseType)serializer
+                            completionQueue:(dispatch_queue_t)completionQueue
                                  completion:(STPAPIResponseBlock)completion;
 
+/**
+ GETs are assumed to be idempotent: while a request is in flight, identical
+ requests (same session, endpoint, parameters and serializer) share its task
+ rather than opening a new one, and the decoded response is delivered to every
+ completion block. Each caller gets a task of its own: cancelling it answers
+ that caller with `NSURLErrorCancelled` straight away, and only cancels the
+ request once no other caller is waiting on it.
+ */
 + (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
                                   endpoint:(NSString *)endpoint
                                 parameters:(NSDictionary *)parameters
                                 serializer:(id<STPAPIResponseDecodable>)serializer
                                 completion:(STPAPIResponseBlock)completion;
 
+/**
+ A GET sent with `If-None-Match: entityTag`, the `ETag` of a response already
+ decoded. If the resource hasn't changed, the server answers 304 with no body,
+ and `completion` is called with the response but neither an object nor an
+ error, without anything being decoded.
+ */
++ (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
+                                  endpoint:(NSString *)endpoint
+                                parameters:(NSDictionary *)parameters
+                                 entityTag:(NSString *)entityTag
+                                serializer:(id<STPAPIResponseDecodable>)serializer
+                                completion:(STPAPIResponseBlock)completion;
+
+/**
+ A conditional GET that, if `hedged`, sends a duplicate when the first attempt
+ hasn't answered within about as long as most responses from the host take,
+ and delivers whichever answers first, cancelling the other. Nothing is
+ duplicated until the host has answered at least once. Cancelling the
+ returned task cancels both.
+ */
++ (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
+                                  endpoint:(NSString *)endpoint
+                                parameters:(NSDictionary *)parameters
+                                 entityTag:(NSString *)entityTag
+                                    hedged:(BOOL)hedged
+                                serializer:(id<STPAPIResponseDecodable>)serializer
+                                completion:(STPAPIResponseBlock)completion;
+
+/**
+ A GET that asks the server to hold its response for up to `waitInterval`
+ seconds while the resource is unchanged, using an RFC 7240 `Prefer: wait`
+ header. Servers that honor it echo `Preference-Applied: wait`; others answer
+ immediately, like a plain GET. Long polls never share a task with other
+ in-flight GETs.
+ */
++ (NSURLSessionDataTask *)longPollWithAPIClient:(STPAPIClient *)apiClient
+                                       endpoint:(NSString *)endpoint
+                                     parameters:(NSDictionary *)parameters
+                                   waitInterval:(NSTimeInterval)waitInterval
+                                     serializer:(id<STPAPIResponseDecodable>)serializer
+                                     completion:(STPAPIResponseBlock)completion;
+
+/**
+ A long poll sent with `If-None-Match: entityTag`. A 304 is delivered as in
+ `getWithAPIClient:endpoint:parameters:entityTag:serializer:completion:`.
+ */
++ (NSURLSessionDataTask *)longPollWithAPIClient:(STPAPIClient *)apiClient
+                                       endpoint:(NSString *)endpoint
+                                     parameters:(NSDictionary *)parameters
+                                      entityTag:(NSString *)entityTag
+                                   waitInterval:(NSTimeInterval)waitInterval
+                                     serializer:(id<STPAPIResponseDecodable>)serializer
+                                     completion:(STPAPIResponseBlock)completion;
+
+/**
+ The number of POSTs in flight across every client, including any waiting to
+ retry. POSTs are the calls a user is waiting on, so their tasks run at high
+ priority, and background work like source polling holds off while this is
+ nonzero.
+ */
++ (NSInteger)userBlockingRequestCount;
+
+#if DEBUG
+/**
+ A line for each request in flight across every client, e.g.
+ `POST tokens 0.4s`, for the performance HUD. A POST waiting to retry counts
+ from its first attempt.
+ */
++ (NSArray<NSString *> *)inFlightRequestDescriptions;
+#endif
+
 @end
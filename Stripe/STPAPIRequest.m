@@ -8,13 +8,174 @@
 
 #import "STPAPIRequest.h"
 
+#import <stdatomic.h>
+
+#import "NSData+Stripe_Gzip.h"
 #import "NSMutableURLRequest+Stripe.h"
 #import "STPAPIClient+Private.h"
 #import "STPAPIClient.h"
+#import "STPAPIRequestMetrics+Private.h"
+#import "STPAnalyticsClient.h"
 #import "STPDispatchFunctions.h"
 #import "STPFormEncoder.h"
+#import "STPHostResponseTimes.h"
+#import "STPPerformanceCounters.h"
+#import "STPRUMCollector.h"
+#import "STPSignpost.h"
+#import "STPURLSessionPool.h"
 #import "StripeError.h"
 
+static NSTimeInterval const LongPollTimeoutGracePeriod = 10;
+
+static NSUInteger const PostMaxAttempts = 3;
+static NSTimeInterval const PostRetryBaseDelay = 0.5;
+static NSTimeInterval const PostRetryMaxDelay = 4;
+// No attempt starts more than this long after the first one did.
+static NSTimeInterval const PostRetryDeadline = 30;
+
+static atomic_long userBlockingRequestCount;
+
+// Smaller bodies fit in a packet or two anyway
+static NSUInteger const CompressionThreshold = 1024;
+
+/**
+ The task returned to one caller of a GET that other callers may share, or to
+ the caller of a POST that may be retried. It stands in for the session task
+ carrying the request, so that cancelling it only ends this caller's wait (the
+ session task itself is only cancelled once nobody else is waiting on it), and
+ so that cancelling a POST also stops any retry that hasn't been sent yet.
+ */
+@interface STPAPIRequestTask : NSURLSessionDataTask
+- (instancetype)initWithTask:(NSURLSessionDataTask *)task;
+/**
+ The session task carrying the request, or for a POST, its latest attempt.
+ */
+@property (atomic) NSURLSessionDataTask *currentTask;
+@property (atomic, copy) STPAPIResponseBlock completion;
+/**
+ Called on the first `-cancel`, unless the request has already finished.
+ */
+@property (atomic, copy) dispatch_block_t cancellationHandler;
+@property (atomic, readonly, getter=isCancelled) BOOL cancelled;
+/**
+ Set once the caller's completion has been handed its answer.
+ */
+@property (atomic) BOOL finished;
+@end
+
+@implementation STPAPIRequestTask {
+    BOOL _cancelled;
+}
+
+- (instancetype)initWithTask:(NSURLSessionDataTask *)task {
+    self = [super init];
+    if (self) {
+        _currentTask = task;
+    }
+    return self;
+}
+
+- (BOOL)isCancelled {
+    @synchronized(self) {
+        return _cancelled;
+    }
+}
+
+- (void)cancel {
+    dispatch_block_t cancellationHandler;
+    @synchronized(self) {
+        if (_cancelled) {
+            return;
+        }
+        _cancelled = YES;
+        cancellationHandler = self.cancellationHandler;
+        self.cancellationHandler = nil;
+    }
+    if (cancellationHandler) {
+        cancellationHandler();
+    }
+}
+
+- (NSURLSessionTaskState)state {
+    if (self.finished) {
+        return NSURLSessionTaskStateCompleted;
+    }
+    if (self.isCancelled) {
+        return NSURLSessionTaskStateCanceling;
+    }
+    // Between a POST's attempts, and while a response is being decoded, the
+    // caller is still waiting.
+    NSURLSessionTaskState state = self.currentTask.state;
+    return state == NSURLSessionTaskStateCompleted ? NSURLSessionTaskStateRunning : state;
+}
+
+- (void)resume {
+    [self.currentTask resume];
+}
+
+- (void)suspend {
+    [self.currentTask suspend];
+}
+
+- (NSUInteger)taskIdentifier {
+    return self.currentTask.taskIdentifier;
+}
+
+- (NSURLRequest *)originalRequest {
+    return self.currentTask.originalRequest;
+}
+
+- (NSURLRequest *)currentRequest {
+    return self.currentTask.currentRequest;
+}
+
+- (NSURLResponse *)response {
+    return self.currentTask.response;
+}
+
+- (NSError *)error {
+    return self.currentTask.error;
+}
+
+@end
+
+/**
+ A GET that is currently in flight, along with every caller waiting on its
+ response. Debug builds also keep one for each POST in flight, with only an
+ endpoint and start time.
+ */
+@interface STPAPIInFlightRequest : NSObject
+@property (nonatomic, copy) NSString *endpoint;
+@property (nonatomic) CFAbsoluteTime startTime;
+@property (nonatomic) NSURLSessionDataTask *task;
+/**
+ The duplicate of `task` sent when it was slow, if any.
+ */
+@property (nonatomic) NSURLSessionDataTask *hedgeTask;
+/**
+ The attempts that haven't finished yet.
+ */
+@property (nonatomic) NSUInteger runningAttempts;
+/**
+ Reported for whichever attempt answers.
+ */
+@property (nonatomic) STPAPIRequestMetrics *metrics;
+@property (nonatomic) NSMutableArray<STPAPIRequestTask *> *waiters;
+@end
+
+@implementation STPAPIInFlightRequest
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _waiters = [NSMutableArray array];
+        _startTime = CFAbsoluteTimeGetCurrent();
+    }
+    return self;
+}
+
+@end
+
 @implementation STPAPIRequest
 
 + (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
@@ -22,71 +183,726 @@
                                  parameters:(NSDictionary *)parameters
                                  serializer:(id<STPAPIResponseDecodable>)serializer
                                  completion:(STPAPIResponseBlock)completion {
+    return [self postWithAPIClient:apiClient
+                          endpoint:endpoint
+                        parameters:parameters
+                        serializer:serializer
+                   completionQueue:nil
+                        completion:completion];
+}
+
++ (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
+                                   endpoint:(NSString *)endpoint
+                                 parameters:(NSDictionary *)parameters
+                                 serializer:(id<STPAPIResponseDecodable>)serializer
+                            completionQueue:(dispatch_queue_t)completionQueue
+                                 completion:(STPAPIResponseBlock)completion {
+    STPSignpostIntervalBegin("Form encoding", parameters);
+    NSData *formData = [STPFormEncoder formDataFromParameters:parameters];
+    STPSignpostIntervalEnd("Form encoding", parameters);
+    return [self postWithAPIClient:apiClient
+                          endpoint:endpoint
+                          formData:formData
+                    idempotencyKey:[NSUUID UUID].UUIDString
+                        serializer:serializer
+                   completionQueue:completionQueue
+                        completion:completion];
+}
+
++ (NSURLSessionDataTask *)postWithAPIClient:(STPAPIClient *)apiClient
+                                   endpoint:(NSString *)endpoint
+                                   formData:(NSData *)formData
+                             idempotencyKey:(NSString *)idempotencyKey
+                                 serializer:(id<STPAPIResponseDecodable>)serializer
+                            completionQueue:(dispatch_queue_t)completionQueue
+                                 completion:(STPAPIResponseBlock)completion {
 
-    NSURL *url = [apiClient.apiURL URLByAppendingPathComponent:endpoint];
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:url];
+    NSMutableURLRequest *request = [apiClient configuredRequestForEndpoint:endpoint];
     request.HTTPMethod = @"POST";
-    NSString *query = [STPFormEncoder queryStringFromParameters:parameters];
-    request.HTTPBody = [query dataUsingEncoding:NSUTF8StringEncoding];
+    request.timeoutInterval = [[STPHostResponseTimes sharedResponseTimes] timeoutIntervalForHost:request.URL.host defaultTimeout:request.timeoutInterval];
+    // Every attempt carries the same key, so if an earlier one reached Stripe
+    // before the connection dropped, a retry gets its response replayed rather
+    // than creating a second token.
+    [request setValue:idempotencyKey forHTTPHeaderField:@"Idempotency-Key"];
+    request.HTTPBody = formData;
+    if (apiClient.compressesRequestBodies && request.HTTPBody.length >= CompressionThreshold) {
+        NSData *compressedBody = [request.HTTPBody stp_gzippedData];
+        if (compressedBody && compressedBody.length < request.HTTPBody.length) {
+            request.HTTPBody = compressedBody;
+            [request setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+        }
+    }
     
+    // Analytics uploads wait until payment requests like this one finish
+    [[STPAnalyticsClient sharedClient] apiRequestDidStart];
+    atomic_fetch_add(&userBlockingRequestCount, 1);
+#if DEBUG
+    [self postDidStartWithEndpoint:endpoint idempotencyKey:idempotencyKey];
+#endif
+    STPAPIRequestTask *requestTask = [[STPAPIRequestTask alloc] initWithTask:nil];
+    __weak STPAPIRequestTask *weakRequestTask = requestTask;
+    requestTask.cancellationHandler = ^{
+        [weakRequestTask.currentTask cancel];
+    };
+    [self sendPostRequest:request
+                 endpoint:endpoint
+                apiClient:apiClient
+               serializer:serializer
+          completionQueue:completionQueue
+                  attempt:1
+                 deadline:CFAbsoluteTimeGetCurrent() + PostRetryDeadline
+              requestTask:requestTask
+               completion:completion];
+    return requestTask;
+}
+
++ (void)sendPostRequest:(NSURLRequest *)request
+               endpoint:(NSString *)endpoint
+              apiClient:(STPAPIClient *)apiClient
+             serializer:(id<STPAPIResponseDecodable>)serializer
+        completionQueue:(dispatch_queue_t)completionQueue
+                attempt:(NSUInteger)attempt
+               deadline:(CFAbsoluteTime)deadline
+            requestTask:(STPAPIRequestTask *)requestTask
+             completion:(STPAPIResponseBlock)completion {
+    STPAPIRequestMetrics *metrics = [self metricsForRequest:request endpoint:endpoint apiClient:apiClient];
+    __block __weak NSURLSessionDataTask *weakTask;
     NSURLSessionDataTask *task = [apiClient.urlSession dataTaskWithRequest:request completionHandler:^(NSData * _Nullable body, NSURLResponse * _Nullable response, NSError * _Nullable error) {
-        [[self class] parseResponse:response
-                               body:body
-                              error:error
+        STPSignpostIntervalEnd("Network", request);
+        STPPerformanceCounterAdd(STPPerformanceCounterBytesReceived, body.length);
+        [self collectMetrics:metrics forTask:weakTask recordingResponseTime:YES];
+        if (requestTask.isCancelled) {
+            // The caller gave up, even if this attempt got an answer first.
+            [self finishPostRequest:request
+                           response:nil
+                               body:nil
+                              error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]
+                          apiClient:apiClient
                          serializer:serializer
+                    completionQueue:completionQueue
+                            metrics:metrics
+                        requestTask:requestTask
                          completion:completion];
+            return;
+        }
+        if (attempt < PostMaxAttempts && [self shouldRetryResponse:response error:error]) {
+            NSTimeInterval delay = [self retryDelayAfterAttempt:attempt];
+            if (CFAbsoluteTimeGetCurrent() + delay < deadline) {
+                STPSignpostEvent("POST retry", "%lu", (unsigned long)attempt);
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                    if (requestTask.isCancelled) {
+                        [self finishPostRequest:request
+                                       response:nil
+                                           body:nil
+                                          error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]
+                                      apiClient:apiClient
+                                     serializer:serializer
+                                completionQueue:completionQueue
+                                        metrics:metrics
+                                    requestTask:requestTask
+                                     completion:completion];
+                        return;
+                    }
+                    [self sendPostRequest:request
+                                 endpoint:endpoint
+                                apiClient:apiClient
+                               serializer:serializer
+                          completionQueue:completionQueue
+                                  attempt:attempt + 1
+                                 deadline:deadline
+                              requestTask:requestTask
+                               completion:completion];
+                });
+                return;
+            }
+        }
+        [self finishPostRequest:request
+                       response:response
+                           body:body
+                          error:error
+                      apiClient:apiClient
+                     serializer:serializer
+                completionQueue:completionQueue
+                        metrics:metrics
+                    requestTask:requestTask
+                     completion:completion];
     }];
+    weakTask = task;
+    task.priority = NSURLSessionTaskPriorityHigh;
+    requestTask.currentTask = task;
+    [self countRequest:request endpoint:endpoint];
+    STPSignpostIntervalBegin("Network", request);
     [task resume];
-    return task;
+    // -cancel sets the flag before cancelling currentTask, so a cancel that
+    // landed on the previous attempt is caught here.
+    if (requestTask.isCancelled) {
+        [task cancel];
+    }
+}
+
++ (void)finishPostRequest:(NSURLRequest *)request
+                 response:(NSURLResponse *)response
+                     body:(NSData *)body
+                    error:(NSError *)error
+                apiClient:(STPAPIClient *)apiClient
+               serializer:(id<STPAPIResponseDecodable>)serializer
+          completionQueue:(dispatch_queue_t)completionQueue
+                  metrics:(STPAPIRequestMetrics *)metrics
+              requestTask:(STPAPIRequestTask *)requestTask
+               completion:(STPAPIResponseBlock)completion {
+    requestTask.cancellationHandler = nil;
+    requestTask.finished = YES;
+    atomic_fetch_sub(&userBlockingRequestCount, 1);
+#if DEBUG
+    [self postDidFinishWithIdempotencyKey:[request valueForHTTPHeaderField:@"Idempotency-Key"]];
+#endif
+    [[STPAnalyticsClient sharedClient] apiRequestDidFinish];
+    [[self class] parseResponse:response
+                           body:body
+                          error:error
+                      apiClient:apiClient
+                     serializer:serializer
+                completionQueue:completionQueue
+                        metrics:metrics
+                     completion:completion];
+}
+
++ (NSInteger)userBlockingRequestCount {
+    return atomic_load(&userBlockingRequestCount);
+}
+
++ (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
+                                  endpoint:(NSString *)endpoint
+                                parameters:(NSDictionary *)parameters
+                                serializer:(id<STPAPIResponseDecodable>)serializer
+                                completion:(STPAPIResponseBlock)completion {
+    return [self getWithAPIClient:apiClient
+                         endpoint:endpoint
+                       parameters:parameters
+                        entityTag:nil
+                       serializer:serializer
+                       completion:completion];
 }
 
 + (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
                                   endpoint:(NSString *)endpoint
                                 parameters:(NSDictionary *)parameters
+                                 entityTag:(NSString *)entityTag
                                 serializer:(id<STPAPIResponseDecodable>)serializer
                                 completion:(STPAPIResponseBlock)completion {
+    return [self getWithAPIClient:apiClient
+                         endpoint:endpoint
+                       parameters:parameters
+                        entityTag:entityTag
+                           hedged:NO
+                       serializer:serializer
+                       completion:completion];
+}
+
++ (NSURLSessionDataTask *)getWithAPIClient:(STPAPIClient *)apiClient
+                                  endpoint:(NSString *)endpoint
+                                parameters:(NSDictionary *)parameters
+                                 entityTag:(NSString *)entityTag
+                                    hedged:(BOOL)hedged
+                                serializer:(id<STPAPIResponseDecodable>)serializer
+                                completion:(STPAPIResponseBlock)completion {
+
+    NSMutableURLRequest *request = [apiClient configuredRequestForEndpoint:endpoint];
+    [request stp_addParametersToURL:parameters];
+    request.HTTPMethod = @"GET";
+    request.timeoutInterval = [[STPHostResponseTimes sharedResponseTimes] timeoutIntervalForHost:request.URL.host defaultTimeout:request.timeoutInterval];
+    if (entityTag) {
+        [request setValue:entityTag forHTTPHeaderField:@"If-None-Match"];
+    }
+
+    // Query strings are built from sorted keys, so identical parameters
+    // always produce the same URL. Sessions are shared between clients, so
+    // the credentials are part of the key too, and a conditional GET can
+    // only share a task with one that has the same tag. The response is
+    // decoded and delivered on the queues of the client that started the
+    // request, so only clients with the same queues share it.
+    NSString *key = [NSString stringWithFormat:@"%p %p %p %@ %@ %@ %@", apiClient.urlSession, apiClient.decodeQueue, apiClient.completionQueue, [request valueForHTTPHeaderField:@"Authorization"], NSStringFromClass([serializer class]), request.URL.absoluteString, entityTag ?: @""];
 
-    NSURL *url = [apiClient.apiURL URLByAppendingPathComponent:endpoint];
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:url];
+    __block NSURLSessionDataTask *task;
+    __block STPAPIRequestTask *waiter;
+    __block STPAPIInFlightRequest *newRequest;
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        NSMutableDictionary<NSString *, STPAPIInFlightRequest *> *inFlightRequests = [self inFlightRequests];
+        STPAPIInFlightRequest *inFlightRequest = inFlightRequests[key];
+        if (inFlightRequest) {
+            waiter = [self addWaiterWithCompletion:completion toInFlightRequest:inFlightRequest key:key apiClient:apiClient];
+            return;
+        }
+
+        inFlightRequest = [STPAPIInFlightRequest new];
+        inFlightRequest.endpoint = endpoint;
+        // Requests that join this one are reported once, to the client that
+        // started it.
+        inFlightRequest.metrics = [self metricsForRequest:request endpoint:endpoint apiClient:apiClient];
+        [[STPAnalyticsClient sharedClient] apiRequestDidStart];
+        task = [self dataTaskForInFlightRequest:inFlightRequest
+                                            key:key
+                                        request:request
+                                      apiClient:apiClient
+                                     serializer:serializer];
+        inFlightRequest.task = task;
+        inFlightRequests[key] = inFlightRequest;
+        waiter = [self addWaiterWithCompletion:completion toInFlightRequest:inFlightRequest key:key apiClient:apiClient];
+        newRequest = inFlightRequest;
+    });
+    if (newRequest) {
+        STPSignpostIntervalBegin("Network", request);
+        [task resume];
+        NSTimeInterval hedgeDelay = hedged ? [[STPHostResponseTimes sharedResponseTimes] hedgeDelayForHost:request.URL.host] : 0;
+        if (hedgeDelay > 0) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(hedgeDelay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self sendHedgeForInFlightRequest:newRequest
+                                              key:key
+                                          request:request
+                                        apiClient:apiClient
+                                       serializer:serializer];
+            });
+        }
+    }
+    return waiter;
+}
+
+/**
+ Only called on the in-flight requests queue.
+ */
++ (STPAPIRequestTask *)addWaiterWithCompletion:(STPAPIResponseBlock)completion
+                             toInFlightRequest:(STPAPIInFlightRequest *)inFlightRequest
+                                           key:(NSString *)key
+                                     apiClient:(STPAPIClient *)apiClient {
+    STPAPIRequestTask *waiter = [[STPAPIRequestTask alloc] initWithTask:inFlightRequest.task];
+    waiter.completion = completion;
+    __weak STPAPIRequestTask *weakWaiter = waiter;
+    // Cleared when the request finishes, which breaks the cycle through the
+    // in-flight request's waiters
+    waiter.cancellationHandler = ^{
+        [self cancelWaiter:weakWaiter ofInFlightRequest:inFlightRequest key:key apiClient:apiClient];
+    };
+    [inFlightRequest.waiters addObject:waiter];
+    return waiter;
+}
+
+/**
+ Answers `waiter` with a cancellation error straight away, leaving the request
+ running for everyone else. The last caller to cancel cancels the request.
+ */
++ (void)cancelWaiter:(STPAPIRequestTask *)waiter
+   ofInFlightRequest:(STPAPIInFlightRequest *)inFlightRequest
+                 key:(NSString *)key
+           apiClient:(STPAPIClient *)apiClient {
+    if (!waiter) {
+        return;
+    }
+    __block BOOL removed = NO;
+    __block NSURLSessionDataTask *task;
+    __block NSURLSessionDataTask *hedgeTask;
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        if ([self inFlightRequests][key] != inFlightRequest || ![inFlightRequest.waiters containsObject:waiter]) {
+            // Already answered
+            return;
+        }
+        if (inFlightRequest.waiters.count > 1) {
+            [inFlightRequest.waiters removeObject:waiter];
+            removed = YES;
+        } else {
+            // The session task answers this last caller with the error
+            task = inFlightRequest.task;
+            hedgeTask = inFlightRequest.hedgeTask;
+        }
+    });
+    [task cancel];
+    [hedgeTask cancel];
+    if (!removed) {
+        return;
+    }
+    waiter.finished = YES;
+    STPAPIResponseBlock completion = waiter.completion;
+    waiter.completion = nil;
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    dispatch_block_t block = ^{
+        completion(nil, nil, error);
+    };
+    dispatch_queue_t completionQueue = apiClient.completionQueue ?: dispatch_get_main_queue();
+    if (completionQueue == dispatch_get_main_queue()) {
+        stpDispatchToMainThreadIfNecessary(block);
+    } else {
+        dispatch_async(completionQueue, block);
+    }
+}
+
+/**
+ Only called on the in-flight requests queue. The first attempt to answer is
+ delivered to every completion, unless it failed while another attempt is
+ still running; the attempts left over are cancelled.
+ */
++ (NSURLSessionDataTask *)dataTaskForInFlightRequest:(STPAPIInFlightRequest *)inFlightRequest
+                                                 key:(NSString *)key
+                                             request:(NSURLRequest *)request
+                                           apiClient:(STPAPIClient *)apiClient
+                                          serializer:(id<STPAPIResponseDecodable>)serializer {
+    STPAPIRequestMetrics *metrics = inFlightRequest.metrics;
+    __block __weak NSURLSessionDataTask *weakTask;
+    NSURLSessionDataTask *task = [apiClient.urlSession dataTaskWithRequest:request completionHandler:^(NSData * _Nullable body, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        NSURLSessionDataTask *finishedTask = weakTask;
+        STPPerformanceCounterAdd(STPPerformanceCounterBytesReceived, body.length);
+        __block NSMutableArray<STPAPIResponseBlock> *completions;
+        __block NSURLSessionDataTask *otherTask;
+        dispatch_sync([self inFlightRequestsQueue], ^{
+            inFlightRequest.runningAttempts--;
+            if ([self inFlightRequests][key] != inFlightRequest) {
+                // Another attempt already answered
+                return;
+            }
+            BOOL cancelled = [error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled;
+            if (error && !cancelled && inFlightRequest.runningAttempts > 0) {
+                return;
+            }
+            // Callers keep their tasks, so the tasks let go of the blocks
+            completions = [NSMutableArray array];
+            for (STPAPIRequestTask *waiter in inFlightRequest.waiters) {
+                [completions addObject:waiter.completion];
+                waiter.completion = nil;
+                waiter.cancellationHandler = nil;
+                waiter.finished = YES;
+            }
+            otherTask = finishedTask == inFlightRequest.task ? inFlightRequest.hedgeTask : inFlightRequest.task;
+            [[self inFlightRequests] removeObjectForKey:key];
+        });
+        // A losing attempt's metrics are claimed too, so the pool lets go of
+        // them, and its response time still counts.
+        [self collectMetrics:completions ? metrics : nil forTask:finishedTask recordingResponseTime:YES];
+        if (!completions) {
+            return;
+        }
+        [otherTask cancel];
+        STPSignpostIntervalEnd("Network", request);
+        [[STPAnalyticsClient sharedClient] apiRequestDidFinish];
+        [[self class] parseResponse:response
+                               body:body
+                              error:error
+                          apiClient:apiClient
+                         serializer:serializer
+                    completionQueue:nil
+                            metrics:metrics
+                         completion:^(id object, NSHTTPURLResponse *httpResponse, NSError *responseError) {
+                             for (STPAPIResponseBlock waitingCompletion in completions) {
+                                 waitingCompletion(object, httpResponse, responseError);
+                             }
+                         }];
+    }];
+    weakTask = task;
+    inFlightRequest.runningAttempts++;
+    // Always resumed straight after
+    [self countRequest:request endpoint:inFlightRequest.endpoint];
+    return task;
+}
+
++ (void)sendHedgeForInFlightRequest:(STPAPIInFlightRequest *)inFlightRequest
+                                key:(NSString *)key
+                            request:(NSURLRequest *)request
+                          apiClient:(STPAPIClient *)apiClient
+                         serializer:(id<STPAPIResponseDecodable>)serializer {
+    __block NSURLSessionDataTask *hedgeTask;
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        // Already answered, or cancelled by the caller
+        if ([self inFlightRequests][key] != inFlightRequest || inFlightRequest.task.state != NSURLSessionTaskStateRunning) {
+            return;
+        }
+        hedgeTask = [self dataTaskForInFlightRequest:inFlightRequest
+                                                 key:key
+                                             request:request
+                                           apiClient:apiClient
+                                          serializer:serializer];
+        inFlightRequest.hedgeTask = hedgeTask;
+    });
+    if (hedgeTask) {
+        STPSignpostEvent("GET hedge", "%lu", (unsigned long)inFlightRequest.waiters.count);
+        [hedgeTask resume];
+    }
+}
+
++ (NSURLSessionDataTask *)longPollWithAPIClient:(STPAPIClient *)apiClient
+                                       endpoint:(NSString *)endpoint
+                                     parameters:(NSDictionary *)parameters
+                                   waitInterval:(NSTimeInterval)waitInterval
+                                     serializer:(id<STPAPIResponseDecodable>)serializer
+                                     completion:(STPAPIResponseBlock)completion {
+    return [self longPollWithAPIClient:apiClient
+                              endpoint:endpoint
+                            parameters:parameters
+                             entityTag:nil
+                          waitInterval:waitInterval
+                            serializer:serializer
+                            completion:completion];
+}
+
++ (NSURLSessionDataTask *)longPollWithAPIClient:(STPAPIClient *)apiClient
+                                       endpoint:(NSString *)endpoint
+                                     parameters:(NSDictionary *)parameters
+                                      entityTag:(NSString *)entityTag
+                                   waitInterval:(NSTimeInterval)waitInterval
+                                     serializer:(id<STPAPIResponseDecodable>)serializer
+                                     completion:(STPAPIResponseBlock)completion {
+
+    NSMutableURLRequest *request = [apiClient configuredRequestForEndpoint:endpoint];
     [request stp_addParametersToURL:parameters];
     request.HTTPMethod = @"GET";
+    if (entityTag) {
+        [request setValue:entityTag forHTTPHeaderField:@"If-None-Match"];
+    }
+    NSString *prefer = [NSString stringWithFormat:@"wait=%ld", (long)ceil(waitInterval)];
+    [request setValue:prefer forHTTPHeaderField:@"Prefer"];
+    // Leave the server time to answer once the wait is over.
+    request.timeoutInterval = MAX(request.timeoutInterval, waitInterval + LongPollTimeoutGracePeriod);
 
+    STPAPIRequestMetrics *metrics = [self metricsForRequest:request endpoint:endpoint apiClient:apiClient];
+    __block __weak NSURLSessionDataTask *weakTask;
     NSURLSessionDataTask *task = [apiClient.urlSession dataTaskWithRequest:request completionHandler:^(NSData * _Nullable body, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        STPSignpostIntervalEnd("Network", request);
+        STPPerformanceCounterAdd(STPPerformanceCounterBytesReceived, body.length);
+        // Time spent waiting on the server says nothing about the network
+        [self collectMetrics:metrics forTask:weakTask recordingResponseTime:NO];
         [[self class] parseResponse:response
                                body:body
                               error:error
+                          apiClient:apiClient
                          serializer:serializer
+                    completionQueue:nil
+                            metrics:metrics
                          completion:completion];
     }];
+    weakTask = task;
+    // Long polls are background work that spends most of its time waiting.
+    task.priority = NSURLSessionTaskPriorityLow;
+    [self countRequest:request endpoint:endpoint];
+    STPSignpostIntervalBegin("Network", request);
     [task resume];
     return task;
 }
 
+#pragma mark - Retries
+
++ (BOOL)shouldRetryResponse:(NSURLResponse *)response error:(NSError *)error {
+    if (error) {
+        // A cancelled request is never retried, and neither is anything the
+        // server might have rejected on its merits.
+        return [error.domain isEqualToString:NSURLErrorDomain]
+            && (error.code == NSURLErrorNetworkConnectionLost || error.code == NSURLErrorTimedOut);
+    }
+    if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
+        return ((NSHTTPURLResponse *)response).statusCode >= 500;
+    }
+    return NO;
+}
+
++ (NSTimeInterval)retryDelayAfterAttempt:(NSUInteger)attempt {
+    // "Full jitter": a random delay up to the exponential backoff, so clients
+    // that lost the same connection don't all come back at once.
+    NSTimeInterval backoff = MIN(PostRetryMaxDelay, PostRetryBaseDelay * pow(2, attempt - 1));
+    return backoff * arc4random_uniform(1001) / 1000.0;
+}
+
+#pragma mark - In-flight GET requests
+
++ (NSMutableDictionary<NSString *, STPAPIInFlightRequest *> *)inFlightRequests {
+    static NSMutableDictionary *inFlightRequests;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        inFlightRequests = [NSMutableDictionary dictionary];
+    });
+    return inFlightRequests;
+}
+
++ (dispatch_queue_t)inFlightRequestsQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.apirequest.inflight", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+#if DEBUG
+
+// Only touched on the in-flight requests queue. Keyed by idempotency key.
++ (NSMutableDictionary<NSString *, STPAPIInFlightRequest *> *)inFlightPosts {
+    static NSMutableDictionary *inFlightPosts;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        inFlightPosts = [NSMutableDictionary dictionary];
+    });
+    return inFlightPosts;
+}
+
++ (void)postDidStartWithEndpoint:(NSString *)endpoint idempotencyKey:(NSString *)idempotencyKey {
+    STPAPIInFlightRequest *post = [STPAPIInFlightRequest new];
+    post.endpoint = endpoint;
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        [self inFlightPosts][idempotencyKey] = post;
+    });
+}
+
++ (void)postDidFinishWithIdempotencyKey:(NSString *)idempotencyKey {
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        [[self inFlightPosts] removeObjectForKey:idempotencyKey];
+    });
+}
+
++ (NSArray<NSString *> *)inFlightRequestDescriptions {
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    NSMutableArray<NSString *> *descriptions = [NSMutableArray array];
+    dispatch_sync([self inFlightRequestsQueue], ^{
+        for (STPAPIInFlightRequest *post in [self inFlightPosts].allValues) {
+            [descriptions addObject:[NSString stringWithFormat:@"POST %@ %.1fs", post.endpoint, now - post.startTime]];
+        }
+        for (STPAPIInFlightRequest *get in [self inFlightRequests].allValues) {
+            [descriptions addObject:[NSString stringWithFormat:@"GET %@ %.1fs%@", get.endpoint, now - get.startTime, get.hedgeTask ? @" (hedged)" : @""]];
+        }
+    });
+    return descriptions;
+}
+
+#endif
+
+#pragma mark - Metrics
+
++ (void)countRequest:(NSURLRequest *)request endpoint:(NSString *)endpoint {
+    STPPerformanceCounterIncrement(STPPerformanceCounterForEndpoint(endpoint));
+    STPPerformanceCounterAdd(STPPerformanceCounterBytesSent, request.HTTPBody.length);
+}
+
++ (STPAPIRequestMetrics *)metricsForRequest:(NSURLRequest *)request endpoint:(NSString *)endpoint apiClient:(STPAPIClient *)apiClient {
+    // Nothing is timed unless someone is listening.
+    if (!apiClient.metricsDelegate) {
+        return nil;
+    }
+    return [[STPAPIRequestMetrics alloc] initWithRequest:request endpoint:endpoint];
+}
+
++ (void)collectMetrics:(STPAPIRequestMetrics *)metrics forTask:(NSURLSessionTask *)task recordingResponseTime:(BOOL)recordingResponseTime {
+    if (!task) {
+        return;
+    }
+    // Claim the session's metrics even when not reporting, so the pool doesn't
+    // hold on to them for the task's lifetime.
+    if ([NSURLSessionTaskMetrics class]) {
+        NSString *host = task.originalRequest.URL.host;
+        __block BOOL collecting = YES;
+        [[STPURLSessionPool sharedPool] takeMetricsForTask:task handler:^(NSURLSessionTaskMetrics *taskMetrics) {
+            // Metrics that arrive after the response has been handed off are
+            // too late for the caller's report, but still count as timings.
+            if (collecting) {
+                metrics.taskMetrics = taskMetrics;
+            }
+            if (recordingResponseTime) {
+                [[STPHostResponseTimes sharedResponseTimes] recordTaskMetrics:taskMetrics forHost:host];
+                [[STPRUMCollector sharedCollector] recordTaskMetrics:taskMetrics];
+            }
+        }];
+        collecting = NO;
+    }
+}
+
++ (void)reportMetrics:(STPAPIRequestMetrics *)metrics
+             response:(NSHTTPURLResponse *)response
+                error:(NSError *)error
+            apiClient:(STPAPIClient *)apiClient
+      completionQueue:(dispatch_queue_t)completionQueue {
+    metrics.statusCode = response.statusCode;
+    metrics.error = error;
+    id<STPAPIClientMetricsDelegate> delegate = apiClient.metricsDelegate;
+    if (!delegate) {
+        return;
+    }
+    dispatch_queue_t clientQueue = apiClient.completionQueue ?: dispatch_get_main_queue();
+    if (clientQueue == completionQueue) {
+        [delegate apiClient:apiClient didFinishRequestWithMetrics:metrics];
+    } else {
+        dispatch_async(clientQueue, ^{
+            [delegate apiClient:apiClient didFinishRequestWithMetrics:metrics];
+        });
+    }
+}
+
+#pragma mark - Decoding
+
 + (void)parseResponse:(NSURLResponse *)response
                  body:(NSData *)body
                 error:(NSError *)error
+            apiClient:(STPAPIClient *)apiClient
            serializer:(id<STPAPIResponseDecodable>)serializer
+      completionQueue:(dispatch_queue_t)requestedCompletionQueue
+              metrics:(STPAPIRequestMetrics *)metrics
            completion:(STPAPIResponseBlock)completion {
 
-    NSDictionary *jsonDictionary = body ? [NSJSONSerialization JSONObjectWithData:body options:(NSJSONReadingOptions)kNilOptions error:NULL] : nil;
-    id<STPAPIResponseDecodable> responseObject = [[serializer class] decodedObjectFromAPIResponse:jsonDictionary];
-    NSError *returnedError = [NSError stp_errorFromStripeResponse:jsonDictionary] ?: error;
-    if ((!responseObject || ![response isKindOfClass:[NSHTTPURLResponse class]]) && !returnedError) {
-        returnedError = [NSError stp_genericFailedToParseResponseError];
+    dispatch_queue_t decodeQueue = apiClient.decodeQueue;
+    dispatch_queue_t completionQueue = requestedCompletionQueue ?: apiClient.completionQueue ?: dispatch_get_main_queue();
+    if (decodeQueue) {
+        dispatch_async(decodeQueue, ^{
+            [self decodeResponse:response body:body error:error apiClient:apiClient serializer:serializer completionQueue:completionQueue metrics:metrics completion:completion];
+        });
+    } else {
+        [self decodeResponse:response body:body error:error apiClient:apiClient serializer:serializer completionQueue:completionQueue metrics:metrics completion:completion];
     }
+}
+
++ (void)decodeResponse:(NSURLResponse *)response
+                  body:(NSData *)body
+                 error:(NSError *)error
+             apiClient:(STPAPIClient *)apiClient
+            serializer:(id<STPAPIResponseDecodable>)serializer
+       completionQueue:(dispatch_queue_t)completionQueue
+               metrics:(STPAPIRequestMetrics *)metrics
+            completion:(STPAPIResponseBlock)completion {
 
     NSHTTPURLResponse *httpResponse;
     if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
         httpResponse = (NSHTTPURLResponse *)response;
     }
-    stpDispatchToMainThreadIfNecessary(^{
+
+    STPSignpostIntervalBegin("Decode", completion);
+    CFAbsoluteTime decodeStartTime = CFAbsoluteTimeGetCurrent();
+    metrics.decodeStartTime = decodeStartTime;
+    id<STPAPIResponseDecodable> responseObject;
+    NSError *returnedError;
+    if (httpResponse.statusCode == 304 && !error) {
+        // Unchanged since the tagged response, so there's nothing to decode
+    } else {
+        NSDictionary *jsonDictionary = body ? [NSJSONSerialization JSONObjectWithData:body options:(NSJSONReadingOptions)kNilOptions error:NULL] : nil;
+        if ([serializer respondsToSelector:@selector(updatedObjectFromAPIResponse:)]) {
+            responseObject = [(id<STPAPIResponseUpdatable>)serializer updatedObjectFromAPIResponse:jsonDictionary];
+        } else {
+            responseObject = [[serializer class] decodedObjectFromAPIResponse:jsonDictionary];
+        }
+        returnedError = [NSError stp_errorFromStripeResponse:jsonDictionary] ?: error;
+        if ((!responseObject || !httpResponse) && !returnedError) {
+            returnedError = [NSError stp_genericFailedToParseResponseError];
+        }
+    }
+    CFAbsoluteTime decodeEndTime = CFAbsoluteTimeGetCurrent();
+    metrics.decodeEndTime = decodeEndTime;
+    STPPerformanceCounterAdd(STPPerformanceCounterDecodeMicroseconds, (uint64_t)(MAX(decodeEndTime - decodeStartTime, 0) * 1e6));
+    STPSignpostIntervalEnd("Decode", completion);
+    dispatch_block_t block = ^{
+        metrics.completionTime = CFAbsoluteTimeGetCurrent();
         if (returnedError) {
             completion(nil, httpResponse, returnedError);
         } else {
             completion(responseObject, httpResponse, nil);
         }
-    });
-
+        if (metrics) {
+            [self reportMetrics:metrics response:httpResponse error:returnedError apiClient:apiClient completionQueue:completionQueue];
+        }
+    };
+    if (completionQueue == dispatch_get_main_queue()) {
+        stpDispatchToMainThreadIfNecessary(block);
+    } else {
+        dispatch_async(completionQueue, block);
+    }
 }
 
 @end
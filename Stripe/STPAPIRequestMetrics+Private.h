@@ -0,0 +1,32 @@
+//
+//  STPAPIRequestMetrics+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPAPIRequestMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Filled in by STPAPIRequest as a request moves through each stage. Timestamps
+ are CFAbsoluteTime values; the public durations are derived from them.
+ */
+@interface STPAPIRequestMetrics ()
+
+- (instancetype)initWithRequest:(NSURLRequest *)request endpoint:(NSString *)endpoint;
+
+@property (nonatomic, readwrite) NSInteger statusCode;
+@property (nonatomic, readwrite, nullable) NSError *error;
+@property (nonatomic, readwrite, nullable) NSURLSessionTaskMetrics *taskMetrics NS_AVAILABLE_IOS(10_0);
+
+@property (nonatomic) CFAbsoluteTime startTime;
+@property (nonatomic) CFAbsoluteTime decodeStartTime;
+@property (nonatomic) CFAbsoluteTime decodeEndTime;
+@property (nonatomic) CFAbsoluteTime completionTime;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,85 @@
+//
+//  STPAPIRequestMetrics.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPAPIRequestMetrics+Private.h"
+
+#import "STPURLSessionPool.h"
+
+static NSTimeInterval STPIntervalBetweenDates(NSDate *start, NSDate *end) {
+    if (!start || !end) {
+        return 0;
+    }
+    return MAX(0, [end timeIntervalSinceDate:start]);
+}
+
+@implementation STPAPIRequestMetrics
+
+- (instancetype)initWithRequest:(NSURLRequest *)request endpoint:(NSString *)endpoint {
+    self = [super init];
+    if (self) {
+        _HTTPMethod = [request.HTTPMethod copy] ?: @"GET";
+        _endpoint = [endpoint copy];
+        _startTime = CFAbsoluteTimeGetCurrent();
+    }
+    return self;
+}
+
+/**
+ The transaction that produced the response. Redirects, cache lookups and
+ retries add other transactions that don't reflect what the caller waited on.
+ */
+- (NSURLSessionTaskTransactionMetrics *)transactionMetrics NS_AVAILABLE_IOS(10_0) {
+    return STPResponseTransactionMetrics(self.taskMetrics);
+}
+
+- (BOOL)reusedConnection {
+    return self.transactionMetrics.reusedConnection;
+}
+
+- (NSTimeInterval)domainLookupDuration {
+    NSURLSessionTaskTransactionMetrics *transaction = self.transactionMetrics;
+    return STPIntervalBetweenDates(transaction.domainLookupStartDate, transaction.domainLookupEndDate);
+}
+
+- (NSTimeInterval)connectDuration {
+    NSURLSessionTaskTransactionMetrics *transaction = self.transactionMetrics;
+    return STPIntervalBetweenDates(transaction.connectStartDate, transaction.connectEndDate);
+}
+
+- (NSTimeInterval)secureConnectionDuration {
+    NSURLSessionTaskTransactionMetrics *transaction = self.transactionMetrics;
+    return STPIntervalBetweenDates(transaction.secureConnectionStartDate, transaction.secureConnectionEndDate);
+}
+
+- (NSTimeInterval)timeToFirstByte {
+    NSURLSessionTaskTransactionMetrics *transaction = self.transactionMetrics;
+    return STPIntervalBetweenDates(transaction.requestStartDate, transaction.responseStartDate);
+}
+
+- (NSTimeInterval)transferDuration {
+    NSURLSessionTaskTransactionMetrics *transaction = self.transactionMetrics;
+    return STPIntervalBetweenDates(transaction.responseStartDate, transaction.responseEndDate);
+}
+
+- (NSTimeInterval)decodeDuration {
+    return MAX(0, self.decodeEndTime - self.decodeStartTime);
+}
+
+- (NSTimeInterval)completionDispatchDelay {
+    return MAX(0, self.completionTime - self.decodeEndTime);
+}
+
+- (NSTimeInterval)totalDuration {
+    return MAX(0, self.completionTime - self.startTime);
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; %@ %@ %ld; total %.3fs, ttfb %.3fs, decode %.3fs>", NSStringFromClass([self class]), (void *)self, self.HTTPMethod, self.endpoint, (long)self.statusCode, self.totalDuration, self.timeToFirstByte, self.decodeDuration];
+}
+
+@end
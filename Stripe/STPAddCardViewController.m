@@ -12,11 +12,13 @@
 #import "STPAddressFieldTableViewCell.h"
 #import "STPAddressViewModel.h"
 #import "STPAnalyticsClient.h"
+#import "STPCardParams+Private.h"
 #import "STPCheckoutAPIClient.h"
 #import "STPColorUtils.h"
 #import "STPCoreTableViewController+Private.h"
 #import "STPDispatchFunctions.h"
 #import "STPEmailAddressValidator.h"
+#import "STPFormValidity.h"
 #import "STPImageLibrary+Private.h"
 #import "STPImageLibrary.h"
 #import "STPLocalizationUtils.h"
@@ -25,10 +27,12 @@
 #import "STPPaymentCardTextField.h"
 #import "STPPaymentConfiguration+Private.h"
 #import "STPPhoneNumberValidator.h"
+#import "STPRUMCollector.h"
 #import "STPRememberMeEmailCell.h"
 #import "STPRememberMePaymentCell.h"
 #import "STPRememberMeTermsView.h"
 #import "STPSectionHeaderView.h"
+#import "STPSignpost.h"
 #import "STPSMSCodeViewController.h"
 #import "STPSwitchTableViewCell.h"
 #import "STPToken.h"
@@ -61,20 +65,51 @@
 @property(nonatomic)STPPaymentActivityIndicatorView *activityIndicator;
 @property(nonatomic, weak)STPPaymentActivityIndicatorView *lookupActivityIndicator;
 @property(nonatomic)STPAddressViewModel *addressViewModel;
+// Which parts of the form are valid. Done is enabled once they all are.
+@property(nonatomic)STPFormValidity *formValidity;
 @property(nonatomic)UIToolbar *inputAccessoryToolbar;
 @property(nonatomic)STPCheckoutAPIClient *checkoutAPIClient;
 @property(nonatomic)STPCheckoutAccount *checkoutAccount;
 @property(nonatomic)STPCheckoutAccountLookup *checkoutLookup;
 @property(nonatomic)STPCard *checkoutAccountCard;
 @property(nonatomic)BOOL lookupSucceeded;
+// Bumped whenever the email changes, so that lookups for older input can
+// tell they've been superseded. Only bumped on the main thread, but read by
+// the SMS send on whichever thread the lookup finishes.
+@property(atomic)NSUInteger emailLookupGeneration;
 @property(nonatomic)STPRememberMeTermsView *rememberMeTermsView;
 @property(nonatomic)BOOL showingRememberMePhoneAndTerms;
+// The in-flight token request, cancelled if the user backs out before it
+// finishes.
+@property(nonatomic)NSURLSessionDataTask *tokenTask;
+// Bumped whenever token creation is abandoned, so a retried request that
+// outlives its task can tell its result is no longer wanted.
+@property(nonatomic)NSUInteger tokenGeneration;
+// With speculative tokenization, a hash of the card params the speculative
+// token is for, its request while in flight, and the token once it's
+// created.
+// A new fingerprint object is made for every request, so a response can tell
+// by identity whether it's still wanted.
+@property(nonatomic)NSData *speculativeFingerprint;
+@property(nonatomic)NSURLSessionDataTask *speculativeTokenTask;
+@property(nonatomic)BOOL speculativeTokenFinished;
+@property(nonatomic)STPToken *speculativeToken;
+// Set when Done is tapped while the speculative request is in flight
+@property(nonatomic, copy)STPTokenCompletionBlock speculativeTokenCompletion;
+// For timing how long the view takes to first appear, and a card takes to
+// be added once Done is tapped.
+@property(nonatomic)CFAbsoluteTime initTime;
+@property(nonatomic)BOOL hasAppeared;
+@property(nonatomic)CFAbsoluteTime submitTime;
 #ifdef STRIPE_UNIT_TESTS_ENABLED
 @property(nonatomic)BOOL forceEnableRememberMeForTesting;
 #endif
 @end
 
 static NSString *const STPPaymentCardCellReuseIdentifier = @"STPPaymentCardCellReuseIdentifier";
+static NSTimeInterval const EmailLookupTimeout = 15;
+// Wait for a pause in typing before looking an email up
+static NSTimeInterval const EmailLookupDebounceInterval = 0.3;
 
 typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     STPPaymentCardEmailSection = 0,
@@ -83,6 +118,14 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     STPPaymentCardRememberMeSection = 3
 };
 
+// The sections tracked by formValidity
+typedef NS_ENUM(NSUInteger, STPAddCardValiditySection) {
+    STPAddCardValiditySectionCard,
+    STPAddCardValiditySectionAddress,
+    STPAddCardValiditySectionEmail,
+    STPAddCardValiditySectionCount,
+};
+
 @implementation STPAddCardViewController
 
 - (instancetype)init {
@@ -98,15 +141,26 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 }
 
 - (void)commonInitWithConfiguration:(STPPaymentConfiguration *)configuration {
+    _initTime = CFAbsoluteTimeGetCurrent();
     _configuration = configuration;
     _shippingAddress = nil;
     _hasUsedShippingAddress = NO;
     _apiClient = [[STPAPIClient alloc] initWithConfiguration:configuration];
     _addressViewModel = [[STPAddressViewModel alloc] initWithRequiredBillingFields:configuration.requiredBillingAddressFields];
     _addressViewModel.delegate = self;
-    _checkoutAPIClient = [[STPCheckoutAPIClient alloc] initWithPublishableKey:configuration.publishableKey];
+    _formValidity = [[STPFormValidity alloc] initWithSectionCount:STPAddCardValiditySectionCount];
+    WEAK(self);
+    _formValidity.changeHandler = ^(STPFormValidity *validity, NSUInteger section) {
+        STRONG(self);
+        if (section == STPAddCardValiditySectionCard) {
+            [self.inputAccessoryToolbar stp_setEnabled:[validity isSectionValid:section]];
+        }
+        self.doneItem.enabled = validity.isValid;
+    };
+    _checkoutAPIClient = [STPCheckoutAPIClient sharedClientWithPublishableKey:configuration.publishableKey];
 
     self.title = STPLocalizedString(@"Add a Card", @"Title for Add a Card view");
+    [STPAnalyticsClient trackProductUsage:STPAnalyticsProductUsageAddCardViewController];
 }
 
 - (void)createAndSetupViews {
@@ -115,7 +169,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     UIBarButtonItem *doneItem = [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemDone target:self action:@selector(nextPressed:)];
     self.doneItem = doneItem;
     self.stp_navigationItemProxy.rightBarButtonItem = doneItem;
-    self.stp_navigationItemProxy.rightBarButtonItem.enabled = NO;
+    doneItem.enabled = self.formValidity.isValid;
     
     UIImageView *cardImageView = [[UIImageView alloc] initWithImage:[STPImageLibrary largeCardFrontImage]];
     cardImageView.contentMode = UIViewContentModeCenter;
@@ -155,7 +209,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     self.activityIndicator = [[STPPaymentActivityIndicatorView alloc] initWithFrame:CGRectMake(0, 0, 20.0f, 20.0f)];
     
     self.inputAccessoryToolbar = [UIToolbar stp_inputAccessoryToolbarWithTarget:self action:@selector(paymentFieldNextTapped)];
-    [self.inputAccessoryToolbar stp_setEnabled:NO];
+    [self.inputAccessoryToolbar stp_setEnabled:[self.formValidity isSectionValid:STPAddCardValiditySectionCard]];
     if (self.configuration.requiredBillingAddressFields != STPBillingAddressFieldsNone) {
         paymentCell.inputAccessoryView = self.inputAccessoryToolbar;
     }
@@ -190,16 +244,63 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 
     [self.view addGestureRecognizer:[[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(endEditing)]];
 
+    // Remember Me can only come up when SMS autofill is allowed, so there's
+    // no need to contact checkout otherwise.
+    if (!self.configuration.smsAutofillDisabled) {
+        [self.checkoutAPIClient bootstrapIfNeeded];
+    }
     [self.checkoutAPIClient.bootstrapPromise onCompletion:^(__unused id value, __unused NSError *error) {
         STRONG(self);
         [self reloadRememberMeCellAnimated:YES];
     }];
+    [self updateFormValidity];
 }
 
 - (void)endEditing {
     [self.view endEditing:NO];
 }
 
+- (void)prepareForReuse {
+    [self cancelTokenCreation];
+    self.loading = NO;
+    self.emailLookupGeneration++;
+    [self.checkoutAPIClient cancelEmailLookupForOwner:self];
+    self.checkoutAccount = nil;
+    self.checkoutLookup = nil;
+    self.checkoutAccountCard = nil;
+    self.lookupSucceeded = NO;
+    self.hasUsedShippingAddress = NO;
+
+    if (self.configuration.requiredBillingAddressFields != STPBillingAddressFieldsNone) {
+        STPAddress *address = self.prefilledInformation.billingAddress;
+        if (!address) {
+            address = [STPAddress new];
+            address.country = [[NSLocale autoupdatingCurrentLocale] objectForKey:NSLocaleCountryCode];
+        }
+        self.addressViewModel.address = address;
+    }
+
+    if (!self.isViewLoaded) {
+        return;
+    }
+    [self.view endEditing:YES];
+    self.cardImageView.image = [STPImageLibrary largeCardFrontImage];
+    [self.paymentCell clear];
+    [self.paymentCell.paymentField clear];
+    self.emailCell.contents = [STPEmailAddressValidator stringIsValidEmailAddress:self.prefilledInformation.email] ? self.prefilledInformation.email : nil;
+    self.rememberMePhoneCell.contents = self.prefilledInformation.phone;
+    if (self.showingRememberMePhoneAndTerms) {
+        self.rememberMeCell.on = NO;
+        [self switchTableViewCell:self.rememberMeCell didToggleSwitch:NO];
+    }
+    [self reloadRememberMeCellAnimated:NO];
+
+    BOOL needsAddress = self.configuration.requiredBillingAddressFields != STPBillingAddressFieldsNone && !self.addressViewModel.isValid;
+    self.addressHeaderView.buttonHidden = !(needsAddress && self.shippingAddress != nil);
+    [self.tableView reloadData];
+    [self updateFormValidity];
+}
+
 - (void)updateAppearance {
     [super updateAppearance];
 
@@ -270,11 +371,25 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 
 - (void)viewWillAppear:(BOOL)animated {
     [super viewWillAppear:animated];
+    [self.apiClient prewarmConnection];
     [self reloadRememberMeCellAnimated:NO];
 }
 
+- (void)viewWillDisappear:(BOOL)animated {
+    [super viewWillDisappear:animated];
+    if (self.isMovingFromParentViewController || self.isBeingDismissed || self.navigationController.isBeingDismissed) {
+        [self cancelTokenCreation];
+    }
+}
+
 - (void)viewDidAppear:(BOOL)animated {
     [super viewDidAppear:animated];
+    if (!self.hasAppeared) {
+        self.hasAppeared = YES;
+        [[STPRUMCollector sharedCollector] recordDuration:CFAbsoluteTimeGetCurrent() - self.initTime
+                                                forMetric:@"add_card.appear"
+                                                 category:STPRUMCategoryInterface];
+    }
     [self stp_beginObservingKeyboardAndInsettingScrollView:self.tableView
                                              onChangeBlock:nil];
     [[self firstEmptyField] becomeFirstResponder];
@@ -296,19 +411,113 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 }
 
 - (void)handleBackOrCancelTapped:(__unused id)sender {
+    [self cancelTokenCreation];
     [self.delegate addCardViewControllerDidCancel:self];
 }
 
-- (void)nextPressed:(__unused id)sender {
-    self.loading = YES;
+- (void)cancelTokenCreation {
+    self.tokenGeneration++;
+    [self.tokenTask cancel];
+    self.tokenTask = nil;
+    [self discardSpeculativeToken];
+}
+
+- (STPCardParams *)enteredCardParams {
     STPCardParams *cardParams = self.paymentCell.paymentField.cardParams;
     cardParams.address = self.addressViewModel.address;
     cardParams.currency = self.managedAccountCurrency;
+    return cardParams;
+}
+
+#pragma mark - Speculative tokenization
+
+/**
+ Called after every edit. Starts creating a token once the card and address
+ are valid, and drops a token for anything other than what's now entered.
+ */
+- (void)updateSpeculativeToken {
+    if (!self.configuration.speculativeTokenizationEnabled || self.loading) {
+        return;
+    }
+    STPCardParams *cardParams = nil;
+    NSData *fingerprint = nil;
+    if (!self.checkoutAccountCard && self.paymentCell.paymentField.isValid && self.addressViewModel.isValid) {
+        cardParams = [self enteredCardParams];
+        fingerprint = [cardParams formEncodedFingerprint];
+    }
+    if (fingerprint && [fingerprint isEqualToData:self.speculativeFingerprint]) {
+        return;
+    }
+    [self discardSpeculativeToken];
+    if (!cardParams) {
+        return;
+    }
+    self.speculativeFingerprint = fingerprint;
+    WEAK(self);
+    self.speculativeTokenTask = [self.apiClient createTokenWithCard:cardParams completion:^(STPToken *token, NSError *error) {
+        STRONG(self);
+        if (self.speculativeFingerprint != fingerprint) {
+            return;
+        }
+        self.speculativeTokenTask = nil;
+        STPTokenCompletionBlock completion = self.speculativeTokenCompletion;
+        if (completion) {
+            [self discardSpeculativeToken];
+            completion(token, error);
+        } else if (error) {
+            // Done makes a fresh request rather than repeating the error
+            self.speculativeFingerprint = nil;
+        } else {
+            self.speculativeTokenFinished = YES;
+            self.speculativeToken = token;
+        }
+    }];
+}
+
+/**
+ Hands the speculative token for `cardParams` to `completion`, now if it's
+ ready or when it arrives if not. Each token is only handed out once.
+
+ @return NO if there's no speculative token for `cardParams`.
+ */
+- (BOOL)useSpeculativeTokenForCardParams:(STPCardParams *)cardParams
+                              completion:(STPTokenCompletionBlock)completion {
+    if (!self.speculativeFingerprint ||
+        ![[cardParams formEncodedFingerprint] isEqualToData:self.speculativeFingerprint]) {
+        return NO;
+    }
+    if (self.speculativeTokenFinished) {
+        STPToken *token = self.speculativeToken;
+        [self discardSpeculativeToken];
+        completion(token, nil);
+    } else {
+        self.speculativeTokenCompletion = completion;
+    }
+    return YES;
+}
+
+- (void)discardSpeculativeToken {
+    [self.speculativeTokenTask cancel];
+    self.speculativeTokenTask = nil;
+    self.speculativeFingerprint = nil;
+    self.speculativeTokenFinished = NO;
+    self.speculativeToken = nil;
+    self.speculativeTokenCompletion = nil;
+}
+
+- (void)nextPressed:(__unused id)sender {
+    // Ends when the delegate is handed a token, or the token fails.
+    STPSignpostIntervalBegin("Add card", self);
+    self.submitTime = CFAbsoluteTimeGetCurrent();
+    self.loading = YES;
+    STPCardParams *cardParams = [self enteredCardParams];
     if (self.checkoutAccountCard) {
         WEAK(self);
         [[[self.checkoutAPIClient createTokenWithAccount:self.checkoutAccount] onSuccess:^(STPToken *token) {
             STRONG(self);
             [[STPAnalyticsClient sharedClient] logRememberMeConversion:STPAddCardRememberMeUsageAddedFromSMS];
+            STPSignpostIntervalEnd("Add card", self);
+            [self recordSubmitDuration];
             [self.delegate addCardViewController:self didCreateToken:token completion:^(NSError * _Nullable error) {
                 stpDispatchToMainThreadIfNecessary(^{
                     if (error) {
@@ -321,11 +530,22 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
             }];
         }] onFailure:^(NSError *error) {
             STRONG(self);
+            STPSignpostIntervalEnd("Add card", self);
             [self handleCardTokenError:error];
         }];
     } else if (cardParams) {
-        [self.apiClient createTokenWithCard:cardParams completion:^(STPToken *token, NSError *tokenError) {
+        NSUInteger generation = self.tokenGeneration;
+        WEAK(self);
+        STPTokenCompletionBlock completion = ^(STPToken *token, NSError *tokenError) {
+            STRONG(self);
+            if (generation != self.tokenGeneration) {
+                // The user backed out, so there's nobody to tell.
+                STPSignpostIntervalEnd("Add card", self);
+                return;
+            }
+            self.tokenTask = nil;
             if (tokenError) {
+                STPSignpostIntervalEnd("Add card", self);
                 [self handleCardTokenError:tokenError];
             } else {
                 NSString *phone = self.rememberMePhoneCell.contents;
@@ -366,6 +586,8 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
                 if (rememberMeUsage == STPAddCardRememberMeUsageSelected) {
                     [self.checkoutAPIClient createAccountWithCardParams:cardParams email:email phone:phone];
                 }
+                STPSignpostIntervalEnd("Add card", self);
+                [self recordSubmitDuration];
                 [self.delegate addCardViewController:self didCreateToken:token completion:^(NSError * _Nullable error) {
                     stpDispatchToMainThreadIfNecessary(^{
                         if (error) {
@@ -377,10 +599,23 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
                     });
                 }];
             }
-        }];
+        };
+        if (![self useSpeculativeTokenForCardParams:cardParams completion:completion]) {
+            self.tokenTask = [self.apiClient createTokenWithCard:cardParams completion:completion];
+        }
+    } else {
+        // Nothing to tokenize, so the interval is over before it started.
+        STPSignpostIntervalEnd("Add card", self);
     }
 }
 
+// Up to the token being handed to the delegate
+- (void)recordSubmitDuration {
+    [[STPRUMCollector sharedCollector] recordDuration:CFAbsoluteTimeGetCurrent() - self.submitTime
+                                            forMetric:@"add_card.submit"
+                                             category:STPRUMCategoryInterface];
+}
+
 - (void)handleCheckoutTokenError:(__unused NSError *)error {
     self.loading = NO;
 
@@ -414,13 +649,30 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 
 - (void)setCheckoutAccountCard:(STPCard *)checkoutAccountCard {
     _checkoutAccountCard = checkoutAccountCard;
-    [self updateDoneButton];
+    [self updateCardValidity];
+    [self updateSpeculativeToken];
 }
 
-- (void)updateDoneButton {
-    self.stp_navigationItemProxy.rightBarButtonItem.enabled = (self.paymentCell.paymentField.isValid || self.checkoutAccountCard) &&
-    self.addressViewModel.isValid &&
-    (self.configuration.smsAutofillDisabled || [STPEmailAddressValidator stringIsValidEmailAddress:self.emailCell.contents]);
+#pragma mark - Form validity
+
+- (void)updateFormValidity {
+    [self updateCardValidity];
+    [self updateAddressValidity];
+    [self updateEmailValidity];
+}
+
+- (void)updateCardValidity {
+    [self.formValidity setValid:(self.paymentCell.paymentField.isValid || self.checkoutAccountCard)
+                     forSection:STPAddCardValiditySectionCard];
+}
+
+- (void)updateAddressValidity {
+    [self.formValidity setValid:self.addressViewModel.isValid forSection:STPAddCardValiditySectionAddress];
+}
+
+- (void)updateEmailValidity {
+    [self.formValidity setValid:(self.configuration.smsAutofillDisabled || [STPEmailAddressValidator stringIsValidEmailAddress:self.emailCell.contents])
+                     forSection:STPAddCardValiditySectionEmail];
 }
 
 - (void)smsCodeViewControllerDidCancel:(__unused STPSMSCodeViewController *)smsCodeViewController {
@@ -443,9 +695,9 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 
 #pragma mark - STPPaymentCardTextField
 
-- (void)paymentCardTextFieldDidChange:(STPPaymentCardTextField *)textField {
-    [self.inputAccessoryToolbar stp_setEnabled:textField.isValid];
-    [self updateDoneButton];
+- (void)paymentCardTextFieldDidChange:(__unused STPPaymentCardTextField *)textField {
+    [self updateCardValidity];
+    [self updateSpeculativeToken];
 }
 
 - (void)paymentFieldNextTapped {
@@ -482,8 +734,17 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     [self.tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationAutomatic];
 }
 
+- (void)addressViewModelWillBeginUpdates:(__unused STPAddressViewModel *)addressViewModel {
+    [self.tableView beginUpdates];
+}
+
+- (void)addressViewModelDidEndUpdates:(__unused STPAddressViewModel *)addressViewModel {
+    [self.tableView endUpdates];
+}
+
 - (void)addressViewModelDidChange:(__unused STPAddressViewModel *)addressViewModel {
-    [self updateDoneButton];
+    [self updateAddressValidity];
+    [self updateSpeculativeToken];
 }
 
 - (void)addressFieldTableViewCellDidReturn:(STPAddressFieldTableViewCell *)cell {
@@ -495,7 +756,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 - (void)addressFieldTableViewCellDidUpdateText:(STPAddressFieldTableViewCell *)cell {
     if (cell == self.emailCell) {
         [self lookupAndSendSMS:cell.contents];
-        [self updateDoneButton];
+        [self updateEmailValidity];
     }
 }
 
@@ -503,35 +764,72 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     if (self.checkoutAccount || self.configuration.smsAutofillDisabled || self.lookupSucceeded) {
         return;
     }
-    WEAK(self);
-    if ([STPEmailAddressValidator stringIsValidEmailAddress:email]) {
-        [self.emailCell.activityIndicator setAnimating:YES animated:YES];
-        [[[[self.stp_didAppearPromise voidFlatMap:^STPPromise * _Nonnull{
-            STRONG(self);
-            return [self.checkoutAPIClient lookupEmail:email];
-        }] flatMap:^STPPromise * _Nonnull(STPCheckoutAccountLookup *lookup) {
-            STRONG(self);
-            self.lookupSucceeded = YES;
-            self.checkoutLookup = lookup;
-            return [self.checkoutAPIClient sendSMSToAccountWithEmail:lookup.email];
-        }] onSuccess:^(STPCheckoutAPIVerification *verification) {
-            STRONG(self);
-            STPSMSCodeViewController *codeViewController = [[STPSMSCodeViewController alloc] initWithCheckoutAPIClient:self.checkoutAPIClient 
-                                                                                                          verification:verification 
-                                                                                                         redactedPhone:self.checkoutLookup.redactedPhone];
-            codeViewController.theme = self.theme;
-            codeViewController.delegate = self;
-            UINavigationController *nav = [[UINavigationController alloc] initWithRootViewController:codeViewController];
-            nav.navigationBar.stp_theme = self.theme;
-            nav.modalPresentationStyle = UIModalPresentationFormSheet;
-            [self presentViewController:nav animated:YES completion:nil];
-        }] onCompletion:^(__unused id value, NSError *error) {
-            STRONG(self);
-            if (![error stp_isURLSessionCancellationError]) {
-                [self.emailCell.activityIndicator setAnimating:NO animated:YES];
-            }
-        }];
+    NSUInteger generation = ++self.emailLookupGeneration;
+    [self.checkoutAPIClient cancelEmailLookupForOwner:self];
+    if (![STPEmailAddressValidator stringIsValidEmailAddress:email]) {
+        [self.emailCell.activityIndicator setAnimating:NO animated:YES];
+        return;
     }
+    [self.emailCell.activityIndicator setAnimating:YES animated:YES];
+    WEAK(self);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(EmailLookupDebounceInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        STRONG(self);
+        if (generation == self.emailLookupGeneration) {
+            [self lookupAndSendSMS:email generation:generation];
+        }
+    });
+}
+
+- (void)lookupAndSendSMS:(NSString *)email generation:(NSUInteger)generation {
+    WEAK(self);
+    STPPromise<STPCheckoutAccountLookup *> *lookupPromise = [self.stp_didAppearPromise voidFlatMap:^STPPromise * _Nonnull{
+        STRONG(self);
+        // A slow checkout bootstrap shouldn't leave the spinner running
+        // while the user types their card in by hand.
+        return [[self.checkoutAPIClient lookupEmail:email owner:self] timeout:EmailLookupTimeout];
+    }];
+    // The SMS goes out as soon as the lookup finds an account, and the code
+    // view controller is built while it's being sent.
+    STPPromise<STPCheckoutAPIVerification *> *smsPromise = [self.checkoutAPIClient sendSMSAfterLookup:lookupPromise ifCurrent:^BOOL{
+        STRONG(self);
+        return generation == self.emailLookupGeneration;
+    }];
+    __block UINavigationController *codeNavigationController;
+    __block STPSMSCodeViewController *codeViewController;
+    [lookupPromise onSuccess:^(STPCheckoutAccountLookup *lookup) {
+        STRONG(self);
+        if (generation != self.emailLookupGeneration) {
+            return;
+        }
+        self.lookupSucceeded = YES;
+        self.checkoutLookup = lookup;
+        codeViewController = [[STPSMSCodeViewController alloc] initWithCheckoutAPIClient:self.checkoutAPIClient
+                                                                            verification:nil
+                                                                           redactedPhone:lookup.redactedPhone];
+        codeViewController.theme = self.theme;
+        codeViewController.delegate = self;
+        codeNavigationController = [[UINavigationController alloc] initWithRootViewController:codeViewController];
+        codeNavigationController.navigationBar.stp_theme = self.theme;
+        codeNavigationController.modalPresentationStyle = UIModalPresentationFormSheet;
+        // Build its views now rather than when it is presented.
+        (void)codeViewController.view;
+    }];
+    [[smsPromise onSuccess:^(STPCheckoutAPIVerification *verification) {
+        STRONG(self);
+        // The lookup callback was queued on the main thread before the SMS
+        // request was even sent, so it has already run.
+        if (!codeViewController || generation != self.emailLookupGeneration) {
+            return;
+        }
+        codeViewController.verification = verification;
+        [self presentViewController:codeNavigationController animated:YES completion:nil];
+    }] onCompletion:^(__unused id value, __unused NSError *error) {
+        STRONG(self);
+        // A newer lookup owns the spinner now.
+        if (generation == self.emailLookupGeneration) {
+            [self.emailCell.activityIndicator setAnimating:NO animated:YES];
+        }
+    }];
 }
 
 - (void)addressFieldTableViewCellDidBackspaceOnEmpty:(__unused STPAddressFieldTableViewCell *)cell {
@@ -663,11 +961,11 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
     BOOL topRow = (indexPath.row == 0);
     BOOL bottomRow = ([self tableView:tableView numberOfRowsInSection:indexPath.section] - 1 == indexPath.row);
-    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor];
-    [cell stp_setTopBorderHidden:!topRow];
-    [cell stp_setBottomBorderHidden:!bottomRow];
-    [cell stp_setFakeSeparatorColor:self.theme.quaternaryBackgroundColor];
-    [cell stp_setFakeSeparatorLeftInset:15.0f];
+    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor
+          fakeSeparatorColor:self.theme.quaternaryBackgroundColor
+      fakeSeparatorLeftInset:15.0f
+             topBorderHidden:!topRow
+          bottomBorderHidden:!bottomRow];
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForFooterInSection:(NSInteger)section {
@@ -680,15 +978,21 @@ typedef NS_ENUM(NSUInteger, STPPaymentCardSection) {
     return 27.0f;
 }
 
+- (CGFloat)heightForHeaderView:(STPSectionHeaderView *)headerView {
+    CGFloat width = self.view.bounds.size.width;
+    return [self cachedHeightForContentKey:headerView.heightCacheKey width:width computation:^CGFloat{
+        return [headerView sizeThatFits:CGSizeMake(width, CGFLOAT_MAX)].height;
+    }];
+}
+
 - (CGFloat)tableView:(UITableView *)tableView heightForHeaderInSection:(NSInteger)section {
-    CGSize fittingSize = CGSizeMake(self.view.bounds.size.width, CGFLOAT_MAX);
     NSInteger numberOfRows = [self tableView:tableView numberOfRowsInSection:section];
     if (section == STPPaymentCardEmailSection) {
         return 0.01f;
     } else if (section == STPPaymentCardNumberSection) {
-        return [self.cardHeaderView sizeThatFits:fittingSize].height;
+        return [self heightForHeaderView:self.cardHeaderView];
     } else if (section == STPPaymentCardBillingAddressSection && numberOfRows != 0) {
-        return [self.addressHeaderView sizeThatFits:fittingSize].height;
+        return [self heightForHeaderView:self.addressHeaderView];
     } else if (section == STPPaymentCardRememberMeSection || numberOfRows != 0) {
         return tableView.sectionHeaderHeight;
     }
@@ -0,0 +1,43 @@
+//
+//  STPAddress+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPAddress.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface STPAddress ()
+
+/**
+ Like `initWithPKContact:`, but fields whose values in `contact` are the same
+ as in `previousContact` are copied from `previousAddress` instead of being
+ converted again, e.g. when only the postal address changed in the Apple Pay
+ sheet. `previousAddress` must have been made from `previousContact`, and not
+ changed since.
+ */
+- (instancetype)initWithPKContact:(PKContact *)contact
+                  previousContact:(nullable PKContact *)previousContact
+                  previousAddress:(nullable STPAddress *)previousAddress NS_AVAILABLE_IOS(9_0);
+
+/**
+ Like `PKContactValue`, but returns the same contact until the address
+ changes. Don't change the contact.
+ */
+- (PKContact *)cachedPKContactValue NS_AVAILABLE_IOS(9_0);
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated"
+/**
+ Like `ABRecordValue`, but returns the same record until the address changes.
+ Don't change the record.
+ */
+- (ABRecordRef)cachedABRecordValue;
+#pragma clang diagnostic pop
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -8,6 +8,7 @@
 
 #import "NSDictionary+Stripe.h"
 #import "STPAddress.h"
+#import "STPAddress+Private.h"
 #import "STPCardValidator.h"
 #import "STPEmailAddressValidator.h"
 #import "STPPhoneNumberValidator.h"
@@ -27,7 +28,18 @@ NSString *stringIfHasContentsElseNil(NSString *string);
 @property (nonatomic, readwrite, nullable, copy) NSString *familyName;
 @end
 
-@implementation STPAddress
+static BOOL STPContactValuesEqual(id value, id otherValue) {
+    return value == otherValue || [value isEqual:otherValue];
+}
+
+@implementation STPAddress {
+    // Guarded by @synchronized(self). The fingerprints are the fields the
+    // cached values were made from.
+    NSArray *_PKContactFingerprint;
+    PKContact *_cachedPKContact;
+    NSArray *_ABRecordFingerprint;
+    id _cachedABRecord;
+}
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated"
@@ -160,14 +172,7 @@ NSString *stringIfHasContentsElseNil(NSString *string);
 - (instancetype)initWithPKContact:(PKContact *)contact {
     self = [super init];
     if (self) {
-        NSPersonNameComponents *nameComponents = contact.name;
-        if (nameComponents) {
-            _givenName = stringIfHasContentsElseNil(nameComponents.givenName);
-            _familyName = stringIfHasContentsElseNil(nameComponents.familyName);
-            _name = stringIfHasContentsElseNil([NSPersonNameComponentsFormatter localizedStringFromPersonNameComponents:nameComponents
-                                                                                                                  style:NSPersonNameComponentsFormatterStyleDefault
-                                                                                                                options:(NSPersonNameComponentsFormatterOptions)0]);
-        }
+        [self setNameFromPersonNameComponents:contact.name];
         _email = stringIfHasContentsElseNil(contact.emailAddress);
         _phone = [self sanitizedPhoneStringFromCNPhoneNumber:contact.phoneNumber];
         [self setAddressFromCNPostalAddress:contact.postalAddress];
@@ -176,6 +181,82 @@ NSString *stringIfHasContentsElseNil(NSString *string);
     return self;
 }
 
+- (instancetype)initWithPKContact:(PKContact *)contact
+                  previousContact:(PKContact *)previousContact
+                  previousAddress:(STPAddress *)previousAddress {
+    if (!previousContact || !previousAddress) {
+        return [self initWithPKContact:contact];
+    }
+    self = [super init];
+    if (self) {
+        if (STPContactValuesEqual(contact.name, previousContact.name)) {
+            _givenName = previousAddress.givenName;
+            _familyName = previousAddress.familyName;
+            _name = previousAddress.name;
+        } else {
+            [self setNameFromPersonNameComponents:contact.name];
+        }
+        _email = stringIfHasContentsElseNil(contact.emailAddress);
+        if (STPContactValuesEqual(contact.phoneNumber, previousContact.phoneNumber)) {
+            _phone = previousAddress.phone;
+        } else {
+            _phone = [self sanitizedPhoneStringFromCNPhoneNumber:contact.phoneNumber];
+        }
+        if (STPContactValuesEqual(contact.postalAddress, previousContact.postalAddress)) {
+            _line1 = previousAddress.line1;
+            _city = previousAddress.city;
+            _state = previousAddress.state;
+            _postalCode = previousAddress.postalCode;
+            _country = previousAddress.country;
+        } else {
+            [self setAddressFromCNPostalAddress:contact.postalAddress];
+        }
+    }
+    return self;
+}
+
++ (dispatch_queue_t)importQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.address.import", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// CNContact and PKContact are immutable value objects, so they can be read from
+// the import queue. ABRecordRefs are tied to the thread of their address book,
+// which is why there is no asynchronous variant of initWithABRecord:.
++ (void)importAddressFromCNContact:(CNContact *)contact
+                        completion:(STPAddressImportBlock)completion {
+    dispatch_async([self importQueue], ^{
+        STPAddress *address = [[self alloc] initWithCNContact:contact];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(address);
+        });
+    });
+}
+
++ (void)importAddressFromPKContact:(PKContact *)contact
+                        completion:(STPAddressImportBlock)completion {
+    dispatch_async([self importQueue], ^{
+        STPAddress *address = [[self alloc] initWithPKContact:contact];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(address);
+        });
+    });
+}
+
+- (void)setNameFromPersonNameComponents:(NSPersonNameComponents *)nameComponents {
+    if (nameComponents) {
+        _givenName = stringIfHasContentsElseNil(nameComponents.givenName);
+        _familyName = stringIfHasContentsElseNil(nameComponents.familyName);
+        _name = stringIfHasContentsElseNil([NSPersonNameComponentsFormatter localizedStringFromPersonNameComponents:nameComponents
+                                                                                                              style:NSPersonNameComponentsFormatterStyleDefault
+                                                                                                            options:(NSPersonNameComponentsFormatterOptions)0]);
+    }
+}
+
 - (void)setAddressFromCNPostalAddress:(CNPostalAddress *)address {
     if (address) {
         _line1 = stringIfHasContentsElseNil(address.street);
@@ -204,6 +285,43 @@ NSString *stringIfHasContentsElseNil(NSString *string);
     return contact;
 }
 
+/**
+ The fields the contact and record conversions read.
+ */
+- (NSArray *)contactFingerprint {
+    NSNull *none = [NSNull null];
+    return @[self.name ?: none, self.givenName ?: none, self.familyName ?: none,
+             self.line1 ?: none, self.line2 ?: none, self.city ?: none, self.state ?: none,
+             self.postalCode ?: none, self.country ?: none, self.phone ?: none, self.email ?: none];
+}
+
+- (PKContact *)cachedPKContactValue {
+    NSArray *fingerprint = [self contactFingerprint];
+    @synchronized(self) {
+        if (!_cachedPKContact || ![_PKContactFingerprint isEqualToArray:fingerprint]) {
+            _cachedPKContact = [self PKContactValue];
+            _PKContactFingerprint = fingerprint;
+        }
+        return _cachedPKContact;
+    }
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated"
+
+- (ABRecordRef)cachedABRecordValue {
+    NSArray *fingerprint = [self contactFingerprint];
+    @synchronized(self) {
+        if (!_cachedABRecord || ![_ABRecordFingerprint isEqualToArray:fingerprint]) {
+            _cachedABRecord = (__bridge id)[self ABRecordValue];
+            _ABRecordFingerprint = fingerprint;
+        }
+        return (__bridge ABRecordRef)_cachedABRecord;
+    }
+}
+
+#pragma clang diagnostic pop
+
 - (NSString *)firstName {
     if (self.givenName) {
         return self.givenName;
@@ -9,20 +9,24 @@
 #import "STPAddressFieldTableViewCell.h"
 
 #import "STPCardValidator.h"
+#import "STPCountryList.h"
 #import "STPEmailAddressValidator.h"
 #import "STPLocalizationUtils.h"
 #import "STPPhoneNumberValidator.h"
 #import "STPPostalCodeValidator.h"
+#import "STPTheme+Private.h"
 
 @interface STPAddressFieldTableViewCell() <STPFormTextFieldDelegate, UIPickerViewDelegate, UIPickerViewDataSource>
 
 @property(nonatomic, weak) STPFormTextField *textField;
 @property(nonatomic) UIToolbar *inputAccessoryToolbar;
 @property(nonatomic) UIPickerView *countryPickerView;
-@property(nonatomic, strong) NSArray *countryCodes;
+// Fetched with the picker, so its rows don't change while it's shown
+@property(nonatomic, strong) STPCountryList *countryList;
 @property(nonatomic, weak)id<STPAddressFieldTableViewCellDelegate>delegate;
 @property(nonatomic, strong) NSString *ourCountryCode;
 @property(nonatomic, assign) STPPostalCodeType postalCodeType;
+@property(nonatomic)NSUInteger appliedThemeChangeToken;
 @end
 
 @implementation STPAddressFieldTableViewCell
@@ -45,39 +49,14 @@
         _textField = textField;
         [self.contentView addSubview:textField];
         
-        UIToolbar *toolbar = [UIToolbar new];
-        UIBarButtonItem *flexibleItem = [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemFlexibleSpace
-                                                                                      target:nil 
-                                                                                      action:nil];
-        UIBarButtonItem *nextItem = [[UIBarButtonItem alloc] initWithTitle:STPLocalizedString(@"Next", nil)
-                                                                     style:UIBarButtonItemStyleDone
-                                                                    target:self
-                                                                    action:@selector(nextTapped:)];
-        toolbar.items = @[flexibleItem, nextItem];
-        _inputAccessoryToolbar = toolbar;
-        
         NSString *countryCode = [[NSLocale autoupdatingCurrentLocale] objectForKey:NSLocaleCountryCode];
-        NSMutableArray *otherCountryCodes = [[NSLocale ISOCountryCodes] mutableCopy];
-        NSLocale *locale = [NSLocale currentLocale];
-        [otherCountryCodes removeObject:countryCode];
-        [otherCountryCodes sortUsingComparator:^NSComparisonResult(NSString *code1, NSString *code2) {
-            NSString *localeID1 = [NSLocale localeIdentifierFromComponents:@{NSLocaleCountryCode: code1}];
-            NSString *localeID2 = [NSLocale localeIdentifierFromComponents:@{NSLocaleCountryCode: code2}];
-            NSString *name1 = [locale displayNameForKey:NSLocaleIdentifier value:localeID1];
-            NSString *name2 = [locale displayNameForKey:NSLocaleIdentifier value:localeID2];
-            return [name1 compare:name2];
-        }];
-        if (countryCode) {
-           _countryCodes = [@[@"", countryCode] arrayByAddingObjectsFromArray:otherCountryCodes];
+        // The toolbar and country picker are only built for the field types
+        // that use them, the first time they're needed. The country list is
+        // only needed once the picker is, so it's built in the meantime.
+        if (type == STPAddressFieldTypeCountry) {
+            [STPCountryList prepareCurrentList];
         }
-        else {
-           _countryCodes = [@[@""] arrayByAddingObjectsFromArray:otherCountryCodes];
-        }
-        UIPickerView *pickerView = [UIPickerView new];
-        pickerView.dataSource = self;
-        pickerView.delegate = self;
-        _countryPickerView = pickerView;
-        
+
         _lastInList = lastInList;
         _type = type;
         self.textField.text = contents;
@@ -96,8 +75,48 @@
     return self;
 }
 
+- (UIToolbar *)inputAccessoryToolbar {
+    if (!_inputAccessoryToolbar) {
+        UIToolbar *toolbar = [UIToolbar new];
+        UIBarButtonItem *flexibleItem = [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemFlexibleSpace
+                                                                                      target:nil
+                                                                                      action:nil];
+        UIBarButtonItem *nextItem = [[UIBarButtonItem alloc] initWithTitle:STPLocalizedString(@"Next", nil)
+                                                                     style:UIBarButtonItemStyleDone
+                                                                    target:self
+                                                                    action:@selector(nextTapped:)];
+        toolbar.items = @[flexibleItem, nextItem];
+        toolbar.frame = CGRectMake(0, 0, self.bounds.size.width, 44);
+        _inputAccessoryToolbar = toolbar;
+    }
+    return _inputAccessoryToolbar;
+}
+
+- (UIPickerView *)countryPickerView {
+    if (!_countryPickerView) {
+        self.countryList = [STPCountryList currentList];
+        UIPickerView *pickerView = [UIPickerView new];
+        pickerView.dataSource = self;
+        pickerView.delegate = self;
+        _countryPickerView = pickerView;
+        [self selectCountryPickerRowForContents];
+    }
+    return _countryPickerView;
+}
+
+- (void)selectCountryPickerRowForContents {
+    NSUInteger index = [self.countryList.countryCodes indexOfObject:self.contents ?: @""];
+    if (index != NSNotFound) {
+        [_countryPickerView selectRow:(NSInteger)index inComponent:0 animated:NO];
+    }
+}
+
 - (void)setTheme:(STPTheme *)theme {
+    if (theme == _theme && theme.changeToken == self.appliedThemeChangeToken) {
+        return;
+    }
     _theme = theme;
+    self.appliedThemeChangeToken = theme.changeToken;
     [self updateAppearance];
 }
 
@@ -148,24 +167,21 @@
             break;
         case STPAddressFieldTypeCountry:
             self.textField.keyboardType = UIKeyboardTypeDefault;
-            self.textField.inputView = self.countryPickerView;
-            NSInteger index = [self.countryCodes indexOfObject:self.contents];
-            if (index == NSNotFound) {
-                self.textField.text = @"";
-            }
-            else {
-                [self.countryPickerView selectRow:index inComponent:0 animated:NO];
-                self.textField.text = [self pickerView:self.countryPickerView titleForRow:index forComponent:0];
-            }
+            // The picker is set as the input view when editing begins.
+            self.textField.text = [STPCountryList displayNameForCountryCode:self.contents] ?: @"";
+            [self selectCountryPickerRowForContents];
             self.textField.validText = [self validContents];
             break;
         case STPAddressFieldTypePhone:
             self.textField.keyboardType = UIKeyboardTypePhonePad;
-            if ([self countryCodeIsUnitedStates]) {
-                self.textField.autoFormattingBehavior = STPFormTextFieldAutoFormattingBehaviorPhoneNumbers;
-            } else {
-                self.textField.autoFormattingBehavior = STPFormTextFieldAutoFormattingBehaviorNone;
+        {
+            STPFormTextFieldAutoFormattingBehavior behavior = [self countryCodeIsUnitedStates] ? STPFormTextFieldAutoFormattingBehaviorPhoneNumbers : STPFormTextFieldAutoFormattingBehaviorNone;
+            // Reassigning rebuilds the field's formatting block, so skip it
+            // when the country change doesn't affect phone formatting.
+            if (self.textField.autoFormattingBehavior != behavior) {
+                self.textField.autoFormattingBehavior = behavior;
             }
+        }
             self.textField.preservesContentsOnPaste = NO;
             self.textField.selectionEnabled = NO;
             if (!self.lastInList) {
@@ -254,7 +270,7 @@
     [super layoutSubviews];
     CGFloat textFieldX = 15;
     self.textField.frame = CGRectMake(textFieldX, 1, self.bounds.size.width - textFieldX, self.bounds.size.height - 1);
-    self.inputAccessoryToolbar.frame = CGRectMake(0, 0, self.bounds.size.width, 44);
+    _inputAccessoryToolbar.frame = CGRectMake(0, 0, self.bounds.size.width, 44);
 }
 
 - (BOOL)becomeFirstResponder {
@@ -281,6 +297,13 @@
     [self.delegate addressFieldTableViewCellDidUpdateText:self];
 }
 
+- (BOOL)textFieldShouldBeginEditing:(__unused UITextField *)textField {
+    if (self.type == STPAddressFieldTypeCountry && !self.textField.inputView) {
+        self.textField.inputView = self.countryPickerView;
+    }
+    return YES;
+}
+
 - (BOOL)textFieldShouldReturn:(__unused UITextField *)textField {
     if ([self.delegate respondsToSelector:@selector(addressFieldTableViewCellDidReturn:)]) {
         [self.delegate addressFieldTableViewCellDidReturn:self];
@@ -292,6 +315,20 @@
     textField.validText = [self validContents];
 }
 
+- (NSAttributedString *)formTextField:(__unused STPFormTextField *)formTextField
+             modifyIncomingTextChange:(NSAttributedString *)input {
+    if (self.type != STPAddressFieldTypeZip) {
+        return input;
+    }
+    NSString *formatted = [STPPostalCodeValidator formattedSanitizedPostalCodeFromString:input.string
+                                                                             countryCode:self.ourCountryCode];
+    if ([formatted isEqualToString:input.string]) {
+        return input;
+    }
+    NSDictionary *attributes = input.length > 0 ? [input attributesAtIndex:0 effectiveRange:NULL] : @{};
+    return [[NSAttributedString alloc] initWithString:formatted attributes:attributes];
+}
+
 - (void)formTextFieldDidBackspaceOnEmpty:(__unused STPFormTextField *)formTextField {
     [self.delegate addressFieldTableViewCellDidBackspaceOnEmpty:self];
 }
@@ -367,7 +404,7 @@
 #pragma mark - UIPickerView
 
 - (void)pickerView:(UIPickerView *)pickerView didSelectRow:(NSInteger)row inComponent:(NSInteger)component {
-    self.ourCountryCode = self.countryCodes[row];
+    self.ourCountryCode = self.countryList.countryCodes[row];
     self.contents = self.ourCountryCode;
     self.textField.text = [self pickerView:pickerView titleForRow:row forComponent:component];
     if ([self.delegate respondsToSelector:@selector(addressFieldTableViewCountryCode)]) {
@@ -376,9 +413,7 @@
 }
 
 - (NSString *)pickerView:(__unused UIPickerView *)pickerView titleForRow:(NSInteger)row forComponent:(__unused NSInteger)component {
-    NSString *countryCode = self.countryCodes[row];
-    NSString *identifier = [NSLocale localeIdentifierFromComponents:@{NSLocaleCountryCode: countryCode}];
-    return [[NSLocale autoupdatingCurrentLocale] displayNameForKey:NSLocaleIdentifier value:identifier];
+    return self.countryList.displayNames[row];
 }
 
 - (NSInteger)numberOfComponentsInPickerView:(__unused UIPickerView *)pickerView {
@@ -386,7 +421,7 @@
 }
 
 - (NSInteger)pickerView:(__unused UIPickerView *)pickerView numberOfRowsInComponent:(__unused NSInteger)component {
-    return self.countryCodes.count;
+    return self.countryList.countryCodes.count;
 }
 
 @end
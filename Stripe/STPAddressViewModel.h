@@ -17,6 +17,13 @@
 - (void)addressViewModelDidChange:(STPAddressViewModel *)addressViewModel;
 - (void)addressViewModel:(STPAddressViewModel *)addressViewModel addedCellAtIndex:(NSUInteger)index;
 - (void)addressViewModel:(STPAddressViewModel *)addressViewModel removedCellAtIndex:(NSUInteger)index;
+/**
+ Bracket a country change, during which cells may be added or removed and every
+ cell reconfigures its captions. Table views should apply the row changes
+ reported in between as a single update.
+ */
+- (void)addressViewModelWillBeginUpdates:(STPAddressViewModel *)addressViewModel;
+- (void)addressViewModelDidEndUpdates:(STPAddressViewModel *)addressViewModel;
 
 @end
 
@@ -32,4 +39,10 @@
 - (instancetype)initWithRequiredShippingFields:(PKAddressField)requiredShippingAddressFields;
 - (STPAddressFieldTableViewCell *)cellAtIndex:(NSInteger)index;
 
+/**
+ Fills the cells from a contact. The contact is mapped off the main thread and
+ the cells are updated on the main thread once it is ready.
+ */
+- (void)importAddressFromCNContact:(CNContact *)contact NS_AVAILABLE_IOS(9_0);
+
 @end
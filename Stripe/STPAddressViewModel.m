@@ -9,6 +9,7 @@
 #import "STPAddressViewModel.h"
 #import "NSArray+Stripe_BoundSafe.h"
 #import "STPPostalCodeValidator.h"
+#import "STPWeakStrongMacros.h"
 
 @interface STPAddressViewModel()<STPAddressFieldTableViewCellDelegate>
 @property(nonatomic)BOOL isBillingAddress;
@@ -16,6 +17,15 @@
 @property(nonatomic)PKAddressField requiredShippingAddressFields;
 @property(nonatomic)NSArray<STPAddressFieldTableViewCell *> *addressCells;
 @property(nonatomic)BOOL showingPostalCodeCell;
+@property(nonatomic)STPAddressFieldTableViewCell *postalCodeCell;
+/**
+ An address mirroring the cells' contents, used only to answer `isValid`. It is
+ kept up to date one field at a time as cells change, and thrown away whenever
+ the set of cells or the country changes. `-address` still hands out a fresh
+ instance, as callers hold on to (and mutate) what they get back.
+ */
+@property(nonatomic)STPAddress *validationAddress;
+@property(nonatomic)NSNumber *cachedIsValid;
 @end
 
 @implementation STPAddressViewModel
@@ -98,16 +108,31 @@
     [self updatePostalCodeCellIfNecessary];
 }
 
+/**
+ The postal code cell comes and goes as the user flips between countries, so
+ hold on to one instance and hand it back out cleared rather than building a
+ new cell (and text field) every time it reappears.
+ */
+- (STPAddressFieldTableViewCell *)reusablePostalCodeCellWithLastInList:(BOOL)lastInList {
+    if (!self.postalCodeCell) {
+        self.postalCodeCell = [[STPAddressFieldTableViewCell alloc] initWithType:STPAddressFieldTypeZip contents:@"" lastInList:lastInList delegate:self];
+    }
+    else {
+        self.postalCodeCell.contents = @"";
+        self.postalCodeCell.lastInList = lastInList;
+    }
+    return self.postalCodeCell;
+}
+
 - (void)updatePostalCodeCellIfNecessary {
     STPPostalCodeType postalCodeType = [STPPostalCodeValidator postalCodeTypeForCountryCode:_addressFieldTableViewCountryCode];
     BOOL shouldBeShowingPostalCode = (postalCodeType != STPCountryPostalCodeTypeNotRequired);
     if (shouldBeShowingPostalCode && !self.showingPostalCodeCell) {
         if (self.isBillingAddress && self.requiredBillingAddressFields == STPBillingAddressFieldsZip) {
             self.addressCells = @[
-                                  [[STPAddressFieldTableViewCell alloc] initWithType:STPAddressFieldTypeZip contents:@"" lastInList:YES delegate:self]
+                                  [self reusablePostalCodeCellWithLastInList:YES]
                                   ];
             [self.delegate addressViewModel:self addedCellAtIndex:0];
-            [self.delegate addressViewModelDidChange:self];
         }
         else if (self.containsStateAndPostalFields) {
             // Add after STPAddressFieldTypeState
@@ -119,11 +144,10 @@
                 NSUInteger zipFieldIndex = stateFieldIndex + 1;
 
                 NSMutableArray<STPAddressFieldTableViewCell *> *mutableAddressCells = self.addressCells.mutableCopy;
-                [mutableAddressCells insertObject:[[STPAddressFieldTableViewCell alloc] initWithType:STPAddressFieldTypeZip contents:@"" lastInList:NO delegate:self]
+                [mutableAddressCells insertObject:[self reusablePostalCodeCellWithLastInList:NO]
                                           atIndex:zipFieldIndex];
                 self.addressCells = mutableAddressCells.copy;
                 [self.delegate addressViewModel:self addedCellAtIndex:zipFieldIndex];
-                [self.delegate addressViewModelDidChange:self];
             }
         }
     }
@@ -131,7 +155,6 @@
         if (self.isBillingAddress && self.requiredBillingAddressFields == STPBillingAddressFieldsZip) {
             self.addressCells = @[];
             [self.delegate addressViewModel:self removedCellAtIndex:0];
-            [self.delegate addressViewModelDidChange:self];
         }
         else if (self.containsStateAndPostalFields) {
             NSUInteger zipFieldIndex = [self.addressCells indexOfObjectPassingTest:^BOOL(STPAddressFieldTableViewCell * _Nonnull obj, NSUInteger __unused idx, BOOL * _Nonnull __unused stop) {
@@ -143,7 +166,6 @@
                 [mutableAddressCells removeObjectAtIndex:zipFieldIndex];
                 self.addressCells = mutableAddressCells.copy;
                 [self.delegate addressViewModel:self removedCellAtIndex:zipFieldIndex];
-                [self.delegate addressViewModelDidChange:self];
             }
         }
     }
@@ -175,27 +197,55 @@
     }
 }
 
-- (void)addressFieldTableViewCellDidUpdateText:(__unused STPAddressFieldTableViewCell *)cell {
+- (void)addressFieldTableViewCellDidUpdateText:(STPAddressFieldTableViewCell *)cell {
+    if (self.validationAddress) {
+        [[self class] applyContentsOfCell:cell toAddress:self.validationAddress];
+    }
+    self.cachedIsValid = nil;
     [self.delegate addressViewModelDidChange:self];
 }
 
+- (void)invalidateValidationAddress {
+    self.validationAddress = nil;
+    self.cachedIsValid = nil;
+}
+
+- (void)setAddressCells:(NSArray<STPAddressFieldTableViewCell *> *)addressCells {
+    _addressCells = addressCells;
+    [self invalidateValidationAddress];
+}
+
 - (BOOL)isValid {
-    if (self.isBillingAddress) {
-        return [self.address containsRequiredFields:self.requiredBillingAddressFields];
-    }
-    else {
-        return [self.address containsRequiredShippingAddressFields:self.requiredShippingAddressFields];
+    if (!self.cachedIsValid) {
+        if (!self.validationAddress) {
+            self.validationAddress = self.address;
+        }
+        BOOL isValid;
+        if (self.isBillingAddress) {
+            isValid = [self.validationAddress containsRequiredFields:self.requiredBillingAddressFields];
+        }
+        else {
+            isValid = [self.validationAddress containsRequiredShippingAddressFields:self.requiredShippingAddressFields];
+        }
+        self.cachedIsValid = @(isValid);
     }
+    return [self.cachedIsValid boolValue];
 }
 
 - (void)setAddressFieldTableViewCountryCode:(NSString *)addressFieldTableViewCountryCode {
     if (addressFieldTableViewCountryCode.length > 0 // ignore if someone passing in nil or empty and keep our current setup
         && ![_addressFieldTableViewCountryCode isEqualToString:addressFieldTableViewCountryCode]) {
         _addressFieldTableViewCountryCode = addressFieldTableViewCountryCode.copy;
+        // Work out the new set of cells and reconfigure them all before telling
+        // the delegate anything changed, so the table animates once.
+        [self.delegate addressViewModelWillBeginUpdates:self];
         [self updatePostalCodeCellIfNecessary];
         for (STPAddressFieldTableViewCell *cell in self.addressCells) {
             [cell delegateCountryCodeDidChange:_addressFieldTableViewCountryCode];
         }
+        [self invalidateValidationAddress];
+        [self.delegate addressViewModelDidEndUpdates:self];
+        [self.delegate addressViewModelDidChange:self];
     }
 }
 
@@ -233,45 +283,57 @@
                 break;
         }
     }
+    [self invalidateValidationAddress];
+}
+
++ (void)applyContentsOfCell:(STPAddressFieldTableViewCell *)cell toAddress:(STPAddress *)address {
+    switch (cell.type) {
+        case STPAddressFieldTypeName:
+            address.name = cell.contents;
+            break;
+        case STPAddressFieldTypeLine1:
+            address.line1 = cell.contents;
+            break;
+        case STPAddressFieldTypeLine2:
+            address.line2 = cell.contents;
+            break;
+        case STPAddressFieldTypeCity:
+            address.city = cell.contents;
+            break;
+        case STPAddressFieldTypeState:
+            address.state = cell.contents;
+            break;
+        case STPAddressFieldTypeZip:
+            address.postalCode = cell.contents;
+            break;
+        case STPAddressFieldTypeCountry:
+            address.country = cell.contents;
+            break;
+        case STPAddressFieldTypeEmail:
+            address.email = cell.contents;
+            break;
+        case STPAddressFieldTypePhone:
+            address.phone = cell.contents;
+            break;
+    }
 }
 
 - (STPAddress *)address {
     STPAddress *address = [STPAddress new];
     for (STPAddressFieldTableViewCell *cell in self.addressCells) {
-        
-        switch (cell.type) {
-            case STPAddressFieldTypeName:
-                address.name = cell.contents;
-                break;
-            case STPAddressFieldTypeLine1:
-                address.line1 = cell.contents;
-                break;
-            case STPAddressFieldTypeLine2:
-                address.line2 = cell.contents;
-                break;
-            case STPAddressFieldTypeCity:
-                address.city = cell.contents;
-                break;
-            case STPAddressFieldTypeState:
-                address.state = cell.contents;
-                break;
-            case STPAddressFieldTypeZip:
-                address.postalCode = cell.contents;
-                break;
-            case STPAddressFieldTypeCountry:
-                address.country = cell.contents;
-                break;
-            case STPAddressFieldTypeEmail:
-                address.email = cell.contents;
-                break;
-            case STPAddressFieldTypePhone:
-                address.phone = cell.contents;
-                break;
-        }
+        [[self class] applyContentsOfCell:cell toAddress:address];
     }
     return address;
 }
 
+- (void)importAddressFromCNContact:(CNContact *)contact {
+    WEAK(self);
+    [STPAddress importAddressFromCNContact:contact completion:^(STPAddress *address) {
+        STRONG(self);
+        self.address = address;
+    }];
+}
+
 - (STPAddressFieldTableViewCell *)cellBeforeCell:(STPAddressFieldTableViewCell *)cell {
     NSInteger index = [self.addressCells indexOfObject:cell];
     return [self.addressCells stp_boundSafeObjectAtIndex:index - 1];
@@ -19,11 +19,27 @@ typedef NS_ENUM(NSUInteger, STPAddCardRememberMeUsage) {
     STPAddCardRememberMeUsageAddedFromSMS       = 4,
 };
 
+/**
+ SDK components whose use is reported with token and source creation events.
+ Each is set by the component's initializer.
+ */
+typedef NS_OPTIONS(NSUInteger, STPAnalyticsProductUsage) {
+    STPAnalyticsProductUsagePaymentCardTextField          = 1 << 0,
+    STPAnalyticsProductUsagePaymentContext                = 1 << 1,
+    STPAnalyticsProductUsageAddCardViewController         = 1 << 2,
+    STPAnalyticsProductUsagePaymentMethodsViewController  = 1 << 3,
+    STPAnalyticsProductUsageShippingAddressViewController = 1 << 4,
+};
+
 @interface STPAnalyticsClient : NSObject
 
 + (instancetype)sharedClient;
 
-+ (void)initializeIfNeeded;
+/**
+ Records that `usage` has been used. Cheap enough to call from every
+ initializer.
+ */
++ (void)trackProductUsage:(STPAnalyticsProductUsage)usage;
 
 + (void)disableAnalytics;
 
@@ -31,6 +47,20 @@ typedef NS_ENUM(NSUInteger, STPAddCardRememberMeUsage) {
 
 + (NSString *)tokenTypeFromParameters:(NSDictionary *)parameters;
 
+/**
+ Called around each API request. Queued events aren't sent while any
+ request is in flight.
+ */
+- (void)apiRequestDidStart;
+- (void)apiRequestDidFinish;
+
+#if DEBUG
+/**
+ How many events are waiting to be sent, for the performance HUD.
+ */
+- (NSUInteger)pendingEventCount;
+#endif
+
 - (void)logRememberMeConversion:(STPAddCardRememberMeUsage)selected;
 
 - (void)logTokenCreationAttemptWithConfiguration:(STPPaymentConfiguration *)configuration
@@ -39,10 +69,25 @@ typedef NS_ENUM(NSUInteger, STPAddCardRememberMeUsage) {
 - (void)logSourceCreationAttemptWithConfiguration:(STPPaymentConfiguration *)configuration
                                        sourceType:(NSString *)sourceType;
 
+- (void)logTokenBatchCreationWithConfiguration:(STPPaymentConfiguration *)configuration
+                                        count:(NSUInteger)count
+                                    succeeded:(NSUInteger)succeeded
+                                        start:(NSDate *)startTime
+                                          end:(NSDate *)endTime;
+
+/**
+ Adds how long creating `token` took to the RUM histograms, under the token's
+ type, rather than logging an event for every token.
+ */
 - (void)logRUMWithToken:(STPToken *)token
           configuration:(STPPaymentConfiguration *)config
                response:(NSHTTPURLResponse *)response
                   start:(NSDate *)startTime
                     end:(NSDate *)endTime;
 
+/**
+ Logs a histogram summary from `STPRUMCollector`.
+ */
+- (void)logRUMSummary:(NSDictionary *)summary;
+
 @end
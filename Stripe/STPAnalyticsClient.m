@@ -7,30 +7,48 @@
 //
 
 #import "STPAnalyticsClient.h"
+#import "NSBundle+Stripe_AppName.h"
 
-#import "NSMutableURLRequest+Stripe.h"
 #import "STPAPIClient+ApplePay.h"
 #import "STPAPIClient.h"
-#import "STPAddCardViewController+Private.h"
-#import "STPAddCardViewController.h"
-#import "STPAspects.h"
+#import "STPAnalyticsUploader.h"
 #import "STPCard.h"
+#import "STPExtensionMode.h"
 #import "STPFormEncodable.h"
-#import "STPPaymentCardTextField.h"
 #import "STPPaymentConfiguration.h"
-#import "STPPaymentContext.h"
-#import "STPPaymentMethodsViewController+Private.h"
-#import "STPPaymentMethodsViewController.h"
+#import "STPPaymentConfiguration+Private.h"
+#import "STPRUMCollector.h"
 #import "STPToken.h"
+#import "STPURLSessionPool.h"
 #import <UIKit/UIKit.h>
+#import <stdatomic.h>
 #import <sys/utsname.h>
 
 static BOOL STPAnalyticsCollectionDisabled = NO;
+static _Atomic(NSUInteger) STPAnalyticsProductUsageFlags = 0;
+
+/**
+ A configuration's serialized form, along with the configuration's
+ `changeCount` when it was serialized.
+ */
+@interface STPAnalyticsSerializedConfiguration : NSObject
+@property (nonatomic) NSUInteger changeCount;
+@property (nonatomic) NSDictionary *dictionary;
+@end
+
+@implementation STPAnalyticsSerializedConfiguration
+@end
 
 @interface STPAnalyticsClient()
 
-@property (nonatomic) NSSet *apiUsage;
+// Names of the product usage flags set so far, sorted; rebuilt when a new
+// flag is set
+@property (atomic, copy) NSArray *productUsage;
+@property (atomic) NSUInteger productUsageFlags;
+@property (nonatomic) NSMapTable<STPPaymentConfiguration *, STPAnalyticsSerializedConfiguration *> *serializedConfigurations;
+@property (nonatomic) dispatch_queue_t serializedConfigurationsQueue;
 @property (nonatomic, readwrite) NSURLSession *urlSession;
+@property (nonatomic) STPAnalyticsUploader *uploader;
 
 @end
 
@@ -45,54 +63,17 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
     return sharedClient;
 }
 
-+ (void)initialize {
-    [self initializeIfNeeded];
-}
-
-+ (void)initializeIfNeeded {
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        [STPPaymentCardTextField stp_aspect_hookSelector:@selector(commonInit)
-                                             withOptions:STPAspectPositionAfter
-                                              usingBlock:^{
-                                                  STPAnalyticsClient *client = [self sharedClient];
-                                                  [client setApiUsage:[client.apiUsage setByAddingObject:NSStringFromClass([STPPaymentCardTextField class])]];
-                                              } error:nil];
-        
-        [STPPaymentContext stp_aspect_hookSelector:@selector(initWithAPIAdapter:configuration:theme:)
-                                       withOptions:STPAspectPositionAfter
-                                        usingBlock:^{
-                                            STPAnalyticsClient *client = [self sharedClient];
-                                            [client setApiUsage:[client.apiUsage setByAddingObject:NSStringFromClass([STPPaymentContext class])]];
-                                        } error:nil];
-        
-        
-        [STPAddCardViewController stp_aspect_hookSelector:@selector(commonInitWithConfiguration:)
-                                              withOptions:STPAspectPositionAfter
-                                               usingBlock:^{
-                                                   STPAnalyticsClient *client = [self sharedClient];
-                                                   [client setApiUsage:[client.apiUsage setByAddingObject:NSStringFromClass([STPAddCardViewController class])]];
-                                               } error:nil];
-        
-        [STPPaymentMethodsViewController stp_aspect_hookSelector:@selector(initWithConfiguration:apiAdapter:loadingPromise:theme:shippingAddress:delegate:)
-                                                     withOptions:STPAspectPositionAfter
-                                                      usingBlock:^{
-                                                          STPAnalyticsClient *client = [self sharedClient];
-                                                          [client setApiUsage:[client.apiUsage setByAddingObject:NSStringFromClass([STPPaymentMethodsViewController class])]];
-                                                      } error:nil];
-
-        [STPShippingAddressViewController stp_aspect_hookSelector:@selector(initWithConfiguration:theme:currency:shippingAddress:selectedShippingMethod:prefilledInformation:)
-                                                      withOptions:STPAspectPositionAfter
-                                                       usingBlock:^{
-                                                           STPAnalyticsClient *client = [self sharedClient];
-                                                           [client setApiUsage:[client.apiUsage setByAddingObject:NSStringFromClass([STPShippingAddressViewController class])]];
-                                                       } error:nil];
-
-    });
++ (void)trackProductUsage:(STPAnalyticsProductUsage)usage {
+    // Checked first so that repeat calls from initializers don't contend on
+    // the atomic write.
+    if ((atomic_load_explicit(&STPAnalyticsProductUsageFlags, memory_order_relaxed) & usage) != usage) {
+        atomic_fetch_or(&STPAnalyticsProductUsageFlags, usage);
+    }
 }
 
 + (void)disableAnalytics {
     STPAnalyticsCollectionDisabled = YES;
+    [STPRUMCollector sharedCollector].enabled = NO;
 }
 
 + (BOOL)shouldCollectAnalytics {
@@ -130,13 +111,36 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
 - (instancetype)init {
     self = [super init];
     if (self) {
-        NSURLSessionConfiguration *config = [NSURLSessionConfiguration defaultSessionConfiguration];
-        _urlSession = [NSURLSession sessionWithConfiguration:config];
-        _apiUsage = [NSSet set];
+        // Nothing is ever logged in extension mode, so there's nothing to upload
+        if (!stpExtensionModeEnabled()) {
+            // Analytics traffic should never hold up payment requests
+            _urlSession = [[STPURLSessionPool sharedPool] sessionForHost:@"q.stripe.com"
+                                                       additionalHeaders:nil
+                                                      networkServiceType:NSURLNetworkServiceTypeBackground];
+            _uploader = [[STPAnalyticsUploader alloc] initWithURLSession:_urlSession
+                                                                 fileURL:[STPAnalyticsUploader defaultFileURL]];
+        }
+        _productUsage = @[];
+        _serializedConfigurations = [NSMapTable weakToStrongObjectsMapTable];
+        _serializedConfigurationsQueue = dispatch_queue_create("com.stripe.analytics.configurations", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
 
+- (void)apiRequestDidStart {
+    [self.uploader apiRequestDidStart];
+}
+
+- (void)apiRequestDidFinish {
+    [self.uploader apiRequestDidFinish];
+}
+
+#if DEBUG
+- (NSUInteger)pendingEventCount {
+    return self.uploader.pendingPayloads.count;
+}
+#endif
+
 - (void)logRememberMeConversion:(STPAddCardRememberMeUsage)selected {
     NSMutableDictionary *payload = [self.class commonPayload];
     [payload addEntriesFromDictionary:@{
@@ -146,21 +150,53 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
     [self logPayload:payload];
 }
 
-- (NSArray *)productUsage {
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:NSStringFromSelector(@selector(description)) ascending:YES];
-    NSArray *productUsage = [self.apiUsage sortedArrayUsingDescriptors:@[sortDescriptor]];
-    return productUsage ?: @[];
+- (NSArray *)currentProductUsage {
+    NSUInteger flags = atomic_load(&STPAnalyticsProductUsageFlags);
+    if (flags != self.productUsageFlags) {
+        // Names rather than classes, so analytics doesn't link the UI
+        NSArray<NSString *> *classNames = @[
+                                            @"STPPaymentCardTextField",
+                                            @"STPPaymentContext",
+                                            @"STPAddCardViewController",
+                                            @"STPPaymentMethodsViewController",
+                                            @"STPShippingAddressViewController",
+                                            ];
+        NSMutableArray<NSString *> *usage = [NSMutableArray array];
+        [classNames enumerateObjectsUsingBlock:^(NSString *className, NSUInteger idx, __unused BOOL *stop) {
+            if (flags & ((NSUInteger)1 << idx)) {
+                [usage addObject:className];
+            }
+        }];
+        self.productUsage = [usage sortedArrayUsingSelector:@selector(compare:)];
+        self.productUsageFlags = flags;
+    }
+    return self.productUsage;
+}
+
+- (NSDictionary *)serializedConfiguration:(STPPaymentConfiguration *)configuration {
+    __block NSDictionary *dictionary;
+    dispatch_sync(self.serializedConfigurationsQueue, ^{
+        STPAnalyticsSerializedConfiguration *serialized = [self.serializedConfigurations objectForKey:configuration];
+        if (!serialized || serialized.changeCount != configuration.changeCount) {
+            serialized = [STPAnalyticsSerializedConfiguration new];
+            serialized.changeCount = configuration.changeCount;
+            serialized.dictionary = [self.class serializeConfiguration:configuration];
+            [self.serializedConfigurations setObject:serialized forKey:configuration];
+        }
+        dictionary = serialized.dictionary;
+    });
+    return dictionary;
 }
 
 - (void)logTokenCreationAttemptWithConfiguration:(STPPaymentConfiguration *)configuration
                                        tokenType:(NSString *)tokenType {
-    NSDictionary *configurationDictionary = [self.class serializeConfiguration:configuration];
+    NSDictionary *configurationDictionary = [self serializedConfiguration:configuration];
     NSMutableDictionary *payload = [self.class commonPayload];
     [payload addEntriesFromDictionary:@{
                                         @"event": @"stripeios.token_creation",
                                         @"token_type": tokenType ?: @"unknown",
                                         @"apple_pay_enabled": @([Stripe deviceSupportsApplePay]),
-                                        @"product_usage": [self productUsage],
+                                        @"product_usage": [self currentProductUsage],
                                         }];
     [payload addEntriesFromDictionary:configurationDictionary];
     [self logPayload:payload];
@@ -168,23 +204,46 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
 
 - (void)logSourceCreationAttemptWithConfiguration:(STPPaymentConfiguration *)configuration
                                        sourceType:(NSString *)sourceType {
-    NSDictionary *configurationDictionary = [self.class serializeConfiguration:configuration];
+    NSDictionary *configurationDictionary = [self serializedConfiguration:configuration];
     NSMutableDictionary *payload = [self.class commonPayload];
     [payload addEntriesFromDictionary:@{
                                         @"event": @"stripeios.source_creation",
                                         @"source_type": sourceType ?: @"unknown",
                                         @"apple_pay_enabled": @([Stripe deviceSupportsApplePay]),
-                                        @"product_usage": [self productUsage],
+                                        @"product_usage": [self currentProductUsage],
+                                        }];
+    [payload addEntriesFromDictionary:configurationDictionary];
+    [self logPayload:payload];
+}
+
+- (void)logTokenBatchCreationWithConfiguration:(STPPaymentConfiguration *)configuration
+                                        count:(NSUInteger)count
+                                    succeeded:(NSUInteger)succeeded
+                                        start:(NSDate *)startTime
+                                          end:(NSDate *)endTime {
+    NSDictionary *configurationDictionary = [self serializedConfiguration:configuration];
+    NSMutableDictionary *payload = [self.class commonPayload];
+    [payload addEntriesFromDictionary:@{
+                                        @"event": @"stripeios.token_batch_creation",
+                                        @"token_type": @"card",
+                                        @"count": @(count),
+                                        @"succeeded": @(succeeded),
+                                        @"product_usage": [self currentProductUsage],
+                                        @"start": [[self class] timestampWithDate:startTime],
+                                        @"end": [[self class] timestampWithDate:endTime],
                                         }];
     [payload addEntriesFromDictionary:configurationDictionary];
     [self logPayload:payload];
 }
 
 - (void)logRUMWithToken:(STPToken *)token
-          configuration:(STPPaymentConfiguration *)configuration
+          configuration:(__unused STPPaymentConfiguration *)configuration
                response:(NSHTTPURLResponse *)response
                   start:(NSDate *)startTime
                     end:(NSDate *)endTime {
+    if (![[self class] shouldCollectAnalytics]) {
+        return;
+    }
     NSString *tokenTypeString = @"unknown";
     if (token.bankAccount) {
         tokenTypeString = @"bank_account";
@@ -195,22 +254,30 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
             tokenTypeString = @"card";
         }
     }
-    NSNumber *start = [[self class] timestampWithDate:startTime];
-    NSNumber *end = [[self class] timestampWithDate:endTime];
+    // Failures are kept apart, so they don't skew the successful timings
+    NSString *outcome = (token && response.statusCode < 400) ? @"succeeded" : @"failed";
+    [[STPRUMCollector sharedCollector] recordDuration:[endTime timeIntervalSinceDate:startTime]
+                                            forMetric:[NSString stringWithFormat:@"token_creation.%@.%@", tokenTypeString, outcome]
+                                             category:STPRUMCategoryNetwork];
+}
+
+- (void)logRUMSummary:(NSDictionary *)summary {
     NSMutableDictionary *payload = [self.class commonPayload];
-    [payload addEntriesFromDictionary:@{
-                                        @"event": @"rum.stripeios",
-                                        @"tokenType": tokenTypeString,
-                                        @"url": response.URL.absoluteString ?: @"unknown",
-                                        @"status": @(response.statusCode),
-                                        @"publishable_key": configuration.publishableKey ?: @"unknown",
-                                        @"start": start,
-                                        @"end": end,
-                                        }];
+    [payload addEntriesFromDictionary:summary];
     [self logPayload:payload];
 }
 
 + (NSMutableDictionary *)commonPayload {
+    // None of this changes while the app runs
+    static NSDictionary *commonPayload;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        commonPayload = [self buildCommonPayload];
+    });
+    return [commonPayload mutableCopy];
+}
+
++ (NSDictionary *)buildCommonPayload {
     NSMutableDictionary *payload = [NSMutableDictionary dictionary];
     payload[@"bindings_version"] = STPSDKVersion;
     payload[@"analytics_ua"] = @"analytics.stripeios-1.0";
@@ -224,7 +291,10 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
     if (deviceType) {
         payload[@"device_type"] = deviceType;
     }
-    return payload;
+    payload[@"app_name"] = [NSBundle stp_applicationName];
+    payload[@"app_version"] = [NSBundle stp_applicationVersion];
+    payload[@"app_bundle_identifier"] = [NSBundle stp_applicationBundleIdentifier];
+    return [payload copy];
 }
 
 + (NSDictionary *)serializeConfiguration:(STPPaymentConfiguration *)configuration {
@@ -277,11 +347,7 @@ static BOOL STPAnalyticsCollectionDisabled = NO;
     if (![[self class] shouldCollectAnalytics]) {
         return;
     }
-    NSURL *url = [NSURL URLWithString:@"https://q.stripe.com"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
-    [request stp_addParametersToURL:payload];
-    NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request];
-    [task resume];
+    [self.uploader enqueuePayload:payload];
 }
 
 @end
@@ -0,0 +1,62 @@
+//
+//  STPAnalyticsUploader.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Queues analytics events and sends them in bursts rather than one request per
+ event as they're logged, at low priority and only while no API requests are
+ in flight, so they stay out of the way of the requests that triggered them. A burst goes out once enough events are pending, a
+ while after the first one is queued, or when the app enters the background.
+ Pending events are saved to disk, and any left over are sent on the next
+ launch.
+ */
+@interface STPAnalyticsUploader : NSObject
+
+/**
+ @param urlSession The session to send events with.
+ @param fileURL Where to save pending events.
+ */
+- (instancetype)initWithURLSession:(NSURLSession *)urlSession
+                           fileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Queues `payload` to be sent as the query of a GET to q.stripe.com.
+ */
+- (void)enqueuePayload:(NSDictionary *)payload;
+
+/**
+ Sends every pending event now.
+ */
+- (void)flush;
+
+/**
+ Calls around each payment API request. While any are in flight, bursts are
+ held back until shortly after the last one finishes. A burst for the app
+ entering the background goes out regardless.
+ */
+- (void)apiRequestDidStart;
+- (void)apiRequestDidFinish;
+
+/**
+ The events that haven't been sent yet.
+ */
+@property (nonatomic, readonly) NSArray<NSDictionary *> *pendingPayloads;
+
+/**
+ Where pending events are saved by default.
+ */
++ (NSURL *)defaultFileURL;
+
+@end
+
+NS_ASSUME_NONNULL_END
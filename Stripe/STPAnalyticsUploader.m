@@ -0,0 +1,232 @@
+//
+//  STPAnalyticsUploader.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPAnalyticsUploader.h"
+
+#import <UIKit/UIKit.h>
+
+#import "NSMutableURLRequest+Stripe.h"
+#import "STPExtensionMode.h"
+#import "STPPerformanceCounters.h"
+
+static NSString *const AnalyticsURLString = @"https://q.stripe.com";
+// Send a burst once this many events are pending
+static NSUInteger const MaxBatchSize = 20;
+// Send a burst this long after the first event is queued
+static NSTimeInterval const FlushInterval = 15;
+// How long the API has to be idle before a held-back burst goes out
+static NSTimeInterval const IdleDelay = 1;
+// Drop the oldest events beyond this, e.g. while offline for a long time
+static NSUInteger const MaxPendingPayloads = 100;
+
+@interface STPAnalyticsUploader ()
+
+@property (nonatomic) NSURLSession *urlSession;
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) NSMutableArray<NSDictionary *> *payloads;
+@property (nonatomic) BOOL flushScheduled;
+// Bumped on every send, so a flush scheduled before it doesn't fire early
+@property (nonatomic) NSUInteger flushGeneration;
+@property (nonatomic) NSInteger activeAPIRequestCount;
+@property (nonatomic) BOOL flushWaitingForIdle;
+
+@end
+
+@implementation STPAnalyticsUploader
+
++ (NSURL *)defaultFileURL {
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] firstObject];
+    return [cachesURL URLByAppendingPathComponent:@"com.stripe.analytics.json"];
+}
+
+- (instancetype)initWithURLSession:(NSURLSession *)urlSession
+                           fileURL:(NSURL *)fileURL {
+    self = [super init];
+    if (self) {
+        _urlSession = urlSession;
+        _fileURL = fileURL;
+        _queue = dispatch_queue_create("com.stripe.analytics.uploader", DISPATCH_QUEUE_SERIAL);
+        _payloads = [NSMutableArray array];
+        dispatch_async(_queue, ^{
+            [self loadPayloads];
+            if (self.payloads.count > 0) {
+                [self scheduleFlush];
+            }
+        });
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(handleDidEnterBackgroundNotification)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)enqueuePayload:(NSDictionary *)payload {
+    dispatch_async(self.queue, ^{
+        [self.payloads addObject:payload];
+        if (self.payloads.count > MaxPendingPayloads) {
+            NSUInteger droppedCount = self.payloads.count - MaxPendingPayloads;
+            STPPerformanceCounterAdd(STPPerformanceCounterAnalyticsEventsDropped, droppedCount);
+            [self.payloads removeObjectsInRange:NSMakeRange(0, droppedCount)];
+        }
+        [self savePayloads];
+        if (self.payloads.count >= MaxBatchSize) {
+            [self sendPendingPayloadsWhenIdle];
+        } else {
+            [self scheduleFlush];
+        }
+    });
+}
+
+- (void)flush {
+    dispatch_async(self.queue, ^{
+        [self sendPendingPayloadsWithCompletion:nil];
+    });
+}
+
+- (void)apiRequestDidStart {
+    dispatch_async(self.queue, ^{
+        self.activeAPIRequestCount++;
+    });
+}
+
+- (void)apiRequestDidFinish {
+    dispatch_async(self.queue, ^{
+        self.activeAPIRequestCount = MAX(self.activeAPIRequestCount - 1, 0);
+        if (self.activeAPIRequestCount == 0 && self.flushWaitingForIdle) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(IdleDelay * NSEC_PER_SEC)), self.queue, ^{
+                if (self.flushWaitingForIdle) {
+                    [self sendPendingPayloadsWhenIdle];
+                }
+            });
+        }
+    });
+}
+
+- (NSArray<NSDictionary *> *)pendingPayloads {
+    __block NSArray *payloads;
+    dispatch_sync(self.queue, ^{
+        payloads = [self.payloads copy];
+    });
+    return payloads;
+}
+
+- (void)handleDidEnterBackgroundNotification {
+    UIApplication *application = stpSharedApplication();
+    __block UIBackgroundTaskIdentifier bgTaskID = UIBackgroundTaskInvalid;
+    bgTaskID = [application beginBackgroundTaskWithExpirationHandler:^{
+        [application endBackgroundTask:bgTaskID];
+        bgTaskID = UIBackgroundTaskInvalid;
+    }];
+    dispatch_async(self.queue, ^{
+        [self sendPendingPayloadsWithCompletion:^{
+            [application endBackgroundTask:bgTaskID];
+            bgTaskID = UIBackgroundTaskInvalid;
+        }];
+    });
+}
+
+#pragma mark - Private, called on queue
+
+- (void)scheduleFlush {
+    if (self.flushScheduled) {
+        return;
+    }
+    self.flushScheduled = YES;
+    NSUInteger generation = self.flushGeneration;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(FlushInterval * NSEC_PER_SEC)), self.queue, ^{
+        if (self.flushScheduled && self.flushGeneration == generation) {
+            [self sendPendingPayloadsWhenIdle];
+        }
+    });
+}
+
+- (void)sendPendingPayloadsWhenIdle {
+    if (self.activeAPIRequestCount > 0) {
+        self.flushWaitingForIdle = YES;
+        return;
+    }
+    [self sendPendingPayloadsWithCompletion:nil];
+}
+
+- (void)sendPendingPayloadsWithCompletion:(dispatch_block_t)completion {
+    self.flushScheduled = NO;
+    self.flushWaitingForIdle = NO;
+    self.flushGeneration++;
+    NSArray<NSDictionary *> *batch = [self.payloads copy];
+    [self.payloads removeAllObjects];
+    [self savePayloads];
+
+    // q.stripe.com takes one event per request, so the batch goes out as a
+    // burst of requests that share the session's connection.
+    dispatch_group_t group = dispatch_group_create();
+    NSMutableArray<NSDictionary *> *failedPayloads = [NSMutableArray array];
+    for (NSDictionary *payload in batch) {
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:AnalyticsURLString]];
+        [request stp_addParametersToURL:payload];
+        dispatch_group_enter(group);
+        NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request completionHandler:^(__unused NSData *data, __unused NSURLResponse *response, NSError *error) {
+            if (error) {
+                dispatch_async(self.queue, ^{
+                    [failedPayloads addObject:payload];
+                    dispatch_group_leave(group);
+                });
+            } else {
+                STPPerformanceCounterIncrement(STPPerformanceCounterAnalyticsEventsSent);
+                dispatch_group_leave(group);
+            }
+        }];
+        task.priority = NSURLSessionTaskPriorityLow;
+        [task resume];
+    }
+    dispatch_group_notify(group, self.queue, ^{
+        if (failedPayloads.count > 0) {
+            // Try again later, keeping the original order
+            [self.payloads insertObjects:failedPayloads atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, failedPayloads.count)]];
+            [self savePayloads];
+            [self scheduleFlush];
+        }
+        if (completion) {
+            completion();
+        }
+    });
+}
+
+- (void)loadPayloads {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    id payloads = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:NULL];
+    if ([payloads isKindOfClass:[NSArray class]]) {
+        for (id payload in payloads) {
+            if ([payload isKindOfClass:[NSDictionary class]]) {
+                [self.payloads addObject:payload];
+            }
+        }
+    }
+}
+
+- (void)savePayloads {
+    if (self.payloads.count == 0) {
+        [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+        return;
+    }
+    if (![NSJSONSerialization isValidJSONObject:self.payloads]) {
+        return;
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:self.payloads options:(NSJSONWritingOptions)kNilOptions error:NULL];
+    [data writeToURL:self.fileURL options:NSDataWritingAtomic error:NULL];
+}
+
+@end
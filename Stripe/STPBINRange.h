@@ -11,16 +11,77 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ The longest BIN prefix in `allRanges`. Lookups never need to look past this
+ many digits of the card number, so a number's brand only changes when one of
+ its first `STPBINRangeMaxPrefixLength` digits does.
+ */
+#define STPBINRangeMaxPrefixLength ((NSUInteger)6)
+
 @interface STPBINRange : NSObject
 
 @property(nonatomic, readonly)NSUInteger length;
 @property(nonatomic, readonly)STPCardBrand brand;
+@property(nonatomic, readonly)NSString *qRangeLow;
+@property(nonatomic, readonly)NSString *qRangeHigh;
+
+- (instancetype)initWithQRangeLow:(NSString *)qRangeLow
+                       qRangeHigh:(NSString *)qRangeHigh
+                           length:(NSUInteger)length
+                            brand:(STPCardBrand)brand;
+
+/**
+ Replaces any previously installed additional ranges with `ranges`, which are
+ then used by every lookup alongside the built-in ones. The swap is atomic, so
+ lookups on other threads see either the old or the new set. Returns NO, and
+ installs nothing, if any range has a prefix longer than
+ `STPBINRangeMaxPrefixLength` or bounds of different lengths.
+ */
++ (BOOL)installAdditionalRanges:(NSArray<STPBINRange *> *)ranges;
 
 + (NSArray<STPBINRange *> *)allRanges;
 + (NSArray<STPBINRange *> *)binRangesForNumber:(NSString *)number;
 + (NSArray<STPBINRange *> *)binRangesForBrand:(STPCardBrand)brand;
+
+/**
+ The card number lengths of `brand`'s ranges, and the longest of them (-1 if
+ it has none). Like `binRangesForBrand:`, these are worked out when ranges are
+ installed, so they're cheap enough to call on every keystroke.
+ */
++ (NSSet<NSNumber *> *)lengthsForBrand:(STPCardBrand)brand;
++ (NSInteger)maxLengthForBrand:(STPCardBrand)brand;
 + (instancetype)mostSpecificBINRangeForNumber:(NSString *)number;
 
+/**
+ Same as `mostSpecificBINRangeForNumber:`, for callers that already have the
+ number's characters in a buffer. Only the first few characters are read.
+ */
++ (instancetype)mostSpecificBINRangeForCharacters:(const unichar *)characters length:(NSUInteger)length;
+
+/**
+ Same as `mostSpecificBINRangeForNumber:`, for a number held as digit values
+ (0 to 9), as in `STPCardNumberDigits`.
+ */
++ (instancetype)mostSpecificBINRangeForDigits:(const uint8_t *)digits length:(NSUInteger)length;
+
+/**
+ The one brand, other than STPCardBrandUnknown, of the ranges that match a
+ number starting with `digits`, or STPCardBrandUnknown if there are several
+ or none. Same as checking the brands of `binRangesForNumber:`, without
+ building the array.
+ */
++ (STPCardBrand)brandForDigits:(const uint8_t *)digits length:(NSUInteger)length;
+
+/**
+ Narrows `candidates` (indexes into `allRanges`) down to those that match a
+ number starting with `characters`. Adding digits to a number can only remove
+ matches, so callers that see a number one digit at a time can pass in the
+ previous result instead of checking every range again.
+ */
++ (NSIndexSet *)indexesOfRanges:(NSIndexSet *)candidates
+              matchingCharacters:(const unichar *)characters
+                          length:(NSUInteger)length;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -8,79 +8,135 @@
 
 #import "STPBINRange.h"
 #import "NSString+Stripe.h"
+#import "STPBINRangeData.h"
+#import "STPPerformanceCounters.h"
+
+#import <stdatomic.h>
 
 @interface STPBINRange()
 
 @property(nonatomic)NSUInteger length;
-@property(nonatomic)NSString *qRangeLow;
-@property(nonatomic)NSString *qRangeHigh;
+@property(nonatomic, readwrite)NSString *qRangeLow;
+@property(nonatomic, readwrite)NSString *qRangeHigh;
 @property(nonatomic)STPCardBrand brand;
 
 - (BOOL)matchesNumber:(NSString *)number;
 
 @end
 
+/**
+ Integer form of a BIN range, precomputed once so that lookups don't need to
+ create substrings or parse integers on every keystroke.
+ */
+typedef struct {
+    NSUInteger prefixLength;
+    NSInteger low;
+    NSInteger high;
+} STPBINRangeBounds;
+
+// STPCardBrandUnknown is the last brand
+#define STPBINRangeBrandCount ((NSUInteger)STPCardBrandUnknown + 1)
+
+/**
+ What the per-brand lookups return, worked out once per table so that they
+ don't filter every range on each keystroke.
+ */
+typedef struct {
+    // Retained NSArray<STPBINRange *> of the brand's ranges
+    const void *ranges;
+    // Retained NSSet<NSNumber *> of their lengths
+    const void *lengths;
+    // The longest of them, or -1 if the brand has no ranges
+    NSInteger maxLength;
+} STPBINRangeBrandMetadata;
+
+/**
+ Everything a lookup reads, built in one go so that a new set of ranges can be
+ swapped in with a single pointer store while other threads are mid-lookup.
+ Replaced tables are never freed, because a lookup may still be using them;
+ this happens at most once or twice per process.
+ */
+typedef struct {
+    NSUInteger count;
+    // Bounds for each entry of `ranges`, in the same order
+    STPBINRangeBounds *bounds;
+    // Indexes into `ranges`, ordered from most to least specific
+    NSUInteger *specificityOrder;
+    // Retained NSArray<STPBINRange *>
+    const void *ranges;
+    // Indexed by STPCardBrand
+    STPBINRangeBrandMetadata brands[STPBINRangeBrandCount];
+} STPBINRangeTable;
+
+static _Atomic(STPBINRangeTable *) STPBINRangeCurrentTable;
+static NSArray<STPBINRange *> *STPBINRangeBuiltInRanges;
+
+static const NSInteger STPBINRangePowersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+static inline NSArray<STPBINRange *> *STPBINRangeTableRanges(const STPBINRangeTable *table) {
+    return (__bridge NSArray<STPBINRange *> *)table->ranges;
+}
 
 @implementation STPBINRange
 
 + (NSArray<STPBINRange *> *)allRanges {
-    
-    static NSArray<STPBINRange *> *STPBINRangeAllRanges;
-    
+    return STPBINRangeTableRanges([self currentTable]);
+}
+
++ (STPBINRangeTable *)currentTable {
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        NSArray *ranges = @[
-                            // Catch-all values
-                            @[@"", @"", @16, @(STPCardBrandUnknown)],
-                            @[@"34", @"34", @15, @(STPCardBrandAmex)],
-                            @[@"37", @"37", @15, @(STPCardBrandAmex)],
-                            @[@"30", @"30", @14, @(STPCardBrandDinersClub)],
-                            @[@"36", @"36", @14, @(STPCardBrandDinersClub)],
-                            @[@"38", @"39", @14, @(STPCardBrandDinersClub)],
-                            @[@"6011", @"6011", @16, @(STPCardBrandDiscover)],
-                            @[@"622", @"622",   @16, @(STPCardBrandDiscover)],
-                            @[@"64", @"65",     @16, @(STPCardBrandDiscover)],
-                            @[@"35", @"35", @16, @(STPCardBrandJCB)],
-                            @[@"5", @"5", @16, @(STPCardBrandMasterCard)],
-                            @[@"4", @"4", @16, @(STPCardBrandVisa)],
-                            // Specific known BIN ranges
-                            @[@"222100", @"272099", @16, @(STPCardBrandMasterCard)],
-                            
-                            @[@"413600", @"413600", @13, @(STPCardBrandVisa)],
-                            @[@"444509", @"444509", @13, @(STPCardBrandVisa)],
-                            @[@"444509", @"444509", @13, @(STPCardBrandVisa)],
-                            @[@"444550", @"444550", @13, @(STPCardBrandVisa)],
-                            @[@"450603", @"450603", @13, @(STPCardBrandVisa)],
-                            @[@"450617", @"450617", @13, @(STPCardBrandVisa)],
-                            @[@"450628", @"450629", @13, @(STPCardBrandVisa)],
-                            @[@"450636", @"450636", @13, @(STPCardBrandVisa)],
-                            @[@"450640", @"450641", @13, @(STPCardBrandVisa)],
-                            @[@"450662", @"450662", @13, @(STPCardBrandVisa)],
-                            @[@"463100", @"463100", @13, @(STPCardBrandVisa)],
-                            @[@"476142", @"476142", @13, @(STPCardBrandVisa)],
-                            @[@"476143", @"476143", @13, @(STPCardBrandVisa)],
-                            @[@"492901", @"492902", @13, @(STPCardBrandVisa)],
-                            @[@"492920", @"492920", @13, @(STPCardBrandVisa)],
-                            @[@"492923", @"492923", @13, @(STPCardBrandVisa)],
-                            @[@"492928", @"492930", @13, @(STPCardBrandVisa)],
-                            @[@"492937", @"492937", @13, @(STPCardBrandVisa)],
-                            @[@"492939", @"492939", @13, @(STPCardBrandVisa)],
-                            @[@"492960", @"492960", @13, @(STPCardBrandVisa)],
-                            ];
-        NSMutableArray *binRanges = [NSMutableArray array];
-        for (NSArray *range in ranges) {
-            STPBINRange *binRange = [self.class new];
-            binRange.qRangeLow  = range[0];
-            binRange.qRangeHigh = range[1];
-            binRange.length     = [range[2] unsignedIntegerValue];
-            binRange.brand = [range[3] integerValue];
-            [binRanges addObject:binRange];
+        // Generated from STPBINRanges.csv, already sorted and de-duplicated
+        size_t count = sizeof(STPBINRangeBuiltInData) / sizeof(STPBINRangeBuiltInData[0]);
+        NSMutableArray *binRanges = [NSMutableArray arrayWithCapacity:count];
+        for (size_t i = 0; i < count; i++) {
+            const STPBINRangeData *data = &STPBINRangeBuiltInData[i];
+            NSString *low = @"";
+            NSString *high = @"";
+            if (data->prefixLength > 0) {
+                low = [NSString stringWithFormat:@"%0*u", (int)data->prefixLength, data->low];
+                high = [NSString stringWithFormat:@"%0*u", (int)data->prefixLength, data->high];
+            }
+            [binRanges addObject:[[self alloc] initWithQRangeLow:low
+                                                      qRangeHigh:high
+                                                          length:data->length
+                                                           brand:data->brand]];
         }
-        STPBINRangeAllRanges = [binRanges copy];
+        STPBINRangeBuiltInRanges = [binRanges copy];
+        atomic_store_explicit(&STPBINRangeCurrentTable, [self newTableWithRanges:binRanges], memory_order_release);
     });
-    return STPBINRangeAllRanges;
+    return atomic_load_explicit(&STPBINRangeCurrentTable, memory_order_acquire);
+}
+
++ (BOOL)installAdditionalRanges:(NSArray<STPBINRange *> *)ranges {
+    // Additional ranges go after the built-in ones, so that indexes into
+    // `allRanges` handed out earlier still refer to the same ranges, and so
+    // that they win ties against built-in ranges of the same specificity.
+    [self currentTable];
+    for (STPBINRange *range in ranges) {
+        if (range.qRangeLow.length > STPBINRangeMaxPrefixLength ||
+            range.qRangeLow.length != range.qRangeHigh.length) {
+            return NO;
+        }
+    }
+    STPBINRangeTable *table = [self newTableWithRanges:[STPBINRangeBuiltInRanges arrayByAddingObjectsFromArray:ranges]];
+    atomic_store_explicit(&STPBINRangeCurrentTable, table, memory_order_release);
+    return YES;
 }
 
+- (instancetype)initWithQRangeLow:(NSString *)qRangeLow
+                       qRangeHigh:(NSString *)qRangeHigh
+                           length:(NSUInteger)length
+                            brand:(STPCardBrand)brand {
+    self = [super init];
+    if (self) {
+        _qRangeLow = [qRangeLow copy];
+        _qRangeHigh = [qRangeHigh copy];
+        _length = length;
+        _brand = brand;
+    }
+    return self;
+}
 
 /**
  Number matching strategy: Truncate the longer of the two numbers (theirs and our
@@ -108,27 +164,224 @@
     return withinLowRange && withinHighRange;
 }
 
-- (NSComparisonResult)compare:(STPBINRange *)other {
-    return [@(self.qRangeLow.length) compare:@(other.qRangeLow.length)];
++ (STPBINRangeTable *)newTableWithRanges:(NSArray<STPBINRange *> *)ranges {
+    NSUInteger count = ranges.count;
+    STPBINRangeBounds *bounds = calloc(count, sizeof(STPBINRangeBounds));
+    NSUInteger *specificityOrder = calloc(count, sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < count; i++) {
+        STPBINRange *range = ranges[i];
+        NSAssert(range.qRangeLow.length <= STPBINRangeMaxPrefixLength, @"BIN prefixes longer than %lu digits are not supported", (unsigned long)STPBINRangeMaxPrefixLength);
+        bounds[i] = (STPBINRangeBounds){
+            .prefixLength = range.qRangeLow.length,
+            .low = range.qRangeLow.integerValue,
+            .high = range.qRangeHigh.integerValue,
+        };
+    }
+
+    // Most specific (longest prefix) first. Ties go to the later entry in
+    // `allRanges`, which is what sorting by prefix length and taking the last
+    // match used to return.
+    NSMutableArray<NSNumber *> *order = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [order addObject:@(i)];
+    }
+    [order sortUsingComparator:^NSComparisonResult(NSNumber *obj1, NSNumber *obj2) {
+        NSUInteger index1 = obj1.unsignedIntegerValue;
+        NSUInteger index2 = obj2.unsignedIntegerValue;
+        NSUInteger length1 = bounds[index1].prefixLength;
+        NSUInteger length2 = bounds[index2].prefixLength;
+        if (length1 != length2) {
+            return length1 > length2 ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return index1 > index2 ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    for (NSUInteger i = 0; i < count; i++) {
+        specificityOrder[i] = order[i].unsignedIntegerValue;
+    }
+
+    STPBINRangeTable *table = calloc(1, sizeof(STPBINRangeTable));
+    table->count = count;
+    table->bounds = bounds;
+    table->specificityOrder = specificityOrder;
+    table->ranges = CFBridgingRetain([ranges copy]);
+    for (NSUInteger brand = 0; brand < STPBINRangeBrandCount; brand++) {
+        NSMutableArray<STPBINRange *> *brandRanges = [NSMutableArray array];
+        NSMutableSet<NSNumber *> *lengths = [NSMutableSet set];
+        NSInteger maxLength = -1;
+        for (STPBINRange *range in ranges) {
+            if ((NSUInteger)range.brand == brand) {
+                [brandRanges addObject:range];
+                [lengths addObject:@(range.length)];
+                maxLength = MAX(maxLength, (NSInteger)range.length);
+            }
+        }
+        table->brands[brand] = (STPBINRangeBrandMetadata){
+            .ranges = CFBridgingRetain([brandRanges copy]),
+            .lengths = CFBridgingRetain([lengths copy]),
+            .maxLength = maxLength,
+        };
+    }
+    return table;
+}
+
+// NULL for brands this version of the SDK doesn't know about, which have no
+// ranges
+static inline const STPBINRangeBrandMetadata *STPBINRangeTableBrand(const STPBINRangeTable *table, STPCardBrand brand) {
+    if (brand < 0 || (NSUInteger)brand >= STPBINRangeBrandCount) {
+        return NULL;
+    }
+    return &table->brands[brand];
+}
+
+/**
+ Reads the leading digits of `characters` into `prefixes`, where `prefixes[i]`
+ is the integer value of the first `i` characters. Mirrors `integerValue`,
+ which stops at the first non-digit character.
+
+ @return The number of characters read, at most `STPBINRangeMaxPrefixLength`.
+ */
+static NSUInteger STPBINRangeReadPrefixes(const unichar *characters, NSUInteger length, NSInteger prefixes[STPBINRangeMaxPrefixLength + 1]) {
+    length = MIN(length, STPBINRangeMaxPrefixLength);
+
+    BOOL sawNonDigit = NO;
+    prefixes[0] = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar c = characters[i];
+        if (sawNonDigit || c < '0' || c > '9') {
+            sawNonDigit = YES;
+            prefixes[i + 1] = prefixes[i];
+        } else {
+            prefixes[i + 1] = prefixes[i] * 10 + (c - '0');
+        }
+    }
+    return length;
+}
+
+/**
+ Same as `STPBINRangeReadPrefixes`, for digit values rather than characters.
+ */
+static NSUInteger STPBINRangeReadDigitPrefixes(const uint8_t *digits, NSUInteger length, NSInteger prefixes[STPBINRangeMaxPrefixLength + 1]) {
+    length = MIN(length, STPBINRangeMaxPrefixLength);
+    prefixes[0] = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        prefixes[i + 1] = prefixes[i] * 10 + digits[i];
+    }
+    return length;
+}
+
+/**
+ Integer equivalent of `-matchesNumber:`: when the number is shorter than the
+ range's prefix, the bounds are truncated to the number's length instead.
+ */
+static BOOL STPBINRangeBoundsMatch(const STPBINRangeBounds *bounds, const NSInteger prefixes[STPBINRangeMaxPrefixLength + 1], NSUInteger length) {
+    if (length >= bounds->prefixLength) {
+        NSInteger value = prefixes[bounds->prefixLength];
+        return value >= bounds->low && value <= bounds->high;
+    }
+    NSInteger divisor = STPBINRangePowersOfTen[bounds->prefixLength - length];
+    NSInteger value = prefixes[length];
+    return value >= bounds->low / divisor && value <= bounds->high / divisor;
 }
 
 + (NSArray<STPBINRange *> *)binRangesForNumber:(NSString *)number {
-    return [[self allRanges] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(STPBINRange *range, __unused NSDictionary *bindings) {
-        return [range matchesNumber:number];
-    }]];
+    STPPerformanceCounterIncrement(STPPerformanceCounterBINRangeLookups);
+    STPBINRangeTable *table = [self currentTable];
+    NSArray<STPBINRange *> *allRanges = STPBINRangeTableRanges(table);
+    unichar characters[STPBINRangeMaxPrefixLength];
+    NSUInteger length = MIN(number.length, STPBINRangeMaxPrefixLength);
+    [number getCharacters:characters range:NSMakeRange(0, length)];
+    NSInteger prefixes[STPBINRangeMaxPrefixLength + 1];
+    length = STPBINRangeReadPrefixes(characters, length, prefixes);
+
+    NSMutableArray<STPBINRange *> *validRanges = [NSMutableArray array];
+    for (NSUInteger i = 0; i < table->count; i++) {
+        if (STPBINRangeBoundsMatch(&table->bounds[i], prefixes, length)) {
+            [validRanges addObject:allRanges[i]];
+        }
+    }
+    return [validRanges copy];
 }
 
 + (instancetype)mostSpecificBINRangeForNumber:(NSString *)number {
-    NSArray *validRanges = [[self allRanges] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(STPBINRange *range, __unused NSDictionary *bindings) {
-        return [range matchesNumber:number];
-    }]];
-    return [[validRanges sortedArrayUsingSelector:@selector(compare:)] lastObject];
+    unichar characters[STPBINRangeMaxPrefixLength];
+    NSUInteger length = MIN(number.length, STPBINRangeMaxPrefixLength);
+    [number getCharacters:characters range:NSMakeRange(0, length)];
+    return [self mostSpecificBINRangeForCharacters:characters length:length];
+}
+
++ (instancetype)mostSpecificBINRangeForCharacters:(const unichar *)characters length:(NSUInteger)length {
+    NSInteger prefixes[STPBINRangeMaxPrefixLength + 1];
+    length = STPBINRangeReadPrefixes(characters, length, prefixes);
+    return [self mostSpecificBINRangeForPrefixes:prefixes length:length];
+}
+
++ (instancetype)mostSpecificBINRangeForDigits:(const uint8_t *)digits length:(NSUInteger)length {
+    NSInteger prefixes[STPBINRangeMaxPrefixLength + 1];
+    length = STPBINRangeReadDigitPrefixes(digits, length, prefixes);
+    return [self mostSpecificBINRangeForPrefixes:prefixes length:length];
+}
+
++ (instancetype)mostSpecificBINRangeForPrefixes:(const NSInteger *)prefixes length:(NSUInteger)length {
+    STPPerformanceCounterIncrement(STPPerformanceCounterBINRangeLookups);
+    STPBINRangeTable *table = [self currentTable];
+    NSArray<STPBINRange *> *allRanges = STPBINRangeTableRanges(table);
+
+    // The least specific range is the catch-all, which matches every number
+    NSUInteger lastIndex = table->count - 1;
+    for (NSUInteger i = 0; i < lastIndex; i++) {
+        NSUInteger index = table->specificityOrder[i];
+        if (STPBINRangeBoundsMatch(&table->bounds[index], prefixes, length)) {
+            return allRanges[index];
+        }
+    }
+    return allRanges[table->specificityOrder[lastIndex]];
+}
+
++ (STPCardBrand)brandForDigits:(const uint8_t *)digits length:(NSUInteger)length {
+    STPBINRangeTable *table = [self currentTable];
+    NSArray<STPBINRange *> *allRanges = STPBINRangeTableRanges(table);
+    NSInteger prefixes[STPBINRangeMaxPrefixLength + 1];
+    length = STPBINRangeReadDigitPrefixes(digits, length, prefixes);
+
+    STPCardBrand brand = STPCardBrandUnknown;
+    for (NSUInteger i = 0; i < table->count; i++) {
+        STPCardBrand rangeBrand = allRanges[i].brand;
+        if (rangeBrand == STPCardBrandUnknown || rangeBrand == brand || !STPBINRangeBoundsMatch(&table->bounds[i], prefixes, length)) {
+            continue;
+        }
+        if (brand != STPCardBrandUnknown) {
+            // A second brand matches
+            return STPCardBrandUnknown;
+        }
+        brand = rangeBrand;
+    }
+    return brand;
+}
+
++ (NSIndexSet *)indexesOfRanges:(NSIndexSet *)candidates
+              matchingCharacters:(const unichar *)characters
+                          length:(NSUInteger)length {
+    STPBINRangeTable *table = [self currentTable];
+    NSInteger prefixes[STPBINRangeMaxPrefixLength + 1];
+    length = STPBINRangeReadPrefixes(characters, length, prefixes);
+    return [candidates indexesPassingTest:^BOOL(NSUInteger index, __unused BOOL *stop) {
+        return index < table->count && STPBINRangeBoundsMatch(&table->bounds[index], prefixes, length);
+    }];
 }
 
 + (NSArray<STPBINRange *> *)binRangesForBrand:(STPCardBrand)brand {
-    return [[self allRanges] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(STPBINRange *range, __unused NSDictionary *bindings) {
-        return range.brand == brand;
-    }]];
+    const STPBINRangeBrandMetadata *metadata = STPBINRangeTableBrand([self currentTable], brand);
+    return metadata ? (__bridge NSArray<STPBINRange *> *)metadata->ranges : @[];
+}
+
++ (NSSet<NSNumber *> *)lengthsForBrand:(STPCardBrand)brand {
+    const STPBINRangeBrandMetadata *metadata = STPBINRangeTableBrand([self currentTable], brand);
+    return metadata ? (__bridge NSSet<NSNumber *> *)metadata->lengths : [NSSet set];
+}
+
++ (NSInteger)maxLengthForBrand:(STPCardBrand)brand {
+    const STPBINRangeBrandMetadata *metadata = STPBINRangeTableBrand([self currentTable], brand);
+    return metadata ? metadata->maxLength : -1;
 }
 
 @end
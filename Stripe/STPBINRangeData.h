@@ -0,0 +1,56 @@
+//
+//  STPBINRangeData.h
+//  Stripe
+//
+//  Generated by ci_scripts/generate_bin_ranges.rb from STPBINRanges.csv.
+//  Do not edit.
+//
+
+#import "STPCardBrand.h"
+
+/**
+ A built-in BIN range in integer form. Sorted by prefix length, then bounds,
+ so the catch-all comes first.
+ */
+typedef struct {
+    uint8_t prefixLength;
+    uint32_t low;
+    uint32_t high;
+    uint8_t length;
+    STPCardBrand brand;
+} STPBINRangeData;
+
+static const STPBINRangeData STPBINRangeBuiltInData[] = {
+    {0, 0, 0, 16, STPCardBrandUnknown},
+    {1, 4, 4, 16, STPCardBrandVisa},
+    {1, 5, 5, 16, STPCardBrandMasterCard},
+    {2, 30, 30, 14, STPCardBrandDinersClub},
+    {2, 34, 34, 15, STPCardBrandAmex},
+    {2, 35, 35, 16, STPCardBrandJCB},
+    {2, 36, 36, 14, STPCardBrandDinersClub},
+    {2, 37, 37, 15, STPCardBrandAmex},
+    {2, 38, 39, 14, STPCardBrandDinersClub},
+    {2, 64, 65, 16, STPCardBrandDiscover},
+    {3, 622, 622, 16, STPCardBrandDiscover},
+    {4, 6011, 6011, 16, STPCardBrandDiscover},
+    {6, 222100, 272099, 16, STPCardBrandMasterCard},
+    {6, 413600, 413600, 13, STPCardBrandVisa},
+    {6, 444509, 444509, 13, STPCardBrandVisa},
+    {6, 444550, 444550, 13, STPCardBrandVisa},
+    {6, 450603, 450603, 13, STPCardBrandVisa},
+    {6, 450617, 450617, 13, STPCardBrandVisa},
+    {6, 450628, 450629, 13, STPCardBrandVisa},
+    {6, 450636, 450636, 13, STPCardBrandVisa},
+    {6, 450640, 450641, 13, STPCardBrandVisa},
+    {6, 450662, 450662, 13, STPCardBrandVisa},
+    {6, 463100, 463100, 13, STPCardBrandVisa},
+    {6, 476142, 476142, 13, STPCardBrandVisa},
+    {6, 476143, 476143, 13, STPCardBrandVisa},
+    {6, 492901, 492902, 13, STPCardBrandVisa},
+    {6, 492920, 492920, 13, STPCardBrandVisa},
+    {6, 492923, 492923, 13, STPCardBrandVisa},
+    {6, 492928, 492930, 13, STPCardBrandVisa},
+    {6, 492937, 492937, 13, STPCardBrandVisa},
+    {6, 492939, 492939, 13, STPCardBrandVisa},
+    {6, 492960, 492960, 13, STPCardBrandVisa},
+};
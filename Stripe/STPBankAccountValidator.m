@@ -0,0 +1,279 @@
+//
+//  STPBankAccountValidator.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPBankAccountValidator.h"
+
+/**
+ No country's IBANs are longer than this, so validation can work out of a
+ fixed-size stack buffer.
+ */
+#define STPBankAccountValidatorMaxIBANLength ((NSUInteger)34)
+
+/**
+ Longer than any routing number format below, so anything that doesn't fit is
+ kept just long enough to be rejected.
+ */
+#define STPBankAccountValidatorMaxRoutingNumberLength ((NSUInteger)16)
+
+typedef struct {
+    char country[2];
+    uint8_t length;
+} STPIBANFormat;
+
+/**
+ From the SWIFT IBAN registry. Sorted by country code for `bsearch`.
+ */
+static const STPIBANFormat STPIBANFormats[] = {
+    {{'A', 'D'}, 24}, {{'A', 'E'}, 23}, {{'A', 'L'}, 28}, {{'A', 'T'}, 20},
+    {{'A', 'Z'}, 28}, {{'B', 'A'}, 20}, {{'B', 'E'}, 16}, {{'B', 'G'}, 22},
+    {{'B', 'H'}, 22}, {{'B', 'R'}, 29}, {{'B', 'Y'}, 28}, {{'C', 'H'}, 21},
+    {{'C', 'R'}, 22}, {{'C', 'Y'}, 28}, {{'C', 'Z'}, 24}, {{'D', 'E'}, 22},
+    {{'D', 'K'}, 18}, {{'D', 'O'}, 28}, {{'E', 'E'}, 20}, {{'E', 'G'}, 29},
+    {{'E', 'S'}, 24}, {{'F', 'I'}, 18}, {{'F', 'O'}, 18}, {{'F', 'R'}, 27},
+    {{'G', 'B'}, 22}, {{'G', 'E'}, 22}, {{'G', 'I'}, 23}, {{'G', 'L'}, 18},
+    {{'G', 'R'}, 27}, {{'G', 'T'}, 28}, {{'H', 'R'}, 21}, {{'H', 'U'}, 28},
+    {{'I', 'E'}, 22}, {{'I', 'L'}, 23}, {{'I', 'Q'}, 23}, {{'I', 'S'}, 26},
+    {{'I', 'T'}, 27}, {{'J', 'O'}, 30}, {{'K', 'W'}, 30}, {{'K', 'Z'}, 20},
+    {{'L', 'B'}, 28}, {{'L', 'C'}, 32}, {{'L', 'I'}, 21}, {{'L', 'T'}, 20},
+    {{'L', 'U'}, 20}, {{'L', 'V'}, 21}, {{'L', 'Y'}, 25}, {{'M', 'C'}, 27},
+    {{'M', 'D'}, 24}, {{'M', 'E'}, 22}, {{'M', 'K'}, 19}, {{'M', 'R'}, 27},
+    {{'M', 'T'}, 31}, {{'M', 'U'}, 30}, {{'N', 'L'}, 18}, {{'N', 'O'}, 15},
+    {{'P', 'K'}, 24}, {{'P', 'L'}, 28}, {{'P', 'S'}, 29}, {{'P', 'T'}, 25},
+    {{'Q', 'A'}, 29}, {{'R', 'O'}, 24}, {{'R', 'S'}, 22}, {{'S', 'A'}, 24},
+    {{'S', 'C'}, 31}, {{'S', 'D'}, 18}, {{'S', 'E'}, 24}, {{'S', 'I'}, 19},
+    {{'S', 'K'}, 24}, {{'S', 'M'}, 27}, {{'S', 'T'}, 25}, {{'S', 'V'}, 28},
+    {{'T', 'L'}, 23}, {{'T', 'N'}, 24}, {{'T', 'R'}, 26}, {{'U', 'A'}, 29},
+    {{'V', 'A'}, 22}, {{'V', 'G'}, 24}, {{'X', 'K'}, 20},
+};
+
+typedef struct {
+    char country[2];
+    uint8_t length;
+    BOOL checksummed;
+} STPRoutingNumberFormat;
+
+static const STPRoutingNumberFormat STPRoutingNumberFormats[] = {
+    // BSB numbers
+    {{'A', 'U'}, 6, NO},
+    // Sort codes
+    {{'G', 'B'}, 6, NO},
+    // ABA routing numbers
+    {{'U', 'S'}, 9, YES},
+};
+
+static inline BOOL STPBankAccountValidatorCharacterIsDigit(unichar c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline BOOL STPBankAccountValidatorCharacterIsLetter(unichar c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+static inline unichar STPBankAccountValidatorUppercase(unichar c) {
+    return (c >= 'a' && c <= 'z') ? (unichar)(c - 'a' + 'A') : c;
+}
+
+static int STPBankAccountValidatorCompareCountries(const void *key, const void *element) {
+    const char *a = key;
+    const char *b = element;
+    return a[0] != b[0] ? a[0] - b[0] : a[1] - b[1];
+}
+
+/**
+ Reads the two-letter code in `country`, uppercased, into `code`. Returns NO
+ for anything that isn't two ASCII letters.
+ */
+static BOOL STPBankAccountValidatorCountryCode(NSString *country, char code[2]) {
+    if (country.length != 2) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < 2; i++) {
+        unichar c = STPBankAccountValidatorUppercase([country characterAtIndex:i]);
+        if (!STPBankAccountValidatorCharacterIsLetter(c)) {
+            return NO;
+        }
+        code[i] = (char)c;
+    }
+    return YES;
+}
+
+static const STPIBANFormat *STPIBANFormatForCountryCode(const char code[2]) {
+    return bsearch(code, STPIBANFormats, sizeof(STPIBANFormats) / sizeof(STPIBANFormats[0]), sizeof(STPIBANFormat), STPBankAccountValidatorCompareCountries);
+}
+
+/**
+ Copies `string` to `buffer` without the characters `skip` returns YES for,
+ uppercasing ASCII letters. Returns how many characters were kept, which is
+ `capacity + 1` if they didn't all fit.
+ */
+static NSUInteger STPBankAccountValidatorCopyCharacters(NSString *string, unichar *buffer, NSUInteger capacity, BOOL (*skip)(unichar)) {
+    if (!string) {
+        return 0;
+    }
+    CFStringInlineBuffer inlineBuffer;
+    CFIndex length = CFStringGetLength((__bridge CFStringRef)string);
+    CFStringInitInlineBuffer((__bridge CFStringRef)string, &inlineBuffer, CFRangeMake(0, length));
+    NSUInteger count = 0;
+    for (CFIndex i = 0; i < length; i++) {
+        unichar c = CFStringGetCharacterFromInlineBuffer(&inlineBuffer, i);
+        if (skip(c)) {
+            continue;
+        }
+        if (count == capacity) {
+            return capacity + 1;
+        }
+        buffer[count++] = STPBankAccountValidatorUppercase(c);
+    }
+    return count;
+}
+
+static BOOL STPBankAccountValidatorIsIBANSeparator(unichar c) {
+    return c == ' ' || c == '\t' || c == 0x00A0;
+}
+
+static BOOL STPBankAccountValidatorIsRoutingNumberSeparator(unichar c) {
+    return STPBankAccountValidatorIsIBANSeparator(c) || c == '-';
+}
+
+/**
+ The IBAN's remainder mod 97, computed as if its first four characters were
+ moved to the end and each letter replaced by its two-digit value (A = 10),
+ one character at a time so the huge number is never built.
+ */
+static NSUInteger STPIBANRemainder(const unichar *characters, NSUInteger length) {
+    NSUInteger remainder = 0;
+    for (NSUInteger n = 0; n < length; n++) {
+        unichar c = characters[(n + 4) % length];
+        if (STPBankAccountValidatorCharacterIsDigit(c)) {
+            remainder = (remainder * 10 + (NSUInteger)(c - '0')) % 97;
+        } else {
+            remainder = (remainder * 100 + (NSUInteger)(c - 'A' + 10)) % 97;
+        }
+    }
+    return remainder;
+}
+
+/**
+ The first two digits of an ABA routing number identify a Federal Reserve
+ district (01-12), a thrift institution (21-32), an electronic transaction
+ (61-72) or a traveler's cheque (80); 00 is reserved for the government.
+ */
+static BOOL STPABAPrefixIsValid(const unichar *digits, NSUInteger length) {
+    if (length == 0) {
+        return YES;
+    }
+    NSUInteger first = (NSUInteger)(digits[0] - '0');
+    if (length == 1) {
+        return first <= 3 || first == 6 || first == 7 || first == 8;
+    }
+    NSUInteger prefix = first * 10 + (NSUInteger)(digits[1] - '0');
+    return prefix <= 12 || (prefix >= 21 && prefix <= 32) || (prefix >= 61 && prefix <= 72) || prefix == 80;
+}
+
+static BOOL STPABAChecksumIsValid(const unichar *digits) {
+    static const NSUInteger weights[] = {3, 7, 1, 3, 7, 1, 3, 7, 1};
+    NSUInteger sum = 0;
+    for (NSUInteger i = 0; i < 9; i++) {
+        sum += weights[i] * (NSUInteger)(digits[i] - '0');
+    }
+    return sum % 10 == 0;
+}
+
+@implementation STPBankAccountValidator
+
++ (STPCardValidationState)validationStateForRoutingNumber:(NSString *)routingNumber
+                                                  country:(NSString *)country {
+    unichar digits[STPBankAccountValidatorMaxRoutingNumberLength];
+    NSUInteger length = STPBankAccountValidatorCopyCharacters(routingNumber, digits, STPBankAccountValidatorMaxRoutingNumberLength, STPBankAccountValidatorIsRoutingNumberSeparator);
+    if (length == 0) {
+        return STPCardValidationStateIncomplete;
+    }
+
+    const STPRoutingNumberFormat *format = NULL;
+    char code[2];
+    if (STPBankAccountValidatorCountryCode(country, code)) {
+        for (size_t i = 0; i < sizeof(STPRoutingNumberFormats) / sizeof(STPRoutingNumberFormats[0]); i++) {
+            if (STPBankAccountValidatorCompareCountries(code, STPRoutingNumberFormats[i].country) == 0) {
+                format = &STPRoutingNumberFormats[i];
+                break;
+            }
+        }
+    }
+    if (!format) {
+        return STPCardValidationStateValid;
+    }
+
+    if (length > format->length) {
+        return STPCardValidationStateInvalid;
+    }
+    for (NSUInteger i = 0; i < length; i++) {
+        if (!STPBankAccountValidatorCharacterIsDigit(digits[i])) {
+            return STPCardValidationStateInvalid;
+        }
+    }
+    if (format->checksummed && !STPABAPrefixIsValid(digits, length)) {
+        return STPCardValidationStateInvalid;
+    }
+    if (length < format->length) {
+        return STPCardValidationStateIncomplete;
+    }
+    if (format->checksummed && !STPABAChecksumIsValid(digits)) {
+        return STPCardValidationStateInvalid;
+    }
+    return STPCardValidationStateValid;
+}
+
++ (STPCardValidationState)validationStateForIBAN:(NSString *)iban {
+    unichar characters[STPBankAccountValidatorMaxIBANLength];
+    NSUInteger length = STPBankAccountValidatorCopyCharacters(iban, characters, STPBankAccountValidatorMaxIBANLength, STPBankAccountValidatorIsIBANSeparator);
+    if (length > STPBankAccountValidatorMaxIBANLength) {
+        return STPCardValidationStateInvalid;
+    }
+
+    // Country code, then check digits, then the alphanumeric account number
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar c = characters[i];
+        BOOL valid = (i < 2) ? STPBankAccountValidatorCharacterIsLetter(c)
+            : (i < 4) ? STPBankAccountValidatorCharacterIsDigit(c)
+            : (STPBankAccountValidatorCharacterIsLetter(c) || STPBankAccountValidatorCharacterIsDigit(c));
+        if (!valid) {
+            return STPCardValidationStateInvalid;
+        }
+    }
+    if (length < 2) {
+        return STPCardValidationStateIncomplete;
+    }
+
+    char code[2] = {(char)characters[0], (char)characters[1]};
+    const STPIBANFormat *format = STPIBANFormatForCountryCode(code);
+    if (!format || length > format->length) {
+        return STPCardValidationStateInvalid;
+    }
+    if (length >= 4) {
+        // 00, 01 and 99 can't come out of the check digit calculation
+        NSUInteger checkDigits = (NSUInteger)(characters[2] - '0') * 10 + (NSUInteger)(characters[3] - '0');
+        if (checkDigits < 2 || checkDigits > 98) {
+            return STPCardValidationStateInvalid;
+        }
+    }
+    if (length < format->length) {
+        return STPCardValidationStateIncomplete;
+    }
+    return STPIBANRemainder(characters, length) == 1 ? STPCardValidationStateValid : STPCardValidationStateInvalid;
+}
+
++ (NSUInteger)lengthOfIBANForCountry:(NSString *)country {
+    char code[2];
+    if (!STPBankAccountValidatorCountryCode(country, code)) {
+        return 0;
+    }
+    const STPIBANFormat *format = STPIBANFormatForCountryCode(code);
+    return format ? format->length : 0;
+}
+
+@end
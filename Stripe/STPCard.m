@@ -24,7 +24,11 @@
 
 @end
 
-@implementation STPCard
+@implementation STPCard {
+    // Cards are compared by identifier, which is only set while decoding, so
+    // the hash is worked out once then.
+    NSUInteger _hash;
+}
 
 @dynamic number, cvc, expMonth, expYear, currency, name, address, addressLine1, addressLine2, addressCity, addressState, addressZip, addressCountry;
 
@@ -37,6 +41,7 @@
     self = [super init];
     if (self) {
         _cardId = stripeID;
+        _hash = [stripeID hash];
         _brand = brand;
         _last4 = last4;
         self.expMonth = expMonth;
@@ -47,22 +52,20 @@
 }
 
 + (STPCardBrand)brandFromString:(NSString *)string {
-    NSString *brand = [string lowercaseString];
-    if ([brand isEqualToString:@"visa"]) {
-        return STPCardBrandVisa;
-    } else if ([brand isEqualToString:@"american express"]) {
-        return STPCardBrandAmex;
-    } else if ([brand isEqualToString:@"mastercard"]) {
-        return STPCardBrandMasterCard;
-    } else if ([brand isEqualToString:@"discover"]) {
-        return STPCardBrandDiscover;
-    } else if ([brand isEqualToString:@"jcb"]) {
-        return STPCardBrandJCB;
-    } else if ([brand isEqualToString:@"diners club"]) {
-        return STPCardBrandDinersClub;
-    } else {
-        return STPCardBrandUnknown;
-    }
+    static NSDictionary<NSString *, NSNumber *> *stringToBrand;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToBrand = @{
+                          @"visa": @(STPCardBrandVisa),
+                          @"american express": @(STPCardBrandAmex),
+                          @"mastercard": @(STPCardBrandMasterCard),
+                          @"discover": @(STPCardBrandDiscover),
+                          @"jcb": @(STPCardBrandJCB),
+                          @"diners club": @(STPCardBrandDinersClub),
+                          };
+    });
+    NSNumber *brand = [stringToBrand stp_objectForLowercaseKeyMatchingString:string];
+    return brand ? (STPCardBrand)[brand integerValue] : STPCardBrandUnknown;
 }
 
 + (NSString *)stringFromBrand:(STPCardBrand)brand {
@@ -85,16 +88,17 @@
 }
 
 + (STPCardFundingType)fundingFromString:(NSString *)string {
-    NSString *funding = [string lowercaseString];
-    if ([funding isEqualToString:@"credit"]) {
-        return STPCardFundingTypeCredit;
-    } else if ([funding isEqualToString:@"debit"]) {
-        return STPCardFundingTypeDebit;
-    } else if ([funding isEqualToString:@"prepaid"]) {
-        return STPCardFundingTypePrepaid;
-    } else {
-        return STPCardFundingTypeOther;
-    }
+    static NSDictionary<NSString *, NSNumber *> *stringToFunding;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToFunding = @{
+                            @"credit": @(STPCardFundingTypeCredit),
+                            @"debit": @(STPCardFundingTypeDebit),
+                            @"prepaid": @(STPCardFundingTypePrepaid),
+                            };
+    });
+    NSNumber *funding = [stringToFunding stp_objectForLowercaseKeyMatchingString:string];
+    return funding ? (STPCardFundingType)[funding integerValue] : STPCardFundingTypeOther;
 }
 
 - (instancetype)init {
@@ -120,7 +124,12 @@
 }
 
 - (NSUInteger)hash {
-    return [self.cardId hash];
+    return _hash;
+}
+
+- (void)setCardId:(NSString *)cardId {
+    _cardId = cardId;
+    _hash = [cardId hash];
 }
 
 - (BOOL)isEqualToCard:(STPCard *)other {
@@ -131,7 +140,11 @@
     if (!other || ![other isKindOfClass:self.class]) {
         return NO;
     }
-    
+
+    // Identifiers share a long prefix, so unequal ones are ruled out by hash
+    if (_hash != other->_hash) {
+        return NO;
+    }
     return [self.cardId isEqualToString:other.cardId];
 }
 
@@ -152,7 +165,12 @@
 
 #pragma mark STPAPIResponseDecodable
 + (NSArray *)requiredFields {
-    return @[@"id", @"last4", @"brand", @"exp_month", @"exp_year"];
+    static NSArray *requiredFields;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        requiredFields = @[@"id", @"last4", @"brand", @"exp_month", @"exp_year"];
+    });
+    return requiredFields;
 }
 
 + (instancetype)decodedObjectFromAPIResponse:(NSDictionary *)response {
@@ -166,8 +184,7 @@
     card.name = dict[@"name"];
     card.last4 = dict[@"last4"];
     card.dynamicLast4 = dict[@"dynamic_last4"];
-    NSString *brand = [dict[@"brand"] lowercaseString];
-    card.brand = [self.class brandFromString:brand];
+    card.brand = [self.class brandFromString:dict[@"brand"]];
     NSString *funding = dict[@"funding"];
     card.funding = [self.class fundingFromString:funding];
     card.country = dict[@"country"];
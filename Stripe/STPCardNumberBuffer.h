@@ -0,0 +1,70 @@
+//
+//  STPCardNumberBuffer.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPCardNumberDigits.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Holds a card number being entered or sent as digit values in a fixed-size
+ buffer, which is overwritten with zeros when it's cleared and when the buffer
+ is deallocated. The card field's view model, the validator and the form
+ encoder all read the digits from here, so the number only becomes an
+ NSString where UIKit or the public API needs one.
+ */
+@interface STPCardNumberBuffer : NSObject <NSCopying>
+
+/**
+ Reads the digits of `string`, ignoring everything else, and keeps the first
+ `STPCardNumberMaxDigits` of them.
+ */
+- (instancetype)initWithString:(nullable NSString *)string;
+
+/**
+ Replaces the number with the digits of `string`, as `initWithString:` does.
+ */
+- (void)setString:(nullable NSString *)string;
+
+/**
+ Drops every digit past `length`. The dropped digits are zeroed.
+ */
+- (void)truncateToLength:(NSUInteger)length;
+
+/**
+ Zeroes the number.
+ */
+- (void)clear;
+
+@property (nonatomic, readonly) NSUInteger length;
+
+/**
+ The digits themselves. Valid until the buffer is next changed.
+ */
+@property (nonatomic, readonly) const STPCardNumberDigits *digits;
+
+/**
+ See `STPCardNumberDigitsBrand`.
+ */
+@property (nonatomic, readonly) STPCardBrand brand;
+
+/**
+ A new string of the digits. Each call makes another copy that can't be
+ zeroed, so it's only for UIKit and the public API.
+ */
+- (NSString *)stringValue;
+
+/**
+ Appends the digits to `data` as ASCII, which needs no form escaping.
+ */
+- (void)appendToData:(NSMutableData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
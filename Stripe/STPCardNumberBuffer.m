@@ -0,0 +1,83 @@
+//
+//  STPCardNumberBuffer.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCardNumberBuffer.h"
+
+@implementation STPCardNumberBuffer {
+    STPCardNumberDigits _digits;
+}
+
+- (instancetype)init {
+    return [self initWithString:nil];
+}
+
+- (instancetype)initWithString:(NSString *)string {
+    self = [super init];
+    if (self) {
+        [self setString:string];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    STPCardNumberDigitsClear(&_digits);
+}
+
+- (id)copyWithZone:(__unused NSZone *)zone {
+    STPCardNumberBuffer *copy = [[self class] new];
+    copy->_digits = _digits;
+    return copy;
+}
+
+- (void)setString:(NSString *)string {
+    STPCardNumberDigitsClear(&_digits);
+    STPCardNumberDigitsRead(string, YES, &_digits);
+}
+
+- (void)truncateToLength:(NSUInteger)length {
+    while (_digits.count > length) {
+        _digits.values[--_digits.count] = 0;
+    }
+}
+
+- (void)clear {
+    STPCardNumberDigitsClear(&_digits);
+}
+
+- (NSUInteger)length {
+    return _digits.count;
+}
+
+- (const STPCardNumberDigits *)digits {
+    return &_digits;
+}
+
+- (STPCardBrand)brand {
+    return STPCardNumberDigitsBrand(&_digits);
+}
+
+- (NSString *)stringValue {
+    unichar characters[STPCardNumberMaxDigits];
+    for (NSUInteger i = 0; i < _digits.count; i++) {
+        characters[i] = (unichar)('0' + _digits.values[i]);
+    }
+    NSString *string = [[NSString alloc] initWithCharacters:characters length:_digits.count];
+    STPCardNumberZero(characters, sizeof(characters));
+    return string;
+}
+
+- (void)appendToData:(NSMutableData *)data {
+    char characters[STPCardNumberMaxDigits];
+    for (NSUInteger i = 0; i < _digits.count; i++) {
+        characters[i] = (char)('0' + _digits.values[i]);
+    }
+    [data appendBytes:characters length:_digits.count];
+    STPCardNumberZero(characters, sizeof(characters));
+}
+
+@end
@@ -0,0 +1,90 @@
+//
+//  STPCardNumberDigits.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPCardBrand.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ No card brand issues numbers longer than this.
+ */
+#define STPCardNumberMaxDigits ((NSUInteger)19)
+
+/**
+ The longest formatted card number: every digit, plus a space between each
+ group.
+ */
+#define STPCardNumberMaxFormattedLength (STPCardNumberMaxDigits + 3)
+
+/**
+ A card number held as digit values (0 to 9) rather than characters. It fits
+ on the stack, so checking, identifying and formatting a number needs no
+ allocations once it's been read.
+ */
+typedef struct {
+    uint8_t values[STPCardNumberMaxDigits];
+    NSUInteger count;
+} STPCardNumberDigits;
+
+typedef NS_ENUM(NSInteger, STPCardNumberDigitsReadResult) {
+    STPCardNumberDigitsReadResultOK,
+    // Something other than a digit or whitespace, unless those are ignored
+    STPCardNumberDigitsReadResultInvalidCharacter,
+    // More than STPCardNumberMaxDigits digits. The first ones are kept.
+    STPCardNumberDigitsReadResultTooLong,
+};
+
+/**
+ Reads the digits of `string` into `digits` in one pass. Whitespace is always
+ skipped; other non-digits stop the read unless `ignoringNonDigits` is YES.
+ */
+STPCardNumberDigitsReadResult STPCardNumberDigitsRead(NSString * _Nullable string, BOOL ignoringNonDigits, STPCardNumberDigits *digits);
+
+/**
+ Overwrites `length` bytes at `bytes` with zeros, in a way the compiler
+ can't optimise away when the memory isn't read again.
+ */
+void STPCardNumberZero(void *bytes, size_t length);
+
+/**
+ Zeroes every digit, then the count.
+ */
+void STPCardNumberDigitsClear(STPCardNumberDigits *digits);
+
+/**
+ Luhn checksum, walking left to right and using the distance from the last
+ digit to decide which digits get doubled, so the number is never reversed.
+ */
+BOOL STPCardNumberDigitsAreValidLuhn(const STPCardNumberDigits *digits);
+
+/**
+ The one brand whose ranges match the number's leading digits, or
+ STPCardBrandUnknown if there are several or none. Partial numbers match the
+ ranges they could still fall into.
+ */
+STPCardBrand STPCardNumberDigitsBrand(const STPCardNumberDigits *digits);
+
+/**
+ The indexes of the digits that `brand`'s formatted numbers put a space
+ after, e.g. 3, 9 for American Express's 4-6-5 grouping.
+
+ @return The number of indexes in `*indexes`.
+ */
+NSUInteger STPCardNumberGroupEndIndexes(STPCardBrand brand, const NSUInteger * _Nonnull * _Nonnull indexes);
+
+/**
+ Writes the number grouped with spaces for `brand` to `characters`, which
+ must have room for `STPCardNumberMaxFormattedLength` characters.
+
+ @return The number of characters written.
+ */
+NSUInteger STPCardNumberDigitsFormat(const STPCardNumberDigits *digits, STPCardBrand brand, unichar *characters);
+
+NS_ASSUME_NONNULL_END
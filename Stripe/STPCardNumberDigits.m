@@ -0,0 +1,108 @@
+//
+//  STPCardNumberDigits.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCardNumberDigits.h"
+
+#import "STPBINRange.h"
+
+/**
+ How many characters are copied out of an NSString at a time.
+ */
+#define STPCardNumberDigitsChunkLength ((NSUInteger)32)
+
+static BOOL STPCardNumberCharacterIsWhitespace(unichar c) {
+    if (c == ' ' || c == '\t') {
+        return YES;
+    }
+    if (c < 0x80) {
+        return NO;
+    }
+    return [[NSCharacterSet whitespaceCharacterSet] characterIsMember:c];
+}
+
+STPCardNumberDigitsReadResult STPCardNumberDigitsRead(NSString *string, BOOL ignoringNonDigits, STPCardNumberDigits *digits) {
+    digits->count = 0;
+    NSUInteger length = string.length;
+    unichar chunk[STPCardNumberDigitsChunkLength];
+    for (NSUInteger location = 0; location < length; location += STPCardNumberDigitsChunkLength) {
+        NSUInteger chunkLength = MIN(STPCardNumberDigitsChunkLength, length - location);
+        [string getCharacters:chunk range:NSMakeRange(location, chunkLength)];
+        for (NSUInteger i = 0; i < chunkLength; i++) {
+            unichar c = chunk[i];
+            if (c >= '0' && c <= '9') {
+                if (digits->count == STPCardNumberMaxDigits) {
+                    return STPCardNumberDigitsReadResultTooLong;
+                }
+                digits->values[digits->count++] = (uint8_t)(c - '0');
+            } else if (!ignoringNonDigits && !STPCardNumberCharacterIsWhitespace(c)) {
+                return STPCardNumberDigitsReadResultInvalidCharacter;
+            }
+        }
+    }
+    return STPCardNumberDigitsReadResultOK;
+}
+
+void STPCardNumberZero(void *bytes, size_t length) {
+    volatile uint8_t *volatileBytes = bytes;
+    for (size_t i = 0; i < length; i++) {
+        volatileBytes[i] = 0;
+    }
+}
+
+void STPCardNumberDigitsClear(STPCardNumberDigits *digits) {
+    STPCardNumberZero(digits, sizeof(*digits));
+}
+
+BOOL STPCardNumberDigitsAreValidLuhn(const STPCardNumberDigits *digits) {
+    NSUInteger sum = 0;
+    NSUInteger count = digits->count;
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger digit = digits->values[i];
+        if ((count - i) % 2 == 0) {
+            digit *= 2;
+            if (digit > 9) {
+                digit -= 9;
+            }
+        }
+        sum += digit;
+    }
+    return sum % 10 == 0;
+}
+
+STPCardBrand STPCardNumberDigitsBrand(const STPCardNumberDigits *digits) {
+    return [STPBINRange brandForDigits:digits->values length:digits->count];
+}
+
+NSUInteger STPCardNumberGroupEndIndexes(STPCardBrand brand, const NSUInteger **indexes) {
+    static const NSUInteger amexIndexes[] = {3, 9};
+    static const NSUInteger defaultIndexes[] = {3, 7, 11};
+    if (brand == STPCardBrandAmex) {
+        *indexes = amexIndexes;
+        return sizeof(amexIndexes) / sizeof(amexIndexes[0]);
+    }
+    *indexes = defaultIndexes;
+    return sizeof(defaultIndexes) / sizeof(defaultIndexes[0]);
+}
+
+NSUInteger STPCardNumberDigitsFormat(const STPCardNumberDigits *digits, STPCardBrand brand, unichar *characters) {
+    const NSUInteger *groupEnds;
+    NSUInteger groupCount = STPCardNumberGroupEndIndexes(brand, &groupEnds);
+    NSUInteger length = 0;
+    NSUInteger group = 0;
+    for (NSUInteger i = 0; i < digits->count; i++) {
+        characters[length++] = (unichar)('0' + digits->values[i]);
+        if (group < groupCount && i == groupEnds[group]) {
+            group++;
+            // No trailing space after a number that ends on a group
+            if (i + 1 < digits->count) {
+                characters[length++] = ' ';
+            }
+        }
+    }
+    return length;
+}
@@ -0,0 +1,146 @@
+//
+//  STPCardNumberSession.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCardNumberSession.h"
+
+#import "STPBINRange.h"
+#import "STPCardValidator.h"
+
+@interface STPCardNumberSession()
+
+@property (nonatomic) NSMutableString *digits;
+/**
+ `candidates[i]` holds the indexes of the BIN ranges that match the first `i`
+ digits, for i up to `STPBINRangeMaxPrefixLength`. Deleting a digit just
+ drops the last entry.
+ */
+@property (nonatomic) NSMutableArray<NSIndexSet *> *candidates;
+// The candidates `possibleBrands` was computed from.
+@property (nonatomic) NSIndexSet *brandCandidates;
+@property (nonatomic, copy, readwrite) NSSet<NSNumber *> *possibleBrands;
+@property (nonatomic, readwrite) STPCardBrand brand;
+@property (nonatomic, readwrite) NSInteger maxLength;
+@property (nonatomic, readwrite) STPCardValidationState validationState;
+
+@end
+
+@implementation STPCardNumberSession
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _digits = [NSMutableString string];
+        NSIndexSet *allIndexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, [STPBINRange allRanges].count)];
+        _candidates = [NSMutableArray arrayWithObject:allIndexes];
+        _brandCandidates = allIndexes;
+        _possibleBrands = [self.class brandsForCandidates:allIndexes];
+        _brand = [self.class brandForPossibleBrands:_possibleBrands];
+        _maxLength = [STPCardValidator maxLengthForCardBrand:_brand];
+        _validationState = [STPCardValidator validationStateForNumber:_digits validatingCardBrand:YES];
+    }
+    return self;
+}
+
+- (NSString *)number {
+    return [self.digits copy];
+}
+
+- (void)appendDigits:(NSString *)digits {
+    [self appendDigitsWithoutNotifying:digits];
+    [self updateDerivedState];
+}
+
+- (void)deleteDigits:(NSUInteger)count {
+    [self deleteDigitsWithoutNotifying:count];
+    [self updateDerivedState];
+}
+
+- (void)setNumber:(NSString *)number {
+    // Keep the lookups for whatever leading digits the two numbers share.
+    NSString *sanitized = [STPCardValidator sanitizedNumericStringForString:number] ?: @"";
+    NSString *commonPrefix = [sanitized commonPrefixWithString:self.digits options:NSLiteralSearch];
+    [self deleteDigitsWithoutNotifying:self.digits.length - commonPrefix.length];
+    [self appendDigitsWithoutNotifying:[sanitized substringFromIndex:commonPrefix.length]];
+    [self updateDerivedState];
+}
+
+- (void)appendDigitsWithoutNotifying:(NSString *)digits {
+    for (NSUInteger i = 0; i < digits.length; i++) {
+        unichar c = [digits characterAtIndex:i];
+        if (c < '0' || c > '9') {
+            continue;
+        }
+        [self.digits appendFormat:@"%C", c];
+        NSUInteger length = self.digits.length;
+        if (length <= STPBINRangeMaxPrefixLength) {
+            unichar characters[STPBINRangeMaxPrefixLength];
+            [self.digits getCharacters:characters range:NSMakeRange(0, length)];
+            [self.candidates addObject:[STPBINRange indexesOfRanges:self.candidates.lastObject
+                                                 matchingCharacters:characters
+                                                             length:length]];
+        }
+    }
+}
+
+- (void)deleteDigitsWithoutNotifying:(NSUInteger)count {
+    NSUInteger length = self.digits.length;
+    count = MIN(count, length);
+    [self.digits deleteCharactersInRange:NSMakeRange(length - count, count)];
+    NSUInteger candidateCount = MIN(self.digits.length, STPBINRangeMaxPrefixLength) + 1;
+    if (self.candidates.count > candidateCount) {
+        [self.candidates removeObjectsInRange:NSMakeRange(candidateCount, self.candidates.count - candidateCount)];
+    }
+}
+
+- (void)updateDerivedState {
+    BOOL brandsChanged = NO;
+    NSIndexSet *candidates = self.candidates.lastObject;
+    // Past the BIN prefix the candidates never change, so neither do the brands.
+    if (![candidates isEqualToIndexSet:self.brandCandidates]) {
+        self.brandCandidates = candidates;
+        NSSet<NSNumber *> *possibleBrands = [self.class brandsForCandidates:candidates];
+        if (![possibleBrands isEqualToSet:self.possibleBrands]) {
+            brandsChanged = YES;
+            self.possibleBrands = possibleBrands;
+            self.brand = [self.class brandForPossibleBrands:possibleBrands];
+            self.maxLength = [STPCardValidator maxLengthForCardBrand:self.brand];
+        }
+    }
+    STPCardValidationState validationState = [STPCardValidator validationStateForNumber:self.digits validatingCardBrand:YES];
+    BOOL validationStateChanged = validationState != self.validationState;
+    self.validationState = validationState;
+
+    id<STPCardNumberSessionDelegate> delegate = self.delegate;
+    if (brandsChanged && [delegate respondsToSelector:@selector(cardNumberSessionDidChangeBrand:)]) {
+        [delegate cardNumberSessionDidChangeBrand:self];
+    }
+    if (validationStateChanged && [delegate respondsToSelector:@selector(cardNumberSessionDidChangeValidationState:)]) {
+        [delegate cardNumberSessionDidChangeValidationState:self];
+    }
+}
+
++ (NSSet<NSNumber *> *)brandsForCandidates:(NSIndexSet *)candidates {
+    NSArray<STPBINRange *> *allRanges = [STPBINRange allRanges];
+    NSMutableSet<NSNumber *> *brands = [NSMutableSet set];
+    [candidates enumerateIndexesUsingBlock:^(NSUInteger index, __unused BOOL *stop) {
+        STPCardBrand brand = allRanges[index].brand;
+        if (brand != STPCardBrandUnknown) {
+            [brands addObject:@(brand)];
+        }
+    }];
+    return [brands copy];
+}
+
++ (STPCardBrand)brandForPossibleBrands:(NSSet<NSNumber *> *)possibleBrands {
+    if (possibleBrands.count == 1) {
+        return (STPCardBrand)[possibleBrands.anyObject integerValue];
+    }
+    return STPCardBrandUnknown;
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  STPCardParams+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCardParams.h"
+
+#import "STPCardNumberBuffer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface STPCardParams ()
+
+/**
+ Holds the number for card params filled in by the SDK's own card field, and
+ is what's form encoded, so the digits go into the request body without
+ passing through another string. Setting `number` clears it.
+ */
+@property (nonatomic, copy, nullable) STPCardNumberBuffer *numberBuffer;
+
+/**
+ New params with only this card's number, expiration date and CVC.
+ */
+- (STPCardParams *)cardDetailsParams;
+
+/**
+ A SHA-256 of the form-encoded params, so two sets of params can be compared
+ without keeping another copy of the card. The encoded body is zeroed
+ afterwards.
+ */
+- (NSData *)formEncodedFingerprint;
+
+@end
+
+NS_ASSUME_NONNULL_END
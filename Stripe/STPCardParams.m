@@ -7,13 +7,17 @@
 //
 
 #import "STPCardParams.h"
+#import "STPCardParams+Private.h"
 
+#import <CommonCrypto/CommonCrypto.h>
 #import "STPCardValidator.h"
+#import "STPFormEncoder.h"
 #import "StripeError.h"
 
 @implementation STPCardParams
 
 @synthesize additionalAPIParameters = _additionalAPIParameters;
+@synthesize number = _number;
 
 - (instancetype)init {
     self = [super init];
@@ -23,14 +27,61 @@
     return self;
 }
 
+- (NSString *)number {
+    return _number ?: [self.numberBuffer stringValue];
+}
+
+- (void)setNumber:(NSString *)number {
+    _number = [number copy];
+    [_numberBuffer clear];
+    _numberBuffer = nil;
+}
+
+- (void)setNumberBuffer:(STPCardNumberBuffer *)numberBuffer {
+    [_numberBuffer clear];
+    _numberBuffer = [numberBuffer copy];
+    _number = nil;
+}
+
+- (STPCardParams *)cardDetailsParams {
+    STPCardParams *cardDetails = [STPCardParams new];
+    if (self.numberBuffer) {
+        cardDetails.numberBuffer = self.numberBuffer;
+    } else {
+        cardDetails.number = self.number;
+    }
+    cardDetails.expMonth = self.expMonth;
+    cardDetails.expYear = self.expYear;
+    cardDetails.cvc = self.cvc;
+    return cardDetails;
+}
+
+- (NSData *)formEncodedFingerprint {
+    NSMutableData *body = [NSMutableData data];
+    [STPFormEncoder appendFormDataFromParameters:[STPFormEncoder dictionaryForObject:self] toData:body];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(body.bytes, (CC_LONG)body.length, digest);
+    [body resetBytesInRange:NSMakeRange(0, body.length)];
+    return [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
+}
+
 - (NSString *)last4 {
-    if (self.number && self.number.length >= 4) {
-        return [self.number substringFromIndex:(self.number.length - 4)];
+    NSString *number = self.number;
+    if (number && number.length >= 4) {
+        return [number substringFromIndex:(number.length - 4)];
     } else {
         return nil;
     }
 }
 
+/**
+ What's encoded as `number`: the buffer when there is one, so the encoder can
+ write its digits directly.
+ */
+- (id)formEncodedNumber {
+    return self.numberBuffer ?: self.number;
+}
+
 - (STPAddress *)address {
     STPAddress *address = [STPAddress new];
     address.name = self.name;
@@ -61,7 +112,7 @@
 
 + (NSDictionary *)propertyNamesToFormFieldNamesMapping {
     return @{
-             @"number": @"number",
+             @"formEncodedNumber": @"number",
              @"cvc": @"cvc",
              @"name": @"name",
              @"addressLine1": @"address_line1",
@@ -10,13 +10,20 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class STPCard;
+@class STPCard, STPCustomer;
 
 @interface STPCardTuple : NSObject
 
 + (instancetype)tupleWithSelectedCard:(nullable STPCard *)selectedCard
                                 cards:(nullable NSArray<STPCard *>*)cards;
 
+/**
+ The customer's cards, with its default source selected if that's one of them.
+ */
++ (instancetype)tupleWithCustomer:(STPCustomer *)customer;
+
+- (BOOL)isEqualToCardTuple:(STPCardTuple *)other;
+
 @property(nonatomic, readonly, nullable)STPCard *selectedCard;
 @property(nonatomic, readonly)NSArray<STPCard *> *cards;
 
@@ -8,6 +8,9 @@
 
 #import "STPCardTuple.h"
 
+#import "STPCard.h"
+#import "STPCustomer.h"
+
 @interface STPCardTuple()
 
 @property(nonatomic, nullable)STPCard *selectedCard;
@@ -25,4 +28,38 @@
     return tuple;
 }
 
++ (instancetype)tupleWithCustomer:(STPCustomer *)customer {
+    // Cards hash their identifiers, so most are ruled out without comparing
+    // strings.
+    NSString *defaultSourceID = customer.defaultSource.stripeID;
+    NSUInteger defaultSourceHash = [defaultSourceID hash];
+    STPCard *selectedCard;
+    NSArray<id<STPSourceProtocol>> *sources = customer.sources;
+    NSMutableArray<STPCard *> *cards = [NSMutableArray arrayWithCapacity:sources.count];
+    Class cardClass = [STPCard class];
+    for (id<STPSourceProtocol> source in sources) {
+        if ([source isKindOfClass:cardClass]) {
+            STPCard *card = (STPCard *)source;
+            [cards addObject:card];
+            if (!selectedCard && card.hash == defaultSourceHash && [card.stripeID isEqualToString:defaultSourceID]) {
+                selectedCard = card;
+            }
+        }
+    }
+    return [self tupleWithSelectedCard:selectedCard cards:cards];
+}
+
+- (BOOL)isEqualToCardTuple:(STPCardTuple *)other {
+    if (self == other) {
+        return YES;
+    }
+    if (!other) {
+        return NO;
+    }
+    if ((self.selectedCard || other.selectedCard) && ![self.selectedCard isEqual:other.selectedCard]) {
+        return NO;
+    }
+    return [self.cards isEqualToArray:other.cards];
+}
+
 @end
@@ -0,0 +1,36 @@
+//
+//  STPCardValidator+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPCardNumberDigits.h"
+#import "STPCardValidator.h"
+
+@class STPValidationClock;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface STPCardValidator ()
+
++ (STPCardValidationState)validationStateForExpirationYear:(NSString *)expirationYear
+                                                   inMonth:(NSString *)expirationMonth
+                                                     clock:(STPValidationClock *)clock;
+
++ (STPCardValidationState)validationStateForCard:(STPCardParams *)card
+                                           clock:(STPValidationClock *)clock;
+
+/**
+ `validationStateForNumber:validatingCardBrand:` for a number that's already
+ been read, e.g. from an `STPCardNumberBuffer`.
+ */
++ (STPCardValidationState)validationStateForCardNumberDigits:(const STPCardNumberDigits *)digits
+                                         validatingCardBrand:(BOOL)validatingCardBrand;
+
+@end
+
+NS_ASSUME_NONNULL_END
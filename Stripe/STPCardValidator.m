@@ -7,12 +7,113 @@
 //
 
 #import "STPCardValidator.h"
+#import "STPCardValidator+Private.h"
+
+#if defined(__aarch64__)
+#import <arm_neon.h>
+#endif
+
 #import "STPBINRange.h"
+#import "STPCardNumberDigits.h"
+#import "STPValidationClock.h"
+
+/**
+ How many characters are copied out of an NSString at a time.
+ */
+#define STPCardValidatorChunkLength ((NSUInteger)32)
+
+/**
+ The input format of each brand that doesn't depend on its BIN ranges.
+ */
+typedef struct {
+    NSUInteger maxCVCLength;
+    // How many digits the last group of a formatted number shows
+    NSInteger fragmentLength;
+} STPCardBrandFormat;
+
+static const STPCardBrandFormat STPCardBrandFormats[] = {
+    [STPCardBrandVisa] = {3, 4},
+    [STPCardBrandAmex] = {4, 5},
+    [STPCardBrandMasterCard] = {3, 4},
+    [STPCardBrandDiscover] = {3, 4},
+    [STPCardBrandJCB] = {3, 4},
+    [STPCardBrandDinersClub] = {3, 2},
+    [STPCardBrandUnknown] = {4, 4},
+};
+
+// For brands this version of the SDK doesn't know about
+static const STPCardBrandFormat STPCardBrandDefaultFormat = {3, 4};
+
+static inline const STPCardBrandFormat *STPCardBrandFormatForBrand(STPCardBrand brand) {
+    if (brand < 0 || (size_t)brand >= sizeof(STPCardBrandFormats) / sizeof(STPCardBrandFormats[0])) {
+        return &STPCardBrandDefaultFormat;
+    }
+    return &STPCardBrandFormats[brand];
+}
+
+/**
+ Copies the ASCII digits in `characters` to `digits`, which must have room for
+ `length` characters, and returns how many there were. Every character is
+ written and the count only advances past digits, so the loop doesn't branch
+ on each character. On arm64 runs of eight are checked at once, and copied
+ whole when they're all digits, as most of a pasted card number is.
+ */
+static NSUInteger STPCardValidatorCopyDigits(const unichar *characters, NSUInteger length, unichar *digits) {
+    NSUInteger count = 0;
+    NSUInteger i = 0;
+#if defined(__aarch64__)
+    const uint16x8_t zero = vdupq_n_u16('0');
+    const uint16x8_t nine = vdupq_n_u16(9);
+    for (; i + 8 <= length; i += 8) {
+        uint16x8_t lane = vld1q_u16(characters + i);
+        // Characters below '0' wrap around to large values
+        uint16x8_t isDigit = vcleq_u16(vsubq_u16(lane, zero), nine);
+        if (vminvq_u16(isDigit) == UINT16_MAX) {
+            vst1q_u16(digits + count, lane);
+            count += 8;
+        } else if (vmaxvq_u16(isDigit) != 0) {
+            for (NSUInteger j = i; j < i + 8; j++) {
+                digits[count] = characters[j];
+                count += (unichar)(characters[j] - '0') <= 9;
+            }
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        digits[count] = characters[i];
+        count += (unichar)(characters[i] - '0') <= 9;
+    }
+    return count;
+}
 
 @implementation STPCardValidator
 
 + (NSString *)sanitizedNumericStringForString:(NSString *)string {
-    return stringByRemovingCharactersFromSet(string, invertedAsciiDigitCharacterSet());
+    NSUInteger length = string.length;
+    unichar stackDigits[STPCardValidatorChunkLength * 2];
+    unichar *digits = length <= sizeof(stackDigits) / sizeof(unichar) ? stackDigits : malloc(length * sizeof(unichar));
+    NSUInteger digitCount = 0;
+
+    // Filter the string's own buffer when it has one, e.g. for most pasted
+    // text, and copy it out a chunk at a time otherwise.
+    const unichar *characters = string ? CFStringGetCharactersPtr((__bridge CFStringRef)string) : NULL;
+    if (characters) {
+        digitCount = STPCardValidatorCopyDigits(characters, length, digits);
+    } else {
+        unichar chunk[STPCardValidatorChunkLength];
+        for (NSUInteger location = 0; location < length; location += STPCardValidatorChunkLength) {
+            NSUInteger chunkLength = MIN(STPCardValidatorChunkLength, length - location);
+            [string getCharacters:chunk range:NSMakeRange(location, chunkLength)];
+            digitCount += STPCardValidatorCopyDigits(chunk, chunkLength, digits + digitCount);
+        }
+    }
+
+    // A string that's already all digits is returned as is
+    NSString *sanitized = (string && digitCount == length) ? string : [[NSString alloc] initWithCharacters:digits length:digitCount];
+    if (digits != stackDigits) {
+        free(digits);
+    }
+    return sanitized;
 }
 
 static NSCharacterSet *invertedAsciiDigitCharacterSet() {
@@ -111,8 +212,16 @@ static NSString * _Nonnull stringByRemovingCharactersFromSet(NSString * _Nonnull
                                                    inMonth:(NSString *)expirationMonth {
     return [self validationStateForExpirationYear:expirationYear
                                           inMonth:expirationMonth
-                                    inCurrentYear:[self currentYear]
-                                     currentMonth:[self currentMonth]];
+                                            clock:[STPValidationClock sharedClock]];
+}
+
++ (STPCardValidationState)validationStateForExpirationYear:(NSString *)expirationYear
+                                                   inMonth:(NSString *)expirationMonth
+                                                     clock:(STPValidationClock *)clock {
+    return [self validationStateForExpirationYear:expirationYear
+                                          inMonth:expirationMonth
+                                    inCurrentYear:clock.currentYear
+                                     currentMonth:clock.currentMonth];
 }
 
 
@@ -139,22 +248,32 @@ static NSString * _Nonnull stringByRemovingCharactersFromSet(NSString * _Nonnull
 
 + (STPCardValidationState)validationStateForNumber:(nonnull NSString *)cardNumber
                                validatingCardBrand:(BOOL)validatingCardBrand {
-    
-    NSString *sanitizedNumber = [self stringByRemovingSpacesFromString:cardNumber];
-    if (![self stringIsNumeric:sanitizedNumber]) {
-        return STPCardValidationStateInvalid;
+
+    // Whitespace is ignored, anything else that isn't a digit is invalid, as
+    // is a number longer than any card number we know about.
+    STPCardNumberDigits digits;
+    STPCardValidationState state = STPCardValidationStateInvalid;
+    if (STPCardNumberDigitsRead(cardNumber, NO, &digits) == STPCardNumberDigitsReadResultOK) {
+        state = [self validationStateForCardNumberDigits:&digits validatingCardBrand:validatingCardBrand];
     }
-    if (sanitizedNumber.length == 0) {
+    STPCardNumberDigitsClear(&digits);
+    return state;
+}
+
++ (STPCardValidationState)validationStateForCardNumberDigits:(const STPCardNumberDigits *)digits
+                                         validatingCardBrand:(BOOL)validatingCardBrand {
+    NSUInteger digitCount = digits->count;
+    if (digitCount == 0) {
         return STPCardValidationStateIncomplete;
     }
-    STPBINRange *binRange = [STPBINRange mostSpecificBINRangeForNumber:sanitizedNumber];
+    STPBINRange *binRange = [STPBINRange mostSpecificBINRangeForDigits:digits->values length:digitCount];
     if (binRange.brand == STPCardBrandUnknown && validatingCardBrand) {
         return STPCardValidationStateInvalid;
     }
-    if (sanitizedNumber.length == binRange.length) {
-        BOOL isValidLuhn = [self stringIsValidLuhn:sanitizedNumber];
+    if (digitCount == binRange.length) {
+        BOOL isValidLuhn = STPCardNumberDigitsAreValidLuhn(digits);
         return isValidLuhn ? STPCardValidationStateValid : STPCardValidationStateInvalid;
-    } else if (sanitizedNumber.length > binRange.length) {
+    } else if (digitCount > binRange.length) {
         return STPCardValidationStateInvalid;
     } else {
         return STPCardValidationStateIncomplete;
@@ -192,99 +311,65 @@ static NSString * _Nonnull stringByRemovingCharactersFromSet(NSString * _Nonnull
 
 + (STPCardValidationState)validationStateForCard:(STPCardParams *)card {
     return [self validationStateForCard:card
-                          inCurrentYear:[self currentYear]
-                           currentMonth:[self currentMonth]];
+                                  clock:[STPValidationClock sharedClock]];
 }
 
-+ (NSUInteger)minCVCLength {
-    return 3;
++ (STPCardValidationState)validationStateForCard:(STPCardParams *)card
+                                           clock:(STPValidationClock *)clock {
+    return [self validationStateForCard:card
+                          inCurrentYear:clock.currentYear
+                           currentMonth:clock.currentMonth];
 }
 
-+ (NSUInteger)maxCVCLengthForCardBrand:(STPCardBrand)brand {
-    switch (brand) {
-        case STPCardBrandAmex:
-        case STPCardBrandUnknown:
-            return 4;
-        default:
-            return 3;
-    }
-}
++ (NSArray<NSNumber *> *)validationStatesForCards:(NSArray<STPCardParams *> *)cards
+                                    referenceDate:(NSDate *)referenceDate {
+    STPValidationClock *clock = [[STPValidationClock alloc] initWithDate:referenceDate];
 
-+ (STPCardBrand)brandForNumber:(NSString *)cardNumber {
-    NSString *sanitizedNumber = [self sanitizedNumericStringForString:cardNumber];
-    NSSet *brands = [self possibleBrandsForNumber:sanitizedNumber];
-    if (brands.count == 1) {
-        return (STPCardBrand)[brands.anyObject integerValue];
+    size_t count = cards.count;
+    if (count == 0) {
+        return @[];
     }
-    return STPCardBrandUnknown;
-}
 
-+ (NSSet *)possibleBrandsForNumber:(NSString *)cardNumber {
-    NSArray<STPBINRange *> *binRanges = [STPBINRange binRangesForNumber:cardNumber];
-    NSMutableSet *possibleBrands = [NSMutableSet setWithArray:[binRanges valueForKeyPath:@"brand"]];
-    [possibleBrands removeObject:@(STPCardBrandUnknown)];
-    return [possibleBrands copy];
-}
+    // Each iteration writes to its own slot, so no locking is needed
+    STPCardValidationState *states = calloc(count, sizeof(STPCardValidationState));
+    dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        states[i] = [self validationStateForCard:cards[i] clock:clock];
+    });
 
-+ (NSSet<NSNumber *>*)lengthsForCardBrand:(STPCardBrand)brand {
-    NSMutableSet *set = [NSMutableSet set];
-    NSArray<STPBINRange *> *binRanges = [STPBINRange binRangesForBrand:brand];
-    for (STPBINRange *binRange in binRanges) {
-        [set addObject:@(binRange.length)];
+    NSMutableArray<NSNumber *> *results = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; i < count; i++) {
+        [results addObject:@(states[i])];
     }
-    return [set copy];
+    free(states);
+    return [results copy];
 }
 
-+ (NSInteger)maxLengthForCardBrand:(STPCardBrand)brand {
-    NSInteger maxLength = -1;
-    for (NSNumber *length in [self lengthsForCardBrand:brand]) {
-        if (length.integerValue > maxLength) {
-            maxLength = length.integerValue;
-        }
-    }
-    return maxLength;
++ (NSUInteger)minCVCLength {
+    return 3;
 }
 
-+ (NSInteger)fragmentLengthForCardBrand:(STPCardBrand)brand {
-    switch (brand) {
-        case STPCardBrandAmex:
-            return 5;
-        case STPCardBrandDinersClub:
-            return 2;
-        default:
-            return 4;
-    }
++ (NSUInteger)maxCVCLengthForCardBrand:(STPCardBrand)brand {
+    return STPCardBrandFormatForBrand(brand)->maxCVCLength;
 }
 
-+ (BOOL)stringIsValidLuhn:(NSString *)number {
-    BOOL odd = true;
-    int sum = 0;
-    NSMutableArray *digits = [NSMutableArray arrayWithCapacity:number.length];
-    
-    for (int i = 0; i < (NSInteger)number.length; i++) {
-        [digits addObject:[number substringWithRange:NSMakeRange(i, 1)]];
-    }
-    
-    for (NSString *digitStr in [digits reverseObjectEnumerator]) {
-        int digit = [digitStr intValue];
-        if ((odd = !odd)) digit *= 2;
-        if (digit > 9) digit -= 9;
-        sum += digit;
-    }
-    
-    return sum % 10 == 0;
++ (STPCardBrand)brandForNumber:(NSString *)cardNumber {
+    STPCardNumberDigits digits;
+    STPCardNumberDigitsRead(cardNumber, YES, &digits);
+    STPCardBrand brand = STPCardNumberDigitsBrand(&digits);
+    STPCardNumberDigitsClear(&digits);
+    return brand;
 }
 
-+ (NSInteger)currentYear {
-    NSCalendar *calendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
-    NSDateComponents *dateComponents = [calendar components:NSCalendarUnitYear fromDate:[NSDate date]];
-    return dateComponents.year % 100;
++ (NSSet<NSNumber *>*)lengthsForCardBrand:(STPCardBrand)brand {
+    return [STPBINRange lengthsForBrand:brand];
 }
 
-+ (NSInteger)currentMonth {
-    NSCalendar *calendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
-    NSDateComponents *dateComponents = [calendar components:NSCalendarUnitMonth fromDate:[NSDate date]];
-    return dateComponents.month;
++ (NSInteger)maxLengthForCardBrand:(STPCardBrand)brand {
+    return [STPBINRange maxLengthForBrand:brand];
+}
+
++ (NSInteger)fragmentLengthForCardBrand:(STPCardBrand)brand {
+    return STPCardBrandFormatForBrand(brand)->fragmentLength;
 }
 
 @end
@@ -12,6 +12,7 @@
 
 #import "NSArray+Stripe_BoundSafe.h"
 #import "NSBundle+Stripe_AppName.h"
+#import "NSData+Stripe_Gzip.h"
 #import "NSDecimalNumber+Stripe_Currency.h"
 #import "NSDictionary+Stripe.h"
 #import "NSMutableURLRequest+Stripe.h"
@@ -53,6 +54,7 @@
     linkUIViewControllerKeyboardAvoidingCategory();
     linkNSDecimalNumberCurrencyCategory();
     linkNSBundleAppNameCategory();
+    linkNSDataGzipCategory();
     linkAspectsCategory();
 }
 
@@ -23,12 +23,60 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic)STPVoidPromise *bootstrapPromise;
 @property(nonatomic, readonly)BOOL readyForLookups;
 
+/**
+ A client shared by everyone using `publishableKey`, so that the bootstrap,
+ its session and its CSRF token are reused. A client is replaced once its
+ bootstrap fails or gets old.
+ */
++ (instancetype)sharedClientWithPublishableKey:(NSString *)publishableKey;
+
+/**
+ Doesn't contact checkout until -bootstrapIfNeeded is called, or one of
+ the requests below is made. The bootstrap and its session are saved in the
+ caches directory, and restored by the next client for `publishableKey`
+ instead of bootstrapping again while they're less than 30 minutes old.
+ */
 - (instancetype)initWithPublishableKey:(NSString *)publishableKey;
 
-- (STPPromise<STPCheckoutAccountLookup *> *)lookupEmail:(NSString *)email;
+/**
+ Saves the bootstrap to `bootstrapCacheURL` instead, or doesn't save it if
+ that's nil.
+ */
+- (instancetype)initWithPublishableKey:(NSString *)publishableKey
+                     bootstrapCacheURL:(nullable NSURL *)bootstrapCacheURL;
+
+/**
+ Restores the saved bootstrap, or else starts the bootstrap request, unless
+ this has already been done. `bootstrapPromise` completes with it. Account
+ responses keep the session's cookies and CSRF token up to date from then on.
+ */
+- (void)bootstrapIfNeeded;
+
+/**
+ Only one lookup runs at a time for each `owner`; starting one cancels the
+ owner's last. Lookups started by other owners of this shared client are left
+ alone. `owner` isn't retained.
+ */
+- (STPPromise<STPCheckoutAccountLookup *> *)lookupEmail:(NSString *)email owner:(id)owner;
+
+/**
+ Cancels `owner`'s lookup in flight, if any. Its promise fails with a URL
+ session cancellation error.
+ */
+- (void)cancelEmailLookupForOwner:(id)owner;
 
 - (STPPromise<STPCheckoutAPIVerification *> *)sendSMSToAccountWithEmail:(NSString *)email;
 
+/**
+ Sends an SMS code to the account that `lookupPromise` finds, straight from
+ the thread the lookup finishes on rather than after a hop to the main
+ thread. `isCurrent` is called on that thread just before sending; if it
+ returns NO, because the email has changed since the lookup started, no SMS
+ is sent and the promise fails with a cancellation error.
+ */
+- (STPPromise<STPCheckoutAPIVerification *> *)sendSMSAfterLookup:(STPPromise<STPCheckoutAccountLookup *> *)lookupPromise
+                                                        ifCurrent:(BOOL (^)(void))isCurrent;
+
 - (STPPromise<STPCheckoutAccount *> *)submitSMSCode:(NSString *)code
                                     forVerification:(STPCheckoutAPIVerification *)verification;
 
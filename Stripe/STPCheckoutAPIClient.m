@@ -8,68 +8,254 @@
 
 #import "STPCheckoutAPIClient.h"
 
+#import <stdatomic.h>
+
 #import "NSBundle+Stripe_AppName.h"
 #import "NSMutableURLRequest+Stripe.h"
-#import "STPAPIClient.h"
+#import "STPAPIClient+Private.h"
 #import "STPCardValidator.h"
+#import "STPCheckoutAccountSession.h"
 #import "STPCheckoutBootstrapResponse.h"
 #import "STPLocalizationUtils.h"
+#import "STPMemoryAccounting.h"
+#import "STPURLSessionPool.h"
 #import "STPWeakStrongMacros.h"
 #import "StripeError.h"
 
-@interface STPCheckoutAPIClient()
+@interface STPCheckoutAPIClient() {
+    atomic_flag _bootstrapStarted;
+}
 @property(nonatomic, copy)NSString *publishableKey;
+@property(nonatomic, nullable)NSURL *bootstrapCacheURL;
 @property(nonatomic)NSURLSession *accountSession;
-@property(nonatomic)NSURLSessionTask *lookupTask;
+@property(nonatomic)STPCheckoutAccountSession *credentials;
+@property(nonatomic)STPCheckoutBootstrapResponse *bootstrap;
+/**
+ Each owner's lookup in flight, keyed weakly. Guarded by @synchronized on the
+ table, since lookups start on whichever thread finishes the bootstrap.
+ */
+@property(nonatomic)NSMapTable<id, NSURLSessionTask *> *lookupTasks;
 @property(nonatomic)STPAPIClient *tokenClient;
+@property(atomic)NSDate *bootstrapDate;
+@property(nonatomic, readonly)BOOL bootstrapExpired;
 @end
 
 static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
+// How long a shared client's session cookies and CSRF token are reused for
+static NSTimeInterval const CheckoutBootstrapLifetime = 30 * 60;
+
+static NSString *const SavedBootstrapDateKey = @"date";
+static NSString *const SavedBootstrapResponseKey = @"bootstrap";
+static NSString *const SavedBootstrapCredentialsKey = @"credentials";
 
 @implementation STPCheckoutAPIClient
 
++ (instancetype)sharedClientWithPublishableKey:(NSString *)publishableKey {
+    static NSMutableDictionary<NSString *, STPCheckoutAPIClient *> *sharedClients;
+    static dispatch_queue_t sharedClientsQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedClients = [NSMutableDictionary dictionary];
+        sharedClientsQueue = dispatch_queue_create("com.stripe.checkout.sharedclients", DISPATCH_QUEUE_SERIAL);
+    });
+    __block STPCheckoutAPIClient *client;
+    dispatch_sync(sharedClientsQueue, ^{
+        client = sharedClients[publishableKey];
+        if (!client || client.bootstrapPromise.error || client.bootstrapExpired) {
+            client = [[self alloc] initWithPublishableKey:publishableKey];
+            sharedClients[publishableKey] = client;
+        }
+    });
+    return client;
+}
+
++ (NSURL *)defaultBootstrapCacheURLForPublishableKey:(NSString *)publishableKey {
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] firstObject];
+    NSURL *directoryURL = [cachesURL URLByAppendingPathComponent:@"com.stripe.checkoutbootstrap" isDirectory:YES];
+    return [directoryURL URLByAppendingPathComponent:[publishableKey stringByAppendingPathExtension:@"plist"]];
+}
+
++ (dispatch_queue_t)bootstrapCacheQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.checkout.bootstrapcache", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
 - (instancetype)initWithPublishableKey:(NSString *)publishableKey {
+    return [self initWithPublishableKey:publishableKey
+                      bootstrapCacheURL:[self.class defaultBootstrapCacheURLForPublishableKey:publishableKey]];
+}
+
+- (instancetype)initWithPublishableKey:(NSString *)publishableKey bootstrapCacheURL:(NSURL *)bootstrapCacheURL {
     self = [super init];
     if (self) {
         _publishableKey = publishableKey;
+        _bootstrapCacheURL = bootstrapCacheURL;
         _merchantName = [NSBundle stp_applicationName];
         _bootstrapPromise = [STPVoidPromise new];
-        NSURLSession *urlSession = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]];
-        NSURL *baseURL = [NSURL URLWithString:CheckoutBaseURLString];
-        NSURL *url = [baseURL URLByAppendingPathComponent:@"bootstrap"];
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
-        NSDictionary *payload = @{
-                                  @"key": _publishableKey
-                                  };
-        WEAK(self);
-        [request stp_addParametersToURL:payload];
-        [[urlSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse * response, NSError *error) {
-            STRONG(self);
-            if (error) {
-                [self.bootstrapPromise fail:error];
+        _lookupTasks = [NSMapTable weakToStrongObjectsMapTable];
+        atomic_flag_clear(&_bootstrapStarted);
+        [STPMemoryAccounting trackObject:self category:STPMemoryCategoryCheckoutClients];
+    }
+    return self;
+}
+
+- (void)bootstrapIfNeeded {
+    if (atomic_flag_test_and_set(&_bootstrapStarted)) {
+        return;
+    }
+    NSURL *baseURL = [NSURL URLWithString:CheckoutBaseURLString];
+    NSURLSession *urlSession = [[STPURLSessionPool sharedPool] sessionForHost:baseURL.host additionalHeaders:@{@"X-Stripe-User-Agent": [STPAPIClient stripeUserAgentDetails]}];
+    WEAK(self);
+    dispatch_async([self.class bootstrapCacheQueue], ^{
+        STRONG(self);
+        if (self && ![self restoreSavedBootstrapWithURLSession:urlSession]) {
+            [self requestBootstrapWithURLSession:urlSession];
+        }
+    });
+}
+
+- (void)requestBootstrapWithURLSession:(NSURLSession *)urlSession {
+    NSURL *baseURL = [NSURL URLWithString:CheckoutBaseURLString];
+    NSURL *url = [baseURL URLByAppendingPathComponent:@"bootstrap"];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    NSDictionary *payload = @{
+                              @"key": self.publishableKey
+                              };
+    WEAK(self);
+    [request stp_addParametersToURL:payload];
+    [[urlSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse * response, NSError *error) {
+        STRONG(self);
+        if (error) {
+            [self.bootstrapPromise fail:error];
+        } else {
+            STPCheckoutBootstrapResponse *bootstrap = [STPCheckoutBootstrapResponse bootstrapResponseWithData:data URLResponse:response];
+            if (bootstrap && !bootstrap.accountsDisabled) {
+                STPCheckoutAccountSession *credentials = [[STPCheckoutAccountSession alloc] initWithURL:baseURL
+                                                                                                response:response
+                                                                                               csrfToken:bootstrap.csrfToken];
+                [self finishBootstrap:bootstrap credentials:credentials URLSession:urlSession date:[NSDate date]];
+                [self saveBootstrap];
             } else {
-                STPCheckoutBootstrapResponse *bootstrap = [STPCheckoutBootstrapResponse bootstrapResponseWithData:data URLResponse:response];
-                if (bootstrap && !bootstrap.accountsDisabled) {
-                    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
-                    NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
-                    NSArray<NSHTTPCookie *> *cookies = [NSHTTPCookie cookiesWithResponseHeaderFields:httpResponse.allHeaderFields forURL:baseURL];
-                    NSMutableDictionary *cookieHeaders = [[NSHTTPCookie requestHeaderFieldsWithCookies:cookies] mutableCopy];
-                    [cookieHeaders addEntriesFromDictionary:@{
-                                                            @"X-Stripe-Client": @"iossdk",
-                                                            @"X-Stripe-Client-Version": STPSDKVersion,
-                                                            @"X-CSRF-Token": bootstrap.csrfToken,
-                                                            }];
-                    configuration.HTTPAdditionalHeaders = cookieHeaders;
-                    self.accountSession = [NSURLSession sessionWithConfiguration:configuration];
-                    self.tokenClient = bootstrap.tokenClient;
-                    [self.bootstrapPromise succeed];
-                } else {
-                    [self.bootstrapPromise fail:[self.class genericRememberMeErrorWithResponseData:data message:@"Bootstrap failed."]];
-                }
+                [self.bootstrapPromise fail:[self.class genericRememberMeErrorWithResponseData:data message:@"Bootstrap failed."]];
             }
-        }] resume];
+        }
+    }] resume];
+}
+
+- (void)finishBootstrap:(STPCheckoutBootstrapResponse *)bootstrap
+            credentials:(STPCheckoutAccountSession *)credentials
+             URLSession:(NSURLSession *)urlSession
+                   date:(NSDate *)date {
+    // The cookies and token go on each request rather than on a session of
+    // their own, so account calls reuse the pooled session's connection (and
+    // TLS session) from the bootstrap.
+    self.bootstrap = bootstrap;
+    self.credentials = credentials;
+    self.accountSession = urlSession;
+    self.tokenClient = bootstrap.tokenClient;
+    self.bootstrapDate = date;
+    [self.bootstrapPromise succeed];
+}
+
+- (NSMutableURLRequest *)accountRequestWithURL:(NSURL *)url {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    [request setValue:@"iossdk" forHTTPHeaderField:@"X-Stripe-Client"];
+    [request setValue:STPSDKVersion forHTTPHeaderField:@"X-Stripe-Client-Version"];
+    [[self.credentials requestHeaders] enumerateKeysAndObjectsUsingBlock:^(NSString *field, NSString *value, __unused BOOL *stop) {
+        [request setValue:value forHTTPHeaderField:field];
+    }];
+    // Only the account session's cookies are sent, not the app's
+    request.HTTPShouldHandleCookies = NO;
+    return request;
+}
+
+/**
+ Called with every account response, before it's parsed.
+ */
+- (void)handleAccountResponse:(NSURLResponse *)response {
+    NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+    if (statusCode == 401 || statusCode == 403) {
+        // The session is no good any more. Don't restore it next launch, and
+        // let the next shared client bootstrap a new one.
+        self.bootstrapDate = [NSDate distantPast];
+        [self removeSavedBootstrap];
+    } else if ([self.credentials updateWithResponse:response]) {
+        [self saveBootstrap];
     }
-    return self;
+}
+
+#pragma mark - Saved bootstrap
+
+/**
+ Only called on the bootstrap cache queue. Returns whether a saved bootstrap
+ young enough to use was found.
+ */
+- (BOOL)restoreSavedBootstrapWithURLSession:(NSURLSession *)urlSession {
+    if (!self.bootstrapCacheURL) {
+        return NO;
+    }
+    NSData *data = [NSData dataWithContentsOfURL:self.bootstrapCacheURL];
+    id saved = data ? [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL] : nil;
+    if (![saved isKindOfClass:[NSDictionary class]]) {
+        return NO;
+    }
+    NSDate *date = saved[SavedBootstrapDateKey];
+    NSData *bootstrapData = saved[SavedBootstrapResponseKey];
+    if (![date isKindOfClass:[NSDate class]] || ![bootstrapData isKindOfClass:[NSData class]]) {
+        return NO;
+    }
+    NSTimeInterval age = -[date timeIntervalSinceNow];
+    if (age < 0 || age > CheckoutBootstrapLifetime) {
+        return NO;
+    }
+    id json = [NSJSONSerialization JSONObjectWithData:bootstrapData options:(NSJSONReadingOptions)kNilOptions error:NULL];
+    STPCheckoutBootstrapResponse *bootstrap = [STPCheckoutBootstrapResponse bootstrapResponseWithJSON:json];
+    STPCheckoutAccountSession *credentials = [STPCheckoutAccountSession sessionWithPropertyList:saved[SavedBootstrapCredentialsKey]
+                                                                                           URL:[NSURL URLWithString:CheckoutBaseURLString]];
+    if (!bootstrap || bootstrap.accountsDisabled || !credentials) {
+        return NO;
+    }
+    [self finishBootstrap:bootstrap credentials:credentials URLSession:urlSession date:date];
+    return YES;
+}
+
+- (void)saveBootstrap {
+    NSURL *fileURL = self.bootstrapCacheURL;
+    NSDate *date = self.bootstrapDate;
+    NSData *bootstrapData = [NSJSONSerialization dataWithJSONObject:self.bootstrap.allResponseFields options:(NSJSONWritingOptions)kNilOptions error:NULL];
+    NSDictionary *credentials = [self.credentials propertyListValue];
+    if (!fileURL || !date || !bootstrapData || !credentials) {
+        return;
+    }
+    dispatch_async([self.class bootstrapCacheQueue], ^{
+        NSDictionary *saved = @{
+                                SavedBootstrapDateKey: date,
+                                SavedBootstrapResponseKey: bootstrapData,
+                                SavedBootstrapCredentialsKey: credentials,
+                                };
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:saved format:NSPropertyListBinaryFormat_v1_0 options:0 error:NULL];
+        [[NSFileManager defaultManager] createDirectoryAtURL:[fileURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:NULL];
+        [data writeToURL:fileURL options:(NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication) error:NULL];
+    });
+}
+
+- (void)removeSavedBootstrap {
+    NSURL *fileURL = self.bootstrapCacheURL;
+    if (!fileURL) {
+        return;
+    }
+    dispatch_async([self.class bootstrapCacheQueue], ^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+    });
+}
+
+- (BOOL)bootstrapExpired {
+    NSDate *bootstrapDate = self.bootstrapDate;
+    return bootstrapDate && -[bootstrapDate timeIntervalSinceNow] > CheckoutBootstrapLifetime;
 }
 
 - (BOOL)readyForLookups {
@@ -79,24 +265,27 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
     return NO;
 }
 
-- (STPPromise *)lookupEmail:(NSString *)email {
+- (STPPromise *)lookupEmail:(NSString *)email owner:(id)owner {
     WEAK(self);
+    __weak id weakOwner = owner;
     Class selfClass = self.class;
+    [self bootstrapIfNeeded];
     return [self.bootstrapPromise voidFlatMap:^STPPromise*() {
         STRONG(self);
-        if (!self) {
+        id strongOwner = weakOwner;
+        if (!self || !strongOwner) {
             return [STPPromise promiseWithError:[selfClass cancellationError]];
         }
         STPPromise<STPCheckoutAccountLookup *> *lookupPromise = [STPPromise<STPCheckoutAccountLookup *> new];
         NSURL *url = [[NSURL URLWithString:CheckoutBaseURLString] URLByAppendingPathComponent:@"account/lookup"];
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        NSMutableURLRequest *request = [self accountRequestWithURL:url];
         NSDictionary *payload = @{
                                   @"key": self.publishableKey,
                                   @"email": email,
                                   };
         [request stp_addParametersToURL:payload];
-        [self.lookupTask cancel];
-        self.lookupTask = [self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        NSURLSessionTask *lookupTask = [self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            [self handleAccountResponse:response];
             STPCheckoutAccountLookup *lookup = [STPCheckoutAccountLookup lookupWithData:data URLResponse:response];
             if (lookup) {
                 [lookupPromise succeed:lookup];
@@ -104,14 +293,30 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
                 [lookupPromise fail:error ?: [self.class genericRememberMeErrorWithResponseData:data message:@"Failed to parse account lookup response"]];
             }
         }];
-        [self.lookupTask resume];
+        NSMapTable<id, NSURLSessionTask *> *lookupTasks = self.lookupTasks;
+        @synchronized(lookupTasks) {
+            [[lookupTasks objectForKey:strongOwner] cancel];
+            [lookupTasks setObject:lookupTask forKey:strongOwner];
+        }
+        [lookupTask resume];
         return lookupPromise;
     }];
 }
 
+- (void)cancelEmailLookupForOwner:(id)owner {
+    NSMapTable<id, NSURLSessionTask *> *lookupTasks = self.lookupTasks;
+    @synchronized(lookupTasks) {
+        [[lookupTasks objectForKey:owner] cancel];
+        [lookupTasks removeObjectForKey:owner];
+    }
+}
+
+// This and the methods below only build and send a request, so they run on
+// whichever thread finishes the bootstrap instead of waiting for main.
 - (STPPromise *)sendSMSToAccountWithEmail:(NSString *)email {
     WEAK(self);
     Class selfClass = self.class;
+    [self bootstrapIfNeeded];
     return [self.bootstrapPromise voidFlatMap:^STPPromise *{
         STRONG(self);
         STPPromise *smsPromise = [STPPromise new];
@@ -119,7 +324,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             return [STPPromise promiseWithError:[selfClass cancellationError]];
         }
         NSURL *url = [[NSURL URLWithString:CheckoutBaseURLString] URLByAppendingPathComponent:@"account/verifications"];
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        NSMutableURLRequest *request = [self accountRequestWithURL:url];
         request.HTTPMethod = @"POST";
         NSDictionary *payload = @{
                                   @"key": self.publishableKey,
@@ -132,6 +337,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
         [request stp_addParametersToURL:payload];
         [request stp_setFormPayload:formPayload];
         [[self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            [self handleAccountResponse:response];
             STPCheckoutAPIVerification *verification = [STPCheckoutAPIVerification verificationWithData:data URLResponse:response];
             if (verification) {
                 [smsPromise succeed:verification];
@@ -140,13 +346,27 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             }
         }] resume];
         return smsPromise;
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
+}
+
+- (STPPromise *)sendSMSAfterLookup:(STPPromise<STPCheckoutAccountLookup *> *)lookupPromise
+                         ifCurrent:(BOOL (^)(void))isCurrent {
+    WEAK(self);
+    Class selfClass = self.class;
+    return [lookupPromise flatMap:^STPPromise *(STPCheckoutAccountLookup *lookup) {
+        STRONG(self);
+        if (!self || !isCurrent()) {
+            return [STPPromise promiseWithError:[selfClass cancellationError]];
+        }
+        return [self sendSMSToAccountWithEmail:lookup.email];
+    } onQueue:STPPromiseImmediateQueue()];
 }
 
 - (STPPromise *)submitSMSCode:(NSString *)code
               forVerification:(STPCheckoutAPIVerification *)verification {
     WEAK(self);
     Class selfClass = self.class;
+    [self bootstrapIfNeeded];
     return [self.bootstrapPromise voidFlatMap:^STPPromise *{
         STRONG(self);
         STPPromise<STPCheckoutAccount*> *accountPromise = [STPPromise<STPCheckoutAccount *> new];
@@ -155,7 +375,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
         }
         NSString *pathComponent = [@"account/verifications" stringByAppendingPathComponent:verification.verificationID];
         NSURL *url = [[NSURL URLWithString:CheckoutBaseURLString] URLByAppendingPathComponent:pathComponent];
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        NSMutableURLRequest *request = [self accountRequestWithURL:url];
         request.HTTPMethod = @"PUT";
 
         NSDictionary *formPayload = @{
@@ -165,6 +385,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
                                       };
         [request stp_setFormPayload:formPayload];
         [[self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            [self handleAccountResponse:response];
             STPCheckoutAccount *account = [STPCheckoutAccount accountWithData:data URLResponse:response];
             if (account) {
                 [accountPromise succeed:account];
@@ -173,12 +394,13 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             }
         }] resume];
         return accountPromise;
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
 }
 
 - (STPPromise *)createTokenWithAccount:(STPCheckoutAccount *)account {
     WEAK(self);
     Class selfClass = self.class;
+    [self bootstrapIfNeeded];
     return [self.bootstrapPromise voidFlatMap:^STPPromise *{
         STRONG(self);
         STPPromise<STPToken *> *tokenPromise = [STPPromise new];
@@ -186,7 +408,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             return [STPPromise promiseWithError:[selfClass cancellationError]];
         }
         NSURL *url = [[NSURL URLWithString:CheckoutBaseURLString] URLByAppendingPathComponent:@"account/tokens"];
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        NSMutableURLRequest *request = [self accountRequestWithURL:url];
         request.HTTPMethod = @"POST";
         NSDictionary *payload = @{
                                   @"key": self.publishableKey,
@@ -196,6 +418,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
         [request setValue:account.sessionID forHTTPHeaderField:@"Stripe-Checkout-Test-Session"];
         [request setValue:account.csrfToken forHTTPHeaderField:@"X-CSRF-Token"];
         [[self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            [self handleAccountResponse:response];
             STPToken *token = [self parseTokenFromResponse:response data:data];
             if (token) {
                 [tokenPromise succeed:token];
@@ -204,7 +427,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             }
         }] resume];
         return tokenPromise;
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
 }
 
 - (STPPromise *)createAccountWithCardParams:(STPCardParams *)cardParams
@@ -212,6 +435,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
                                       phone:(NSString *)phone {
     WEAK(self);
     Class selfClass = self.class;
+    [self bootstrapIfNeeded];
     return [[self.bootstrapPromise voidFlatMap:^STPPromise * _Nonnull{
         STRONG(self);
         STPPromise *tokenPromise = [STPPromise new];
@@ -223,7 +447,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
             }
         }];
         return tokenPromise;
-    }] flatMap:^STPPromise *(STPToken *token) {
+    } onQueue:STPPromiseImmediateQueue()] flatMap:^STPPromise *(STPToken *token) {
         STRONG(self);
         if (!self) {
             return [STPPromise promiseWithError:[selfClass cancellationError]];
@@ -237,7 +461,7 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
         if (![internationalizedPhone hasPrefix:@"+"]) {
             internationalizedPhone = [@"+" stringByAppendingString:internationalizedPhone];
         }
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        NSMutableURLRequest *request = [self accountRequestWithURL:url];
         request.HTTPMethod = @"POST";
         
         NSDictionary *formPayload = @{
@@ -248,7 +472,8 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
                                       @"merchant_name": self.merchantName,
                                       };
         [request stp_setFormPayload:formPayload];
-        [[self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        NSURLSessionDataTask *task = [self.accountSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            [self handleAccountResponse:response];
             STPCheckoutAccount *account = [STPCheckoutAccount accountWithData:data URLResponse:response];
             if (account) {
                 [accountPromise succeed:account];
@@ -257,9 +482,12 @@ static NSString *CheckoutBaseURLString = @"https://checkout.stripe.com/api";
                                                                                          message:STPLocalizedString(@"Failed to parse account response", 
                                                                                                                     @"Error message for checkout account api call")]];
             }
-        }] resume];
+        }];
+        // Nobody waits on the account; it's saved after the token is handed off.
+        task.priority = NSURLSessionTaskPriorityLow;
+        [task resume];
         return accountPromise;
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
 }
 
 - (nullable STPToken *)parseTokenFromResponse:(NSURLResponse *)response
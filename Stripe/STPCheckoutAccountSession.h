@@ -0,0 +1,56 @@
+//
+//  STPCheckoutAccountSession.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The cookies and CSRF token that checkout's account requests carry. They start
+ out as the bootstrap's, and are kept up to date from every account response,
+ so checkout can rotate them without a new bootstrap.
+
+ The cookies are kept here rather than in a cookie storage, because the
+ session they're sent on is shared with the rest of the SDK, and so uses the
+ app's cookie storage. Safe to use from any thread.
+ */
+@interface STPCheckoutAccountSession : NSObject
+
+/**
+ A session with the cookies that `response`, e.g. the bootstrap's, sets for
+ `url`.
+ */
+- (instancetype)initWithURL:(NSURL *)url response:(nullable NSURLResponse *)response csrfToken:(NSString *)csrfToken;
+
+/**
+ A session saved with `propertyListValue`, or nil if `propertyList` isn't one.
+ */
++ (nullable instancetype)sessionWithPropertyList:(id)propertyList URL:(NSURL *)url;
+
+@property(nonatomic, readonly, copy)NSString *csrfToken;
+
+/**
+ Headers for an account request: the cookies that haven't expired, and the
+ CSRF token.
+ */
+- (NSDictionary<NSString *, NSString *> *)requestHeaders;
+
+/**
+ Keeps the cookies that `response` sets, and its CSRF token if it has one.
+ Returns whether anything changed.
+ */
+- (BOOL)updateWithResponse:(nullable NSURLResponse *)response;
+
+/**
+ The cookies and CSRF token, for saving to disk.
+ */
+- (NSDictionary *)propertyListValue;
+
+@end
+
+NS_ASSUME_NONNULL_END
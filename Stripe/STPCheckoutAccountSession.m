@@ -0,0 +1,134 @@
+//
+//  STPCheckoutAccountSession.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCheckoutAccountSession.h"
+
+static NSString *const CSRFTokenHeader = @"X-CSRF-Token";
+static NSString *const CSRFTokenKey = @"csrf_token";
+static NSString *const CookiesKey = @"cookies";
+
+@interface STPCheckoutAccountSession ()
+@property(nonatomic) NSURL *url;
+@property(nonatomic) dispatch_queue_t queue;
+// Cookies by name. Only touched on queue.
+@property(nonatomic) NSMutableDictionary<NSString *, NSHTTPCookie *> *cookies;
+// Only touched on queue
+@property(nonatomic, readwrite, copy) NSString *csrfToken;
+@end
+
+@implementation STPCheckoutAccountSession
+
+- (instancetype)initWithURL:(NSURL *)url response:(NSURLResponse *)response csrfToken:(NSString *)csrfToken {
+    self = [super init];
+    if (self) {
+        _url = url;
+        _queue = dispatch_queue_create("com.stripe.checkout.accountsession", DISPATCH_QUEUE_SERIAL);
+        _cookies = [NSMutableDictionary dictionary];
+        [self updateWithResponse:response];
+        // The token given wins over one in the response's headers
+        _csrfToken = [csrfToken copy];
+    }
+    return self;
+}
+
++ (instancetype)sessionWithPropertyList:(id)propertyList URL:(NSURL *)url {
+    if (![propertyList isKindOfClass:[NSDictionary class]]
+        || ![propertyList[CSRFTokenKey] isKindOfClass:[NSString class]]
+        || ![propertyList[CookiesKey] isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    STPCheckoutAccountSession *session = [[self alloc] initWithURL:url response:nil csrfToken:propertyList[CSRFTokenKey]];
+    for (id properties in propertyList[CookiesKey]) {
+        NSHTTPCookie *cookie = [properties isKindOfClass:[NSDictionary class]] ? [NSHTTPCookie cookieWithProperties:properties] : nil;
+        if (cookie) {
+            session.cookies[cookie.name] = cookie;
+        }
+    }
+    return session;
+}
+
+- (NSString *)csrfToken {
+    __block NSString *csrfToken;
+    dispatch_sync(self.queue, ^{
+        csrfToken = self->_csrfToken;
+    });
+    return csrfToken;
+}
+
+- (NSDictionary<NSString *, NSString *> *)requestHeaders {
+    __block NSMutableDictionary<NSString *, NSString *> *headers;
+    dispatch_sync(self.queue, ^{
+        NSDate *now = [NSDate date];
+        NSMutableArray<NSHTTPCookie *> *liveCookies = [NSMutableArray array];
+        for (NSHTTPCookie *cookie in self.cookies.allValues) {
+            if (!cookie.expiresDate || [cookie.expiresDate compare:now] == NSOrderedDescending) {
+                [liveCookies addObject:cookie];
+            }
+        }
+        headers = [[NSHTTPCookie requestHeaderFieldsWithCookies:liveCookies] mutableCopy];
+        headers[CSRFTokenHeader] = self->_csrfToken;
+    });
+    return headers;
+}
+
+- (BOOL)updateWithResponse:(NSURLResponse *)response {
+    if (![response isKindOfClass:[NSHTTPURLResponse class]]) {
+        return NO;
+    }
+    NSDictionary *headerFields = ((NSHTTPURLResponse *)response).allHeaderFields;
+    NSArray<NSHTTPCookie *> *cookies = [NSHTTPCookie cookiesWithResponseHeaderFields:headerFields forURL:self.url];
+    NSString *csrfToken = nil;
+    for (NSString *field in headerFields) {
+        if ([field caseInsensitiveCompare:CSRFTokenHeader] == NSOrderedSame) {
+            csrfToken = headerFields[field];
+        }
+    }
+    if (cookies.count == 0 && csrfToken.length == 0) {
+        return NO;
+    }
+    __block BOOL changed = NO;
+    dispatch_sync(self.queue, ^{
+        for (NSHTTPCookie *cookie in cookies) {
+            NSHTTPCookie *oldCookie = self.cookies[cookie.name];
+            if (![oldCookie.value isEqualToString:cookie.value]
+                || !(oldCookie.expiresDate == cookie.expiresDate || [oldCookie.expiresDate isEqualToDate:cookie.expiresDate])) {
+                changed = YES;
+            }
+            self.cookies[cookie.name] = cookie;
+        }
+        if (csrfToken.length > 0 && ![csrfToken isEqualToString:self->_csrfToken]) {
+            self->_csrfToken = [csrfToken copy];
+            changed = YES;
+        }
+    });
+    return changed;
+}
+
+- (NSDictionary *)propertyListValue {
+    __block NSDictionary *propertyList;
+    dispatch_sync(self.queue, ^{
+        NSMutableArray<NSDictionary *> *cookies = [NSMutableArray array];
+        for (NSHTTPCookie *cookie in self.cookies.allValues) {
+            // Only the values a property list can hold, e.g. not the origin URL
+            NSMutableDictionary *properties = [NSMutableDictionary dictionary];
+            [cookie.properties enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, __unused BOOL *stop) {
+                if ([value isKindOfClass:[NSString class]] || [value isKindOfClass:[NSNumber class]] || [value isKindOfClass:[NSDate class]]) {
+                    properties[key] = value;
+                }
+            }];
+            [cookies addObject:properties];
+        }
+        propertyList = @{
+                         CSRFTokenKey: self->_csrfToken,
+                         CookiesKey: cookies,
+                         };
+    });
+    return propertyList;
+}
+
+@end
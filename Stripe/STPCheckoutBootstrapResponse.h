@@ -15,10 +15,16 @@
 + (nullable instancetype)bootstrapResponseWithData:(nullable NSData *)data
                                        URLResponse:(nullable NSURLResponse *)response;
 
+/**
+ A bootstrap response from its `allResponseFields`, e.g. saved to disk.
+ */
++ (nullable instancetype)bootstrapResponseWithJSON:(nullable id)object;
+
 @property(nonatomic, readonly)BOOL liveMode;
 @property(nonatomic, readonly)BOOL accountsDisabled;
 @property(nonatomic, readonly, nonnull)NSString *sessionID;
 @property(nonatomic, readonly, nonnull)NSString *csrfToken;
 @property(nonatomic, readonly, nonnull)STPAPIClient *tokenClient;
+@property(nonatomic, readonly, nonnull, copy)NSDictionary *allResponseFields;
 
 @end
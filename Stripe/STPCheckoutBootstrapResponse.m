@@ -18,6 +18,7 @@
 @property(nonatomic, nonnull)NSString *sessionID;
 @property(nonatomic, nonnull)NSString *csrfToken;
 @property(nonatomic, nonnull)STPAPIClient *tokenClient;
+@property(nonatomic, nonnull, copy)NSDictionary *allResponseFields;
 
 @end
 
@@ -32,7 +33,11 @@
     if (httpResponse.statusCode != 200) {
         return nil;
     }
-    NSDictionary *object = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:nil];
+    id object = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:nil];
+    return [self bootstrapResponseWithJSON:object];
+}
+
++ (nullable instancetype)bootstrapResponseWithJSON:(id)object {
     if (![object isKindOfClass:[NSDictionary class]]) {
         return nil;
     }
@@ -62,6 +67,7 @@
         return nil;
     }
     STPCheckoutBootstrapResponse *bootstrap = [self new];
+    bootstrap.allResponseFields = object;
     bootstrap.accountsDisabled = [accountsDisabled boolValue];
     bootstrap.sessionID = sessionID;
     bootstrap.liveMode = [liveMode boolValue];
@@ -24,4 +24,21 @@
  property but with the type cast to `UITableView`
  */
 @property(nonatomic, nullable, readonly) UITableView *tableView;
+
+/**
+ Returns the height cached for `contentKey` at `width`, calling `computation`
+ to work it out the first time. `contentKey` should identify everything else
+ the height depends on, e.g. a header's title and button. Heights are shared
+ by every row, header and footer of the table, and dropped when the theme or
+ the content size category changes.
+ */
+- (CGFloat)cachedHeightForContentKey:(nonnull id<NSCopying>)contentKey
+                               width:(CGFloat)width
+                         computation:(nonnull CGFloat (^)(void))computation;
+
+/**
+ Drops every cached height, for content changes `contentKey` doesn't cover.
+ */
+- (void)invalidateCachedHeights;
+
 @end
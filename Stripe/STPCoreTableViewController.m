@@ -15,7 +15,18 @@
 // The private class extension for this class is in
 // STPCoreTableViewController+Private.h
 
-@implementation STPCoreTableViewController
+// Past this many heights the cache starts over, as keys for old content are
+// never looked up again
+static NSUInteger const MaxCachedHeights = 64;
+
+@implementation STPCoreTableViewController {
+    // Keyed by @[contentKey, width]
+    NSMutableDictionary<NSArray *, NSNumber *> *_cachedHeights;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
 
 - (UIScrollView *)createScrollView {
     UITableView *tableView = [[UITableView alloc] initWithFrame:CGRectZero style:UITableViewStyleGrouped];
@@ -37,6 +48,36 @@
 - (void)updateAppearance {
     [super updateAppearance];
     self.tableView.separatorStyle = UITableViewCellSeparatorStyleNone; // handle this with fake separator views for flexibility
+    [self invalidateCachedHeights];
+}
+
+- (CGFloat)cachedHeightForContentKey:(id<NSCopying>)contentKey
+                               width:(CGFloat)width
+                         computation:(CGFloat (^)(void))computation {
+    if (!_cachedHeights) {
+        _cachedHeights = [NSMutableDictionary dictionary];
+        // Observed rather than made part of the key: reading the category
+        // needs UIApplication, which isn't available in extensions, or
+        // iOS 10's trait collections.
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(invalidateCachedHeights)
+                                                     name:UIContentSizeCategoryDidChangeNotification
+                                                   object:nil];
+    }
+    NSArray *key = @[contentKey, @(width)];
+    NSNumber *height = _cachedHeights[key];
+    if (!height) {
+        if (_cachedHeights.count >= MaxCachedHeights) {
+            [_cachedHeights removeAllObjects];
+        }
+        height = @(computation());
+        _cachedHeights[key] = height;
+    }
+    return (CGFloat)height.doubleValue;
+}
+
+- (void)invalidateCachedHeights {
+    [_cachedHeights removeAllObjects];
 }
 
 
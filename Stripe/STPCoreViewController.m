@@ -11,17 +11,25 @@
 
 #import "STPColorUtils.h"
 #import "STPLocalizationUtils.h"
+#import "STPMainThreadWatchdog.h"
+#import "STPMemoryAccounting.h"
+#import "STPPerformanceHUD+Private.h"
+#import "STPPromise.h"
 #import "STPTheme.h"
 #import "UIBarButtonItem+Stripe.h"
 #import "UINavigationBar+Stripe_Theme.h"
 #import "UIViewController+Stripe_NavigationItemProxy.h"
 #import "UIViewController+Stripe_ParentViewController.h"
+#import "UIViewController+Stripe_Promises.h"
 
 // Note:
 // The private class extension for this class is in
 // STPCoreViewController+Private.h
 
-@implementation STPCoreViewController
+@implementation STPCoreViewController {
+    STPVoidPromise *_willAppearPromise;
+    STPVoidPromise *_didAppearPromise;
+}
 
 - (instancetype)init {
     return [self initWithTheme:[STPTheme defaultTheme]];
@@ -53,6 +61,7 @@
 
 - (void)commonInitWithTheme:(STPTheme *)theme {
     _theme = theme;
+    [STPMemoryAccounting trackObject:self category:STPMemoryCategoryViewControllers];
     self.backItem = [UIBarButtonItem stp_backButtonItemWithTitle:STPLocalizedString(@"Back", @"Text for back button")
                                                            style:UIBarButtonItemStylePlain
                                                           target:self
@@ -66,7 +75,9 @@
 
 - (void)setTheme:(STPTheme *)theme {
     _theme = theme;
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
     [self updateAppearance];
+    STPMainThreadWatchdogEnd(start, self, @selector(updateAppearance));
 }
 
 - (void)createAndSetupViews {
@@ -76,8 +87,17 @@
 - (void)viewDidLoad {
     [super viewDidLoad];
     self.automaticallyAdjustsScrollViewInsets = NO;
+#if DEBUG
+    [STPPerformanceHUD noteCurrentScreen:self];
+#endif
+    // Measured here rather than in the methods themselves, so that the
+    // subclasses' overrides count too
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
     [self createAndSetupViews];
+    STPMainThreadWatchdogEnd(start, self, @selector(createAndSetupViews));
+    start = STPMainThreadWatchdogBegin();
     [self updateAppearance];
+    STPMainThreadWatchdogEnd(start, self, @selector(updateAppearance));
 }
 
 - (void)updateAppearance {
@@ -94,10 +114,51 @@
 
 - (void)viewWillAppear:(BOOL)animated {
     [super viewWillAppear:animated];
+#if DEBUG
+    // Again here, for a screen shown again after another was pushed over it
+    [STPPerformanceHUD noteCurrentScreen:self];
+#endif
 
     if (![self stp_isAtRootOfNavigationController]) {
         self.stp_navigationItemProxy.leftBarButtonItem = self.backItem;
     }
+    if (_willAppearPromise && !_willAppearPromise.completed) {
+        [_willAppearPromise succeed];
+    }
+}
+
+- (void)viewDidAppear:(BOOL)animated {
+    [super viewDidAppear:animated];
+    if (_didAppearPromise && !_didAppearPromise.completed) {
+        [_didAppearPromise succeed];
+    }
+}
+
+#pragma mark - Appearance promises
+
+// These override the UIViewController category versions, which have to hook
+// the appearance methods of the instance at runtime.
+
+- (STPVoidPromise *)stp_willAppearPromise {
+    if (!_willAppearPromise) {
+        _willAppearPromise = [self appearancePromise];
+    }
+    return _willAppearPromise;
+}
+
+- (STPVoidPromise *)stp_didAppearPromise {
+    if (!_didAppearPromise) {
+        _didAppearPromise = [self appearancePromise];
+    }
+    return _didAppearPromise;
+}
+
+- (STPVoidPromise *)appearancePromise {
+    STPVoidPromise *promise = [STPVoidPromise new];
+    if (self.isViewLoaded && self.view.window) {
+        [promise succeed];
+    }
+    return promise;
 }
 
 - (void)viewWillDisappear:(BOOL)animated {
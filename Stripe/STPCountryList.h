@@ -0,0 +1,56 @@
+//
+//  STPCountryList.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The countries offered by address forms, in the order they're listed, with
+ their display names. Building a list means looking up hundreds of display
+ names, so it's built once per locale, shared by every form, and can be built
+ ahead of time off the main thread. Safe to use from any thread.
+ 
+ Names are in the language of the Stripe strings, which can differ from the
+ current locale's (see `STPLocalizationUtils`).
+ */
+@interface STPCountryList : NSObject
+
+/**
+ The list for the current locale, building it first if needed. Waits for a
+ build already started by `prepareCurrentList` rather than starting another.
+ */
++ (instancetype)currentList;
+
+/**
+ Starts building the list for the current locale on a background queue, if
+ it isn't built already.
+ */
++ (void)prepareCurrentList;
+
+/**
+ The display name of `countryCode` in the current locale, or nil if it isn't
+ an ISO country code. Doesn't need a list.
+ */
++ (nullable NSString *)displayNameForCountryCode:(nullable NSString *)countryCode;
+
+/**
+ An empty code, for no country, then the user's own country, then the rest
+ sorted by display name.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *countryCodes;
+
+/**
+ The display name of each code in `countryCodes`, in the same order. The
+ empty code's name is empty.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *displayNames;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,107 @@
+//
+//  STPCountryList.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCountryList.h"
+
+#import "STPLocalizationUtils.h"
+
+@interface STPCountryList ()
+@property (nonatomic, readwrite) NSArray<NSString *> *countryCodes;
+@property (nonatomic, readwrite) NSArray<NSString *> *displayNames;
+@end
+
+@implementation STPCountryList
+
++ (dispatch_queue_t)queue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.countrylist", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// Called on queue
++ (NSMutableDictionary<NSString *, STPCountryList *> *)lists {
+    static NSMutableDictionary *lists;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        lists = [NSMutableDictionary dictionary];
+    });
+    return lists;
+}
+
++ (instancetype)currentList {
+    __block STPCountryList *list;
+    dispatch_sync([self queue], ^{
+        list = [self currentListOnQueue];
+    });
+    return list;
+}
+
++ (void)prepareCurrentList {
+    dispatch_async([self queue], ^{
+        [self currentListOnQueue];
+    });
+}
+
++ (NSString *)displayNameForCountryCode:(NSString *)countryCode {
+    static NSSet<NSString *> *isoCountryCodes;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        isoCountryCodes = [NSSet setWithArray:[NSLocale ISOCountryCodes]];
+    });
+    if (!countryCode || ![isoCountryCodes containsObject:countryCode]) {
+        return nil;
+    }
+    NSString *identifier = [NSLocale localeIdentifierFromComponents:@{NSLocaleCountryCode: countryCode}];
+    return [[STPLocalizationUtils localizedStripeStringsLocale] displayNameForKey:NSLocaleIdentifier value:identifier] ?: countryCode;
+}
+
++ (instancetype)currentListOnQueue {
+    // Named in the language of the form's own strings
+    NSLocale *locale = [STPLocalizationUtils localizedStripeStringsLocale];
+    NSString *countryCode = [locale objectForKey:NSLocaleCountryCode];
+    NSString *key = [NSString stringWithFormat:@"%@|%@", locale.localeIdentifier, countryCode];
+    STPCountryList *list = [self lists][key];
+    if (!list) {
+        list = [[self alloc] initWithLocale:locale countryCode:countryCode];
+        [self lists][key] = list;
+    }
+    return list;
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale countryCode:(NSString *)countryCode {
+    self = [super init];
+    if (self) {
+        NSMutableArray<NSString *> *otherCountryCodes = [[NSLocale ISOCountryCodes] mutableCopy];
+        [otherCountryCodes removeObject:countryCode];
+        NSMutableDictionary<NSString *, NSString *> *names = [NSMutableDictionary dictionaryWithCapacity:otherCountryCodes.count + 1];
+        for (NSString *code in [otherCountryCodes arrayByAddingObject:countryCode ?: @""]) {
+            NSString *identifier = [NSLocale localeIdentifierFromComponents:@{NSLocaleCountryCode: code}];
+            names[code] = code.length > 0 ? ([locale displayNameForKey:NSLocaleIdentifier value:identifier] ?: code) : @"";
+        }
+        [otherCountryCodes sortUsingComparator:^NSComparisonResult(NSString *code1, NSString *code2) {
+            return [names[code1] compare:names[code2]];
+        }];
+        NSMutableArray<NSString *> *countryCodes = [NSMutableArray arrayWithObject:@""];
+        if (countryCode) {
+            [countryCodes addObject:countryCode];
+        }
+        [countryCodes addObjectsFromArray:otherCountryCodes];
+        NSMutableArray<NSString *> *displayNames = [NSMutableArray arrayWithCapacity:countryCodes.count];
+        for (NSString *code in countryCodes) {
+            [displayNames addObject:names[code] ?: @""];
+        }
+        _countryCodes = [countryCodes copy];
+        _displayNames = [displayNames copy];
+    }
+    return self;
+}
+
+@end
@@ -17,6 +17,7 @@
 @property(nonatomic, copy)NSString *stripeID;
 @property(nonatomic) id<STPSourceProtocol> defaultSource;
 @property(nonatomic) NSArray<id<STPSourceProtocol>> *sources;
+@property(nonatomic) BOOL hasMoreSources;
 
 @end
 
@@ -34,6 +35,39 @@
 
 @end
 
+/**
+ Decodes the cards and sources in a list's `data`, and picks out the one with
+ `defaultSourceID`, if it's there.
+ */
+static NSArray<id<STPSourceProtocol>> *STPCustomerDecodeSources(NSArray *data, NSString *defaultSourceID, id<STPSourceProtocol> *defaultSource) {
+    NSMutableArray *sources = [NSMutableArray arrayWithCapacity:data.count];
+    for (id contents in data) {
+        if ([contents isKindOfClass:[NSDictionary class]]) {
+            // eventually support other source types
+            if ([contents[@"object"] isEqualToString:@"card"]) {
+                STPCard *card = [STPCard decodedObjectFromAPIResponse:contents];
+                // ignore apple pay cards from the response
+                if (card && !card.isApplePayCard) {
+                    [sources addObject:card];
+                    if (defaultSourceID && [card.stripeID isEqualToString:defaultSourceID]) {
+                        *defaultSource = card;
+                    }
+                }
+            }
+            else if ([contents[@"object"] isEqualToString:@"source"]) {
+                STPSource *source = [STPSource decodedObjectFromAPIResponse:contents];
+                if (source) {
+                    [sources addObject:source];
+                    if (defaultSourceID && [source.stripeID isEqualToString:defaultSourceID]) {
+                        *defaultSource = source;
+                    }
+                }
+            }
+        }
+    }
+    return sources;
+}
+
 @interface STPCustomerDeserializer()
 
 @property(nonatomic, nullable)STPCustomer *customer;
@@ -78,33 +112,11 @@
         if ([json[@"default_source"] isKindOfClass:[NSString class]]) {
             defaultSourceId = json[@"default_source"];
         }
-        NSMutableArray *sources = [NSMutableArray array];
         if ([json[@"sources"] isKindOfClass:[NSDictionary class]] && [json[@"sources"][@"data"] isKindOfClass:[NSArray class]]) {
-            for (id contents in json[@"sources"][@"data"]) {
-                if ([contents isKindOfClass:[NSDictionary class]]) {
-                    // eventually support other source types
-                    if ([contents[@"object"] isEqualToString:@"card"]) {
-                        STPCard *card = [STPCard decodedObjectFromAPIResponse:contents];
-                        // ignore apple pay cards from the response
-                        if (card && !card.isApplePayCard) {
-                            [sources addObject:card];
-                            if (defaultSourceId && [card.stripeID isEqualToString:defaultSourceId]) {
-                                customer.defaultSource = card;
-                            }
-                        }
-                    }
-                    else if ([contents[@"object"] isEqualToString:@"source"]) {
-                        STPSource *source = [STPSource decodedObjectFromAPIResponse:contents];
-                        if (source) {
-                            [sources addObject:source];
-                            if (defaultSourceId && [source.stripeID isEqualToString:defaultSourceId]) {
-                                customer.defaultSource = source;
-                            }
-                        }
-                    }
-                }
-            }
-            customer.sources = sources;
+            id<STPSourceProtocol> defaultSource;
+            customer.sources = STPCustomerDecodeSources(json[@"sources"][@"data"], defaultSourceId, &defaultSource);
+            customer.defaultSource = defaultSource;
+            customer.hasMoreSources = [json[@"sources"][@"has_more"] boolValue];
         }
         _customer = customer;
     }
@@ -112,3 +124,51 @@
 }
 
 @end
+
+@interface STPCustomerSourcesDeserializer()
+
+@property(nonatomic, nullable)NSArray<id<STPSourceProtocol>> *sources;
+@property(nonatomic)BOOL hasMore;
+@property(nonatomic, nullable)NSError *error;
+
+@end
+
+@implementation STPCustomerSourcesDeserializer
+
+- (instancetype)initWithData:(nullable NSData *)data
+                 urlResponse:(nullable __unused NSURLResponse *)urlResponse
+                       error:(nullable NSError *)error {
+    if (error) {
+        return [self initWithError:error];
+    }
+    NSError *jsonError;
+    id json = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:&jsonError];
+    if (!json) {
+        return [self initWithError:jsonError];
+    }
+    return [self initWithJSONResponse:json];
+}
+
+- (instancetype)initWithError:(NSError *)error {
+    self = [super init];
+    if (self) {
+        _error = error;
+    }
+    return self;
+}
+
+- (instancetype)initWithJSONResponse:(id)json {
+    self = [super init];
+    if (self) {
+        if (![json isKindOfClass:[NSDictionary class]] || ![json[@"data"] isKindOfClass:[NSArray class]]) {
+            _error = [NSError stp_genericFailedToParseResponseError];
+            return self;
+        }
+        id<STPSourceProtocol> defaultSource;
+        _sources = STPCustomerDecodeSources(json[@"data"], nil, &defaultSource);
+        _hasMore = [json[@"has_more"] boolValue];
+    }
+    return self;
+}
+
+@end
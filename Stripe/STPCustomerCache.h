@@ -0,0 +1,52 @@
+//
+//  STPCustomerCache.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPBackendAPIAdapter.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The last customer each `STPBackendAPIAdapter` returned, so the prebuilt UI can
+ show it while a fresh one loads. Entries are held in memory, keyed by the
+ adapter instance, and disappear with it. Main thread only.
+
+ This is also the one place the prebuilt UI asks an adapter for its customer,
+ so that a payment context and a payment methods screen loading at the same
+ time share a single request.
+ */
+@interface STPCustomerCache : NSObject
+
++ (instancetype)sharedCache;
+
+- (nullable STPCustomer *)customerForAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter;
+
+/**
+ Asks the adapter for its customer, remembering the result on success. If a
+ request to the same adapter is already in flight, this waits for that one
+ instead of starting another. The completion block is called on the main
+ thread.
+ */
+- (void)retrieveCustomerWithAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter
+                            completion:(STPCustomerCompletionBlock)completion;
+
+/**
+ Like `retrieveCustomerWithAPIAdapter:completion:`, but always starts a new
+ request, for when the customer is known to have changed (e.g. a card was just
+ attached) and an older in-flight answer would be stale. Later retrieves join
+ this request.
+ */
+- (void)refreshCustomerWithAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter
+                           completion:(STPCustomerCompletionBlock)completion;
+
+- (void)removeAllCustomers;
+
+@end
+
+NS_ASSUME_NONNULL_END
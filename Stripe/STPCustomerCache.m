@@ -0,0 +1,90 @@
+//
+//  STPCustomerCache.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPCustomerCache.h"
+
+#import "STPDispatchFunctions.h"
+
+@interface STPCustomerCache ()
+@property(nonatomic)NSMapTable<id<STPBackendAPIAdapter>, STPCustomer *> *customers;
+/**
+ Completion blocks waiting on each adapter's in-flight request. The array is
+ replaced, not emptied, when a newer request supersedes it.
+ */
+@property(nonatomic)NSMapTable<id<STPBackendAPIAdapter>, NSMutableArray<STPCustomerCompletionBlock> *> *pendingCompletions;
+@end
+
+@implementation STPCustomerCache
+
++ (instancetype)sharedCache {
+    static STPCustomerCache *sharedCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [self new];
+    });
+    return sharedCache;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        // Adapters are compared by identity; one adapter's customer is never
+        // shown through another.
+        _customers = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory
+                                                   capacity:0];
+        _pendingCompletions = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                                        valueOptions:NSPointerFunctionsStrongMemory
+                                                            capacity:0];
+    }
+    return self;
+}
+
+- (STPCustomer *)customerForAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter {
+    return [self.customers objectForKey:apiAdapter];
+}
+
+- (void)retrieveCustomerWithAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter
+                            completion:(STPCustomerCompletionBlock)completion {
+    NSMutableArray<STPCustomerCompletionBlock> *pending = [self.pendingCompletions objectForKey:apiAdapter];
+    if (pending) {
+        [pending addObject:[completion copy]];
+        return;
+    }
+    [self refreshCustomerWithAPIAdapter:apiAdapter completion:completion];
+}
+
+- (void)refreshCustomerWithAPIAdapter:(id<STPBackendAPIAdapter>)apiAdapter
+                           completion:(STPCustomerCompletionBlock)completion {
+    NSMutableArray<STPCustomerCompletionBlock> *pending = [NSMutableArray arrayWithObject:[completion copy]];
+    [self.pendingCompletions setObject:pending forKey:apiAdapter];
+    __weak id<STPBackendAPIAdapter> weakAdapter = apiAdapter;
+    [apiAdapter retrieveCustomer:^(STPCustomer * _Nullable customer, NSError * _Nullable error) {
+        stpDispatchToMainThreadIfNecessary(^{
+            id<STPBackendAPIAdapter> adapter = weakAdapter;
+            // Only the newest request for an adapter gets to update the cache
+            // and clear the in-flight slot.
+            if (adapter && [self.pendingCompletions objectForKey:adapter] == pending) {
+                [self.pendingCompletions removeObjectForKey:adapter];
+                if (customer && !error) {
+                    [self.customers setObject:customer forKey:adapter];
+                }
+            }
+            for (STPCustomerCompletionBlock block in pending) {
+                block(customer, error);
+            }
+        });
+    }];
+}
+
+- (void)removeAllCustomers {
+    [self.customers removeAllObjects];
+    [self.pendingCompletions removeAllObjects];
+}
+
+@end
@@ -8,22 +8,80 @@
 
 #import "STPDelegateProxy.h"
 
+typedef NS_ENUM(NSUInteger, STPDelegateProxyTarget) {
+    STPDelegateProxyTargetUnresolved = 0,
+    STPDelegateProxyTargetSelf,
+    STPDelegateProxyTargetDelegate,
+    STPDelegateProxyTargetNone,
+};
+
+@interface STPDelegateProxy () {
+    /**
+     Maps selectors to the STPDelegateProxyTarget that handles them, so every
+     keystroke's delegate callbacks don't repeat the runtime lookups.
+     Cleared whenever the delegate changes.
+     */
+    CFMutableDictionaryRef _targetsBySelector;
+}
+@end
+
 @implementation STPDelegateProxy
 
 - (instancetype)init {
     return self;
 }
 
+- (void)dealloc {
+    if (_targetsBySelector) {
+        CFRelease(_targetsBySelector);
+    }
+}
+
+- (void)setDelegate:(id)delegate {
+    _delegate = delegate;
+    if (_targetsBySelector) {
+        CFDictionaryRemoveAllValues(_targetsBySelector);
+    }
+}
+
+- (STPDelegateProxyTarget)targetForSelector:(SEL)selector {
+    if (!_targetsBySelector) {
+        // Selectors are unique pointers, so no retain or equality callbacks are needed.
+        _targetsBySelector = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+    }
+    STPDelegateProxyTarget target = (STPDelegateProxyTarget)(uintptr_t)CFDictionaryGetValue(_targetsBySelector, selector);
+    if (target == STPDelegateProxyTargetUnresolved) {
+        id delegate = _delegate;
+        if ([[self class] instancesRespondToSelector:selector]) {
+            target = STPDelegateProxyTargetSelf;
+        } else if ([delegate respondsToSelector:selector]) {
+            target = STPDelegateProxyTargetDelegate;
+        } else {
+            target = STPDelegateProxyTargetNone;
+        }
+        // A delegate that has gone away resolves to nothing, but shouldn't be
+        // remembered that way in case the weak reference is set again.
+        if (delegate || target == STPDelegateProxyTargetSelf) {
+            CFDictionarySetValue(_targetsBySelector, selector, (const void *)(uintptr_t)target);
+        }
+    }
+    return target;
+}
+
 - (BOOL)respondsToSelector:(SEL)selector {
-    return [super respondsToSelector:selector] || [_delegate respondsToSelector:selector];
+    STPDelegateProxyTarget target = [self targetForSelector:selector];
+    if (target == STPDelegateProxyTargetDelegate) {
+        return _delegate != nil;
+    }
+    return target == STPDelegateProxyTargetSelf;
 }
 
 - (id)forwardingTargetForSelector:(SEL)selector {
-    if ([self respondsToSelector:selector]) {
-        return self;
-    }
-    if ([_delegate respondsToSelector:selector]) {
-        return _delegate;
+    if ([self targetForSelector:selector] == STPDelegateProxyTargetDelegate) {
+        id delegate = _delegate;
+        if (delegate) {
+            return delegate;
+        }
     }
     return self;
 }
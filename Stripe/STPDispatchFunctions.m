@@ -8,9 +8,16 @@
 
 #include "STPDispatchFunctions.h"
 
+#import "STPMainThreadWatchdog.h"
+
 void stpDispatchToMainThreadIfNecessary(dispatch_block_t block) {
     if ([NSThread isMainThread]) {
-        block();
+        STPMainThreadWatchdogRun(block);
+    }
+    else if (atomic_load_explicit(&STPMainThreadWatchdogEnabled, memory_order_relaxed)) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            STPMainThreadWatchdogRun(block);
+        });
     }
     else {
         dispatch_async(dispatch_get_main_queue(), block);
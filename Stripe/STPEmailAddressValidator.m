@@ -8,20 +8,99 @@
 
 #import "STPEmailAddressValidator.h"
 
+typedef NS_ENUM(NSInteger, STPEmailValidationState) {
+    STPEmailValidationStateLocalStart,
+    STPEmailValidationStateLocal,
+    STPEmailValidationStateLabelStart,
+    STPEmailValidationStateLabel,
+};
+
+static BOOL STPEmailIsAlphanumeric(UniChar c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static BOOL STPEmailIsLocalCharacter(UniChar c) {
+    if (STPEmailIsAlphanumeric(c)) {
+        return YES;
+    }
+    switch (c) {
+        case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
+        case '+': case '/': case '=': case '?': case '^': case '_': case '`':
+        case '{': case '|': case '}': case '~': case '-':
+            return YES;
+        default:
+            return NO;
+    }
+}
+
 @implementation STPEmailAddressValidator
 
 + (BOOL)stringIsValidPartialEmailAddress:(nullable NSString *)string {
-    return [[string mutableCopy] replaceOccurrencesOfString:@"@" withString:@"" options:NSLiteralSearch range:NSMakeRange(0, string.length)] <= 1;
+    if (!string) {
+        return YES;
+    }
+    NSRange at = [string rangeOfString:@"@" options:NSLiteralSearch];
+    if (at.location == NSNotFound) {
+        return YES;
+    }
+    NSRange rest = NSMakeRange(NSMaxRange(at), string.length - NSMaxRange(at));
+    return [string rangeOfString:@"@" options:NSLiteralSearch range:rest].location == NSNotFound;
 }
 
 + (BOOL)stringIsValidEmailAddress:(NSString *)string {
     if (!string) {
         return NO;
     }
-    // regex from http://www.regular-expressions.info/email.html
-    NSString *pattern = @"[a-z0-9!#$%&'*+/=?^_`{|}~-]+(?:\\.[a-z0-9!#$%&'*+/=?^_`{|}~-]+)*@(?:[a-z0-9](?:[a-z0-9-]*[a-z0-9])?\\.)+[a-z0-9](?:[a-z0-9-]*[a-z0-9])?";
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"SELF MATCHES %@", pattern];
-    return [predicate evaluateWithObject:[string lowercaseString]];
+    // A single pass over the characters, accepting the same addresses as
+    // the regex from http://www.regular-expressions.info/email.html:
+    // dot-separated atoms, an @, then two or more dot-separated domain
+    // labels that start and end with a letter or digit.
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    CFIndex length = CFStringGetLength(cfString);
+    CFStringInlineBuffer buffer;
+    CFStringInitInlineBuffer(cfString, &buffer, CFRangeMake(0, length));
+    STPEmailValidationState state = STPEmailValidationStateLocalStart;
+    NSUInteger labelCount = 0;
+    UniChar previous = 0;
+    for (CFIndex i = 0; i < length; i++) {
+        UniChar c = CFStringGetCharacterFromInlineBuffer(&buffer, i);
+        switch (state) {
+            case STPEmailValidationStateLocalStart:
+                if (!STPEmailIsLocalCharacter(c)) {
+                    return NO;
+                }
+                state = STPEmailValidationStateLocal;
+                break;
+            case STPEmailValidationStateLocal:
+                if (c == '.') {
+                    state = STPEmailValidationStateLocalStart;
+                } else if (c == '@') {
+                    state = STPEmailValidationStateLabelStart;
+                } else if (!STPEmailIsLocalCharacter(c)) {
+                    return NO;
+                }
+                break;
+            case STPEmailValidationStateLabelStart:
+                if (!STPEmailIsAlphanumeric(c)) {
+                    return NO;
+                }
+                labelCount++;
+                state = STPEmailValidationStateLabel;
+                break;
+            case STPEmailValidationStateLabel:
+                if (c == '.') {
+                    if (previous == '-') {
+                        return NO;
+                    }
+                    state = STPEmailValidationStateLabelStart;
+                } else if (c != '-' && !STPEmailIsAlphanumeric(c)) {
+                    return NO;
+                }
+                break;
+        }
+        previous = c;
+    }
+    return state == STPEmailValidationStateLabel && previous != '-' && labelCount >= 2;
 }
 
 @end
@@ -0,0 +1,31 @@
+//
+//  STPExtensionMode.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Whether `+[Stripe enableExtensionMode]` has been called. Cheap enough to
+ check on every request.
+ */
+BOOL stpExtensionModeEnabled(void);
+
+/**
+ Only tests should turn extension mode back off.
+ */
+void stpSetExtensionModeEnabled(BOOL enabled);
+
+/**
+ The shared application, or nil in extension mode and when running in an app
+ extension, where there isn't one. Callers treat nil as "no app to ask", e.g.
+ for background time.
+ */
+UIApplication * _Nullable stpSharedApplication(void);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,40 @@
+//
+//  STPExtensionMode.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPExtensionMode.h"
+
+#import <stdatomic.h>
+
+static atomic_bool STPExtensionModeIsEnabled;
+
+BOOL stpExtensionModeEnabled(void) {
+    return atomic_load_explicit(&STPExtensionModeIsEnabled, memory_order_relaxed);
+}
+
+void stpSetExtensionModeEnabled(BOOL enabled) {
+    atomic_store(&STPExtensionModeIsEnabled, enabled);
+}
+
+static BOOL stpRunningInAppExtension(void) {
+    static BOOL runningInAppExtension;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        runningInAppExtension = [[NSBundle mainBundle].bundlePath.pathExtension isEqualToString:@"appex"];
+    });
+    return runningInAppExtension;
+}
+
+UIApplication *stpSharedApplication(void) {
+    if (stpExtensionModeEnabled() || stpRunningInAppExtension()) {
+        return nil;
+    }
+    // Looked up by selector, so this still compiles when the SDK's sources
+    // are built into an extension target that sets
+    // APPLICATION_EXTENSION_API_ONLY. The Stripe targets don't set it.
+    return [UIApplication performSelector:@selector(sharedApplication)];
+}
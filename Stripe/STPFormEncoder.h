@@ -19,6 +19,22 @@
 
 + (nonnull NSString *)stringByReplacingSnakeCaseWithCamelCase:(nonnull NSString *)input;
 
+/**
+ Form-encodes `parameters`. NSData values are taken to be UTF-8 text and
+ escaped byte for byte, which saves converting large payloads to strings.
+ */
 + (nonnull NSString *)queryStringFromParameters:(nonnull NSDictionary *)parameters;
 
+/**
+ The same encoding as `queryStringFromParameters:`, as UTF-8 data ready to be
+ used as a request body.
+ */
++ (nonnull NSData *)formDataFromParameters:(nonnull NSDictionary *)parameters;
+
+/**
+ Encodes `parameters` straight onto the end of `data`, so callers encoding
+ many bodies can reuse a single buffer.
+ */
++ (void)appendFormDataFromParameters:(nonnull NSDictionary *)parameters toData:(nonnull NSMutableData *)data;
+
 @end
@@ -8,11 +8,88 @@
 
 #import "STPFormEncoder.h"
 
+#import <objc/runtime.h>
+
 #import "STPBankAccountParams.h"
+#import "STPCardNumberBuffer.h"
 #import "STPCardParams.h"
 
-FOUNDATION_EXPORT NSString * STPPercentEscapedStringFromString(NSString *string);
-FOUNDATION_EXPORT NSString * STPQueryStringFromParameters(NSDictionary *parameters);
+/**
+ How to read one form field off an STPFormEncodable object.
+ */
+@interface STPFormEncodingField : NSObject
+@property (nonatomic, copy) NSString *propertyName;
+@property (nonatomic, copy) NSString *formFieldName;
+@property (nonatomic) SEL getter;
+/**
+ The getter's implementation, or NULL if it doesn't return an object and the
+ value has to be read (and boxed) through KVC instead.
+ */
+@property (nonatomic) IMP getterImplementation;
+@end
+
+@implementation STPFormEncodingField
+@end
+
+/**
+ The fields to encode for one STPFormEncodable class, built the first time an
+ instance of that class is encoded.
+ */
+@interface STPFormEncodingPlan : NSObject
+@property (nonatomic, copy) NSArray<STPFormEncodingField *> *fields;
+@end
+
+@implementation STPFormEncodingPlan
+
+- (instancetype)initWithClass:(Class)cls {
+    self = [super init];
+    if (self) {
+        NSMutableArray<STPFormEncodingField *> *fields = [NSMutableArray array];
+        [[cls propertyNamesToFormFieldNamesMapping] enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull propertyName, NSString * _Nonnull formFieldName, __unused BOOL * _Nonnull stop) {
+            STPFormEncodingField *field = [STPFormEncodingField new];
+            field.propertyName = propertyName;
+            field.formFieldName = formFieldName;
+            field.getter = [[self class] getterForPropertyName:propertyName inClass:cls];
+            Method method = class_getInstanceMethod(cls, field.getter);
+            if (method) {
+                char *returnType = method_copyReturnType(method);
+                if (returnType[0] == _C_ID) {
+                    field.getterImplementation = method_getImplementation(method);
+                }
+                free(returnType);
+            }
+            [fields addObject:field];
+        }];
+        _fields = [fields copy];
+    }
+    return self;
+}
+
++ (SEL)getterForPropertyName:(NSString *)propertyName inClass:(Class)cls {
+    objc_property_t property = class_getProperty(cls, propertyName.UTF8String);
+    if (property) {
+        char *customGetter = property_copyAttributeValue(property, "G");
+        if (customGetter) {
+            SEL getter = sel_registerName(customGetter);
+            free(customGetter);
+            return getter;
+        }
+    }
+    return NSSelectorFromString(propertyName);
+}
+
+- (id)valueOfField:(STPFormEncodingField *)field inObject:(NSObject *)object {
+    IMP implementation = field.getterImplementation;
+    if (implementation) {
+        return ((id (*)(id, SEL))implementation)(object, field.getter);
+    }
+    return [object valueForKey:field.propertyName];
+}
+
+@end
+
+static void STPFormEncoderAppendEscapedString(NSMutableData *data, NSString *string);
+static void STPFormEncoderAppendPairs(NSMutableData *data, NSMutableData *escapedKey, id value, BOOL *isFirstPair);
 
 @implementation STPFormEncoder
 
@@ -33,14 +110,36 @@ FOUNDATION_EXPORT NSString * STPQueryStringFromParameters(NSDictionary *paramete
     return dict;
 }
 
++ (STPFormEncodingPlan *)encodingPlanForClass:(Class)cls {
+    static NSMapTable *plans;
+    static dispatch_queue_t plansQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        plans = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality)
+                                      valueOptions:NSPointerFunctionsStrongMemory];
+        plansQueue = dispatch_queue_create("com.stripe.formencoder.plans", DISPATCH_QUEUE_SERIAL);
+    });
+
+    __block STPFormEncodingPlan *plan;
+    dispatch_sync(plansQueue, ^{
+        plan = [plans objectForKey:cls];
+        if (!plan) {
+            plan = [[STPFormEncodingPlan alloc] initWithClass:cls];
+            [plans setObject:plan forKey:cls];
+        }
+    });
+    return plan;
+}
+
 + (NSDictionary *)keyPairDictionaryForObject:(nonnull NSObject<STPFormEncodable> *)object {
-    NSMutableDictionary *keyPairs = [NSMutableDictionary dictionary];
-    [[object.class propertyNamesToFormFieldNamesMapping] enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull propertyName, NSString *  _Nonnull formFieldName, __unused BOOL * _Nonnull stop) {
-        id value = [self formEncodableValueForObject:[object valueForKey:propertyName]];
+    STPFormEncodingPlan *plan = [self encodingPlanForClass:object.class];
+    NSMutableDictionary *keyPairs = [NSMutableDictionary dictionaryWithCapacity:plan.fields.count];
+    for (STPFormEncodingField *field in plan.fields) {
+        id value = [self formEncodableValueForObject:[plan valueOfField:field inObject:object]];
         if (value) {
-            keyPairs[formFieldName] = value;
+            keyPairs[field.formFieldName] = value;
         }
-    }];
+    }
     [object.additionalAPIParameters enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull additionalFieldName, id  _Nonnull additionalFieldValue, __unused BOOL * _Nonnull stop) {
         id value = [self formEncodableValueForObject:additionalFieldValue];
         if (value) {
@@ -59,132 +158,161 @@ FOUNDATION_EXPORT NSString * STPQueryStringFromParameters(NSDictionary *paramete
 }
 
 + (NSString *)stringByURLEncoding:(NSString *)string {
-    return STPPercentEscapedStringFromString(string);
+    NSMutableData *data = [NSMutableData dataWithCapacity:string.length];
+    STPFormEncoderAppendEscapedString(data, string);
+    return [[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding];
 }
 
 + (NSString *)queryStringFromParameters:(NSDictionary *)parameters {
-    return STPQueryStringFromParameters(parameters);
+    return [[NSString alloc] initWithData:[self formDataFromParameters:parameters] encoding:NSASCIIStringEncoding];
 }
 
-@end
-
++ (NSData *)formDataFromParameters:(NSDictionary *)parameters {
+    NSMutableData *data = [NSMutableData data];
+    [self appendFormDataFromParameters:parameters toData:data];
+    return data;
+}
 
-// This code is adapted from https://github.com/AFNetworking/AFNetworking/blob/master/AFNetworking/AFURLRequestSerialization.m . The only modifications are to replace the AF namespace with the STP namespace to avoid collisions with apps that are using both Stripe and AFNetworking.
-NSString * STPPercentEscapedStringFromString(NSString *string) {
-    static NSString * const kSTPCharactersGeneralDelimitersToEncode = @":#[]@"; // does not include "?" or "/" due to RFC 3986 - Section 3.4
-    static NSString * const kSTPCharactersSubDelimitersToEncode = @"!$&'()*+,;=";
-    
-    NSMutableCharacterSet * allowedCharacterSet = [[NSCharacterSet URLQueryAllowedCharacterSet] mutableCopy];
-    [allowedCharacterSet removeCharactersInString:[kSTPCharactersGeneralDelimitersToEncode stringByAppendingString:kSTPCharactersSubDelimitersToEncode]];
-    
-    // FIXME: https://github.com/AFNetworking/AFNetworking/pull/3028
-    // return [string stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacterSet];
-    
-    static NSUInteger const batchSize = 50;
-    
-    NSUInteger index = 0;
-    NSMutableString *escaped = @"".mutableCopy;
-    
-    while (index < string.length) {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wgnu"
-        NSUInteger length = MIN(string.length - index, batchSize);
-#pragma GCC diagnostic pop
-        NSRange range = NSMakeRange(index, length);
-        
-        // To avoid breaking up character sequences such as 👴🏻👮🏽
-        range = [string rangeOfComposedCharacterSequencesForRange:range];
-        
-        NSString *substring = [string substringWithRange:range];
-        NSString *encoded = [substring stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacterSet];
-        [escaped appendString:encoded];
-        
-        index += range.length;
-    }
-    
-    return escaped;
++ (void)appendFormDataFromParameters:(NSDictionary *)parameters toData:(NSMutableData *)data {
+    NSMutableData *escapedKey = [NSMutableData data];
+    BOOL isFirstPair = YES;
+    STPFormEncoderAppendPairs(data, escapedKey, parameters, &isFirstPair);
 }
 
-#pragma mark -
+@end
 
-@interface STPQueryStringPair : NSObject
-@property (readwrite, nonatomic, strong) id field;
-@property (readwrite, nonatomic, strong) id value;
 
-- (instancetype)initWithField:(id)field value:(id)value;
+#pragma mark - Form encoding
 
-- (NSString *)URLEncodedStringValue;
-@end
+/**
+ Size of the stack buffers used while encoding. Output is flushed into the
+ destination data whenever a buffer fills up.
+ */
+#define STPFormEncoderBufferLength ((NSUInteger)256)
 
-@implementation STPQueryStringPair
+static const char STPFormEncoderHexDigits[] = "0123456789ABCDEF";
 
-- (instancetype)initWithField:(id)field value:(id)value {
-    self = [super init];
-    if (!self) {
-        return nil;
-    }
-    
-    _field = field;
-    _value = value;
-    
-    return self;
+/**
+ Lookup table for the ASCII bytes that are left unescaped: the unreserved
+ characters from RFC 3986, plus "/" and "?", which are allowed in query
+ strings (RFC 3986 - Section 3.4). Every other byte is percent-escaped,
+ including the general and sub-delimiters.
+ */
+static const BOOL *STPFormEncoderAllowedBytes(void) {
+    static BOOL allowedBytes[128];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        const char *allowed = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~/?";
+        for (const char *c = allowed; *c != '\0'; c++) {
+            allowedBytes[(uint8_t)*c] = YES;
+        }
+    });
+    return allowedBytes;
 }
 
-- (NSString *)URLEncodedStringValue {
-    if (!self.value || [self.value isEqual:[NSNull null]]) {
-        return STPPercentEscapedStringFromString([self.field description]);
-    } else {
-        return [NSString stringWithFormat:@"%@=%@", STPPercentEscapedStringFromString([self.field description]), STPPercentEscapedStringFromString([self.value description])];
+static void STPFormEncoderAppendEscapedBytes(NSMutableData *data, const uint8_t *bytes, NSUInteger length) {
+    const BOOL *allowedBytes = STPFormEncoderAllowedBytes();
+    uint8_t buffer[STPFormEncoderBufferLength];
+    NSUInteger bufferLength = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        uint8_t byte = bytes[i];
+        if (byte < 128 && allowedBytes[byte]) {
+            buffer[bufferLength++] = byte;
+        } else {
+            buffer[bufferLength++] = '%';
+            buffer[bufferLength++] = (uint8_t)STPFormEncoderHexDigits[byte >> 4];
+            buffer[bufferLength++] = (uint8_t)STPFormEncoderHexDigits[byte & 0x0F];
+        }
+        // Make sure there's always room for one more escaped byte
+        if (bufferLength > STPFormEncoderBufferLength - 3) {
+            [data appendBytes:buffer length:bufferLength];
+            bufferLength = 0;
+        }
     }
+    [data appendBytes:buffer length:bufferLength];
 }
 
-@end
-
-#pragma mark -
-
-FOUNDATION_EXPORT NSArray * STPQueryStringPairsFromDictionary(NSDictionary *dictionary);
-FOUNDATION_EXPORT NSArray * STPQueryStringPairsFromKeyAndValue(NSString *key, id value);
-
-NSString * STPQueryStringFromParameters(NSDictionary *parameters) {
-    NSMutableArray *mutablePairs = [NSMutableArray array];
-    for (STPQueryStringPair *pair in STPQueryStringPairsFromDictionary(parameters)) {
-        [mutablePairs addObject:[pair URLEncodedStringValue]];
+/**
+ Percent-escapes the UTF-8 representation of `string` directly into `data`,
+ converting a buffer's worth of characters at a time.
+ */
+static void STPFormEncoderAppendEscapedString(NSMutableData *data, NSString *string) {
+    uint8_t utf8[STPFormEncoderBufferLength];
+    NSRange remainingRange = NSMakeRange(0, string.length);
+    while (remainingRange.length > 0) {
+        NSUInteger usedLength = 0;
+        BOOL converted = [string getBytes:utf8
+                                maxLength:sizeof(utf8)
+                               usedLength:&usedLength
+                                 encoding:NSUTF8StringEncoding
+                                  options:NSStringEncodingConversionAllowLossy
+                                    range:remainingRange
+                           remainingRange:&remainingRange];
+        if (!converted || usedLength == 0) {
+            break;
+        }
+        STPFormEncoderAppendEscapedBytes(data, utf8, usedLength);
     }
-    
-    return [mutablePairs componentsJoinedByString:@"&"];
 }
 
-NSArray * STPQueryStringPairsFromDictionary(NSDictionary *dictionary) {
-    return STPQueryStringPairsFromKeyAndValue(nil, dictionary);
+static NSArray *STPFormEncoderSortedByDescription(NSArray *objects) {
+    return [objects sortedArrayUsingComparator:^NSComparisonResult(id obj1, id obj2) {
+        return [[obj1 description] compare:[obj2 description]];
+    }];
 }
 
-NSArray * STPQueryStringPairsFromKeyAndValue(NSString *key, id value) {
-    NSMutableArray *mutableQueryStringComponents = [NSMutableArray array];
-    NSString *descriptionSelector = NSStringFromSelector(@selector(description));
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:descriptionSelector ascending:YES selector:@selector(compare:)];
-    
+/**
+ Appends the form-encoded pairs for `value` to `data`. `escapedKey` holds the
+ already-escaped key path leading to `value` (e.g. "card%5Bnumber%5D"); it is
+ extended in place while descending into nested values and restored on the
+ way back out, so nested keys never need intermediate strings.
+
+ Dictionary keys and set members are sorted by description to ensure a
+ consistent ordering in the output, which is important when deserializing
+ potentially ambiguous sequences, such as an array of dictionaries.
+ */
+static void STPFormEncoderAppendPairs(NSMutableData *data, NSMutableData *escapedKey, id value, BOOL *isFirstPair) {
+    NSUInteger keyLength = escapedKey.length;
     if ([value isKindOfClass:[NSDictionary class]]) {
         NSDictionary *dictionary = value;
-        // Sort dictionary keys to ensure consistent ordering in query string, which is important when deserializing potentially ambiguous sequences, such as an array of dictionaries
-        for (id nestedKey in [dictionary.allKeys sortedArrayUsingDescriptors:@[ sortDescriptor ]]) {
-            id nestedValue = dictionary[nestedKey];
-            if (nestedValue) {
-                [mutableQueryStringComponents addObjectsFromArray:STPQueryStringPairsFromKeyAndValue((key ? [NSString stringWithFormat:@"%@[%@]", key, nestedKey] : nestedKey), nestedValue)];
+        for (id nestedKey in STPFormEncoderSortedByDescription(dictionary.allKeys)) {
+            if (keyLength > 0) {
+                [escapedKey appendBytes:"%5B" length:3];
+                STPFormEncoderAppendEscapedString(escapedKey, [nestedKey description]);
+                [escapedKey appendBytes:"%5D" length:3];
+            } else {
+                STPFormEncoderAppendEscapedString(escapedKey, [nestedKey description]);
             }
+            STPFormEncoderAppendPairs(data, escapedKey, dictionary[nestedKey], isFirstPair);
+            escapedKey.length = keyLength;
         }
     } else if ([value isKindOfClass:[NSArray class]]) {
-        NSArray *array = value;
-        for (id nestedValue in array) {
-            [mutableQueryStringComponents addObjectsFromArray:STPQueryStringPairsFromKeyAndValue([NSString stringWithFormat:@"%@[]", key], nestedValue)];
+        [escapedKey appendBytes:"%5B%5D" length:6];
+        for (id nestedValue in (NSArray *)value) {
+            STPFormEncoderAppendPairs(data, escapedKey, nestedValue, isFirstPair);
         }
+        escapedKey.length = keyLength;
     } else if ([value isKindOfClass:[NSSet class]]) {
-        NSSet *set = value;
-        for (id obj in [set sortedArrayUsingDescriptors:@[ sortDescriptor ]]) {
-            [mutableQueryStringComponents addObjectsFromArray:STPQueryStringPairsFromKeyAndValue(key, obj)];
+        for (id nestedValue in STPFormEncoderSortedByDescription([(NSSet *)value allObjects])) {
+            STPFormEncoderAppendPairs(data, escapedKey, nestedValue, isFirstPair);
         }
     } else {
-        [mutableQueryStringComponents addObject:[[STPQueryStringPair alloc] initWithField:key value:value]];
+        if (!*isFirstPair) {
+            [data appendBytes:"&" length:1];
+        }
+        *isFirstPair = NO;
+        [data appendData:escapedKey];
+        if ([value isKindOfClass:[NSData class]]) {
+            // Data values are UTF-8 text, escaped as is without a string copy
+            [data appendBytes:"=" length:1];
+            STPFormEncoderAppendEscapedBytes(data, [(NSData *)value bytes], [(NSData *)value length]);
+        } else if ([value isKindOfClass:[STPCardNumberBuffer class]]) {
+            // Digits need no escaping, and this avoids a string of the number
+            [data appendBytes:"=" length:1];
+            [(STPCardNumberBuffer *)value appendToData:data];
+        } else if (value && ![value isEqual:[NSNull null]]) {
+            [data appendBytes:"=" length:1];
+            STPFormEncoderAppendEscapedString(data, [value description]);
+        }
     }
-    
-    return mutableQueryStringComponents;
 }
@@ -0,0 +1,37 @@
+//
+//  STPFormTextField+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPFormTextField.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface STPFormTextField ()
+
+/**
+ How many of the characters before `offset` in `string` are kept when it's
+ unformatted for `behavior`, i.e. where `offset` ends up in the raw text.
+ */
++ (NSUInteger)unformattedOffsetForOffset:(NSUInteger)offset
+                                inString:(NSString *)string
+                                behavior:(STPFormTextFieldAutoFormattingBehavior)behavior;
+
+/**
+ The inverse of `unformattedOffsetForOffset:inString:behavior:`: the offset in
+ the formatted `string` just after its `unformattedOffset`th raw character,
+ clamped to the end of the string. The caret goes here after an edit, so it
+ stays after the character that was typed however separators move around.
+ */
++ (NSUInteger)offsetForUnformattedOffset:(NSUInteger)unformattedOffset
+                                inString:(NSString *)string
+                                behavior:(STPFormTextFieldAutoFormattingBehavior)behavior;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -7,8 +7,11 @@
 //
 
 #import "STPFormTextField.h"
+#import "STPFormTextField+Private.h"
 
 #import "NSString+Stripe.h"
+#import "STPBINRange.h"
+#import "STPCardNumberDigits.h"
 #import "STPCardValidator.h"
 #import "STPDelegateProxy.h"
 #import "STPPhoneNumberValidator.h"
@@ -27,30 +30,32 @@
 - (BOOL)textField:(UITextField *)textField shouldChangeCharactersInRange:(NSRange)range replacementString:(NSString *)string {
     BOOL deleting = (range.location == textField.text.length - 1 && range.length == 1 && [string isEqualToString:@""]);
     NSString *inputText;
+    // Where the caret belongs after the edit, counted in raw characters so
+    // that it survives reformatting
+    NSUInteger caretOffset;
     if (deleting) {
         NSString *sanitized = [self unformattedStringForString:textField.text];
         inputText = [sanitized stp_safeSubstringToIndex:sanitized.length - 1];
+        caretOffset = inputText.length;
     } else {
         NSString *newString = [textField.text stringByReplacingCharactersInRange:range withString:string];
-        NSString *sanitized = [self unformattedStringForString:newString];
-        inputText = sanitized;
+        inputText = [self unformattedStringForString:newString];
+        caretOffset = [STPFormTextField unformattedOffsetForOffset:range.location + string.length
+                                                          inString:newString
+                                                          behavior:self.autoformattingBehavior];
     }
     
-    UITextPosition *beginning = textField.beginningOfDocument;
-    UITextPosition *start = [textField positionFromPosition:beginning offset:range.location];
-    
     if ([textField.text isEqualToString:inputText]) {
         return NO;
     }
     
     textField.text = inputText;
     
-    if (self.autoformattingBehavior == STPFormTextFieldAutoFormattingBehaviorNone && self.selectionEnabled) {
-        
-        // this will be the new cursor location after insert/paste/typing
-        NSInteger cursorOffset = [textField offsetFromPosition:beginning toPosition:start] + string.length;
-        
-        UITextPosition *newCursorPosition = [textField positionFromPosition:textField.beginningOfDocument offset:cursorOffset];
+    if (self.selectionEnabled) {
+        NSUInteger cursorOffset = [STPFormTextField offsetForUnformattedOffset:caretOffset
+                                                                      inString:textField.text
+                                                                      behavior:self.autoformattingBehavior];
+        UITextPosition *newCursorPosition = [textField positionFromPosition:textField.beginningOfDocument offset:(NSInteger)cursorOffset];
         UITextRange *newSelectedRange = [textField textRangeFromPosition:newCursorPosition toPosition:newCursorPosition];
         [textField setSelectedTextRange:newSelectedRange];
     }
@@ -91,6 +96,53 @@ typedef NSAttributedString* (^STPFormTextTransformationBlock)(NSAttributedString
     [super reloadInputViews];
 }
 
+#pragma mark - Caret mapping
+
+// Whether `c` is kept by unformattedStringForString: for `behavior`
+static inline BOOL STPFormTextFieldKeepsCharacter(unichar c, STPFormTextFieldAutoFormattingBehavior behavior) {
+    return behavior == STPFormTextFieldAutoFormattingBehaviorNone || (c >= '0' && c <= '9');
+}
+
++ (NSUInteger)unformattedOffsetForOffset:(NSUInteger)offset
+                                inString:(NSString *)string
+                                behavior:(STPFormTextFieldAutoFormattingBehavior)behavior {
+    offset = MIN(offset, string.length);
+    if (behavior == STPFormTextFieldAutoFormattingBehaviorNone) {
+        return offset;
+    }
+    NSUInteger count = 0;
+    unichar chunk[32];
+    for (NSUInteger location = 0; location < offset; location += 32) {
+        NSUInteger chunkLength = MIN((NSUInteger)32, offset - location);
+        [string getCharacters:chunk range:NSMakeRange(location, chunkLength)];
+        for (NSUInteger i = 0; i < chunkLength; i++) {
+            count += STPFormTextFieldKeepsCharacter(chunk[i], behavior);
+        }
+    }
+    return count;
+}
+
++ (NSUInteger)offsetForUnformattedOffset:(NSUInteger)unformattedOffset
+                                inString:(NSString *)string
+                                behavior:(STPFormTextFieldAutoFormattingBehavior)behavior {
+    NSUInteger length = string.length;
+    if (behavior == STPFormTextFieldAutoFormattingBehaviorNone || unformattedOffset == 0) {
+        return MIN(unformattedOffset, length);
+    }
+    NSUInteger count = 0;
+    unichar chunk[32];
+    for (NSUInteger location = 0; location < length; location += 32) {
+        NSUInteger chunkLength = MIN((NSUInteger)32, length - location);
+        [string getCharacters:chunk range:NSMakeRange(location, chunkLength)];
+        for (NSUInteger i = 0; i < chunkLength; i++) {
+            if (STPFormTextFieldKeepsCharacter(chunk[i], behavior) && ++count == unformattedOffset) {
+                return location + i + 1;
+            }
+        }
+    }
+    return length;
+}
+
 + (NSDictionary *)attributesForAttributedString:(NSAttributedString *)attributedString {
     if (attributedString.length == 0) {
         return @{};
@@ -116,27 +168,29 @@ typedef NSAttributedString* (^STPFormTextTransformationBlock)(NSAttributedString
             }
 #endif
             break;
-        case STPFormTextFieldAutoFormattingBehaviorCardNumbers:
+        case STPFormTextFieldAutoFormattingBehaviorCardNumbers: {
+            // The brand (and so the digit grouping) only depends on the
+            // leading BIN digits, so only look it up again when they change.
+            __block NSString *brandPrefix = nil;
+            __block STPCardBrand brand = STPCardBrandUnknown;
             self.textFormattingBlock = ^NSAttributedString *(NSAttributedString *inputString) {
                 if (![STPCardValidator stringIsNumeric:inputString.string]) {
                     return [inputString copy];
                 }
-                NSMutableAttributedString *attributedString = [inputString mutableCopy];
-                NSArray *cardSpacing;
-                STPCardBrand currentBrand = [STPCardValidator brandForNumber:attributedString.string];
-                if (currentBrand == STPCardBrandAmex) {
-                    cardSpacing = @[@3, @9];
-                } else {
-                    cardSpacing = @[@3, @7, @11];
+                NSString *prefix = [inputString.string stp_safeSubstringToIndex:STPBINRangeMaxPrefixLength];
+                if (!brandPrefix || ![prefix isEqualToString:brandPrefix]) {
+                    brandPrefix = prefix;
+                    brand = [STPCardValidator brandForNumber:prefix];
                 }
-                for (NSUInteger i = 0; i < attributedString.length; i++) {
-                    if ([cardSpacing containsObject:@(i)]) {
-                        [attributedString addAttribute:NSKernAttributeName value:@(5)
-                                                 range:NSMakeRange(i, 1)];
-                    } else {
-                        [attributedString addAttribute:NSKernAttributeName value:@(0)
-                                                 range:NSMakeRange(i, 1)];
-                    }
+                NSMutableAttributedString *attributedString = [inputString mutableCopy];
+                NSUInteger length = attributedString.length;
+                [attributedString addAttribute:NSKernAttributeName value:@(0)
+                                         range:NSMakeRange(0, length)];
+                const NSUInteger *gaps;
+                NSUInteger gapCount = STPCardNumberGroupEndIndexes(brand, &gaps);
+                for (NSUInteger i = 0; i < gapCount && gaps[i] < length; i++) {
+                    [attributedString addAttribute:NSKernAttributeName value:@(5)
+                                             range:NSMakeRange(gaps[i], 1)];
                 }
                 return [attributedString copy];
             };
@@ -146,6 +200,7 @@ typedef NSAttributedString* (^STPFormTextTransformationBlock)(NSAttributedString
             }
 #endif
             break;
+        }
         case STPFormTextFieldAutoFormattingBehaviorPhoneNumbers: {
             WEAK(self);
             self.textFormattingBlock = ^NSAttributedString *(NSAttributedString *inputString) {
@@ -202,7 +257,11 @@ typedef NSAttributedString* (^STPFormTextTransformationBlock)(NSAttributedString
         [self.formDelegate formTextField:self modifyIncomingTextChange:attributedText] :
         attributedText;
     NSAttributedString *transformed = self.textFormattingBlock ? self.textFormattingBlock(modified) : modified;
-    [super setAttributedText:transformed];
+    // Setting the same text again would only lay the field out again, and
+    // move the caret to the end.
+    if (!oldValue || ![transformed isEqualToAttributedString:oldValue]) {
+        [super setAttributedText:transformed];
+    }
     [self sendActionsForControlEvents:UIControlEventEditingChanged];
     if ([self.formDelegate respondsToSelector:@selector(formTextFieldTextDidChange:)]) {
         if (![transformed isEqualToAttributedString:oldValue]) {
@@ -272,9 +331,17 @@ typedef NSAttributedString* (^STPFormTextTransformationBlock)(NSAttributedString
 }
 
 // Fixes a weird issue related to our custom override of deleteBackwards. This only affects the simulator and iPads with custom keyboards.
+// UIKit asks for these whenever the responder chain changes, so every field
+// shares one array. The action goes to the first responder, whichever field
+// that is.
 - (NSArray *)keyCommands {
     FAUXPAS_IGNORED_IN_METHOD(APIAvailability);
-    return @[[UIKeyCommand keyCommandWithInput:@"\b" modifierFlags:UIKeyModifierCommand action:@selector(commandDeleteBackwards)]];
+    static NSArray<UIKeyCommand *> *STPFormTextFieldKeyCommands;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        STPFormTextFieldKeyCommands = @[[UIKeyCommand keyCommandWithInput:@"\b" modifierFlags:UIKeyModifierCommand action:@selector(commandDeleteBackwards)]];
+    });
+    return STPFormTextFieldKeyCommands;
 }
 
 - (void)commandDeleteBackwards {
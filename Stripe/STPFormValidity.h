@@ -0,0 +1,44 @@
+//
+//  STPFormValidity.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Whether each section of a form is valid, and whether they all are. Each
+ section reports its own validity when it changes, so the form never has to
+ re-check every field to find out, and `changeHandler` only runs when a
+ section's validity actually changed. Sections start out invalid.
+ */
+@interface STPFormValidity : NSObject
+
+/**
+ @param sectionCount The number of sections, at most 64.
+ */
+- (instancetype)initWithSectionCount:(NSUInteger)sectionCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ YES if every section is valid.
+ */
+@property (nonatomic, readonly, getter=isValid) BOOL valid;
+
+/**
+ Called with the section whose validity changed.
+ */
+@property (nonatomic, copy, nullable) void (^changeHandler)(STPFormValidity *validity, NSUInteger section);
+
+- (BOOL)isSectionValid:(NSUInteger)section;
+
+- (void)setValid:(BOOL)valid forSection:(NSUInteger)section;
+
+@end
+
+NS_ASSUME_NONNULL_END
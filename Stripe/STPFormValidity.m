@@ -0,0 +1,51 @@
+//
+//  STPFormValidity.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPFormValidity.h"
+
+@interface STPFormValidity ()
+@property (nonatomic) uint64_t allSections;
+// One bit per section, set while it's valid
+@property (nonatomic) uint64_t validSections;
+@end
+
+@implementation STPFormValidity
+
+- (instancetype)initWithSectionCount:(NSUInteger)sectionCount {
+    NSCAssert(sectionCount <= 64, @"Forms can have at most 64 sections");
+    self = [super init];
+    if (self) {
+        _allSections = sectionCount >= 64 ? UINT64_MAX : (((uint64_t)1 << sectionCount) - 1);
+    }
+    return self;
+}
+
+- (BOOL)isValid {
+    return self.validSections == self.allSections;
+}
+
+- (BOOL)isSectionValid:(NSUInteger)section {
+    return (self.validSections & ((uint64_t)1 << section)) != 0;
+}
+
+- (void)setValid:(BOOL)valid forSection:(NSUInteger)section {
+    NSCAssert(((uint64_t)1 << section) & self.allSections, @"No such section");
+    if ([self isSectionValid:section] == valid) {
+        return;
+    }
+    if (valid) {
+        self.validSections |= (uint64_t)1 << section;
+    } else {
+        self.validSections &= ~((uint64_t)1 << section);
+    }
+    if (self.changeHandler) {
+        self.changeHandler(self, section);
+    }
+}
+
+@end
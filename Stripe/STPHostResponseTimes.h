@@ -0,0 +1,53 @@
+//
+//  STPHostResponseTimes.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A running estimate of how long each host takes to start answering a request,
+ from the time to first byte of recent responses, smoothed the way TCP smooths
+ round trip times (RFC 6298). Requests use it to pick a timeout that fits the
+ network they're on, and to decide when a slow GET is worth sending twice.
+ Safe to use from any thread.
+ */
+@interface STPHostResponseTimes : NSObject
+
++ (instancetype)sharedResponseTimes;
+
+/**
+ Adds a response that took `responseTime` seconds from the request being sent
+ to its first byte arriving. Estimates older than a few minutes are dropped
+ rather than updated, since the device has likely changed networks.
+ */
+- (void)recordResponseTime:(NSTimeInterval)responseTime forHost:(NSString *)host;
+
+/**
+ Adds the time to first byte of the last transaction in `taskMetrics`, if the
+ request got that far.
+ */
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics forHost:(NSString *)host NS_AVAILABLE_IOS(10_0);
+
+/**
+ A timeout for the next request to `host`: a generous multiple of the slowest
+ response expected, but never less than 15 seconds nor more than
+ `defaultTimeout`. `defaultTimeout` is returned until the host has answered.
+ */
+- (NSTimeInterval)timeoutIntervalForHost:(NSString *)host defaultTimeout:(NSTimeInterval)defaultTimeout;
+
+/**
+ How long to wait on a GET to `host` before sending a duplicate: about as long
+ as all but the slowest responses take. 0 until the host has answered, so
+ nothing is duplicated on a guess.
+ */
+- (NSTimeInterval)hedgeDelayForHost:(NSString *)host;
+
+@end
+
+NS_ASSUME_NONNULL_END
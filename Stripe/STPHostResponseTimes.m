@@ -0,0 +1,137 @@
+//
+//  STPHostResponseTimes.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPHostResponseTimes.h"
+
+#import "STPURLSessionPool.h"
+
+// Gains from RFC 6298
+static double const SmoothingGain = 0.125;
+static double const VariationGain = 0.25;
+// The network has probably changed since then
+static CFTimeInterval const EstimateLifetime = 300;
+
+// Timeouts are an idle interval, so they only have to cover a stall
+static double const TimeoutResponseTimes = 10;
+static NSTimeInterval const MinimumTimeout = 15;
+
+static NSTimeInterval const MinimumHedgeDelay = 0.5;
+static NSTimeInterval const MaximumHedgeDelay = 5;
+
+@interface STPHostResponseTimeEstimate : NSObject
+@property (nonatomic) NSTimeInterval smoothedTime;
+@property (nonatomic) NSTimeInterval variation;
+@property (nonatomic) CFAbsoluteTime updated;
+@end
+
+@implementation STPHostResponseTimeEstimate
+@end
+
+@interface STPHostResponseTimes ()
+@property (nonatomic) NSMutableDictionary<NSString *, STPHostResponseTimeEstimate *> *estimates;
+@property (nonatomic) dispatch_queue_t queue;
+@end
+
+@implementation STPHostResponseTimes
+
++ (instancetype)sharedResponseTimes {
+    static id sharedResponseTimes;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ sharedResponseTimes = [[self alloc] init]; });
+    return sharedResponseTimes;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _estimates = [NSMutableDictionary dictionary];
+        _queue = dispatch_queue_create("com.stripe.hostresponsetimes", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)recordResponseTime:(NSTimeInterval)responseTime forHost:(NSString *)host {
+    if (!host || responseTime < 0) {
+        return;
+    }
+    NSString *key = host.lowercaseString;
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    dispatch_sync(self.queue, ^{
+        STPHostResponseTimeEstimate *estimate = [self currentEstimateForKey:key now:now];
+        if (!estimate) {
+            estimate = [STPHostResponseTimeEstimate new];
+            estimate.smoothedTime = responseTime;
+            estimate.variation = responseTime / 2;
+            self.estimates[key] = estimate;
+        } else {
+            estimate.variation = (1 - VariationGain) * estimate.variation + VariationGain * fabs(estimate.smoothedTime - responseTime);
+            estimate.smoothedTime = (1 - SmoothingGain) * estimate.smoothedTime + SmoothingGain * responseTime;
+        }
+        estimate.updated = now;
+    });
+}
+
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics forHost:(NSString *)host {
+    NSURLSessionTaskTransactionMetrics *transaction = STPResponseTransactionMetrics(taskMetrics);
+    if (!transaction.requestStartDate || !transaction.responseStartDate) {
+        return;
+    }
+    [self recordResponseTime:[transaction.responseStartDate timeIntervalSinceDate:transaction.requestStartDate] forHost:host];
+}
+
+- (NSTimeInterval)timeoutIntervalForHost:(NSString *)host defaultTimeout:(NSTimeInterval)defaultTimeout {
+    NSTimeInterval slowResponseTime = [self slowResponseTimeForHost:host];
+    if (slowResponseTime <= 0 || defaultTimeout <= MinimumTimeout) {
+        return defaultTimeout;
+    }
+    return MIN(defaultTimeout, MAX(MinimumTimeout, TimeoutResponseTimes * slowResponseTime));
+}
+
+- (NSTimeInterval)hedgeDelayForHost:(NSString *)host {
+    NSTimeInterval slowResponseTime = [self slowResponseTimeForHost:host];
+    if (slowResponseTime <= 0) {
+        return 0;
+    }
+    return MIN(MaximumHedgeDelay, MAX(MinimumHedgeDelay, slowResponseTime));
+}
+
+#pragma mark - Private
+
+/**
+ The smoothed time plus four times its variation, like TCP's retransmission
+ timeout. 0 without a current estimate.
+ */
+- (NSTimeInterval)slowResponseTimeForHost:(NSString *)host {
+    if (!host) {
+        return 0;
+    }
+    NSString *key = host.lowercaseString;
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    __block NSTimeInterval slowResponseTime = 0;
+    dispatch_sync(self.queue, ^{
+        STPHostResponseTimeEstimate *estimate = [self currentEstimateForKey:key now:now];
+        if (estimate) {
+            slowResponseTime = estimate.smoothedTime + 4 * estimate.variation;
+        }
+    });
+    return slowResponseTime;
+}
+
+/**
+ Only called on `queue`.
+ */
+- (STPHostResponseTimeEstimate *)currentEstimateForKey:(NSString *)key now:(CFAbsoluteTime)now {
+    STPHostResponseTimeEstimate *estimate = self.estimates[key];
+    if (estimate && now - estimate.updated > EstimateLifetime) {
+        [self.estimates removeObjectForKey:key];
+        return nil;
+    }
+    return estimate;
+}
+
+@end
@@ -0,0 +1,36 @@
+//
+//  STPImageAtlasData.h
+//  Stripe
+//
+//  Generated by ci_scripts/generate_brand_atlas.rb from Stripe/BrandImages.
+//  Do not edit.
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+
+static NSString * const STPImageAtlasName = @"stp_card_brands";
+
+/**
+ Where an image is in the atlas, in points.
+ */
+typedef struct {
+    const char *name;
+    CGRect frame;
+} STPImageAtlasEntry;
+
+// Sorted by name
+static const STPImageAtlasEntry STPImageAtlasEntries[] = {
+    {"stp_card_amex", {{0, 0}, {32, 20}}},
+    {"stp_card_amex_template", {{0, 20}, {26, 18}}},
+    {"stp_card_diners", {{0, 38}, {32, 20}}},
+    {"stp_card_diners_template", {{0, 58}, {26, 18}}},
+    {"stp_card_discover", {{0, 76}, {32, 20}}},
+    {"stp_card_discover_template", {{0, 96}, {26, 18}}},
+    {"stp_card_jcb", {{0, 114}, {32, 20}}},
+    {"stp_card_jcb_template", {{0, 134}, {26, 18}}},
+    {"stp_card_mastercard", {{0, 152}, {32, 20}}},
+    {"stp_card_mastercard_template", {{0, 172}, {26, 18}}},
+    {"stp_card_placeholder_template", {{0, 190}, {32, 20}}},
+    {"stp_card_visa", {{0, 210}, {32, 20}}},
+    {"stp_card_visa_template", {{0, 230}, {26, 18}}},
+};
@@ -30,6 +30,33 @@ NS_ASSUME_NONNULL_BEGIN
 + (UIImage *)paddedImageWithInsets:(UIEdgeInsets)insets
                           forImage:(UIImage *)image;
 
+/**
+ Loads every brand and CVC image into the image cache on a background queue,
+ so the card field's brand swaps never hit the bundle. Safe to call repeatedly.
+ */
++ (void)warmBrandImageCache;
+
+/**
+ Synchronously loads and decodes the brand, CVC and card form images into the
+ image cache. Does not need to be called on the main thread.
+ */
++ (void)preloadImages;
+
+/**
+ The copy of `image` decoded at `scale` by `prepareThumbnailsForImages:scale:completion:`,
+ or nil if it hasn't been drawn yet.
+ */
++ (nullable UIImage *)thumbnailForImage:(UIImage *)image scale:(CGFloat)scale;
+
+/**
+ Draws each image into a bitmap at `scale` on a background queue, once per
+ image and scale, so table cells can show them without decoding on the main
+ thread. `completion` is called on the main queue once they're all ready.
+ */
++ (void)prepareThumbnailsForImages:(NSArray<UIImage *> *)images
+                             scale:(CGFloat)scale
+                        completion:(nullable void (^)(void))completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -8,8 +8,13 @@
 
 #import "STPImageLibrary.h"
 
+#import <objc/runtime.h>
+
 #import "STPBundleLocator.h"
+#import "STPImageAtlasData.h"
 #import "STPImageLibrary+Private.h"
+#import "STPMemoryAccounting.h"
+#import "STPPerformanceCounters.h"
 
 #define FAUXPAS_IGNORED_IN_METHOD(...)
 
@@ -69,8 +74,120 @@
 
 @end
 
+static const char STPImageLibraryVariantCacheKey;
+
+static int STPImageAtlasEntryCompare(const void *key, const void *entry) {
+    return strcmp(key, ((const STPImageAtlasEntry *)entry)->name);
+}
+
 @implementation STPImageLibrary (Private)
 
++ (NSCache<NSString *, UIImage *> *)namedImageCache {
+    static NSCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [NSCache new];
+        cache.name = @"com.stripe.imageLibrary";
+    });
+    return cache;
+}
+
+/**
+ Rendered variants (tinted, padded) are cached on the source image itself, so
+ they live exactly as long as the image they were drawn from.
+ */
++ (NSCache<NSString *, UIImage *> *)variantCacheForImage:(UIImage *)image {
+    @synchronized (image) {
+        NSCache *cache = objc_getAssociatedObject(image, &STPImageLibraryVariantCacheKey);
+        if (!cache) {
+            cache = [NSCache new];
+            objc_setAssociatedObject(image, &STPImageLibraryVariantCacheKey, cache, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        }
+        return cache;
+    }
+}
+
++ (void)warmBrandImageCache {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+            [self preloadImages];
+        });
+    });
+}
+
++ (void)preloadImages {
+    NSArray<NSNumber *> *brands = @[@(STPCardBrandVisa),
+                                    @(STPCardBrandAmex),
+                                    @(STPCardBrandMasterCard),
+                                    @(STPCardBrandDiscover),
+                                    @(STPCardBrandJCB),
+                                    @(STPCardBrandDinersClub),
+                                    @(STPCardBrandUnknown)];
+    NSMutableArray<UIImage *> *images = [NSMutableArray array];
+    void (^addImage)(UIImage *) = ^(UIImage *image) {
+        // A resource missing from the bundle just isn't preloaded
+        if (image) {
+            [images addObject:image];
+        }
+    };
+    for (NSNumber *brand in brands) {
+        addImage([self brandImageForCardBrand:brand.integerValue template:NO]);
+        addImage([self brandImageForCardBrand:brand.integerValue template:YES]);
+        addImage([self cvcImageForCardBrand:brand.integerValue]);
+    }
+    addImage([self largeCardFrontImage]);
+    addImage([self largeCardBackImage]);
+    addImage([self leftChevronIcon]);
+    addImage([self checkmarkIcon]);
+    // Drawing each image once forces its bitmap to be decoded now rather than
+    // on the first main thread render.
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(1, 1), NO, 1);
+    for (UIImage *image in images) {
+        [image drawAtPoint:CGPointZero];
+    }
+    UIGraphicsEndImageContext();
+}
+
++ (NSString *)thumbnailCacheKeyForScale:(CGFloat)scale {
+    return [NSString stringWithFormat:@"thumbnail|%.1f", (double)scale];
+}
+
++ (UIImage *)thumbnailForImage:(UIImage *)image scale:(CGFloat)scale {
+    return [[self variantCacheForImage:image] objectForKey:[self thumbnailCacheKeyForScale:scale]];
+}
+
++ (void)prepareThumbnailsForImages:(NSArray<UIImage *> *)images
+                             scale:(CGFloat)scale
+                        completion:(void (^)(void))completion {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.imageLibrary.thumbnails", DISPATCH_QUEUE_SERIAL);
+    });
+    dispatch_async(queue, ^{
+        NSString *cacheKey = [self thumbnailCacheKeyForScale:scale];
+        for (UIImage *image in images) {
+            NSCache *variants = [self variantCacheForImage:image];
+            if ([variants objectForKey:cacheKey]) {
+                continue;
+            }
+            UIGraphicsBeginImageContextWithOptions(image.size, NO, scale);
+            [image drawAtPoint:CGPointZero];
+            UIImage *thumbnail = UIGraphicsGetImageFromCurrentImageContext();
+            UIGraphicsEndImageContext();
+            thumbnail = [thumbnail imageWithRenderingMode:image.renderingMode];
+            if (thumbnail) {
+                [variants setObject:thumbnail forKey:cacheKey];
+                [STPMemoryAccounting trackObject:thumbnail category:STPMemoryCategoryImages];
+            }
+        }
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), completion);
+        }
+    });
+}
+
 + (UIImage *)addIcon {
     return [self safeImageNamed:@"stp_icon_add" templateIfAvailable:YES];
 }
@@ -101,17 +218,85 @@
 
 + (UIImage *)safeImageNamed:(NSString *)imageName
         templateIfAvailable:(BOOL)templateIfAvailable {
+    NSString *cacheKey = [NSString stringWithFormat:@"%@|%d", imageName, templateIfAvailable];
+    UIImage *image = [[self namedImageCache] objectForKey:cacheKey];
+    if (image) {
+        STPPerformanceCounterIncrement(STPPerformanceCounterImageCacheHits);
+        return image;
+    }
+    STPPerformanceCounterIncrement(STPPerformanceCounterImageCacheMisses);
+    image = [self atlasImageNamed:imageName] ?: [self bundledImageNamed:imageName];
+    if (templateIfAvailable) {
+        image = [image imageWithRenderingMode:UIImageRenderingModeAlwaysTemplate];
+    }
+    if (image) {
+        [[self namedImageCache] setObject:image forKey:cacheKey];
+        [STPMemoryAccounting trackObject:image category:STPMemoryCategoryImages];
+    }
+    return image;
+}
+
++ (nullable UIImage *)bundledImageNamed:(NSString *)imageName {
     FAUXPAS_IGNORED_IN_METHOD(APIAvailability);
-    UIImage *image = nil;
+    UIImage *image;
     if ([UIImage respondsToSelector:@selector(imageNamed:inBundle:compatibleWithTraitCollection:)]) {
         image = [UIImage imageNamed:imageName inBundle:[STPBundleLocator stripeResourcesBundle] compatibleWithTraitCollection:nil];
     }
     if (image == nil) {
         image = [UIImage imageNamed:imageName];
     }
-    if (templateIfAvailable) {
-        image = [image imageWithRenderingMode:UIImageRenderingModeAlwaysTemplate];
+    return image;
+}
+
+/**
+ The brand images are packed into one atlas per scale by
+ ci_scripts/generate_brand_atlas.rb. The atlas is drawn into a bitmap once,
+ the first time any of them is needed, and every brand image is cut out of
+ that bitmap, so they all share a single decode.
+ */
++ (nullable UIImage *)decodedAtlas {
+    static UIImage *decodedAtlas;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        UIImage *atlas = [self bundledImageNamed:STPImageAtlasName];
+        if (!atlas) {
+            return;
+        }
+        UIGraphicsBeginImageContextWithOptions(atlas.size, NO, atlas.scale);
+        [atlas drawAtPoint:CGPointZero];
+        decodedAtlas = UIGraphicsGetImageFromCurrentImageContext();
+        UIGraphicsEndImageContext();
+        if (decodedAtlas) {
+            [STPMemoryAccounting trackObject:decodedAtlas category:STPMemoryCategoryImages];
+        }
+    });
+    return decodedAtlas;
+}
+
++ (nullable UIImage *)atlasImageNamed:(NSString *)imageName {
+    const STPImageAtlasEntry *entry = bsearch(imageName.UTF8String,
+                                              STPImageAtlasEntries,
+                                              sizeof(STPImageAtlasEntries) / sizeof(STPImageAtlasEntries[0]),
+                                              sizeof(STPImageAtlasEntry),
+                                              STPImageAtlasEntryCompare);
+    if (!entry) {
+        return nil;
+    }
+    UIImage *atlas = [self decodedAtlas];
+    if (!atlas) {
+        return nil;
     }
+    CGFloat scale = atlas.scale;
+    CGRect frame = CGRectMake(entry->frame.origin.x * scale,
+                              entry->frame.origin.y * scale,
+                              entry->frame.size.width * scale,
+                              entry->frame.size.height * scale);
+    CGImageRef cgImage = CGImageCreateWithImageInRect(atlas.CGImage, frame);
+    if (!cgImage) {
+        return nil;
+    }
+    UIImage *image = [UIImage imageWithCGImage:cgImage scale:scale orientation:UIImageOrientationUp];
+    CGImageRelease(cgImage);
     return image;
 }
 
@@ -151,18 +336,33 @@
 
 + (UIImage *)imageWithTintColor:(UIColor *)color
                        forImage:(UIImage *)image {
-    UIImage *newImage;
+    NSCache *variants = [self variantCacheForImage:image];
+    NSString *cacheKey = [NSString stringWithFormat:@"tint|%@", color];
+    UIImage *newImage = [variants objectForKey:cacheKey];
+    if (newImage) {
+        return newImage;
+    }
     UIGraphicsBeginImageContextWithOptions(image.size, NO, image.scale);
     [color set];
     UIImage *templateImage = [image imageWithRenderingMode:UIImageRenderingModeAlwaysTemplate];
     [templateImage drawInRect:CGRectMake(0, 0, templateImage.size.width, templateImage.size.height)];
     newImage = UIGraphicsGetImageFromCurrentImageContext();
     UIGraphicsEndImageContext();
+    if (newImage) {
+        [variants setObject:newImage forKey:cacheKey];
+        [STPMemoryAccounting trackObject:newImage category:STPMemoryCategoryImages];
+    }
     return newImage;
 }
 
 + (UIImage *)paddedImageWithInsets:(UIEdgeInsets)insets
                           forImage:(UIImage *)image {
+    NSCache *variants = [self variantCacheForImage:image];
+    NSString *cacheKey = [NSString stringWithFormat:@"insets|%@", NSStringFromUIEdgeInsets(insets)];
+    UIImage *cachedImage = [variants objectForKey:cacheKey];
+    if (cachedImage) {
+        return cachedImage;
+    }
     CGSize size = CGSizeMake(image.size.width + insets.left + insets.right,
                              image.size.height + insets.top + insets.bottom);
     UIGraphicsBeginImageContextWithOptions(size, NO, image.scale);
@@ -171,6 +371,10 @@
     UIImage *imageWithInsets = UIGraphicsGetImageFromCurrentImageContext();
     UIGraphicsEndImageContext();
     imageWithInsets = [imageWithInsets imageWithRenderingMode:image.renderingMode];
+    if (imageWithInsets) {
+        [variants setObject:imageWithInsets forKey:cacheKey];
+        [STPMemoryAccounting trackObject:imageWithInsets category:STPMemoryCategoryImages];
+    }
     return imageWithInsets;
 }
 
@@ -16,6 +16,19 @@
  */
 + (nonnull NSString *)localizedStripeStringForKey:(nonnull NSString *)key;
 
+/**
+ Switches the Stripe strings to the given lproj name (e.g. @"de") without
+ relaunching, or back to the automatically chosen language if nil. Views
+ that are already on screen keep the strings they were configured with.
+ */
++ (void)overrideLanguageTo:(nullable NSString *)language;
+
+/**
+ The current locale, but in the language the Stripe strings are shown in,
+ for formatting and display names that appear next to those strings.
+ */
++ (nonnull NSLocale *)localizedStripeStringsLocale;
+
 @end
 
 static inline NSString * _Nonnull STPLocalizedString(NSString* _Nonnull key, NSString * _Nullable __unused comment) {
@@ -9,42 +9,115 @@
 #import "STPLocalizationUtils.h"
 #import "STPBundleLocator.h"
 
-@implementation STPLocalizationUtils
+static NSString *const STPLocalizationStringTableName = @"Localizable";
 
-+ (NSString *)localizedStripeStringForKey:(NSString *)key {
+static NSString *STPLocalizationLanguageOverride;
+static NSBundle *STPLocalizationBundle;
+static NSString *STPLocalizationLanguage;
+static NSDictionary<NSString *, NSString *> *STPLocalizationStringTable;
 
-    /**
-     If the main app has a localization that we do not support, we want to switch
-     to pulling strings from the main bundle instead of our own bundle so that
-     users can add translations for our strings without having to fork the sdk.
-     
-     At launch, NSBundles' store what language(s) the user requests that they
-     actually have translations for in `preferredLocalizations`. 
-     
-     We compare our framework's resource bundle to the main app's bundle, and
-     if their language choice doesn't match up we switch to pulling strings
-     from the main bundle instead.
-     
-     This also prevents language mismatches. E.g. the user lists portuguese and
-     then spanish as their preferred languages. The main app supports both so all its
-     strings are in pt, but we support spanish so our bundle marks es as our
-     preferred language and our strings are in es.
-     */
-    
-    static BOOL useMainBundle = NO;
-    
+@implementation STPLocalizationUtils
+
++ (dispatch_queue_t)stringTableQueue {
+    static dispatch_queue_t queue;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        if (![[STPBundleLocator stripeResourcesBundle].preferredLocalizations.firstObject isEqualToString:[NSBundle mainBundle].preferredLocalizations.firstObject]) {
-            useMainBundle = YES;
+        queue = dispatch_queue_create("com.stripe.localization", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
++ (NSString *)localizedStripeStringForKey:(NSString *)key {
+    __block NSString *translation;
+    __block NSBundle *bundle;
+    dispatch_sync([self stringTableQueue], ^{
+        if (!STPLocalizationStringTable) {
+            [self loadStringTable];
+        }
+        translation = STPLocalizationStringTable[key];
+        bundle = STPLocalizationBundle;
+    });
+    if (translation) {
+        return translation;
+    }
+    // Not in the table we preloaded (e.g. a key only the main app translates).
+    return [bundle localizedStringForKey:key value:nil table:nil];
+}
+
++ (void)overrideLanguageTo:(NSString *)language {
+    dispatch_sync([self stringTableQueue], ^{
+        STPLocalizationLanguageOverride = [language copy];
+        STPLocalizationStringTable = nil;
+        STPLocalizationBundle = nil;
+        STPLocalizationLanguage = nil;
+    });
+}
+
++ (NSLocale *)localizedStripeStringsLocale {
+    __block NSString *language;
+    dispatch_sync([self stringTableQueue], ^{
+        if (!STPLocalizationStringTable) {
+            [self loadStringTable];
         }
+        language = STPLocalizationLanguage;
     });
-    
-    NSBundle *bundle = useMainBundle ? [NSBundle mainBundle] : [STPBundleLocator stripeResourcesBundle];
+    NSLocale *locale = [NSLocale currentLocale];
+    if (language.length == 0 || [language isEqualToString:@"Base"]) {
+        return locale;
+    }
+    NSMutableDictionary *components = [[NSLocale componentsFromLocaleIdentifier:language] mutableCopy];
+    NSString *countryCode = [locale objectForKey:NSLocaleCountryCode];
+    if (countryCode && !components[NSLocaleCountryCode]) {
+        components[NSLocaleCountryCode] = countryCode;
+    }
+    return [NSLocale localeWithLocaleIdentifier:[NSLocale localeIdentifierFromComponents:components]];
+}
+
+/**
+ Must be called on stringTableQueue.
+ */
++ (void)loadStringTable {
+    NSBundle *stripeBundle = [STPBundleLocator stripeResourcesBundle];
+    NSBundle *bundle;
+    NSString *localization;
+    if (STPLocalizationLanguageOverride) {
+        bundle = stripeBundle;
+        localization = STPLocalizationLanguageOverride;
+        NSString *lprojPath = [stripeBundle pathForResource:localization ofType:@"lproj"];
+        NSBundle *lprojBundle = lprojPath ? [NSBundle bundleWithPath:lprojPath] : nil;
+        STPLocalizationBundle = lprojBundle ?: stripeBundle;
+    } else {
+        /**
+         If the main app has a localization that we do not support, we want to switch
+         to pulling strings from the main bundle instead of our own bundle so that
+         users can add translations for our strings without having to fork the sdk.
+
+         At launch, NSBundles' store what language(s) the user requests that they
+         actually have translations for in `preferredLocalizations`.
+
+         We compare our framework's resource bundle to the main app's bundle, and
+         if their language choice doesn't match up we switch to pulling strings
+         from the main bundle instead.
+
+         This also prevents language mismatches. E.g. the user lists portuguese and
+         then spanish as their preferred languages. The main app supports both so all its
+         strings are in pt, but we support spanish so our bundle marks es as our
+         preferred language and our strings are in es.
+         */
+        NSString *mainLocalization = [NSBundle mainBundle].preferredLocalizations.firstObject;
+        BOOL useMainBundle = ![stripeBundle.preferredLocalizations.firstObject isEqualToString:mainLocalization];
+        bundle = useMainBundle ? [NSBundle mainBundle] : stripeBundle;
+        localization = bundle.preferredLocalizations.firstObject;
+        STPLocalizationBundle = bundle;
+    }
 
-    NSString *translation = [bundle localizedStringForKey:key value:nil table:nil];
-    
-    return translation;
+    NSString *path = [bundle pathForResource:STPLocalizationStringTableName
+                                      ofType:@"strings"
+                                 inDirectory:nil
+                             forLocalization:localization];
+    NSDictionary *table = path ? [NSDictionary dictionaryWithContentsOfFile:path] : nil;
+    STPLocalizationStringTable = [table copy] ?: @{};
+    STPLocalizationLanguage = [localization copy];
 }
 
 @end
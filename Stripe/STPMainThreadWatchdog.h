@@ -0,0 +1,92 @@
+//
+//  STPMainThreadWatchdog.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <stdatomic.h>
+
+@protocol STPMainThreadWatchdogDelegate;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Set while the watchdog has a delegate or, in Debug builds, an observer. Read
+ with a relaxed load on every measurement, so that measuring costs nothing
+ more while it's off.
+ */
+FOUNDATION_EXPORT _Atomic(bool) STPMainThreadWatchdogEnabled;
+
+#if DEBUG
+/**
+ How many measurements are under way, so that the duration observer doesn't
+ count work measured inside other measured work twice. Only touched on the
+ main thread.
+ */
+FOUNDATION_EXPORT NSUInteger STPMainThreadWatchdogDepth;
+#endif
+
+/**
+ Reports SDK work on the main thread that takes longer than a budget, e.g.
+ main queue callbacks and view controller setup, to the delegate set with
+ `+[Stripe setMainThreadWatchdogDelegate:budget:]`. Work is labelled with the
+ method it ran in, or for blocks with the symbol of the block's code, e.g.
+ `__41-[STPPaymentContext didAppear]_block_invoke`.
+ */
+@interface STPMainThreadWatchdog : NSObject
+
++ (void)setDelegate:(nullable id<STPMainThreadWatchdogDelegate>)delegate budget:(NSTimeInterval)budget;
+
+#if DEBUG
+/**
+ Called on the main thread with the duration of all measured work, whatever
+ the budget, for the performance HUD. Work measured inside other measured work
+ is only counted as part of it.
+ */
++ (void)setDurationObserver:(nullable void (^)(NSTimeInterval duration))observer;
+#endif
+
+/**
+ Called on the main thread after work that took `duration`. Reports it if it
+ went over budget.
+ */
++ (void)recordDuration:(NSTimeInterval)duration label:(NSString *(^)(void))label;
+
+@end
+
+/**
+ When to start measuring, or 0 if the watchdog is off or this isn't the main
+ thread.
+ */
+static inline CFAbsoluteTime STPMainThreadWatchdogBegin(void) {
+    if (!atomic_load_explicit(&STPMainThreadWatchdogEnabled, memory_order_relaxed) || ![NSThread isMainThread]) {
+        return 0;
+    }
+#if DEBUG
+    STPMainThreadWatchdogDepth++;
+#endif
+    return CFAbsoluteTimeGetCurrent();
+}
+
+/**
+ Finishes measuring work begun with `STPMainThreadWatchdogBegin`, labelled as
+ `selector` of `object`'s class.
+ */
+FOUNDATION_EXPORT void STPMainThreadWatchdogEnd(CFAbsoluteTime start, id object, SEL selector);
+
+/**
+ Finishes measuring work begun with `STPMainThreadWatchdogBegin`, labelled
+ with the symbol of `block`'s code.
+ */
+FOUNDATION_EXPORT void STPMainThreadWatchdogEndBlock(CFAbsoluteTime start, id block);
+
+/**
+ Runs `block`, measuring it if it runs on the main thread.
+ */
+FOUNDATION_EXPORT void STPMainThreadWatchdogRun(dispatch_block_t block);
+
+NS_ASSUME_NONNULL_END
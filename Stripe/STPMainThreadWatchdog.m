@@ -0,0 +1,125 @@
+//
+//  STPMainThreadWatchdog.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPMainThreadWatchdog.h"
+
+#import "STPAPIClient.h"
+
+#import <dlfcn.h>
+
+_Atomic(bool) STPMainThreadWatchdogEnabled;
+#if DEBUG
+NSUInteger STPMainThreadWatchdogDepth;
+#endif
+
+// The start of every block object, from the Clang block ABI
+struct STPBlockLiteral {
+    void *isa;
+    int flags;
+    int reserved;
+    void (*invoke)(void *, ...);
+};
+
+static NSString *STPLabelForBlock(id block) {
+    struct STPBlockLiteral *literal = (__bridge struct STPBlockLiteral *)block;
+    Dl_info info;
+    if (dladdr((const void *)literal->invoke, &info) && info.dli_sname) {
+        return @(info.dli_sname);
+    }
+    return [NSString stringWithFormat:@"block at %p", (const void *)literal->invoke];
+}
+
+@implementation STPMainThreadWatchdog
+
+static __weak id<STPMainThreadWatchdogDelegate> CurrentDelegate;
+static NSTimeInterval CurrentBudget;
+#if DEBUG
+static void (^CurrentObserver)(NSTimeInterval);
+#endif
+
+// Called while synchronized
++ (void)updateEnabled {
+    bool enabled = CurrentDelegate != nil;
+#if DEBUG
+    enabled = enabled || CurrentObserver != nil;
+#endif
+    atomic_store_explicit(&STPMainThreadWatchdogEnabled, enabled, memory_order_relaxed);
+}
+
++ (void)setDelegate:(id<STPMainThreadWatchdogDelegate>)delegate budget:(NSTimeInterval)budget {
+    @synchronized(self) {
+        CurrentDelegate = delegate;
+        CurrentBudget = MAX(budget, 0);
+        [self updateEnabled];
+    }
+}
+
+#if DEBUG
++ (void)setDurationObserver:(void (^)(NSTimeInterval))observer {
+    @synchronized(self) {
+        CurrentObserver = [observer copy];
+        [self updateEnabled];
+    }
+}
+#endif
+
++ (void)recordDuration:(NSTimeInterval)duration label:(NSString *(^)(void))label {
+    id<STPMainThreadWatchdogDelegate> delegate;
+#if DEBUG
+    void (^observer)(NSTimeInterval) = nil;
+#endif
+    @synchronized(self) {
+        delegate = duration > CurrentBudget ? CurrentDelegate : nil;
+#if DEBUG
+        if (STPMainThreadWatchdogDepth == 0) {
+            observer = CurrentObserver;
+        }
+#endif
+    }
+#if DEBUG
+    if (observer) {
+        observer(duration);
+    }
+#endif
+    // Labels are only worked out for the work that's reported
+    if (delegate) {
+        [delegate mainThreadWatchdogDidObserveWork:label() duration:duration];
+    }
+}
+
+@end
+
+void STPMainThreadWatchdogEnd(CFAbsoluteTime start, id object, SEL selector) {
+    if (start == 0) {
+        return;
+    }
+#if DEBUG
+    STPMainThreadWatchdogDepth--;
+#endif
+    [STPMainThreadWatchdog recordDuration:CFAbsoluteTimeGetCurrent() - start label:^{
+        return [NSString stringWithFormat:@"-[%@ %@]", NSStringFromClass([object class]), NSStringFromSelector(selector)];
+    }];
+}
+
+void STPMainThreadWatchdogEndBlock(CFAbsoluteTime start, id block) {
+    if (start == 0) {
+        return;
+    }
+#if DEBUG
+    STPMainThreadWatchdogDepth--;
+#endif
+    [STPMainThreadWatchdog recordDuration:CFAbsoluteTimeGetCurrent() - start label:^{
+        return STPLabelForBlock(block);
+    }];
+}
+
+void STPMainThreadWatchdogRun(dispatch_block_t block) {
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
+    block();
+    STPMainThreadWatchdogEndBlock(start, block);
+}
@@ -0,0 +1,69 @@
+//
+//  STPMemoryAccounting.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+FOUNDATION_EXPORT NSString *const STPMemoryCategoryViewControllers;
+FOUNDATION_EXPORT NSString *const STPMemoryCategoryImages;
+FOUNDATION_EXPORT NSString *const STPMemoryCategoryURLSessions;
+FOUNDATION_EXPORT NSString *const STPMemoryCategorySourcePollers;
+FOUNDATION_EXPORT NSString *const STPMemoryCategoryCheckoutClients;
+
+/**
+ What the SDK was holding on to at one moment.
+ */
+@interface STPMemorySnapshot : NSObject
+
+/**
+ The process's physical footprint in bytes, as reported by the kernel. This is
+ the number the system uses to decide when to terminate an app.
+ */
+@property (nonatomic, readonly) uint64_t footprint;
+
+/**
+ Decoded bitmap size, in bytes, of the tracked images that are still alive.
+ */
+@property (nonatomic, readonly) uint64_t imageBytes;
+
+/**
+ Live tracked objects, by category.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *liveObjectCounts;
+
+- (NSUInteger)liveCountForCategory:(NSString *)category;
+
+@end
+
+/**
+ Counts the SDK objects that account for most of its memory, so tests can
+ check what a screen costs and that it's all released afterwards. Objects are
+ tracked weakly. Tracking is off by default and costs a single atomic load per
+ call while it's off.
+ */
+@interface STPMemoryAccounting : NSObject
+
++ (void)setEnabled:(BOOL)enabled;
++ (BOOL)isEnabled;
+
+/**
+ Counts `object` under `category` for as long as it's alive.
+ */
++ (void)trackObject:(id)object category:(NSString *)category;
+
+/**
+ The process's current physical footprint in bytes.
+ */
++ (uint64_t)currentFootprint;
+
++ (STPMemorySnapshot *)snapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,131 @@
+//
+//  STPMemoryAccounting.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPMemoryAccounting.h"
+
+#import <UIKit/UIKit.h>
+#import <mach/mach.h>
+#import <stdatomic.h>
+
+NSString *const STPMemoryCategoryViewControllers = @"view controllers";
+NSString *const STPMemoryCategoryImages = @"images";
+NSString *const STPMemoryCategoryURLSessions = @"URL sessions";
+NSString *const STPMemoryCategorySourcePollers = @"source pollers";
+NSString *const STPMemoryCategoryCheckoutClients = @"checkout clients";
+
+static atomic_bool STPMemoryAccountingEnabled;
+
+@interface STPMemorySnapshot ()
+
+@property (nonatomic, readwrite) uint64_t footprint;
+@property (nonatomic, readwrite) uint64_t imageBytes;
+@property (nonatomic, readwrite) NSDictionary<NSString *, NSNumber *> *liveObjectCounts;
+
+@end
+
+@implementation STPMemorySnapshot
+
+- (NSUInteger)liveCountForCategory:(NSString *)category {
+    return self.liveObjectCounts[category].unsignedIntegerValue;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; footprint = %.1f MB; images = %.1f MB; live = %@>",
+            NSStringFromClass([self class]), self,
+            self.footprint / (1024.0 * 1024.0), self.imageBytes / (1024.0 * 1024.0),
+            self.liveObjectCounts];
+}
+
+@end
+
+@implementation STPMemoryAccounting
+
++ (dispatch_queue_t)queue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.memoryaccounting", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// Only touched on +queue
++ (NSMutableDictionary<NSString *, NSHashTable *> *)trackedObjects {
+    static NSMutableDictionary *trackedObjects;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        trackedObjects = [NSMutableDictionary dictionary];
+    });
+    return trackedObjects;
+}
+
++ (void)setEnabled:(BOOL)enabled {
+    atomic_store(&STPMemoryAccountingEnabled, enabled);
+}
+
++ (BOOL)isEnabled {
+    return atomic_load_explicit(&STPMemoryAccountingEnabled, memory_order_relaxed);
+}
+
++ (void)trackObject:(id)object category:(NSString *)category {
+    if (!object || ![self isEnabled]) {
+        return;
+    }
+    dispatch_sync([self queue], ^{
+        NSMutableDictionary<NSString *, NSHashTable *> *trackedObjects = [self trackedObjects];
+        NSHashTable *objects = trackedObjects[category];
+        if (!objects) {
+            objects = [NSHashTable weakObjectsHashTable];
+            trackedObjects[category] = objects;
+        }
+        [objects addObject:object];
+    });
+}
+
++ (uint64_t)currentFootprint {
+    task_vm_info_data_t vmInfo;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&vmInfo, &count) == KERN_SUCCESS
+        && count >= TASK_VM_INFO_REV1_COUNT) {
+        return vmInfo.phys_footprint;
+    }
+    // Older kernels don't report a footprint
+    mach_task_basic_info_data_t basicInfo;
+    count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&basicInfo, &count) == KERN_SUCCESS) {
+        return basicInfo.resident_size;
+    }
+    return 0;
+}
+
++ (STPMemorySnapshot *)snapshot {
+    STPMemorySnapshot *snapshot = [STPMemorySnapshot new];
+    snapshot.footprint = [self currentFootprint];
+    __block NSDictionary *counts;
+    __block NSArray<UIImage *> *images;
+    dispatch_sync([self queue], ^{
+        NSMutableDictionary *liveCounts = [NSMutableDictionary dictionary];
+        [[self trackedObjects] enumerateKeysAndObjectsUsingBlock:^(NSString *category, NSHashTable *objects, __unused BOOL *stop) {
+            liveCounts[category] = @(objects.allObjects.count);
+        }];
+        counts = [liveCounts copy];
+        images = [self trackedObjects][STPMemoryCategoryImages].allObjects;
+    });
+    uint64_t imageBytes = 0;
+    for (UIImage *image in images) {
+        CGImageRef cgImage = image.CGImage;
+        if (cgImage) {
+            imageBytes += (uint64_t)CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+        }
+    }
+    snapshot.liveObjectCounts = counts;
+    snapshot.imageBytes = imageBytes;
+    return snapshot;
+}
+
+@end
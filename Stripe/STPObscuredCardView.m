@@ -11,76 +11,70 @@
 #import "STPImageLibrary+Private.h"
 #import "STPImageLibrary.h"
 #import "STPLocalizationUtils.h"
+#import "STPTheme+Private.h"
 
-@interface STPObscuredCardView()<UITextFieldDelegate>
+/**
+ Draws the card's brand, last 4, expiry and a CVC mask in a single layer,
+ rather than with text fields, as it's only ever shown, never edited. It takes
+ the keyboard itself through UIKeyInput, so that deleting still clears it.
+ */
+@interface STPObscuredCardView()<UIKeyInput>
 
-@property(nonatomic, weak) UIImageView *brandImageView;
-@property(nonatomic, weak) UITextField *last4Field;
-@property(nonatomic, weak) UITextField *expField;
-@property(nonatomic, weak) UITextField *cvcField;
+@property(nonatomic) UIImage *brandImage;
+@property(nonatomic, copy) NSString *last4;
+@property(nonatomic, copy) NSString *expiration;
+@property(nonatomic, copy) NSString *cvc;
+@property(nonatomic, copy) STPTheme *appliedTheme;
 
 @end
 
 @implementation STPObscuredCardView
 
+@synthesize inputAccessoryView = _inputAccessoryView;
+
 - (instancetype)initWithFrame:(CGRect)frame {
     self = [super initWithFrame:frame];
     if (self) {
-        UIImage *cardImage = [STPImageLibrary unknownCardCardImage];
-        UIImageView *brandImageView = [[UIImageView alloc] initWithImage:cardImage];
-        brandImageView.contentMode = UIViewContentModeCenter;
-        [self addSubview:brandImageView];
-        _brandImageView = brandImageView;
-        
-        UITextField *last4Field = [UITextField new];
-        last4Field.delegate = self;
-        last4Field.keyboardType = UIKeyboardTypePhonePad;
-        [self addSubview:last4Field];
-        _last4Field = last4Field;
-        
-        UITextField *expField = [UITextField new];
-        expField.delegate = self;
-        expField.keyboardType = UIKeyboardTypePhonePad;
-        [self addSubview:expField];
-        _expField = expField;
-        
-        UITextField *cvcField = [UITextField new];
-        cvcField.delegate = self;
-        cvcField.keyboardType = UIKeyboardTypePhonePad;
-        cvcField.secureTextEntry = YES;
-        [self addSubview:cvcField];
-        _cvcField = cvcField;
-        
+        _brandImage = [STPImageLibrary unknownCardCardImage];
+        self.contentMode = UIViewContentModeRedraw;
         _theme = [STPTheme new];
         [self updateAppearance];
+        self.isAccessibilityElement = YES;
+        [self addGestureRecognizer:[[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(handleTap:)]];
     }
     return self;
 }
 
-- (void)layoutSubviews {
-    [super layoutSubviews];
-    self.brandImageView.frame = CGRectMake(10, 2, self.brandImageView.image.size.width, self.bounds.size.height - 2);
-    
-    [self.last4Field sizeToFit];
-    self.last4Field.frame = CGRectMake(CGRectGetMaxX(self.brandImageView.frame) + 8, 0, self.last4Field.frame.size.width + 20, self.bounds.size.height);
-    
-    [self.cvcField sizeToFit];
-    CGRect cvcFrame = self.cvcField.frame;
-    cvcFrame.size.width += 20;
-    cvcFrame.origin.y = 0;
-    cvcFrame.origin.x = CGRectGetMaxX(self.bounds) - cvcFrame.size.width;
-    cvcFrame.size.height = CGRectGetHeight(self.bounds);
-    self.cvcField.frame = cvcFrame;
-    
-    [self.expField sizeToFit];
-    CGRect expFrame = self.expField.frame;
-    expFrame.size.width += 20;
-    self.expField.frame = expFrame;
-    self.expField.center = CGPointMake(
-                                       (CGRectGetMinX(cvcFrame) + CGRectGetMaxX(self.last4Field.frame)) / 2,
-                                       self.bounds.size.height / 2
-                                       );
-    
+- (void)handleTap:(__unused UITapGestureRecognizer *)recognizer {
+    [self becomeFirstResponder];
+}
+
+- (NSDictionary<NSString *, id> *)textAttributes {
+    return @{
+             NSFontAttributeName: self.theme.font,
+             NSForegroundColorAttributeName: self.theme.primaryForegroundColor,
+             };
+}
+
+- (void)drawRect:(__unused CGRect)rect {
+    // Laid out as the text fields were: each text's box is 20 points wider than
+    // the text, with the text at its left.
+    CGFloat height = CGRectGetHeight(self.bounds);
+    CGRect brandFrame = CGRectMake(10, 2, self.brandImage.size.width, height - 2);
+    [self.brandImage drawAtPoint:CGPointMake(CGRectGetMinX(brandFrame),
+                                             CGRectGetMidY(brandFrame) - self.brandImage.size.height / 2)];
+
+    NSDictionary *attributes = [self textAttributes];
+    CGSize last4Size = [self.last4 sizeWithAttributes:attributes];
+    CGSize expirationSize = [self.expiration sizeWithAttributes:attributes];
+    CGSize cvcSize = [self.cvc sizeWithAttributes:attributes];
+    CGFloat last4MaxX = CGRectGetMaxX(brandFrame) + 8 + last4Size.width + 20;
+    CGFloat cvcMinX = CGRectGetMaxX(self.bounds) - cvcSize.width - 20;
+    CGFloat expirationMinX = (cvcMinX + last4MaxX) / 2 - (expirationSize.width + 20) / 2;
+
+    [self.last4 drawAtPoint:CGPointMake(CGRectGetMaxX(brandFrame) + 8, (height - last4Size.height) / 2) withAttributes:attributes];
+    [self.expiration drawAtPoint:CGPointMake(expirationMinX, (height - expirationSize.height) / 2) withAttributes:attributes];
+    [self.cvc drawAtPoint:CGPointMake(cvcMinX, (height - cvcSize.height) / 2) withAttributes:attributes];
 }
 
 - (void)setTheme:(STPTheme *)theme {
@@ -89,60 +83,70 @@
 }
 
 - (void)updateAppearance {
-    self.backgroundColor = self.theme.secondaryBackgroundColor;
-    self.last4Field.backgroundColor = [UIColor clearColor];
-    self.last4Field.font = self.theme.font;
-    self.last4Field.textColor = self.theme.primaryForegroundColor;
-    
-    self.expField.backgroundColor = [UIColor clearColor];
-    self.expField.font = self.theme.font;
-    self.expField.textColor = self.theme.primaryForegroundColor;
-    
-    self.cvcField.backgroundColor = [UIColor clearColor];
-    self.cvcField.font = self.theme.font;
-    self.cvcField.textColor = self.theme.primaryForegroundColor;
+    STPThemeChange changes = [self.theme changesFromTheme:self.appliedTheme];
+    if (changes & STPThemeChangeSecondaryBackgroundColor) {
+        self.backgroundColor = self.theme.secondaryBackgroundColor;
+    }
+    if (changes & (STPThemeChangeFont | STPThemeChangePrimaryForegroundColor)) {
+        [self setNeedsDisplay];
+    }
+    self.appliedTheme = self.theme;
 }
 
 - (void)configureWithCard:(STPCard *)card {
-    UIImage *image = [STPImageLibrary brandImageForCardBrand:card.brand];
-    self.brandImageView.image = image;
-    self.last4Field.text = card.last4;
-    self.expField.text = [NSString stringWithFormat:@"%lu/%lu", (unsigned long)card.expMonth, (unsigned long)(card.expYear % 100)];
+    self.brandImage = [STPImageLibrary brandImageForCardBrand:card.brand];
+    self.last4 = card.last4;
+    self.expiration = [NSString stringWithFormat:@"%lu/%lu", (unsigned long)card.expMonth, (unsigned long)(card.expYear % 100)];
     if (card.brand == STPCardBrandAmex) {
-        self.cvcField.text = STPLocalizedString(@"XXXX", @"Placeholder text for Amex CVC field (4 digits)");
+        self.cvc = STPLocalizedString(@"XXXX", @"Placeholder text for Amex CVC field (4 digits)");
     } else {
-        self.cvcField.text = STPLocalizedString(@"XXX", @"Placeholder text for non-Amex CVC field (3 digits)");
-    }
-    [self setNeedsLayout];
-}
-
-- (BOOL)textField:(UITextField *)textField shouldChangeCharactersInRange:(NSRange)range replacementString:(NSString *)string {
-    BOOL deleting = (range.location == textField.text.length - 1 && range.length == 1 && [string isEqualToString:@""]);
-    if (deleting) {
-        [self clear];
+        self.cvc = STPLocalizedString(@"XXX", @"Placeholder text for non-Amex CVC field (3 digits)");
     }
-    return NO;
+    self.accessibilityLabel = [@[self.last4 ?: @"", self.expiration] componentsJoinedByString:@" "];
+    [self setNeedsDisplay];
 }
 
 - (void)clear {
-    self.last4Field.text = @"";
-    self.expField.text = @"";
+    self.last4 = @"";
+    self.expiration = @"";
+    self.accessibilityLabel = nil;
+    [self setNeedsDisplay];
     [self.delegate obscuredCardViewDidClear:self];
 }
 
 - (BOOL)isEmpty {
-    return self.last4Field.text.length == 0;
+    return self.last4.length == 0;
 }
 
 - (void)setInputAccessoryView:(UIView *)inputAccessoryView {
     _inputAccessoryView = inputAccessoryView;
-    self.last4Field.inputAccessoryView = inputAccessoryView;
-    self.expField.inputAccessoryView = inputAccessoryView;
-    self.cvcField.inputAccessoryView = inputAccessoryView;
+    if (self.isFirstResponder) {
+        [self reloadInputViews];
+    }
 }
 
-- (BOOL)becomeFirstResponder {
-    return [self.cvcField becomeFirstResponder];
+#pragma mark - UIKeyInput
+
+- (BOOL)canBecomeFirstResponder {
+    return YES;
+}
+
+- (UIKeyboardType)keyboardType {
+    return UIKeyboardTypePhonePad;
+}
+
+- (BOOL)hasText {
+    return !self.isEmpty;
+}
+
+- (void)insertText:(__unused NSString *)text {
+    // The card can only be cleared, not edited
+}
+
+- (void)deleteBackward {
+    if (!self.isEmpty) {
+        [self clear];
+    }
 }
 
 @end
@@ -8,9 +8,13 @@
 
 #import "STPPaymentActivityIndicatorView.h"
 
+static NSString *const RotationAnimationKey = @"rotation";
+
 @interface STPPaymentActivityIndicatorView()
 
 @property(nonatomic, weak)CAShapeLayer *indicatorLayer;
+// The size the indicator's path was last built for
+@property(nonatomic)CGSize pathSize;
 
 @end
 
@@ -50,10 +54,20 @@
     CGRect bounds = self.bounds;
     bounds.size.width = MIN(bounds.size.width, bounds.size.height);
     bounds.size.height = bounds.size.width;
+    if (CGSizeEqualToSize(bounds.size, self.pathSize)) {
+        return;
+    }
+    self.pathSize = bounds.size;
     UIBezierPath *path = [UIBezierPath bezierPathWithOvalInRect:bounds];
     self.indicatorLayer.path = path.CGPath;
 }
 
+- (void)didMoveToWindow {
+    [super didMoveToWindow];
+    // Off-screen spinners don't keep an animation running.
+    [self updateRotationAnimation];
+}
+
 - (void)setHidesWhenStopped:(BOOL)hidesWhenStopped {
     _hidesWhenStopped = hidesWhenStopped;
     if (!self.animating && hidesWhenStopped) {
@@ -75,23 +89,41 @@
                 self.alpha = 1.0f;
             }];
         }
-        CALayer *currentLayer = [self.layer presentationLayer];
-        CGFloat currentRotation = (CGFloat)[[currentLayer valueForKeyPath:@"transform.rotation.z"] floatValue];
-        CABasicAnimation *animation = [CABasicAnimation animationWithKeyPath:@"transform.rotation.z"];
-        animation.fromValue = @(currentRotation);
-        animation.toValue = @(currentRotation + 2*M_PI);
-        animation.duration = 1.0f;
-        animation.repeatCount = HUGE_VAL;
-        [self.layer addAnimation:animation forKey:@"rotation"];
+        [self updateRotationAnimation];
     } else {
         if (self.hidesWhenStopped) {
+            // Keep spinning while fading out, then stop.
             [UIView animateWithDuration:(0.2f * animated) animations:^{
                 self.alpha = 0.0f;
+            } completion:^(__unused BOOL finished) {
+                [self updateRotationAnimation];
             }];
+        } else {
+            [self updateRotationAnimation];
         }
     }
 }
 
+- (void)updateRotationAnimation {
+    BOOL shouldRotate = self.animating && self.window != nil;
+    BOOL isRotating = [self.layer animationForKey:RotationAnimationKey] != nil;
+    if (shouldRotate == isRotating) {
+        return;
+    }
+    if (!shouldRotate) {
+        [self.layer removeAnimationForKey:RotationAnimationKey];
+        return;
+    }
+    CALayer *currentLayer = [self.layer presentationLayer];
+    CGFloat currentRotation = (CGFloat)[[currentLayer valueForKeyPath:@"transform.rotation.z"] floatValue];
+    CABasicAnimation *animation = [CABasicAnimation animationWithKeyPath:@"transform.rotation.z"];
+    animation.fromValue = @(currentRotation);
+    animation.toValue = @(currentRotation + 2*M_PI);
+    animation.duration = 1.0f;
+    animation.repeatCount = HUGE_VAL;
+    [self.layer addAnimation:animation forKey:RotationAnimationKey];
+}
+
 - (void)setAnimating:(BOOL)animating {
     [self setAnimating:animating animated:NO];
 }
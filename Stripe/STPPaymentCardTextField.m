@@ -8,14 +8,18 @@
 
 #import <UIKit/UIKit.h>
 
+#import "STPAnalyticsClient.h"
+#import "STPCardParams+Private.h"
 #import "STPFormTextField.h"
-#import "STPImageLibrary.h"
+#import "STPImageLibrary+Private.h"
 #import "STPPaymentCardTextFieldViewModel.h"
 #import "STPWeakStrongMacros.h"
 #import "Stripe.h"
 
 #define FAUXPAS_IGNORED_IN_METHOD(...)
 
+static NSUInteger const STPPaymentCardTextFieldMaxCachedSizes = 64;
+
 @interface STPPaymentCardTextField()<STPFormTextFieldDelegate>
 
 @property(nonatomic, readwrite, strong)STPFormTextField *sizingField;
@@ -37,6 +41,25 @@
 
 @property(nonatomic, readwrite, strong)STPCardParams *internalCardParams;
 
+// While set, text written to the fields comes from an already updated view
+// model, and the per-field change handling waits for the batch to finish.
+@property(nonatomic, assign)BOOL updatingFieldsInBatch;
+@property(nonatomic, assign)BOOL fieldsChangedInBatch;
+
+// Everything the frames set by the last layout pass were computed from.
+@property(nonatomic, copy)NSArray *layoutInputs;
+
+// Frames of the number, expiration and CVC fields with the number field
+// expanded and shrunk, worked out together by each layout pass.
+@property(nonatomic, copy)NSArray<NSValue *> *expandedFieldRects;
+@property(nonatomic, copy)NSArray<NSValue *> *shrunkFieldRects;
+
+// The image shown for each brand and field kind, keyed by
+// `brandImageKeyForFieldType:`. Keeping them here means the same image is
+// always the same object, even after the image library's cache is purged, so
+// comparing pointers is enough to skip a crossfade to the image already shown.
+@property(nonatomic, strong)NSMutableDictionary<NSString *, UIImage *> *brandImages;
+
 @end
 
 @implementation STPPaymentCardTextField
@@ -77,6 +100,8 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
 }
 
 - (void)commonInit {
+    [STPAnalyticsClient trackProductUsage:STPAnalyticsProductUsagePaymentCardTextField];
+    [STPImageLibrary warmBrandImageCache];
     // We're using ivars here because UIAppearance tracks when setters are
     // called, and won't override properties that have already been customized
     _borderColor = [self.class placeholderGrayColor];
@@ -370,10 +395,9 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
 #pragma mark public convenience methods
 
 - (void)clear {
-    for (STPFormTextField *field in [self allFields]) {
-        field.text = @"";
-    }
-    self.viewModel = [STPPaymentCardTextFieldViewModel new];
+    // Zeroed now rather than whenever the last reference to it goes away
+    [self.viewModel clear];
+    [self updateFieldsWithViewModel:[STPPaymentCardTextFieldViewModel new]];
     [self onChange];
     [self updateImageForFieldType:STPCardFieldTypeNumber];
     [self updateCVCPlaceholder];
@@ -421,7 +445,7 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
 }
 
 - (STPCardParams *)cardParams {
-    self.internalCardParams.number = self.cardNumber;
+    self.internalCardParams.numberBuffer = self.viewModel.cardNumberBuffer;
     self.internalCardParams.expMonth = self.expirationMonth;
     self.internalCardParams.expYear = self.expirationYear;
     self.internalCardParams.cvc = self.cvc;
@@ -430,19 +454,17 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
 
 - (void)setCardParams:(STPCardParams *)cardParams {
     self.internalCardParams = cardParams;
-    [self setText:cardParams.number inField:STPCardFieldTypeNumber];
+    STPPaymentCardTextFieldViewModel *viewModel = [STPPaymentCardTextFieldViewModel new];
+    viewModel.cardNumber = cardParams.number;
     BOOL expirationPresent = cardParams.expMonth && cardParams.expYear;
     if (expirationPresent) {
-        NSString *text = [NSString stringWithFormat:@"%02lu%02lu",
-                          (unsigned long)cardParams.expMonth,
-                          (unsigned long)cardParams.expYear%100];
-        [self setText:text inField:STPCardFieldTypeExpiration];
+        viewModel.rawExpiration = [NSString stringWithFormat:@"%02lu%02lu",
+                                   (unsigned long)cardParams.expMonth,
+                                   (unsigned long)cardParams.expYear%100];
     }
-    else {
-        [self setText:@"" inField:STPCardFieldTypeExpiration];
-    }
-    [self setText:cardParams.cvc inField:STPCardFieldTypeCVC];
-    
+    viewModel.cvc = cardParams.cvc;
+    BOOL changed = [self updateFieldsWithViewModel:viewModel];
+
     BOOL shrinkNumberField = [self shouldShrinkNumberField];
     [self setNumberFieldShrunk:shrinkNumberField animated:NO completion:nil];
     if ([self isFirstResponder]) {
@@ -460,6 +482,28 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
         [self updateImageForFieldType:STPCardFieldTypeNumber];
     }
     [self updateCVCPlaceholder];
+    if (changed) {
+        [self onChange];
+    }
+}
+
+/**
+ Replaces the view model, and shows its values in the fields. Each field is
+ validated, but the first responder, image and change notifications are left
+ to the caller, so prefilling a card validates and notifies once rather than
+ once per field.
+
+ @return Whether the text of any field changed.
+ */
+- (BOOL)updateFieldsWithViewModel:(STPPaymentCardTextFieldViewModel *)viewModel {
+    self.viewModel = viewModel;
+    self.updatingFieldsInBatch = YES;
+    self.fieldsChangedInBatch = NO;
+    [self setText:viewModel.cardNumber inField:STPCardFieldTypeNumber];
+    [self setText:viewModel.rawExpiration inField:STPCardFieldTypeExpiration];
+    [self setText:viewModel.cvc inField:STPCardFieldTypeCVC];
+    self.updatingFieldsInBatch = NO;
+    return self.fieldsChangedInBatch;
 }
 
 - (void)setText:(NSString *)text inField:(STPCardFieldType)field {
@@ -483,8 +527,8 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
     
     CGSize imageSize = self.brandImage.size;
     
-    self.sizingField.text = self.viewModel.defaultPlaceholder;
-    CGFloat textHeight = [self.sizingField measureTextSize].height;
+    CGFloat textHeight = [self measuredSizeForText:self.viewModel.defaultPlaceholder
+                            autoFormattingBehavior:STPFormTextFieldAutoFormattingBehaviorNone].height;
     CGFloat imageHeight = imageSize.height + (STPPaymentCardTextFieldDefaultPadding);
     CGFloat height = stp_roundCGFloat((MAX(MAX(imageHeight, textHeight), 44)));
     
@@ -530,17 +574,122 @@ CGFloat const STPPaymentCardTextFieldDefaultPadding = 13;
     return CGRectMake(expirationX, 0, expirationWidth, CGRectGetHeight(bounds));
 }
 
+/**
+ The values the subview frames depend on. Text sizes are cached, but finding
+ them still means building a key for every measurement, so layout passes that
+ change none of these (e.g. while a containing view animates) are skipped.
+ 
+ A subclass that overrides the rect methods can compute them from anything,
+ so it is always laid out.
+ */
++ (BOOL)canSkipUnchangedLayout {
+    static NSMutableDictionary<NSString *, NSNumber *> *canSkipByClass;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        canSkipByClass = [NSMutableDictionary new];
+    });
+    @synchronized(canSkipByClass) {
+        NSString *className = NSStringFromClass(self);
+        NSNumber *canSkip = canSkipByClass[className];
+        if (!canSkip) {
+            SEL selectors[] = {
+                @selector(brandImageRectForBounds:),
+                @selector(fieldsRectForBounds:),
+                @selector(numberFieldRectForBounds:),
+                @selector(cvcFieldRectForBounds:),
+                @selector(expirationFieldRectForBounds:),
+            };
+            BOOL overridden = NO;
+            for (size_t i = 0; i < sizeof(selectors) / sizeof(selectors[0]); i++) {
+                if ([self instanceMethodForSelector:selectors[i]] != [STPPaymentCardTextField instanceMethodForSelector:selectors[i]]) {
+                    overridden = YES;
+                    break;
+                }
+            }
+            canSkip = @(!overridden);
+            canSkipByClass[className] = canSkip;
+        }
+        return canSkip.boolValue;
+    }
+}
+
+
+- (NSArray *)currentLayoutInputs {
+    return @[
+             [NSValue valueWithCGSize:self.bounds.size],
+             self.sizingField.font ?: [NSNull null],
+             [NSValue valueWithCGSize:self.brandImageView.image.size],
+             // Positions the number field while it's shrunk.
+             [self.viewModel numberWithoutLastDigits],
+             self.numberField.placeholder ?: @"",
+             self.expirationField.placeholder ?: @"",
+             self.cvcField.placeholder ?: @"",
+             ];
+}
+
 - (void)layoutSubviews {
     [super layoutSubviews];
 
+    if ([[self class] canSkipUnchangedLayout]) {
+        NSArray *layoutInputs = [self currentLayoutInputs];
+        if ([layoutInputs isEqualToArray:self.layoutInputs]) {
+            return;
+        }
+        self.layoutInputs = layoutInputs;
+    }
+
     CGRect bounds = self.bounds;
 
     self.brandImageView.frame = [self brandImageRectForBounds:bounds];
     self.fieldsView.frame = [self fieldsRectForBounds:bounds];
-    self.numberField.frame = [self numberFieldRectForBounds:bounds];
-    self.cvcField.frame = [self cvcFieldRectForBounds:bounds];
-    self.expirationField.frame = [self expirationFieldRectForBounds:bounds];
-    
+
+    // Lay out both states now, so shrinking or expanding the number field
+    // only has to move the fields.
+    BOOL shrunk = _numberFieldShrunk;
+    _numberFieldShrunk = NO;
+    self.expandedFieldRects = [self fieldRectsForBounds:bounds];
+    _numberFieldShrunk = YES;
+    self.shrunkFieldRects = [self fieldRectsForBounds:bounds];
+    _numberFieldShrunk = shrunk;
+
+    NSArray<UIView *> *fields = [self allFields];
+    for (NSUInteger i = 0; i < MIN(fields.count, self.expandedFieldRects.count); i++) {
+        fields[i].transform = CGAffineTransformIdentity;
+        fields[i].frame = self.expandedFieldRects[i].CGRectValue;
+    }
+    [self moveFieldsForNumberFieldShrunk:shrunk];
+}
+
+// In the same order as `allFields`.
+- (NSArray<NSValue *> *)fieldRectsForBounds:(CGRect)bounds {
+    return @[
+             [NSValue valueWithCGRect:[self numberFieldRectForBounds:bounds]],
+             [NSValue valueWithCGRect:[self expirationFieldRectForBounds:bounds]],
+             [NSValue valueWithCGRect:[self cvcFieldRectForBounds:bounds]],
+             ];
+}
+
+/**
+ The fields keep their expanded frames, and are translated to their shrunk
+ positions, so the shrink animation only animates each layer's transform.
+ A field whose size differs between the two states (e.g. in a subclass that
+ overrides the rect methods) has its frame set instead.
+ */
+- (void)moveFieldsForNumberFieldShrunk:(BOOL)shrunk {
+    NSArray<UIView *> *fields = [self allFields];
+    if (self.expandedFieldRects.count != fields.count || self.shrunkFieldRects.count != fields.count) {
+        return;
+    }
+    for (NSUInteger i = 0; i < fields.count; i++) {
+        CGRect expanded = self.expandedFieldRects[i].CGRectValue;
+        CGRect target = shrunk ? self.shrunkFieldRects[i].CGRectValue : expanded;
+        if (CGSizeEqualToSize(expanded.size, self.shrunkFieldRects[i].CGRectValue.size)) {
+            fields[i].transform = CGAffineTransformMakeTranslation(CGRectGetMinX(target) - CGRectGetMinX(expanded),
+                                                                   CGRectGetMinY(target) - CGRectGetMinY(expanded));
+        } else {
+            fields[i].frame = target;
+        }
+    }
 }
 
 #pragma mark - private helper methods
@@ -583,12 +732,13 @@ typedef void (^STPNumberShrunkCompletionBlock)(BOOL completed);
         return;
     }
     
+    [self layoutIfNeeded];
     _numberFieldShrunk = shrunk;
     void (^animations)() = ^void() {
         for (UIView *view in @[self.expirationField, self.cvcField]) {
             view.alpha = 1.0f * shrunk;
         }
-        [self layoutSubviews];
+        [self moveFieldsForNumberFieldShrunk:shrunk];
     };
     
     FAUXPAS_IGNORED_IN_METHOD(APIAvailability);
@@ -613,15 +763,87 @@ typedef void (^STPNumberShrunkCompletionBlock)(BOOL completed);
 }
 
 - (CGFloat)widthForText:(NSString *)text {
-    self.sizingField.autoFormattingBehavior = STPFormTextFieldAutoFormattingBehaviorNone;
-    [self.sizingField setText:text];
-    return [self.sizingField measureTextSize].width + 8;
+    return [self measuredWidthForText:text autoFormattingBehavior:STPFormTextFieldAutoFormattingBehaviorNone] + 8;
 }
 
 - (CGFloat)widthForCardNumber:(NSString *)cardNumber {
-    self.sizingField.autoFormattingBehavior = STPFormTextFieldAutoFormattingBehaviorCardNumbers;
-    [self.sizingField setText:cardNumber];
-    return [self.sizingField measureTextSize].width + 20;
+    return [self measuredWidthForText:cardNumber autoFormattingBehavior:STPFormTextFieldAutoFormattingBehaviorCardNumbers] + 20;
+}
+
+- (CGFloat)measuredWidthForText:(NSString *)text autoFormattingBehavior:(STPFormTextFieldAutoFormattingBehavior)behavior {
+    return [self measuredSizeForText:text autoFormattingBehavior:behavior].width;
+}
+
+/**
+ Sizes are shared by every card field on screen, keyed by font and by a
+ pattern of the text that captures everything its size depends on.
+ */
++ (NSCache<NSString *, NSValue *> *)textSizeCache {
+    static NSCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [NSCache new];
+        cache.name = @"com.stripe.paymentCardTextField.textSizes";
+        cache.countLimit = STPPaymentCardTextFieldMaxCachedSizes;
+    });
+    return cache;
+}
+
++ (BOOL)fontHasTabularDigits:(UIFont *)font {
+    static NSCache<NSString *, NSNumber *> *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [NSCache new];
+    });
+    NSString *key = [NSString stringWithFormat:@"%@|%f", font.fontName, font.pointSize];
+    NSNumber *tabular = [cache objectForKey:key];
+    if (!tabular) {
+        NSDictionary *attributes = @{NSFontAttributeName: font};
+        CGFloat width = [@"0" sizeWithAttributes:attributes].width;
+        BOOL allEqual = YES;
+        for (NSString *digit in @[@"1", @"2", @"3", @"4", @"5", @"6", @"7", @"8", @"9"]) {
+            allEqual = allEqual && fabs([digit sizeWithAttributes:attributes].width - width) < 0.001;
+        }
+        tabular = @(allEqual);
+        [cache setObject:tabular forKey:key];
+    }
+    return tabular.boolValue;
+}
+
+/**
+ Nil for text whose size can't be cached without keeping the digits the user
+ typed, which would outlive the field in a process-wide cache.
+ */
+- (NSString *)sizeCacheKeyForText:(NSString *)text autoFormattingBehavior:(STPFormTextFieldAutoFormattingBehavior)behavior {
+    UIFont *font = self.sizingField.font;
+    NSString *pattern = text ?: @"";
+    if ([pattern rangeOfCharacterFromSet:[NSCharacterSet decimalDigitCharacterSet]].location != NSNotFound) {
+        if (![STPCardValidator stringIsNumeric:pattern] || ![self.class fontHasTabularDigits:font]) {
+            return nil;
+        }
+        // Every digit is the same width, so only the number of digits and how
+        // they're grouped matter.
+        BOOL amexGrouping = behavior == STPFormTextFieldAutoFormattingBehaviorCardNumbers && [STPCardValidator brandForNumber:pattern] == STPCardBrandAmex;
+        pattern = [NSString stringWithFormat:@"#%lu%@", (unsigned long)pattern.length, amexGrouping ? @"a" : @""];
+    }
+    return [NSString stringWithFormat:@"%@|%f|%ld|%@", font.fontName, font.pointSize, (long)behavior, pattern];
+}
+
+- (CGSize)measuredSizeForText:(NSString *)text autoFormattingBehavior:(STPFormTextFieldAutoFormattingBehavior)behavior {
+    NSCache *cache = [self.class textSizeCache];
+    NSString *key = [self sizeCacheKeyForText:text autoFormattingBehavior:behavior];
+    NSValue *size = key ? [cache objectForKey:key] : nil;
+    if (!size) {
+        if (self.sizingField.autoFormattingBehavior != behavior) {
+            self.sizingField.autoFormattingBehavior = behavior;
+        }
+        [self.sizingField setText:text];
+        size = [NSValue valueWithCGSize:[self.sizingField measureTextSize]];
+        if (key) {
+            [cache setObject:size forKey:key];
+        }
+    }
+    return size.CGSizeValue;
 }
 
 #pragma mark STPFormTextFieldDelegate
@@ -635,17 +857,19 @@ typedef void (^STPNumberShrunkCompletionBlock)(BOOL completed);
 - (NSAttributedString *)formTextField:(STPFormTextField *)formTextField
    modifyIncomingTextChange:(NSAttributedString *)input {
     STPCardFieldType fieldType = formTextField.tag;
-    switch (fieldType) {
-        case STPCardFieldTypeNumber:
-            self.viewModel.cardNumber = input.string;
-            break;
-        case STPCardFieldTypeExpiration: {
-            self.viewModel.rawExpiration = input.string;
-            break;
+    if (!self.updatingFieldsInBatch) {
+        switch (fieldType) {
+            case STPCardFieldTypeNumber:
+                self.viewModel.cardNumber = input.string;
+                break;
+            case STPCardFieldTypeExpiration: {
+                self.viewModel.rawExpiration = input.string;
+                break;
+            }
+            case STPCardFieldTypeCVC:
+                self.viewModel.cvc = input.string;
+                break;
         }
-        case STPCardFieldTypeCVC:
-            self.viewModel.cvc = input.string;
-            break;
     }
     
     switch (fieldType) {
@@ -663,6 +887,11 @@ typedef void (^STPNumberShrunkCompletionBlock)(BOOL completed);
 
 - (void)formTextFieldTextDidChange:(STPFormTextField *)formTextField {
     STPCardFieldType fieldType = formTextField.tag;
+    if (self.updatingFieldsInBatch) {
+        formTextField.validText = [self.viewModel validationStateForField:fieldType] != STPCardValidationStateInvalid;
+        self.fieldsChangedInBatch = YES;
+        return;
+    }
     if (fieldType == STPCardFieldTypeNumber) {
         [self updateImageForFieldType:fieldType];
         [self updateCVCPlaceholder];
@@ -750,12 +979,29 @@ typedef void (^STPNumberShrunkCompletionBlock)(BOOL completed);
     return [STPImageLibrary brandImageForCardBrand:cardBrand];
 }
 
+- (NSString *)brandImageKeyForFieldType:(STPCardFieldType)fieldType {
+    BOOL cvc = fieldType == STPCardFieldTypeCVC;
+    return [NSString stringWithFormat:@"%ld|%d", (long)self.viewModel.brand, cvc];
+}
+
 - (UIImage *)brandImageForFieldType:(STPCardFieldType)fieldType {
+    NSString *key = [self brandImageKeyForFieldType:fieldType];
+    UIImage *image = self.brandImages[key];
+    if (image) {
+        return image;
+    }
     if (fieldType == STPCardFieldTypeCVC) {
-        return [self.class cvcImageForCardBrand:self.viewModel.brand];
+        image = [self.class cvcImageForCardBrand:self.viewModel.brand];
+    } else {
+        image = [self.class brandImageForCardBrand:self.viewModel.brand];
     }
-
-    return [self.class brandImageForCardBrand:self.viewModel.brand];
+    if (image) {
+        if (!self.brandImages) {
+            self.brandImages = [NSMutableDictionary dictionary];
+        }
+        self.brandImages[key] = image;
+    }
+    return image;
 }
 
 - (void)updateImageForFieldType:(STPCardFieldType)fieldType {
@@ -10,6 +10,7 @@
 #import <UIKit/UIKit.h>
 
 #import "STPCard.h"
+#import "STPCardNumberBuffer.h"
 #import "STPCardValidator.h"
 
 typedef NS_ENUM(NSInteger, STPCardFieldType) {
@@ -21,16 +22,23 @@ typedef NS_ENUM(NSInteger, STPCardFieldType) {
 @interface STPPaymentCardTextFieldViewModel : NSObject
 
 @property(nonatomic, readwrite, copy, nullable)NSString *cardNumber;
+// Where `cardNumber` is kept. nil until it's first set.
+@property(nonatomic, readonly, nullable)STPCardNumberBuffer *cardNumberBuffer;
 @property(nonatomic, readwrite, copy, nullable)NSString *rawExpiration;
 @property(nonatomic, readonly, nullable)NSString *expirationMonth;
 @property(nonatomic, readonly, nullable)NSString *expirationYear;
 @property(nonatomic, readwrite, copy, nullable)NSString *cvc;
 @property(nonatomic, readonly) STPCardBrand brand;
-@property(nonatomic, readonly) BOOL isValid;
+@property(nonatomic, readonly, getter=isValid) BOOL valid;
 
 - (nonnull NSString *)defaultPlaceholder;
 - (nullable NSString *)numberWithoutLastDigits;
 
 - (STPCardValidationState)validationStateForField:(STPCardFieldType)fieldType;
 
+/**
+ Zeroes the card number.
+ */
+- (void)clear;
+
 @end
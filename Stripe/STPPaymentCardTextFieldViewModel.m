@@ -8,16 +8,103 @@
 
 #import "STPPaymentCardTextFieldViewModel.h"
 #import "NSString+Stripe.h"
+#import "STPCardValidator+Private.h"
 
 #define FAUXPAS_IGNORED_IN_METHOD(...)
 
+/**
+ Everything derived from the entered values (brand, length limits, validation
+ states) is computed once when a value is set and stored, so reading it while
+ laying out or validating the field is free. `brand` and `valid` only send KVO
+ notifications when their value actually changes.
+
+ The card number is read straight into `cardNumberBuffer` and validated
+ there, so setting it makes no intermediate strings.
+ */
+@interface STPPaymentCardTextFieldViewModel()
+@property(nonatomic, readwrite)STPCardBrand brand;
+@property(nonatomic, readwrite)STPCardNumberBuffer *cardNumberBuffer;
+@property(nonatomic)NSInteger maxNumberLength;
+@property(nonatomic)NSInteger maxCVCLength;
+@property(nonatomic)STPCardValidationState numberState;
+@property(nonatomic)STPCardValidationState expirationState;
+@property(nonatomic)STPCardValidationState cvcState;
+@property(nonatomic, readwrite, getter=isValid)BOOL valid;
+@end
+
 @implementation STPPaymentCardTextFieldViewModel
 
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _brand = STPCardBrandUnknown;
+        _maxNumberLength = [STPCardValidator maxLengthForCardBrand:_brand];
+        _maxCVCLength = [STPCardValidator maxCVCLengthForCardBrand:_brand];
+        _numberState = [STPCardValidator validationStateForNumber:@"" validatingCardBrand:YES];
+        _expirationState = [self.class expirationStateForMonth:@"" year:@""];
+        _cvcState = [STPCardValidator validationStateForCVC:@"" cardBrand:_brand];
+    }
+    return self;
+}
+
++ (BOOL)automaticallyNotifiesObserversForKey:(NSString *)key {
+    if ([key isEqualToString:NSStringFromSelector(@selector(brand))] ||
+        [key isEqualToString:NSStringFromSelector(@selector(valid))]) {
+        return NO;
+    }
+    return [super automaticallyNotifiesObserversForKey:key];
+}
+
+- (void)setBrand:(STPCardBrand)brand {
+    if (brand == _brand) {
+        return;
+    }
+    NSString *key = NSStringFromSelector(@selector(brand));
+    [self willChangeValueForKey:key];
+    _brand = brand;
+    [self didChangeValueForKey:key];
+    self.maxNumberLength = [STPCardValidator maxLengthForCardBrand:brand];
+    self.maxCVCLength = [STPCardValidator maxCVCLengthForCardBrand:brand];
+    self.cvcState = [STPCardValidator validationStateForCVC:self.cvc cardBrand:brand];
+}
+
+- (void)setValid:(BOOL)valid {
+    if (valid == _valid) {
+        return;
+    }
+    NSString *key = NSStringFromSelector(@selector(valid));
+    [self willChangeValueForKey:key];
+    _valid = valid;
+    [self didChangeValueForKey:key];
+}
+
+- (void)updateValid {
+    self.valid = (self.numberState == STPCardValidationStateValid &&
+                  self.expirationState == STPCardValidationStateValid &&
+                  self.cvcState == STPCardValidationStateValid);
+}
+
 - (void)setCardNumber:(NSString *)cardNumber {
-    NSString *sanitizedNumber = [STPCardValidator sanitizedNumericStringForString:cardNumber];
-    STPCardBrand brand = [STPCardValidator brandForNumber:sanitizedNumber];
-    NSInteger maxLength = [STPCardValidator maxLengthForCardBrand:brand];
-    _cardNumber = [sanitizedNumber stp_safeSubstringToIndex:maxLength];
+    if (!self.cardNumberBuffer) {
+        self.cardNumberBuffer = [STPCardNumberBuffer new];
+    }
+    [self.cardNumberBuffer setString:cardNumber];
+    // Looking up the brand doesn't allocate, so it isn't worth caching
+    self.brand = self.cardNumberBuffer.brand;
+    [self.cardNumberBuffer truncateToLength:self.maxNumberLength];
+    self.numberState = [STPCardValidator validationStateForCardNumberDigits:self.cardNumberBuffer.digits validatingCardBrand:YES];
+    [self updateValid];
+}
+
+- (NSString *)cardNumber {
+    return [self.cardNumberBuffer stringValue];
+}
+
+- (void)clear {
+    [self.cardNumberBuffer clear];
+    self.brand = STPCardBrandUnknown;
+    self.numberState = [STPCardValidator validationStateForCardNumberDigits:self.cardNumberBuffer.digits validatingCardBrand:YES];
+    [self updateValid];
 }
 
 // This might contain slashes.
@@ -45,71 +132,58 @@
         sanitizedExpiration = [@"0" stringByAppendingString:sanitizedExpiration];
     }
     _expirationMonth = [sanitizedExpiration stp_safeSubstringToIndex:2];
+    self.expirationState = [self.class expirationStateForMonth:_expirationMonth year:_expirationYear];
+    [self updateValid];
 }
 
 - (void)setExpirationYear:(NSString *)expirationYear {
     _expirationYear = [[STPCardValidator sanitizedNumericStringForString:expirationYear] stp_safeSubstringToIndex:2];
+    self.expirationState = [self.class expirationStateForMonth:_expirationMonth year:_expirationYear];
+    [self updateValid];
 }
 
 - (void)setCvc:(NSString *)cvc {
-    NSInteger maxLength = [STPCardValidator maxCVCLengthForCardBrand:self.brand];
-    _cvc = [[STPCardValidator sanitizedNumericStringForString:cvc] stp_safeSubstringToIndex:maxLength];
+    _cvc = [[STPCardValidator sanitizedNumericStringForString:cvc] stp_safeSubstringToIndex:self.maxCVCLength];
+    self.cvcState = [STPCardValidator validationStateForCVC:_cvc cardBrand:self.brand];
+    [self updateValid];
 }
 
-- (STPCardBrand)brand {
-    return [STPCardValidator brandForNumber:self.cardNumber];
++ (STPCardValidationState)expirationStateForMonth:(NSString *)month year:(NSString *)year {
+    STPCardValidationState monthState = [STPCardValidator validationStateForExpirationMonth:month];
+    STPCardValidationState yearState = [STPCardValidator validationStateForExpirationYear:year inMonth:month];
+    if (monthState == STPCardValidationStateValid && yearState == STPCardValidationStateValid) {
+        return STPCardValidationStateValid;
+    } else if (monthState == STPCardValidationStateInvalid || yearState == STPCardValidationStateInvalid) {
+        return STPCardValidationStateInvalid;
+    } else {
+        return STPCardValidationStateIncomplete;
+    }
 }
 
 - (STPCardValidationState)validationStateForField:(STPCardFieldType)fieldType {
     switch (fieldType) {
         case STPCardFieldTypeNumber:
-            return [STPCardValidator validationStateForNumber:self.cardNumber validatingCardBrand:YES];
-            break;
-        case STPCardFieldTypeExpiration: {
-            STPCardValidationState monthState = [STPCardValidator validationStateForExpirationMonth:self.expirationMonth];
-            STPCardValidationState yearState = [STPCardValidator validationStateForExpirationYear:self.expirationYear inMonth:self.expirationMonth];
-            if (monthState == STPCardValidationStateValid && yearState == STPCardValidationStateValid) {
-                return STPCardValidationStateValid;
-            } else if (monthState == STPCardValidationStateInvalid || yearState == STPCardValidationStateInvalid) {
-                return STPCardValidationStateInvalid;
-            } else {
-                return STPCardValidationStateIncomplete;
-            }
-            break;
-        }
+            return self.numberState;
+        case STPCardFieldTypeExpiration:
+            return self.expirationState;
         case STPCardFieldTypeCVC:
-            return [STPCardValidator validationStateForCVC:self.cvc cardBrand:self.brand];
+            return self.cvcState;
     }
 }
 
-- (BOOL)isValid {
-    return ([self validationStateForField:STPCardFieldTypeNumber] == STPCardValidationStateValid &&
-            [self validationStateForField:STPCardFieldTypeExpiration] == STPCardValidationStateValid &&
-            [self validationStateForField:STPCardFieldTypeCVC] == STPCardValidationStateValid);
-}
-
 - (NSString *)defaultPlaceholder {
     return @"4242424242424242";
 }
 
 - (NSString *)numberWithoutLastDigits {
-    NSUInteger length = [STPCardValidator fragmentLengthForCardBrand:[STPCardValidator brandForNumber:self.cardNumber]];
-    NSUInteger toIndex = self.cardNumber.length - length;
-    
-    return (toIndex < self.cardNumber.length) ?
+    NSUInteger length = [STPCardValidator fragmentLengthForCardBrand:self.brand];
+    NSUInteger numberLength = self.cardNumberBuffer.length;
+    NSUInteger toIndex = numberLength - length;
+
+    return (toIndex < numberLength) ?
         [self.cardNumber substringToIndex:toIndex] :
         [self.defaultPlaceholder stp_safeSubstringToIndex:[self defaultPlaceholder].length - length];
 
 }
 
-+ (NSSet<NSString *> *)keyPathsForValuesAffectingValid {
-    return [NSSet setWithArray:@[
-                                 NSStringFromSelector(@selector(cardNumber)),
-                                 NSStringFromSelector(@selector(expirationMonth)),
-                                 NSStringFromSelector(@selector(expirationYear)),
-                                 NSStringFromSelector(@selector(cvc)),
-                                 NSStringFromSelector(@selector(brand))
-                                 ]];
-}
-
 @end
@@ -13,5 +13,22 @@
 @property(nonatomic, readonly)BOOL applePayEnabled;
 @property(nonatomic, readwrite) BOOL ineligibleForSmsAutofill;
 
+/**
+ Incremented whenever a public property changes, so that values derived from
+ the configuration can be cached until it does.
+ */
+@property(nonatomic, readonly) NSUInteger changeCount;
+
+/**
+ An immutable copy of the configuration as it is now, for reading from any
+ thread while the configuration itself keeps changing on the main thread.
+ Capture one when starting work that reads the configuration later, e.g. in a
+ request's completion. The same snapshot is returned until a property
+ changes, so values derived from it, like the serialized analytics
+ configuration, can be cached per snapshot. A snapshot's own snapshot is
+ itself, and setting any property of a snapshot is a programmer error.
+ */
+- (STPPaymentConfiguration *)configurationSnapshot;
+
 @end
 
@@ -8,19 +8,25 @@
 
 #import "STPPaymentConfiguration.h"
 
+#import <stdatomic.h>
+
 #import "NSBundle+Stripe_AppName.h"
-#import "STPAnalyticsClient.h"
 #import "STPPaymentConfiguration+Private.h"
-#import "Stripe.h"
+#import "STPAPIClient.h"
 
-@implementation STPPaymentConfiguration
+@implementation STPPaymentConfiguration {
+    // The shared configuration is usually created at launch, when the
+    // publishable key is set, so the app name is only read once it's needed.
+    BOOL _companyNameSet;
+    // Read from whichever thread is caching something derived from it
+    _Atomic(NSUInteger) _changeCount;
+    BOOL _isSnapshot;
+    // Guarded by @synchronized(self)
+    STPPaymentConfiguration *_cachedSnapshot;
+}
 
 @synthesize ineligibleForSmsAutofill = _ineligibleForSmsAutofill;
 
-+ (void)initialize {
-    [STPAnalyticsClient initializeIfNeeded];
-}
-
 + (instancetype)sharedConfiguration {
     static STPPaymentConfiguration *sharedConfiguration;
     static dispatch_once_t onceToken;
@@ -36,7 +42,6 @@
         _additionalPaymentMethods = STPPaymentMethodTypeAll;
         _requiredBillingAddressFields = STPBillingAddressFieldsNone;
         _requiredShippingAddressFields = PKAddressFieldNone;
-        _companyName = [NSBundle stp_applicationName];
         _smsAutofillDisabled = NO;
         _shippingType = STPShippingTypeShipping;
     }
@@ -53,6 +58,9 @@
     copy.companyName = self.companyName;
     copy.appleMerchantIdentifier = self.appleMerchantIdentifier;
     copy.smsAutofillDisabled = self.smsAutofillDisabled;
+    copy.customerCachingEnabled = self.customerCachingEnabled;
+    copy.shippingMethodsPrefetchingEnabled = self.shippingMethodsPrefetchingEnabled;
+    copy.speculativeTokenizationEnabled = self.speculativeTokenizationEnabled;
     return copy;
 }
 
@@ -62,6 +70,98 @@
     [Stripe deviceSupportsApplePay];
 }
 
+#pragma mark - Setters
+
+- (void)didChange {
+    NSCAssert(!_isSnapshot, @"Configuration snapshots can't be changed. Change the configuration they were taken from instead.");
+    atomic_fetch_add(&_changeCount, 1);
+    @synchronized(self) {
+        _cachedSnapshot = nil;
+    }
+}
+
+- (NSUInteger)changeCount {
+    return atomic_load(&_changeCount);
+}
+
+- (STPPaymentConfiguration *)configurationSnapshot {
+    if (_isSnapshot) {
+        return self;
+    }
+    @synchronized(self) {
+        if (!_cachedSnapshot) {
+            STPPaymentConfiguration *snapshot = [self copy];
+            snapshot->_ineligibleForSmsAutofill = _ineligibleForSmsAutofill;
+            snapshot->_isSnapshot = YES;
+            _cachedSnapshot = snapshot;
+        }
+        return _cachedSnapshot;
+    }
+}
+
+- (void)setPublishableKey:(NSString *)publishableKey {
+    _publishableKey = [publishableKey copy];
+    [self didChange];
+}
+
+- (void)setAdditionalPaymentMethods:(STPPaymentMethodType)additionalPaymentMethods {
+    _additionalPaymentMethods = additionalPaymentMethods;
+    [self didChange];
+}
+
+- (void)setRequiredBillingAddressFields:(STPBillingAddressFields)requiredBillingAddressFields {
+    _requiredBillingAddressFields = requiredBillingAddressFields;
+    [self didChange];
+}
+
+- (void)setRequiredShippingAddressFields:(PKAddressField)requiredShippingAddressFields {
+    _requiredShippingAddressFields = requiredShippingAddressFields;
+    [self didChange];
+}
+
+- (void)setShippingType:(STPShippingType)shippingType {
+    _shippingType = shippingType;
+    [self didChange];
+}
+
+- (void)setCompanyName:(NSString *)companyName {
+    _companyName = [companyName copy];
+    _companyNameSet = YES;
+    [self didChange];
+}
+
+- (NSString *)companyName {
+    if (!_companyNameSet) {
+        return [NSBundle stp_applicationName];
+    }
+    return _companyName;
+}
+
+- (void)setAppleMerchantIdentifier:(NSString *)appleMerchantIdentifier {
+    _appleMerchantIdentifier = [appleMerchantIdentifier copy];
+    [self didChange];
+}
+
+- (void)setSmsAutofillDisabled:(BOOL)smsAutofillDisabled {
+    _smsAutofillDisabled = smsAutofillDisabled;
+    [self didChange];
+}
+
+- (void)setCustomerCachingEnabled:(BOOL)customerCachingEnabled {
+    _customerCachingEnabled = customerCachingEnabled;
+    [self didChange];
+}
+
+- (void)setShippingMethodsPrefetchingEnabled:(BOOL)shippingMethodsPrefetchingEnabled {
+    _shippingMethodsPrefetchingEnabled = shippingMethodsPrefetchingEnabled;
+    [self didChange];
+}
+
+- (void)setSpeculativeTokenizationEnabled:(BOOL)speculativeTokenizationEnabled {
+    _speculativeTokenizationEnabled = speculativeTokenizationEnabled;
+    [self didChange];
+}
+
 - (void)setIneligibleForSmsAutofill:(BOOL)ineligibleForSmsAutofill {
     _ineligibleForSmsAutofill = ineligibleForSmsAutofill;
     self.smsAutofillDisabled = (self.smsAutofillDisabled || ineligibleForSmsAutofill);
@@ -11,14 +11,21 @@
 
 #import "PKPaymentAuthorizationViewController+Stripe_Blocks.h"
 #import "STPAddCardViewController+Private.h"
+#import "STPAddress+Private.h"
+#import "STPAnalyticsClient.h"
 #import "STPCardTuple.h"
+#import "STPCheckoutAPIClient.h"
+#import "STPCustomerCache.h"
 #import "STPDispatchFunctions.h"
+#import "STPImageLibrary+Private.h"
+#import "STPMainThreadWatchdog.h"
 #import "STPPaymentConfiguration+Private.h"
 #import "STPPaymentContext+Private.h"
 #import "STPPaymentContextAmountModel.h"
 #import "STPPaymentMethodTuple.h"
 #import "STPPromise.h"
 #import "STPShippingMethodsViewController.h"
+#import "STPSignpost.h"
 #import "STPWeakStrongMacros.h"
 #import "UINavigationController+Stripe_Completion.h"
 #import "UIViewController+Stripe_ParentViewController.h"
@@ -34,6 +41,12 @@
  - STPPaymentContextStateShowingRequestedViewController: The view controller that you requested the context show is being shown (via the push or present payment methods or shipping view controller methods)
  - STPPaymentContextStateRequestingPayment: The payment context is in the middle of requesting payment. It may be showing some other UI or view controller if more information is necessary to complete the payment.
  */
+static STPPaymentContextChanges const STPPaymentContextChangeEverything = (STPPaymentContextChangePaymentMethods
+                                                                             | STPPaymentContextChangeSelectedPaymentMethod
+                                                                             | STPPaymentContextChangeShippingMethods
+                                                                             | STPPaymentContextChangeSelectedShippingMethod
+                                                                             | STPPaymentContextChangeShippingAddress);
+
 typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
     STPPaymentContextStateNone,
     STPPaymentContextStateShowingRequestedViewController,
@@ -53,13 +66,24 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
 @property(nonatomic)STPVoidPromise *didAppearPromise;
 
 @property(nonatomic, weak)STPPaymentMethodsViewController *paymentMethodsViewController;
+// Built by -preparePaymentMethodsViewController, and not yet shown
+@property(nonatomic)STPPaymentMethodsViewController *preparedPaymentMethodsViewController;
 @property(nonatomic)id<STPPaymentMethod> selectedPaymentMethod;
 @property(nonatomic)NSArray<id<STPPaymentMethod>> *paymentMethods;
 @property(nonatomic)STPAddress *shippingAddress;
 @property(nonatomic)PKShippingMethod *selectedShippingMethod;
 @property(nonatomic)NSArray<PKShippingMethod *> *shippingMethods;
+// The address shipping methods were last asked for. The shipping screen
+// prefetches them as the user types, so answers for any other address are
+// out of date by the time they arrive.
+@property(nonatomic)STPAddress *shippingMethodsAddress;
 
 @property(nonatomic, assign) STPPaymentContextState state;
+/**
+ Changes the delegate hasn't been told about yet. Only touched on the main
+ thread.
+ */
+@property(nonatomic, assign) STPPaymentContextChanges pendingChanges;
 
 @property(nonatomic)STPPaymentContextAmountModel *paymentAmountModel;
 
@@ -90,6 +114,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
         _modalPresentationStyle = UIModalPresentationFullScreen;
         _state = STPPaymentContextStateNone;
         [self retryLoading];
+        [STPAnalyticsClient trackProductUsage:STPAnalyticsProductUsagePaymentContext];
     }
     return self;
 }
@@ -109,39 +134,55 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
             [self.didAppearPromise onSuccess:^(__unused id value) {
                 if (self.paymentMethodsViewController) {
                     [self appropriatelyDismissPaymentMethodsViewController:self.paymentMethodsViewController completion:^{
-                        [self.delegate paymentContext:self didFailToLoadWithError:error];
+                        [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+                            [delegate paymentContext:self didFailToLoadWithError:error];
+                        }];
                     }];
                 } else {
-                    [self.delegate paymentContext:self didFailToLoadWithError:error];
+                    [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+                        [delegate paymentContext:self didFailToLoadWithError:error];
+                    }];
                 }
             }];
         }
     }];
-    [self.apiAdapter retrieveCustomer:^(STPCustomer * _Nullable customer, NSError * _Nullable error) {
-        stpDispatchToMainThreadIfNecessary(^{
+    // The tuples are built in the order they're asked for, so the cached one
+    // is always in place before the request below is compared with it.
+    __block STPCardTuple *cachedTuple;
+    BOOL applePayEnabled = self.configuration.applePayEnabled;
+    if (self.configuration.customerCachingEnabled) {
+        STPCustomer *cachedCustomer = [[STPCustomerCache sharedCache] customerForAPIAdapter:self.apiAdapter];
+        if (cachedCustomer) {
+            // Show what we had last time; the request below revalidates it.
+            [STPPaymentMethodTuple getTuplesWithCustomer:cachedCustomer applePayEnabled:applePayEnabled completion:^(STPCardTuple *tuple, STPPaymentMethodTuple *paymentTuple) {
+                STRONG(self);
+                cachedTuple = tuple;
+                [self.loadingPromise succeed:paymentTuple];
+            }];
+        }
+    }
+    [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:self.apiAdapter completion:^(STPCustomer * _Nullable customer, NSError * _Nullable error) {
+        // Errors go through the queue too, so they can't overtake the cached tuple
+        [STPPaymentMethodTuple getTuplesWithCustomer:customer applePayEnabled:applePayEnabled completion:^(STPCardTuple *tuple, STPPaymentMethodTuple *paymentTuple) {
             STRONG(self);
             if (!self) {
                 return;
             }
             if (error) {
+                // A failed revalidation leaves the cached cards on screen.
                 [self.loadingPromise fail:error];
                 return;
             }
-            STPCard *selectedCard;
-            NSMutableArray<STPCard *> *cards = [NSMutableArray array];
-            for (id<STPSourceProtocol> source in customer.sources) {
-                if ([source isKindOfClass:[STPCard class]]) {
-                    STPCard *card = (STPCard *)source;
-                    [cards addObject:card];
-                    if ([card.stripeID isEqualToString:customer.defaultSource.stripeID]) {
-                        selectedCard = card;
-                    }
-                }
+            if (!cachedTuple) {
+                [self.loadingPromise succeed:paymentTuple];
             }
-            STPCardTuple *tuple = [STPCardTuple tupleWithSelectedCard:selectedCard cards:cards];
-            STPPaymentMethodTuple *paymentTuple = [STPPaymentMethodTuple tupleWithCardTuple:tuple applePayEnabled:self.configuration.applePayEnabled];
-            [self.loadingPromise succeed:paymentTuple];
-        });
+            else if (![tuple isEqualToCardTuple:cachedTuple]) {
+                self.paymentMethods = paymentTuple.paymentMethods;
+                self.selectedPaymentMethod = paymentTuple.selectedPaymentMethod;
+                [self.paymentMethodsViewController updateWithPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:self.paymentMethods
+                                                                                                          selectedPaymentMethod:self.selectedPaymentMethod]];
+            }
+        }];
     }];
 }
 
@@ -155,6 +196,36 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
     [self artificiallyRetain:hostViewController];
     [self.willAppearPromise voidCompleteWith:hostViewController.stp_willAppearPromise];
     [self.didAppearPromise voidCompleteWith:hostViewController.stp_didAppearPromise];
+    [self prefetch];
+}
+
+/**
+ Warms everything the context's screens depend on, all at once, so that
+ presenting them or requesting payment only finds cached state. The customer
+ is already loading (see -retryLoading) and Apple Pay availability was looked
+ up with it; shipping methods wait for the shipping screen, which prefetches
+ them once it has a valid address.
+ */
+- (void)prefetch {
+    [self.apiClient prewarmConnection];
+    [STPImageLibrary warmBrandImageCache];
+    // Remember Me in the add card screen needs the checkout bootstrap
+    NSString *publishableKey = self.configuration.publishableKey;
+    if (publishableKey && !self.configuration.smsAutofillDisabled) {
+        [[STPCheckoutAPIClient sharedClientWithPublishableKey:publishableKey] bootstrapIfNeeded];
+    }
+    WEAK(self);
+    [self.loadingPromise onSuccess:^(__unused STPPaymentMethodTuple *tuple) {
+        STRONG(self);
+        NSMutableArray<UIImage *> *images = [NSMutableArray array];
+        for (id<STPPaymentMethod> paymentMethod in self.paymentMethods) {
+            UIImage *image = paymentMethod.templateImage;
+            if (image && ![images containsObject:image]) {
+                [images addObject:image];
+            }
+        }
+        [STPImageLibrary prepareThumbnailsForImages:images scale:[UIScreen mainScreen].scale completion:nil];
+    }];
 }
 
 - (void)setDelegate:(id<STPPaymentContextDelegate>)delegate {
@@ -163,7 +234,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
     [self.willAppearPromise voidOnSuccess:^{
         STRONG(self);
         if (self.delegate == delegate) {
-            [delegate paymentContextDidChange:self];
+            [self addChanges:STPPaymentContextChangeEverything];
         }
     }];
 }
@@ -192,6 +263,9 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
         }
         return NSOrderedSame;
     }];
+    // The next screen shown is built from the new cards
+    self.preparedPaymentMethodsViewController = nil;
+    [self addChanges:STPPaymentContextChangePaymentMethods];
 }
 
 - (void)setSelectedPaymentMethod:(id<STPPaymentMethod>)selectedPaymentMethod {
@@ -200,9 +274,8 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
     }
     if (![_selectedPaymentMethod isEqual:selectedPaymentMethod]) {
         _selectedPaymentMethod = selectedPaymentMethod;
-        stpDispatchToMainThreadIfNecessary(^{
-            [self.delegate paymentContextDidChange:self];
-        });
+        self.preparedPaymentMethodsViewController = nil;
+        [self addChanges:STPPaymentContextChangeSelectedPaymentMethod];
     }
 }
 
@@ -230,6 +303,7 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
 
 - (void)setShippingMethods:(NSArray<PKShippingMethod *> *)shippingMethods {
     _shippingMethods = shippingMethods;
+    [self addChanges:STPPaymentContextChangeShippingMethods];
     if (shippingMethods != nil && self.selectedShippingMethod != nil) {
         if ([shippingMethods count] == 0) {
             self.selectedShippingMethod = nil;
@@ -240,6 +314,32 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
     }
 }
 
+- (void)setSelectedShippingMethod:(PKShippingMethod *)selectedShippingMethod {
+    if (_selectedShippingMethod != selectedShippingMethod && ![_selectedShippingMethod isEqual:selectedShippingMethod]) {
+        _selectedShippingMethod = selectedShippingMethod;
+        [self addChanges:STPPaymentContextChangeSelectedShippingMethod];
+    }
+}
+
+- (void)setShippingAddress:(STPAddress *)shippingAddress {
+    _shippingAddress = shippingAddress;
+    [self addChanges:STPPaymentContextChangeShippingAddress];
+}
+
+- (void)setState:(STPPaymentContextState)state {
+    if (state == _state) {
+        return;
+    }
+    if (_state == STPPaymentContextStateRequestingPayment) {
+        STPSignpostIntervalEnd("Requesting payment", self);
+    }
+    _state = state;
+    STPSignpostEvent("Payment context state", "%lu", (unsigned long)state);
+    if (state == STPPaymentContextStateRequestingPayment) {
+        STPSignpostIntervalBegin("Requesting payment", self);
+    }
+}
+
 #pragma mark - Payment Methods
 
 - (void)presentPaymentMethodsViewController {
@@ -248,14 +348,14 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
 
 - (void)presentPaymentMethodsViewControllerWithNewState:(STPPaymentContextState)state {
     NSCAssert(self.hostViewController != nil, @"hostViewController must not be nil on STPPaymentContext when calling pushPaymentMethodsViewController on it. Next time, set the hostViewController property first!");
+    [self.apiClient prewarmConnection];
     WEAK(self);
     [self.didAppearPromise voidOnSuccess:^{
         STRONG(self);
         if (self.state == STPPaymentContextStateNone) {
             self.state = state;
-            STPPaymentMethodsViewController *paymentMethodsViewController = [[STPPaymentMethodsViewController alloc] initWithPaymentContext:self];
+            STPPaymentMethodsViewController *paymentMethodsViewController = [self dequeuePaymentMethodsViewController];
             self.paymentMethodsViewController = paymentMethodsViewController;
-            paymentMethodsViewController.prefilledInformation = self.prefilledInformation;
             UINavigationController *navigationController = [[UINavigationController alloc] initWithRootViewController:paymentMethodsViewController];
             navigationController.navigationBar.stp_theme = self.theme;
             navigationController.modalPresentationStyle = self.modalPresentationStyle;
@@ -273,20 +373,60 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
         navigationController = self.hostViewController.navigationController;
     }
     NSCAssert(self.hostViewController != nil, @"The payment context's hostViewController is not a navigation controller, or is not contained in one. Either make sure it is inside a navigation controller before calling pushPaymentMethodsViewController, or call presentPaymentMethodsViewController instead.");
+    [self.apiClient prewarmConnection];
     WEAK(self);
     [self.didAppearPromise voidOnSuccess:^{
         STRONG(self);
         if (self.state == STPPaymentContextStateNone) {
             self.state = STPPaymentContextStateShowingRequestedViewController;
 
-            STPPaymentMethodsViewController *paymentMethodsViewController = [[STPPaymentMethodsViewController alloc] initWithPaymentContext:self];
+            STPPaymentMethodsViewController *paymentMethodsViewController = [self dequeuePaymentMethodsViewController];
             self.paymentMethodsViewController = paymentMethodsViewController;
-            paymentMethodsViewController.prefilledInformation = self.prefilledInformation;
             [navigationController pushViewController:paymentMethodsViewController animated:YES];
         }
     }];
 }
 
+- (void)preparePaymentMethodsViewController {
+    WEAK(self);
+    [self.loadingPromise onSuccess:^(__unused STPPaymentMethodTuple *tuple) {
+        STRONG(self);
+        if (!self || self.preparedPaymentMethodsViewController || self.state != STPPaymentContextStateNone) {
+            return;
+        }
+        STPPaymentMethodsViewController *paymentMethodsViewController = [self newPaymentMethodsViewController];
+        // The payment methods have loaded, so loading the view builds the list
+        // straight away, and laying it out builds the cells.
+        // Asking for the host's view would load it, so the screen's bounds
+        // stand in until it has one.
+        UIViewController *hostViewController = self.hostViewController;
+        paymentMethodsViewController.view.frame = hostViewController.isViewLoaded ? hostViewController.view.bounds : [UIScreen mainScreen].bounds;
+        [paymentMethodsViewController.view layoutIfNeeded];
+        self.preparedPaymentMethodsViewController = paymentMethodsViewController;
+    }];
+}
+
+- (STPPaymentMethodsViewController *)newPaymentMethodsViewController {
+    STPPaymentMethodsViewController *paymentMethodsViewController = [[STPPaymentMethodsViewController alloc] initWithPaymentContext:self];
+    paymentMethodsViewController.prefilledInformation = self.prefilledInformation;
+    return paymentMethodsViewController;
+}
+
+/**
+ The prepared payment methods screen if it's still good to show, or else a
+ new one.
+ */
+- (STPPaymentMethodsViewController *)dequeuePaymentMethodsViewController {
+    STPPaymentMethodsViewController *paymentMethodsViewController = self.preparedPaymentMethodsViewController;
+    self.preparedPaymentMethodsViewController = nil;
+    if (paymentMethodsViewController
+        && paymentMethodsViewController.prefilledInformation == self.prefilledInformation
+        && paymentMethodsViewController.shippingAddress == self.shippingAddress) {
+        return paymentMethodsViewController;
+    }
+    return [self newPaymentMethodsViewController];
+}
+
 - (void)paymentMethodsViewController:(__unused STPPaymentMethodsViewController *)paymentMethodsViewController
               didSelectPaymentMethod:(id<STPPaymentMethod>)paymentMethod {
     self.selectedPaymentMethod = paymentMethod;
@@ -402,11 +542,18 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
                       didEnterAddress:(STPAddress *)address
                            completion:(STPShippingMethodsCompletionBlock)completion {
     if ([self.delegate respondsToSelector:@selector(paymentContext:didUpdateShippingAddress:completion:)]) {
-        [self.delegate paymentContext:self didUpdateShippingAddress:address completion:^(STPShippingStatus status, NSError *shippingValidationError, NSArray<PKShippingMethod *> * shippingMethods, PKShippingMethod *selectedMethod) {
-            self.shippingMethods = shippingMethods;
-            if (completion) {
-                completion(status, shippingValidationError, shippingMethods, selectedMethod);
-            }
+        self.shippingMethodsAddress = address;
+        [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+            [delegate paymentContext:self didUpdateShippingAddress:address completion:^(STPShippingStatus status, NSError *shippingValidationError, NSArray<PKShippingMethod *> * shippingMethods, PKShippingMethod *selectedMethod) {
+                stpDispatchToMainThreadIfNecessary(^{
+                    if (address == self.shippingMethodsAddress) {
+                        self.shippingMethods = shippingMethods;
+                    }
+                    if (completion) {
+                        completion(status, shippingValidationError, shippingMethods, selectedMethod);
+                    }
+                });
+            }];
         }];
     }
     else {
@@ -421,7 +568,6 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
                        shippingMethod:(PKShippingMethod *)method {
     self.shippingAddress = address;
     self.selectedShippingMethod = method;
-    [self.delegate paymentContextDidChange:self];
     [self appropriatelyDismissViewController:addressViewController completion:^{
         if (self.state == STPPaymentContextStateRequestingPayment) {
             self.state = STPPaymentContextStateNone;
@@ -480,14 +626,16 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
         else if ([self.selectedPaymentMethod isKindOfClass:[STPCard class]]) {
             self.state = STPPaymentContextStateRequestingPayment;
             STPPaymentResult *result = [[STPPaymentResult alloc] initWithSource:(STPCard *)self.selectedPaymentMethod];
-            [self.delegate paymentContext:self didCreatePaymentResult:result completion:^(NSError * _Nullable error) {
-                stpDispatchToMainThreadIfNecessary(^{
-                    if (error) {
-                        [self didFinishWithStatus:STPPaymentStatusError error:error];
-                    } else {
-                        [self didFinishWithStatus:STPPaymentStatusSuccess error:nil];
-                    }
-                });
+            [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+                [delegate paymentContext:self didCreatePaymentResult:result completion:^(NSError * _Nullable error) {
+                    stpDispatchToMainThreadIfNecessary(^{
+                        if (error) {
+                            [self didFinishWithStatus:STPPaymentStatusError error:error];
+                        } else {
+                            [self didFinishWithStatus:STPPaymentStatusSuccess error:nil];
+                        }
+                    });
+                }];
             }];
         }
         else if ([self.selectedPaymentMethod isKindOfClass:[STPApplePayPaymentMethod class]]) {
@@ -497,8 +645,12 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
                 // Apple Pay always returns a partial address here, so we won't
                 // update self.shippingAddress or self.shippingMethods
                 if ([self.delegate respondsToSelector:@selector(paymentContext:didUpdateShippingAddress:completion:)]) {
-                    [self.delegate paymentContext:self didUpdateShippingAddress:shippingAddress completion:^(STPShippingStatus status, __unused NSError *shippingValidationError, NSArray<PKShippingMethod *> *shippingMethods, __unused PKShippingMethod *selectedMethod) {
-                        completion(status, shippingMethods, self.paymentSummaryItems);
+                    [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+                        [delegate paymentContext:self didUpdateShippingAddress:shippingAddress completion:^(STPShippingStatus status, __unused NSError *shippingValidationError, NSArray<PKShippingMethod *> *shippingMethods, __unused PKShippingMethod *selectedMethod) {
+                            stpDispatchToMainThreadIfNecessary(^{
+                                completion(status, shippingMethods, self.paymentSummaryItems);
+                            });
+                        }];
                     }];
                 }
                 else {
@@ -507,13 +659,15 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
             };
             STPShippingMethodSelectionBlock shippingMethodHandler = ^(PKShippingMethod *shippingMethod, STPPaymentSummaryItemCompletionBlock completion) {
                 self.selectedShippingMethod = shippingMethod;
-                [self.delegate paymentContextDidChange:self];
+                // The summary items below may depend on the delegate's
+                // response, so it can't wait for the next turn.
+                [self deliverPendingChanges];
                 completion(self.paymentSummaryItems);
             };
             STPPaymentAuthorizationBlock paymentHandler = ^(PKPayment *payment) {
                 self.selectedShippingMethod = payment.shippingMethod;
                 self.shippingAddress = [[STPAddress alloc] initWithABRecord:payment.shippingAddress];
-                [self.delegate paymentContextDidChange:self];
+                [self deliverPendingChanges];
             };
             STPApplePayTokenHandlerBlock applePayTokenHandler = ^(STPToken *token, STPErrorBlock tokenCompletion) {
                 [self.apiAdapter attachSourceToCustomer:token completion:^(NSError *tokenError) {
@@ -522,13 +676,13 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
                             tokenCompletion(tokenError);
                         } else {
                             STPPaymentResult *result = [[STPPaymentResult alloc] initWithSource:token.card];
-                            [self.delegate paymentContext:self didCreatePaymentResult:result completion:^(NSError * error) {
-                                // for Apple Pay, the didFinishWithStatus callback is fired later when Apple Pay VC finishes
-                                if (error) {
-                                    tokenCompletion(error);
-                                } else {
-                                    tokenCompletion(nil);
-                                }
+                            [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+                                [delegate paymentContext:self didCreatePaymentResult:result completion:^(NSError * error) {
+                                    // for Apple Pay, the didFinishWithStatus callback is fired later when Apple Pay VC finishes
+                                    stpDispatchToMainThreadIfNecessary(^{
+                                        tokenCompletion(error);
+                                    });
+                                }];
                             }];
                         }
                     });
@@ -561,9 +715,78 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
 - (void)didFinishWithStatus:(STPPaymentStatus)status
                       error:(nullable NSError *)error {
     self.state = STPPaymentContextStateNone;
-    [self.delegate paymentContext:self
-              didFinishWithStatus:status
-                            error:error];
+    [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+        [delegate paymentContext:self
+             didFinishWithStatus:status
+                           error:error];
+    }];
+}
+
+#pragma mark - Delegate
+
+- (dispatch_queue_t)delegateQueue {
+    return _delegateQueue ?: dispatch_get_main_queue();
+}
+
+/**
+ Calls `block` with the delegate on `delegateQueue`: straight away if that's
+ the main queue and we're on it, so the delegate sees changes as they happen,
+ or asynchronously otherwise.
+ */
+- (void)notifyDelegate:(void (^)(id<STPPaymentContextDelegate> delegate))block {
+    id<STPPaymentContextDelegate> delegate = self.delegate;
+    if (!delegate) {
+        return;
+    }
+    dispatch_queue_t queue = self.delegateQueue;
+    void (^notify)(void) = ^{
+        // Only measured when the delegate queue is the main queue
+        CFAbsoluteTime start = STPMainThreadWatchdogBegin();
+        block(delegate);
+        STPMainThreadWatchdogEndBlock(start, block);
+    };
+    if (queue == dispatch_get_main_queue() && [NSThread isMainThread]) {
+        notify();
+    } else {
+        dispatch_async(queue, notify);
+    }
+}
+
+/**
+ Records `changes`, and tells the delegate about everything changed so far on
+ the next turn of the main run loop, in one call.
+ */
+- (void)addChanges:(STPPaymentContextChanges)changes {
+    stpDispatchToMainThreadIfNecessary(^{
+        BOOL scheduled = self.pendingChanges != 0;
+        self.pendingChanges |= changes;
+        if (scheduled) {
+            return;
+        }
+        WEAK(self);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            STRONG(self);
+            [self deliverPendingChanges];
+        });
+    });
+}
+
+/**
+ Tells the delegate about the changes made so far, if any, right away.
+ */
+- (void)deliverPendingChanges {
+    STPPaymentContextChanges changes = self.pendingChanges;
+    if (changes == 0) {
+        return;
+    }
+    self.pendingChanges = 0;
+    [self notifyDelegate:^(id<STPPaymentContextDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(paymentContext:didChange:)]) {
+            [delegate paymentContext:self didChange:changes];
+        } else {
+            [delegate paymentContextDidChange:self];
+        }
+    }];
 }
 
 - (PKPaymentRequest *)buildPaymentRequest {
@@ -596,10 +819,10 @@ typedef NS_ENUM(NSUInteger, STPPaymentContextState) {
         // Using shippingContact if available to work around an iOS10 bug:
         // https://openradar.appspot.com/radar?id=5518219632705536
         if ([paymentRequest respondsToSelector:@selector(shippingContact)]) {
-            paymentRequest.shippingContact = [self.shippingAddress PKContactValue];
+            paymentRequest.shippingContact = [self.shippingAddress cachedPKContactValue];
         }
         else {
-            paymentRequest.shippingAddress = [self.shippingAddress ABRecordValue];
+            paymentRequest.shippingAddress = [self.shippingAddress cachedABRecordValue];
         }
 #pragma clang diagnostic pop
     }
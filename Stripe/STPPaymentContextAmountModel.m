@@ -13,6 +13,16 @@
 @implementation STPPaymentContextAmountModel {
     NSInteger _paymentAmount;
     NSArray<PKPaymentSummaryItem *> *_paymentSummaryItems;
+
+    // Inputs and result of the last paymentSummaryItemsWithCurrency: call.
+    // The Apple Pay sheet asks for the same items repeatedly, so they're only
+    // rebuilt when one of these changes.
+    NSString *_cachedCurrency;
+    NSString *_cachedCompanyName;
+    PKShippingMethod *_cachedShippingMethod;
+    NSDecimalNumber *_cachedShippingAmount;
+    NSString *_cachedShippingLabel;
+    NSArray<PKPaymentSummaryItem *> *_cachedSummaryItems;
 }
 
 FAUXPAS_IGNORED_IN_CLASS(APIAvailability)
@@ -30,7 +40,7 @@ FAUXPAS_IGNORED_IN_CLASS(APIAvailability)
     self = [super init];
     if (self) {
         _paymentAmount = 0;
-        _paymentSummaryItems = paymentSummaryItems;
+        _paymentSummaryItems = [paymentSummaryItems copy];
     }
     return self;
 }
@@ -49,6 +59,38 @@ FAUXPAS_IGNORED_IN_CLASS(APIAvailability)
 - (NSArray<PKPaymentSummaryItem *> *)paymentSummaryItemsWithCurrency:(NSString *)currency
                                                          companyName:(NSString *)companyName
                                                       shippingMethod:(PKShippingMethod *)shippingMethod {
+    if ([self cacheMatchesCurrency:currency companyName:companyName shippingMethod:shippingMethod]) {
+        return _cachedSummaryItems;
+    }
+    NSArray<PKPaymentSummaryItem *> *items = [self buildPaymentSummaryItemsWithCurrency:currency
+                                                                            companyName:companyName
+                                                                         shippingMethod:shippingMethod];
+    _cachedCurrency = [currency copy];
+    _cachedCompanyName = [companyName copy];
+    _cachedShippingMethod = shippingMethod;
+    // PKShippingMethod is mutable, so identity alone isn't enough
+    _cachedShippingAmount = shippingMethod.amount;
+    _cachedShippingLabel = [shippingMethod.label copy];
+    _cachedSummaryItems = items;
+    return items;
+}
+
+- (BOOL)cacheMatchesCurrency:(NSString *)currency
+                 companyName:(NSString *)companyName
+              shippingMethod:(PKShippingMethod *)shippingMethod {
+    if (_cachedSummaryItems == nil) {
+        return NO;
+    }
+    return (shippingMethod == _cachedShippingMethod
+            && (shippingMethod.amount == _cachedShippingAmount || [shippingMethod.amount isEqual:_cachedShippingAmount])
+            && (shippingMethod.label == _cachedShippingLabel || [shippingMethod.label isEqualToString:_cachedShippingLabel])
+            && (currency == _cachedCurrency || [currency isEqualToString:_cachedCurrency])
+            && (companyName == _cachedCompanyName || [companyName isEqualToString:_cachedCompanyName]));
+}
+
+- (NSArray<PKPaymentSummaryItem *> *)buildPaymentSummaryItemsWithCurrency:(NSString *)currency
+                                                              companyName:(NSString *)companyName
+                                                           shippingMethod:(PKShippingMethod *)shippingMethod {
     PKPaymentSummaryItem *shippingItem = nil;
     if (shippingMethod != nil) {
         shippingItem = [PKPaymentSummaryItem summaryItemWithLabel:shippingMethod.label
@@ -15,4 +15,10 @@
 - (void)configureWithPaymentMethod:(id<STPPaymentMethod>)paymentMethod theme:(STPTheme *)theme;
 - (void)configureForNewCardRowWithTheme:(STPTheme *)theme;
 
+/**
+ Swaps the payment method's icon for its decoded thumbnail, if one has been
+ prepared since the cell was configured.
+ */
+- (void)updateIcon;
+
 @end
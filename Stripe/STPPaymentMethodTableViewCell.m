@@ -53,6 +53,7 @@
 }
 
 - (void)configureForNewCardRowWithTheme:(STPTheme *)theme {
+    _paymentMethod = nil;
     _theme = theme;
     self.backgroundColor = [UIColor clearColor];
     self.contentView.backgroundColor = self.theme.secondaryBackgroundColor;
@@ -71,12 +72,21 @@
     _theme = theme;
     self.backgroundColor = [UIColor clearColor];
     self.contentView.backgroundColor = self.theme.secondaryBackgroundColor;
-    self.leftIcon.image = paymentMethod.templateImage;
+    [self updateIcon];
     self.titleLabel.font = self.theme.font;
     self.checkmarkIcon.tintColor = self.theme.accentColor;
     self.selected = NO;
 }
 
+- (void)updateIcon {
+    if (self.paymentMethod == nil) {
+        return;
+    }
+    UIImage *image = self.paymentMethod.templateImage;
+    CGFloat scale = self.window.screen.scale ?: [UIScreen mainScreen].scale;
+    self.leftIcon.image = [STPImageLibrary thumbnailForImage:image scale:scale] ?: image;
+}
+
 - (void)setSelected:(BOOL)selected {
     [super setSelected:selected];
     if (self.paymentMethod != nil) {
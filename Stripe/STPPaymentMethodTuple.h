@@ -12,6 +12,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class STPCustomer;
+
 @interface STPPaymentMethodTuple : NSObject
 
 + (instancetype)tupleWithPaymentMethods:(NSArray<id<STPPaymentMethod>> *)paymentMethods
@@ -20,6 +22,16 @@ NS_ASSUME_NONNULL_BEGIN
 + (instancetype)tupleWithCardTuple:(STPCardTuple *)cardTuple
                    applePayEnabled:(BOOL)applePayEnabled;
 
+/**
+ Builds both of a customer's tuples off the main thread, as a customer can
+ have many sources, and calls `completion` with them on the main queue.
+ Completions run in the order the calls were made. A nil customer has no
+ cards.
+ */
++ (void)getTuplesWithCustomer:(nullable STPCustomer *)customer
+              applePayEnabled:(BOOL)applePayEnabled
+                   completion:(void (^)(STPCardTuple *cardTuple, STPPaymentMethodTuple *paymentMethodTuple))completion;
+
 @property(nonatomic, nullable, readonly)id<STPPaymentMethod> selectedPaymentMethod;
 @property(nonatomic, readonly)NSArray<id<STPPaymentMethod>> *paymentMethods;
 
@@ -9,6 +9,7 @@
 #import "STPPaymentMethodTuple.h"
 #import "STPApplePayPaymentMethod.h"
 #import "STPCard.h"
+#import "STPCustomer.h"
 
 @interface STPPaymentMethodTuple()
 
@@ -45,4 +46,21 @@
     return [self tupleWithPaymentMethods:paymentMethods selectedPaymentMethod:paymentMethod];
 }
 
++ (void)getTuplesWithCustomer:(STPCustomer *)customer
+              applePayEnabled:(BOOL)applePayEnabled
+                   completion:(void (^)(STPCardTuple *, STPPaymentMethodTuple *))completion {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.paymentmethodtuple", DISPATCH_QUEUE_SERIAL);
+    });
+    dispatch_async(queue, ^{
+        STPCardTuple *cardTuple = customer ? [STPCardTuple tupleWithCustomer:customer] : [STPCardTuple tupleWithSelectedCard:nil cards:nil];
+        STPPaymentMethodTuple *paymentMethodTuple = [self tupleWithCardTuple:cardTuple applePayEnabled:applePayEnabled];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(cardTuple, paymentMethodTuple);
+        });
+    });
+}
+
 @end
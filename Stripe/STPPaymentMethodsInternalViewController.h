@@ -18,6 +18,11 @@
 - (void)internalViewControllerDidCreateToken:(STPToken *)token
                                   completion:(STPErrorBlock)completion;
 - (void)internalViewControllerDidCancel;
+/**
+ The user has scrolled close to the last payment method, so more can be
+ loaded if there are any.
+ */
+- (void)internalViewControllerDidScrollNearEnd;
 
 @end
 
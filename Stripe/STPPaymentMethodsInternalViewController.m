@@ -16,12 +16,15 @@
 #import "STPImageLibrary.h"
 #import "STPLocalizationUtils.h"
 #import "STPPaymentMethodTableViewCell.h"
+#import "STPWeakStrongMacros.h"
 #import "UINavigationController+Stripe_Completion.h"
 #import "UITableViewCell+Stripe_Borders.h"
 
 static NSString *const STPPaymentMethodCellReuseIdentifier = @"STPPaymentMethodCellReuseIdentifier";
 static NSInteger STPPaymentMethodCardListSection = 0;
 static NSInteger STPPaymentMethodAddCardSection = 1;
+// How close to the end of the list a row can be before the next page is asked for
+static NSInteger STPPaymentMethodPrefetchDistance = 5;
 
 @interface STPPaymentMethodsInternalViewController()<UITableViewDataSource, UITableViewDelegate, STPAddCardViewControllerDelegate>
 
@@ -51,6 +54,7 @@ static NSInteger STPPaymentMethodAddCardSection = 1;
         _paymentMethods = tuple.paymentMethods;
         _selectedPaymentMethod = tuple.selectedPaymentMethod;
         _delegate = delegate;
+        [self prepareThumbnails];
     }
     self.title = STPLocalizedString(@"Payment Method", @"Title for Payment Method screen");
     return self;
@@ -76,6 +80,32 @@ static NSInteger STPPaymentMethodAddCardSection = 1;
     self.cardImageView.tintColor = self.theme.accentColor;
 }
 
+/**
+ Decodes the icons for the listed payment methods off the main thread, then
+ hands them to any cells that went on screen before they were ready.
+ */
+- (void)prepareThumbnails {
+    NSMutableArray<UIImage *> *images = [NSMutableArray array];
+    for (id<STPPaymentMethod> paymentMethod in self.paymentMethods) {
+        UIImage *image = paymentMethod.templateImage;
+        if (image && ![images containsObject:image]) {
+            [images addObject:image];
+        }
+    }
+    WEAK(self);
+    [STPImageLibrary prepareThumbnailsForImages:images scale:[UIScreen mainScreen].scale completion:^{
+        STRONG(self);
+        if (!self.isViewLoaded) {
+            return;
+        }
+        for (UITableViewCell *cell in self.tableView.visibleCells) {
+            if ([cell isKindOfClass:[STPPaymentMethodTableViewCell class]]) {
+                [(STPPaymentMethodTableViewCell *)cell updateIcon];
+            }
+        }
+    }];
+}
+
 - (void)handleBackOrCancelTapped:(__unused id)sender {
     [self.delegate internalViewControllerDidCancel];
 }
@@ -108,8 +138,8 @@ static NSInteger STPPaymentMethodAddCardSection = 1;
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
     if (indexPath.section == STPPaymentMethodCardListSection) {
         id<STPPaymentMethod> paymentMethod = [self.paymentMethods stp_boundSafeObjectAtIndex:indexPath.row];
-        self.selectedPaymentMethod = paymentMethod;
-        [tableView reloadSections:[NSIndexSet indexSetWithIndex:STPPaymentMethodCardListSection] withRowAnimation:UITableViewRowAnimationFade];
+        [self updateWithPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:self.paymentMethods
+                                                                    selectedPaymentMethod:paymentMethod]];
         [self.delegate internalViewControllerDidSelectPaymentMethod:paymentMethod];
     } else if (indexPath.section == STPPaymentMethodAddCardSection) {
         STPPaymentConfiguration *config = [self.configuration copy];
@@ -129,13 +159,21 @@ static NSInteger STPPaymentMethodAddCardSection = 1;
 }
 
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
+    [self updateBordersForCell:cell atIndexPath:indexPath inTableView:tableView];
+    if (indexPath.section == STPPaymentMethodCardListSection
+        && indexPath.row >= (NSInteger)self.paymentMethods.count - STPPaymentMethodPrefetchDistance) {
+        [self.delegate internalViewControllerDidScrollNearEnd];
+    }
+}
+
+- (void)updateBordersForCell:(UITableViewCell *)cell atIndexPath:(NSIndexPath *)indexPath inTableView:(UITableView *)tableView {
     BOOL topRow = (indexPath.row == 0);
     BOOL bottomRow = ([self tableView:tableView numberOfRowsInSection:indexPath.section] - 1 == indexPath.row);
-    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor];
-    [cell stp_setTopBorderHidden:!topRow];
-    [cell stp_setBottomBorderHidden:!bottomRow];
-    [cell stp_setFakeSeparatorColor:self.theme.quaternaryBackgroundColor];
-    [cell stp_setFakeSeparatorLeftInset:15.0f];
+    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor
+          fakeSeparatorColor:self.theme.quaternaryBackgroundColor
+      fakeSeparatorLeftInset:15.0f
+             topBorderHidden:!topRow
+          bottomBorderHidden:!bottomRow];
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForFooterInSection:(NSInteger)section {
@@ -150,14 +188,70 @@ static NSInteger STPPaymentMethodAddCardSection = 1;
 }
 
 - (void)updateWithPaymentMethodTuple:(STPPaymentMethodTuple *)tuple {
-    if ([self.paymentMethods isEqualToArray:tuple.paymentMethods] &&
-        [self.selectedPaymentMethod isEqual:tuple.selectedPaymentMethod]) {
+    NSArray<id<STPPaymentMethod>> *oldPaymentMethods = self.paymentMethods;
+    NSArray<id<STPPaymentMethod>> *newPaymentMethods = tuple.paymentMethods;
+    id<STPPaymentMethod> oldSelection = self.selectedPaymentMethod;
+    id<STPPaymentMethod> newSelection = tuple.selectedPaymentMethod;
+    BOOL selectionChanged = (oldSelection || newSelection) && ![oldSelection isEqual:newSelection];
+    if ([oldPaymentMethods isEqualToArray:newPaymentMethods] && !selectionChanged) {
+        return;
+    }
+    self.paymentMethods = newPaymentMethods;
+    self.selectedPaymentMethod = newSelection;
+    [self prepareThumbnails];
+    if (!self.isViewLoaded) {
         return;
     }
-    self.paymentMethods = tuple.paymentMethods;
-    self.selectedPaymentMethod = tuple.selectedPaymentMethod;
-    NSMutableIndexSet *sections = [NSMutableIndexSet indexSetWithIndex:STPPaymentMethodCardListSection];
-    [self.tableView reloadSections:sections withRowAnimation:UITableViewRowAnimationAutomatic];
+
+    // Work out the rows that came and went. Payment methods compare by
+    // identity (cards by ID), so a kept row's content is unchanged and only
+    // needs reloading if its selection flipped.
+    NSMutableArray<NSIndexPath *> *deletedRows = [NSMutableArray array];
+    NSMutableArray<NSIndexPath *> *reloadedRows = [NSMutableArray array];
+    NSMutableArray<id<STPPaymentMethod>> *keptPaymentMethods = [NSMutableArray array];
+    [oldPaymentMethods enumerateObjectsUsingBlock:^(id<STPPaymentMethod> paymentMethod, NSUInteger idx, __unused BOOL *stop) {
+        NSIndexPath *indexPath = [NSIndexPath indexPathForRow:(NSInteger)idx inSection:STPPaymentMethodCardListSection];
+        if (![newPaymentMethods containsObject:paymentMethod]) {
+            [deletedRows addObject:indexPath];
+            return;
+        }
+        [keptPaymentMethods addObject:paymentMethod];
+        if (selectionChanged && ([paymentMethod isEqual:oldSelection] || [paymentMethod isEqual:newSelection])) {
+            [reloadedRows addObject:indexPath];
+        }
+    }];
+    NSMutableArray<NSIndexPath *> *insertedRows = [NSMutableArray array];
+    NSMutableArray<id<STPPaymentMethod>> *keptInNewOrder = [NSMutableArray array];
+    [newPaymentMethods enumerateObjectsUsingBlock:^(id<STPPaymentMethod> paymentMethod, NSUInteger idx, __unused BOOL *stop) {
+        if ([oldPaymentMethods containsObject:paymentMethod]) {
+            [keptInNewOrder addObject:paymentMethod];
+        } else {
+            [insertedRows addObject:[NSIndexPath indexPathForRow:(NSInteger)idx inSection:STPPaymentMethodCardListSection]];
+        }
+    }];
+
+    if (![keptPaymentMethods isEqualToArray:keptInNewOrder]) {
+        // Rows moved relative to each other; that's rare enough not to be worth
+        // expressing as moves.
+        [self.tableView reloadSections:[NSIndexSet indexSetWithIndex:STPPaymentMethodCardListSection]
+                      withRowAnimation:UITableViewRowAnimationAutomatic];
+        return;
+    }
+    [self.tableView beginUpdates];
+    [self.tableView deleteRowsAtIndexPaths:deletedRows withRowAnimation:UITableViewRowAnimationAutomatic];
+    [self.tableView insertRowsAtIndexPaths:insertedRows withRowAnimation:UITableViewRowAnimationAutomatic];
+    [self.tableView reloadRowsAtIndexPaths:reloadedRows withRowAnimation:UITableViewRowAnimationFade];
+    [self.tableView endUpdates];
+
+    // Inserting or deleting at either end moves the top and bottom borders.
+    if (deletedRows.count > 0 || insertedRows.count > 0) {
+        for (NSIndexPath *indexPath in self.tableView.indexPathsForVisibleRows) {
+            UITableViewCell *cell = [self.tableView cellForRowAtIndexPath:indexPath];
+            if (cell && indexPath.section == STPPaymentMethodCardListSection) {
+                [self updateBordersForCell:cell atIndexPath:indexPath inTableView:self.tableView];
+            }
+        }
+    }
 }
 
 - (void)addCardViewControllerDidCancel:(__unused STPAddCardViewController *)addCardViewController {
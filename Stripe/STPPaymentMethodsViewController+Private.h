@@ -23,4 +23,15 @@
                       shippingAddress:(STPAddress *)shippingAddress
                              delegate:(id<STPPaymentMethodsViewControllerDelegate>)delegate;
 
+/**
+ Refreshes the card list in place, e.g. once a cached customer has been
+ revalidated. Does nothing until the list has been shown.
+ */
+- (void)updateWithPaymentMethodTuple:(STPPaymentMethodTuple *)tuple;
+
+/**
+ The shipping address the add card screen is prefilled with.
+ */
+- (STPAddress *)shippingAddress;
+
 @end
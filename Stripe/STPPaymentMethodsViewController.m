@@ -10,9 +10,11 @@
 
 #import "STPAPIClient.h"
 #import "STPAddCardViewController+Private.h"
+#import "STPAnalyticsClient.h"
 #import "STPCard.h"
 #import "STPColorUtils.h"
 #import "STPCoreViewController+Private.h"
+#import "STPCustomerCache.h"
 #import "STPDispatchFunctions.h"
 #import "STPLocalizationUtils.h"
 #import "STPPaymentActivityIndicatorView.h"
@@ -43,9 +45,17 @@
 @property(nonatomic, weak)STPPaymentActivityIndicatorView *activityIndicator;
 @property(nonatomic, weak)UIViewController *internalViewController;
 @property(nonatomic)BOOL loading;
+// Paging through the customer's sources, if the adapter supports it
+@property(nonatomic)BOOL hasMoreSources;
+@property(nonatomic)BOOL loadingMoreSources;
+// The last source received, of any type, which is where the next page starts
+@property(nonatomic, copy, nullable)NSString *sourcesCursor;
+@property(nonatomic, copy, nullable)NSString *defaultSourceID;
 
 @end
 
+static NSUInteger const STPPaymentMethodsSourcesPageSize = 20;
+
 @implementation STPPaymentMethodsViewController
 
 - (instancetype)initWithPaymentContext:(STPPaymentContext *)paymentContext {
@@ -72,30 +82,46 @@
 
 - (STPPromise<STPPaymentMethodTuple *>*)retrieveCustomerWithConfiguration:(STPPaymentConfiguration *)configuration
                                                                apiAdapter:(id<STPBackendAPIAdapter>)apiAdapter {
+    return [self retrieveCustomerWithConfiguration:configuration apiAdapter:apiAdapter forceRefresh:NO];
+}
+
+- (STPPromise<STPPaymentMethodTuple *>*)retrieveCustomerWithConfiguration:(STPPaymentConfiguration *)configuration
+                                                               apiAdapter:(id<STPBackendAPIAdapter>)apiAdapter
+                                                             forceRefresh:(BOOL)forceRefresh {
     STPPromise<STPPaymentMethodTuple *> *promise = [STPPromise new];
-    [apiAdapter retrieveCustomer:^(STPCustomer * _Nullable customer, NSError * _Nullable error) {
-        stpDispatchToMainThreadIfNecessary(^{
+    // The tuples are built in the order they're asked for, so the cached one
+    // is always in place before the request below is compared with it.
+    __block STPCardTuple *cachedTuple;
+    if (configuration.customerCachingEnabled && !forceRefresh) {
+        STPCustomer *cachedCustomer = [[STPCustomerCache sharedCache] customerForAPIAdapter:apiAdapter];
+        if (cachedCustomer) {
+            [STPPaymentMethodTuple getTuplesWithCustomer:cachedCustomer applePayEnabled:configuration.applePayEnabled completion:^(STPCardTuple *cardTuple, STPPaymentMethodTuple *tuple) {
+                cachedTuple = cardTuple;
+                [promise succeed:tuple];
+            }];
+        }
+    }
+    WEAK(self);
+    STPCustomerCompletionBlock completion = ^(STPCustomer * _Nullable customer, NSError * _Nullable error) {
+        [STPPaymentMethodTuple getTuplesWithCustomer:customer applePayEnabled:configuration.applePayEnabled completion:^(STPCardTuple *cardTuple, STPPaymentMethodTuple *tuple) {
             if (error) {
                 [promise fail:error];
-            } else {
-                STPCard *selectedCard;
-                NSMutableArray<STPCard *> *cards = [NSMutableArray array];
-                for (id<STPSourceProtocol> source in customer.sources) {
-                    if ([source isKindOfClass:[STPCard class]]) {
-                        STPCard *card = (STPCard *)source;
-                        [cards addObject:card];
-                        if ([card.stripeID isEqualToString:customer.defaultSource.stripeID]) {
-                            selectedCard = card;
-                        }
-                    }
-                }
-                STPCardTuple *cardTuple = [STPCardTuple tupleWithSelectedCard:selectedCard cards:cards];
-                STPPaymentMethodTuple *tuple = [STPPaymentMethodTuple tupleWithCardTuple:cardTuple
-                                                                         applePayEnabled:configuration.applePayEnabled];
+                return;
+            }
+            if (!cachedTuple) {
                 [promise succeed:tuple];
             }
-        });
-    }];
+            else if (![cardTuple isEqualToCardTuple:cachedTuple]) {
+                STRONG(self);
+                [self updateWithPaymentMethodTuple:tuple];
+            }
+        }];
+    };
+    if (forceRefresh) {
+        [[STPCustomerCache sharedCache] refreshCustomerWithAPIAdapter:apiAdapter completion:completion];
+    } else {
+        [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:apiAdapter completion:completion];
+    }
     return promise;
 }
 
@@ -148,6 +174,13 @@
     self.loading = YES;
 }
 
+- (void)viewWillAppear:(BOOL)animated {
+    [super viewWillAppear:animated];
+    // Not on init or view load, as STPPaymentContext builds the screen ahead
+    // of time and may never show it.
+    [STPAnalyticsClient trackProductUsage:STPAnalyticsProductUsagePaymentMethodsViewController];
+}
+
 - (void)viewDidLayoutSubviews {
     [super viewDidLayoutSubviews];
     CGFloat centerX = (self.view.frame.size.width - self.activityIndicator.frame.size.width) / 2;
@@ -177,13 +210,10 @@
 
 - (void)internalViewControllerDidCreateToken:(STPToken *)token completion:(STPErrorBlock)completion {
     [self.apiAdapter attachSourceToCustomer:token completion:^(NSError *error) {
-        STPPromise<STPPaymentMethodTuple *> *promise = [self retrieveCustomerWithConfiguration:self.configuration apiAdapter:self.apiAdapter];
+        STPPromise<STPPaymentMethodTuple *> *promise = [self retrieveCustomerWithConfiguration:self.configuration apiAdapter:self.apiAdapter forceRefresh:YES];
         [promise onSuccess:^(STPPaymentMethodTuple *tuple) {
             stpDispatchToMainThreadIfNecessary(^{
-                if ([self.internalViewController isKindOfClass:[STPPaymentMethodsInternalViewController class]]) {
-                    STPPaymentMethodsInternalViewController *paymentMethodsVC = (STPPaymentMethodsInternalViewController *)self.internalViewController;
-                    [paymentMethodsVC updateWithPaymentMethodTuple:tuple];
-                }
+                [self updateWithPaymentMethodTuple:tuple];
             });
         }];
 
@@ -200,6 +230,54 @@
     [self.delegate paymentMethodsViewControllerDidCancel:self];
 }
 
+- (void)internalViewControllerDidScrollNearEnd {
+    if (!self.hasMoreSources || self.loadingMoreSources
+        || ![self.apiAdapter respondsToSelector:@selector(retrieveCustomerSourcesStartingAfter:limit:completion:)]) {
+        return;
+    }
+    // Cards come before Apple Pay, so new ones go after the last one
+    STPCard *lastCard;
+    for (id<STPPaymentMethod> paymentMethod in self.paymentMethods) {
+        if ([paymentMethod isKindOfClass:[STPCard class]]) {
+            lastCard = (STPCard *)paymentMethod;
+        }
+    }
+    self.loadingMoreSources = YES;
+    WEAK(self);
+    [self.apiAdapter retrieveCustomerSourcesStartingAfter:self.sourcesCursor
+                                                    limit:STPPaymentMethodsSourcesPageSize
+                                               completion:^(NSArray<id<STPSourceProtocol>> *sources, BOOL hasMore, NSError *error) {
+        stpDispatchToMainThreadIfNecessary(^{
+            STRONG(self);
+            self.loadingMoreSources = NO;
+            if (error) {
+                // Tried again the next time the user scrolls to the end
+                return;
+            }
+            self.hasMoreSources = hasMore;
+            self.sourcesCursor = sources.lastObject.stripeID ?: self.sourcesCursor;
+            // The new cards go after the loaded ones and before Apple Pay
+            NSMutableArray<id<STPPaymentMethod>> *paymentMethods = [self.paymentMethods mutableCopy];
+            NSUInteger insertionIndex = lastCard ? [paymentMethods indexOfObject:lastCard] + 1 : 0;
+            NSSet *loadedPaymentMethods = [NSSet setWithArray:self.paymentMethods];
+            id<STPPaymentMethod> selectedPaymentMethod = self.selectedPaymentMethod;
+            for (id<STPSourceProtocol> source in sources) {
+                if (![source isKindOfClass:[STPCard class]] || [loadedPaymentMethods containsObject:source]) {
+                    continue;
+                }
+                STPCard *card = (STPCard *)source;
+                [paymentMethods insertObject:card atIndex:insertionIndex++];
+                // The default card may not have been on the first page
+                if (![selectedPaymentMethod isKindOfClass:[STPCard class]] && [card.stripeID isEqualToString:self.defaultSourceID]) {
+                    selectedPaymentMethod = card;
+                }
+            }
+            [self updateWithPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:paymentMethods
+                                                                        selectedPaymentMethod:selectedPaymentMethod]];
+        });
+    }];
+}
+
 - (void)addCardViewControllerDidCancel:(__unused STPAddCardViewController *)addCardViewController {
     // Add card is only our direct delegate if there are no other payment methods possible
     // and we skipped directly to this screen. In this case, a cancel from it is the same as a cancel to us.
@@ -254,6 +332,11 @@
             STRONG(self);
             self.paymentMethods = tuple.paymentMethods;
             self.selectedPaymentMethod = tuple.selectedPaymentMethod;
+            // The tuple was built from the customer the cache last saw
+            STPCustomer *customer = [[STPCustomerCache sharedCache] customerForAPIAdapter:apiAdapter];
+            self.hasMoreSources = customer.hasMoreSources;
+            self.sourcesCursor = customer.sources.lastObject.stripeID;
+            self.defaultSourceID = customer.defaultSource.stripeID;
         }];
         [[[self.stp_didAppearPromise voidFlatMap:^STPPromise * _Nonnull{
             return loadingPromise;
@@ -271,4 +354,13 @@
     return self;
 }
 
+- (void)updateWithPaymentMethodTuple:(STPPaymentMethodTuple *)tuple {
+    self.paymentMethods = tuple.paymentMethods;
+    self.selectedPaymentMethod = tuple.selectedPaymentMethod;
+    if ([self.internalViewController isKindOfClass:[STPPaymentMethodsInternalViewController class]]) {
+        STPPaymentMethodsInternalViewController *paymentMethodsVC = (STPPaymentMethodsInternalViewController *)self.internalViewController;
+        [paymentMethodsVC updateWithPaymentMethodTuple:tuple];
+    }
+}
+
 @end
@@ -0,0 +1,62 @@
+//
+//  STPPerformanceCounters.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <stdatomic.h>
+
+#import "STPPerformanceSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, STPPerformanceCounter) {
+    STPPerformanceCounterTokensRequests,
+    STPPerformanceCounterSourcesRequests,
+    STPPerformanceCounterOtherRequests,
+    STPPerformanceCounterBytesSent,
+    STPPerformanceCounterBytesReceived,
+    STPPerformanceCounterDecodeMicroseconds,
+    STPPerformanceCounterSourcePolls,
+    STPPerformanceCounterPromiseHops,
+    STPPerformanceCounterImageCacheHits,
+    STPPerformanceCounterImageCacheMisses,
+    STPPerformanceCounterBINRangeLookups,
+    STPPerformanceCounterAnalyticsEventsSent,
+    STPPerformanceCounterAnalyticsEventsDropped,
+    STPPerformanceCounterCount,
+};
+
+/**
+ Only touched through the functions below. Counts only ever go up, and nothing
+ is ordered against them, so relaxed atomics are enough and no lock is needed.
+ */
+FOUNDATION_EXPORT _Atomic(uint64_t) STPPerformanceCounterValues[STPPerformanceCounterCount];
+
+static inline void STPPerformanceCounterAdd(STPPerformanceCounter counter, uint64_t amount) {
+    atomic_fetch_add_explicit(&STPPerformanceCounterValues[counter], amount, memory_order_relaxed);
+}
+
+static inline void STPPerformanceCounterIncrement(STPPerformanceCounter counter) {
+    STPPerformanceCounterAdd(counter, 1);
+}
+
+/**
+ The request counter for an API endpoint such as `tokens` or `sources/src_123`.
+ */
+FOUNDATION_EXPORT STPPerformanceCounter STPPerformanceCounterForEndpoint(NSString *endpoint);
+
+@interface STPPerformanceSnapshot ()
+
+/**
+ The counts so far.
+ */
++ (instancetype)currentSnapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
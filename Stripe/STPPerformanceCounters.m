@@ -0,0 +1,112 @@
+//
+//  STPPerformanceCounters.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPPerformanceCounters.h"
+
+NSString *const STPPerformanceEndpointOther = @"other";
+
+static NSString *const TokensEndpoint = @"tokens";
+static NSString *const SourcesEndpoint = @"sources";
+
+_Atomic(uint64_t) STPPerformanceCounterValues[STPPerformanceCounterCount];
+
+static BOOL STPEndpointHasFirstComponent(NSString *endpoint, NSString *component) {
+    return [endpoint hasPrefix:component]
+        && (endpoint.length == component.length || [endpoint characterAtIndex:component.length] == '/');
+}
+
+STPPerformanceCounter STPPerformanceCounterForEndpoint(NSString *endpoint) {
+    if (STPEndpointHasFirstComponent(endpoint, TokensEndpoint)) {
+        return STPPerformanceCounterTokensRequests;
+    }
+    if (STPEndpointHasFirstComponent(endpoint, SourcesEndpoint)) {
+        return STPPerformanceCounterSourcesRequests;
+    }
+    return STPPerformanceCounterOtherRequests;
+}
+
+@implementation STPPerformanceSnapshot {
+    uint64_t _values[STPPerformanceCounterCount];
+}
+
++ (instancetype)currentSnapshot {
+    STPPerformanceSnapshot *snapshot = [self new];
+    for (NSUInteger i = 0; i < STPPerformanceCounterCount; i++) {
+        snapshot->_values[i] = atomic_load_explicit(&STPPerformanceCounterValues[i], memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+- (STPPerformanceSnapshot *)snapshotBySubtractingSnapshot:(STPPerformanceSnapshot *)snapshot {
+    STPPerformanceSnapshot *difference = [[self class] new];
+    for (NSUInteger i = 0; i < STPPerformanceCounterCount; i++) {
+        // Counts never go down, but don't wrap around if the snapshots were
+        // passed the wrong way round.
+        difference->_values[i] = _values[i] >= snapshot->_values[i] ? _values[i] - snapshot->_values[i] : 0;
+    }
+    return difference;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)requestCounts {
+    return @{
+             TokensEndpoint: @(_values[STPPerformanceCounterTokensRequests]),
+             SourcesEndpoint: @(_values[STPPerformanceCounterSourcesRequests]),
+             STPPerformanceEndpointOther: @(_values[STPPerformanceCounterOtherRequests]),
+             };
+}
+
+- (uint64_t)bytesSent {
+    return _values[STPPerformanceCounterBytesSent];
+}
+
+- (uint64_t)bytesReceived {
+    return _values[STPPerformanceCounterBytesReceived];
+}
+
+- (NSTimeInterval)decodeDuration {
+    return _values[STPPerformanceCounterDecodeMicroseconds] / 1e6;
+}
+
+- (uint64_t)sourcePollCount {
+    return _values[STPPerformanceCounterSourcePolls];
+}
+
+- (uint64_t)promiseHopCount {
+    return _values[STPPerformanceCounterPromiseHops];
+}
+
+- (uint64_t)imageCacheHitCount {
+    return _values[STPPerformanceCounterImageCacheHits];
+}
+
+- (uint64_t)imageCacheMissCount {
+    return _values[STPPerformanceCounterImageCacheMisses];
+}
+
+- (uint64_t)binRangeLookupCount {
+    return _values[STPPerformanceCounterBINRangeLookups];
+}
+
+- (uint64_t)analyticsEventsSentCount {
+    return _values[STPPerformanceCounterAnalyticsEventsSent];
+}
+
+- (uint64_t)analyticsEventsDroppedCount {
+    return _values[STPPerformanceCounterAnalyticsEventsDropped];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; requests = %@; sent = %llu bytes; received = %llu bytes; decoding = %.1f ms; source polls = %llu; promise hops = %llu; image cache = %llu hits, %llu misses; BIN range lookups = %llu; analytics = %llu sent, %llu dropped>",
+            NSStringFromClass([self class]), self,
+            self.requestCounts, self.bytesSent, self.bytesReceived, self.decodeDuration * 1000,
+            self.sourcePollCount, self.promiseHopCount,
+            self.imageCacheHitCount, self.imageCacheMissCount, self.binRangeLookupCount,
+            self.analyticsEventsSentCount, self.analyticsEventsDroppedCount];
+}
+
+@end
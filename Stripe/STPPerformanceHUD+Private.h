@@ -0,0 +1,34 @@
+//
+//  STPPerformanceHUD+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPPerformanceHUD.h"
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#if DEBUG
+
+@interface STPPerformanceHUD ()
+
+/**
+ Called by Stripe's view controllers as they load and appear. The HUD's count
+ of main thread time starts over whenever a different screen calls this.
+ */
++ (void)noteCurrentScreen:(UIViewController *)screen;
+
+/**
+ The text the HUD shows right now.
+ */
++ (NSString *)currentText;
+
+@end
+
+#endif
+
+NS_ASSUME_NONNULL_END
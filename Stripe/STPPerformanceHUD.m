@@ -0,0 +1,183 @@
+//
+//  STPPerformanceHUD.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPPerformanceHUD.h"
+#import "STPPerformanceHUD+Private.h"
+
+#if DEBUG
+#import "STPAPIRequest.h"
+#import "STPAnalyticsClient.h"
+#import "STPCoreViewController.h"
+#import "STPExtensionMode.h"
+#import "STPMainThreadWatchdog.h"
+#import "STPPerformanceCounters.h"
+#import "STPSourcePollScheduler.h"
+#endif
+
+@implementation STPPerformanceHUD
+
+#if DEBUG
+
+static NSTimeInterval const RefreshInterval = 1;
+static CGFloat const Margin = 8;
+// Clear of the status bar, before iOS 11 gives the safe area
+static CGFloat const StatusBarInset = 20;
+
+// Only touched on the main thread
+static UIWindow *HUDWindow;
+static UILabel *HUDLabel;
+static NSTimer *RefreshTimer;
+// The counts when the HUD was shown, and at the last refresh
+static STPPerformanceSnapshot *ShownSnapshot;
+static STPPerformanceSnapshot *LastSnapshot;
+static CFAbsoluteTime LastRefreshTime;
+static __weak UIViewController *CurrentScreen;
+static NSString *CurrentScreenName;
+static NSTimeInterval CurrentScreenMainThreadTime;
+
++ (void)show {
+    if (HUDWindow) {
+        return;
+    }
+    HUDWindow = [[UIWindow alloc] initWithFrame:CGRectZero];
+    HUDWindow.windowLevel = UIWindowLevelAlert + 1;
+    // Touches go through to the windows beneath
+    HUDWindow.userInteractionEnabled = NO;
+    HUDWindow.backgroundColor = [UIColor colorWithWhite:0 alpha:0.75f];
+    // UIKit expects every window to have one, e.g. to ask about rotation
+    UIViewController *rootViewController = [UIViewController new];
+    rootViewController.view.backgroundColor = [UIColor clearColor];
+    HUDWindow.rootViewController = rootViewController;
+    HUDLabel = [UILabel new];
+    HUDLabel.numberOfLines = 0;
+    HUDLabel.font = [UIFont fontWithName:@"Menlo" size:10];
+    HUDLabel.textColor = [UIColor whiteColor];
+    [rootViewController.view addSubview:HUDLabel];
+    HUDWindow.hidden = NO;
+
+    ShownSnapshot = [STPPerformanceSnapshot currentSnapshot];
+    LastSnapshot = ShownSnapshot;
+    LastRefreshTime = CFAbsoluteTimeGetCurrent();
+    CurrentScreenMainThreadTime = 0;
+    [STPMainThreadWatchdog setDurationObserver:^(NSTimeInterval duration) {
+        CurrentScreenMainThreadTime += duration;
+    }];
+    // Common modes, so the HUD keeps up while a table view scrolls
+    RefreshTimer = [NSTimer timerWithTimeInterval:RefreshInterval
+                                           target:self
+                                         selector:@selector(refresh)
+                                         userInfo:nil
+                                          repeats:YES];
+    [[NSRunLoop mainRunLoop] addTimer:RefreshTimer forMode:NSRunLoopCommonModes];
+    [self refresh];
+}
+
++ (void)hide {
+    if (!HUDWindow) {
+        return;
+    }
+    [STPMainThreadWatchdog setDurationObserver:nil];
+    [RefreshTimer invalidate];
+    RefreshTimer = nil;
+    HUDWindow.hidden = YES;
+    HUDWindow = nil;
+    HUDLabel = nil;
+    ShownSnapshot = nil;
+    LastSnapshot = nil;
+}
+
++ (void)noteCurrentScreen:(UIViewController *)screen {
+    // Screens embedded in another Stripe screen count as part of it
+    while ([screen.parentViewController isKindOfClass:[STPCoreViewController class]]) {
+        screen = screen.parentViewController;
+    }
+    if (screen == CurrentScreen) {
+        return;
+    }
+    CurrentScreen = screen;
+    CurrentScreenName = NSStringFromClass([screen class]);
+    CurrentScreenMainThreadTime = 0;
+}
+
++ (void)refresh {
+    HUDLabel.text = [self currentText];
+    LastSnapshot = [STPPerformanceSnapshot currentSnapshot];
+    LastRefreshTime = CFAbsoluteTimeGetCurrent();
+
+    UIEdgeInsets insets = [self safeAreaInsets];
+    CGSize screenSize = [UIScreen mainScreen].bounds.size;
+    CGSize size = [HUDLabel sizeThatFits:CGSizeMake(screenSize.width - insets.left - insets.right - 4 * Margin, CGFLOAT_MAX)];
+    HUDWindow.frame = CGRectMake(insets.left + Margin, insets.top + Margin, size.width + 2 * Margin, size.height + 2 * Margin);
+    HUDLabel.frame = CGRectMake(Margin, Margin, size.width, size.height);
+}
+
+/**
+ The app's safe area, e.g. below the notch. The HUD's own window is too small
+ to have the app's, so it's read off the key window.
+ */
++ (UIEdgeInsets)safeAreaInsets {
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+    if (@available(iOS 11.0, *)) {
+        UIWindow *keyWindow = stpSharedApplication().keyWindow;
+        if (keyWindow) {
+            return keyWindow.safeAreaInsets;
+        }
+    }
+#endif
+    return UIEdgeInsetsMake(StatusBarInset, 0, 0, 0);
+}
+
++ (NSString *)currentText {
+    STPPerformanceSnapshot *snapshot = [STPPerformanceSnapshot currentSnapshot];
+    STPPerformanceSnapshot *sinceShown = ShownSnapshot ? [snapshot snapshotBySubtractingSnapshot:ShownSnapshot] : snapshot;
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+
+    [lines addObject:@"Requests"];
+    [self addLines:[STPAPIRequest inFlightRequestDescriptions] toLines:lines];
+    [lines addObject:@"Source polls"];
+    [self addLines:[STPSourcePollScheduler pollerDescriptions] toLines:lines];
+
+    [lines addObject:[NSString stringWithFormat:@"Analytics: %lu waiting, %llu sent, %llu dropped",
+                      (unsigned long)[[STPAnalyticsClient sharedClient] pendingEventCount],
+                      sinceShown.analyticsEventsSentCount, sinceShown.analyticsEventsDroppedCount]];
+
+    uint64_t imageLookups = sinceShown.imageCacheHitCount + sinceShown.imageCacheMissCount;
+    NSString *hitRate = imageLookups > 0 ? [NSString stringWithFormat:@" (%.0f%% hits)", 100.0 * sinceShown.imageCacheHitCount / imageLookups] : @"";
+    [lines addObject:[NSString stringWithFormat:@"Images: %llu hits, %llu misses%@",
+                      sinceShown.imageCacheHitCount, sinceShown.imageCacheMissCount, hitRate]];
+
+    NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - LastRefreshTime;
+    uint64_t recentLookups = LastSnapshot ? [snapshot snapshotBySubtractingSnapshot:LastSnapshot].binRangeLookupCount : 0;
+    [lines addObject:[NSString stringWithFormat:@"Card brand lookups: %llu (%.0f/s)",
+                      sinceShown.binRangeLookupCount, elapsed > 0 ? recentLookups / elapsed : 0]];
+
+    [lines addObject:[NSString stringWithFormat:@"Main thread: %.0f ms in %@",
+                      CurrentScreenMainThreadTime * 1000, CurrentScreenName ?: @"no Stripe screen"]];
+    return [lines componentsJoinedByString:@"\n"];
+}
+
++ (void)addLines:(NSArray<NSString *> *)items toLines:(NSMutableArray<NSString *> *)lines {
+    if (items.count == 0) {
+        [lines addObject:@"  none"];
+    }
+    for (NSString *item in items) {
+        [lines addObject:[@"  " stringByAppendingString:item]];
+    }
+}
+
+#else
+
++ (void)show {
+}
+
++ (void)hide {
+}
+
+#endif
+
+@end
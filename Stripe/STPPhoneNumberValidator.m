@@ -9,8 +9,118 @@
 #import "STPPhoneNumberValidator.h"
 
 
-#import "NSString+Stripe.h"
 #import "STPCardValidator.h"
+
+/**
+ *  A national phone number layout. `pattern` uses '#' for each digit slot and
+ *  any other character as a literal. When `maxDigits` is non-zero the number is
+ *  truncated to that many digits; otherwise extra digits are appended as typed.
+ */
+typedef struct {
+    const char *countryCode;
+    const char *pattern;
+    NSUInteger maxDigits;
+} STPPhoneNumberFormat;
+
+static const STPPhoneNumberFormat STPPhoneNumberFormats[] = {
+    {"US", "(###) ###-####", 10},
+    {"CA", "(###) ###-####", 10},
+    {"GB", "##### ######", 0},
+    {"FR", "## ## ## ## ##", 0},
+    {"ES", "### ## ## ##", 0},
+    {"AU", "#### ### ###", 0},
+};
+
+static const STPPhoneNumberFormat *STPPhoneNumberFormatForCountryCode(NSString *countryCode) {
+    if (countryCode.length != 2) {
+        return NULL;
+    }
+    const char *code = countryCode.UTF8String;
+    for (size_t i = 0; i < sizeof(STPPhoneNumberFormats) / sizeof(STPPhoneNumberFormats[0]); i++) {
+        if (strcmp(STPPhoneNumberFormats[i].countryCode, code) == 0) {
+            return &STPPhoneNumberFormats[i];
+        }
+    }
+    return NULL;
+}
+
+// Output for typical phone numbers fits in this many characters, so formatting
+// a keystroke's worth of input needs no allocation beyond the resulting string.
+static const NSUInteger STPPhoneNumberFormatterBufferLength = 64;
+
+/**
+ *  Lays `string` out according to `format` in a single pass. When `digitsOnly`
+ *  is YES any non-digit characters in the input are ignored, which lets the
+ *  sanitized formatter skip building an intermediate string. Literals are only
+ *  emitted once the group before them is complete, and nothing is formatted
+ *  until the first group is complete, matching how the US format always behaved.
+ */
+static NSString *STPFormattedPhoneNumber(NSString *string, const STPPhoneNumberFormat *format, BOOL digitsOnly) {
+    NSUInteger length = string.length;
+    size_t patternLength = strlen(format->pattern);
+    NSUInteger capacity = length + patternLength;
+
+    unichar formattedStorage[STPPhoneNumberFormatterBufferLength];
+    unichar rawStorage[STPPhoneNumberFormatterBufferLength];
+    unichar *formatted = formattedStorage;
+    unichar *raw = rawStorage;
+    if (capacity > STPPhoneNumberFormatterBufferLength) {
+        formatted = malloc(capacity * sizeof(unichar));
+        raw = malloc(capacity * sizeof(unichar));
+    }
+
+    NSUInteger firstGroupLength = 0;
+    for (size_t i = 0; i < patternLength; i++) {
+        if (format->pattern[i] == '#') {
+            firstGroupLength++;
+        } else if (firstGroupLength > 0) {
+            break;
+        }
+    }
+
+    CFStringInlineBuffer inlineBuffer;
+    CFStringInitInlineBuffer((__bridge CFStringRef)string, &inlineBuffer, CFRangeMake(0, (CFIndex)length));
+
+    NSUInteger formattedLength = 0;
+    NSUInteger rawLength = 0;
+    size_t patternIndex = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar character = CFStringGetCharacterFromInlineBuffer(&inlineBuffer, (CFIndex)i);
+        if (digitsOnly && (character < '0' || character > '9')) {
+            continue;
+        }
+        if (format->maxDigits > 0 && rawLength == format->maxDigits) {
+            break;
+        }
+        raw[rawLength++] = character;
+        while (patternIndex < patternLength && format->pattern[patternIndex] != '#') {
+            formatted[formattedLength++] = (unichar)format->pattern[patternIndex++];
+        }
+        if (patternIndex < patternLength) {
+            patternIndex++;
+        }
+        formatted[formattedLength++] = character;
+    }
+    // Close the group that was just completed, e.g. "(555" becomes "(555) ".
+    if (patternIndex > 0) {
+        while (patternIndex < patternLength && format->pattern[patternIndex] != '#') {
+            formatted[formattedLength++] = (unichar)format->pattern[patternIndex++];
+        }
+    }
+
+    NSString *result;
+    if (rawLength < firstGroupLength) {
+        result = [NSString stringWithCharacters:raw length:rawLength];
+    } else {
+        result = [NSString stringWithCharacters:formatted length:formattedLength];
+    }
+    if (formatted != formattedStorage) {
+        free(formatted);
+        free(raw);
+    }
+    return result;
+}
+
 @implementation STPPhoneNumberValidator
 
 + (NSString *)countryCodeOrCurrentLocaleCountryFromString:(nullable NSString *)nillableCode {
@@ -35,9 +145,10 @@
 + (BOOL)stringIsValidPartialPhoneNumber:(NSString *)string
                          forCountryCode:(nullable NSString *)nillableCode {
     NSString *countryCode = [self countryCodeOrCurrentLocaleCountryFromString:nillableCode];
+    const STPPhoneNumberFormat *format = STPPhoneNumberFormatForCountryCode(countryCode);
     
-    if ([countryCode isEqualToString:@"US"]) {
-        return [STPCardValidator sanitizedNumericStringForString:string].length <= 10;
+    if (format && format->maxDigits > 0) {
+        return [STPCardValidator sanitizedNumericStringForString:string].length <= format->maxDigits;
     }
     else {
         return YES;
@@ -47,9 +158,10 @@
 + (BOOL)stringIsValidPhoneNumber:(NSString *)string 
                   forCountryCode:(nullable NSString *)nillableCode {
     NSString *countryCode = [self countryCodeOrCurrentLocaleCountryFromString:nillableCode];
+    const STPPhoneNumberFormat *format = STPPhoneNumberFormatForCountryCode(countryCode);
     
-    if ([countryCode isEqualToString:@"US"]) {
-        return [STPCardValidator sanitizedNumericStringForString:string].length == 10;
+    if (format && format->maxDigits > 0) {
+        return [STPCardValidator sanitizedNumericStringForString:string].length == format->maxDigits;
     }
     else {
         return YES;
@@ -64,9 +176,11 @@
 + (NSString *)formattedSanitizedPhoneNumberForString:(NSString *)string 
                                       forCountryCode:(nullable NSString *)nillableCode {
     NSString *countryCode = [self countryCodeOrCurrentLocaleCountryFromString:nillableCode];
-    NSString *sanitized = [STPCardValidator sanitizedNumericStringForString:string];
-    return [self formattedPhoneNumberForString:sanitized
-                                forCountryCode:countryCode];
+    const STPPhoneNumberFormat *format = STPPhoneNumberFormatForCountryCode(countryCode);
+    if (!format) {
+        return [STPCardValidator sanitizedNumericStringForString:string];
+    }
+    return STPFormattedPhoneNumber(string, format, YES);
 }
 
 + (NSString *)formattedRedactedPhoneNumberForString:(NSString *)string {
@@ -89,23 +203,11 @@
 
 + (NSString *)formattedPhoneNumberForString:(NSString *)string 
                              forCountryCode:(NSString *)countryCode {
-    
-    if (![countryCode isEqualToString:@"US"]) {
+    const STPPhoneNumberFormat *format = STPPhoneNumberFormatForCountryCode(countryCode);
+    if (!format) {
         return string;
     }
-    if (string.length >= 6) {
-        return [NSString stringWithFormat:@"(%@) %@-%@",
-                [string stp_safeSubstringToIndex:3],
-                [[string stp_safeSubstringToIndex:6] stp_safeSubstringFromIndex:3],
-                [[string stp_safeSubstringToIndex:10] stp_safeSubstringFromIndex:6]
-                ];
-    } else if (string.length >= 3) {
-        return [NSString stringWithFormat:@"(%@) %@",
-                [string stp_safeSubstringToIndex:3],
-                [string stp_safeSubstringFromIndex:3]
-                ];
-    }
-    return string;
+    return STPFormattedPhoneNumber(string, format, NO);
 }
 
 @end
@@ -23,4 +23,12 @@ typedef NS_ENUM(NSInteger, STPPostalCodeType) {
 
 + (STPPostalCodeType)postalCodeTypeForCountryCode:(nullable NSString *)countryCode;
 
+/**
+ *  For countries with a fixed postal code layout (currently CA and GB), returns
+ *  the code uppercased, truncated to the country's maximum length and with the
+ *  separating space inserted. Other countries' codes are returned unchanged.
+ */
++ (nullable NSString *)formattedSanitizedPostalCodeFromString:(nullable NSString *)postalCode
+                                                  countryCode:(nullable NSString *)countryCode;
+
 @end
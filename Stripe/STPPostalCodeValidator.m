@@ -10,6 +10,40 @@
 #import "STPCardValidator.h"
 #import "STPPhoneNumberValidator.h"
 
+static const char *const STPCountriesWithNoPostalCodes[] = {
+    "AE", "AG", "AN", "AO", "AW", "BF", "BI", "BJ", "BO", "BS",
+    "BW", "BZ", "CD", "CF", "CG", "CI", "CK", "CM", "DJ", "DM",
+    "ER", "FJ", "GD", "GH", "GM", "GN", "GQ", "GY", "HK", "IE",
+    "JM", "KE", "KI", "KM", "KN", "KP", "LC", "ML", "MO", "MR",
+    "MS", "MU", "MW", "NR", "NU", "PA", "QA", "RW", "SA", "SB",
+    "SC", "SL", "SO", "SR", "ST", "SY", "TF", "TK", "TL", "TO",
+    "TT", "TV", "TZ", "UG", "VU", "YE", "ZA", "ZW",
+};
+
+/**
+ *  How postal codes work in one country. Rules are built once and looked up by
+ *  country code, so checking the type on each keystroke is a dictionary lookup.
+ */
+@interface STPPostalCodeRule : NSObject
+@property(nonatomic)STPPostalCodeType type;
+@property(nonatomic)BOOL formatted;
+@property(nonatomic)NSUInteger maxLength;
+@property(nonatomic)NSUInteger separatorIndex;
+@property(nonatomic)NSUInteger inwardCodeLength;
+@property(nonatomic)NSUInteger minimumFormattedLength;
++ (instancetype)ruleWithType:(STPPostalCodeType)type;
+@end
+
+@implementation STPPostalCodeRule
+
++ (instancetype)ruleWithType:(STPPostalCodeType)type {
+    STPPostalCodeRule *rule = [self new];
+    rule.type = type;
+    return rule;
+}
+
+@end
+
 @implementation STPPostalCodeValidator
 
 + (BOOL)stringIsValidPostalCode:(nullable NSString *)string
@@ -31,87 +65,64 @@
 }
 
 + (STPPostalCodeType)postalCodeTypeForCountryCode:(NSString *)countryCode {
-    if ([countryCode isEqualToString:@"US"]) {
-        return STPCountryPostalCodeTypeNumericOnly;
+    return [self ruleForCountryCode:countryCode].type;
+}
+
++ (NSString *)formattedSanitizedPostalCodeFromString:(NSString *)postalCode
+                                         countryCode:(NSString *)countryCode {
+    STPPostalCodeRule *rule = [self ruleForCountryCode:countryCode];
+    if (!rule.formatted || !postalCode) {
+        return postalCode;
     }
-    else if ([[self countriesWithNoPostalCodes] containsObject:countryCode]) {
-        return STPCountryPostalCodeTypeNotRequired;
+    NSMutableString *sanitized = [NSMutableString stringWithCapacity:postalCode.length + 1];
+    NSCharacterSet *alphanumerics = [NSCharacterSet alphanumericCharacterSet];
+    for (NSUInteger i = 0; i < postalCode.length && (rule.maxLength == 0 || sanitized.length < rule.maxLength); i++) {
+        unichar character = [postalCode characterAtIndex:i];
+        if ([alphanumerics characterIsMember:character]) {
+            [sanitized appendFormat:@"%C", character];
+        }
     }
-    else {
-        return STPCountryPostalCodeTypeAlphanumeric;
+    [sanitized setString:[sanitized uppercaseString]];
+    if (rule.separatorIndex > 0 && sanitized.length > rule.separatorIndex) {
+        [sanitized insertString:@" " atIndex:rule.separatorIndex];
+    } else if (rule.inwardCodeLength > 0 && sanitized.length >= rule.minimumFormattedLength) {
+        [sanitized insertString:@" " atIndex:sanitized.length - rule.inwardCodeLength];
     }
+    return [sanitized copy];
 }
 
-+ (NSArray *)countriesWithNoPostalCodes {
-    return @[ @"AE",
-              @"AG",
-              @"AN",
-              @"AO",
-              @"AW",
-              @"BF",
-              @"BI",
-              @"BJ",
-              @"BO",
-              @"BS",
-              @"BW",
-              @"BZ",
-              @"CD",
-              @"CF",
-              @"CG",
-              @"CI",
-              @"CK",
-              @"CM",
-              @"DJ",
-              @"DM",
-              @"ER",
-              @"FJ",
-              @"GD",
-              @"GH",
-              @"GM",
-              @"GN",
-              @"GQ",
-              @"GY",
-              @"HK",
-              @"IE",
-              @"JM",
-              @"KE",
-              @"KI",
-              @"KM",
-              @"KN",
-              @"KP",
-              @"LC",
-              @"ML",
-              @"MO",
-              @"MR",
-              @"MS",
-              @"MU",
-              @"MW",
-              @"NR",
-              @"NU",
-              @"PA",
-              @"QA",
-              @"RW",
-              @"SA",
-              @"SB",
-              @"SC",
-              @"SL",
-              @"SO",
-              @"SR",
-              @"ST",
-              @"SY",
-              @"TF",
-              @"TK",
-              @"TL",
-              @"TO",
-              @"TT",
-              @"TV",
-              @"TZ",
-              @"UG",
-              @"VU",
-              @"YE",
-              @"ZA",
-              @"ZW"
-              ];
++ (STPPostalCodeRule *)ruleForCountryCode:(NSString *)countryCode {
+    static NSDictionary<NSString *, STPPostalCodeRule *> *rulesByCountryCode;
+    static STPPostalCodeRule *defaultRule;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableDictionary *rules = [NSMutableDictionary new];
+        STPPostalCodeRule *notRequiredRule = [STPPostalCodeRule ruleWithType:STPCountryPostalCodeTypeNotRequired];
+        for (size_t i = 0; i < sizeof(STPCountriesWithNoPostalCodes) / sizeof(STPCountriesWithNoPostalCodes[0]); i++) {
+            rules[@(STPCountriesWithNoPostalCodes[i])] = notRequiredRule;
+        }
+        rules[@"US"] = [STPPostalCodeRule ruleWithType:STPCountryPostalCodeTypeNumericOnly];
+
+        // Canadian codes are always "A1A 1A1".
+        STPPostalCodeRule *canadaRule = [STPPostalCodeRule ruleWithType:STPCountryPostalCodeTypeAlphanumeric];
+        canadaRule.formatted = YES;
+        canadaRule.maxLength = 6;
+        canadaRule.separatorIndex = 3;
+        rules[@"CA"] = canadaRule;
+
+        // UK outward codes are 2-4 characters but the inward code is always 3,
+        // so the space can only be placed once enough of the code is known.
+        STPPostalCodeRule *britainRule = [STPPostalCodeRule ruleWithType:STPCountryPostalCodeTypeAlphanumeric];
+        britainRule.formatted = YES;
+        britainRule.maxLength = 7;
+        britainRule.inwardCodeLength = 3;
+        britainRule.minimumFormattedLength = 5;
+        rules[@"GB"] = britainRule;
+
+        rulesByCountryCode = [rules copy];
+        defaultRule = [STPPostalCodeRule ruleWithType:STPCountryPostalCodeTypeAlphanumeric];
+    });
+    return (countryCode ? rulesByCountryCode[countryCode] : nil) ?: defaultRule;
 }
 
 @end
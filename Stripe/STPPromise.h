@@ -13,6 +13,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class STPVoidPromise;
 
+/**
+ Pass as the `queue` of the `onQueue:` variants below to run a callback
+ synchronously on whichever thread completes the promise, or on the calling
+ thread if the promise has already completed. Suits cheap, thread-safe work
+ like forwarding a result to another promise.
+ */
+FOUNDATION_EXPORT dispatch_queue_t STPPromiseImmediateQueue(void);
+
 @interface STPPromise<T>: NSObject
 
 typedef void (^STPPromiseErrorBlock)(NSError *error);
@@ -33,14 +41,49 @@ typedef STPPromise* _Nonnull (^STPPromiseFlatMapBlock)(T value);
 
 - (void)completeWith:(STPPromise<T> *)promise;
 
+/**
+ These run their callbacks on the main thread.
+ */
 - (instancetype)onSuccess:(STPPromiseValueBlock)callback;
 - (instancetype)onFailure:(STPPromiseErrorBlock)callback;
 - (instancetype)onCompletion:(STPPromiseCompletionBlock)callback;
 
+/**
+ These run their callbacks on `queue`, or immediately if `queue` is
+ `STPPromiseImmediateQueue()`. Use them to keep work that doesn't touch UI off
+ the main thread.
+ */
+- (instancetype)onSuccess:(STPPromiseValueBlock)callback onQueue:(dispatch_queue_t)queue;
+- (instancetype)onFailure:(STPPromiseErrorBlock)callback onQueue:(dispatch_queue_t)queue;
+- (instancetype)onCompletion:(STPPromiseCompletionBlock)callback onQueue:(dispatch_queue_t)queue;
+
 - (STPPromise<id> *)map:(STPPromiseMapBlock)callback;
 - (STPPromise<id> *)flatMap:(STPPromiseFlatMapBlock)callback;
+
+/**
+ Like `map:` and `flatMap:`, but `callback` runs on `queue`.
+ */
+- (STPPromise<id> *)map:(STPPromiseMapBlock)callback onQueue:(dispatch_queue_t)queue;
+- (STPPromise<id> *)flatMap:(STPPromiseFlatMapBlock)callback onQueue:(dispatch_queue_t)queue;
 - (STPVoidPromise *)asVoid;
 
+/**
+ Succeeds with the values of `promises`, in the same order, once all of them
+ succeed. Fails with the first error any of them fails with.
+ */
++ (STPPromise<NSArray *> *)all:(NSArray<STPPromise *> *)promises;
+
+/**
+ Completes the same way as whichever of `promises` completes first.
+ */
++ (STPPromise *)race:(NSArray<STPPromise *> *)promises;
+
+/**
+ Returns a promise that completes like this one, or fails with an
+ `NSURLErrorTimedOut` error if this one hasn't completed after `interval`.
+ */
+- (instancetype)timeout:(NSTimeInterval)interval;
+
 @end
 
 typedef STPPromise* _Nonnull (^STPVoidPromiseFlatMapBlock)();
@@ -51,6 +94,7 @@ typedef STPPromise* _Nonnull (^STPVoidPromiseFlatMapBlock)();
 - (void)voidCompleteWith:(STPVoidPromise *)promise;
 - (instancetype)voidOnSuccess:(STPVoidBlock)block;
 - (STPPromise<id> *)voidFlatMap:(STPVoidPromiseFlatMapBlock)block;
+- (STPPromise<id> *)voidFlatMap:(STPVoidPromiseFlatMapBlock)block onQueue:(dispatch_queue_t)queue;
 
 @end
 
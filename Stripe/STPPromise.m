@@ -8,19 +8,95 @@
 
 #import "STPPromise.h"
 
+#import <stdatomic.h>
+
 #import "STPDispatchFunctions.h"
+#import "STPPerformanceCounters.h"
+#import "STPSignpost.h"
 #import "STPWeakStrongMacros.h"
 
-@interface STPPromise<T>()
+typedef NS_ENUM(intptr_t, STPPromiseState) {
+    STPPromiseStatePending,
+    // succeed: or fail: has claimed the promise and is storing its result
+    STPPromiseStateCompleting,
+    STPPromiseStateSucceeded,
+    STPPromiseStateFailed,
+};
 
-@property(atomic)T value;
-@property(atomic)NSError *error;
-@property(atomic)NSArray<STPPromiseValueBlock> *successCallbacks;
-@property(atomic)NSArray<STPPromiseErrorBlock> *errorCallbacks;
+/**
+ One registration: a success block, an error block, or both. Nodes form an
+ append-only stack that completion swaps out in one step, so registering a
+ callback never copies the ones before it.
+ */
+typedef struct STPPromiseCallbackNode {
+    void *successCallback;
+    void *errorCallback;
+    // NULL for the main thread
+    void *queue;
+    struct STPPromiseCallbackNode *next;
+} STPPromiseCallbackNode;
 
-@end
+// Replaces the callback stack once the promise completes. Callbacks added
+// after that run straight away.
+static STPPromiseCallbackNode STPPromiseSealedNode;
+#define STPPromiseSealed (&STPPromiseSealedNode)
+
+static void STPPromiseFreeCallbackNodes(STPPromiseCallbackNode *node) {
+    while (node && node != STPPromiseSealed) {
+        STPPromiseCallbackNode *next = node->next;
+        if (node->successCallback) {
+            CFRelease(node->successCallback);
+        }
+        if (node->errorCallback) {
+            CFRelease(node->errorCallback);
+        }
+        if (node->queue) {
+            CFRelease(node->queue);
+        }
+        free(node);
+        node = next;
+    }
+}
+
+dispatch_queue_t STPPromiseImmediateQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.promise.immediate", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
 
-@implementation STPPromise
+static void STPPromiseRunOnQueue(dispatch_queue_t queue, dispatch_block_t block) {
+#if STP_SIGNPOSTS_ENABLED
+    if (queue != STPPromiseImmediateQueue()) {
+        dispatch_block_t hop = block;
+        STPSignpostIntervalBegin("Promise hop", hop);
+        block = ^{
+            STPSignpostIntervalEnd("Promise hop", hop);
+            hop();
+        };
+    }
+#endif
+    if (!queue || queue == dispatch_get_main_queue()) {
+        if (![NSThread isMainThread]) {
+            STPPerformanceCounterIncrement(STPPerformanceCounterPromiseHops);
+        }
+        stpDispatchToMainThreadIfNecessary(block);
+    } else if (queue == STPPromiseImmediateQueue()) {
+        block();
+    } else {
+        STPPerformanceCounterIncrement(STPPerformanceCounterPromiseHops);
+        dispatch_async(queue, block);
+    }
+}
+
+@implementation STPPromise {
+    _Atomic(intptr_t) _state;
+    _Atomic(STPPromiseCallbackNode *) _callbacks;
+    id _value;
+    NSError *_error;
+}
 
 + (instancetype)promiseWithError:(NSError *)error {
     STPPromise *promise = [self new];
@@ -37,108 +113,181 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
-        _successCallbacks = @[];
-        _errorCallbacks = @[];
+        atomic_init(&_state, STPPromiseStatePending);
+        atomic_init(&_callbacks, NULL);
     }
     return self;
 }
 
+- (void)dealloc {
+    STPPromiseFreeCallbackNodes(atomic_load(&_callbacks));
+}
+
 - (BOOL)completed {
-    return (self.error != nil || self.value != nil);
+    intptr_t state = atomic_load(&_state);
+    return state == STPPromiseStateSucceeded || state == STPPromiseStateFailed;
+}
+
+- (id)value {
+    return (atomic_load(&_state) == STPPromiseStateSucceeded) ? _value : nil;
+}
+
+- (NSError *)error {
+    return (atomic_load(&_state) == STPPromiseStateFailed) ? _error : nil;
 }
 
 - (void)succeed:(id)value {
-    if (self.completed) {
-        return;
-    }
-    self.value = value;
-    stpDispatchToMainThreadIfNecessary(^{
-        for (STPPromiseValueBlock valueBlock in self.successCallbacks) {
-            valueBlock(value);
-        }
-        self.successCallbacks = nil;
-        self.errorCallbacks = nil;
-    });
+    [self completeWithValue:value error:nil];
 }
 
 - (void)fail:(NSError *)error {
-    if (self.completed) {
+    [self completeWithValue:nil error:error];
+}
+
+- (void)completeWithValue:(id)value error:(NSError *)error {
+    intptr_t expected = STPPromiseStatePending;
+    if (!atomic_compare_exchange_strong(&_state, &expected, STPPromiseStateCompleting)) {
         return;
     }
-    self.error = error;
-    stpDispatchToMainThreadIfNecessary(^{
-        for (STPPromiseErrorBlock errorBlock in self.errorCallbacks) {
-            errorBlock(error);
+    _value = value;
+    _error = error;
+    atomic_store(&_state, error ? STPPromiseStateFailed : STPPromiseStateSucceeded);
+
+    // The stack holds the newest registration first; run them in the order
+    // they were added.
+    STPPromiseCallbackNode *node = atomic_exchange(&_callbacks, STPPromiseSealed);
+    STPPromiseCallbackNode *ordered = NULL;
+    while (node) {
+        STPPromiseCallbackNode *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+    for (STPPromiseCallbackNode *callback = ordered; callback; callback = callback->next) {
+        [self runSuccessCallback:(__bridge STPPromiseValueBlock)callback->successCallback
+                   errorCallback:(__bridge STPPromiseErrorBlock)callback->errorCallback
+                         onQueue:(__bridge dispatch_queue_t)callback->queue];
+    }
+    STPPromiseFreeCallbackNodes(ordered);
+}
+
+- (void)addSuccessCallback:(STPPromiseValueBlock)successCallback
+             errorCallback:(STPPromiseErrorBlock)errorCallback
+                   onQueue:(dispatch_queue_t)queue {
+    STPPromiseCallbackNode *node = calloc(1, sizeof(STPPromiseCallbackNode));
+    if (successCallback) {
+        node->successCallback = (__bridge_retained void *)[successCallback copy];
+    }
+    if (errorCallback) {
+        node->errorCallback = (__bridge_retained void *)[errorCallback copy];
+    }
+    if (queue && queue != dispatch_get_main_queue()) {
+        node->queue = (__bridge_retained void *)queue;
+    }
+    STPPromiseCallbackNode *head = atomic_load(&_callbacks);
+    do {
+        if (head == STPPromiseSealed) {
+            STPPromiseFreeCallbackNodes(node);
+            [self runSuccessCallback:successCallback errorCallback:errorCallback onQueue:queue];
+            return;
         }
-        self.successCallbacks = nil;
-        self.errorCallbacks = nil;
-    });
+        node->next = head;
+    } while (!atomic_compare_exchange_weak(&_callbacks, &head, node));
+}
+
+// Only called once the result is stored.
+- (void)runSuccessCallback:(STPPromiseValueBlock)successCallback
+             errorCallback:(STPPromiseErrorBlock)errorCallback
+                   onQueue:(dispatch_queue_t)queue {
+    if (atomic_load(&_state) == STPPromiseStateFailed) {
+        if (errorCallback) {
+            NSError *error = _error;
+            STPPromiseRunOnQueue(queue, ^{
+                errorCallback(error);
+            });
+        }
+    } else if (successCallback) {
+        id value = _value;
+        STPPromiseRunOnQueue(queue, ^{
+            successCallback(value);
+        });
+    }
 }
 
 - (void)completeWith:(STPPromise *)promise {
     WEAK(self);
-    [[promise onSuccess:^(id value) {
+    [promise addSuccessCallback:^(id value) {
         STRONG(self);
         [self succeed:value];
-    }] onFailure:^(NSError * _Nonnull error) {
+    } errorCallback:^(NSError * _Nonnull error) {
         STRONG(self);
         [self fail:error];
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
 }
 
 - (instancetype)onSuccess:(STPPromiseValueBlock)callback {
-    if (self.value) {
-        stpDispatchToMainThreadIfNecessary( ^{
-            callback(self.value);
-        });
-    } else {
-        self.successCallbacks = [self.successCallbacks arrayByAddingObject:callback];
-    }
+    return [self onSuccess:callback onQueue:dispatch_get_main_queue()];
+}
+
+- (instancetype)onSuccess:(STPPromiseValueBlock)callback onQueue:(dispatch_queue_t)queue {
+    [self addSuccessCallback:callback errorCallback:nil onQueue:queue];
     return self;
 }
 
 - (instancetype)onFailure:(STPPromiseErrorBlock)callback {
-    if (self.error) {
-        stpDispatchToMainThreadIfNecessary( ^{
-            callback(self.error);
-        });
-    } else {
-        self.errorCallbacks = [self.errorCallbacks arrayByAddingObject:callback];
-    }
+    return [self onFailure:callback onQueue:dispatch_get_main_queue()];
+}
+
+- (instancetype)onFailure:(STPPromiseErrorBlock)callback onQueue:(dispatch_queue_t)queue {
+    [self addSuccessCallback:nil errorCallback:callback onQueue:queue];
     return self;
 }
 
 - (instancetype)onCompletion:(STPPromiseCompletionBlock)callback {
-    return [[self onSuccess:^(id  _Nonnull value) {
+    return [self onCompletion:callback onQueue:dispatch_get_main_queue()];
+}
+
+- (instancetype)onCompletion:(STPPromiseCompletionBlock)callback onQueue:(dispatch_queue_t)queue {
+    [self addSuccessCallback:^(id  _Nonnull value) {
         callback(value, nil);
-    }] onFailure:^(NSError * _Nonnull error) {
+    } errorCallback:^(NSError * _Nonnull error) {
         callback(nil, error);
-    }];
+    } onQueue:queue];
+    return self;
 }
 
 - (STPPromise<id> *)map:(STPPromiseMapBlock)callback {
+    return [self map:callback onQueue:dispatch_get_main_queue()];
+}
+
+- (STPPromise<id> *)map:(STPPromiseMapBlock)callback onQueue:(dispatch_queue_t)queue {
     STPPromise<id>* wrapper = [self.class new];
+    // Forwarding a result needs no particular thread; the wrapper's own
+    // callbacks pick theirs.
     [[self onSuccess:^(id value) {
         [wrapper succeed:callback(value)];
-    }] onFailure:^(NSError *error) {
+    } onQueue:queue] onFailure:^(NSError *error) {
         [wrapper fail:error];
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
     return wrapper;
 }
 
-
 - (STPPromise *)flatMap:(STPPromiseFlatMapBlock)callback {
+    return [self flatMap:callback onQueue:dispatch_get_main_queue()];
+}
+
+- (STPPromise *)flatMap:(STPPromiseFlatMapBlock)callback onQueue:(dispatch_queue_t)queue {
     STPPromise<id>* wrapper = [self.class new];
     [[self onSuccess:^(id value) {
         STPPromise *internal = callback(value);
-        [[internal onSuccess:^(id internalValue) {
+        [internal addSuccessCallback:^(id internalValue) {
             [wrapper succeed:internalValue];
-        }] onFailure:^(NSError *internalError) {
+        } errorCallback:^(NSError *internalError) {
             [wrapper fail:internalError];
-        }];
-    }] onFailure:^(NSError *error) {
+        } onQueue:STPPromiseImmediateQueue()];
+    } onQueue:queue] onFailure:^(NSError *error) {
         [wrapper fail:error];
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
     return wrapper;
 }
 
@@ -146,12 +295,65 @@
     STPVoidPromise *voidPromise = [STPVoidPromise new];
     [[self onSuccess:^(__unused id value) {
         [voidPromise succeed];
-    }] onFailure:^(NSError * _Nonnull error) {
+    } onQueue:STPPromiseImmediateQueue()] onFailure:^(NSError * _Nonnull error) {
         [voidPromise fail:error];
-    }];
+    } onQueue:STPPromiseImmediateQueue()];
     return voidPromise;
 }
 
++ (STPPromise<NSArray *> *)all:(NSArray<STPPromise *> *)promises {
+    STPPromise<NSArray *> *wrapper = [STPPromise new];
+    if (promises.count == 0) {
+        [wrapper succeed:@[]];
+        return wrapper;
+    }
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:promises.count];
+    for (NSUInteger i = 0; i < promises.count; i++) {
+        [values addObject:[NSNull null]];
+    }
+    // Values can arrive on any thread; collect them on one queue.
+    dispatch_queue_t queue = dispatch_queue_create("com.stripe.promise.all", DISPATCH_QUEUE_SERIAL);
+    __block NSUInteger remaining = promises.count;
+    [promises enumerateObjectsUsingBlock:^(STPPromise *promise, NSUInteger idx, __unused BOOL *stop) {
+        [promise addSuccessCallback:^(id value) {
+            values[idx] = value ?: [NSNull null];
+            remaining--;
+            if (remaining == 0) {
+                [wrapper succeed:[values copy]];
+            }
+        } errorCallback:^(NSError *error) {
+            [wrapper fail:error];
+        } onQueue:queue];
+    }];
+    return wrapper;
+}
+
++ (STPPromise *)race:(NSArray<STPPromise *> *)promises {
+    STPPromise *wrapper = [STPPromise new];
+    for (STPPromise *promise in promises) {
+        // Only the first result to arrive completes the wrapper
+        [promise addSuccessCallback:^(id value) {
+            [wrapper succeed:value];
+        } errorCallback:^(NSError *error) {
+            [wrapper fail:error];
+        } onQueue:STPPromiseImmediateQueue()];
+    }
+    return wrapper;
+}
+
+- (instancetype)timeout:(NSTimeInterval)interval {
+    STPPromise *wrapper = [self.class new];
+    [self addSuccessCallback:^(id value) {
+        [wrapper succeed:value];
+    } errorCallback:^(NSError *error) {
+        [wrapper fail:error];
+    } onQueue:STPPromiseImmediateQueue()];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [wrapper fail:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]];
+    });
+    return wrapper;
+}
+
 @end
 
 @implementation STPVoidPromise
@@ -180,9 +382,13 @@
 }
 
 - (STPPromise<id> *)voidFlatMap:(STPVoidPromiseFlatMapBlock)block {
+    return [self voidFlatMap:block onQueue:dispatch_get_main_queue()];
+}
+
+- (STPPromise<id> *)voidFlatMap:(STPVoidPromiseFlatMapBlock)block onQueue:(dispatch_queue_t)queue {
     return [super flatMap:^STPPromise *(__unused id value) {
         return block();
-    }];
+    } onQueue:queue];
 }
 
 - (STPVoidPromise *)asVoid {
@@ -0,0 +1,53 @@
+//
+//  STPPublicKeyPins.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <Security/Security.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The public keys that connections to a host must be able to trace their
+ certificate chain to, as base64 SHA-256 hashes of each key's
+ SubjectPublicKeyInfo (the `pin-sha256` format of RFC 7469). Sessions from
+ STPURLSessionPool check them in place of the default trust evaluation.
+ Safe to use from any thread.
+ */
+@interface STPPublicKeyPins : NSObject
+
++ (instancetype)sharedPins;
+
+/**
+ Replaces the pins for `host`. Pass nil or an empty array to go back to the
+ default trust evaluation.
+ */
+- (void)setPinnedHashes:(nullable NSArray<NSString *> *)hashes forHost:(NSString *)host;
+
+/**
+ Whether connections to `host` are checked against pins. Always NO before
+ iOS 10, which has no way to read a certificate's public key, so pins are
+ only enforced from iOS 10 on.
+ */
+- (BOOL)hasPinsForHost:(NSString *)host;
+
+/**
+ YES if `serverTrust` is valid for `host` and one of the certificates in its
+ chain has a pinned key. The result is remembered for an hour for the same
+ chain, so reconnecting doesn't evaluate it again.
+ */
+- (BOOL)evaluateServerTrust:(SecTrustRef)serverTrust forHost:(NSString *)host;
+
+/**
+ The `pin-sha256` hash of the certificate's public key, or nil if its key
+ type isn't RSA (2048 or 4096 bits) or EC (P-256 or P-384).
+ */
++ (nullable NSString *)publicKeyHashForCertificate:(SecCertificateRef)certificate;
+
+@end
+
+NS_ASSUME_NONNULL_END
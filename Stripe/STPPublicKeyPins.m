@@ -0,0 +1,213 @@
+//
+//  STPPublicKeyPins.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPPublicKeyPins.h"
+
+#import <CommonCrypto/CommonDigest.h>
+
+// A new chain could mean a revoked or replaced certificate, so results are
+// only reused for a while.
+static CFTimeInterval const TrustResultLifetime = 3600;
+
+// The DER that goes before a key's bits in its SubjectPublicKeyInfo, which is
+// what pins hash. The system only hands out the bits.
+static const uint8_t RSA2048Header[] = {
+    0x30, 0x82, 0x01, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86,
+    0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x82, 0x01, 0x0f, 0x00,
+};
+static const uint8_t RSA4096Header[] = {
+    0x30, 0x82, 0x02, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86,
+    0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x82, 0x02, 0x0f, 0x00,
+};
+static const uint8_t P256Header[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+    0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00,
+};
+static const uint8_t P384Header[] = {
+    0x30, 0x76, 0x30, 0x10, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+    0x01, 0x06, 0x05, 0x2b, 0x81, 0x04, 0x00, 0x22, 0x03, 0x62, 0x00,
+};
+
+@interface STPTrustResult : NSObject
+@property (nonatomic) BOOL trusted;
+@property (nonatomic) CFAbsoluteTime evaluated;
+@end
+
+@implementation STPTrustResult
+@end
+
+@interface STPPublicKeyPins ()
+@property (nonatomic) NSMutableDictionary<NSString *, NSSet<NSString *> *> *pins;
+@property (nonatomic) dispatch_queue_t pinsQueue;
+/**
+ Keyed by host and a hash of the whole chain.
+ */
+@property (nonatomic) NSCache<NSString *, STPTrustResult *> *trustResults;
+@end
+
+@implementation STPPublicKeyPins
+
++ (instancetype)sharedPins {
+    static id sharedPins;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ sharedPins = [[self alloc] init]; });
+    return sharedPins;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _pins = [NSMutableDictionary dictionary];
+        _pinsQueue = dispatch_queue_create("com.stripe.publickeypins", DISPATCH_QUEUE_SERIAL);
+        _trustResults = [NSCache new];
+        _trustResults.name = @"com.stripe.trustresults";
+    }
+    return self;
+}
+
+- (void)setPinnedHashes:(NSArray<NSString *> *)hashes forHost:(NSString *)host {
+    NSString *key = host.lowercaseString;
+    dispatch_sync(self.pinsQueue, ^{
+        self.pins[key] = hashes.count ? [NSSet setWithArray:hashes] : nil;
+    });
+    // Results were for the old pins
+    [self.trustResults removeAllObjects];
+}
+
+- (BOOL)hasPinsForHost:(NSString *)host {
+    return [self pinsForHost:host] != nil;
+}
+
+- (NSSet<NSString *> *)pinsForHost:(NSString *)host {
+    if (!host || &SecKeyCopyExternalRepresentation == NULL) {
+        return nil;
+    }
+    NSString *key = host.lowercaseString;
+    __block NSSet<NSString *> *pins;
+    dispatch_sync(self.pinsQueue, ^{
+        pins = self.pins[key];
+    });
+    return pins;
+}
+
+- (BOOL)evaluateServerTrust:(SecTrustRef)serverTrust forHost:(NSString *)host {
+    NSSet<NSString *> *pins = [self pinsForHost:host];
+    if (!pins || !serverTrust) {
+        return NO;
+    }
+
+    CFIndex certificateCount = SecTrustGetCertificateCount(serverTrust);
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    for (CFIndex i = 0; i < certificateCount; i++) {
+        NSData *certificateData = (__bridge_transfer NSData *)SecCertificateCopyData(SecTrustGetCertificateAtIndex(serverTrust, i));
+        // Lengths keep different splits of the same bytes apart
+        uint32_t length = (uint32_t)certificateData.length;
+        CC_SHA256_Update(&context, &length, sizeof(length));
+        CC_SHA256_Update(&context, certificateData.bytes, (CC_LONG)certificateData.length);
+    }
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &context);
+    NSString *resultKey = [NSString stringWithFormat:@"%@ %@", host.lowercaseString, [[NSData dataWithBytes:digest length:sizeof(digest)] base64EncodedStringWithOptions:0]];
+
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    STPTrustResult *result = [self.trustResults objectForKey:resultKey];
+    if (result && now - result.evaluated < TrustResultLifetime) {
+        return result.trusted;
+    }
+
+    result = [STPTrustResult new];
+    result.evaluated = now;
+    result.trusted = [self isValidServerTrust:serverTrust forHost:host] && [self serverTrust:serverTrust matchesPins:pins];
+    [self.trustResults setObject:result forKey:resultKey];
+    return result.trusted;
+}
+
+#pragma mark - Private
+
+- (BOOL)isValidServerTrust:(SecTrustRef)serverTrust forHost:(NSString *)host {
+    SecPolicyRef policy = SecPolicyCreateSSL(true, (__bridge CFStringRef)host);
+    OSStatus status = SecTrustSetPolicies(serverTrust, policy);
+    CFRelease(policy);
+    if (status != errSecSuccess) {
+        return NO;
+    }
+    SecTrustResultType trustResult = kSecTrustResultInvalid;
+    if (SecTrustEvaluate(serverTrust, &trustResult) != errSecSuccess) {
+        return NO;
+    }
+    return trustResult == kSecTrustResultUnspecified || trustResult == kSecTrustResultProceed;
+}
+
+- (BOOL)serverTrust:(SecTrustRef)serverTrust matchesPins:(NSSet<NSString *> *)pins {
+    CFIndex certificateCount = SecTrustGetCertificateCount(serverTrust);
+    for (CFIndex i = 0; i < certificateCount; i++) {
+        NSString *hash = [[self class] publicKeyHashForCertificate:SecTrustGetCertificateAtIndex(serverTrust, i)];
+        if (hash && [pins containsObject:hash]) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
++ (NSString *)publicKeyHashForCertificate:(SecCertificateRef)certificate {
+    if (&SecKeyCopyExternalRepresentation == NULL) {
+        return nil;
+    }
+    // A trust made of just the certificate is the only way to get at its key
+    // before iOS 12.
+    SecPolicyRef policy = SecPolicyCreateBasicX509();
+    SecTrustRef trust = NULL;
+    OSStatus status = SecTrustCreateWithCertificates(certificate, policy, &trust);
+    CFRelease(policy);
+    if (status != errSecSuccess || !trust) {
+        return nil;
+    }
+    SecTrustResultType trustResult;
+    SecTrustEvaluate(trust, &trustResult);
+    SecKeyRef key = SecTrustCopyPublicKey(trust);
+    CFRelease(trust);
+    if (!key) {
+        return nil;
+    }
+    NSData *keyData = (__bridge_transfer NSData *)SecKeyCopyExternalRepresentation(key, NULL);
+    NSDictionary *attributes = (__bridge_transfer NSDictionary *)SecKeyCopyAttributes(key);
+    CFRelease(key);
+
+    NSString *keyType = attributes[(__bridge NSString *)kSecAttrKeyType];
+    NSInteger keySize = [attributes[(__bridge NSString *)kSecAttrKeySizeInBits] integerValue];
+    const uint8_t *header = NULL;
+    size_t headerLength = 0;
+    if ([keyType isEqualToString:(__bridge NSString *)kSecAttrKeyTypeRSA] && keySize == 2048) {
+        header = RSA2048Header;
+        headerLength = sizeof(RSA2048Header);
+    } else if ([keyType isEqualToString:(__bridge NSString *)kSecAttrKeyTypeRSA] && keySize == 4096) {
+        header = RSA4096Header;
+        headerLength = sizeof(RSA4096Header);
+    } else if ([keyType isEqualToString:(__bridge NSString *)kSecAttrKeyTypeECSECPrimeRandom] && keySize == 256) {
+        header = P256Header;
+        headerLength = sizeof(P256Header);
+    } else if ([keyType isEqualToString:(__bridge NSString *)kSecAttrKeyTypeECSECPrimeRandom] && keySize == 384) {
+        header = P384Header;
+        headerLength = sizeof(P384Header);
+    }
+    if (!header || !keyData) {
+        return nil;
+    }
+
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    CC_SHA256_Update(&context, header, (CC_LONG)headerLength);
+    CC_SHA256_Update(&context, keyData.bytes, (CC_LONG)keyData.length);
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &context);
+    return [[NSData dataWithBytes:digest length:sizeof(digest)] base64EncodedStringWithOptions:0];
+}
+
+@end
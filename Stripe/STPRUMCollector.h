@@ -0,0 +1,85 @@
+//
+//  STPRUMCollector.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, STPRUMCategory) {
+    // Phases of API requests, from their task metrics
+    STPRUMCategoryNetwork,
+    // Flows in the SDK's view controllers
+    STPRUMCategoryInterface,
+};
+
+/**
+ Times a sample of API requests and UI flows, and keeps the timings as
+ histograms on the device rather than reporting each one. Every few minutes,
+ or when the app enters the background, each histogram is handed to the
+ reporter as one summary (count, percentiles and bucket counts) and starts
+ over, so what's sent depends on how many kinds of timing there are, not on
+ how many requests were made. Safe to use from any thread.
+ */
+@interface STPRUMCollector : NSObject
+
+/**
+ Reports summaries through `STPAnalyticsClient`.
+ */
++ (instancetype)sharedCollector;
+
+/**
+ @param reportInterval How long after the first timing in a period the
+ period is reported.
+ @param reporter Called on a private queue with each summary.
+ */
+- (instancetype)initWithReportInterval:(NSTimeInterval)reportInterval
+                              reporter:(void (^)(NSDictionary *summary))reporter NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Timings aren't recorded while NO.
+ */
+@property (atomic) BOOL enabled;
+
+/**
+ The fraction of requests or flows in `category` that are timed, from 0 to
+ 1. Both default to 1.
+ */
+- (void)setSampleRate:(double)sampleRate forCategory:(STPRUMCategory)category;
+- (double)sampleRateForCategory:(STPRUMCategory)category;
+
+/**
+ Adds `duration` to the histogram for `metric`, if this timing is sampled.
+ */
+- (void)recordDuration:(NSTimeInterval)duration
+             forMetric:(NSString *)metric
+              category:(STPRUMCategory)category;
+
+/**
+ Adds the DNS, connection, TLS, time to first byte, download and total times
+ of the last transaction in `taskMetrics` to histograms named after the API
+ endpoint requested, e.g. `tokens.ttfb`. The phases of one request are
+ sampled together.
+ */
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics NS_AVAILABLE_IOS(10_0);
+
+/**
+ Reports every histogram now, and starts a new period.
+ */
+- (void)report;
+
+/**
+ The upper bound, in milliseconds, of every histogram bucket but the last,
+ which holds everything slower.
+ */
++ (NSArray<NSNumber *> *)bucketUpperBounds;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,281 @@
+//
+//  STPRUMCollector.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPRUMCollector.h"
+
+#import "STPAnalyticsClient.h"
+#import "STPURLSessionPool.h"
+#import <UIKit/UIKit.h>
+
+static NSTimeInterval const DefaultReportInterval = 300;
+// Bounds memory if a path ever puts something unexpected in a metric name
+static NSUInteger const MaxMetrics = 64;
+
+static double const BucketUpperBounds[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 60000};
+static NSUInteger const BucketCount = sizeof(BucketUpperBounds) / sizeof(BucketUpperBounds[0]) + 1;
+
+@interface STPRUMHistogram : NSObject
+@property (nonatomic) STPRUMCategory category;
+@property (nonatomic) NSUInteger count;
+@property (nonatomic) double sum;
+@property (nonatomic) double min;
+@property (nonatomic) double max;
+@end
+
+@implementation STPRUMHistogram {
+    NSUInteger _buckets[BucketCount];
+}
+
+- (void)addMilliseconds:(double)milliseconds {
+    NSUInteger bucket = 0;
+    while (bucket < BucketCount - 1 && milliseconds > BucketUpperBounds[bucket]) {
+        bucket++;
+    }
+    _buckets[bucket]++;
+    self.min = self.count == 0 ? milliseconds : MIN(self.min, milliseconds);
+    self.max = self.count == 0 ? milliseconds : MAX(self.max, milliseconds);
+    self.count++;
+    self.sum += milliseconds;
+}
+
+/**
+ Interpolated within the bucket holding the percentile, and clamped to the
+ smallest and largest values actually seen.
+ */
+- (double)percentile:(double)percentile {
+    double rank = percentile * self.count;
+    NSUInteger below = 0;
+    for (NSUInteger bucket = 0; bucket < BucketCount; bucket++) {
+        NSUInteger inBucket = _buckets[bucket];
+        if (inBucket > 0 && below + inBucket >= rank) {
+            double lower = bucket == 0 ? 0 : BucketUpperBounds[bucket - 1];
+            double upper = bucket == BucketCount - 1 ? self.max : BucketUpperBounds[bucket];
+            double value = lower + (upper - lower) * (rank - below) / inBucket;
+            return MIN(self.max, MAX(self.min, value));
+        }
+        below += inBucket;
+    }
+    return self.max;
+}
+
+- (NSString *)bucketString {
+    NSMutableArray<NSString *> *counts = [NSMutableArray arrayWithCapacity:BucketCount];
+    for (NSUInteger bucket = 0; bucket < BucketCount; bucket++) {
+        [counts addObject:[NSString stringWithFormat:@"%lu", (unsigned long)_buckets[bucket]]];
+    }
+    return [counts componentsJoinedByString:@","];
+}
+
+@end
+
+@interface STPRUMCollector ()
+@property (nonatomic, copy) void (^reporter)(NSDictionary *summary);
+@property (nonatomic) NSTimeInterval reportInterval;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) NSMutableDictionary<NSString *, STPRUMHistogram *> *histograms;
+@property (nonatomic) NSMutableDictionary<NSNumber *, NSNumber *> *sampleRates;
+@property (nonatomic) NSDate *periodStart;
+@property (nonatomic) NSUInteger reportGeneration;
+@end
+
+@implementation STPRUMCollector
+
++ (instancetype)sharedCollector {
+    static id sharedCollector;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCollector = [[self alloc] initWithReportInterval:DefaultReportInterval reporter:^(NSDictionary *summary) {
+            [[STPAnalyticsClient sharedClient] logRUMSummary:summary];
+        }];
+    });
+    return sharedCollector;
+}
+
++ (NSArray<NSNumber *> *)bucketUpperBounds {
+    NSMutableArray<NSNumber *> *bounds = [NSMutableArray array];
+    for (NSUInteger bucket = 0; bucket < BucketCount - 1; bucket++) {
+        [bounds addObject:@(BucketUpperBounds[bucket])];
+    }
+    return [bounds copy];
+}
+
+- (instancetype)initWithReportInterval:(NSTimeInterval)reportInterval
+                              reporter:(void (^)(NSDictionary *))reporter {
+    self = [super init];
+    if (self) {
+        _reportInterval = reportInterval;
+        _reporter = [reporter copy];
+        _enabled = YES;
+        _queue = dispatch_queue_create("com.stripe.rum", DISPATCH_QUEUE_SERIAL);
+        _histograms = [NSMutableDictionary dictionary];
+        _sampleRates = [NSMutableDictionary dictionary];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(handleDidEnterBackgroundNotification)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)setSampleRate:(double)sampleRate forCategory:(STPRUMCategory)category {
+    double clamped = MIN(1, MAX(0, sampleRate));
+    dispatch_sync(self.queue, ^{
+        self.sampleRates[@(category)] = @(clamped);
+    });
+}
+
+- (double)sampleRateForCategory:(STPRUMCategory)category {
+    __block double sampleRate;
+    dispatch_sync(self.queue, ^{
+        sampleRate = [self currentSampleRateForCategory:category];
+    });
+    return sampleRate;
+}
+
+- (void)recordDuration:(NSTimeInterval)duration
+             forMetric:(NSString *)metric
+              category:(STPRUMCategory)category {
+    if (!self.enabled || duration < 0) {
+        return;
+    }
+    dispatch_async(self.queue, ^{
+        if ([self shouldSampleCategory:category]) {
+            [self addDuration:duration forMetric:metric category:category];
+        }
+    });
+}
+
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics {
+    NSURLSessionTaskTransactionMetrics *transaction = STPResponseTransactionMetrics(taskMetrics);
+    if (!self.enabled || !transaction) {
+        return;
+    }
+    NSString *endpoint = [self.class endpointForURL:transaction.request.URL];
+    NSMutableDictionary<NSString *, NSNumber *> *phases = [NSMutableDictionary dictionary];
+    void (^addPhase)(NSString *, NSDate *, NSDate *) = ^(NSString *phase, NSDate *start, NSDate *end) {
+        // Phases that didn't happen, e.g. on a reused connection, have no dates
+        if (start && end) {
+            phases[phase] = @([end timeIntervalSinceDate:start]);
+        }
+    };
+    addPhase(@"dns", transaction.domainLookupStartDate, transaction.domainLookupEndDate);
+    addPhase(@"connect", transaction.connectStartDate, transaction.connectEndDate);
+    addPhase(@"tls", transaction.secureConnectionStartDate, transaction.secureConnectionEndDate);
+    addPhase(@"ttfb", transaction.requestStartDate, transaction.responseStartDate);
+    addPhase(@"download", transaction.responseStartDate, transaction.responseEndDate);
+    phases[@"total"] = @(taskMetrics.taskInterval.duration);
+    dispatch_async(self.queue, ^{
+        if (![self shouldSampleCategory:STPRUMCategoryNetwork]) {
+            return;
+        }
+        [phases enumerateKeysAndObjectsUsingBlock:^(NSString *phase, NSNumber *duration, __unused BOOL *stop) {
+            NSString *metric = [NSString stringWithFormat:@"%@.%@", endpoint, phase];
+            [self addDuration:duration.doubleValue forMetric:metric category:STPRUMCategoryNetwork];
+        }];
+    });
+}
+
+- (void)report {
+    dispatch_sync(self.queue, ^{
+        [self reportHistograms];
+    });
+}
+
+- (void)handleDidEnterBackgroundNotification {
+    dispatch_async(self.queue, ^{
+        [self reportHistograms];
+    });
+}
+
+/**
+ The first path component after the API version, e.g. `tokens` for
+ /v1/tokens and `sources` for /v1/sources/src_123, so identifiers never end up
+ in a metric name.
+ */
++ (NSString *)endpointForURL:(NSURL *)url {
+    NSArray<NSString *> *components = url.pathComponents;
+    NSUInteger index = [components indexOfObject:@"v1"];
+    if (index != NSNotFound && index + 1 < components.count) {
+        return components[index + 1];
+    }
+    return @"other";
+}
+
+#pragma mark - Private, called on queue
+
+- (double)currentSampleRateForCategory:(STPRUMCategory)category {
+    NSNumber *sampleRate = self.sampleRates[@(category)];
+    return sampleRate ? sampleRate.doubleValue : 1;
+}
+
+- (BOOL)shouldSampleCategory:(STPRUMCategory)category {
+    double sampleRate = [self currentSampleRateForCategory:category];
+    if (sampleRate >= 1) {
+        return YES;
+    }
+    return arc4random_uniform(1000000) < sampleRate * 1000000;
+}
+
+- (void)addDuration:(NSTimeInterval)duration forMetric:(NSString *)metric category:(STPRUMCategory)category {
+    STPRUMHistogram *histogram = self.histograms[metric];
+    if (!histogram) {
+        if (self.histograms.count >= MaxMetrics) {
+            return;
+        }
+        histogram = [STPRUMHistogram new];
+        histogram.category = category;
+        self.histograms[metric] = histogram;
+    }
+    [histogram addMilliseconds:duration * 1000];
+    if (!self.periodStart) {
+        self.periodStart = [NSDate date];
+        NSUInteger generation = self.reportGeneration;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.reportInterval * NSEC_PER_SEC)), self.queue, ^{
+            if (self.reportGeneration == generation) {
+                [self reportHistograms];
+            }
+        });
+    }
+}
+
+- (void)reportHistograms {
+    self.reportGeneration++;
+    if (!self.periodStart) {
+        return;
+    }
+    NSNumber *periodStart = @((NSInteger)([self.periodStart timeIntervalSince1970] * 1000));
+    NSNumber *periodEnd = @((NSInteger)([[NSDate date] timeIntervalSince1970] * 1000));
+    NSDictionary<NSString *, STPRUMHistogram *> *histograms = [self.histograms copy];
+    [self.histograms removeAllObjects];
+    self.periodStart = nil;
+    for (NSString *metric in [histograms.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        STPRUMHistogram *histogram = histograms[metric];
+        self.reporter(@{
+                        @"event": @"rum.stripeios.summary",
+                        @"metric": metric,
+                        @"category": histogram.category == STPRUMCategoryNetwork ? @"network" : @"interface",
+                        @"sample_rate": @([self currentSampleRateForCategory:histogram.category]),
+                        @"count": @(histogram.count),
+                        @"min_ms": @(histogram.min),
+                        @"max_ms": @(histogram.max),
+                        @"mean_ms": @(histogram.sum / histogram.count),
+                        @"p50_ms": @([histogram percentile:0.5]),
+                        @"p90_ms": @([histogram percentile:0.9]),
+                        @"p99_ms": @([histogram percentile:0.99]),
+                        @"buckets": [histogram bucketString],
+                        @"period_start": periodStart,
+                        @"period_end": periodEnd,
+                        });
+    }
+}
+
+@end
@@ -0,0 +1,31 @@
+//
+//  STPRedirectContext+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPRedirectContextState.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Posted on the main thread whenever a redirect context's `state` changes. The
+ object is the context; the user info holds the source's ID under
+ `STPRedirectContextSourceIDKey` and the new state under
+ `STPRedirectContextStateKey`. Source pollers use it to tune how often they
+ poll.
+
+ These are defined with the poll scheduler, their only observer, so that the
+ core build has them without `STPRedirectContext`.
+ */
+FOUNDATION_EXPORT NSString *const STPRedirectContextStateDidChangeNotification;
+
+FOUNDATION_EXPORT NSString *const STPRedirectContextSourceIDKey;
+
+FOUNDATION_EXPORT NSString *const STPRedirectContextStateKey;
+
+NS_ASSUME_NONNULL_END
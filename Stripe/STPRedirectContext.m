@@ -7,6 +7,7 @@
 //
 
 #import "STPRedirectContext.h"
+#import "STPRedirectContext+Private.h"
 
 #import "STPDispatchFunctions.h"
 #import "STPSource.h"
@@ -19,10 +20,13 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+
 @interface STPRedirectContext () <SFSafariViewControllerDelegate, STPURLCallbackListener>
 @property (nonatomic, copy) STPRedirectContextCompletionBlock completion;
 @property (nonatomic, strong) STPSource *source;
 @property (nonatomic, strong, nullable) SFSafariViewController *safariVC;
+// Set if a prepared controller's page failed to load before it was shown
+@property (nonatomic) BOOL safariVCFailedInitialLoad;
 @end
 
 @implementation STPRedirectContext
@@ -51,19 +55,35 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)startSafariViewControllerRedirectFlowFromViewController:(UIViewController *)presentingViewController {
     FAUXPAS_IGNORED_IN_METHOD(APIAvailability)
     if (self.state == STPRedirectContextStateNotStarted) {
-        _state = STPRedirectContextStateInProgress;
+        // A prepared controller that already failed to load gets a fresh
+        // attempt instead.
+        if (self.safariVCFailedInitialLoad) {
+            self.safariVC = nil;
+        }
+        [self prepareSafariViewControllerRedirectFlow];
+        [self transitionToState:STPRedirectContextStateInProgress];
         [self subscribeToUrlAndForegroundNotifications];
-        self.safariVC = [[SFSafariViewController alloc] initWithURL:self.source.redirect.url];
-        self.safariVC.delegate = self;
         [presentingViewController presentViewController:self.safariVC
                                                animated:YES
                                              completion:nil];
     }
 }
 
+- (void)prepareSafariViewControllerRedirectFlow {
+    FAUXPAS_IGNORED_IN_METHOD(APIAvailability)
+    if (self.state != STPRedirectContextStateNotStarted || self.safariVC) {
+        return;
+    }
+    self.safariVCFailedInitialLoad = NO;
+    self.safariVC = [[SFSafariViewController alloc] initWithURL:self.source.redirect.url];
+    self.safariVC.delegate = self;
+    // Loading the view starts loading the page.
+    (void)self.safariVC.view;
+}
+
 - (void)startSafariAppRedirectFlow {
     if (self.state == STPRedirectContextStateNotStarted) {
-        _state = STPRedirectContextStateInProgress;
+        [self transitionToState:STPRedirectContextStateInProgress];
         [self subscribeToUrlAndForegroundNotifications];
         [[UIApplication sharedApplication] openURL:self.source.redirect.url];
     }
@@ -71,7 +91,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)cancel {
     if (self.state == STPRedirectContextStateInProgress) {
-        _state = STPRedirectContextStateCancelled;
+        [self transitionToState:STPRedirectContextStateCancelled];
         [self unsubscribeFromNotificationsAndDismissPresentedViewControllers];
     }
 }
@@ -87,6 +107,10 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)safariViewController:(__unused SFSafariViewController *)controller didCompleteInitialLoad:(BOOL)didLoadSuccessfully { FAUXPAS_IGNORED_ON_LINE(APIAvailability)
     if (didLoadSuccessfully == NO) {
         stpDispatchToMainThreadIfNecessary(^{
+            if (self.state == STPRedirectContextStateNotStarted) {
+                self.safariVCFailedInitialLoad = YES;
+                return;
+            }
             [self handleRedirectCompletionWithError:[NSError stp_genericConnectionError]];
         });
     }
@@ -116,6 +140,25 @@ NS_ASSUME_NONNULL_BEGIN
     _state = STPRedirectContextStateCompleted;
 
     self.completion(self.source.stripeID, self.source.clientSecret, error);
+    // Posted after the completion block so that a poller it starts for this
+    // source hears that the user is back.
+    [self postStateDidChangeNotification];
+}
+
+- (void)transitionToState:(STPRedirectContextState)state {
+    _state = state;
+    [self postStateDidChangeNotification];
+}
+
+- (void)postStateDidChangeNotification {
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
+    userInfo[STPRedirectContextSourceIDKey] = self.source.stripeID;
+    userInfo[STPRedirectContextStateKey] = @(self.state);
+    stpDispatchToMainThreadIfNecessary(^{
+        [[NSNotificationCenter defaultCenter] postNotificationName:STPRedirectContextStateDidChangeNotification
+                                                            object:self
+                                                          userInfo:[userInfo copy]];
+    });
 }
 
 - (void)subscribeToUrlAndForegroundNotifications {
@@ -23,12 +23,6 @@
         STPPaymentCardTextField *paymentField = [[STPPaymentCardTextField alloc] initWithFrame:self.bounds];
         [self.contentView addSubview:paymentField];
         _paymentField = paymentField;
-        
-        STPObscuredCardView *obscuredView = [[STPObscuredCardView alloc] initWithFrame:self.bounds];
-        obscuredView.hidden = YES;
-        obscuredView.delegate = self;
-        [self.contentView addSubview:obscuredView];
-        _obscuredCardView = obscuredView;
         _theme = [STPTheme defaultTheme];
         [self updateAppearance];
     }
@@ -64,17 +58,26 @@
 }
 
 - (BOOL)isEmpty {
-    return self.paymentField.cardNumber.length == 0 && self.obscuredCardView.isEmpty;
+    return self.paymentField.cardNumber.length == 0 && (!self.obscuredCardView || self.obscuredCardView.isEmpty);
 }
 
 - (void)configureWithCard:(STPCard *)card {
     [self.paymentField clear];
+    // Only made once there's a remembered card to show
+    if (!self.obscuredCardView) {
+        STPObscuredCardView *obscuredView = [[STPObscuredCardView alloc] initWithFrame:self.bounds];
+        obscuredView.delegate = self;
+        obscuredView.theme = self.theme;
+        obscuredView.inputAccessoryView = self.inputAccessoryView;
+        [self.contentView addSubview:obscuredView];
+        self.obscuredCardView = obscuredView;
+    }
     self.obscuredCardView.hidden = NO;
     [self.obscuredCardView configureWithCard:card];
 }
 
 - (BOOL)becomeFirstResponder {
-    if (self.obscuredCardView.hidden) {
+    if (!self.obscuredCardView || self.obscuredCardView.hidden) {
         return [self.paymentField becomeFirstResponder];
     } else {
         return [self.obscuredCardView becomeFirstResponder];
@@ -82,13 +85,21 @@
 }
 
 - (void)obscuredCardViewDidClear:(__unused STPObscuredCardView *)cardView {
+    [self didClear];
+}
+
+- (void)didClear {
     self.obscuredCardView.hidden = YES;
     [self.paymentField becomeFirstResponder];
     [self.delegate paymentCellDidClear:self];
 }
 
 - (void)clear {
-    [self.obscuredCardView clear];
+    if (self.obscuredCardView) {
+        [self.obscuredCardView clear];
+    } else {
+        [self didClear];
+    }
 }
 
 @end
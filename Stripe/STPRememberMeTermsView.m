@@ -12,11 +12,14 @@
 #import "STPImageLibrary.h"
 #import "STPLocalizationUtils.h"
 #import "STPStringUtils.h"
+#import "STPTheme+Private.h"
 #import "STPWebViewController.h"
 
 @interface STPRememberMeTermsView()<UITextViewDelegate>
 
 @property(nonatomic, weak)UITextView *textView;
+@property(nonatomic, copy)STPTheme *appliedTheme;
+@property(nonatomic)NSMutableDictionary<NSNumber *, NSNumber *> *heightsByWidth;
 
 @end
 
@@ -44,6 +47,7 @@
         _textView = textView;
         _theme = [STPTheme new];
         _insets = UIEdgeInsetsMake(10, 15, 0, 15);
+        _heightsByWidth = [NSMutableDictionary new];
         [self updateAppearance];
     }
     return self;
@@ -54,22 +58,15 @@ static NSString *const FooterLinkTagTermsOfService = @"termslink";
 static NSString *const FooterLinkTagMoreInfo = @"infolink";
 
 - (NSAttributedString *)buildAttributedString {
-    __block NSString *contents = STPLocalizedString(@"Stripe may store my payment info and phone number for use in this app and other apps, and use my number for verification, subject to Stripe's <pplink>Privacy Policy</pplink> and <termslink>Terms</termslink>. <infolink>More Info</infolink>", 
-                                                    @"Footer shown when the user enables Remember Me that shows additional info. The html-style tags control which parts of the text link to the Stripe Privacy Policy, Terms of Service, and Remember Me More Info pages, and can be moved around as needed in the translation (although they CANNOT overlap).");
+    NSString *localizedString = STPLocalizedString(@"Stripe may store my payment info and phone number for use in this app and other apps, and use my number for verification, subject to Stripe's <pplink>Privacy Policy</pplink> and <termslink>Terms</termslink>. <infolink>More Info</infolink>", 
+                                                   @"Footer shown when the user enables Remember Me that shows additional info. The html-style tags control which parts of the text link to the Stripe Privacy Policy, Terms of Service, and Remember Me More Info pages, and can be moved around as needed in the translation (although they CANNOT overlap).");
     
-    __block NSRange privacyRange;
-    __block NSRange termsRange;
-    __block NSRange learnMoreRange;
-    
-    [STPStringUtils parseRangesFromString:contents 
-                                 withTags:[NSSet setWithArray:@[FooterLinkTagPrivacyPolicy, FooterLinkTagTermsOfService, FooterLinkTagMoreInfo]] 
-                               completion:^(NSString *string, NSDictionary<NSString *,NSValue *> *tagMap) {
-                                   contents = string;
-                                   
-                                   privacyRange = tagMap[FooterLinkTagPrivacyPolicy].rangeValue;
-                                   termsRange = tagMap[FooterLinkTagTermsOfService].rangeValue;
-                                   learnMoreRange = tagMap[FooterLinkTagMoreInfo].rangeValue;
-                               }];
+    STPTaggedStringTemplate *template = [STPTaggedStringTemplate templateWithString:localizedString
+                                                                               tags:[NSSet setWithArray:@[FooterLinkTagPrivacyPolicy, FooterLinkTagTermsOfService, FooterLinkTagMoreInfo]]];
+    NSString *contents = template.string;
+    NSRange privacyRange = [template rangeForTag:FooterLinkTagPrivacyPolicy];
+    NSRange termsRange = [template rangeForTag:FooterLinkTagTermsOfService];
+    NSRange learnMoreRange = [template rangeForTag:FooterLinkTagMoreInfo];
     
     NSURL *privacyURL = [NSURL URLWithString:@"https://checkout.stripe.com/-/privacy"];
     NSURL *termsURL = [NSURL URLWithString:@"https://checkout.stripe.com/-/terms"];
@@ -112,18 +109,35 @@ static NSString *const FooterLinkTagMoreInfo = @"infolink";
 }
 
 - (void)updateAppearance {
-    self.textView.attributedText = [self buildAttributedString];
-    self.textView.linkTextAttributes = @{
-                                         NSFontAttributeName: self.theme.smallFont,
-                                         NSForegroundColorAttributeName: self.theme.primaryForegroundColor
-                                         };
+    STPThemeChange changes = [self.theme changesFromTheme:self.appliedTheme];
+    // The attributed string only depends on the small font and the body text
+    // color; rebuilding it means re-parsing the localized tags.
+    if (changes & (STPThemeChangeFont | STPThemeChangeSecondaryForegroundColor)) {
+        self.textView.attributedText = [self buildAttributedString];
+    }
+    if (changes & (STPThemeChangeFont | STPThemeChangePrimaryForegroundColor)) {
+        self.textView.linkTextAttributes = @{
+                                             NSFontAttributeName: self.theme.smallFont,
+                                             NSForegroundColorAttributeName: self.theme.primaryForegroundColor
+                                             };
+    }
+    if (changes & (STPThemeChangeFont | STPThemeChangeSecondaryForegroundColor | STPThemeChangePrimaryForegroundColor)) {
+        [self.heightsByWidth removeAllObjects];
+    }
+    self.appliedTheme = self.theme;
 }
 
 - (CGFloat)heightForWidth:(CGFloat)maxWidth {
+    NSNumber *cachedHeight = self.heightsByWidth[@(maxWidth)];
+    if (cachedHeight) {
+        return (CGFloat)[cachedHeight doubleValue];
+    }
     CGFloat availableWidth = maxWidth - (self.insets.left + self.insets.right);
-    return ([self.textView sizeThatFits:CGSizeMake(availableWidth, CGFLOAT_MAX)].height
-            + self.insets.top
-            + self.insets.bottom);
+    CGFloat height = ([self.textView sizeThatFits:CGSizeMake(availableWidth, CGFLOAT_MAX)].height
+                      + self.insets.top
+                      + self.insets.bottom);
+    self.heightsByWidth[@(maxWidth)] = @(height);
+    return height;
 }
 
 - (void)layoutSubviews {
@@ -133,6 +147,7 @@ static NSString *const FooterLinkTagMoreInfo = @"infolink";
 
 - (void)setInsets:(UIEdgeInsets)insets {
     _insets = insets;
+    [self.heightsByWidth removeAllObjects];
     [self setNeedsLayout];
 }
 
@@ -0,0 +1,72 @@
+//
+//  STPRemoteBINRanges.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class STPBINRange;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Fetches extra BIN ranges from a remote table, keeps the last good copy on
+ disk, and installs them with `+[STPBINRange installAdditionalRanges:]`.
+
+ The table is a small binary file, the same on the wire and on disk, so the
+ saved copy can be memory-mapped and checked without parsing anything:
+
+     header (48 bytes): "STPB", version (uint32), record count (uint32),
+                        reserved (uint32), SHA-256 of the records (32 bytes)
+     record (12 bytes): prefix length, STPCardBrand value, card number length,
+                        reserved (one byte each), low bound (uint32),
+                        high bound (uint32)
+
+ Integers are little-endian. A table whose checksum or records don't check
+ out is ignored as a whole.
+ */
+@interface STPRemoteBINRanges : NSObject
+
+/**
+ @param urlSession The session to fetch the table with.
+ @param remoteURL Where to fetch the table from.
+ @param fileURL Where to save the last good table.
+ */
+- (instancetype)initWithURLSession:(NSURLSession *)urlSession
+                         remoteURL:(NSURL *)remoteURL
+                           fileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Installs the table saved by an earlier fetch, if there is a valid one.
+ */
+- (BOOL)installSavedRanges;
+
+/**
+ Fetches the remote table in the background. If it is valid, saves it and
+ installs it. `completion` is called on an arbitrary queue.
+ */
+- (void)refreshWithCompletion:(nullable void (^)(BOOL installed))completion;
+
+/**
+ Returns the ranges in a table, or nil if it isn't valid.
+ */
++ (nullable NSArray<STPBINRange *> *)rangesFromData:(NSData *)data;
+
+/**
+ Encodes `ranges` in the table format.
+ */
++ (NSData *)dataWithRanges:(NSArray<STPBINRange *> *)ranges;
+
+/**
+ Where the last good table is saved by default.
+ */
++ (NSURL *)defaultFileURL;
+
+@end
+
+NS_ASSUME_NONNULL_END
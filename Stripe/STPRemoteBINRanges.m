@@ -0,0 +1,168 @@
+//
+//  STPRemoteBINRanges.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPRemoteBINRanges.h"
+
+#import <CommonCrypto/CommonDigest.h>
+#import <libkern/OSByteOrder.h>
+
+#import "STPBINRange.h"
+
+static const char STPRemoteBINRangesMagic[4] = {'S', 'T', 'P', 'B'};
+static const uint32_t STPRemoteBINRangesVersion = 1;
+static const NSUInteger STPRemoteBINRangesHeaderLength = 48;
+static const NSUInteger STPRemoteBINRangesRecordLength = 12;
+static const NSUInteger STPRemoteBINRangesChecksumOffset = 16;
+// Far more than any real table; guards against allocating for a corrupt count.
+static const uint32_t STPRemoteBINRangesMaxRecordCount = 10000;
+static const uint8_t STPRemoteBINRangesMaxCardNumberLength = 19;
+
+static const uint32_t STPRemoteBINRangesPowersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+@interface STPRemoteBINRanges()
+@property (nonatomic) NSURLSession *urlSession;
+@property (nonatomic) NSURL *remoteURL;
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) dispatch_queue_t queue;
+@end
+
+@implementation STPRemoteBINRanges
+
++ (NSURL *)defaultFileURL {
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] firstObject];
+    return [cachesURL URLByAppendingPathComponent:@"com.stripe.binranges.bin"];
+}
+
+- (instancetype)initWithURLSession:(NSURLSession *)urlSession
+                         remoteURL:(NSURL *)remoteURL
+                           fileURL:(NSURL *)fileURL {
+    self = [super init];
+    if (self) {
+        _urlSession = urlSession;
+        _remoteURL = remoteURL;
+        _fileURL = fileURL;
+        _queue = dispatch_queue_create("com.stripe.remoteBINRanges", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (BOOL)installSavedRanges {
+    __block BOOL installed = NO;
+    dispatch_sync(self.queue, ^{
+        NSData *data = [NSData dataWithContentsOfURL:self.fileURL options:NSDataReadingMappedIfSafe error:NULL];
+        NSArray<STPBINRange *> *ranges = data ? [self.class rangesFromData:data] : nil;
+        installed = ranges && [STPBINRange installAdditionalRanges:ranges];
+    });
+    return installed;
+}
+
+- (void)refreshWithCompletion:(void (^)(BOOL))completion {
+    NSURLRequest *request = [NSURLRequest requestWithURL:self.remoteURL
+                                             cachePolicy:NSURLRequestReloadIgnoringLocalCacheData
+                                         timeoutInterval:60];
+    NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, __unused NSError *error) {
+        NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+        if (statusCode != 200 || !data) {
+            if (completion) {
+                completion(NO);
+            }
+            return;
+        }
+        dispatch_async(self.queue, ^{
+            NSArray<STPBINRange *> *ranges = [self.class rangesFromData:data];
+            BOOL installed = ranges && [STPBINRange installAdditionalRanges:ranges];
+            if (installed) {
+                [data writeToURL:self.fileURL atomically:YES];
+            }
+            if (completion) {
+                completion(installed);
+            }
+        });
+    }];
+    if ([task respondsToSelector:@selector(setPriority:)]) {
+        task.priority = NSURLSessionTaskPriorityLow;
+    }
+    [task resume];
+}
+
+#pragma mark - Table format
+
++ (NSData *)checksumForRecordBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(bytes, (CC_LONG)length, digest);
+    return [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
+}
+
++ (NSArray<STPBINRange *> *)rangesFromData:(NSData *)data {
+    if (data.length < STPRemoteBINRangesHeaderLength) {
+        return nil;
+    }
+    const uint8_t *bytes = data.bytes;
+    if (memcmp(bytes, STPRemoteBINRangesMagic, sizeof(STPRemoteBINRangesMagic)) != 0 ||
+        OSReadLittleInt32(bytes, 4) != STPRemoteBINRangesVersion) {
+        return nil;
+    }
+    uint32_t count = OSReadLittleInt32(bytes, 8);
+    if (count > STPRemoteBINRangesMaxRecordCount ||
+        data.length != STPRemoteBINRangesHeaderLength + count * STPRemoteBINRangesRecordLength) {
+        return nil;
+    }
+    const uint8_t *records = bytes + STPRemoteBINRangesHeaderLength;
+    NSUInteger recordsLength = count * STPRemoteBINRangesRecordLength;
+    NSData *checksum = [self checksumForRecordBytes:records length:recordsLength];
+    if (memcmp(checksum.bytes, bytes + STPRemoteBINRangesChecksumOffset, CC_SHA256_DIGEST_LENGTH) != 0) {
+        return nil;
+    }
+
+    NSMutableArray<STPBINRange *> *ranges = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *record = records + i * STPRemoteBINRangesRecordLength;
+        uint8_t prefixLength = record[0];
+        uint8_t brand = record[1];
+        uint8_t length = record[2];
+        uint32_t low = OSReadLittleInt32(record, 4);
+        uint32_t high = OSReadLittleInt32(record, 8);
+        if (prefixLength == 0 || (NSUInteger)prefixLength > STPBINRangeMaxPrefixLength ||
+            (NSInteger)brand > STPCardBrandUnknown ||
+            length == 0 || length > STPRemoteBINRangesMaxCardNumberLength ||
+            low > high || high >= STPRemoteBINRangesPowersOfTen[prefixLength]) {
+            return nil;
+        }
+        NSString *qRangeLow = [NSString stringWithFormat:@"%0*u", (int)prefixLength, low];
+        NSString *qRangeHigh = [NSString stringWithFormat:@"%0*u", (int)prefixLength, high];
+        [ranges addObject:[[STPBINRange alloc] initWithQRangeLow:qRangeLow
+                                                      qRangeHigh:qRangeHigh
+                                                          length:length
+                                                           brand:(STPCardBrand)brand]];
+    }
+    return [ranges copy];
+}
+
++ (NSData *)dataWithRanges:(NSArray<STPBINRange *> *)ranges {
+    NSUInteger recordsLength = ranges.count * STPRemoteBINRangesRecordLength;
+    NSMutableData *data = [NSMutableData dataWithLength:STPRemoteBINRangesHeaderLength + recordsLength];
+    uint8_t *bytes = data.mutableBytes;
+    memcpy(bytes, STPRemoteBINRangesMagic, sizeof(STPRemoteBINRangesMagic));
+    OSWriteLittleInt32(bytes, 4, STPRemoteBINRangesVersion);
+    OSWriteLittleInt32(bytes, 8, (uint32_t)ranges.count);
+
+    uint8_t *records = bytes + STPRemoteBINRangesHeaderLength;
+    [ranges enumerateObjectsUsingBlock:^(STPBINRange *range, NSUInteger i, __unused BOOL *stop) {
+        uint8_t *record = records + i * STPRemoteBINRangesRecordLength;
+        record[0] = (uint8_t)range.qRangeLow.length;
+        record[1] = (uint8_t)range.brand;
+        record[2] = (uint8_t)range.length;
+        OSWriteLittleInt32(record, 4, (uint32_t)range.qRangeLow.integerValue);
+        OSWriteLittleInt32(record, 8, (uint32_t)range.qRangeHigh.integerValue);
+    }];
+    NSData *checksum = [self checksumForRecordBytes:records length:recordsLength];
+    memcpy(bytes + STPRemoteBINRangesChecksumOffset, checksum.bytes, CC_SHA256_DIGEST_LENGTH);
+    return [data copy];
+}
+
+@end
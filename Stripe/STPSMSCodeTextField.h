@@ -18,7 +18,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
-@interface STPSMSCodeTextField : UIView
+/**
+ A six digit code entry field. The digits are kept in a single string and
+ drawn into one layer, rather than each having a text field of its own.
+ */
+@interface STPSMSCodeTextField : UIView <UIKeyInput>
 
 @property(nonatomic, weak)id<STPSMSCodeTextFieldDelegate>delegate;
 @property(nonatomic)STPTheme *theme;
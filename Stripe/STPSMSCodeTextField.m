@@ -8,51 +8,86 @@
 
 #import "STPSMSCodeTextField.h"
 
-#import "NSArray+Stripe_BoundSafe.h"
 #import "NSString+Stripe.h"
 #import "STPCardValidator.h"
+#import "STPLocalizationUtils.h"
 #import "STPTheme.h"
+#import "STPTheme+Private.h"
 
-@class STPCodeInternalTextField;
+static const NSUInteger STPSMSCodeLength = 6;
 
-@protocol STPCodeInternalTextFieldDelegate <NSObject>
-- (void)internalTextFieldDidBackspaceOnEmpty:(STPCodeInternalTextField *)textField;
+/**
+ Draws every digit of the code, and the separators between them, into one
+ layer laid over the two halves of the field.
+ */
+@interface STPSMSCodeDigitsView : UIView
+@property(nonatomic, copy)NSString *code;
+@property(nonatomic, copy)NSArray<NSValue *> *slotFrames;
+@property(nonatomic)UIFont *font;
+@property(nonatomic)UIColor *textColor;
+@property(nonatomic)UIColor *separatorColor;
 @end
 
-@interface STPCodeInternalTextField : UITextField
-@property(nonatomic, weak)id<STPCodeInternalTextFieldDelegate>internalDelegate;
-@end
-
-@implementation STPCodeInternalTextField
+@implementation STPSMSCodeDigitsView
 
-- (void)deleteBackward {
-    [super deleteBackward];
-    if (self.text.length == 0) {
-        [self.internalDelegate internalTextFieldDidBackspaceOnEmpty:self];
+- (instancetype)initWithFrame:(CGRect)frame {
+    self = [super initWithFrame:frame];
+    if (self) {
+        _code = @"";
+        self.opaque = NO;
+        self.backgroundColor = [UIColor clearColor];
+        self.userInteractionEnabled = NO;
+        self.contentMode = UIViewContentModeRedraw;
     }
+    return self;
+}
+
+- (void)drawRect:(__unused CGRect)rect {
+    NSDictionary *attributes = @{NSFontAttributeName: self.font ?: [UIFont systemFontOfSize:18],
+                                 NSForegroundColorAttributeName: self.textColor ?: [UIColor blackColor]};
+    [self.separatorColor setFill];
+    [self.slotFrames enumerateObjectsUsingBlock:^(NSValue *value, NSUInteger idx, __unused BOOL *stop) {
+        CGRect slot = value.CGRectValue;
+        if (idx % 3 != 2) {
+            UIRectFill(CGRectMake(CGRectGetMaxX(slot), CGRectGetMinY(slot), 0.5f, CGRectGetHeight(slot)));
+        }
+        if (idx < self.code.length) {
+            NSString *digit = [self.code substringWithRange:NSMakeRange(idx, 1)];
+            CGSize size = [digit sizeWithAttributes:attributes];
+            CGPoint origin = CGPointMake(CGRectGetMidX(slot) - size.width / 2, CGRectGetMidY(slot) - size.height / 2);
+            [digit drawAtPoint:origin withAttributes:attributes];
+        }
+    }];
 }
 
 @end
 
-@interface STPSMSCodeTextField()<UITextFieldDelegate, STPCodeInternalTextFieldDelegate>
+@interface STPSMSCodeTextField()
 
 @property(nonatomic, weak)UIView *leftContainerView;
 @property(nonatomic, weak)UILabel *centerLabel;
 @property(nonatomic, weak)UIView *rightContainerView;
-@property(nonatomic)NSArray *textFields;
-@property(nonatomic)NSArray *separators;
-@property(nonatomic, weak)UIView *coveringView;
+@property(nonatomic, weak)STPSMSCodeDigitsView *digitsView;
+@property(nonatomic, weak)UIView *caretView;
+@property(nonatomic)NSMutableString *digits;
+@property(nonatomic, copy)NSArray<NSValue *> *slotFrames;
+@property(nonatomic, copy)STPTheme *appliedTheme;
 
 @end
 
 @implementation STPSMSCodeTextField
 
+@synthesize keyboardType = _keyboardType;
+
 - (instancetype)initWithFrame:(CGRect)frame {
     self = [super initWithFrame:frame];
     if (self) {
         _theme = [STPTheme new];
+        _digits = [NSMutableString stringWithCapacity:STPSMSCodeLength];
+        _keyboardType = UIKeyboardTypePhonePad;
         
         UIView *leftContainerView = [UIView new];
+        leftContainerView.userInteractionEnabled = NO;
         [self addSubview:leftContainerView];
         _leftContainerView = leftContainerView;
         
@@ -63,34 +98,25 @@
         _centerLabel = centerLabel;
         
         UIView *rightContainerView = [UIView new];
+        rightContainerView.userInteractionEnabled = NO;
         [self addSubview:rightContainerView];
         _rightContainerView = rightContainerView;
+
+        STPSMSCodeDigitsView *digitsView = [STPSMSCodeDigitsView new];
+        [self addSubview:digitsView];
+        _digitsView = digitsView;
+
+        UIView *caretView = [UIView new];
+        caretView.userInteractionEnabled = NO;
+        caretView.hidden = YES;
+        [self addSubview:caretView];
+        _caretView = caretView;
         
-        NSMutableArray *textFields = [NSMutableArray array];
-        NSMutableArray *separators = [NSMutableArray array];
-        for (UIView *containerView in @[leftContainerView, rightContainerView]) {
-            for (NSInteger i=0; i < 3; i++) {
-                STPCodeInternalTextField *textField = [STPCodeInternalTextField new];
-                textField.delegate = self;
-                textField.keyboardType = UIKeyboardTypePhonePad;
-                textField.internalDelegate = self;
-                textField.textAlignment = NSTextAlignmentCenter;
-                [textFields addObject:textField];
-                [containerView addSubview:textField];
-                
-                UIView *separator = [UIView new];
-                [separators addObject:separator];
-                [containerView addSubview:separator];
-            }
-        }
-        _textFields = [textFields copy];
-        _separators = [separators copy];
-        
-        UIView *coveringView = [UIView new];
         UITapGestureRecognizer *gestureRecognizer = [[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(becomeFirstResponder)];
-        [coveringView addGestureRecognizer:gestureRecognizer];
-        [self addSubview:coveringView];
-        _coveringView = coveringView;
+        [self addGestureRecognizer:gestureRecognizer];
+        
+        self.isAccessibilityElement = YES;
+        self.accessibilityLabel = STPLocalizedString(@"Verification Code", @"Title for SMS verification code screen");
         
         [self updateAppearance];
     }
@@ -106,42 +132,152 @@
     self.rightContainerView.frame = CGRectMake(rightContainerX, 0, self.bounds.size.width - rightContainerX, self.bounds.size.height);
     CGFloat fieldWidth = (CGFloat)round(self.leftContainerView.bounds.size.width / 3.0f);
     CGFloat fieldHeight = self.leftContainerView.bounds.size.height;
-    for (NSInteger i=0; i < 6; i++) {
-        NSInteger j = i % 3;
-        UITextField *textField = self.textFields[i];
-        textField.frame = CGRectMake(j * fieldWidth, 0, fieldWidth, fieldHeight);
-        
-        UIView *separator = self.separators[i];
-        separator.frame = CGRectMake(((j+1) * fieldWidth), 0, 0.5, fieldHeight);
-        separator.hidden = j == 2;
+    NSMutableArray<NSValue *> *slotFrames = [NSMutableArray arrayWithCapacity:STPSMSCodeLength];
+    for (NSUInteger i = 0; i < STPSMSCodeLength; i++) {
+        UIView *containerView = i < 3 ? self.leftContainerView : self.rightContainerView;
+        CGRect slot = CGRectMake(CGRectGetMinX(containerView.frame) + (i % 3) * fieldWidth, 0, fieldWidth, fieldHeight);
+        [slotFrames addObject:[NSValue valueWithCGRect:slot]];
     }
-    self.coveringView.frame = self.bounds;
+    self.digitsView.frame = self.bounds;
+    if (![slotFrames isEqualToArray:self.slotFrames]) {
+        self.slotFrames = slotFrames;
+        self.digitsView.slotFrames = slotFrames;
+        [self.digitsView setNeedsDisplay];
+    }
+    [self updateCaret];
+}
+
+#pragma mark - Responder
+
+- (BOOL)canBecomeFirstResponder {
+    return YES;
 }
 
 - (BOOL)becomeFirstResponder {
-    UITextField *emptyField;
-    for (UITextField *textField in self.textFields) {
-        if (textField.text.length == 0) {
-            emptyField = textField;
-            break;
-        }
+    BOOL became = [super becomeFirstResponder];
+    [self updateCaret];
+    return became;
+}
+
+- (BOOL)resignFirstResponder {
+    BOOL resigned = [super resignFirstResponder];
+    [self updateCaret];
+    return resigned;
+}
+
+/**
+ Shows a blinking caret in the slot the next digit goes into, or the last
+ one once the code is complete.
+ */
+- (void)updateCaret {
+    BOOL visible = self.isFirstResponder && self.slotFrames.count == STPSMSCodeLength;
+    if (!visible) {
+        self.caretView.hidden = YES;
+        [self.caretView.layer removeAnimationForKey:@"blink"];
+        return;
     }
-    if (!emptyField) {
-        emptyField = self.textFields.lastObject;
+    NSUInteger index = MIN(self.digits.length, STPSMSCodeLength - 1);
+    CGRect slot = self.slotFrames[index].CGRectValue;
+    CGFloat height = (CGFloat)ceil(self.theme.largeFont.lineHeight);
+    CGFloat x = CGRectGetMidX(slot);
+    if (index < self.digits.length) {
+        NSString *digit = [self.digits substringWithRange:NSMakeRange(index, 1)];
+        x += [digit sizeWithAttributes:@{NSFontAttributeName: self.theme.largeFont}].width / 2 + 1;
+    }
+    self.caretView.frame = CGRectMake((CGFloat)round(x - 1), (CGFloat)round(CGRectGetMidY(slot) - height / 2), 2, height);
+    self.caretView.hidden = NO;
+    if (![self.caretView.layer animationForKey:@"blink"]) {
+        CAKeyframeAnimation *blink = [CAKeyframeAnimation animationWithKeyPath:@"opacity"];
+        blink.values = @[@1, @1, @0, @0];
+        blink.keyTimes = @[@0, @0.5, @0.5, @1];
+        blink.duration = 1;
+        blink.repeatCount = HUGE_VALF;
+        [self.caretView.layer addAnimation:blink forKey:@"blink"];
     }
-    return [emptyField becomeFirstResponder];
 }
 
-- (BOOL)resignFirstResponder {
-    [super resignFirstResponder];
-    for (UITextField *textField in self.textFields) {
-        if ([textField isFirstResponder]) {
-            return [textField resignFirstResponder];
-        }
+#pragma mark - Accessibility
+
+- (NSString *)accessibilityValue {
+    return self.code;
+}
+
+/**
+ There is no public trait for text entry, so borrow the one VoiceOver reads
+ off a UITextField; it announces the field as editable and brings up the
+ keyboard on double tap.
+ */
+- (UIAccessibilityTraits)accessibilityTraits {
+    static UIAccessibilityTraits textFieldTraits;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        textFieldTraits = [UITextField new].accessibilityTraits;
+    });
+    return [super accessibilityTraits] | textFieldTraits;
+}
+
+- (BOOL)accessibilityActivate {
+    return [self becomeFirstResponder];
+}
+
+#pragma mark - UIKeyInput
+
+- (BOOL)hasText {
+    return self.digits.length > 0;
+}
+
+- (void)insertText:(NSString *)text {
+    if (![STPCardValidator stringIsNumeric:text]) {
+        return;
+    }
+    BOOL wasComplete = self.digits.length == STPSMSCodeLength;
+    NSUInteger available = STPSMSCodeLength - self.digits.length;
+    if (wasComplete) {
+        // Typing over a complete code replaces its last digit
+        [self.digits deleteCharactersInRange:NSMakeRange(STPSMSCodeLength - 1, 1)];
+        available = 1;
+    }
+    [self.digits appendString:[text stp_safeSubstringToIndex:available]];
+    [self digitsDidChange];
+    if (self.digits.length == STPSMSCodeLength) {
+        [self resignFirstResponder];
+        [self.delegate codeTextField:self didEnterCode:self.code];
+    }
+}
+
+- (void)deleteBackward {
+    if (self.digits.length == 0) {
+        return;
+    }
+    [self.digits deleteCharactersInRange:NSMakeRange(self.digits.length - 1, 1)];
+    [self digitsDidChange];
+}
+
+- (BOOL)canPerformAction:(SEL)action withSender:(id)sender {
+    if (action == @selector(paste:)) {
+        return [UIPasteboard generalPasteboard].string.length > 0;
+    }
+    return [super canPerformAction:action withSender:sender];
+}
+
+- (void)paste:(__unused id)sender {
+    NSString *string = [UIPasteboard generalPasteboard].string;
+    if (string) {
+        [self insertText:[STPCardValidator sanitizedNumericStringForString:string]];
+    }
+}
+
+- (void)digitsDidChange {
+    self.digitsView.code = self.digits;
+    [self.digitsView setNeedsDisplay];
+    [self updateCaret];
+    if (self.accessibilityElementIsFocused) {
+        UIAccessibilityPostNotification(UIAccessibilityLayoutChangedNotification, self);
     }
-    return NO;
 }
 
+#pragma mark - Animation
+
 - (void)shakeAndClear {
     for (UIView *containerView in @[self.leftContainerView, self.rightContainerView]) {
         CABasicAnimation *colorAnimation = [CABasicAnimation animationWithKeyPath:@"borderColor"];
@@ -169,9 +305,7 @@
                      animations:^{
         self.transform = CGAffineTransformIdentity;
     } completion:^(__unused BOOL finished) {
-        for (UITextField *textField in self.textFields) {
-            textField.text = nil;
-        }
+        self.code = @"";
         for (UIView *containerView in @[self.leftContainerView, self.rightContainerView]) {
             CABasicAnimation *colorAnimation = [CABasicAnimation animationWithKeyPath:@"borderColor"];
             colorAnimation.fromValue = (id)containerView.layer.borderColor;
@@ -193,81 +327,65 @@
     }];
 }
 
+#pragma mark - Theme
+
 - (void)setTheme:(STPTheme *)theme {
     _theme = theme;
     [self updateAppearance];
 }
 
 - (void)updateAppearance {
-    self.backgroundColor = [UIColor clearColor];
-    self.coveringView.backgroundColor = [UIColor clearColor];
+    STPThemeChange changes = [self.theme changesFromTheme:self.appliedTheme];
+    BOOL firstUpdate = (self.appliedTheme == nil);
+    if (firstUpdate) {
+        self.backgroundColor = [UIColor clearColor];
+    }
     for (UIView *containerView in @[self.leftContainerView, self.rightContainerView]) {
-        containerView.layer.cornerRadius = 6;
-        containerView.layer.borderWidth = 0.5f;
-        containerView.layer.borderColor = self.theme.tertiaryBackgroundColor.CGColor;
-        containerView.backgroundColor = self.theme.secondaryBackgroundColor;
+        if (firstUpdate) {
+            containerView.layer.cornerRadius = 6;
+            containerView.layer.borderWidth = 0.5f;
+        }
+        if (changes & STPThemeChangePrimaryBackgroundColor) {
+            containerView.layer.borderColor = self.theme.tertiaryBackgroundColor.CGColor;
+        }
+        if (changes & STPThemeChangeSecondaryBackgroundColor) {
+            containerView.backgroundColor = self.theme.secondaryBackgroundColor;
+        }
     }
-    self.centerLabel.textColor = self.theme.secondaryForegroundColor;
-    self.centerLabel.font = self.theme.largeFont;
-    for (UIView *separator in self.separators) {
-        separator.backgroundColor = self.theme.quaternaryBackgroundColor;
+    if (changes & STPThemeChangeSecondaryForegroundColor) {
+        self.centerLabel.textColor = self.theme.secondaryForegroundColor;
     }
-    for (UITextField *textField in self.textFields) {
-        textField.textColor = self.theme.primaryForegroundColor;
-        textField.tintColor = self.theme.accentColor;
-        textField.font = self.theme.largeFont;
+    if (changes & STPThemeChangeFont) {
+        self.centerLabel.font = self.theme.largeFont;
+        self.digitsView.font = self.theme.largeFont;
     }
-}
-
-- (BOOL)textField:(UITextField *)textField shouldChangeCharactersInRange:(NSRange)range replacementString:(NSString *)string {
-    if (![STPCardValidator stringIsNumeric:string]) {
-        return NO;
+    if (changes & STPThemeChangePrimaryBackgroundColor) {
+        self.digitsView.separatorColor = self.theme.quaternaryBackgroundColor;
     }
-    NSString *destination = [[textField.text stringByReplacingCharactersInRange:range withString:string] stp_safeSubstringToIndex:1];
-    textField.text = destination;
-    UITextField *nextField = [self fieldAfter:textField];
-    if (nextField) {
-        [nextField becomeFirstResponder];
-    } else {
-        [textField resignFirstResponder];
-        [self.delegate codeTextField:self didEnterCode:self.code];
+    if (changes & STPThemeChangePrimaryForegroundColor) {
+        self.digitsView.textColor = self.theme.primaryForegroundColor;
     }
-    return NO;
-}
-
-- (void)internalTextFieldDidBackspaceOnEmpty:(STPCodeInternalTextField *)textField {
-    UITextField *previousField = [self fieldBefore:textField];
-    previousField.text = @"";
-    [previousField becomeFirstResponder];
-}
-
-- (UITextField *)fieldBefore:(UITextField *)field {
-    NSInteger index = [self.textFields indexOfObject:field];
-    return [self.textFields stp_boundSafeObjectAtIndex:index-1];
+    if (changes & STPThemeChangeAccentColor) {
+        self.caretView.backgroundColor = self.theme.accentColor;
+    }
+    if (changes & (STPThemeChangeFont | STPThemeChangePrimaryBackgroundColor | STPThemeChangePrimaryForegroundColor)) {
+        [self.digitsView setNeedsDisplay];
+    }
+    if (changes & STPThemeChangeFont) {
+        [self updateCaret];
+    }
+    self.appliedTheme = self.theme;
 }
 
-- (UITextField *)fieldAfter:(UITextField *)field {
-    NSInteger index = [self.textFields indexOfObject:field];
-    return [self.textFields stp_boundSafeObjectAtIndex:index+1];
-}
+#pragma mark - Code
 
 - (NSString *)code {
-    NSMutableString *code = [NSMutableString string];
-    for (UITextField *aTextField in self.textFields) {
-        [code appendString:aTextField.text];
-    }
-    return code.copy;
+    return [self.digits copy];
 }
 
 - (void)setCode:(NSString *)code {
-    [self.textFields enumerateObjectsUsingBlock:^(UITextField *_Nonnull aTextField, NSUInteger idx, __unused BOOL * _Nonnull stop) {
-        if (idx < code.length) {
-            aTextField.text = [code substringWithRange:NSMakeRange(idx, 1)];
-        }
-        else {
-            aTextField.text = @"";
-        }
-    }];
+    [self.digits setString:[code ?: @"" stp_safeSubstringToIndex:STPSMSCodeLength]];
+    [self digitsDidChange];
 }
 
 @end
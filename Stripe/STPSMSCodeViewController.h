@@ -22,10 +22,15 @@
 
 @interface STPSMSCodeViewController : STPCoreScrollViewController
 
+/**
+ `verification` may be nil while the SMS is still being sent, so that the
+ view controller can be built ahead of time. Set it before presenting.
+ */
 - (instancetype)initWithCheckoutAPIClient:(STPCheckoutAPIClient *)checkoutAPIClient
                              verification:(STPCheckoutAPIVerification *)verification
                             redactedPhone:(NSString *)redactedPhone;
 
 @property(nonatomic, weak)id<STPSMSCodeViewControllerDelegate>delegate;
+@property(nonatomic)STPCheckoutAPIVerification *verification;
 
 @end
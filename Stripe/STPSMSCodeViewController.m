@@ -25,9 +25,13 @@
 @interface STPSMSCodeViewController()<STPSMSCodeTextFieldDelegate>
 
 @property(nonatomic)STPCheckoutAPIClient *checkoutAPIClient;
-@property(nonatomic)STPCheckoutAPIVerification *verification;
 @property(nonatomic)NSString *redactedPhone;
 @property(nonatomic)NSTimer *hideSMSSentLabelTimer;
+/**
+ The pasteboard's `changeCount` when its contents were last looked at, so
+ they're only read again once something new has been copied.
+ */
+@property(nonatomic)NSInteger checkedPasteboardChangeCount;
 
 @property(nonatomic, weak)UILabel *topLabel;
 @property(nonatomic, weak)STPSMSCodeTextField *codeField;
@@ -51,6 +55,9 @@
         _checkoutAPIClient = checkoutAPIClient;
         _verification = verification;
         _redactedPhone = redactedPhone;
+        // This is built before the SMS is sent, so nothing already on the
+        // pasteboard can be the code.
+        _checkedPasteboardChangeCount = [UIPasteboard generalPasteboard].changeCount;
     }
     return self;
 }
@@ -138,7 +145,12 @@
 
 - (void)applicationDidBecomeActive {
     if (self.view.superview != nil) {
-        NSString *pasteboardString = [UIPasteboard generalPasteboard].string;
+        UIPasteboard *pasteboard = [UIPasteboard generalPasteboard];
+        if (pasteboard.changeCount == self.checkedPasteboardChangeCount) {
+            return;
+        }
+        self.checkedPasteboardChangeCount = pasteboard.changeCount;
+        NSString *pasteboardString = pasteboard.string;
         BOOL clipboardIsCode = NO;
         if (pasteboardString.length == 6) {
             NSCharacterSet *invalidCharacterset = [NSCharacterSet characterSetWithCharactersInString:@"0123456789"].invertedSet;
@@ -232,6 +244,7 @@
                                                  }
                                              }];
     [self.codeField becomeFirstResponder];
+    [self.hideSMSSentLabelTimer invalidate];
     self.hideSMSSentLabelTimer = [NSTimer scheduledTimerWithTimeInterval:10.0f target:self selector:@selector(hideSMSSentLabel) userInfo:nil repeats:NO];
 }
 
@@ -319,6 +332,7 @@
 - (void)pasteCodeFromClipboard {
     self.codeField.code = [UIPasteboard generalPasteboard].string;
     [UIPasteboard generalPasteboard].string = @"";
+    self.checkedPasteboardChangeCount = [UIPasteboard generalPasteboard].changeCount;
     [self setPasteFromClipboardButtonVisible:NO];
     [self codeTextField:self.codeField
            didEnterCode:self.codeField.code];
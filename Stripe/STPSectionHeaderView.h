@@ -16,4 +16,10 @@
 @property(nonatomic, nullable, weak)UIButton *button;
 @property(nonatomic)BOOL buttonHidden;
 
+/**
+ Everything the header's height depends on besides its width, for
+ `-[STPCoreTableViewController cachedHeightForContentKey:width:computation:]`.
+ */
+@property(nonatomic, nonnull, readonly)id<NSCopying> heightCacheKey;
+
 @end
@@ -8,9 +8,12 @@
 
 #import "STPSectionHeaderView.h"
 
+#import "STPTheme+Private.h"
+
 @interface STPSectionHeaderView()
 @property(nonatomic, weak)UILabel *label;
 @property(nonatomic)UIEdgeInsets buttonInsets;
+@property(nonatomic)NSUInteger appliedThemeChangeToken;
 @end
 
 @implementation STPSectionHeaderView
@@ -40,7 +43,11 @@
 }
 
 - (void)setTheme:(STPTheme *)theme {
+    if (theme == _theme && theme.changeToken == self.appliedThemeChangeToken) {
+        return;
+    }
     _theme = theme;
+    self.appliedThemeChangeToken = theme.changeToken;
     [self updateAppearance];
 }
 
@@ -107,6 +114,13 @@
     return buttonSize.height + insets.top + insets.bottom;
 }
 
+- (id<NSCopying>)heightCacheKey {
+    return @[self.title ?: @"",
+             self.button.titleLabel.text ?: @"",
+             @(self.buttonHidden),
+             self.theme.smallFont];
+}
+
 - (CGSize)sizeThatFits:(CGSize)size {
     return CGSizeMake(size.width, [self heightThatFits:size]);
 }
@@ -11,15 +11,18 @@
 #import "NSArray+Stripe_BoundSafe.h"
 #import "STPAddress.h"
 #import "STPAddressViewModel.h"
+#import "STPAnalyticsClient.h"
 #import "STPColorUtils.h"
 #import "STPCoreTableViewController+Private.h"
 #import "STPImageLibrary+Private.h"
 #import "STPLocalizationUtils.h"
 #import "STPPaymentActivityIndicatorView.h"
 #import "STPPaymentContext+Private.h"
+#import "STPPromise.h"
 #import "STPSectionHeaderView.h"
 #import "STPShippingMethodsViewController.h"
 #import "STPTheme.h"
+#import "STPWeakStrongMacros.h"
 #import "UIBarButtonItem+Stripe.h"
 #import "UINavigationController+Stripe_Completion.h"
 #import "UITableViewCell+Stripe_Borders.h"
@@ -27,6 +30,39 @@
 #import "UIViewController+Stripe_NavigationItemProxy.h"
 #import "UIViewController+Stripe_ParentViewController.h"
 
+// How long the address has to stay the same before shipping methods are
+// prefetched for it
+static NSTimeInterval const ShippingMethodsPrefetchDebounceInterval = 0.5;
+
+/**
+ What the delegate returned for an address.
+ */
+@interface STPShippingMethodsResult : NSObject
+@property(nonatomic)STPShippingStatus status;
+@property(nonatomic)NSError *error;
+@property(nonatomic)NSArray<PKShippingMethod *> *shippingMethods;
+@property(nonatomic)PKShippingMethod *selectedShippingMethod;
+@end
+
+@implementation STPShippingMethodsResult
+@end
+
+/**
+ Identifies an address by everything the delegate could validate it on.
+ */
+static NSString *STPShippingAddressKey(STPAddress *address) {
+    NSArray<NSString *> *fields = @[address.name ?: @"",
+                                    address.line1 ?: @"",
+                                    address.line2 ?: @"",
+                                    address.city ?: @"",
+                                    address.state ?: @"",
+                                    address.postalCode ?: @"",
+                                    address.country ?: @"",
+                                    address.phone ?: @"",
+                                    address.email ?: @""];
+    return [fields componentsJoinedByString:@"\n"];
+}
+
 @interface STPShippingAddressViewController ()<STPAddressViewModelDelegate, UITableViewDelegate, UITableViewDataSource, STPShippingMethodsViewControllerDelegate>
 @property(nonatomic)STPPaymentConfiguration *configuration;
 @property(nonatomic)NSString *currency;
@@ -39,6 +75,9 @@
 @property(nonatomic)STPAddress *billingAddress;
 @property(nonatomic)BOOL hasUsedBillingAddress;
 @property(nonatomic)STPSectionHeaderView *addressHeaderView;
+@property(nonatomic)NSUInteger prefetchGeneration;
+@property(nonatomic, copy)NSString *prefetchedAddressKey;
+@property(nonatomic)STPPromise<STPShippingMethodsResult *> *prefetchedShippingMethods;
 @end
 
 @implementation STPShippingAddressViewController
@@ -101,6 +140,7 @@
             _addressViewModel.address = prefilledAddress;
         }
         self.title = [self titleForShippingType:self.configuration.shippingType];
+        [STPAnalyticsClient trackProductUsage:STPAnalyticsProductUsageShippingAddressViewController];
     }
     return self;
 }
@@ -220,13 +260,28 @@
     STPAddress *address = self.addressViewModel.address;
     switch (self.configuration.shippingType) {
         case STPShippingTypeShipping: {
-            self.loading = YES;
-            [self.delegate shippingAddressViewController:self didEnterAddress:address completion:^(STPShippingStatus status, NSError * __nullable shippingValidationError, NSArray<PKShippingMethod *>* __nullable shippingMethods, PKShippingMethod * __nullable selectedShippingMethod) {
+            // Cancel any prefetch still waiting out its debounce
+            self.prefetchGeneration++;
+            NSString *key = STPShippingAddressKey(address);
+            STPPromise<STPShippingMethodsResult *> *promise;
+            if (self.prefetchedShippingMethods && [key isEqualToString:self.prefetchedAddressKey]) {
+                promise = self.prefetchedShippingMethods;
+            } else {
+                promise = [self shippingMethodsForAddress:address];
+            }
+            // A finished prefetch is handled straight away, so there's
+            // nothing to show a spinner for.
+            if (!promise.completed) {
+                self.loading = YES;
+            }
+            WEAK(self);
+            [promise onSuccess:^(STPShippingMethodsResult *result) {
+                STRONG(self);
                 self.loading = NO;
-                if (status == STPShippingStatusValid) {
-                    if ([shippingMethods count] > 0) {
-                        STPShippingMethodsViewController *nextViewController = [[STPShippingMethodsViewController alloc] initWithShippingMethods:shippingMethods
-                                                                                                                          selectedShippingMethod:selectedShippingMethod
+                if (result.status == STPShippingStatusValid) {
+                    if ([result.shippingMethods count] > 0) {
+                        STPShippingMethodsViewController *nextViewController = [[STPShippingMethodsViewController alloc] initWithShippingMethods:result.shippingMethods
+                                                                                                                          selectedShippingMethod:result.selectedShippingMethod
                                                                                                                                         currency:self.currency
                                                                                                                                            theme:self.theme];
                         nextViewController.delegate = self;
@@ -239,7 +294,12 @@
                     }
                 }
                 else {
-                    [self handleShippingValidationError:shippingValidationError];
+                    // Ask again if the user retries with the same address
+                    if (promise == self.prefetchedShippingMethods) {
+                        self.prefetchedShippingMethods = nil;
+                        self.prefetchedAddressKey = nil;
+                    }
+                    [self handleShippingValidationError:result.error];
                 }
             }];
             break;
@@ -252,6 +312,48 @@
     }
 }
 
+- (STPPromise<STPShippingMethodsResult *> *)shippingMethodsForAddress:(STPAddress *)address {
+    STPPromise<STPShippingMethodsResult *> *promise = [STPPromise new];
+    [self.delegate shippingAddressViewController:self didEnterAddress:address completion:^(STPShippingStatus status, NSError * __nullable shippingValidationError, NSArray<PKShippingMethod *>* __nullable shippingMethods, PKShippingMethod * __nullable selectedShippingMethod) {
+        STPShippingMethodsResult *result = [STPShippingMethodsResult new];
+        result.status = status;
+        result.error = shippingValidationError;
+        result.shippingMethods = shippingMethods;
+        result.selectedShippingMethod = selectedShippingMethod;
+        [promise succeed:result];
+    }];
+    return promise;
+}
+
+/**
+ Once the address has been valid and unchanged for a moment, asks the
+ delegate for its shipping methods, so tapping Next can push them straight
+ away. Only the latest address's result is kept.
+ */
+- (void)prefetchShippingMethodsIfNeeded {
+    NSUInteger generation = ++self.prefetchGeneration;
+    if (!self.configuration.shippingMethodsPrefetchingEnabled
+        || self.configuration.shippingType != STPShippingTypeShipping
+        || !self.addressViewModel.isValid
+        || self.loading) {
+        return;
+    }
+    STPAddress *address = self.addressViewModel.address;
+    NSString *key = STPShippingAddressKey(address);
+    if ([key isEqualToString:self.prefetchedAddressKey]) {
+        return;
+    }
+    WEAK(self);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(ShippingMethodsPrefetchDebounceInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        STRONG(self);
+        if (generation != self.prefetchGeneration) {
+            return;
+        }
+        self.prefetchedAddressKey = key;
+        self.prefetchedShippingMethods = [self shippingMethodsForAddress:address];
+    });
+}
+
 - (void)updateDoneButton {
     self.stp_navigationItemProxy.rightBarButtonItem.enabled = self.addressViewModel.isValid;
 }
@@ -301,8 +403,17 @@
     [self.tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationAutomatic];
 }
 
+- (void)addressViewModelWillBeginUpdates:(__unused STPAddressViewModel *)addressViewModel {
+    [self.tableView beginUpdates];
+}
+
+- (void)addressViewModelDidEndUpdates:(__unused STPAddressViewModel *)addressViewModel {
+    [self.tableView endUpdates];
+}
+
 - (void)addressViewModelDidChange:(__unused STPAddressViewModel *)addressViewModel {
     [self updateDoneButton];
+    [self prefetchShippingMethodsIfNeeded];
 }
 
 #pragma mark - UITableView
@@ -326,11 +437,11 @@
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
     BOOL topRow = (indexPath.row == 0);
     BOOL bottomRow = ([self tableView:tableView numberOfRowsInSection:indexPath.section] - 1 == indexPath.row);
-    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor];
-    [cell stp_setTopBorderHidden:!topRow];
-    [cell stp_setBottomBorderHidden:!bottomRow];
-    [cell stp_setFakeSeparatorColor:self.theme.quaternaryBackgroundColor];
-    [cell stp_setFakeSeparatorLeftInset:15.0f];
+    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor
+          fakeSeparatorColor:self.theme.quaternaryBackgroundColor
+      fakeSeparatorLeftInset:15.0f
+             topBorderHidden:!topRow
+          bottomBorderHidden:!bottomRow];
 }
 
 - (CGFloat)tableView:(__unused UITableView *)tableView heightForFooterInSection:(__unused NSInteger)section {
@@ -342,8 +453,11 @@
 }
 
 - (CGFloat)tableView:(__unused UITableView *)tableView heightForHeaderInSection:(__unused NSInteger)section {
-    CGSize size = [self.addressHeaderView sizeThatFits:CGSizeMake(self.view.bounds.size.width, CGFLOAT_MAX)];
-    return size.height;
+    STPSectionHeaderView *headerView = self.addressHeaderView;
+    CGFloat width = self.view.bounds.size.width;
+    return [self cachedHeightForContentKey:headerView.heightCacheKey width:width computation:^CGFloat{
+        return [headerView sizeThatFits:CGSizeMake(width, CGFLOAT_MAX)].height;
+    }];
 }
 
 - (UIView *)tableView:(__unused UITableView *)tableView viewForHeaderInSection:(__unused NSInteger)section {
@@ -14,7 +14,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface STPShippingMethodTableViewCell : UITableViewCell
 @property(nonatomic)STPTheme *theme;
-- (void)setShippingMethod:(PKShippingMethod *)method currency:(NSString *)currency;
+/**
+ Shows `method` with an amount already formatted by
+ `amountStringForShippingMethod:currency:`.
+ */
+- (void)setShippingMethod:(PKShippingMethod *)method amountString:(NSString *)amountString;
+
+/**
+ The amount shown for `method`, e.g. "$5.99" or "Free", formatted with a
+ formatter shared by everything using the same currency and language.
+ */
++ (NSString *)amountStringForShippingMethod:(PKShippingMethod *)method currency:(NSString *)currency;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -11,6 +11,7 @@
 #import "NSDecimalNumber+Stripe_Currency.h"
 #import "STPImageLibrary+Private.h"
 #import "STPLocalizationUtils.h"
+#import "STPTheme+Private.h"
 
 @interface STPShippingMethodTableViewCell ()
 @property(nonatomic, weak) UILabel *titleLabel;
@@ -18,7 +19,7 @@
 @property(nonatomic, weak) UILabel *amountLabel;
 @property(nonatomic, weak) UIImageView *checkmarkIcon;
 @property(nonatomic)PKShippingMethod *shippingMethod;
-@property(nonatomic) NSNumberFormatter *numberFormatter;
+@property(nonatomic)NSUInteger appliedThemeChangeToken;
 @end
 
 @implementation STPShippingMethodTableViewCell
@@ -35,10 +36,6 @@
         _amountLabel = amountLabel;
         UIImageView *checkmarkIcon = [[UIImageView alloc] initWithImage:[STPImageLibrary checkmarkIcon]];
         _checkmarkIcon = checkmarkIcon;
-        NSNumberFormatter *formatter = [[NSNumberFormatter alloc] init];
-        formatter.numberStyle = NSNumberFormatterCurrencyStyle;
-        formatter.usesGroupingSeparator = YES;
-        _numberFormatter = formatter;
         [self.contentView addSubview:titleLabel];
         [self.contentView addSubview:subtitleLabel];
         [self.contentView addSubview:amountLabel];
@@ -49,28 +46,50 @@
 }
 
 - (void)setTheme:(STPTheme *)theme {
+    if (theme == _theme && theme.changeToken == self.appliedThemeChangeToken) {
+        return;
+    }
     _theme = theme;
+    self.appliedThemeChangeToken = theme.changeToken;
     [self updateAppearance];
 }
 
-- (void)setShippingMethod:(PKShippingMethod *)method currency:(NSString *)currency {
-    _shippingMethod = method;
-    self.titleLabel.text = method.label;
-    self.subtitleLabel.text = method.detail;
-    NSMutableDictionary<NSString *,NSString *>*localeInfo = [@{NSLocaleCurrencyCode: currency} mutableCopy];
-    localeInfo[NSLocaleLanguageCode] = [[NSLocale preferredLanguages] firstObject];
-    NSString *localeID = [NSLocale localeIdentifierFromComponents:localeInfo];
-    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:localeID];
-    self.numberFormatter.locale = locale;
++ (NSNumberFormatter *)currencyFormatterForLocaleIdentifier:(NSString *)localeID {
+    static NSCache<NSString *, NSNumberFormatter *> *formatters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        formatters = [NSCache new];
+        formatters.name = @"com.stripe.shippingMethodFormatters";
+    });
+    NSNumberFormatter *formatter = [formatters objectForKey:localeID];
+    if (!formatter) {
+        formatter = [[NSNumberFormatter alloc] init];
+        formatter.numberStyle = NSNumberFormatterCurrencyStyle;
+        formatter.usesGroupingSeparator = YES;
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:localeID];
+        [formatters setObject:formatter forKey:localeID];
+    }
+    return formatter;
+}
+
++ (NSString *)amountStringForShippingMethod:(PKShippingMethod *)method currency:(NSString *)currency {
     NSInteger amount = [method.amount stp_amountWithCurrency:currency];
     if (amount == 0) {
-        self.amountLabel.text = STPLocalizedString(@"Free", @"Label for free shipping method");
-    }
-    else {
-        NSDecimalNumber *number = [NSDecimalNumber stp_decimalNumberWithAmount:amount
-                                                                      currency:currency];
-        self.amountLabel.text = [self.numberFormatter stringFromNumber:number];
+        return STPLocalizedString(@"Free", @"Label for free shipping method");
     }
+    NSMutableDictionary<NSString *,NSString *>*localeInfo = [@{NSLocaleCurrencyCode: currency} mutableCopy];
+    localeInfo[NSLocaleLanguageCode] = [[NSLocale preferredLanguages] firstObject];
+    NSString *localeID = [NSLocale localeIdentifierFromComponents:localeInfo];
+    NSDecimalNumber *number = [NSDecimalNumber stp_decimalNumberWithAmount:amount
+                                                                  currency:currency];
+    return [[self currencyFormatterForLocaleIdentifier:localeID] stringFromNumber:number];
+}
+
+- (void)setShippingMethod:(PKShippingMethod *)method amountString:(NSString *)amountString {
+    _shippingMethod = method;
+    self.titleLabel.text = method.label;
+    self.subtitleLabel.text = method.detail;
+    self.amountLabel.text = amountString;
     [self setNeedsLayout];
 }
 
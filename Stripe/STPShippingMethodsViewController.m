@@ -25,6 +25,8 @@ static NSString *const STPShippingMethodCellReuseIdentifier = @"STPShippingMetho
 @property(nonatomic)NSArray<PKShippingMethod *>*shippingMethods;
 @property(nonatomic)PKShippingMethod *selectedShippingMethod;
 @property(nonatomic)NSString *currency;
+// Formatted up front, so scrolling a long list doesn't format amounts
+@property(nonatomic)NSArray<NSString *> *amountStrings;
 @property(nonatomic, weak)UIImageView *imageView;
 @property(nonatomic)UIBarButtonItem *doneItem;
 @end
@@ -46,6 +48,11 @@ static NSString *const STPShippingMethodCellReuseIdentifier = @"STPShippingMetho
         }
 
         _currency = currency;
+        NSMutableArray<NSString *> *amountStrings = [NSMutableArray arrayWithCapacity:methods.count];
+        for (PKShippingMethod *method in methods) {
+            [amountStrings addObject:[STPShippingMethodTableViewCell amountStringForShippingMethod:method currency:currency] ?: @""];
+        }
+        _amountStrings = amountStrings;
         self.title = STPLocalizedString(@"Shipping", @"Title for shipping info form");
     }
     return self;
@@ -103,7 +110,7 @@ static NSString *const STPShippingMethodCellReuseIdentifier = @"STPShippingMetho
     STPShippingMethodTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:STPShippingMethodCellReuseIdentifier forIndexPath:indexPath];
     PKShippingMethod *method = [self.shippingMethods stp_boundSafeObjectAtIndex:indexPath.row];
     cell.theme = self.theme;
-    [cell setShippingMethod:method currency:self.currency];
+    [cell setShippingMethod:method amountString:[self.amountStrings stp_boundSafeObjectAtIndex:indexPath.row]];
     cell.selected = [method.identifier isEqualToString:self.selectedShippingMethod.identifier];
     return cell;
 }
@@ -111,11 +118,11 @@ static NSString *const STPShippingMethodCellReuseIdentifier = @"STPShippingMetho
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
     BOOL topRow = (indexPath.row == 0);
     BOOL bottomRow = ([self tableView:tableView numberOfRowsInSection:indexPath.section] - 1 == indexPath.row);
-    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor];
-    [cell stp_setTopBorderHidden:!topRow];
-    [cell stp_setBottomBorderHidden:!bottomRow];
-    [cell stp_setFakeSeparatorColor:self.theme.quaternaryBackgroundColor];
-    [cell stp_setFakeSeparatorLeftInset:15.0f];
+    [cell stp_setBorderColor:self.theme.tertiaryBackgroundColor
+          fakeSeparatorColor:self.theme.quaternaryBackgroundColor
+      fakeSeparatorLeftInset:15.0f
+             topBorderHidden:!topRow
+          bottomBorderHidden:!bottomRow];
 }
 
 - (CGFloat)tableView:(__unused UITableView *)tableView heightForRowAtIndexPath:(__unused NSIndexPath *)indexPath {
@@ -0,0 +1,60 @@
+//
+//  STPSignpost.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+ * Signpost intervals and events for Instruments, under the
+ * "com.stripe.sdk" subsystem. Names must be string literals. Intervals are
+ * matched up by the object passed to begin and end, which must not be nil.
+ *
+ * Define STP_SIGNPOSTS_ENABLED=0 to compile them out. They are always
+ * compiled out when building against an SDK older than iOS 12, and do
+ * nothing when running on one.
+ */
+
+#ifndef STP_SIGNPOSTS_ENABLED
+#define STP_SIGNPOSTS_ENABLED (__IPHONE_OS_VERSION_MAX_ALLOWED >= 120000)
+#endif
+
+#if STP_SIGNPOSTS_ENABLED
+
+#import <os/signpost.h>
+
+os_log_t STPSignpostLog(void) API_AVAILABLE(ios(12.0));
+
+#define STPSignpostIntervalBegin(name, object) \
+do { \
+    if (@available(iOS 12.0, *)) { \
+        os_log_t stp_signpostLog = STPSignpostLog(); \
+        os_signpost_interval_begin(stp_signpostLog, os_signpost_id_make_with_pointer(stp_signpostLog, (__bridge const void *)(object)), name); \
+    } \
+} while (0)
+
+#define STPSignpostIntervalEnd(name, object) \
+do { \
+    if (@available(iOS 12.0, *)) { \
+        os_log_t stp_signpostLog = STPSignpostLog(); \
+        os_signpost_interval_end(stp_signpostLog, os_signpost_id_make_with_pointer(stp_signpostLog, (__bridge const void *)(object)), name); \
+    } \
+} while (0)
+
+#define STPSignpostEvent(name, ...) \
+do { \
+    if (@available(iOS 12.0, *)) { \
+        os_signpost_event_emit(STPSignpostLog(), OS_SIGNPOST_ID_EXCLUSIVE, name, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+#else
+
+#define STPSignpostIntervalBegin(name, object) do { (void)(object); } while (0)
+#define STPSignpostIntervalEnd(name, object) do { (void)(object); } while (0)
+#define STPSignpostEvent(name, ...) do {} while (0)
+
+#endif
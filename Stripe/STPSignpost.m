@@ -0,0 +1,22 @@
+//
+//  STPSignpost.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSignpost.h"
+
+#if STP_SIGNPOSTS_ENABLED
+
+os_log_t STPSignpostLog(void) {
+    static os_log_t log;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        log = os_log_create("com.stripe.sdk", OS_LOG_CATEGORY_POINTS_OF_INTEREST);
+    });
+    return log;
+}
+
+#endif
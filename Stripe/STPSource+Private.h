@@ -6,12 +6,29 @@
 //  Copyright © 2017 Stripe, Inc. All rights reserved.
 //
 
+#import "STPAPIRequest.h"
 #import "STPSource.h"
 
-@interface STPSource (Private)
+@interface STPSource (Private) <STPAPIResponseUpdatable>
 + (NSString *)stringFromType:(STPSourceType)type;
 + (NSString *)stringFromFlow:(STPSourceFlow)flow;
 + (NSString *)stringFromUsage:(STPSourceUsage)usage;
+
+/**
+ Decodes `response` as a newer version of this source. Sub-objects like
+ `owner` and `redirect` whose fields haven't changed are shared with this
+ source rather than decoded again, and if nothing has changed at all, this
+ source itself is returned.
+ */
+- (STPSource *)updatedObjectFromAPIResponse:(NSDictionary *)response;
+
+/**
+ Whether `source` has exactly the same fields as this one, unlike
+ `isEqualToSource:`, which only compares identifiers. The fields that change
+ as a source progresses are compared first, so sources that differ are
+ usually told apart without comparing their whole responses.
+ */
+- (BOOL)hasSameFieldsAsSource:(STPSource *)source;
 @end
 
 
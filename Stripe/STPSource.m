@@ -8,6 +8,7 @@
 
 #import "NSDictionary+Stripe.h"
 #import "STPSource.h"
+#import "STPSource+Private.h"
 #import "STPSourceOwner.h"
 #import "STPSourceReceiver.h"
 #import "STPSourceRedirect.h"
@@ -37,24 +38,32 @@
 
 @end
 
-@implementation STPSource
+@implementation STPSource {
+    // Sources are compared by identifier, which is only set while decoding,
+    // so the hash is worked out once then.
+    NSUInteger _hash;
+}
 
 + (NSDictionary<NSString *,NSNumber *>*)stringToType {
-    return @{
-             @"bancontact": @(STPSourceTypeBancontact),
-             @"bitcoin": @(STPSourceTypeBitcoin),
-             @"card": @(STPSourceTypeCard),
-             @"giropay": @(STPSourceTypeGiropay),
-             @"ideal": @(STPSourceTypeIDEAL),
-             @"sepa_debit": @(STPSourceTypeSEPADebit),
-             @"sofort": @(STPSourceTypeSofort),
-             @"three_d_secure": @(STPSourceTypeThreeDSecure)
-             };
+    static NSDictionary<NSString *,NSNumber *> *table;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        table = @{
+                  @"bancontact": @(STPSourceTypeBancontact),
+                  @"bitcoin": @(STPSourceTypeBitcoin),
+                  @"card": @(STPSourceTypeCard),
+                  @"giropay": @(STPSourceTypeGiropay),
+                  @"ideal": @(STPSourceTypeIDEAL),
+                  @"sepa_debit": @(STPSourceTypeSEPADebit),
+                  @"sofort": @(STPSourceTypeSofort),
+                  @"three_d_secure": @(STPSourceTypeThreeDSecure)
+                  };
+    });
+    return table;
 }
 
 + (STPSourceType)typeFromString:(NSString *)string {
-    NSString *key = [string lowercaseString];
-    NSNumber *value = [self stringToType][key];
+    NSNumber *value = [[self stringToType] stp_objectForLowercaseKeyMatchingString:string];
     if (value) {
         return (STPSourceType)[value integerValue];
     } else {
@@ -67,17 +76,21 @@
 }
 
 + (NSDictionary<NSString *,NSNumber *>*)stringToFlow {
-    return @{
-             @"redirect": @(STPSourceFlowRedirect),
-             @"receiver": @(STPSourceFlowReceiver),
-             @"code_verification": @(STPSourceFlowCodeVerification),
-             @"none": @(STPSourceFlowNone)
-             };
+    static NSDictionary<NSString *,NSNumber *> *table;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        table = @{
+                  @"redirect": @(STPSourceFlowRedirect),
+                  @"receiver": @(STPSourceFlowReceiver),
+                  @"code_verification": @(STPSourceFlowCodeVerification),
+                  @"none": @(STPSourceFlowNone)
+                  };
+    });
+    return table;
 }
 
 + (STPSourceFlow)flowFromString:(NSString *)string {
-    NSString *key = [string lowercaseString];
-    NSNumber *value = [self stringToFlow][key];
+    NSNumber *value = [[self stringToFlow] stp_objectForLowercaseKeyMatchingString:string];
     if (value) {
         return (STPSourceFlow)[value integerValue];
     } else {
@@ -90,32 +103,35 @@
 }
 
 + (STPSourceStatus)statusFromString:(NSString *)string {
-    NSString *status = [string lowercaseString];
-    if ([status isEqualToString:@"pending"]) {
-        return STPSourceStatusPending;
-    } else if ([status isEqualToString:@"chargeable"]) {
-        return STPSourceStatusChargeable;
-    } else if ([status isEqualToString:@"consumed"]) {
-        return STPSourceStatusConsumed;
-    } else if ([status isEqualToString:@"canceled"]) {
-        return STPSourceStatusCanceled;
-    } else if ([status isEqualToString:@"failed"]) {
-        return STPSourceStatusFailed;
-    } else {
-        return STPSourceStatusUnknown;
-    }
+    static NSDictionary<NSString *,NSNumber *> *stringToStatus;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToStatus = @{
+                           @"pending": @(STPSourceStatusPending),
+                           @"chargeable": @(STPSourceStatusChargeable),
+                           @"consumed": @(STPSourceStatusConsumed),
+                           @"canceled": @(STPSourceStatusCanceled),
+                           @"failed": @(STPSourceStatusFailed),
+                           };
+    });
+    NSNumber *value = [stringToStatus stp_objectForLowercaseKeyMatchingString:string];
+    return value ? (STPSourceStatus)[value integerValue] : STPSourceStatusUnknown;
 }
 
 + (NSDictionary<NSString *,NSNumber *>*)stringToUsage {
-    return @{
-             @"reusable": @(STPSourceUsageReusable),
-             @"single_use": @(STPSourceUsageSingleUse)
-             };
+    static NSDictionary<NSString *,NSNumber *> *table;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        table = @{
+                  @"reusable": @(STPSourceUsageReusable),
+                  @"single_use": @(STPSourceUsageSingleUse)
+                  };
+    });
+    return table;
 }
 
 + (STPSourceUsage)usageFromString:(NSString *)string {
-    NSString *key = [string lowercaseString];
-    NSNumber *value = [self stringToUsage][key];
+    NSNumber *value = [[self stringToUsage] stp_objectForLowercaseKeyMatchingString:string];
     if (value) {
         return (STPSourceUsage)[value integerValue];
     } else {
@@ -134,7 +150,12 @@
 }
 
 - (NSUInteger)hash {
-    return [self.stripeID hash];
+    return _hash;
+}
+
+- (void)setStripeID:(NSString *)stripeID {
+    _stripeID = stripeID;
+    _hash = [stripeID hash];
 }
 
 - (BOOL)isEqualToSource:(STPSource *)source {
@@ -146,21 +167,68 @@
         return NO;
     }
 
+    if (_hash != source->_hash) {
+        return NO;
+    }
     return [self.stripeID isEqualToString:source.stripeID];
 }
 
+- (BOOL)hasSameFieldsAsSource:(STPSource *)source {
+    if (self == source) {
+        return YES;
+    }
+    if (![self isEqualToSource:source]) {
+        return NO;
+    }
+    if (self.status != source.status
+        || self.redirect.status != source.redirect.status
+        || self.verification.status != source.verification.status) {
+        return NO;
+    }
+    return self.allResponseFields == source.allResponseFields || [self.allResponseFields isEqualToDictionary:source.allResponseFields];
+}
+
 #pragma mark STPAPIResponseDecodable
 
 + (NSArray *)requiredFields {
     return @[@"id", @"livemode", @"status", @"type"];
 }
 
+// Whether `key` is the same in both responses, so whatever was decoded from
+// it before can be kept.
+static BOOL STPSourceFieldUnchanged(NSDictionary *fields, NSDictionary *previousFields, NSString *key) {
+    if (!previousFields) {
+        return NO;
+    }
+    id value = fields[key];
+    id previousValue = previousFields[key];
+    return value == previousValue || [value isEqual:previousValue];
+}
+
 + (instancetype)decodedObjectFromAPIResponse:(NSDictionary *)response {
+    return [self decodedObjectFromAPIResponse:response previousSource:nil];
+}
+
+- (STPSource *)updatedObjectFromAPIResponse:(NSDictionary *)response {
+    return [[self class] decodedObjectFromAPIResponse:response previousSource:self];
+}
+
++ (instancetype)decodedObjectFromAPIResponse:(NSDictionary *)response previousSource:(STPSource *)previousSource {
     NSDictionary *dict = [response stp_dictionaryByRemovingNullsValidatingRequiredFields:[self requiredFields]];
     if (!dict) {
         return nil;
     }
 
+    NSDictionary *previousFields;
+    if (previousSource.allResponseFields && [previousSource.stripeID isEqualToString:dict[@"id"]]) {
+        previousFields = previousSource.allResponseFields;
+        // Usually only the status moves, and then nothing else can be shared
+        // wholesale, so that's checked before comparing everything.
+        if (STPSourceFieldUnchanged(dict, previousFields, @"status") && [dict isEqualToDictionary:previousFields]) {
+            return previousSource;
+        }
+    }
+
     STPSource *source = [self new];
     source.stripeID = dict[@"id"];
     source.amount = dict[@"amount"];
@@ -169,23 +237,30 @@
     source.currency = dict[@"currency"];
     source.flow = [[self class] flowFromString:dict[@"flow"]];
     source.livemode = [dict[@"livemode"] boolValue];
-    source.metadata = dict[@"metadata"];
-    source.owner = [STPSourceOwner decodedObjectFromAPIResponse:dict[@"owner"]];
-    source.receiver = [STPSourceReceiver decodedObjectFromAPIResponse:dict[@"receiver"]];
-    source.redirect = [STPSourceRedirect decodedObjectFromAPIResponse:dict[@"redirect"]];
+    source.metadata = STPSourceFieldUnchanged(dict, previousFields, @"metadata") ? previousSource.metadata : dict[@"metadata"];
+    source.owner = STPSourceFieldUnchanged(dict, previousFields, @"owner") ? previousSource.owner : [STPSourceOwner decodedObjectFromAPIResponse:dict[@"owner"]];
+    source.receiver = STPSourceFieldUnchanged(dict, previousFields, @"receiver") ? previousSource.receiver : [STPSourceReceiver decodedObjectFromAPIResponse:dict[@"receiver"]];
+    source.redirect = STPSourceFieldUnchanged(dict, previousFields, @"redirect") ? previousSource.redirect : [STPSourceRedirect decodedObjectFromAPIResponse:dict[@"redirect"]];
     source.status = [[self class] statusFromString:dict[@"status"]];
     NSString *typeString = dict[@"type"];
     source.type = [[self class] typeFromString:typeString];
     source.usage = [[self class] usageFromString:dict[@"usage"]];
-    source.verification = [STPSourceVerification decodedObjectFromAPIResponse:dict[@"verification"]];
-    source.details = dict[typeString];
+    source.verification = STPSourceFieldUnchanged(dict, previousFields, @"verification") ? previousSource.verification : [STPSourceVerification decodedObjectFromAPIResponse:dict[@"verification"]];
     source.allResponseFields = dict;
 
-    if (source.type == STPSourceTypeCard) {
-        source.cardDetails = [STPSourceCardDetails decodedObjectFromAPIResponse:source.details];
-    }
-    else if (source.type == STPSourceTypeSEPADebit) {
-        source.sepaDebitDetails = [STPSourceSEPADebitDetails decodedObjectFromAPIResponse:source.details];
+    // The type is part of the response, so matching details are for the same type
+    if (STPSourceFieldUnchanged(dict, previousFields, @"type") && STPSourceFieldUnchanged(dict, previousFields, typeString)) {
+        source.details = previousSource.details;
+        source.cardDetails = previousSource.cardDetails;
+        source.sepaDebitDetails = previousSource.sepaDebitDetails;
+    } else {
+        source.details = dict[typeString];
+        if (source.type == STPSourceTypeCard) {
+            source.cardDetails = [STPSourceCardDetails decodedObjectFromAPIResponse:source.details];
+        }
+        else if (source.type == STPSourceTypeSEPADebit) {
+            source.sepaDebitDetails = [STPSourceSEPADebitDetails decodedObjectFromAPIResponse:source.details];
+        }
     }
 
     return source;
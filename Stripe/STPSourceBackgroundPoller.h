@@ -0,0 +1,107 @@
+//
+//  STPSourceBackgroundPoller.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class STPAPIClient;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Keeps checking on pending sources after the app leaves the foreground, with a
+ discretionary background URL session, so the system can run the checks while
+ the app is suspended and wake or relaunch it with the result. The sources
+ being checked and the results that haven't been delivered are saved to disk,
+ so a relaunched app picks up where it left off.
+
+ Results are handed to the client with `deliverBackgroundPolledSource:`, which
+ finishes the poll still running in the app, or tells the client's
+ `backgroundPollingDelegate`. Only used on the main thread.
+ */
+NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions")
+@interface STPSourceBackgroundPoller : NSObject
+
+/**
+ The poller for `publishableKey`, shared by every client using that key since
+ the system allows one session per identifier.
+ */
++ (instancetype)pollerForPublishableKey:(NSString *)publishableKey;
+
+/**
+ @param sessionIdentifier The identifier of the background session to create
+ or reconnect to.
+ @param fileURL Where to save the sources being checked and their results.
+ */
+- (instancetype)initWithSessionIdentifier:(NSString *)sessionIdentifier
+                                  fileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The client results are delivered to. Held weakly; results are kept on disk
+ while it's nil.
+ */
+@property (nonatomic, weak, nullable) STPAPIClient *apiClient;
+
+/**
+ Delivers any results that arrived while there was no client to take them,
+ e.g. while the app was relaunched in the background.
+ */
+- (void)start;
+
+/**
+ Checks the source fetched by `request` in the background until it leaves
+ the pending state, or `deadline` passes. Replaces any checks already
+ scheduled for `identifier`.
+ */
+- (void)startPollingSourceWithId:(NSString *)identifier
+                         request:(NSURLRequest *)request
+                        deadline:(NSDate *)deadline;
+
+/**
+ Cancels the background checks for a source, e.g. because the app is back in
+ the foreground and polling it itself.
+ */
+- (void)stopPollingSourceWithId:(NSString *)identifier;
+
+/**
+ Records the source fetched by a background check as final, and delivers it.
+ */
+- (void)finishSourceWithId:(NSString *)identifier JSON:(NSDictionary *)json;
+
+/**
+ The identifiers of the sources being checked in the background.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *pendingSourceIdentifiers;
+
+/**
+ The identifiers of the sources whose results haven't been delivered yet.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *undeliveredSourceIdentifiers;
+
+/**
+ The background session identifier used for `publishableKey`.
+ */
++ (NSString *)sessionIdentifierForPublishableKey:(NSString *)publishableKey;
+
+/**
+ Where sources polled for `publishableKey` are saved by default. Results
+ hold customer details, so they're kept out of backups and encrypted until
+ the device is first unlocked.
+ */
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey;
+
+/**
+ See `+[Stripe handleEventsForBackgroundURLSession:completionHandler:]`.
+ */
++ (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier
+                          completionHandler:(void (^)(void))completionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
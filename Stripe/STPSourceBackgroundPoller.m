@@ -0,0 +1,318 @@
+//
+//  STPSourceBackgroundPoller.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourceBackgroundPoller.h"
+
+#import "STPAPIClient+Private.h"
+#import "STPAPIClient.h"
+#import "STPSignpost.h"
+#import "STPSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static NSString *const SessionIdentifierPrefix = @"com.stripe.sourcepolling.";
+// The earliest the system is asked to run the next check of a pending
+// source. It may well run later; the checks are discretionary.
+static NSTimeInterval const BackgroundPollInterval = 30;
+// A source is a few KB, which helps the system decide when to run a check
+static int64_t const ExpectedResponseBytes = 4096;
+
+static NSString *const PendingKey = @"pending";
+static NSString *const FinishedKey = @"finished";
+
+@interface STPSourceBackgroundPoller () <NSURLSessionDownloadDelegate>
+
+@property (nonatomic, copy) NSString *sessionIdentifier;
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) NSURLSession *session;
+// When to give up on each source being checked, in seconds since 1970, by
+// source ID
+@property (nonatomic) NSMutableDictionary<NSString *, NSNumber *> *deadlines;
+// The final JSON of sources that haven't been delivered, by source ID
+@property (nonatomic) NSMutableDictionary<NSString *, NSDictionary *> *finishedSources;
+
+@end
+
+// Both only used on the main thread
+static NSMutableDictionary<NSString *, STPSourceBackgroundPoller *> *STPSharedBackgroundPollers(void) {
+    static NSMutableDictionary *pollers;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pollers = [NSMutableDictionary dictionary];
+    });
+    return pollers;
+}
+
+static NSMutableDictionary<NSString *, void (^)(void)> *STPBackgroundSessionCompletionHandlers(void) {
+    static NSMutableDictionary *completionHandlers;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        completionHandlers = [NSMutableDictionary dictionary];
+    });
+    return completionHandlers;
+}
+
+@implementation STPSourceBackgroundPoller
+
++ (instancetype)pollerForPublishableKey:(NSString *)publishableKey {
+    NSString *sessionIdentifier = [self sessionIdentifierForPublishableKey:publishableKey];
+    NSMutableDictionary<NSString *, STPSourceBackgroundPoller *> *pollers = STPSharedBackgroundPollers();
+    STPSourceBackgroundPoller *poller = pollers[sessionIdentifier];
+    if (!poller) {
+        poller = [[self alloc] initWithSessionIdentifier:sessionIdentifier
+                                                 fileURL:[self defaultFileURLForPublishableKey:publishableKey]];
+        pollers[sessionIdentifier] = poller;
+    }
+    return poller;
+}
+
++ (NSString *)sessionIdentifierForPublishableKey:(NSString *)publishableKey {
+    return [SessionIdentifierPrefix stringByAppendingString:publishableKey];
+}
+
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey {
+    NSURL *supportURL = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] firstObject];
+    NSURL *directoryURL = [supportURL URLByAppendingPathComponent:@"com.stripe.sourcepolling" isDirectory:YES];
+    return [directoryURL URLByAppendingPathComponent:[publishableKey stringByAppendingPathExtension:@"json"]];
+}
+
++ (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier
+                          completionHandler:(void (^)(void))completionHandler {
+    if (![identifier hasPrefix:SessionIdentifierPrefix] || identifier.length == SessionIdentifierPrefix.length) {
+        return NO;
+    }
+    STPBackgroundSessionCompletionHandlers()[identifier] = [completionHandler copy];
+    // Reconnecting to the session is what gets its events delivered, so a
+    // relaunched app doesn't have to wait for a client to be set up.
+    [self pollerForPublishableKey:[identifier substringFromIndex:SessionIdentifierPrefix.length]];
+    return YES;
+}
+
+- (instancetype)initWithSessionIdentifier:(NSString *)sessionIdentifier
+                                  fileURL:(NSURL *)fileURL {
+    self = [super init];
+    if (self) {
+        _sessionIdentifier = [sessionIdentifier copy];
+        _fileURL = fileURL;
+        _deadlines = [NSMutableDictionary dictionary];
+        _finishedSources = [NSMutableDictionary dictionary];
+        [self loadEntries];
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:sessionIdentifier];
+        configuration.discretionary = YES;
+        configuration.sessionSendsLaunchEvents = YES;
+        configuration.HTTPAdditionalHeaders = [STPAPIClient sharedAdditionalHeaders];
+        _session = [NSURLSession sessionWithConfiguration:configuration
+                                                 delegate:self
+                                            delegateQueue:[NSOperationQueue mainQueue]];
+    }
+    return self;
+}
+
+- (NSArray<NSString *> *)pendingSourceIdentifiers {
+    return self.deadlines.allKeys;
+}
+
+- (NSArray<NSString *> *)undeliveredSourceIdentifiers {
+    return self.finishedSources.allKeys;
+}
+
+- (void)start {
+    [self deliverFinishedSources];
+}
+
+#pragma mark - Polling
+
+- (void)startPollingSourceWithId:(NSString *)identifier
+                         request:(NSURLRequest *)request
+                        deadline:(NSDate *)deadline {
+    [self cancelTasksForSourceWithId:identifier];
+    self.deadlines[identifier] = @([deadline timeIntervalSince1970]);
+    [self saveEntries];
+    [self scheduleCheckWithRequest:request identifier:identifier delay:0];
+}
+
+- (void)stopPollingSourceWithId:(NSString *)identifier {
+    if (!self.deadlines[identifier]) {
+        return;
+    }
+    [self.deadlines removeObjectForKey:identifier];
+    [self saveEntries];
+    [self cancelTasksForSourceWithId:identifier];
+}
+
+- (void)cancelTasksForSourceWithId:(NSString *)identifier {
+    [self.session getTasksWithCompletionHandler:^(__unused NSArray *dataTasks, __unused NSArray *uploadTasks, NSArray *downloadTasks) {
+        for (NSURLSessionDownloadTask *task in downloadTasks) {
+            if ([task.taskDescription isEqualToString:identifier]) {
+                [task cancel];
+            }
+        }
+    }];
+}
+
+- (void)scheduleCheckWithRequest:(NSURLRequest *)request
+                      identifier:(NSString *)identifier
+                           delay:(NSTimeInterval)delay {
+    NSURLSessionDownloadTask *task = [self.session downloadTaskWithRequest:request];
+    task.taskDescription = identifier;
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+    if (@available(iOS 11.0, *)) {
+        if (delay > 0) {
+            task.earliestBeginDate = [NSDate dateWithTimeIntervalSinceNow:delay];
+        }
+        task.countOfBytesClientExpectsToSend = 0;
+        task.countOfBytesClientExpectsToReceive = ExpectedResponseBytes;
+    }
+#endif
+    STPSignpostEvent("Background source check", "%lu", (unsigned long)self.deadlines.count);
+    [task resume];
+}
+
+- (BOOL)isPastDeadlineForSourceWithId:(NSString *)identifier {
+    return [[NSDate date] timeIntervalSince1970] >= self.deadlines[identifier].doubleValue;
+}
+
+- (void)finishSourceWithId:(NSString *)identifier JSON:(NSDictionary *)json {
+    [self.deadlines removeObjectForKey:identifier];
+    self.finishedSources[identifier] = json;
+    [self saveEntries];
+    [self deliverFinishedSources];
+}
+
+- (void)deliverFinishedSources {
+    STPAPIClient *apiClient = self.apiClient;
+    if (!apiClient || self.finishedSources.count == 0) {
+        return;
+    }
+    BOOL delivered = NO;
+    for (NSString *identifier in self.finishedSources.allKeys) {
+        STPSource *source = [STPSource decodedObjectFromAPIResponse:self.finishedSources[identifier]];
+        if (!source || [apiClient deliverBackgroundPolledSource:source]) {
+            [self.finishedSources removeObjectForKey:identifier];
+            delivered = YES;
+        }
+    }
+    if (delivered) {
+        [self saveEntries];
+    }
+}
+
+#pragma mark - NSURLSessionDownloadDelegate
+
+- (void)URLSession:(__unused NSURLSession *)session
+      downloadTask:(NSURLSessionDownloadTask *)downloadTask
+didFinishDownloadingToURL:(NSURL *)location {
+    NSString *identifier = downloadTask.taskDescription;
+    if (!identifier || !self.deadlines[identifier]) {
+        return;
+    }
+    // The file is deleted as soon as this returns, so it's read right away
+    NSData *data = [NSData dataWithContentsOfURL:location];
+    id json = data ? [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:NULL] : nil;
+    NSInteger statusCode = [downloadTask.response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)downloadTask.response).statusCode : 0;
+    STPSource *source = (statusCode == 200 && [json isKindOfClass:[NSDictionary class]]) ? [STPSource decodedObjectFromAPIResponse:json] : nil;
+    BOOL pastDeadline = [self isPastDeadlineForSourceWithId:identifier];
+    if (source && (source.status != STPSourceStatusPending || pastDeadline)) {
+        [self finishSourceWithId:identifier JSON:json];
+    } else if ((statusCode >= 400 && statusCode < 500) || pastDeadline) {
+        // Don't retry requests that 4xx. The poll in the app reports the
+        // error when it's back in the foreground.
+        [self stopPollingSourceWithId:identifier];
+    } else {
+        [self scheduleCheckWithRequest:downloadTask.originalRequest
+                            identifier:identifier
+                                 delay:BackgroundPollInterval];
+    }
+}
+
+- (void)URLSession:(__unused NSURLSession *)session
+              task:(NSURLSessionTask *)task
+didCompleteWithError:(nullable NSError *)error {
+    NSString *identifier = task.taskDescription;
+    // Finished downloads were handled above, and cancelled ones were
+    // replaced or stopped on purpose.
+    if (!error || error.code == NSURLErrorCancelled || !identifier || !self.deadlines[identifier]) {
+        return;
+    }
+    if ([self isPastDeadlineForSourceWithId:identifier] || !task.originalRequest) {
+        [self stopPollingSourceWithId:identifier];
+    } else {
+        [self scheduleCheckWithRequest:task.originalRequest
+                            identifier:identifier
+                                 delay:BackgroundPollInterval];
+    }
+}
+
+- (void)URLSessionDidFinishEventsForBackgroundURLSession:(__unused NSURLSession *)session {
+    NSMutableDictionary<NSString *, void (^)(void)> *completionHandlers = STPBackgroundSessionCompletionHandlers();
+    void (^completionHandler)(void) = completionHandlers[self.sessionIdentifier];
+    [completionHandlers removeObjectForKey:self.sessionIdentifier];
+    if (completionHandler) {
+        completionHandler();
+    }
+}
+
+#pragma mark - Persistence
+
+- (void)loadEntries {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    id entries = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:NULL];
+    if (![entries isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    id pending = entries[PendingKey];
+    if ([pending isKindOfClass:[NSDictionary class]]) {
+        for (id identifier in pending) {
+            if ([identifier isKindOfClass:[NSString class]] && [pending[identifier] isKindOfClass:[NSNumber class]]) {
+                self.deadlines[identifier] = pending[identifier];
+            }
+        }
+    }
+    id finished = entries[FinishedKey];
+    if ([finished isKindOfClass:[NSDictionary class]]) {
+        for (id identifier in finished) {
+            if ([identifier isKindOfClass:[NSString class]] && [finished[identifier] isKindOfClass:[NSDictionary class]]) {
+                self.finishedSources[identifier] = finished[identifier];
+            }
+        }
+    }
+}
+
+- (void)saveEntries {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (self.deadlines.count == 0 && self.finishedSources.count == 0) {
+        [fileManager removeItemAtURL:self.fileURL error:NULL];
+        return;
+    }
+    NSDictionary *entries = @{
+                              PendingKey: self.deadlines,
+                              FinishedKey: self.finishedSources,
+                              };
+    NSData *data = [NSJSONSerialization dataWithJSONObject:entries options:(NSJSONWritingOptions)kNilOptions error:NULL];
+    [fileManager createDirectoryAtURL:[self.fileURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:NULL];
+    if ([data writeToURL:self.fileURL options:(NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication) error:NULL]) {
+        [self.fileURL setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:NULL];
+    }
+}
+
+@end
+
+@implementation Stripe (STPBackgroundPollingAdditions)
+
++ (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier
+                          completionHandler:(void (^)(void))completionHandler {
+    return [STPSourceBackgroundPoller handleEventsForBackgroundURLSession:identifier
+                                                        completionHandler:completionHandler];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
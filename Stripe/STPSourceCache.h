@@ -0,0 +1,41 @@
+//
+//  STPSourceCache.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class STPSource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Recently created and retrieved sources, in memory and keyed by ID, so screens
+ fetching the same source within seconds of each other don't each go to the
+ network. Holds at most `capacity` sources, dropping the least recently used,
+ and each for `timeToLive` seconds. Safe to use from any thread.
+ */
+@interface STPSourceCache : NSObject
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity timeToLive:(NSTimeInterval)timeToLive;
+
+/**
+ The source with `identifier`, if it was added less than `timeToLive` seconds
+ ago and has `clientSecret`, so a source is only handed to callers that could
+ have retrieved it.
+ */
+- (nullable STPSource *)sourceWithId:(NSString *)identifier clientSecret:(NSString *)clientSecret;
+
+/**
+ Adds `source`, replacing any older copy.
+ */
+- (void)addSource:(STPSource *)source;
+
+- (void)removeAllSources;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,92 @@
+//
+//  STPSourceCache.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourceCache.h"
+
+#import "STPSource.h"
+
+@interface STPSourceCacheEntry : NSObject
+@property (nonatomic) STPSource *source;
+@property (nonatomic) CFAbsoluteTime addedTime;
+@end
+
+@implementation STPSourceCacheEntry
+@end
+
+@interface STPSourceCache ()
+@property (nonatomic) NSUInteger capacity;
+@property (nonatomic) NSTimeInterval timeToLive;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) NSMutableDictionary<NSString *, STPSourceCacheEntry *> *entries;
+// Identifiers in entries, least recently used first
+@property (nonatomic) NSMutableArray<NSString *> *order;
+@end
+
+@implementation STPSourceCache
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity timeToLive:(NSTimeInterval)timeToLive {
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _timeToLive = timeToLive;
+        _queue = dispatch_queue_create("com.stripe.sourcecache", DISPATCH_QUEUE_SERIAL);
+        _entries = [NSMutableDictionary dictionary];
+        _order = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (STPSource *)sourceWithId:(NSString *)identifier clientSecret:(NSString *)clientSecret {
+    __block STPSource *source;
+    dispatch_sync(self.queue, ^{
+        STPSourceCacheEntry *entry = self.entries[identifier];
+        if (!entry) {
+            return;
+        }
+        if (CFAbsoluteTimeGetCurrent() - entry.addedTime >= self.timeToLive) {
+            self.entries[identifier] = nil;
+            [self.order removeObject:identifier];
+            return;
+        }
+        if (![entry.source.clientSecret isEqualToString:clientSecret]) {
+            return;
+        }
+        [self.order removeObject:identifier];
+        [self.order addObject:identifier];
+        source = entry.source;
+    });
+    return source;
+}
+
+- (void)addSource:(STPSource *)source {
+    NSString *identifier = source.stripeID;
+    if (!identifier) {
+        return;
+    }
+    STPSourceCacheEntry *entry = [STPSourceCacheEntry new];
+    entry.source = source;
+    entry.addedTime = CFAbsoluteTimeGetCurrent();
+    dispatch_sync(self.queue, ^{
+        [self.order removeObject:identifier];
+        self.entries[identifier] = entry;
+        [self.order addObject:identifier];
+        while (self.order.count > self.capacity) {
+            self.entries[self.order.firstObject] = nil;
+            [self.order removeObjectAtIndex:0];
+        }
+    });
+}
+
+- (void)removeAllSources {
+    dispatch_sync(self.queue, ^{
+        [self.entries removeAllObjects];
+        [self.order removeAllObjects];
+    });
+}
+
+@end
@@ -33,8 +33,7 @@
     self = [super init];
     if (self) {
         _last4 = dict[@"last4"];
-        NSString *brand = [dict[@"brand"] lowercaseString];
-        _brand = [STPCard brandFromString:brand];
+        _brand = [STPCard brandFromString:dict[@"brand"]];
         NSString *funding = dict[@"funding"];
         _funding = [STPCard fundingFromString:funding];
         _country = dict[@"country"];
@@ -49,16 +48,17 @@
 }
 
 + (STPSourceCard3DSecureStatus)threeDSecureStatusFromString:(NSString *)string {
-    NSString *brand = [string lowercaseString];
-    if ([brand isEqualToString:@"required"]) {
-        return STPSourceCard3DSecureStatusRequired;
-    } else if ([brand isEqualToString:@"optional"]) {
-        return STPSourceCard3DSecureStatusOptional;
-    } else if ([brand isEqualToString:@"not_supported"]) {
-        return STPSourceCard3DSecureStatusNotSupported;
-    } else {
-        return STPSourceCard3DSecureStatusUnknown;
-    }
+    static NSDictionary<NSString *,NSNumber *> *stringToStatus;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToStatus = @{
+                           @"required": @(STPSourceCard3DSecureStatusRequired),
+                           @"optional": @(STPSourceCard3DSecureStatusOptional),
+                           @"not_supported": @(STPSourceCard3DSecureStatusNotSupported),
+                           };
+    });
+    NSNumber *value = [stringToStatus stp_objectForLowercaseKeyMatchingString:string];
+    return value ? (STPSourceCard3DSecureStatus)[value integerValue] : STPSourceCard3DSecureStatusUnknown;
 }
 
 @end
@@ -0,0 +1,70 @@
+//
+//  STPSourceCreationQueue.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class STPAPIClient;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Saves source creation requests to disk and sends them one at a time whenever
+ the Stripe API is reachable, so sources can be queued while offline. Each
+ request is replayed with the idempotency key it was queued with, so one that
+ reached Stripe before the connection dropped doesn't create a second source.
+ Results are reported to the client's `sourceQueueDelegate`, on its completion
+ queue.
+ */
+@interface STPSourceCreationQueue : NSObject
+
+/**
+ @param apiClient The client to send requests with. Held weakly; nothing is
+ sent while it's nil.
+ @param endpoint The endpoint to POST queued requests to.
+ @param fileURL Where to save queued requests.
+ */
+- (instancetype)initWithAPIClient:(nullable STPAPIClient *)apiClient
+                         endpoint:(NSString *)endpoint
+                          fileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Queues a POST of `formData`, returning an identifier for it that is also
+ used as its idempotency key.
+ */
+- (NSString *)enqueueFormData:(NSData *)formData;
+
+/**
+ Loads the requests saved by an earlier launch and starts watching
+ reachability, sending requests whenever the API can be reached. Enqueuing
+ starts the queue too; calling this again does nothing.
+ */
+- (void)start;
+
+/**
+ The identifiers of the requests that haven't been sent yet, oldest first.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *pendingIdentifiers;
+
+/**
+ Where queued requests for `publishableKey` are saved by default. They hold
+ customer details, so they're kept out of backups and encrypted until the
+ device is first unlocked.
+ */
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey;
+
+/**
+ Whether a request that failed with `response` and `error` should stay queued
+ to be tried again, as it never got a definitive answer from the server.
+ */
++ (BOOL)shouldKeepRequestWithResponse:(nullable NSHTTPURLResponse *)response error:(NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
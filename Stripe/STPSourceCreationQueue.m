@@ -0,0 +1,259 @@
+//
+//  STPSourceCreationQueue.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourceCreationQueue.h"
+
+#import <SystemConfiguration/SystemConfiguration.h>
+
+#import "STPAPIClient+Private.h"
+#import "STPAPIClient.h"
+#import "STPAPIRequest.h"
+#import "STPSource.h"
+
+// How long to wait before trying again after the API answered with a 5xx
+// while reachable; reachability changes don't help there.
+static NSTimeInterval const ServerErrorRetryInterval = 30;
+// A request can also fail without an answer while the API looks reachable,
+// e.g. after a timeout, and then no reachability change comes to send it
+// again. Those are retried on a backoff for a while, then left for the next
+// reachability change.
+static NSUInteger const NetworkErrorMaxRetries = 5;
+static NSTimeInterval const NetworkErrorRetryBaseDelay = 2;
+
+static NSString *const EntryIdentifierKey = @"id";
+static NSString *const EntryBodyKey = @"body";
+
+@interface STPSourceCreationQueue ()
+
+@property (nonatomic, weak) STPAPIClient *apiClient;
+@property (nonatomic, copy) NSString *endpoint;
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) NSMutableArray<NSDictionary<NSString *, NSString *> *> *entries;
+@property (nonatomic) SCNetworkReachabilityRef reachability;
+@property (nonatomic) BOOL started;
+@property (nonatomic) BOOL reachable;
+@property (nonatomic) BOOL sending;
+@property (nonatomic) BOOL waitingToRetry;
+// Network errors in a row since the last answer or reachability change
+@property (nonatomic) NSUInteger networkErrorCount;
+
+- (void)reachabilityDidChangeFlags:(SCNetworkReachabilityFlags)flags;
+
+@end
+
+static void STPSourceCreationQueueReachabilityCallback(__unused SCNetworkReachabilityRef target, SCNetworkReachabilityFlags flags, void *info) {
+    STPSourceCreationQueue *queue = (__bridge STPSourceCreationQueue *)info;
+    [queue reachabilityDidChangeFlags:flags];
+}
+
+@implementation STPSourceCreationQueue
+
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey {
+    NSURL *supportURL = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] firstObject];
+    NSURL *directoryURL = [supportURL URLByAppendingPathComponent:@"com.stripe.sourcequeue" isDirectory:YES];
+    return [directoryURL URLByAppendingPathComponent:[publishableKey stringByAppendingPathExtension:@"json"]];
+}
+
++ (NSTimeInterval)retryDelayAfterNetworkErrors:(NSUInteger)errorCount {
+    return MIN(ServerErrorRetryInterval, NetworkErrorRetryBaseDelay * pow(2, MAX(errorCount, 1U) - 1));
+}
+
++ (BOOL)shouldKeepRequestWithResponse:(NSHTTPURLResponse *)response error:(NSError *)error {
+    if (response) {
+        return response.statusCode >= 500;
+    }
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    switch (error.code) {
+        case NSURLErrorNotConnectedToInternet:
+        case NSURLErrorNetworkConnectionLost:
+        case NSURLErrorTimedOut:
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorDNSLookupFailed:
+        case NSURLErrorInternationalRoamingOff:
+        case NSURLErrorDataNotAllowed:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                         endpoint:(NSString *)endpoint
+                          fileURL:(NSURL *)fileURL {
+    self = [super init];
+    if (self) {
+        _apiClient = apiClient;
+        _endpoint = [endpoint copy];
+        _fileURL = fileURL;
+        _queue = dispatch_queue_create("com.stripe.sourcequeue", DISPATCH_QUEUE_SERIAL);
+        _entries = [NSMutableArray array];
+        NSString *host = apiClient.apiURL.host;
+        if (host) {
+            _reachability = SCNetworkReachabilityCreateWithName(kCFAllocatorDefault, host.UTF8String);
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_reachability) {
+        SCNetworkReachabilitySetCallback(_reachability, NULL, NULL);
+        SCNetworkReachabilitySetDispatchQueue(_reachability, NULL);
+        CFRelease(_reachability);
+    }
+}
+
+- (NSArray<NSString *> *)pendingIdentifiers {
+    __block NSArray<NSString *> *identifiers;
+    dispatch_sync(self.queue, ^{
+        identifiers = [self.entries valueForKey:EntryIdentifierKey];
+    });
+    return identifiers;
+}
+
+- (void)start {
+    dispatch_async(self.queue, ^{
+        [self startIfNeeded];
+    });
+}
+
+- (NSString *)enqueueFormData:(NSData *)formData {
+    NSString *identifier = [NSUUID UUID].UUIDString;
+    NSDictionary<NSString *, NSString *> *entry = @{
+                                                    EntryIdentifierKey: identifier,
+                                                    EntryBodyKey: [formData base64EncodedStringWithOptions:(NSDataBase64EncodingOptions)0],
+                                                    };
+    dispatch_async(self.queue, ^{
+        [self startIfNeeded];
+        [self.entries addObject:entry];
+        [self saveEntries];
+        [self sendNextEntry];
+    });
+    return identifier;
+}
+
+#pragma mark - Sending
+
+- (void)startIfNeeded {
+    if (self.started) {
+        return;
+    }
+    self.started = YES;
+    [self loadEntries];
+    if (self.reachability) {
+        SCNetworkReachabilityContext context = {0, (__bridge void *)self, NULL, NULL, NULL};
+        SCNetworkReachabilitySetCallback(self.reachability, STPSourceCreationQueueReachabilityCallback, &context);
+        SCNetworkReachabilitySetDispatchQueue(self.reachability, self.queue);
+        SCNetworkReachabilityFlags flags;
+        if (SCNetworkReachabilityGetFlags(self.reachability, &flags)) {
+            [self reachabilityDidChangeFlags:flags];
+        }
+    } else {
+        // Without reachability, try anyway and let the request tell us.
+        self.reachable = YES;
+    }
+    [self sendNextEntry];
+}
+
+- (void)reachabilityDidChangeFlags:(SCNetworkReachabilityFlags)flags {
+    self.reachable = (flags & kSCNetworkReachabilityFlagsReachable) && !(flags & kSCNetworkReachabilityFlagsConnectionRequired);
+    self.networkErrorCount = 0;
+    [self sendNextEntry];
+}
+
+- (void)sendNextEntry {
+    STPAPIClient *apiClient = self.apiClient;
+    if (!apiClient || self.sending || !self.reachable || self.waitingToRetry || self.entries.count == 0) {
+        return;
+    }
+    NSDictionary<NSString *, NSString *> *entry = self.entries.firstObject;
+    NSString *identifier = entry[EntryIdentifierKey];
+    NSData *formData = [[NSData alloc] initWithBase64EncodedString:entry[EntryBodyKey] options:(NSDataBase64DecodingOptions)0];
+    self.sending = YES;
+    [STPAPIRequest<STPSource *> postWithAPIClient:apiClient
+                                         endpoint:self.endpoint
+                                         formData:formData ?: [NSData data]
+                                   idempotencyKey:identifier
+                                       serializer:[STPSource new]
+                                  completionQueue:self.queue
+                                       completion:^(STPSource *source, NSHTTPURLResponse *response, NSError *error) {
+                                           self.sending = NO;
+                                           if (error && [[self class] shouldKeepRequestWithResponse:response error:error]) {
+                                               if (response) {
+                                                   [self retryAfterDelay:ServerErrorRetryInterval];
+                                               } else if (self.reachable && self.networkErrorCount < NetworkErrorMaxRetries) {
+                                                   self.networkErrorCount++;
+                                                   [self retryAfterDelay:[[self class] retryDelayAfterNetworkErrors:self.networkErrorCount]];
+                                               }
+                                               return;
+                                           }
+                                           self.networkErrorCount = 0;
+                                           [self.entries removeObject:entry];
+                                           [self saveEntries];
+                                           [self notifyCompletionOfEntryWithIdentifier:identifier source:source error:error];
+                                           [self sendNextEntry];
+                                       }];
+}
+
+- (void)retryAfterDelay:(NSTimeInterval)delay {
+    self.waitingToRetry = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, ^{
+        self.waitingToRetry = NO;
+        [self sendNextEntry];
+    });
+}
+
+- (void)notifyCompletionOfEntryWithIdentifier:(NSString *)identifier source:(STPSource *)source error:(NSError *)error {
+    STPAPIClient *apiClient = self.apiClient;
+    dispatch_async(apiClient.completionQueue ?: dispatch_get_main_queue(), ^{
+        id<STPAPIClientSourceQueueDelegate> delegate = apiClient.sourceQueueDelegate;
+        if (source) {
+            [delegate apiClient:apiClient didCreateQueuedSource:source identifier:identifier];
+        } else {
+            [delegate apiClient:apiClient didFailToCreateQueuedSourceWithIdentifier:identifier error:error];
+        }
+    });
+}
+
+#pragma mark - Persistence
+
+- (void)loadEntries {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    id entries = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:NULL];
+    if ([entries isKindOfClass:[NSArray class]]) {
+        for (id entry in entries) {
+            if ([entry isKindOfClass:[NSDictionary class]]
+                && [entry[EntryIdentifierKey] isKindOfClass:[NSString class]]
+                && [entry[EntryBodyKey] isKindOfClass:[NSString class]]) {
+                [self.entries addObject:entry];
+            }
+        }
+    }
+}
+
+- (void)saveEntries {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (self.entries.count == 0) {
+        [fileManager removeItemAtURL:self.fileURL error:NULL];
+        return;
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:self.entries options:(NSJSONWritingOptions)kNilOptions error:NULL];
+    [fileManager createDirectoryAtURL:[self.fileURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:NULL];
+    if ([data writeToURL:self.fileURL options:(NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication) error:NULL]) {
+        [self.fileURL setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:NULL];
+    }
+}
+
+@end
@@ -10,6 +10,14 @@
 
 @interface STPSourceParams ()
 
-@property (nonatomic, nullable, strong) NSString *redirectMerchantName;
+@property (nonatomic, nullable, copy) NSString *redirectMerchantName;
+
+/**
+ The form encoding of these params, kept until any of them is set again, so
+ creating several sources from the same params (or copies of them) only
+ encodes them once. Setting a dictionary copies it, so the encoding only goes
+ stale if a mutable object nested inside one is changed afterwards.
+ */
+- (nonnull NSDictionary *)formParameters;
 
 @end
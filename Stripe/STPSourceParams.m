@@ -13,7 +13,10 @@
 #import "STPFormEncoder.h"
 #import "STPSource+Private.h"
 
-@implementation STPSourceParams
+@implementation STPSourceParams {
+    // Set by `formParameters`, and cleared by every setter
+    NSDictionary *_formParameters;
+}
 
 @synthesize additionalAPIParameters = _additionalAPIParameters;
 
@@ -28,6 +31,78 @@
     return self;
 }
 
+#pragma mark - Setters
+
+- (void)didChange {
+    _formParameters = nil;
+}
+
+- (void)setType:(STPSourceType)type {
+    _type = type;
+    [self didChange];
+}
+
+- (void)setAmount:(NSNumber *)amount {
+    _amount = [amount copy];
+    [self didChange];
+}
+
+- (void)setCurrency:(NSString *)currency {
+    _currency = [currency copy];
+    [self didChange];
+}
+
+- (void)setFlow:(STPSourceFlow)flow {
+    _flow = flow;
+    [self didChange];
+}
+
+- (void)setMetadata:(NSDictionary *)metadata {
+    _metadata = [metadata copy];
+    [self didChange];
+}
+
+- (void)setOwner:(NSDictionary *)owner {
+    _owner = [owner copy];
+    [self didChange];
+}
+
+- (void)setRedirect:(NSDictionary *)redirect {
+    _redirect = [redirect copy];
+    [self didChange];
+}
+
+- (void)setToken:(NSString *)token {
+    _token = [token copy];
+    [self didChange];
+}
+
+- (void)setUsage:(STPSourceUsage)usage {
+    _usage = usage;
+    [self didChange];
+}
+
+- (void)setAdditionalAPIParameters:(NSDictionary *)additionalAPIParameters {
+    _additionalAPIParameters = [additionalAPIParameters copy];
+    [self didChange];
+}
+
+- (void)setRedirectMerchantName:(NSString *)redirectMerchantName {
+    // Set to the same name before every request, so only a new name counts
+    if (redirectMerchantName == _redirectMerchantName || [redirectMerchantName isEqualToString:_redirectMerchantName]) {
+        return;
+    }
+    _redirectMerchantName = [redirectMerchantName copy];
+    [self didChange];
+}
+
+- (NSDictionary *)formParameters {
+    if (!_formParameters) {
+        _formParameters = [STPFormEncoder dictionaryForObject:self];
+    }
+    return _formParameters;
+}
+
 - (NSString *)typeString {
     return [STPSource stringFromType:self.type];
 }
@@ -215,43 +290,58 @@
  the value of return_url if necessary
  */
 - (NSDictionary *)redirectDictionaryWithMerchantNameIfNecessary {
-    if (self.redirectMerchantName
-        && self.redirect[@"return_url"]) {
-
-        NSURL *url = [NSURL URLWithString:self.redirect[@"return_url"]];
-        if (url) {
-            NSURLComponents *urlComponents = [NSURLComponents componentsWithURL:url
-                                                        resolvingAgainstBaseURL:NO];
-
-            if (urlComponents) {
-
-                for (NSURLQueryItem *item in urlComponents.queryItems) {
-                    if ([item.name isEqualToString:@"redirect_merchant_name"]) {
-                        // Just return, don't replace their value
-                        return self.redirect;
-                    }
-                }
-
-                // If we get here, there was no existing redirect name
-
-                NSMutableArray<NSURLQueryItem *> *queryItems = (urlComponents.queryItems ?: @[]).mutableCopy;
-
-                [queryItems addObject:[NSURLQueryItem queryItemWithName:@"redirect_merchant_name"
-                                                                  value:self.redirectMerchantName]];
-                urlComponents.queryItems = queryItems;
-
-
-                NSMutableDictionary *redirectCopy = self.redirect.mutableCopy;
-                redirectCopy[@"return_url"] = urlComponents.URL.absoluteString;
-                
-                return redirectCopy.copy;
-            }
+    NSString *returnURL = self.redirect[@"return_url"];
+    if (self.redirectMerchantName && [returnURL isKindOfClass:[NSString class]]) {
+        NSString *encodedReturnURL = [self.class returnURL:returnURL withMerchantName:self.redirectMerchantName];
+        if (![encodedReturnURL isEqualToString:returnURL]) {
+            NSMutableDictionary *redirectCopy = self.redirect.mutableCopy;
+            redirectCopy[@"return_url"] = encodedReturnURL;
+            return redirectCopy.copy;
         }
-
     }
-
     return self.redirect;
+}
 
+/**
+ `returnURL` with a redirect_merchant_name query item added, unless it has
+ one already or can't be parsed. An app creates its sources with the same few
+ return URLs and one merchant name, so results are kept for the process and
+ creating a source doesn't usually parse its URL.
+ */
++ (NSString *)returnURL:(NSString *)returnURL withMerchantName:(NSString *)merchantName {
+    static NSCache<NSString *, NSString *> *returnURLs;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        returnURLs = [NSCache new];
+        returnURLs.name = @"com.stripe.sourceparams.returnurls";
+    });
+    NSString *key = [NSString stringWithFormat:@"%@\n%@", merchantName, returnURL];
+    NSString *encoded = [returnURLs objectForKey:key];
+    if (encoded) {
+        return encoded;
+    }
+    encoded = returnURL;
+    NSURL *url = [NSURL URLWithString:returnURL];
+    NSURLComponents *urlComponents = url ? [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:NO] : nil;
+    if (urlComponents) {
+        BOOL hasMerchantName = NO;
+        for (NSURLQueryItem *item in urlComponents.queryItems) {
+            if ([item.name isEqualToString:@"redirect_merchant_name"]) {
+                // Don't replace their value
+                hasMerchantName = YES;
+                break;
+            }
+        }
+        if (!hasMerchantName) {
+            NSMutableArray<NSURLQueryItem *> *queryItems = (urlComponents.queryItems ?: @[]).mutableCopy;
+            [queryItems addObject:[NSURLQueryItem queryItemWithName:@"redirect_merchant_name"
+                                                              value:merchantName]];
+            urlComponents.queryItems = queryItems;
+            encoded = urlComponents.URL.absoluteString ?: returnURL;
+        }
+    }
+    [returnURLs setObject:encoded forKey:key];
+    return encoded;
 }
 
 
@@ -278,16 +368,21 @@
 #pragma mark - NSCopying
 
 - (id)copyWithZone:(__unused NSZone *)zone {
+    // Every value is immutable, so the copy shares them, along with their
+    // form encoding.
     STPSourceParams *copy = [self.class new];
     copy.type = self.type;
     copy.amount = self.amount;
     copy.currency = self.currency;
     copy.flow = self.flow;
-    copy.metadata = [self.metadata copy];
-    copy.owner = [self.owner copy];
-    copy.redirect = [self.redirect copy];
+    copy.metadata = self.metadata;
+    copy.owner = self.owner;
+    copy.redirect = self.redirect;
     copy.token = self.token;
     copy.usage = self.usage;
+    copy.additionalAPIParameters = self.additionalAPIParameters;
+    copy.redirectMerchantName = self.redirectMerchantName;
+    copy->_formParameters = _formParameters;
     return copy;
 }
 
@@ -0,0 +1,43 @@
+//
+//  STPSourcePollIntervalPolicy.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPRedirectContextState.h"
+
+@class STPSource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Decides how long an `STPSourcePoller` waits between successful polls of a
+ pending source. Failed requests back off from this interval.
+ */
+@protocol STPSourcePollIntervalPolicy <NSObject>
+
+/**
+ @param source The latest version of the source, if one has been fetched.
+ @param redirectState The state of the source's redirect context, or
+ `STPRedirectContextStateNotStarted` if it has none.
+ @param redirectCompletedDate When the redirect completed, if it has.
+ */
+- (NSTimeInterval)pollIntervalForSource:(nullable STPSource *)source
+                          redirectState:(STPRedirectContextState)redirectState
+                  redirectCompletedDate:(nullable NSDate *)redirectCompletedDate;
+
+@end
+
+/**
+ The policy pollers use unless told otherwise. It polls slowly while the user
+ is away completing a redirect, quickly for a short time after they come back,
+ and slowly for receiver-flow sources, which wait on an external transfer.
+ */
+@interface STPSourcePollDefaultIntervalPolicy : NSObject <STPSourcePollIntervalPolicy>
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,43 @@
+//
+//  STPSourcePollIntervalPolicy.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourcePollIntervalPolicy.h"
+
+#import "STPSource.h"
+
+static NSTimeInterval const DefaultPollInterval = 1.5;
+static NSTimeInterval const RedirectInProgressPollInterval = 5;
+static NSTimeInterval const RedirectReturnedPollInterval = 0.5;
+// How long after the user returns from a redirect to keep polling quickly
+static NSTimeInterval const RedirectReturnedWindow = 10;
+static NSTimeInterval const ReceiverPollInterval = 5;
+
+@implementation STPSourcePollDefaultIntervalPolicy
+
+- (NSTimeInterval)pollIntervalForSource:(STPSource *)source
+                          redirectState:(STPRedirectContextState)redirectState
+                  redirectCompletedDate:(NSDate *)redirectCompletedDate {
+    switch (redirectState) {
+        case STPRedirectContextStateInProgress:
+            return RedirectInProgressPollInterval;
+        case STPRedirectContextStateCompleted:
+            if (redirectCompletedDate && -[redirectCompletedDate timeIntervalSinceNow] < RedirectReturnedWindow) {
+                return RedirectReturnedPollInterval;
+            }
+            break;
+        case STPRedirectContextStateNotStarted:
+        case STPRedirectContextStateCancelled:
+            break;
+    }
+    if (source.flow == STPSourceFlowReceiver) {
+        return ReceiverPollInterval;
+    }
+    return DefaultPollInterval;
+}
+
+@end
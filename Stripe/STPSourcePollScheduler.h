@@ -0,0 +1,67 @@
+//
+//  STPSourcePollScheduler.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class STPSourcePoller;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Drives every `STPSourcePoller` created by one API client. Due polls run off a
+ single timer, so pollers whose polls fall due together fire in one batch.
+ The scheduler also owns the app lifecycle observers and the background task
+ that cover the pollers' requests. Must be used from the main thread.
+ */
+NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions")
+@interface STPSourcePollScheduler : NSObject
+
+/**
+ Starts delivering lifecycle events to `poller`. Pollers are held weakly.
+ */
+- (void)addPoller:(STPSourcePoller *)poller;
+
+/**
+ Stops delivering lifecycle events to `poller` and cancels its pending poll.
+ */
+- (void)removePoller:(STPSourcePoller *)poller;
+
+/**
+ Calls `-poll` on `poller` after `interval`, replacing any poll already
+ scheduled for it.
+ */
+- (void)schedulePoller:(STPSourcePoller *)poller after:(NSTimeInterval)interval;
+
+/**
+ Cancels the pending poll for `poller`, if there is one.
+ */
+- (void)unschedulePoller:(STPSourcePoller *)poller;
+
+/**
+ Whether `poller` has a pending poll.
+ */
+- (BOOL)isPollerScheduled:(STPSourcePoller *)poller;
+
+/**
+ Pollers call these around each request so that a single background task
+ covers every request in flight.
+ */
+- (void)pollerDidStartRequest;
+- (void)pollerDidFinishRequest;
+
+#if DEBUG
+/**
+ A line for each poller of every scheduler, e.g. `src_123 in 2.0s`, for the
+ performance HUD. Like everything else here, main thread only.
+ */
++ (NSArray<NSString *> *)pollerDescriptions;
+#endif
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,272 @@
+//
+//  STPSourcePollScheduler.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourcePollScheduler.h"
+
+#import <UIKit/UIKit.h>
+
+#import "STPAPIRequest.h"
+#import "STPExtensionMode.h"
+#import "STPRedirectContext+Private.h"
+#import "STPSourcePoller.h"
+
+NSString *const STPRedirectContextStateDidChangeNotification = @"STPRedirectContextStateDidChangeNotification";
+NSString *const STPRedirectContextSourceIDKey = @"STPRedirectContextSourceIDKey";
+NSString *const STPRedirectContextStateKey = @"STPRedirectContextStateKey";
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Polls due within this window of each other fire together
+static NSTimeInterval const CoalescingWindow = 0.5;
+// Polls held back for a payment request check again after this long
+static NSTimeInterval const UserBlockingRequestDeferral = 0.5;
+// Due polls beyond this many in flight wait for one to finish
+static NSInteger const MaxConcurrentPolls = 4;
+
+@interface STPSourcePollScheduler ()
+
+@property (nonatomic) NSHashTable<STPSourcePoller *> *pollers;
+@property (nonatomic) NSMapTable<STPSourcePoller *, NSDate *> *dueDates;
+@property (nonatomic, nullable) NSTimer *timer;
+@property (nonatomic) NSInteger requestCount;
+@property (nonatomic) UIBackgroundTaskIdentifier backgroundTaskID;
+
+@end
+
+@implementation STPSourcePollScheduler
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _pollers = [NSHashTable weakObjectsHashTable];
+        _dueDates = [NSMapTable weakToStrongObjectsMapTable];
+        _backgroundTaskID = UIBackgroundTaskInvalid;
+#if DEBUG
+        NSHashTable *schedulers = [[self class] allSchedulers];
+        @synchronized(schedulers) {
+            [schedulers addObject:self];
+        }
+#endif
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [_timer invalidate];
+}
+
+#pragma mark - Pollers
+
+- (void)addPoller:(STPSourcePoller *)poller {
+    if (self.pollers.count == 0) {
+        [self startObservingLifecycle];
+    }
+    [self.pollers addObject:poller];
+}
+
+- (void)removePoller:(STPSourcePoller *)poller {
+    [self unschedulePoller:poller];
+    [self.pollers removeObject:poller];
+    if (self.pollers.count == 0) {
+        [[NSNotificationCenter defaultCenter] removeObserver:self];
+    }
+}
+
+- (void)schedulePoller:(STPSourcePoller *)poller after:(NSTimeInterval)interval {
+    [self.dueDates setObject:[NSDate dateWithTimeIntervalSinceNow:interval] forKey:poller];
+    [self rescheduleTimer];
+}
+
+- (void)unschedulePoller:(STPSourcePoller *)poller {
+    if ([self.dueDates objectForKey:poller]) {
+        [self.dueDates removeObjectForKey:poller];
+        [self rescheduleTimer];
+    }
+}
+
+- (BOOL)isPollerScheduled:(STPSourcePoller *)poller {
+    return [self.dueDates objectForKey:poller] != nil;
+}
+
+#if DEBUG
+
+// Schedulers are created by API clients on any thread, so this is synchronized
++ (NSHashTable<STPSourcePollScheduler *> *)allSchedulers {
+    static NSHashTable *schedulers;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schedulers = [NSHashTable weakObjectsHashTable];
+    });
+    return schedulers;
+}
+
++ (NSArray<NSString *> *)pollerDescriptions {
+    NSHashTable *schedulers = [self allSchedulers];
+    NSArray<STPSourcePollScheduler *> *allSchedulers;
+    @synchronized(schedulers) {
+        allSchedulers = schedulers.allObjects;
+    }
+    NSMutableArray<NSString *> *descriptions = [NSMutableArray array];
+    for (STPSourcePollScheduler *scheduler in allSchedulers) {
+        for (STPSourcePoller *poller in scheduler.pollers) {
+            NSDate *dueDate = [scheduler.dueDates objectForKey:poller];
+            if (dueDate) {
+                [descriptions addObject:[NSString stringWithFormat:@"%@ in %.1fs", poller.sourceID, MAX([dueDate timeIntervalSinceNow], 0)]];
+            } else {
+                [descriptions addObject:[NSString stringWithFormat:@"%@ not scheduled", poller.sourceID]];
+            }
+        }
+    }
+    return descriptions;
+}
+
+#endif
+
+#pragma mark - Timer
+
+- (void)rescheduleTimer {
+    NSDate *earliestDate;
+    for (STPSourcePoller *poller in self.dueDates) {
+        NSDate *dueDate = [self.dueDates objectForKey:poller];
+        if (!earliestDate || [dueDate compare:earliestDate] == NSOrderedAscending) {
+            earliestDate = dueDate;
+        }
+    }
+    if (self.timer && earliestDate && [self.timer.fireDate isEqualToDate:earliestDate]) {
+        return;
+    }
+    [self.timer invalidate];
+    self.timer = nil;
+    if (earliestDate && self.requestCount < MaxConcurrentPolls) {
+        NSTimeInterval interval = MAX([earliestDate timeIntervalSinceNow], 0);
+        if ([STPAPIRequest userBlockingRequestCount] > 0) {
+            interval = MAX(interval, UserBlockingRequestDeferral);
+        }
+        self.timer = [NSTimer scheduledTimerWithTimeInterval:interval
+                                                      target:self
+                                                    selector:@selector(fireDuePolls)
+                                                    userInfo:nil
+                                                     repeats:NO];
+        self.timer.tolerance = CoalescingWindow;
+    }
+}
+
+- (void)fireDuePolls {
+    self.timer = nil;
+    // A user waiting on a token or source comes before polling; the polls
+    // stay due and go out once it's done.
+    if ([STPAPIRequest userBlockingRequestCount] > 0) {
+        [self rescheduleTimer];
+        return;
+    }
+    NSDate *cutoff = [NSDate dateWithTimeIntervalSinceNow:CoalescingWindow];
+    NSInteger availableSlots = MaxConcurrentPolls - self.requestCount;
+    NSMutableArray<STPSourcePoller *> *duePollers = [NSMutableArray array];
+    for (STPSourcePoller *poller in self.dueDates) {
+        if ((NSInteger)duePollers.count >= availableSlots) {
+            break;
+        }
+        if ([[self.dueDates objectForKey:poller] compare:cutoff] != NSOrderedDescending) {
+            [duePollers addObject:poller];
+        }
+    }
+    for (STPSourcePoller *poller in duePollers) {
+        [self.dueDates removeObjectForKey:poller];
+    }
+    for (STPSourcePoller *poller in duePollers) {
+        [poller poll];
+    }
+    [self rescheduleTimer];
+}
+
+#pragma mark - Background task
+
+- (void)pollerDidStartRequest {
+    self.requestCount++;
+    if (self.backgroundTaskID == UIBackgroundTaskInvalid) {
+        UIApplication *application = stpSharedApplication();
+        self.backgroundTaskID = [application beginBackgroundTaskWithExpirationHandler:^{
+            [self endBackgroundTask];
+        }];
+    }
+}
+
+- (void)pollerDidFinishRequest {
+    self.requestCount = MAX(self.requestCount - 1, 0);
+    if (self.requestCount == 0) {
+        [self endBackgroundTask];
+    }
+    // A slot is free for any poll that was held back
+    [self rescheduleTimer];
+}
+
+- (void)endBackgroundTask {
+    if (self.backgroundTaskID != UIBackgroundTaskInvalid) {
+        [stpSharedApplication() endBackgroundTask:self.backgroundTaskID];
+        self.backgroundTaskID = UIBackgroundTaskInvalid;
+    }
+}
+
+#pragma mark - App lifecycle
+
+- (void)startObservingLifecycle {
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    [notificationCenter addObserver:self
+                           selector:@selector(restartPolling)
+                               name:UIApplicationDidBecomeActiveNotification
+                             object:nil];
+    [notificationCenter addObserver:self
+                           selector:@selector(restartPolling)
+                               name:UIApplicationWillEnterForegroundNotification
+                             object:nil];
+    [notificationCenter addObserver:self
+                           selector:@selector(pausePolling)
+                               name:UIApplicationWillResignActiveNotification
+                             object:nil];
+    [notificationCenter addObserver:self
+                           selector:@selector(continuePollingInBackground)
+                               name:UIApplicationDidEnterBackgroundNotification
+                             object:nil];
+    [notificationCenter addObserver:self
+                           selector:@selector(redirectContextStateDidChange:)
+                               name:STPRedirectContextStateDidChangeNotification
+                             object:nil];
+}
+
+- (void)restartPolling {
+    for (STPSourcePoller *poller in self.pollers.allObjects) {
+        [poller restartPolling];
+    }
+}
+
+- (void)redirectContextStateDidChange:(NSNotification *)notification {
+    NSString *sourceID = notification.userInfo[STPRedirectContextSourceIDKey];
+    STPRedirectContextState state = [notification.userInfo[STPRedirectContextStateKey] unsignedIntegerValue];
+    for (STPSourcePoller *poller in self.pollers.allObjects) {
+        if ([poller.sourceID isEqualToString:sourceID]) {
+            [poller redirectContextDidChangeState:state];
+        }
+    }
+}
+
+- (void)pausePolling {
+    for (STPSourcePoller *poller in self.pollers.allObjects) {
+        [poller pausePolling];
+    }
+}
+
+- (void)continuePollingInBackground {
+    for (STPSourcePoller *poller in self.pollers.allObjects) {
+        [poller continuePollingInBackground];
+    }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
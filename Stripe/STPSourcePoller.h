@@ -8,11 +8,29 @@
 
 #import <Foundation/Foundation.h>
 #import "STPBlocks.h"
+#import "STPRedirectContextState.h"
+#import "STPSourcePollIntervalPolicy.h"
 
-@class STPAPIClient;
+@class STPAPIClient, STPSource;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ How an `STPSourcePoller` waits for a source to leave the pending state.
+ */
+typedef NS_ENUM(NSInteger, STPSourcePollerEngine) {
+    /**
+     Fetches the source on a timer, backing off after failed requests.
+     */
+    STPSourcePollerEngineTimer,
+    /**
+     Holds one long-poll request open at a time, and re-issues it as soon as
+     it returns. Falls back to timer polling if the server doesn't honor
+     the long poll.
+     */
+    STPSourcePollerEngineLongPoll,
+};
+
 NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions")
 @interface STPSourcePoller : NSObject
 
@@ -24,8 +42,73 @@ NS_EXTENSION_UNAVAILABLE("Source polling is not available in extensions")
                           timeout:(NSTimeInterval)timeout
                        completion:(STPSourceCompletionBlock)completion;
 
+/**
+ The designated initializer. `initWithAPIClient:clientSecret:sourceID:timeout:completion:`
+ uses `STPSourcePollerEngineTimer`.
+ */
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                     clientSecret:(NSString *)clientSecret
+                         sourceID:(NSString *)sourceID
+                          timeout:(NSTimeInterval)timeout
+                           engine:(STPSourcePollerEngine)engine
+                       completion:(STPSourceCompletionBlock)completion NS_DESIGNATED_INITIALIZER;
+
+/**
+ The engine currently in use. A long-polling poller switches to
+ `STPSourcePollerEngineTimer` when it falls back.
+ */
+@property (nonatomic, readonly) STPSourcePollerEngine engine;
+
+/**
+ Decides the interval between polls of a pending source. Defaults to an
+ `STPSourcePollDefaultIntervalPolicy`. Not consulted while long polling, since
+ each long poll already waits on the server.
+ */
+@property (nonatomic) id<STPSourcePollIntervalPolicy> intervalPolicy;
+
+@property (nonatomic, readonly) NSString *sourceID;
+
 - (void)stopPolling;
 
+/**
+ Stops polling and calls the completion block with the latest source, as if
+ the poll had timed out.
+ */
+- (void)finishPolling;
+
+/**
+ Stops polling and calls the completion block with `source`, which was
+ fetched by a background check.
+ */
+- (void)finishPollingWithSource:(STPSource *)source;
+
+/**
+ Stops polling and calls the completion block with the latest source and
+ `error`, for a poll that was ended before it could finish.
+ */
+- (void)finishPollingWithError:(NSError *)error;
+
+/**
+ Called by the scheduler when the app enters the background. Pauses polling,
+ and hands it over to the API client's background session if background
+ polling is on. `restartPolling` takes it back.
+ */
+- (void)continuePollingInBackground;
+
+/**
+ Called by the scheduler when the redirect context for this poller's source
+ changes state. Polls right away once the redirect completes.
+ */
+- (void)redirectContextDidChangeState:(STPRedirectContextState)state;
+
+/**
+ Called by the API client's `STPSourcePollScheduler`: `poll` when this
+ poller's poll falls due, and the others on app lifecycle changes.
+ */
+- (void)poll;
+- (void)restartPolling;
+- (void)pausePolling;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -10,7 +10,13 @@
 
 #import "STPAPIClient+Private.h"
 #import "STPAPIRequest.h"
+#import "STPDispatchFunctions.h"
+#import "STPMemoryAccounting.h"
+#import "STPPerformanceCounters.h"
+#import "STPSignpost.h"
 #import "STPSource.h"
+#import "STPSourcePollScheduler.h"
+#import "STPSourcePollerStateStore.h"
 #import "StripeError.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -21,26 +27,52 @@ static NSTimeInterval const MaxPollInterval = 24;
 static NSTimeInterval const MaxTimeout = 60*5;
 // Stop polling after 5 consecutive non-200 responses
 static NSTimeInterval const MaxRetries = 5;
+// How long to ask the server to hold each long poll
+static NSTimeInterval const LongPollWaitInterval = 25;
+// Stop checking in the background an hour after polling started. The system
+// runs background checks when it sees fit, so they're given longer.
+static NSTimeInterval const MaxBackgroundTimeout = 60*60;
 
 @interface STPSourcePoller ()
 
 @property (nonatomic, weak) STPAPIClient *apiClient;
-@property (nonatomic) NSString *sourceID;
+@property (nonatomic, readwrite) NSString *sourceID;
 @property (nonatomic) NSString *clientSecret;
 @property (nonatomic, copy) STPSourceCompletionBlock completion;
 @property (nonatomic, nullable) STPSource *latestSource;
+// The ETag latestSource was sent with, so a poll can skip downloading it again
+@property (nonatomic, nullable, copy) NSString *latestEntityTag;
 @property (nonatomic) NSTimeInterval pollInterval;
 @property (nonatomic) NSTimeInterval timeout;
 @property (nonatomic, nullable) NSURLSessionDataTask *dataTask;
-@property (nonatomic, nullable) NSTimer *timer;
+@property (nonatomic) STPSourcePollScheduler *scheduler;
+@property (nonatomic, nullable) STPSourcePollerStateStore *stateStore;
+@property (nonatomic) STPRedirectContextState redirectState;
+@property (nonatomic, nullable) NSDate *redirectCompletedDate;
 @property (nonatomic) NSDate *startTime;
 @property (nonatomic) NSInteger retryCount;
 @property (nonatomic) NSInteger requestCount;
 @property (nonatomic) BOOL pollingPaused;
 @property (nonatomic) BOOL pollingStopped;
+@property (nonatomic) BOOL pollingInBackground;
+@property (nonatomic, readwrite) STPSourcePollerEngine engine;
 
 @end
 
+/**
+ Header field names are case-insensitive, and HTTP/2 responses arrive with
+ them lowercased.
+ */
+static NSString * _Nullable STPHeaderFieldValue(NSHTTPURLResponse *response, NSString *name) {
+    NSDictionary *headerFields = response.allHeaderFields;
+    for (NSString *field in headerFields) {
+        if ([field caseInsensitiveCompare:name] == NSOrderedSame) {
+            return headerFields[field];
+        }
+    }
+    return nil;
+}
+
 @implementation STPSourcePoller
 
 - (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
@@ -48,6 +80,20 @@ static NSTimeInterval const MaxRetries = 5;
                          sourceID:(NSString *)sourceID
                           timeout:(NSTimeInterval)timeout
                        completion:(STPSourceCompletionBlock)completion {
+    return [self initWithAPIClient:apiClient
+                      clientSecret:clientSecret
+                          sourceID:sourceID
+                           timeout:timeout
+                            engine:STPSourcePollerEngineTimer
+                        completion:completion];
+}
+
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                     clientSecret:(NSString *)clientSecret
+                         sourceID:(NSString *)sourceID
+                          timeout:(NSTimeInterval)timeout
+                           engine:(STPSourcePollerEngine)engine
+                       completion:(STPSourceCompletionBlock)completion {
     self = [super init];
     if (self) {
         _apiClient = apiClient;
@@ -61,32 +107,19 @@ static NSTimeInterval const MaxRetries = 5;
         _requestCount = 0;
         _pollingPaused = NO;
         _pollingStopped = NO;
+        _engine = engine;
+        _intervalPolicy = [STPSourcePollDefaultIntervalPolicy new];
+        _redirectState = STPRedirectContextStateNotStarted;
+        _scheduler = apiClient.sourcePollScheduler;
+        _stateStore = apiClient.sourcePollerStateStore;
+        [self restoreState];
+        [_scheduler addPoller:self];
+        [STPMemoryAccounting trackObject:self category:STPMemoryCategorySourcePollers];
         [self pollAfter:0 lastError:nil];
-        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
-        [notificationCenter addObserver:self
-                               selector:@selector(restartPolling)
-                                   name:UIApplicationDidBecomeActiveNotification
-                                 object:nil];
-        [notificationCenter addObserver:self
-                               selector:@selector(restartPolling)
-                                   name:UIApplicationWillEnterForegroundNotification
-                                 object:nil];
-        [notificationCenter addObserver:self
-                               selector:@selector(pausePolling)
-                                   name:UIApplicationWillResignActiveNotification
-                                 object:nil];
-        [notificationCenter addObserver:self
-                               selector:@selector(pausePolling)
-                                   name:UIApplicationDidEnterBackgroundNotification
-                                 object:nil];
     }
     return self;
 }
 
-- (void)dealloc {
-    [[NSNotificationCenter defaultCenter] removeObserver:self];
-}
-
 - (void)pollAfter:(NSTimeInterval)interval lastError:(nullable NSError *)error {
     NSTimeInterval totalTime = [[NSDate date] timeIntervalSinceDate:self.startTime];
     BOOL shouldTimeout = (self.requestCount > 0 &&
@@ -99,31 +132,44 @@ static NSTimeInterval const MaxRetries = 5;
     if (self.pollingPaused || self.pollingStopped) {
         return;
     }
-    self.timer = [NSTimer scheduledTimerWithTimeInterval:interval
-                                                  target:self
-                                                selector:@selector(poll)
-                                                userInfo:nil
-                                                 repeats:NO];
+    [self.scheduler schedulePoller:self after:interval];
 }
 
 - (void)poll {
-    self.timer = nil;
-    UIApplication *application = [UIApplication sharedApplication];
-    __block UIBackgroundTaskIdentifier bgTaskID = UIBackgroundTaskInvalid;
-    bgTaskID = [application beginBackgroundTaskWithExpirationHandler:^{
-        self.dataTask = nil;
-        [application endBackgroundTask:bgTaskID];
-        bgTaskID = UIBackgroundTaskInvalid;
-    }];
-    self.dataTask = [self.apiClient retrieveSourceWithId:self.sourceID
-                                            clientSecret:self.clientSecret
-                                      responseCompletion:^(STPSource *source, NSHTTPURLResponse *response, NSError *error) {
-                                          [self continueWithSource:source response:response error:error];
-                                          self.requestCount++;
-                                          self.dataTask = nil;
-                                          [application endBackgroundTask:bgTaskID];
-                                          bgTaskID = UIBackgroundTaskInvalid;
-                                      }];
+    STPSourcePollScheduler *scheduler = self.scheduler;
+    [scheduler pollerDidStartRequest];
+    STPPerformanceCounterIncrement(STPPerformanceCounterSourcePolls);
+    STPSignpostIntervalBegin("Source poll", self);
+    STPAPIResponseBlock responseCompletion = ^(STPSource *source, NSHTTPURLResponse *response, NSError *error) {
+        // The API client may be configured to call back on another
+        // queue, but polling timers need the main run loop.
+        stpDispatchToMainThreadIfNecessary(^{
+            STPSignpostIntervalEnd("Source poll", self);
+            [self continueWithSource:source response:response error:error];
+            self.requestCount++;
+            self.dataTask = nil;
+            if (!self.pollingStopped) {
+                [self saveState];
+            }
+            [scheduler pollerDidFinishRequest];
+        });
+    };
+    if (self.engine == STPSourcePollerEngineLongPoll) {
+        NSTimeInterval totalTime = [[NSDate date] timeIntervalSinceDate:self.startTime];
+        NSTimeInterval remainingTime = MIN(self.timeout, MaxTimeout) - totalTime;
+        self.dataTask = [self.apiClient waitForSourceWithId:self.sourceID
+                                               clientSecret:self.clientSecret
+                                             previousSource:self.latestSource
+                                                  entityTag:self.latestEntityTag
+                                               waitInterval:MAX(MIN(LongPollWaitInterval, remainingTime), 1)
+                                         responseCompletion:responseCompletion];
+    } else {
+        self.dataTask = [self.apiClient retrieveSourceWithId:self.sourceID
+                                                clientSecret:self.clientSecret
+                                              previousSource:self.latestSource
+                                                   entityTag:self.latestEntityTag
+                                          responseCompletion:responseCompletion];
+    }
 }
 
 - (void)continueWithSource:(STPSource *)source
@@ -135,12 +181,24 @@ static NSTimeInterval const MaxRetries = 5;
             // Don't retry requests that 4xx
             [self cleanupAndFireCompletionWithSource:self.latestSource
                                                error:error];
-        } else if (status == 200) {
-            self.pollInterval = DefaultPollInterval;
+        } else if (status == 200 || (status == 304 && self.latestSource)) {
+            // A 304 means latestSource hasn't changed, so it's still pending
+            if (status == 200) {
+                self.latestSource = source;
+                self.latestEntityTag = STPHeaderFieldValue(response, @"ETag");
+            }
+            self.pollInterval = [self.intervalPolicy pollIntervalForSource:self.latestSource
+                                                             redirectState:self.redirectState
+                                                     redirectCompletedDate:self.redirectCompletedDate];
             self.retryCount = 0;
-            self.latestSource = source;
-            if ([self shouldContinuePollingSource:source]) {
-                [self pollAfter:self.pollInterval lastError:nil];
+            if ([self shouldContinuePollingSource:self.latestSource]) {
+                if (self.engine == STPSourcePollerEngineLongPoll && ![self responseHonoredLongPoll:response]) {
+                    self.engine = STPSourcePollerEngineTimer;
+                }
+                // A long poll that comes back pending has already waited on
+                // the server, so the next one can start right away.
+                NSTimeInterval interval = (self.engine == STPSourcePollerEngineLongPoll) ? 0 : self.pollInterval;
+                [self pollAfter:interval lastError:nil];
             } else {
                 [self cleanupAndFireCompletionWithSource:self.latestSource
                                                    error:nil];
@@ -157,6 +215,12 @@ static NSTimeInterval const MaxRetries = 5;
             error.code == kCFURLErrorNetworkConnectionLost) {
             self.retryCount++;
             [self pollAfter:self.pollInterval lastError:error];
+        } else if (error.code == kCFURLErrorTimedOut && self.engine == STPSourcePollerEngineLongPoll) {
+            // Something between us and the server won't hold a connection
+            // open that long.
+            self.engine = STPSourcePollerEngineTimer;
+            self.retryCount++;
+            [self pollAfter:self.pollInterval lastError:error];
         } else {
             // Don't call completion if the request was cancelled
             if (error.code != kCFURLErrorCancelled) {
@@ -168,6 +232,11 @@ static NSTimeInterval const MaxRetries = 5;
     }
 }
 
+- (BOOL)responseHonoredLongPoll:(NSHTTPURLResponse *)response {
+    NSString *preferenceApplied = STPHeaderFieldValue(response, @"Preference-Applied");
+    return preferenceApplied && [preferenceApplied rangeOfString:@"wait" options:NSCaseInsensitiveSearch].location != NSNotFound;
+}
+
 - (BOOL)shouldContinuePollingSource:(nullable STPSource *)source {
     if (!source) {
         return NO;
@@ -179,19 +248,54 @@ static NSTimeInterval const MaxRetries = 5;
     if (self.pollingStopped) {
         return;
     }
+    if (self.pollingInBackground) {
+        // A result the background checks already got has been delivered by
+        // now; otherwise the poll carries on here.
+        self.pollingInBackground = NO;
+        [self.apiClient stopBackgroundPollingSourceWithId:self.sourceID];
+    }
     self.pollingPaused = NO;
-    if (!self.timer && !self.dataTask) {
+    if (![self.scheduler isPollerScheduled:self] && !self.dataTask) {
         [self pollAfter:0 lastError:nil];
     }
 }
 
+- (void)redirectContextDidChangeState:(STPRedirectContextState)state {
+    self.redirectState = state;
+    if (state == STPRedirectContextStateCompleted) {
+        self.redirectCompletedDate = [NSDate date];
+    }
+    if (!self.pollingStopped) {
+        [self saveState];
+    }
+    if (state != STPRedirectContextStateCompleted) {
+        return;
+    }
+    // The user is back, so don't wait out an interval chosen while they were
+    // away. A poll that is paused or already in flight is left alone.
+    if ([self.scheduler isPollerScheduled:self]) {
+        self.pollInterval = [self.intervalPolicy pollIntervalForSource:self.latestSource
+                                                         redirectState:self.redirectState
+                                                 redirectCompletedDate:self.redirectCompletedDate];
+        [self.scheduler schedulePoller:self after:0];
+    }
+}
+
 // Pauses polling, without canceling the request in progress.
 - (void)pausePolling {
     self.pollingPaused = YES;
-    if (self.timer) {
-        [self.timer invalidate];
-        self.timer = nil;
+    [self.scheduler unschedulePoller:self];
+}
+
+- (void)continuePollingInBackground {
+    [self pausePolling];
+    if (self.pollingStopped || self.pollingInBackground) {
+        return;
     }
+    NSDate *deadline = [self.startTime dateByAddingTimeInterval:MaxBackgroundTimeout];
+    self.pollingInBackground = [self.apiClient startBackgroundPollingSourceWithId:self.sourceID
+                                                                     clientSecret:self.clientSecret
+                                                                         deadline:deadline];
 }
 
 - (void)cleanupAndFireCompletionWithSource:(nullable STPSource *)source
@@ -208,13 +312,67 @@ static NSTimeInterval const MaxRetries = 5;
     }
 }
 
+- (void)finishPolling {
+    [self cleanupAndFireCompletionWithSource:self.latestSource error:nil];
+}
+
+- (void)finishPollingWithSource:(STPSource *)source {
+    self.latestSource = source;
+    [self finishPolling];
+}
+
+- (void)finishPollingWithError:(NSError *)error {
+    [self cleanupAndFireCompletionWithSource:self.latestSource error:error];
+}
+
+#pragma mark - Saved state
+
+// Picks up from where an unfinished poll for the same source was when the
+// app last ran, so its timeout covers only the time it had left.
+- (void)restoreState {
+    STPSourcePollerState *state = [self.stateStore stateForSourceWithId:self.sourceID];
+    if (!state) {
+        return;
+    }
+    self.latestSource = state.latestSource;
+    if (state.finished) {
+        return;
+    }
+    self.startTime = state.startTime;
+    self.retryCount = state.retryCount;
+    self.pollInterval = state.pollInterval > 0 ? state.pollInterval : DefaultPollInterval;
+    self.redirectState = state.redirectState;
+    self.redirectCompletedDate = state.redirectCompletedDate;
+}
+
+- (void)saveState {
+    if (!self.stateStore) {
+        return;
+    }
+    STPSourcePollerState *state = [STPSourcePollerState new];
+    state.latestSource = self.latestSource;
+    state.startTime = self.startTime;
+    state.pollInterval = self.pollInterval;
+    state.retryCount = self.retryCount;
+    state.redirectState = self.redirectState;
+    state.redirectCompletedDate = self.redirectCompletedDate;
+    state.finished = self.pollingStopped;
+    [self.stateStore saveState:state forSourceWithId:self.sourceID];
+}
+
 // Stops polling and cancels the request in progress.
 - (void)stopPolling {
+    BOOL wasStopped = self.pollingStopped;
     self.pollingStopped = YES;
-    if (self.timer) {
-        [self.timer invalidate];
-        self.timer = nil;
+    if (!wasStopped) {
+        [self saveState];
+    }
+    if (self.pollingInBackground) {
+        self.pollingInBackground = NO;
+        [self.apiClient stopBackgroundPollingSourceWithId:self.sourceID];
     }
+    [self.apiClient sourcePollerDidStop:self];
+    [self.scheduler removePoller:self];
     if (self.dataTask) {
         [self.dataTask cancel];
         self.dataTask = nil;
@@ -0,0 +1,68 @@
+//
+//  STPSourcePollerStateStore.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPRedirectContextState.h"
+
+@class STPSource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Where an `STPSourcePoller` had got to with a source, as saved by an
+ `STPSourcePollerStateStore`.
+ */
+@interface STPSourcePollerState : NSObject
+
+@property (nonatomic, nullable) STPSource *latestSource;
+@property (nonatomic) NSDate *startTime;
+@property (nonatomic) NSTimeInterval pollInterval;
+@property (nonatomic) NSInteger retryCount;
+@property (nonatomic) STPRedirectContextState redirectState;
+@property (nonatomic, nullable) NSDate *redirectCompletedDate;
+/**
+ Whether the poll had finished. A finished poll's `latestSource` is still
+ worth showing, but a new poll for the source starts over.
+ */
+@property (nonatomic) BOOL finished;
+
+@end
+
+/**
+ Saves the state of each source poll to disk as it changes, so that after a
+ relaunch the latest source can be shown right away, and a poll for it can
+ pick up with the time it had left rather than starting over. Safe to use
+ from any thread; files are written on a serial queue.
+ */
+@interface STPSourcePollerStateStore : NSObject
+
+/**
+ @param fileURL Where to save poll states. States left there by an earlier
+ launch are loaded right away, apart from those more than a day old.
+ */
+- (instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (nullable STPSourcePollerState *)stateForSourceWithId:(NSString *)identifier;
+
+- (void)saveState:(STPSourcePollerState *)state forSourceWithId:(NSString *)identifier;
+
+- (void)removeStateForSourceWithId:(NSString *)identifier;
+
+/**
+ Where poll states for `publishableKey` are saved by default. Sources hold
+ customer details, so they're kept out of backups and encrypted until the
+ device is first unlocked.
+ */
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey;
+
+@end
+
+NS_ASSUME_NONNULL_END
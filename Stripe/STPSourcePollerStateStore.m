@@ -0,0 +1,157 @@
+//
+//  STPSourcePollerStateStore.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPSourcePollerStateStore.h"
+
+#import "STPSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// States older than this are dropped when the store is loaded
+static NSTimeInterval const MaxStateAge = 60*60*24;
+
+static NSString *const SourceKey = @"source";
+static NSString *const StartTimeKey = @"start_time";
+static NSString *const PollIntervalKey = @"poll_interval";
+static NSString *const RetryCountKey = @"retry_count";
+static NSString *const RedirectStateKey = @"redirect_state";
+static NSString *const RedirectCompletedDateKey = @"redirect_completed_date";
+static NSString *const FinishedKey = @"finished";
+
+@implementation STPSourcePollerState
+
++ (nullable instancetype)stateWithDictionary:(NSDictionary *)dict {
+    if (![dict[StartTimeKey] isKindOfClass:[NSNumber class]]) {
+        return nil;
+    }
+    STPSourcePollerState *state = [self new];
+    if ([dict[SourceKey] isKindOfClass:[NSDictionary class]]) {
+        state.latestSource = [STPSource decodedObjectFromAPIResponse:dict[SourceKey]];
+    }
+    state.startTime = [NSDate dateWithTimeIntervalSince1970:[dict[StartTimeKey] doubleValue]];
+    state.pollInterval = [dict[PollIntervalKey] doubleValue];
+    state.retryCount = [dict[RetryCountKey] integerValue];
+    state.redirectState = (STPRedirectContextState)[dict[RedirectStateKey] integerValue];
+    if ([dict[RedirectCompletedDateKey] isKindOfClass:[NSNumber class]]) {
+        state.redirectCompletedDate = [NSDate dateWithTimeIntervalSince1970:[dict[RedirectCompletedDateKey] doubleValue]];
+    }
+    state.finished = [dict[FinishedKey] boolValue];
+    return state;
+}
+
+- (NSDictionary *)dictionaryValue {
+    NSMutableDictionary *dict = [@{
+                                   StartTimeKey: @([self.startTime timeIntervalSince1970]),
+                                   PollIntervalKey: @(self.pollInterval),
+                                   RetryCountKey: @(self.retryCount),
+                                   RedirectStateKey: @(self.redirectState),
+                                   FinishedKey: @(self.finished),
+                                   } mutableCopy];
+    if (self.latestSource) {
+        dict[SourceKey] = self.latestSource.allResponseFields;
+    }
+    if (self.redirectCompletedDate) {
+        dict[RedirectCompletedDateKey] = @([self.redirectCompletedDate timeIntervalSince1970]);
+    }
+    return dict;
+}
+
+@end
+
+@interface STPSourcePollerStateStore ()
+
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) dispatch_queue_t queue;
+// Saved states by source ID. Only touched on queue.
+@property (nonatomic) NSMutableDictionary<NSString *, NSDictionary *> *entries;
+
+@end
+
+@implementation STPSourcePollerStateStore
+
++ (NSURL *)defaultFileURLForPublishableKey:(NSString *)publishableKey {
+    NSURL *supportURL = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] firstObject];
+    NSURL *directoryURL = [supportURL URLByAppendingPathComponent:@"com.stripe.sourcepollerstate" isDirectory:YES];
+    return [directoryURL URLByAppendingPathComponent:[publishableKey stringByAppendingPathExtension:@"json"]];
+}
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL {
+    self = [super init];
+    if (self) {
+        _fileURL = fileURL;
+        _queue = dispatch_queue_create("com.stripe.sourcepollerstate", DISPATCH_QUEUE_SERIAL);
+        _entries = [NSMutableDictionary dictionary];
+        [self loadEntries];
+    }
+    return self;
+}
+
+- (nullable STPSourcePollerState *)stateForSourceWithId:(NSString *)identifier {
+    __block NSDictionary *entry;
+    dispatch_sync(self.queue, ^{
+        entry = self.entries[identifier];
+    });
+    return entry ? [STPSourcePollerState stateWithDictionary:entry] : nil;
+}
+
+- (void)saveState:(STPSourcePollerState *)state forSourceWithId:(NSString *)identifier {
+    NSDictionary *entry = [state dictionaryValue];
+    dispatch_async(self.queue, ^{
+        self.entries[identifier] = entry;
+        [self saveEntries];
+    });
+}
+
+- (void)removeStateForSourceWithId:(NSString *)identifier {
+    dispatch_async(self.queue, ^{
+        if (self.entries[identifier]) {
+            [self.entries removeObjectForKey:identifier];
+            [self saveEntries];
+        }
+    });
+}
+
+#pragma mark - Persistence
+
+- (void)loadEntries {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    id entries = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:NULL];
+    if (![entries isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    NSTimeInterval oldestStartTime = [[NSDate date] timeIntervalSince1970] - MaxStateAge;
+    for (id identifier in entries) {
+        id entry = entries[identifier];
+        if ([identifier isKindOfClass:[NSString class]]
+            && [entry isKindOfClass:[NSDictionary class]]
+            && [entry[StartTimeKey] isKindOfClass:[NSNumber class]]
+            && [entry[StartTimeKey] doubleValue] >= oldestStartTime) {
+            self.entries[identifier] = entry;
+        }
+    }
+}
+
+- (void)saveEntries {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (self.entries.count == 0) {
+        [fileManager removeItemAtURL:self.fileURL error:NULL];
+        return;
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:self.entries options:(NSJSONWritingOptions)kNilOptions error:NULL];
+    [fileManager createDirectoryAtURL:[self.fileURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:NULL];
+    if ([data writeToURL:self.fileURL options:(NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication) error:NULL]) {
+        [self.fileURL setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:NULL];
+    }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
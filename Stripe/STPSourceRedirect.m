@@ -21,16 +21,17 @@
 @implementation STPSourceRedirect
 
 + (STPSourceRedirectStatus)statusFromString:(NSString *)string {
-    NSString *status = [string lowercaseString];
-    if ([status isEqualToString:@"pending"]) {
-        return STPSourceRedirectStatusPending;
-    } else if ([status isEqualToString:@"succeeded"]) {
-        return STPSourceRedirectStatusSucceeded;
-    } else if ([status isEqualToString:@"failed"]) {
-        return STPSourceRedirectStatusFailed;
-    } else {
-        return STPSourceRedirectStatusUnknown;
-    }
+    static NSDictionary<NSString *,NSNumber *> *stringToStatus;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToStatus = @{
+                           @"pending": @(STPSourceRedirectStatusPending),
+                           @"succeeded": @(STPSourceRedirectStatusSucceeded),
+                           @"failed": @(STPSourceRedirectStatusFailed),
+                           };
+    });
+    NSNumber *value = [stringToStatus stp_objectForLowercaseKeyMatchingString:string];
+    return value ? (STPSourceRedirectStatus)[value integerValue] : STPSourceRedirectStatusUnknown;
 }
 
 #pragma mark STPAPIResponseDecodable
@@ -20,16 +20,17 @@
 @implementation STPSourceVerification
 
 + (STPSourceVerificationStatus)statusFromString:(NSString *)string {
-    NSString *status = [string lowercaseString];
-    if ([status isEqualToString:@"pending"]) {
-        return STPSourceVerificationStatusPending;
-    } else if ([status isEqualToString:@"succeeded"]) {
-        return STPSourceVerificationStatusSucceeded;
-    } else if ([status isEqualToString:@"failed"]) {
-        return STPSourceVerificationStatusFailed;
-    } else {
-        return STPSourceVerificationStatusUnknown;
-    }
+    static NSDictionary<NSString *,NSNumber *> *stringToStatus;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stringToStatus = @{
+                           @"pending": @(STPSourceVerificationStatusPending),
+                           @"succeeded": @(STPSourceVerificationStatusSucceeded),
+                           @"failed": @(STPSourceVerificationStatusFailed),
+                           };
+    });
+    NSNumber *value = [stringToStatus stp_objectForLowercaseKeyMatchingString:string];
+    return value ? (STPSourceVerificationStatus)[value integerValue] : STPSourceVerificationStatusUnknown;
 }
 
 #pragma mark STPAPIResponseDecodable
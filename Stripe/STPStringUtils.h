@@ -53,3 +53,34 @@ typedef void(^STPTaggedSubstringsCompletionBlock)(NSString *string, NSDictionary
                      withTags:(NSSet<NSString *> *)tags
                    completion:(STPTaggedSubstringsCompletionBlock)completion;
 @end
+
+/**
+ *  The result of running `parseRangesFromString:withTags:completion:` on a
+ *  string, kept around so that strings which never change (e.g. localized
+ *  copy) are only scanned once.
+ */
+@interface STPTaggedStringTemplate : NSObject
+
+/**
+ *  Returns the parsed template for the string and tags, parsing it only the
+ *  first time a given string and tag set are seen. Because the string itself is
+ *  the cache key, each localization of a piece of copy gets its own entry.
+ */
++ (instancetype)templateWithString:(NSString *)string tags:(NSSet<NSString *> *)tags;
+
+/**
+ *  The string with the tags removed.
+ */
+@property(nonatomic, readonly)NSString *string;
+
+/**
+ *  The ranges in `string` that each tag enclosed, wrapped in NSValue.
+ */
+@property(nonatomic, readonly)NSDictionary<NSString *, NSValue *> *tagMap;
+
+/**
+ *  The range in `string` the tag enclosed, or a range with location NSNotFound.
+ */
+- (NSRange)rangeForTag:(NSString *)tag;
+
+@end
@@ -114,4 +114,40 @@
 }
 
 
+@end
+
+@interface STPTaggedStringTemplate ()
+@property(nonatomic, readwrite)NSString *string;
+@property(nonatomic, readwrite)NSDictionary<NSString *, NSValue *> *tagMap;
+@end
+
+@implementation STPTaggedStringTemplate
+
++ (instancetype)templateWithString:(NSString *)string tags:(NSSet<NSString *> *)tags {
+    static NSCache<NSString *, STPTaggedStringTemplate *> *templates;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        templates = [NSCache new];
+    });
+    NSArray<NSString *> *sortedTags = [tags.allObjects sortedArrayUsingSelector:@selector(compare:)];
+    NSString *key = [NSString stringWithFormat:@"%@|%@", [sortedTags componentsJoinedByString:@","], string];
+    STPTaggedStringTemplate *template = [templates objectForKey:key];
+    if (!template) {
+        template = [self new];
+        [STPStringUtils parseRangesFromString:string
+                                     withTags:tags
+                                   completion:^(NSString *parsedString, NSDictionary<NSString *,NSValue *> *tagMap) {
+                                       template.string = parsedString;
+                                       template.tagMap = tagMap;
+                                   }];
+        [templates setObject:template forKey:key];
+    }
+    return template;
+}
+
+- (NSRange)rangeForTag:(NSString *)tag {
+    NSValue *rangeValue = self.tagMap[tag];
+    return rangeValue ? rangeValue.rangeValue : NSMakeRange(NSNotFound, 0);
+}
+
 @end
@@ -8,12 +8,14 @@
 
 #import "STPSwitchTableViewCell.h"
 #import "STPColorUtils.h"
+#import "STPTheme+Private.h"
 
 @interface STPSwitchTableViewCell()
 
 @property(nonatomic, weak)UILabel *captionLabel;
 @property(nonatomic, weak)UISwitch *switchView;
 @property(nonatomic, weak)id<STPSwitchTableViewCellDelegate> delegate;
+@property(nonatomic)NSUInteger appliedThemeChangeToken;
 
 @end
 
@@ -38,7 +40,11 @@
 }
 
 - (void)setTheme:(STPTheme *)theme {
+    if (theme == _theme && theme.changeToken == self.appliedThemeChangeToken) {
+        return;
+    }
     _theme = theme;
+    self.appliedThemeChangeToken = theme.changeToken;
     [self updateAppearance];
 }
 
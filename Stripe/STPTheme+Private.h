@@ -0,0 +1,52 @@
+//
+//  STPTheme+Private.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPTheme.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The theme properties that differ between two themes. Derived properties are
+ *  folded into the property they are computed from, e.g. `tertiaryBackgroundColor`
+ *  changes with `STPThemeChangePrimaryBackgroundColor` and `smallFont` with
+ *  `STPThemeChangeFont`.
+ */
+typedef NS_OPTIONS(NSUInteger, STPThemeChange) {
+    STPThemeChangeNone = 0,
+    STPThemeChangePrimaryBackgroundColor = 1 << 0,
+    STPThemeChangeSecondaryBackgroundColor = 1 << 1,
+    STPThemeChangePrimaryForegroundColor = 1 << 2,
+    STPThemeChangeSecondaryForegroundColor = 1 << 3,
+    STPThemeChangeAccentColor = 1 << 4,
+    STPThemeChangeErrorColor = 1 << 5,
+    STPThemeChangeFont = 1 << 6,
+    STPThemeChangeEmphasisFont = 1 << 7,
+    STPThemeChangeBarStyle = 1 << 8,
+    STPThemeChangeTranslucentNavigationBar = 1 << 9,
+    STPThemeChangeAll = (1 << 10) - 1,
+};
+
+@interface STPTheme ()
+
+/**
+ *  Changes whenever any property of this theme is set. Tokens are unique across
+ *  all themes, so a view that remembers the token it last applied can skip
+ *  re-theming when it is handed the same, unmodified theme again.
+ */
+@property(nonatomic, readonly)NSUInteger changeToken;
+
+/**
+ *  Returns the properties of this theme that differ from `theme`. Passing nil
+ *  returns `STPThemeChangeAll`. Views keep a copy of the theme they last applied
+ *  and pass it here, so they only touch what actually changed.
+ */
+- (STPThemeChange)changesFromTheme:(nullable STPTheme *)theme;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -6,13 +6,23 @@
 //  Copyright © 2016 Stripe, Inc. All rights reserved.
 //
 
+#import <stdatomic.h>
+
 #import "STPTheme.h"
+#import "STPTheme+Private.h"
 #import "STPColorUtils.h"
 
 @interface STPTheme()
 @property(nonatomic)NSNumber *internalBarStyle;
+@property(nonatomic, readwrite)NSUInteger changeToken;
 @end
 
+static _Atomic(NSUInteger) STPThemeLastChangeToken;
+
+static NSUInteger STPThemeNextChangeToken(void) {
+    return atomic_fetch_add(&STPThemeLastChangeToken, 1) + 1;
+}
+
 static UIColor *STPThemeDefaultPrimaryBackgroundColor;
 static UIColor *STPThemeDefaultSecondaryBackgroundColor;
 static UIColor *STPThemeDefaultPrimaryForegroundColor;
@@ -22,9 +32,31 @@ static UIColor *STPThemeDefaultErrorColor;
 static UIFont  *STPThemeDefaultFont;
 static UIFont  *STPThemeDefaultMediumFont;
 
+// The point size of the preferred body font at the default content size
+// category, which Dynamic Type scales from.
+static const CGFloat STPThemeContentSizeBodyPointSize = 17;
+
+// How much Dynamic Type scales fonts at the current content size category,
+// or 0 when it has to be read again.
+static CGFloat STPThemeContentSizeScale;
+
 #define FAUXPAS_IGNORED_ON_LINE(...)
 
-@implementation STPTheme
+@implementation STPTheme {
+    // Derived values, computed on first access and cleared by -themeDidChange
+    // whenever a property they depend on is set.
+    UIColor *_cachedTertiaryBackgroundColor;
+    UIColor *_cachedQuaternaryBackgroundColor;
+    UIColor *_cachedTertiaryForegroundColor;
+    UIFont *_cachedFont;
+    UIFont *_cachedEmphasisFont;
+    UIFont *_cachedSmallFont;
+    UIFont *_cachedLargeFont;
+    NSNumber *_cachedBarStyle;
+    // The content size scale the cached fonts were made for. They're made
+    // again when it changes.
+    CGFloat _cachedFontsContentSizeScale;
+}
 
 + (void)initialize {
     STPThemeDefaultPrimaryBackgroundColor = [UIColor colorWithRed:242.0f/255.0f green:242.0f/255.0f blue:245.0f/255.0f alpha:1];
@@ -40,6 +72,24 @@ static UIFont  *STPThemeDefaultMediumFont;
     } else {
         STPThemeDefaultMediumFont = [UIFont boldSystemFontOfSize:17];
     }
+
+    // Observed rather than read on every access: reading the category itself
+    // needs UIApplication, which isn't available in extensions, or iOS 10's
+    // trait collections.
+    [[NSNotificationCenter defaultCenter] addObserverForName:UIContentSizeCategoryDidChangeNotification
+                                                      object:nil
+                                                       queue:nil
+                                                  usingBlock:^(__unused NSNotification *note) {
+                                                      STPThemeContentSizeScale = 0;
+                                                  }];
+}
+
++ (CGFloat)contentSizeScale {
+    if (STPThemeContentSizeScale == 0) {
+        UIFontDescriptor *bodyDescriptor = [UIFontDescriptor preferredFontDescriptorWithTextStyle:UIFontTextStyleBody];
+        STPThemeContentSizeScale = bodyDescriptor.pointSize / STPThemeContentSizeBodyPointSize;
+    }
+    return STPThemeContentSizeScale;
 }
 
 + (STPTheme *)defaultTheme {
@@ -63,10 +113,110 @@ static UIFont  *STPThemeDefaultMediumFont;
         _font = STPThemeDefaultFont;
         _emphasisFont = STPThemeDefaultMediumFont;
         _translucentNavigationBar = NO;
+        _changeToken = STPThemeNextChangeToken();
     }
     return self;
 }
 
+- (void)themeDidChange {
+    _cachedTertiaryBackgroundColor = nil;
+    _cachedQuaternaryBackgroundColor = nil;
+    _cachedTertiaryForegroundColor = nil;
+    [self clearCachedFonts];
+    _cachedBarStyle = nil;
+    self.changeToken = STPThemeNextChangeToken();
+}
+
+- (void)clearCachedFonts {
+    _cachedFont = nil;
+    _cachedEmphasisFont = nil;
+    _cachedSmallFont = nil;
+    _cachedLargeFont = nil;
+}
+
+/**
+ Clears the cached fonts if they were made for another content size category,
+ and returns how much to scale them by.
+ */
+- (CGFloat)validateCachedFonts {
+    CGFloat scale = self.adjustsFontsForContentSizeCategory ? [self.class contentSizeScale] : 1;
+    if (scale != _cachedFontsContentSizeScale) {
+        [self clearCachedFonts];
+        if (_cachedFontsContentSizeScale != 0) {
+            // Views skip re-theming unless the token changes
+            self.changeToken = STPThemeNextChangeToken();
+        }
+        _cachedFontsContentSizeScale = scale;
+    }
+    return scale;
+}
+
+// Checked first, so views comparing tokens see a content size category change
+// even when nothing has read a font since.
+- (NSUInteger)changeToken {
+    [self validateCachedFonts];
+    return _changeToken;
+}
+
+- (void)setPrimaryBackgroundColor:(UIColor *)primaryBackgroundColor {
+    _primaryBackgroundColor = [primaryBackgroundColor copy];
+    [self themeDidChange];
+}
+
+- (void)setSecondaryBackgroundColor:(UIColor *)secondaryBackgroundColor {
+    _secondaryBackgroundColor = [secondaryBackgroundColor copy];
+    [self themeDidChange];
+}
+
+- (void)setPrimaryForegroundColor:(UIColor *)primaryForegroundColor {
+    _primaryForegroundColor = [primaryForegroundColor copy];
+    [self themeDidChange];
+}
+
+- (void)setSecondaryForegroundColor:(UIColor *)secondaryForegroundColor {
+    _secondaryForegroundColor = [secondaryForegroundColor copy];
+    [self themeDidChange];
+}
+
+- (void)setAccentColor:(UIColor *)accentColor {
+    _accentColor = [accentColor copy];
+    [self themeDidChange];
+}
+
+- (void)setErrorColor:(UIColor *)errorColor {
+    _errorColor = [errorColor copy];
+    [self themeDidChange];
+}
+
+- (void)setFont:(UIFont *)font {
+    _font = [font copy];
+    [self themeDidChange];
+}
+
+- (void)setEmphasisFont:(UIFont *)emphasisFont {
+    _emphasisFont = [emphasisFont copy];
+    [self themeDidChange];
+}
+
+- (void)setAdjustsFontsForContentSizeCategory:(BOOL)adjustsFontsForContentSizeCategory {
+    _adjustsFontsForContentSizeCategory = adjustsFontsForContentSizeCategory;
+    [self themeDidChange];
+}
+
+- (void)setTranslucentNavigationBar:(BOOL)translucentNavigationBar {
+    _translucentNavigationBar = translucentNavigationBar;
+    [self themeDidChange];
+}
+
+- (UIColor *)primaryBackgroundColorOffsetByBrightness:(CGFloat)offset {
+    CGFloat hue;
+    CGFloat saturation;
+    CGFloat brightness;
+    CGFloat alpha;
+    [self.primaryBackgroundColor getHue:&hue saturation:&saturation brightness:&brightness alpha:&alpha];
+    return [UIColor colorWithHue:hue saturation:saturation brightness:(brightness + offset) alpha:alpha];
+}
+
 - (UIColor *)primaryBackgroundColor {
     return _primaryBackgroundColor ?: STPThemeDefaultPrimaryBackgroundColor;
 }
@@ -76,12 +226,10 @@ static UIFont  *STPThemeDefaultMediumFont;
 }
 
 - (UIColor *)tertiaryBackgroundColor {
-	CGFloat hue;
-	CGFloat saturation;
-	CGFloat brightness;
-	CGFloat alpha;
-	[self.primaryBackgroundColor getHue:&hue saturation:&saturation brightness:&brightness alpha:&alpha];
-    return [UIColor colorWithHue:hue saturation:saturation brightness:(brightness - 0.09f) alpha:alpha];
+    if (!_cachedTertiaryBackgroundColor) {
+        _cachedTertiaryBackgroundColor = [self primaryBackgroundColorOffsetByBrightness:-0.09f];
+    }
+    return _cachedTertiaryBackgroundColor;
 }
 
 - (UIColor *)primaryForegroundColor {
@@ -93,16 +241,17 @@ static UIFont  *STPThemeDefaultMediumFont;
 }
 
 - (UIColor *)tertiaryForegroundColor {
-    return [self.primaryForegroundColor colorWithAlphaComponent:0.25f];
+    if (!_cachedTertiaryForegroundColor) {
+        _cachedTertiaryForegroundColor = [self.primaryForegroundColor colorWithAlphaComponent:0.25f];
+    }
+    return _cachedTertiaryForegroundColor;
 }
 
 - (UIColor *)quaternaryBackgroundColor {
-    CGFloat hue;
-    CGFloat saturation;
-    CGFloat brightness;
-    CGFloat alpha;
-    [self.primaryBackgroundColor getHue:&hue saturation:&saturation brightness:&brightness alpha:&alpha];
-    return [UIColor colorWithHue:hue saturation:saturation brightness:(brightness - 0.03f) alpha:alpha];
+    if (!_cachedQuaternaryBackgroundColor) {
+        _cachedQuaternaryBackgroundColor = [self primaryBackgroundColorOffsetByBrightness:-0.03f];
+    }
+    return _cachedQuaternaryBackgroundColor;
 }
 
 - (UIColor *)accentColor {
@@ -114,19 +263,39 @@ static UIFont  *STPThemeDefaultMediumFont;
 }
 
 - (UIFont *)font {
-    return _font ?: STPThemeDefaultFont;
+    CGFloat scale = [self validateCachedFonts];
+    if (!_cachedFont) {
+        UIFont *font = _font ?: STPThemeDefaultFont;
+        _cachedFont = scale == 1 ? font : [font fontWithSize:font.pointSize * scale];
+    }
+    return _cachedFont;
 }
 
 - (UIFont *)emphasisFont {
-    return _emphasisFont ?: STPThemeDefaultMediumFont;
+    CGFloat scale = [self validateCachedFonts];
+    if (!_cachedEmphasisFont) {
+        UIFont *font = _emphasisFont ?: STPThemeDefaultMediumFont;
+        _cachedEmphasisFont = scale == 1 ? font : [font fontWithSize:font.pointSize * scale];
+    }
+    return _cachedEmphasisFont;
 }
 
 - (UIFont *)smallFont {
-    return [self.font fontWithSize:self.font.pointSize - 2];
+    CGFloat scale = [self validateCachedFonts];
+    if (!_cachedSmallFont) {
+        UIFont *font = _font ?: STPThemeDefaultFont;
+        _cachedSmallFont = [font fontWithSize:(font.pointSize - 2) * scale];
+    }
+    return _cachedSmallFont;
 }
 
 - (UIFont *)largeFont {
-    return [self.font fontWithSize:self.font.pointSize + 15];
+    CGFloat scale = [self validateCachedFonts];
+    if (!_cachedLargeFont) {
+        UIFont *font = _font ?: STPThemeDefaultFont;
+        _cachedLargeFont = [font fontWithSize:(font.pointSize + 15) * scale];
+    }
+    return _cachedLargeFont;
 }
 
 - (UIBarStyle)barStyleForColor:(UIColor *)color {
@@ -140,13 +309,62 @@ static UIFont  *STPThemeDefaultMediumFont;
 
 - (void)setBarStyle:(UIBarStyle)barStyle {
     _internalBarStyle = @(barStyle);
+    [self themeDidChange];
 }
 
 - (UIBarStyle)barStyle {
     if (_internalBarStyle) {
         return [_internalBarStyle integerValue];
     }
-    return [self barStyleForColor:self.secondaryBackgroundColor];
+    if (!_cachedBarStyle) {
+        _cachedBarStyle = @([self barStyleForColor:self.secondaryBackgroundColor]);
+    }
+    return [_cachedBarStyle integerValue];
+}
+
+static BOOL STPThemeValuesEqual(id value, id otherValue) {
+    return value == otherValue || [value isEqual:otherValue];
+}
+
+- (STPThemeChange)changesFromTheme:(STPTheme *)theme {
+    if (!theme) {
+        return STPThemeChangeAll;
+    }
+    if (theme == self) {
+        return STPThemeChangeNone;
+    }
+    STPThemeChange changes = STPThemeChangeNone;
+    if (!STPThemeValuesEqual(self.primaryBackgroundColor, theme.primaryBackgroundColor)) {
+        changes |= STPThemeChangePrimaryBackgroundColor;
+    }
+    if (!STPThemeValuesEqual(self.secondaryBackgroundColor, theme.secondaryBackgroundColor)) {
+        changes |= STPThemeChangeSecondaryBackgroundColor;
+    }
+    if (!STPThemeValuesEqual(self.primaryForegroundColor, theme.primaryForegroundColor)) {
+        changes |= STPThemeChangePrimaryForegroundColor;
+    }
+    if (!STPThemeValuesEqual(self.secondaryForegroundColor, theme.secondaryForegroundColor)) {
+        changes |= STPThemeChangeSecondaryForegroundColor;
+    }
+    if (!STPThemeValuesEqual(self.accentColor, theme.accentColor)) {
+        changes |= STPThemeChangeAccentColor;
+    }
+    if (!STPThemeValuesEqual(self.errorColor, theme.errorColor)) {
+        changes |= STPThemeChangeErrorColor;
+    }
+    if (!STPThemeValuesEqual(self.font, theme.font)) {
+        changes |= STPThemeChangeFont;
+    }
+    if (!STPThemeValuesEqual(self.emphasisFont, theme.emphasisFont)) {
+        changes |= STPThemeChangeEmphasisFont;
+    }
+    if (self.barStyle != theme.barStyle) {
+        changes |= STPThemeChangeBarStyle;
+    }
+    if (self.translucentNavigationBar != theme.translucentNavigationBar) {
+        changes |= STPThemeChangeTranslucentNavigationBar;
+    }
+    return changes;
 }
 
 - (id)copyWithZone:(__unused NSZone *)zone {
@@ -157,8 +375,10 @@ static UIFont  *STPThemeDefaultMediumFont;
     copyTheme.secondaryForegroundColor = self.secondaryForegroundColor;
     copyTheme.accentColor = self.accentColor;
     copyTheme.errorColor = self.errorColor;
-    copyTheme.font = self.font;
-    copyTheme.emphasisFont = self.emphasisFont;
+    // The unscaled fonts, so a copy isn't scaled twice
+    copyTheme.font = _font;
+    copyTheme.emphasisFont = _emphasisFont;
+    copyTheme.adjustsFontsForContentSizeCategory = self.adjustsFontsForContentSizeCategory;
     return copyTheme;
 }
 
@@ -0,0 +1,190 @@
+//
+//  STPThreeDSecureFlow.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPThreeDSecureFlow.h"
+
+#import "STPAPIClient.h"
+#import "STPCardParams+Private.h"
+#import "STPCardValidator.h"
+#import "STPSource.h"
+#import "STPSourceParams.h"
+#import "STPWeakStrongMacros.h"
+
+#import <SafariServices/SafariServices.h>
+
+#define FAUXPAS_IGNORED_IN_METHOD(...)
+
+@interface STPThreeDSecureFlow ()
+
+@property (nonatomic) STPAPIClient *apiClient;
+@property (nonatomic) NSUInteger amount;
+@property (nonatomic, copy) NSString *currency;
+@property (nonatomic, copy) NSString *returnURL;
+@property (nonatomic, copy) STPRedirectContextCompletionBlock redirectCompletion;
+// A hash of the card details the sources are being created for. A new
+// fingerprint object is made for every card, so a response can tell whether
+// it's still wanted by comparing pointers.
+@property (nonatomic) NSData *fingerprint;
+@property (nonatomic) NSURLSessionDataTask *task;
+@property (nonatomic) BOOL finished;
+@property (nonatomic, readwrite) STPSource *cardSource;
+@property (nonatomic, readwrite) STPSource *threeDSecureSource;
+@property (nonatomic, readwrite) STPRedirectContext *redirectContext;
+// Set by finishWithCardParams:completion: while the sources are being created
+@property (nonatomic, copy) STPThreeDSecureFlowCompletionBlock completion;
+
+@end
+
+@implementation STPThreeDSecureFlow
+
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                           amount:(NSUInteger)amount
+                         currency:(NSString *)currency
+                        returnURL:(NSString *)returnURL
+               redirectCompletion:(STPRedirectContextCompletionBlock)redirectCompletion {
+    self = [super init];
+    if (self) {
+        _apiClient = apiClient;
+        _amount = amount;
+        _currency = [currency copy];
+        _returnURL = [returnURL copy];
+        _redirectCompletion = [redirectCompletion copy];
+        _preparesSafariViewController = YES;
+    }
+    return self;
+}
+
+- (STPSourceCard3DSecureStatus)threeDSecureStatus {
+    return self.cardSource ? self.cardSource.cardDetails.threeDSecure : STPSourceCard3DSecureStatusUnknown;
+}
+
+- (void)updateCardParams:(STPCardParams *)cardParams {
+    if (self.completion) {
+        return;
+    }
+    STPCardParams *cardDetails = nil;
+    NSData *fingerprint = nil;
+    if (cardParams && [STPCardValidator validationStateForCard:cardParams] == STPCardValidationStateValid) {
+        cardDetails = [cardParams cardDetailsParams];
+        fingerprint = [cardDetails formEncodedFingerprint];
+    }
+    if (fingerprint && [fingerprint isEqualToData:self.fingerprint]) {
+        return;
+    }
+    [self cancel];
+    if (cardDetails) {
+        [self createCardSourceWithCardDetails:cardDetails fingerprint:fingerprint];
+    }
+}
+
+- (void)finishWithCardParams:(STPCardParams *)cardParams completion:(STPThreeDSecureFlowCompletionBlock)completion {
+    STPCardParams *cardDetails = [cardParams cardDetailsParams];
+    NSData *fingerprint = [cardDetails formEncodedFingerprint];
+    if (![fingerprint isEqualToData:self.fingerprint]) {
+        // Not necessarily valid, so this request's error is what's reported
+        [self cancel];
+        [self createCardSourceWithCardDetails:cardDetails fingerprint:fingerprint];
+    }
+    if (self.finished) {
+        completion(self.cardSource, self.redirectContext, nil);
+    } else {
+        self.completion = completion;
+    }
+}
+
+- (void)cancel {
+    [self.task cancel];
+    self.task = nil;
+    self.fingerprint = nil;
+    self.finished = NO;
+    self.cardSource = nil;
+    self.threeDSecureSource = nil;
+    self.redirectContext = nil;
+    self.completion = nil;
+}
+
+#pragma mark - Private
+
+- (BOOL)needsThreeDSecureForCardSource:(STPSource *)cardSource {
+    switch (cardSource.cardDetails.threeDSecure) {
+        case STPSourceCard3DSecureStatusRequired:
+            return YES;
+        case STPSourceCard3DSecureStatusOptional:
+            return self.usesThreeDSecureWhenOptional;
+        case STPSourceCard3DSecureStatusNotSupported:
+        case STPSourceCard3DSecureStatusUnknown:
+            break;
+    }
+    return NO;
+}
+
+- (void)createCardSourceWithCardDetails:(STPCardParams *)cardDetails fingerprint:(NSData *)fingerprint {
+    self.fingerprint = fingerprint;
+    WEAK(self);
+    self.task = [self.apiClient createSourceWithParams:[STPSourceParams cardParamsWithCard:cardDetails]
+                                            completion:^(STPSource *source, NSError *error) {
+                                                STRONG(self);
+                                                if (self.fingerprint != fingerprint) {
+                                                    return;
+                                                }
+                                                self.cardSource = source;
+                                                if (source && [self needsThreeDSecureForCardSource:source]) {
+                                                    [self createThreeDSecureSourceForCardSource:source fingerprint:fingerprint];
+                                                } else {
+                                                    [self finishCreatingSourcesWithError:error];
+                                                }
+                                            }];
+}
+
+- (void)createThreeDSecureSourceForCardSource:(STPSource *)cardSource fingerprint:(NSData *)fingerprint {
+    STPSourceParams *params = [STPSourceParams threeDSecureParamsWithAmount:self.amount
+                                                                   currency:self.currency
+                                                                  returnURL:self.returnURL
+                                                                       card:cardSource.stripeID];
+    WEAK(self);
+    self.task = [self.apiClient createSourceWithParams:params completion:^(STPSource *source, NSError *error) {
+        STRONG(self);
+        if (self.fingerprint != fingerprint) {
+            return;
+        }
+        if (source) {
+            self.threeDSecureSource = source;
+            self.redirectContext = [[STPRedirectContext alloc] initWithSource:source completion:self.redirectCompletion];
+            [self prepareRedirectContext];
+        }
+        [self finishCreatingSourcesWithError:error];
+    }];
+}
+
+- (void)prepareRedirectContext {
+    FAUXPAS_IGNORED_IN_METHOD(APIAvailability)
+    // SFSafariViewController is iOS 9 and later
+    if (self.preparesSafariViewController && [SFSafariViewController class]) {
+        [self.redirectContext prepareSafariViewControllerRedirectFlow];
+    }
+}
+
+- (void)finishCreatingSourcesWithError:(NSError *)error {
+    self.task = nil;
+    STPThreeDSecureFlowCompletionBlock completion = self.completion;
+    if (error) {
+        // The next call starts over rather than repeating the error
+        [self cancel];
+        if (completion) {
+            completion(nil, nil, error);
+        }
+        return;
+    }
+    self.finished = YES;
+    if (completion) {
+        self.completion = nil;
+        completion(self.cardSource, self.redirectContext, nil);
+    }
+}
+
+@end
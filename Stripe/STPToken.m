@@ -21,7 +21,10 @@
 @property (nonatomic, readwrite, nonnull, copy) NSDictionary *allResponseFields;
 @end
 
-@implementation STPToken
+@implementation STPToken {
+    // Tokens never change once decoded, so neither does the hash
+    NSUInteger _hash;
+}
 
 - (NSString *)description {
     return self.tokenId ?: @"Unknown token";
@@ -38,7 +41,12 @@
 }
 
 - (NSUInteger)hash {
-    return [self.tokenId hash];
+    return _hash;
+}
+
+- (void)setTokenId:(NSString *)tokenId {
+    _tokenId = tokenId;
+    _hash = [tokenId hash];
 }
 
 - (BOOL)isEqualToToken:(STPToken *)object {
@@ -50,6 +58,12 @@
         return NO;
     }
 
+    // Different tokens almost always differ here, so the other fields are
+    // rarely compared.
+    if (_hash != object->_hash || ![self.tokenId isEqualToString:object.tokenId]) {
+        return NO;
+    }
+
     if ((self.card || object.card) && (![self.card isEqual:object.card])) {
         return NO;
     }
@@ -58,8 +72,7 @@
         return NO;
     }
 
-    return self.livemode == object.livemode && [self.tokenId isEqualToString:object.tokenId] && [self.created isEqualToDate:object.created] &&
-           [self.card isEqual:object.card] && [self.tokenId isEqualToString:object.tokenId] && [self.created isEqualToDate:object.created];
+    return self.livemode == object.livemode && [self.created isEqualToDate:object.created];
 }
 
 #pragma mark STPSource
@@ -0,0 +1,44 @@
+//
+//  STPTokenBatch.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "STPAPIClient.h"
+
+@class STPCardParams;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Drives one call to `createTokensWithCards:maxConcurrentRequests:itemCompletion:completion:`.
+ Cards are encoded and sent from a private serial queue, keeping up to
+ `maxConcurrentRequests` requests in flight on the client's shared session,
+ and analytics are logged once for the whole batch. Keeps itself alive until
+ every card has a result.
+ */
+@interface STPTokenBatch : NSObject
+
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                            cards:(NSArray<STPCardParams *> *)cards
+            maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                   itemCompletion:(nullable STPTokenBatchItemCompletionBlock)itemCompletion
+                       completion:(STPTokenBatchCompletionBlock)completion NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Counts the cards that have a result. Cancelling it cancels the requests in
+ flight, and gives the cards not yet sent an `NSURLErrorCancelled` error.
+ */
+@property (nonatomic, readonly) NSProgress *progress;
+
+- (void)start;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,175 @@
+//
+//  STPTokenBatch.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPTokenBatch.h"
+
+#import "STPAPIClient+Private.h"
+#import "STPAPIRequest.h"
+#import "STPAnalyticsClient.h"
+#import "STPCardParams.h"
+#import "STPFormEncoder.h"
+#import "STPPaymentConfiguration+Private.h"
+#import "STPSignpost.h"
+#import "STPToken.h"
+#import "STPWeakStrongMacros.h"
+#import "StripeError.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static NSString *const TokenEndpoint = @"tokens";
+
+@interface STPTokenBatch ()
+
+@property (nonatomic) STPAPIClient *apiClient;
+@property (nonatomic, copy) NSArray<STPCardParams *> *cards;
+@property (nonatomic) NSUInteger maxConcurrentRequests;
+@property (nonatomic, copy, nullable) STPTokenBatchItemCompletionBlock itemCompletion;
+@property (nonatomic, copy) STPTokenBatchCompletionBlock completion;
+@property (nonatomic, readwrite) NSProgress *progress;
+@property (nonatomic) dispatch_queue_t queue;
+
+// Everything below is only touched on queue
+@property (nonatomic) NSMutableArray *results;
+@property (nonatomic) NSMutableDictionary<NSNumber *, NSURLSessionDataTask *> *tasks;
+@property (nonatomic) NSUInteger nextIndex;
+@property (nonatomic) NSUInteger completedCount;
+@property (nonatomic) NSUInteger succeededCount;
+@property (nonatomic) BOOL cancelled;
+@property (nonatomic, copy) NSString *muid;
+@property (nonatomic) NSDate *startTime;
+// As the batch started, so analytics match the cards it sent
+@property (nonatomic) STPPaymentConfiguration *configuration;
+
+@end
+
+@implementation STPTokenBatch
+
+- (instancetype)initWithAPIClient:(STPAPIClient *)apiClient
+                            cards:(NSArray<STPCardParams *> *)cards
+            maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                   itemCompletion:(nullable STPTokenBatchItemCompletionBlock)itemCompletion
+                       completion:(STPTokenBatchCompletionBlock)completion {
+    self = [super init];
+    if (self) {
+        _apiClient = apiClient;
+        _cards = [cards copy];
+        _maxConcurrentRequests = MAX(maxConcurrentRequests, (NSUInteger)1);
+        _itemCompletion = [itemCompletion copy];
+        _completion = [completion copy];
+        _queue = dispatch_queue_create("com.stripe.tokenbatch", DISPATCH_QUEUE_SERIAL);
+        _results = [NSMutableArray arrayWithCapacity:cards.count];
+        for (NSUInteger i = 0; i < cards.count; i++) {
+            [_results addObject:[NSNull null]];
+        }
+        _tasks = [NSMutableDictionary dictionary];
+        _progress = [NSProgress progressWithTotalUnitCount:(int64_t)cards.count];
+        WEAK(self);
+        _progress.cancellationHandler = ^{
+            STRONG(self);
+            [self cancel];
+        };
+    }
+    return self;
+}
+
+- (void)start {
+    dispatch_async(self.queue, ^{
+        STPSignpostIntervalBegin("Token batch", self);
+        self.startTime = [NSDate date];
+        self.configuration = [self.apiClient.configuration configurationSnapshot];
+        // The same for every card, so it's looked up once
+        self.muid = [STPAnalyticsClient muid];
+        [self sendNextCards];
+        [self finishIfDone];
+    });
+}
+
+- (void)sendNextCards {
+    while (!self.cancelled && self.tasks.count < self.maxConcurrentRequests && self.nextIndex < self.cards.count) {
+        NSUInteger index = self.nextIndex++;
+        NSMutableDictionary *parameters = [[STPFormEncoder dictionaryForObject:self.cards[index]] mutableCopy];
+        parameters[@"muid"] = self.muid;
+        NSURLSessionDataTask *task = [STPAPIRequest<STPToken *> postWithAPIClient:self.apiClient
+                                                                         endpoint:TokenEndpoint
+                                                                       parameters:parameters
+                                                                       serializer:[STPToken new]
+                                                                  completionQueue:self.queue
+                                                                       completion:^(STPToken *token, __unused NSHTTPURLResponse *response, NSError *error) {
+                                                                           [self finishCardAtIndex:index token:token error:error];
+                                                                       }];
+        // The completion is queued behind this, so the task is always recorded first
+        self.tasks[@(index)] = task;
+    }
+}
+
+- (void)finishCardAtIndex:(NSUInteger)index token:(nullable STPToken *)token error:(nullable NSError *)error {
+    [self.tasks removeObjectForKey:@(index)];
+    if (token) {
+        self.results[index] = token;
+        self.succeededCount++;
+    } else {
+        self.results[index] = error ?: [NSError stp_genericFailedToParseResponseError];
+    }
+    [self reportCardAtIndex:index token:token error:error];
+    [self sendNextCards];
+    [self finishIfDone];
+}
+
+- (void)reportCardAtIndex:(NSUInteger)index token:(nullable STPToken *)token error:(nullable NSError *)error {
+    self.completedCount++;
+    self.progress.completedUnitCount = (int64_t)self.completedCount;
+    STPTokenBatchItemCompletionBlock itemCompletion = self.itemCompletion;
+    if (itemCompletion) {
+        dispatch_async(self.apiClient.completionQueue, ^{
+            itemCompletion(index, token, error);
+        });
+    }
+}
+
+- (void)cancel {
+    dispatch_async(self.queue, ^{
+        if (self.cancelled) {
+            return;
+        }
+        self.cancelled = YES;
+        NSError *cancelledError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+        while (self.nextIndex < self.cards.count) {
+            NSUInteger index = self.nextIndex++;
+            self.results[index] = cancelledError;
+            [self reportCardAtIndex:index token:nil error:cancelledError];
+        }
+        // These finish with NSURLErrorCancelled errors of their own
+        for (NSURLSessionDataTask *task in self.tasks.allValues) {
+            [task cancel];
+        }
+        [self finishIfDone];
+    });
+}
+
+- (void)finishIfDone {
+    if (self.completedCount < self.cards.count || !self.completion) {
+        return;
+    }
+    STPSignpostIntervalEnd("Token batch", self);
+    [[STPAnalyticsClient sharedClient] logTokenBatchCreationWithConfiguration:self.configuration
+                                                                        count:self.cards.count
+                                                                    succeeded:self.succeededCount
+                                                                        start:self.startTime
+                                                                          end:[NSDate date]];
+    STPTokenBatchCompletionBlock completion = self.completion;
+    // Only finish once
+    self.completion = nil;
+    NSArray *results = [self.results copy];
+    dispatch_async(self.apiClient.completionQueue, ^{
+        completion(results);
+    });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
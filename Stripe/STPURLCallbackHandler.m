@@ -31,15 +31,54 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 @interface STPURLCallback : NSObject
-@property (nonatomic) NSURLComponents *urlComponents;
+/**
+ The registered URL's query items, parsed once. A URL in the same group
+ matches if it has all of them.
+ */
+@property (nonatomic, copy) NSDictionary<NSString *, NSString *> *queryItems;
 @property (nonatomic) id<STPURLCallbackListener> listener;
 @end
 
 @implementation STPURLCallback
+
+- (BOOL)matchesQueryItems:(NSDictionary<NSString *, NSString *> *)queryItems {
+    __block BOOL matches = YES;
+    [self.queryItems enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSString *value, BOOL *stop) {
+        if (![queryItems[name] isEqualToString:value]) {
+            matches = NO;
+            *stop = YES;
+        }
+    }];
+    return matches;
+}
+
 @end
 
+/**
+ Callbacks can only match URLs with the same scheme, host and path, so they
+ are grouped by those. Returns nil for components that can never match.
+ */
+static NSString * _Nullable STPURLCallbackKey(NSURLComponents *components) {
+    NSString *scheme = components.scheme;
+    NSString *host = components.host;
+    NSString *path = components.path;
+    if (!scheme || !host || !path) {
+        return nil;
+    }
+    // Hosts can't contain a slash, and paths after a host start with one,
+    // so this is unambiguous.
+    return [NSString stringWithFormat:@"%@://%@%@", scheme, host, path];
+}
+
 @interface STPURLCallbackHandler ()
-@property (nonatomic) NSArray <STPURLCallback *> *callbacks;
+/**
+ An immutable snapshot, replaced whenever listeners change, so that handling
+ a URL never has to wait on or copy anything.
+ */
+@property (atomic, copy) NSDictionary<NSString *, NSArray<STPURLCallback *> *> *callbacksByKey;
+// Which groups each listener is in, so unregistering only touches those.
+@property (nonatomic) NSMapTable<id<STPURLCallbackListener>, NSMutableSet<NSString *> *> *keysByListener;
+@property (nonatomic) dispatch_queue_t listenersQueue;
 @end
 
 @implementation STPURLCallbackHandler
@@ -57,7 +96,10 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)init {
     self = [super init];
     if (self) {
-        _callbacks = [NSArray new];
+        _callbacksByKey = @{};
+        _keysByListener = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)
+                                                valueOptions:NSPointerFunctionsStrongMemory];
+        _listenersQueue = dispatch_queue_create("com.stripe.urlcallbackhandler", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
@@ -66,11 +108,23 @@ NS_ASSUME_NONNULL_BEGIN
 
     NSURLComponents *components = [[NSURLComponents alloc] initWithURL:url
                                                resolvingAgainstBaseURL:NO];
+    NSString *key = STPURLCallbackKey(components);
+    if (!key) {
+        return NO;
+    }
 
+    NSArray<STPURLCallback *> *callbacks = self.callbacksByKey[key];
+    if (callbacks.count == 0) {
+        return NO;
+    }
+
+    // Everything in the group already shares the scheme, host and path, so
+    // only the query items are left to compare, and they're parsed once.
+    NSDictionary<NSString *, NSString *> *queryItems = components.stp_queryItemsDictionary;
     BOOL resultsOrred = NO;
 
-    for (STPURLCallback *callback in self.callbacks) {
-        if ([callback.urlComponents stp_matchesURLComponents:components]) {
+    for (STPURLCallback *callback in callbacks) {
+        if ([callback matchesQueryItems:queryItems]) {
             resultsOrred |= [callback.listener handleURLCallback:url];
         }
     }
@@ -83,27 +137,48 @@ NS_ASSUME_NONNULL_BEGIN
 
     STPURLCallback *callback = [STPURLCallback new];
     callback.listener = listener;
-    callback.urlComponents = [[NSURLComponents alloc] initWithURL:url
-                                          resolvingAgainstBaseURL:NO];
-
-    if (callback.listener && callback.urlComponents) {
-        NSMutableArray <STPURLCallback *> *callbacksCopy = self.callbacks.mutableCopy;
-        [callbacksCopy addObject:callback];
-        self.callbacks = callbacksCopy.copy;
+    NSURLComponents *components = [[NSURLComponents alloc] initWithURL:url
+                                               resolvingAgainstBaseURL:NO];
+    callback.queryItems = components.stp_queryItemsDictionary;
+    NSString *key = STPURLCallbackKey(components);
+
+    if (callback.listener && key) {
+        dispatch_sync(self.listenersQueue, ^{
+            NSMutableDictionary *callbacksByKey = [self.callbacksByKey mutableCopy];
+            NSArray<STPURLCallback *> *callbacks = callbacksByKey[key] ?: @[];
+            callbacksByKey[key] = [callbacks arrayByAddingObject:callback];
+            self.callbacksByKey = callbacksByKey;
+
+            NSMutableSet<NSString *> *keys = [self.keysByListener objectForKey:listener];
+            if (!keys) {
+                keys = [NSMutableSet set];
+                [self.keysByListener setObject:keys forKey:listener];
+            }
+            [keys addObject:key];
+        });
     }
 }
 
 - (void)unregisterListener:(id<STPURLCallbackListener>)listener {
-    NSMutableArray *callbacksToRemove = [NSMutableArray new];
-
-    for (STPURLCallback *callback in self.callbacks) {
-        if (listener == callback.listener) {
-            [callbacksToRemove addObject:callback];
+    dispatch_sync(self.listenersQueue, ^{
+        NSSet<NSString *> *keys = [self.keysByListener objectForKey:listener];
+        if (!keys) {
+            return;
         }
-    }
-    NSMutableArray <STPURLCallback *> *callbacksCopy = self.callbacks.mutableCopy;
-    [callbacksCopy removeObjectsInArray:callbacksToRemove];
-    self.callbacks = callbacksCopy.copy;
+        NSMutableDictionary *callbacksByKey = [self.callbacksByKey mutableCopy];
+        for (NSString *key in keys) {
+            NSIndexSet *remaining = [callbacksByKey[key] indexesOfObjectsPassingTest:^BOOL(STPURLCallback *callback, __unused NSUInteger idx, __unused BOOL *stop) {
+                return callback.listener != listener;
+            }];
+            if (remaining.count > 0) {
+                callbacksByKey[key] = [callbacksByKey[key] objectsAtIndexes:remaining];
+            } else {
+                [callbacksByKey removeObjectForKey:key];
+            }
+        }
+        self.callbacksByKey = callbacksByKey;
+        [self.keysByListener removeObjectForKey:listener];
+    });
 }
 
 @end
@@ -0,0 +1,61 @@
+//
+//  STPURLSessionPool.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Vends NSURLSessions shared by every client that talks to the same host with
+ the same headers, so they also share connections (and their TLS handshakes).
+ Credentials that differ between clients, like the publishable key, belong on
+ each request instead of in `additionalHeaders`. Connections to hosts with
+ pins in STPPublicKeyPins are checked against them.
+ */
+@interface STPURLSessionPool : NSObject
+
++ (instancetype)sharedPool;
+
+/**
+ Returns the session for `host` and `additionalHeaders`, creating it from the
+ default session configuration the first time it is requested. Sessions live
+ for the lifetime of the pool.
+ */
+- (NSURLSession *)sessionForHost:(NSString *)host
+               additionalHeaders:(nullable NSDictionary<NSString *, NSString *> *)additionalHeaders;
+
+/**
+ Like `sessionForHost:additionalHeaders:`, for a session whose traffic is
+ marked with `networkServiceType`. Sessions for the same host and headers
+ with different service types are kept apart.
+ */
+- (NSURLSession *)sessionForHost:(NSString *)host
+               additionalHeaders:(nullable NSDictionary<NSString *, NSString *> *)additionalHeaders
+              networkServiceType:(NSURLRequestNetworkServiceType)networkServiceType;
+
+/**
+ Calls `handler` with the metrics the URL session collected for `task`,
+ removing them from the pool. Sessions usually report metrics before they call
+ a task's completion handler, in which case `handler` runs before this
+ returns; otherwise it runs on the session's delegate queue once they arrive.
+ Never called before iOS 10, or for tasks that didn't come from one of the
+ pool's sessions.
+ */
+- (void)takeMetricsForTask:(NSURLSessionTask *)task handler:(void (^)(NSURLSessionTaskMetrics *taskMetrics))handler NS_AVAILABLE_IOS(10_0);
+
+@end
+
+/**
+ The transaction in `taskMetrics` that produced the response: the last one
+ loaded from the network with a response, skipping redirects, cache hits and
+ attempts that failed before a response arrived. Falls back to the last
+ transaction with a response, then to nil.
+ */
+FOUNDATION_EXTERN NSURLSessionTaskTransactionMetrics * _Nullable STPResponseTransactionMetrics(NSURLSessionTaskMetrics * _Nullable taskMetrics) NS_AVAILABLE_IOS(10_0);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,149 @@
+//
+//  STPURLSessionPool.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPURLSessionPool.h"
+
+#import "STPExtensionMode.h"
+#import "STPMemoryAccounting.h"
+#import "STPPublicKeyPins.h"
+
+@interface STPURLSessionPool ()<NSURLSessionTaskDelegate>
+@property (nonatomic) NSMutableDictionary<NSString *, NSURLSession *> *sessions;
+@property (nonatomic) dispatch_queue_t sessionsQueue;
+/**
+ Metrics waiting to be claimed with -takeMetricsForTask:handler:. Keyed
+ weakly, so metrics for tasks nobody asks about go away with the task.
+ */
+@property (nonatomic) NSMapTable<NSURLSessionTask *, id> *taskMetrics;
+/**
+ Handlers waiting for metrics the session hasn't delivered yet, keyed weakly
+ like `taskMetrics`.
+ */
+@property (nonatomic) NSMapTable<NSURLSessionTask *, id> *metricsHandlers;
+@end
+
+NSURLSessionTaskTransactionMetrics *STPResponseTransactionMetrics(NSURLSessionTaskMetrics *taskMetrics) {
+    NSURLSessionTaskTransactionMetrics *fallback;
+    for (NSURLSessionTaskTransactionMetrics *transaction in taskMetrics.transactionMetrics.reverseObjectEnumerator) {
+        if (!transaction.response) {
+            continue;
+        }
+        if (transaction.resourceFetchType == NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad) {
+            return transaction;
+        }
+        fallback = fallback ?: transaction;
+    }
+    return fallback;
+}
+
+@implementation STPURLSessionPool
+
++ (instancetype)sharedPool {
+    static id sharedPool;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ sharedPool = [[self alloc] init]; });
+    return sharedPool;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _sessions = [NSMutableDictionary dictionary];
+        _sessionsQueue = dispatch_queue_create("com.stripe.urlsessionpool", DISPATCH_QUEUE_SERIAL);
+        _taskMetrics = [NSMapTable weakToStrongObjectsMapTable];
+        _metricsHandlers = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+- (NSURLSession *)sessionForHost:(NSString *)host
+               additionalHeaders:(NSDictionary<NSString *, NSString *> *)additionalHeaders {
+    return [self sessionForHost:host
+              additionalHeaders:additionalHeaders
+             networkServiceType:NSURLNetworkServiceTypeDefault];
+}
+
+- (NSURLSession *)sessionForHost:(NSString *)host
+               additionalHeaders:(NSDictionary<NSString *, NSString *> *)additionalHeaders
+              networkServiceType:(NSURLRequestNetworkServiceType)networkServiceType {
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%lu %@", (unsigned long)networkServiceType, host.lowercaseString];
+    for (NSString *field in [additionalHeaders.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        [key appendFormat:@"\n%@: %@", field.lowercaseString, additionalHeaders[field]];
+    }
+
+    __block NSURLSession *session;
+    dispatch_sync(self.sessionsQueue, ^{
+        session = self.sessions[key];
+        if (!session) {
+            NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+            configuration.HTTPAdditionalHeaders = additionalHeaders;
+            configuration.networkServiceType = networkServiceType;
+            if (stpExtensionModeEnabled()) {
+                // API responses aren't reused, so a cache would only cost memory
+                configuration.URLCache = nil;
+                configuration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+            }
+            // Sessions live as long as the pool, so it's safe for them to
+            // retain it as their delegate.
+            session = [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:nil];
+            self.sessions[key] = session;
+            [STPMemoryAccounting trackObject:session category:STPMemoryCategoryURLSessions];
+        }
+    });
+    return session;
+}
+
+- (void)takeMetricsForTask:(NSURLSessionTask *)task handler:(void (^)(NSURLSessionTaskMetrics *))handler {
+    __block NSURLSessionTaskMetrics *metrics;
+    dispatch_sync(self.sessionsQueue, ^{
+        metrics = [self.taskMetrics objectForKey:task];
+        if (metrics) {
+            [self.taskMetrics removeObjectForKey:task];
+        } else {
+            [self.metricsHandlers setObject:[handler copy] forKey:task];
+        }
+    });
+    if (metrics) {
+        handler(metrics);
+    }
+}
+
+#pragma mark - NSURLSessionDelegate
+
+- (void)URLSession:(__unused NSURLSession *)session didReceiveChallenge:(NSURLAuthenticationChallenge *)challenge completionHandler:(void (^)(NSURLSessionAuthChallengeDisposition, NSURLCredential *))completionHandler {
+    NSURLProtectionSpace *protectionSpace = challenge.protectionSpace;
+    STPPublicKeyPins *pins = [STPPublicKeyPins sharedPins];
+    if (![protectionSpace.authenticationMethod isEqualToString:NSURLAuthenticationMethodServerTrust] || ![pins hasPinsForHost:protectionSpace.host]) {
+        completionHandler(NSURLSessionAuthChallengePerformDefaultHandling, nil);
+        return;
+    }
+    if ([pins evaluateServerTrust:protectionSpace.serverTrust forHost:protectionSpace.host]) {
+        completionHandler(NSURLSessionAuthChallengeUseCredential, [NSURLCredential credentialForTrust:protectionSpace.serverTrust]);
+    } else {
+        completionHandler(NSURLSessionAuthChallengeCancelAuthenticationChallenge, nil);
+    }
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+
+- (void)URLSession:(__unused NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics NS_AVAILABLE_IOS(10_0) {
+    __block void (^handler)(NSURLSessionTaskMetrics *);
+    dispatch_sync(self.sessionsQueue, ^{
+        handler = [self.metricsHandlers objectForKey:task];
+        if (handler) {
+            [self.metricsHandlers removeObjectForKey:task];
+        } else {
+            [self.taskMetrics setObject:metrics forKey:task];
+        }
+    });
+    if (handler) {
+        handler(metrics);
+    }
+}
+
+@end
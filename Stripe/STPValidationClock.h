@@ -0,0 +1,44 @@
+//
+//  STPValidationClock.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Caches the Gregorian year and month used to validate card expiration dates,
+ so validating on every keystroke doesn't need to create an NSCalendar.
+ Safe to read from any thread.
+ */
+@interface STPValidationClock : NSObject
+
+/**
+ A clock that follows the system date. It refreshes when the day changes and
+ on significant time changes (e.g. time zone or system clock changes).
+ */
++ (instancetype)sharedClock;
+
+/**
+ A clock pinned to `date`, for tests and batch validation against a fixed
+ reference date. It never refreshes itself.
+ */
+- (instancetype)initWithDate:(NSDate *)date;
+
+/**
+ The last two digits of the current year, e.g. 17 for 2017.
+ */
+@property (nonatomic, readonly) NSInteger currentYear;
+
+/**
+ The current month, from 1 to 12.
+ */
+@property (nonatomic, readonly) NSInteger currentMonth;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,82 @@
+//
+//  STPValidationClock.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPValidationClock.h"
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface STPValidationClock ()
+
+/**
+ Year and month packed into one value (year * 100 + month) so that readers
+ never see a year from one refresh and a month from another.
+ */
+@property (atomic) NSInteger packedYearMonth;
+
+@end
+
+@implementation STPValidationClock
+
++ (instancetype)sharedClock {
+    static STPValidationClock *sharedClock;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedClock = [[self alloc] initWithDate:[NSDate date]];
+        [sharedClock startObservingTimeChanges];
+    });
+    return sharedClock;
+}
+
+- (instancetype)initWithDate:(NSDate *)date {
+    self = [super init];
+    if (self) {
+        [self updateWithDate:date];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)startObservingTimeChanges {
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    for (NSString *name in @[NSCalendarDayChangedNotification,
+                             NSSystemClockDidChangeNotification,
+                             NSSystemTimeZoneDidChangeNotification,
+                             UIApplicationSignificantTimeChangeNotification]) {
+        [notificationCenter addObserver:self
+                               selector:@selector(handleTimeChange)
+                                   name:name
+                                 object:nil];
+    }
+}
+
+- (void)handleTimeChange {
+    [self updateWithDate:[NSDate date]];
+}
+
+- (void)updateWithDate:(NSDate *)date {
+    NSCalendar *calendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+    NSDateComponents *dateComponents = [calendar components:(NSCalendarUnitYear | NSCalendarUnitMonth) fromDate:date];
+    self.packedYearMonth = (dateComponents.year % 100) * 100 + dateComponents.month;
+}
+
+- (NSInteger)currentYear {
+    return self.packedYearMonth / 100;
+}
+
+- (NSInteger)currentMonth {
+    return self.packedYearMonth % 100;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
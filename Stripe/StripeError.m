@@ -27,65 +27,120 @@ NSString *const STPCardDeclined = @"com.stripe.lib:CardDeclined";
 NSString *const STPProcessingError = @"com.stripe.lib:ProcessingError";
 NSString *const STPIncorrectCVC = @"com.stripe.lib:IncorrectCVC";
 
+/**
+ The user-facing messages a Stripe error can carry, so that the card error
+ table only localizes the one an error needs.
+ */
+typedef NS_ENUM(NSInteger, STPErrorUserMessage) {
+    STPErrorUserMessageNone = 0,
+    STPErrorUserMessageUnexpected,
+    STPErrorUserMessageInvalidNumber,
+    STPErrorUserMessageInvalidCVC,
+    STPErrorUserMessageInvalidExpMonth,
+    STPErrorUserMessageInvalidExpYear,
+    STPErrorUserMessageExpiredCard,
+    STPErrorUserMessageDeclined,
+    STPErrorUserMessageProcessingError,
+};
+
+static NSString *const STPCardErrorMappingCodeKey = @"code";
+static NSString *const STPCardErrorMappingMessageKey = @"message";
+
 @implementation NSError(Stripe)
 
++ (NSDictionary<NSString *, NSNumber *> *)stp_errorCodesByType {
+    static NSDictionary<NSString *, NSNumber *> *errorCodes;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        errorCodes = @{
+                       @"api_error": @(STPAPIError),
+                       @"invalid_request_error": @(STPInvalidRequestError),
+                       @"card_error": @(STPCardError),
+                       };
+    });
+    return errorCodes;
+}
+
++ (NSDictionary<NSString *, NSDictionary *> *)stp_cardErrorMappingsByCode {
+    static NSDictionary<NSString *, NSDictionary *> *mappings;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mappings = @{
+                     @"incorrect_number": @{STPCardErrorMappingCodeKey: STPIncorrectNumber, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidNumber)},
+                     @"invalid_number": @{STPCardErrorMappingCodeKey: STPInvalidNumber, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidNumber)},
+                     @"invalid_expiry_month": @{STPCardErrorMappingCodeKey: STPInvalidExpMonth, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidExpMonth)},
+                     @"invalid_expiry_year": @{STPCardErrorMappingCodeKey: STPInvalidExpYear, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidExpYear)},
+                     @"invalid_cvc": @{STPCardErrorMappingCodeKey: STPInvalidCVC, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidCVC)},
+                     @"expired_card": @{STPCardErrorMappingCodeKey: STPExpiredCard, STPCardErrorMappingMessageKey: @(STPErrorUserMessageExpiredCard)},
+                     @"incorrect_cvc": @{STPCardErrorMappingCodeKey: STPIncorrectCVC, STPCardErrorMappingMessageKey: @(STPErrorUserMessageInvalidCVC)},
+                     @"card_declined": @{STPCardErrorMappingCodeKey: STPCardDeclined, STPCardErrorMappingMessageKey: @(STPErrorUserMessageDeclined)},
+                     @"processing_error": @{STPCardErrorMappingCodeKey: STPProcessingError, STPCardErrorMappingMessageKey: @(STPErrorUserMessageProcessingError)},
+                     };
+    });
+    return mappings;
+}
+
++ (nullable NSString *)stp_stringForUserMessage:(STPErrorUserMessage)userMessage {
+    switch (userMessage) {
+        case STPErrorUserMessageNone:
+            return nil;
+        case STPErrorUserMessageUnexpected:
+            return [self stp_unexpectedErrorMessage];
+        case STPErrorUserMessageInvalidNumber:
+            return [self stp_cardErrorInvalidNumberUserMessage];
+        case STPErrorUserMessageInvalidCVC:
+            return [self stp_cardInvalidCVCUserMessage];
+        case STPErrorUserMessageInvalidExpMonth:
+            return [self stp_cardErrorInvalidExpMonthUserMessage];
+        case STPErrorUserMessageInvalidExpYear:
+            return [self stp_cardErrorInvalidExpYearUserMessage];
+        case STPErrorUserMessageExpiredCard:
+            return [self stp_cardErrorExpiredCardUserMessage];
+        case STPErrorUserMessageDeclined:
+            return [self stp_cardErrorDeclinedUserMessage];
+        case STPErrorUserMessageProcessingError:
+            return [self stp_cardErrorProcessingErrorUserMessage];
+    }
+    return nil;
+}
+
 + (NSError *)stp_errorFromStripeResponse:(NSDictionary *)jsonDictionary {
+    // Most responses are successes, so get out before doing any other work.
+    if (![jsonDictionary isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
     NSDictionary *errorDictionary = jsonDictionary[@"error"];
-    if (!errorDictionary) {
+    if (![errorDictionary isKindOfClass:[NSDictionary class]]) {
         return nil;
     }
     NSString *errorType = errorDictionary[@"type"];
     NSString *errorParam = errorDictionary[@"param"];
     NSString *stripeErrorMessage = errorDictionary[@"message"];
     NSString *stripeErrorCode = errorDictionary[@"code"];
-    NSInteger code = 0;
+    NSNumber *typeCode = errorType ? [self stp_errorCodesByType][errorType] : nil;
+    NSInteger code = typeCode ? typeCode.integerValue : STPAPIError;
 
-    NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithCapacity:6];
     userInfo[STPStripeErrorCodeKey] = stripeErrorCode;
     userInfo[STPStripeErrorTypeKey] = errorType;
     if (errorParam) {
         userInfo[STPErrorParameterKey] = [STPFormEncoder stringByReplacingSnakeCaseWithCamelCase:errorParam];
     }
-    if (stripeErrorMessage) {
-        userInfo[NSLocalizedDescriptionKey] = stripeErrorMessage;
-        userInfo[STPErrorMessageKey] = stripeErrorMessage;
-    } else {
-        userInfo[NSLocalizedDescriptionKey] = [self stp_unexpectedErrorMessage];
-        userInfo[STPErrorMessageKey] = @"Could not interpret the error response that was returned from Stripe.";
-    }
+    userInfo[STPErrorMessageKey] = stripeErrorMessage ?: @"Could not interpret the error response that was returned from Stripe.";
+
+    STPErrorUserMessage userMessage = stripeErrorMessage ? STPErrorUserMessageNone : STPErrorUserMessageUnexpected;
     if ([errorType isEqualToString:@"api_error"]) {
-        code = STPAPIError;
-        userInfo[NSLocalizedDescriptionKey] = [self stp_unexpectedErrorMessage];
+        userMessage = STPErrorUserMessageUnexpected;
     } else {
-        if ([errorType isEqualToString:@"invalid_request_error"]) {
-            code = STPInvalidRequestError;
-        } else if ([errorType isEqualToString:@"card_error"]) {
-            code = STPCardError;
-        } else {
-            code = STPAPIError;
-        }
-        NSDictionary *codeMap = @{
-                                  @"incorrect_number": @{@"code": STPIncorrectNumber, @"message": [self stp_cardErrorInvalidNumberUserMessage]},
-                                  @"invalid_number": @{@"code": STPInvalidNumber, @"message": [self stp_cardErrorInvalidNumberUserMessage]},
-                                  @"invalid_expiry_month": @{@"code": STPInvalidExpMonth, @"message": [self stp_cardErrorInvalidExpMonthUserMessage]},
-                                  @"invalid_expiry_year": @{@"code": STPInvalidExpYear, @"message": [self stp_cardErrorInvalidExpYearUserMessage]},
-                                  @"invalid_cvc": @{@"code": STPInvalidCVC, @"message": [self stp_cardInvalidCVCUserMessage]},
-                                  @"expired_card": @{@"code": STPExpiredCard, @"message": [self stp_cardErrorExpiredCardUserMessage]},
-                                  @"incorrect_cvc": @{@"code": STPIncorrectCVC, @"message": [self stp_cardInvalidCVCUserMessage]},
-                                  @"card_declined": @{@"code": STPCardDeclined, @"message": [self stp_cardErrorDeclinedUserMessage]},
-                                  @"processing_error": @{@"code": STPProcessingError, @"message": [self stp_cardErrorProcessingErrorUserMessage]},
-                                  };
-        NSDictionary *codeMapEntry = codeMap[stripeErrorCode];
-        NSDictionary *cardErrorCode = codeMapEntry[@"code"];
-        NSString *localizedMessage = codeMapEntry[@"message"];
-        if (cardErrorCode) {
-            userInfo[STPCardErrorCodeKey] = cardErrorCode;
-        }
-        if (localizedMessage) {
-            userInfo[NSLocalizedDescriptionKey] = codeMapEntry[@"message"];
+        NSDictionary *mapping = stripeErrorCode ? [self stp_cardErrorMappingsByCode][stripeErrorCode] : nil;
+        if (mapping) {
+            userInfo[STPCardErrorCodeKey] = mapping[STPCardErrorMappingCodeKey];
+            userMessage = (STPErrorUserMessage)[mapping[STPCardErrorMappingMessageKey] integerValue];
         }
     }
 
+    userInfo[NSLocalizedDescriptionKey] = userMessage == STPErrorUserMessageNone ? stripeErrorMessage : [self stp_stringForUserMessage:userMessage];
+
     return [[self alloc] initWithDomain:StripeDomain code:code userInfo:userInfo];
 }
 
@@ -16,6 +16,16 @@
 - (void)stp_setFakeSeparatorLeftInset:(CGFloat)leftInset;
 - (void)stp_setFakeSeparatorColor:(UIColor *)color;
 
+/**
+ *  Applies every border setting in one pass, skipping any that already match the
+ *  cell's current state. Prefer this from `tableView:willDisplayCell:forRowAtIndexPath:`.
+ */
+- (void)stp_setBorderColor:(UIColor *)borderColor
+        fakeSeparatorColor:(UIColor *)fakeSeparatorColor
+    fakeSeparatorLeftInset:(CGFloat)leftInset
+           topBorderHidden:(BOOL)topBorderHidden
+        bottomBorderHidden:(BOOL)bottomBorderHidden;
+
 @end
 
 void linkUITableViewCellBordersCategory(void);
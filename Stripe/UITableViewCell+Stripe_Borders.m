@@ -6,75 +6,166 @@
 //  Copyright © 2016 Stripe, Inc. All rights reserved.
 //
 
+#import <objc/runtime.h>
+
 #import "UITableViewCell+Stripe_Borders.h"
 
 static NSInteger const STPTableViewCellTopBorderTag = 787473;
 static NSInteger const STPTableViewCellBottomBorderTag = 787474;
 static NSInteger const STPTableViewCellFakeSeparatorTag = 787475;
 
+static char kSTPTableViewCellBordersKey;
+
+/**
+ *  Holds a cell's border views so they can be reached without walking the
+ *  content view's hierarchy with `viewWithTag:` every time a cell is displayed.
+ */
+@interface STPTableViewCellBorders : NSObject {
+    @public
+    UIView *_topBorderView;
+    UIView *_bottomBorderView;
+    UIView *_fakeSeparatorView;
+    CGFloat _fakeSeparatorLeftInset;
+    CGRect _fakeSeparatorCellBounds;
+}
+@end
+
+@implementation STPTableViewCellBorders
+@end
+
 @implementation UITableViewCell (Stripe_Borders)
 
-- (UIView *)stp_topBorderView {
-    UIView *view = [self.contentView viewWithTag:STPTableViewCellTopBorderTag];
-    if (!view) {
-        view = [[UIView alloc] initWithFrame:CGRectMake(0, 0, self.bounds.size.width, 0.5f)];
+- (STPTableViewCellBorders *)stp_borders {
+    STPTableViewCellBorders *borders = objc_getAssociatedObject(self, &kSTPTableViewCellBordersKey);
+    if (!borders) {
+        borders = [STPTableViewCellBorders new];
+        borders->_fakeSeparatorLeftInset = -1;
+        objc_setAssociatedObject(self, &kSTPTableViewCellBordersKey, borders, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return borders;
+}
+
+- (UIView *)stp_topBorderViewInBorders:(STPTableViewCellBorders *)borders {
+    if (!borders->_topBorderView) {
+        UIView *view = [[UIView alloc] initWithFrame:CGRectMake(0, 0, self.bounds.size.width, 0.5f)];
         view.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleBottomMargin;
         view.tag = STPTableViewCellTopBorderTag;
         view.backgroundColor = self.backgroundColor;
         view.hidden = YES;
         view.accessibilityIdentifier = @"stp_topBorderView";
         [self.contentView addSubview:view];
+        borders->_topBorderView = view;
     }
-    return view;
+    return borders->_topBorderView;
 }
 
-- (UIView *)stp_bottomBorderView {
-    UIView *view = [self.contentView viewWithTag:STPTableViewCellBottomBorderTag];
-    if (!view) {
-        view = [[UIView alloc] initWithFrame:CGRectMake(0, self.bounds.size.height - 0.5f, self.bounds.size.width, 0.5f)];
+- (UIView *)stp_bottomBorderViewInBorders:(STPTableViewCellBorders *)borders {
+    if (!borders->_bottomBorderView) {
+        UIView *view = [[UIView alloc] initWithFrame:CGRectMake(0, self.bounds.size.height - 0.5f, self.bounds.size.width, 0.5f)];
         view.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleTopMargin;
         view.tag = STPTableViewCellBottomBorderTag;
         view.backgroundColor = self.backgroundColor;
         view.hidden = YES;
         view.accessibilityIdentifier = @"stp_bottomBorderView";
         [self.contentView addSubview:view];
+        borders->_bottomBorderView = view;
     }
-    return view;
+    return borders->_bottomBorderView;
 }
 
-- (UIView *)stp_fakeSeparatorView {
-    UIView *view = [self.contentView viewWithTag:STPTableViewCellFakeSeparatorTag];
-    if (!view) {
-        view = [[UIView alloc] initWithFrame:CGRectMake(0, self.bounds.size.height - 0.5f, self.bounds.size.width, 0.5f)];
+- (UIView *)stp_fakeSeparatorViewInBorders:(STPTableViewCellBorders *)borders {
+    if (!borders->_fakeSeparatorView) {
+        UIView *view = [[UIView alloc] initWithFrame:CGRectMake(0, self.bounds.size.height - 0.5f, self.bounds.size.width, 0.5f)];
         view.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleTopMargin;
         view.tag = STPTableViewCellFakeSeparatorTag;
         view.backgroundColor = self.backgroundColor;
         view.accessibilityIdentifier = @"stp_fakeSeparatorView";
         [self.contentView addSubview:view];
+        borders->_fakeSeparatorView = view;
+    }
+    return borders->_fakeSeparatorView;
+}
+
+- (UIView *)stp_topBorderView {
+    return [self stp_topBorderViewInBorders:[self stp_borders]];
+}
+
+- (UIView *)stp_bottomBorderView {
+    return [self stp_bottomBorderViewInBorders:[self stp_borders]];
+}
+
+- (UIView *)stp_fakeSeparatorView {
+    return [self stp_fakeSeparatorViewInBorders:[self stp_borders]];
+}
+
+static void STPSetViewBackgroundColor(UIView *view, UIColor *color) {
+    if (view.backgroundColor != color && ![view.backgroundColor isEqual:color]) {
+        view.backgroundColor = color;
     }
-    return view;
+}
+
+static void STPSetViewHidden(UIView *view, BOOL hidden) {
+    if (view.hidden != hidden) {
+        view.hidden = hidden;
+    }
+}
+
+- (void)stp_setFakeSeparatorLeftInset:(CGFloat)leftInset inBorders:(STPTableViewCellBorders *)borders {
+    CGRect bounds = self.bounds;
+    // The frame only depends on the inset and the cell's bounds, so skip the
+    // layer geometry update when neither has changed since the last call.
+    if (borders->_fakeSeparatorView
+        && !isless(leftInset, borders->_fakeSeparatorLeftInset)
+        && !isgreater(leftInset, borders->_fakeSeparatorLeftInset)
+        && CGRectEqualToRect(bounds, borders->_fakeSeparatorCellBounds)) {
+        return;
+    }
+    [self stp_fakeSeparatorViewInBorders:borders].frame = CGRectMake(leftInset, bounds.size.height - 0.5f, bounds.size.width - leftInset, 0.5f);
+    borders->_fakeSeparatorLeftInset = leftInset;
+    borders->_fakeSeparatorCellBounds = bounds;
 }
 
 - (void)stp_setBorderColor:(UIColor *)color {
-    [self stp_topBorderView].backgroundColor = color;
-    [self stp_bottomBorderView].backgroundColor = color;
+    STPTableViewCellBorders *borders = [self stp_borders];
+    STPSetViewBackgroundColor([self stp_topBorderViewInBorders:borders], color);
+    STPSetViewBackgroundColor([self stp_bottomBorderViewInBorders:borders], color);
 }
 
 - (void)stp_setTopBorderHidden:(BOOL)hidden {
-    [self stp_topBorderView].hidden = hidden;
+    STPSetViewHidden([self stp_topBorderView], hidden);
 }
 
 - (void)stp_setBottomBorderHidden:(BOOL)hidden {
-    [self stp_bottomBorderView].hidden = hidden;
-    [self stp_fakeSeparatorView].hidden = !hidden;
+    STPTableViewCellBorders *borders = [self stp_borders];
+    STPSetViewHidden([self stp_bottomBorderViewInBorders:borders], hidden);
+    STPSetViewHidden([self stp_fakeSeparatorViewInBorders:borders], !hidden);
 }
 
 - (void)stp_setFakeSeparatorColor:(UIColor *)color {
-    [self stp_fakeSeparatorView].backgroundColor = color;
+    STPSetViewBackgroundColor([self stp_fakeSeparatorView], color);
 }
 
 - (void)stp_setFakeSeparatorLeftInset:(CGFloat)leftInset {
-    [self stp_fakeSeparatorView].frame = CGRectMake(leftInset, self.bounds.size.height - 0.5f, self.bounds.size.width - leftInset, 0.5f);
+    [self stp_setFakeSeparatorLeftInset:leftInset inBorders:[self stp_borders]];
+}
+
+- (void)stp_setBorderColor:(UIColor *)borderColor
+        fakeSeparatorColor:(UIColor *)fakeSeparatorColor
+    fakeSeparatorLeftInset:(CGFloat)leftInset
+           topBorderHidden:(BOOL)topBorderHidden
+        bottomBorderHidden:(BOOL)bottomBorderHidden {
+    STPTableViewCellBorders *borders = [self stp_borders];
+    UIView *topBorderView = [self stp_topBorderViewInBorders:borders];
+    UIView *bottomBorderView = [self stp_bottomBorderViewInBorders:borders];
+    UIView *fakeSeparatorView = [self stp_fakeSeparatorViewInBorders:borders];
+
+    STPSetViewBackgroundColor(topBorderView, borderColor);
+    STPSetViewBackgroundColor(bottomBorderView, borderColor);
+    STPSetViewHidden(topBorderView, topBorderHidden);
+    STPSetViewHidden(bottomBorderView, bottomBorderHidden);
+    STPSetViewBackgroundColor(fakeSeparatorView, fakeSeparatorColor);
+    STPSetViewHidden(fakeSeparatorView, !bottomBorderHidden);
+    [self stp_setFakeSeparatorLeftInset:leftInset inBorders:borders];
 }
 
 @end
@@ -11,6 +11,23 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class STPKeyboardDetectingViewController;
+
+/**
+ Listens for keyboard and text field notifications once for the whole app,
+ and passes them on only to the keyboard detecting view controllers that are
+ on screen. Every other text field in the app then costs Stripe nothing.
+ */
+@interface STPKeyboardTracker : NSObject
+@property(nonatomic)NSHashTable<STPKeyboardDetectingViewController *> *visibleControllers;
+// The last keyboard end frame, in screen coordinates
+@property(nonatomic, assign)CGRect keyboardFrame;
+@property(nonatomic, nullable)NSDictionary *lastKeyboardUserInfo;
++ (instancetype)sharedTracker;
+- (void)addVisibleController:(STPKeyboardDetectingViewController *)controller;
+- (void)removeVisibleController:(STPKeyboardDetectingViewController *)controller;
+@end
+
 // This is a private class that is only a UIViewController subclass by virtue of the fact
 // that that makes it easier to attach to another UIViewController as a child.
 @interface STPKeyboardDetectingViewController : UIViewController
@@ -19,6 +36,68 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic, nullable, copy)STPKeyboardFrameBlock keyboardFrameBlock;
 @property(nonatomic, weak)UIScrollView *managedScrollView;
 @property(nonatomic, assign)CGFloat currentBottomInsetChange;
+- (void)textFieldWillBeginEditing:(UITextField *)textField;
+- (void)keyboardWillChangeFrame:(NSNotification *)notification;
+- (void)doKeyboardChangeAnimationWithNewFrame:(CGRect)keyboardFrame;
+@end
+
+@implementation STPKeyboardTracker
+
++ (instancetype)sharedTracker {
+    static STPKeyboardTracker *tracker;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        tracker = [self new];
+    });
+    return tracker;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _visibleControllers = [NSHashTable weakObjectsHashTable];
+        _keyboardFrame = CGRectNull;
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(keyboardWillChangeFrame:) name:UIKeyboardWillChangeFrameNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(textFieldWillBeginEditing:) name:UITextFieldTextDidBeginEditingNotification object:nil];
+    }
+    return self;
+}
+
+- (void)addVisibleController:(STPKeyboardDetectingViewController *)controller {
+    [self.visibleControllers addObject:controller];
+}
+
+- (void)removeVisibleController:(STPKeyboardDetectingViewController *)controller {
+    [self.visibleControllers removeObject:controller];
+}
+
+- (void)textFieldWillBeginEditing:(NSNotification *)notification {
+    if (self.visibleControllers.count == 0) {
+        return;
+    }
+    UITextField *textField = notification.object;
+    if (![textField isKindOfClass:[UITextField class]]) {
+        return;
+    }
+    for (STPKeyboardDetectingViewController *controller in self.visibleControllers.allObjects) {
+        [controller textFieldWillBeginEditing:textField];
+    }
+}
+
+- (void)keyboardWillChangeFrame:(NSNotification *)notification {
+    CGRect keyboardFrame = [notification.userInfo[UIKeyboardFrameEndUserInfoKey] CGRectValue];
+    // The keyboard often reports the same end frame several times in a row,
+    // e.g. when focus moves between fields.
+    if (CGRectEqualToRect(keyboardFrame, self.keyboardFrame)) {
+        return;
+    }
+    self.keyboardFrame = keyboardFrame;
+    self.lastKeyboardUserInfo = notification.userInfo;
+    for (STPKeyboardDetectingViewController *controller in self.visibleControllers.allObjects) {
+        [controller keyboardWillChangeFrame:notification];
+    }
+}
+
 @end
 
 @implementation STPKeyboardDetectingViewController
@@ -27,8 +106,6 @@ NS_ASSUME_NONNULL_BEGIN
                                 scrollView:(nullable UIScrollView *)scrollView {
     self = [super initWithNibName:nil bundle:nil];
     if (self) {
-        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(keyboardWillChangeFrame:) name:UIKeyboardWillChangeFrameNotification object:nil];
-        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(textFieldWillBeginEditing:) name:UITextFieldTextDidBeginEditingNotification object:nil];
         _keyboardFrameBlock = block;
         _managedScrollView = scrollView;
         _currentBottomInsetChange = 0;
@@ -37,7 +114,7 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 - (void)dealloc {
-    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [[STPKeyboardTracker sharedTracker] removeVisibleController:self];
 }
 
 - (void)loadView {
@@ -47,9 +124,32 @@ NS_ASSUME_NONNULL_BEGIN
     self.view = view;
 }
 
-- (void)textFieldWillBeginEditing:(NSNotification *)notification {
-    UITextField *textField = notification.object;
-    if (![textField isKindOfClass:[UITextField class]] || ![textField isDescendantOfView:self.parentViewController.view]) {
+- (void)viewWillAppear:(BOOL)animated {
+    [super viewWillAppear:animated];
+    [[STPKeyboardTracker sharedTracker] addVisibleController:self];
+}
+
+- (void)viewDidAppear:(BOOL)animated {
+    [super viewDidAppear:animated];
+    // Catch up on keyboard changes made while this screen wasn't showing.
+    // This does nothing if the frame is the one already handled.
+    STPKeyboardTracker *tracker = [STPKeyboardTracker sharedTracker];
+    if (tracker.lastKeyboardUserInfo) {
+        [UIView performWithoutAnimation:^{
+            [self keyboardWillChangeFrame:[NSNotification notificationWithName:UIKeyboardWillChangeFrameNotification
+                                                                         object:nil
+                                                                       userInfo:tracker.lastKeyboardUserInfo]];
+        }];
+    }
+}
+
+- (void)viewDidDisappear:(BOOL)animated {
+    [super viewDidDisappear:animated];
+    [[STPKeyboardTracker sharedTracker] removeVisibleController:self];
+}
+
+- (void)textFieldWillBeginEditing:(UITextField *)textField {
+    if (![textField isDescendantOfView:self.parentViewController.view]) {
         return;
     }
     if (textField != self.lastResponder && self.keyboardFrameBlock && !CGRectIsEmpty(self.lastKeyboardFrame)) {
@@ -142,6 +242,7 @@ NS_ASSUME_NONNULL_BEGIN
                                            onChangeBlock:(nullable STPKeyboardFrameBlock)block {
     STPKeyboardDetectingViewController *existing = [self stp_keyboardDetectingViewController];
     if (existing) {
+        [[STPKeyboardTracker sharedTracker] removeVisibleController:existing];
         [existing removeFromParentViewController];
         [existing.view removeFromSuperview];
         [existing didMoveToParentViewController:nil];
@@ -151,6 +252,11 @@ NS_ASSUME_NONNULL_BEGIN
     [self addChildViewController:keyboardAvoiding];
     [self.view addSubview:keyboardAvoiding.view];
     [keyboardAvoiding didMoveToParentViewController:self];
+    // This is usually called from viewDidAppear:, so don't count on the new
+    // child getting appearance callbacks of its own.
+    if (keyboardAvoiding.view.window) {
+        [[STPKeyboardTracker sharedTracker] addVisibleController:keyboardAvoiding];
+    }
 }
 
 @end
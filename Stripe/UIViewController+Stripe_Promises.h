@@ -12,6 +12,14 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ Promises that complete the first time the view controller's view will appear
+ or did appear, or straight away if it's already on screen.
+
+ `STPCoreViewController` fulfils these from its own lifecycle methods. Any
+ other view controller, e.g. an `STPPaymentContext`'s host, has its appearance
+ methods hooked at runtime the first time a promise is asked for.
+ */
 @interface UIViewController (Stripe_Promises)
 
 @property(nonatomic, readonly)STPVoidPromise *stp_willAppearPromise;
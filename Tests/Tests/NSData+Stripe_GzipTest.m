@@ -0,0 +1,57 @@
+//
+//  NSData+Stripe_GzipTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+
+#import "NSData+Stripe_Gzip.h"
+
+@interface NSData_Stripe_GzipTest : XCTestCase
+
+@end
+
+@implementation NSData_Stripe_GzipTest
+
+- (NSData *)gunzip:(NSData *)data length:(NSUInteger)length {
+    NSMutableData *output = [NSMutableData dataWithLength:length];
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    XCTAssertEqual(inflateInit2(&stream, MAX_WBITS + 16), Z_OK);
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    stream.next_out = output.mutableBytes;
+    stream.avail_out = (uInt)output.length;
+    XCTAssertEqual(inflate(&stream, Z_FINISH), Z_STREAM_END);
+    output.length = stream.total_out;
+    inflateEnd(&stream);
+    return output;
+}
+
+- (void)testRoundTrip {
+    NSMutableString *form = [NSMutableString string];
+    for (NSUInteger i = 0; i < 100; i++) {
+        [form appendFormat:@"metadata[key%lu]=value%lu&", (unsigned long)i, (unsigned long)i];
+    }
+    NSData *data = [form dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *gzipped = [data stp_gzippedData];
+
+    XCTAssertNotNil(gzipped);
+    XCTAssertLessThan(gzipped.length, data.length);
+    const uint8_t *bytes = gzipped.bytes;
+    XCTAssertEqual(bytes[0], 0x1f);
+    XCTAssertEqual(bytes[1], 0x8b);
+    XCTAssertEqualObjects([self gunzip:gzipped length:data.length], data);
+}
+
+- (void)testEmptyData {
+    NSData *gzipped = [[NSData data] stp_gzippedData];
+    XCTAssertNotNil(gzipped);
+    XCTAssertEqual([self gunzip:gzipped length:1].length, 0U);
+}
+
+@end
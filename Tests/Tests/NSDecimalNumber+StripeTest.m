@@ -25,5 +25,36 @@
     XCTAssertEqualObjects(decimalNumber, [NSDecimalNumber decimalNumberWithString:@"1000"]);
 }
 
+- (void)testDecimalAmount_uppercaseCurrency {
+    NSDecimalNumber *decimalNumber = [NSDecimalNumber stp_decimalNumberWithAmount:1000 currency:@"JPY"];
+    XCTAssertEqualObjects(decimalNumber, [NSDecimalNumber decimalNumberWithString:@"1000"]);
+    decimalNumber = [NSDecimalNumber stp_decimalNumberWithAmount:1000 currency:@"Jpy"];
+    XCTAssertEqualObjects(decimalNumber, [NSDecimalNumber decimalNumberWithString:@"1000"]);
+}
+
+- (void)testDecimalAmount_negative {
+    NSDecimalNumber *decimalNumber = [NSDecimalNumber stp_decimalNumberWithAmount:-1050 currency:@"usd"];
+    XCTAssertEqualObjects(decimalNumber, [NSDecimalNumber decimalNumberWithString:@"-10.50"]);
+}
+
+- (void)testAmountWithCurrency {
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"10.50"] stp_amountWithCurrency:@"usd"], 1050);
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"0.29"] stp_amountWithCurrency:@"USD"], 29);
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"1000"] stp_amountWithCurrency:@"jpy"], 1000);
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"-3.25"] stp_amountWithCurrency:@"usd"], -325);
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"1.999"] stp_amountWithCurrency:@"usd"], 199);
+    XCTAssertEqual([[NSDecimalNumber zero] stp_amountWithCurrency:@"usd"], 0);
+    XCTAssertEqual([[NSDecimalNumber decimalNumberWithString:@"1e3"] stp_amountWithCurrency:@"usd"], 100000);
+}
+
+- (void)testAmountRoundTrip {
+    for (NSString *currency in @[@"usd", @"jpy"]) {
+        for (NSNumber *amount in @[@0, @1, @99, @-1050, @123456789]) {
+            NSDecimalNumber *decimalNumber = [NSDecimalNumber stp_decimalNumberWithAmount:amount.integerValue currency:currency];
+            XCTAssertEqual([decimalNumber stp_amountWithCurrency:currency], amount.integerValue);
+        }
+    }
+}
+
 
 @end
@@ -0,0 +1,56 @@
+//
+//  NSDictionary+StripeTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "NSDictionary+Stripe.h"
+
+@interface NSDictionary_StripeTest : XCTestCase
+
+@end
+
+@implementation NSDictionary_StripeTest
+
+- (void)testRemovesNulls {
+    NSDictionary *dict = @{@"id": @"card_123", @"name": [NSNull null]};
+    XCTAssertEqualObjects([dict stp_dictionaryByRemovingNullsValidatingRequiredFields:@[@"id"]], @{@"id": @"card_123"});
+}
+
+- (void)testFilteredViewHidesNulls {
+    NSDictionary *dict = @{@"id": @"card_123", @"name": [NSNull null], @"last4": @"4242"};
+    NSDictionary *filtered = [dict stp_dictionaryByRemovingNullsValidatingRequiredFields:@[]];
+    XCTAssertEqual(filtered.count, 2U);
+    XCTAssertNil(filtered[@"name"]);
+    XCTAssertEqualObjects(filtered[@"last4"], @"4242");
+    XCTAssertEqualObjects([NSSet setWithArray:filtered.allKeys], ([NSSet setWithObjects:@"id", @"last4", nil]));
+    XCTAssertEqual([filtered copy], filtered);
+    NSData *data = [NSJSONSerialization dataWithJSONObject:filtered options:0 error:nil];
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], (@{@"id": @"card_123", @"last4": @"4242"}));
+}
+
+- (void)testReturnsEquivalentDictionaryWithoutNulls {
+    NSDictionary *dict = @{@"id": @"card_123", @"name": @"Jenny Rosen"};
+    XCTAssertEqualObjects([dict stp_dictionaryByRemovingNullsValidatingRequiredFields:@[@"id", @"name"]], dict);
+}
+
+- (void)testMissingOrNullRequiredFields {
+    NSDictionary *dict = @{@"id": @"card_123", @"name": [NSNull null]};
+    XCTAssertNil([dict stp_dictionaryByRemovingNullsValidatingRequiredFields:@[@"id", @"name"]]);
+    XCTAssertNil([dict stp_dictionaryByRemovingNullsValidatingRequiredFields:@[@"last4"]]);
+}
+
+- (void)testLowercaseKeyLookupIgnoresCase {
+    NSDictionary *table = @{@"visa": @1, @"american express": @2};
+    XCTAssertEqualObjects([table stp_objectForLowercaseKeyMatchingString:@"visa"], @1);
+    XCTAssertEqualObjects([table stp_objectForLowercaseKeyMatchingString:@"American Express"], @2);
+    XCTAssertNil([table stp_objectForLowercaseKeyMatchingString:@"discover"]);
+    XCTAssertNil([table stp_objectForLowercaseKeyMatchingString:@"DISCOVER"]);
+    XCTAssertNil([table stp_objectForLowercaseKeyMatchingString:nil]);
+    XCTAssertNil([table stp_objectForLowercaseKeyMatchingString:@1]);
+}
+
+@end
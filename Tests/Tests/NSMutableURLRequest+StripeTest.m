@@ -29,4 +29,11 @@
     XCTAssertEqualObjects(request.URL.absoluteString, @"https://example.com?a=b&foo=bar");
 }
 
+- (void)testAddParametersToURL_escapesValues {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://example.com/v1/sources/src_123#frag"]];
+    [request stp_addParametersToURL:@{@"client_secret": @"a b&c", @"metadata": @{@"key": @"é"}}];
+
+    XCTAssertEqualObjects(request.URL.absoluteString, @"https://example.com/v1/sources/src_123?client_secret=a%20b%26c&metadata%5Bkey%5D=%C3%A9#frag");
+}
+
 @end
@@ -9,6 +9,11 @@
 @import XCTest;
 
 #import "STPAPIClient.h"
+#import "STPAPIClient+Private.h"
+#import "STPCardParams.h"
+#import "STPNetworkReplayProtocol.h"
+#import "STPTestUtils.h"
+#import "StripeError.h"
 
 @interface STPAPIClientTest : XCTestCase
 @end
@@ -19,10 +24,328 @@
     XCTAssertEqualObjects([STPAPIClient sharedClient], [STPAPIClient sharedClient]);
 }
 
+- (void)testClientWithPublishableKey {
+    STPAPIClient *client = [STPAPIClient clientWithPublishableKey:@"pk_test_registry_1"];
+    XCTAssertEqualObjects(client.publishableKey, @"pk_test_registry_1");
+    XCTAssertEqual([STPAPIClient clientWithPublishableKey:@"pk_test_registry_1"], client);
+    STPAPIClient *otherClient = [STPAPIClient clientWithPublishableKey:@"pk_test_registry_2"];
+    XCTAssertNotEqual(otherClient, client);
+    XCTAssertEqual(otherClient.urlSession, client.urlSession);
+
+    // A client whose key was changed isn't handed out for its old key
+    client.publishableKey = @"pk_test_registry_3";
+    STPAPIClient *replacement = [STPAPIClient clientWithPublishableKey:@"pk_test_registry_1"];
+    XCTAssertNotEqual(replacement, client);
+    XCTAssertEqualObjects(replacement.publishableKey, @"pk_test_registry_1");
+}
+
 - (void)testPublishableKey {
+    NSString *previousKey = [Stripe defaultPublishableKey];
     [Stripe setDefaultPublishableKey:@"test"];
     STPAPIClient *client = [STPAPIClient sharedClient];
     XCTAssertEqualObjects(client.publishableKey, @"test");
+    // Other tests may run after this one in the same process
+    [Stripe setDefaultPublishableKey:previousKey];
+}
+
+- (void)testIdenticalGETsShareTask {
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    STPAPIResponseBlock completion = ^(__unused id object, __unused NSHTTPURLResponse *response, __unused NSError *error) {};
+    NSURLSessionDataTask *task1 = [client retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    NSURLSessionDataTask *task2 = [client retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    NSURLSessionDataTask *task3 = [client retrieveSourceWithId:@"src_123" clientSecret:@"other_secret" responseCompletion:completion];
+    XCTAssertEqual(task1.taskIdentifier, task2.taskIdentifier);
+    XCTAssertNotEqual(task1.taskIdentifier, task3.taskIdentifier);
+    [task1 cancel];
+    [task2 cancel];
+    [task3 cancel];
+}
+
+- (void)testGETsWithDifferentQueuesDoNotShareTask {
+    STPAPIClient *client1 = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    STPAPIClient *client2 = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    client2.completionQueue = dispatch_queue_create("com.stripe.test.completion", DISPATCH_QUEUE_SERIAL);
+    STPAPIResponseBlock completion = ^(__unused id object, __unused NSHTTPURLResponse *response, __unused NSError *error) {};
+    NSURLSessionDataTask *task1 = [client1 retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    NSURLSessionDataTask *task2 = [client2 retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    XCTAssertNotEqual(task1.taskIdentifier, task2.taskIdentifier);
+    [task1 cancel];
+    [task2 cancel];
+}
+
+- (void)testCancellingSharedGETOnlyCancelsCaller {
+    STPAPIClient *client = [self replayClientWithSourceStatus:@"chargeable" count:1];
+    XCTestExpectation *cancelled = [self expectationWithDescription:@"cancelled"];
+    XCTestExpectation *answered = [self expectationWithDescription:@"answered"];
+    NSURLSessionDataTask *task1 = [client retrieveSourceWithId:@"src_0" clientSecret:@"secret" responseCompletion:^(id object, __unused NSHTTPURLResponse *response, NSError *error) {
+        XCTAssertNil(object);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [cancelled fulfill];
+    }];
+    NSURLSessionDataTask *task2 = [client retrieveSourceWithId:@"src_0" clientSecret:@"secret" responseCompletion:^(id object, __unused NSHTTPURLResponse *response, NSError *error) {
+        XCTAssertNotNil(object);
+        XCTAssertNil(error);
+        [answered fulfill];
+    }];
+    [task1 cancel];
+    XCTAssertEqual(task1.state, NSURLSessionTaskStateCompleted);
+    XCTAssertEqual(task2.state, NSURLSessionTaskStateRunning);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual([STPNetworkReplayProtocol requestCountForMethod:@"GET" path:@"/v1/sources/src_0"], 1U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testCancelledPOSTIsNotRetried {
+    [STPNetworkReplayProtocol stubMethod:@"POST"
+                                    path:@"/v1/tokens"
+                              statusCode:500
+                                 headers:@{}
+                             JSONObjects:@[@{}]];
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    client.urlSession = [STPNetworkReplayProtocol session];
+    STPCardParams *card = [STPCardParams new];
+    card.number = @"4242424242424242";
+    card.expMonth = 12;
+    card.expYear = 2030;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"cancelled"];
+    NSURLSessionDataTask *task = [client createTokenWithCard:card completion:^(STPToken *token, NSError *error) {
+        XCTAssertNil(token);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [expectation fulfill];
+    }];
+    [task cancel];
+    XCTAssertEqual(task.state, NSURLSessionTaskStateCanceling);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(task.state, NSURLSessionTaskStateCompleted);
+    XCTAssertLessThanOrEqual([STPNetworkReplayProtocol requestCountForMethod:@"POST" path:@"/v1/tokens"], 1U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testClientsShareURLSession {
+    STPAPIClient *client1 = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    STPAPIClient *client2 = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_bar"];
+    XCTAssertEqual(client1.urlSession, client2.urlSession);
+    XCTAssertNil(client1.urlSession.configuration.HTTPAdditionalHeaders[@"Authorization"]);
+
+    NSURLRequest *request = [client1 configuredRequestForURL:client1.apiURL];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Authorization"], @"Bearer pk_test_foo");
+
+    STPAPIResponseBlock completion = ^(__unused id object, __unused NSHTTPURLResponse *response, __unused NSError *error) {};
+    NSURLSessionDataTask *task1 = [client1 retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    NSURLSessionDataTask *task2 = [client2 retrieveSourceWithId:@"src_123" clientSecret:@"secret" responseCompletion:completion];
+    XCTAssertNotEqual(task1, task2);
+    [task1 cancel];
+    [task2 cancel];
+}
+
+- (void)testRequestTemplatesAreCopied {
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    NSMutableURLRequest *request1 = [client configuredRequestForEndpoint:@"sources/src_123"];
+    XCTAssertEqualObjects(request1.URL, [client.apiURL URLByAppendingPathComponent:@"sources/src_123"]);
+    XCTAssertEqualObjects([request1 valueForHTTPHeaderField:@"Authorization"], @"Bearer pk_test_foo");
+    request1.HTTPMethod = @"POST";
+    [request1 setValue:@"key" forHTTPHeaderField:@"Idempotency-Key"];
+
+    NSMutableURLRequest *request2 = [client configuredRequestForEndpoint:@"sources/src_123"];
+    XCTAssertNotEqual(request1, request2);
+    XCTAssertEqualObjects(request2.HTTPMethod, @"GET");
+    XCTAssertNil([request2 valueForHTTPHeaderField:@"Idempotency-Key"]);
+
+    client.publishableKey = @"pk_test_bar";
+    NSMutableURLRequest *request3 = [client configuredRequestForEndpoint:@"sources/src_123"];
+    XCTAssertEqualObjects([request3 valueForHTTPHeaderField:@"Authorization"], @"Bearer pk_test_bar");
+
+    client.apiURL = [NSURL URLWithString:@"https://example.com/v1"];
+    NSMutableURLRequest *request4 = [client configuredRequestForEndpoint:@"sources/src_123"];
+    XCTAssertEqualObjects(request4.URL.absoluteString, @"https://example.com/v1/sources/src_123");
+}
+
+- (void)testUnchangedSourceIsNotDecoded {
+    [STPNetworkReplayProtocol stubMethod:@"GET"
+                                    path:@"/v1/sources/src_123"
+                              statusCode:304
+                                 headers:@{@"ETag": @"\"abc\""}
+                             JSONObjects:@[@{}]];
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    client.urlSession = [STPNetworkReplayProtocol session];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"retrieve"];
+    [client retrieveSourceWithId:@"src_123" clientSecret:@"secret" previousSource:nil entityTag:@"\"abc\"" responseCompletion:^(id object, NSHTTPURLResponse *response, NSError *error) {
+        XCTAssertNil(object);
+        XCTAssertNil(error);
+        XCTAssertEqual(response.statusCode, 304);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testPrepareResources {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"resources prepared"];
+    [Stripe prepareResourcesWithCompletion:^{
+        XCTAssertTrue([NSThread isMainThread]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+#pragma mark - Source pollers
+
+- (STPAPIClient *)replayClientWithSourceStatus:(NSString *)status count:(NSUInteger)count {
+    [STPNetworkReplayProtocol reset];
+    STPNetworkProfile *profile = [STPNetworkProfile instantProfile];
+    // Keeps pending long polls from spinning
+    profile.latency = 0.2;
+    [STPNetworkReplayProtocol setProfile:profile];
+    NSMutableDictionary *json = [[STPTestUtils jsonNamed:@"3DSSource"] mutableCopy];
+    json[@"status"] = status;
+    for (NSUInteger i = 0; i < count; i++) {
+        json[@"id"] = [NSString stringWithFormat:@"src_%lu", (unsigned long)i];
+        [STPNetworkReplayProtocol stubMethod:@"GET" path:[@"/v1/sources/" stringByAppendingString:json[@"id"]] withJSONObjects:@[json]];
+    }
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    client.urlSession = [STPNetworkReplayProtocol session];
+    return client;
+}
+
+- (void)testFinishedPollersAreUnregistered {
+    STPAPIClient *client = [self replayClientWithSourceStatus:@"chargeable" count:1];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"poll"];
+    [client startPollingSourceWithId:@"src_0" clientSecret:@"secret" timeout:10 completion:^(STPSource *source, __unused NSError *error) {
+        XCTAssertEqual(source.status, STPSourceStatusChargeable);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    STPSourcePollerRegistryMetrics metrics = [client sourcePollerRegistryMetrics];
+    XCTAssertEqual(metrics.activeCount, 0U);
+    XCTAssertEqual(metrics.registeredCount, 1U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testPollStoppedBeforeRegistrationNeverRuns {
+    STPAPIClient *client = [self replayClientWithSourceStatus:@"pending" count:1];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"started and stopped"];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        // The poller is only created once the main thread gets to it, so
+        // the stop reaches the registry before the poller does.
+        [client startPollingSourceWithId:@"src_0" clientSecret:@"secret" timeout:60 completion:^(__unused STPSource *source, __unused NSError *error) {
+            XCTFail(@"A stopped poll shouldn't finish");
+        }];
+        [client stopPollingSourceWithId:@"src_0"];
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+    STPSourcePollerRegistryMetrics metrics = [client sourcePollerRegistryMetrics];
+    XCTAssertEqual(metrics.activeCount, 0U);
+    XCTAssertEqual(metrics.registeredCount, 0U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testPollerRegistryIsBounded {
+    NSUInteger count = 34;
+    STPAPIClient *client = [self replayClientWithSourceStatus:@"pending" count:count];
+    NSMutableArray<XCTestExpectation *> *evictions = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count; i++) {
+        XCTestExpectation *expectation = (i < 2) ? [self expectationWithDescription:@"evicted"] : nil;
+        if (expectation) {
+            [evictions addObject:expectation];
+        }
+        [client startPollingSourceWithId:[NSString stringWithFormat:@"src_%lu", (unsigned long)i]
+                            clientSecret:@"secret"
+                                 timeout:60
+                              completion:^(__unused STPSource *source, NSError *error) {
+                                  XCTAssertNotNil(expectation, @"Only the oldest polls should finish early");
+                                  XCTAssertEqualObjects(error.domain, StripeDomain);
+                                  XCTAssertEqual(error.code, STPCancellationError);
+                                  [expectation fulfill];
+                              }];
+    }
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    STPSourcePollerRegistryMetrics metrics = [client sourcePollerRegistryMetrics];
+    XCTAssertEqual(metrics.activeCount, 32U);
+    XCTAssertEqual(metrics.peakCount, 32U);
+    XCTAssertEqual(metrics.registeredCount, count);
+    XCTAssertEqual(metrics.evictedCount, 2U);
+
+    for (NSUInteger i = 0; i < count; i++) {
+        [client stopPollingSourceWithId:[NSString stringWithFormat:@"src_%lu", (unsigned long)i]];
+    }
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqual([client sourcePollerRegistryMetrics].activeCount, 0U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testRetrieveSourceUsesCache {
+    STPAPIClient *client = [self replayClientWithSourceStatus:@"chargeable" count:1];
+    NSString *secret = [STPTestUtils jsonNamed:@"3DSSource"][@"client_secret"];
+    void (^retrieve)(STPSourceCachePolicy) = ^(STPSourceCachePolicy cachePolicy) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"retrieve"];
+        [client retrieveSourceWithId:@"src_0" clientSecret:secret cachePolicy:cachePolicy completion:^(STPSource *source, NSError *error) {
+            XCTAssertEqualObjects(source.stripeID, @"src_0");
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:2 handler:nil];
+    };
+
+    retrieve(STPSourceCachePolicyReturnCacheElseLoad);
+    XCTAssertEqual([STPNetworkReplayProtocol requestCountForMethod:@"GET" path:@"/v1/sources/src_0"], 1U);
+    retrieve(STPSourceCachePolicyReturnCacheElseLoad);
+    XCTAssertEqual([STPNetworkReplayProtocol requestCountForMethod:@"GET" path:@"/v1/sources/src_0"], 1U);
+    retrieve(STPSourceCachePolicyReloadIgnoringCache);
+    XCTAssertEqual([STPNetworkReplayProtocol requestCountForMethod:@"GET" path:@"/v1/sources/src_0"], 2U);
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)testEmptyTokenBatchCompletes {
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    NSProgress *progress = [client createTokensWithCards:@[]
+                                   maxConcurrentRequests:0
+                                          itemCompletion:^(__unused NSUInteger index, __unused STPToken *token, __unused NSError *error) {
+                                              XCTFail(@"There are no cards to report");
+                                          }
+                                              completion:^(NSArray *results) {
+                                                  XCTAssertEqual(results.count, 0U);
+                                                  [expectation fulfill];
+                                              }];
+    XCTAssertEqual(progress.totalUnitCount, 0);
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testCancellingTokenBatchFinishesEveryCard {
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_foo"];
+    NSMutableArray<STPCardParams *> *cards = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 20; i++) {
+        STPCardParams *card = [STPCardParams new];
+        card.number = @"4242424242424242";
+        card.expMonth = 12;
+        card.expYear = 2030;
+        [cards addObject:card];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    NSMutableIndexSet *reported = [NSMutableIndexSet indexSet];
+    NSProgress *progress = [client createTokensWithCards:cards
+                                   maxConcurrentRequests:2
+                                          itemCompletion:^(NSUInteger index, STPToken *token, NSError *error) {
+                                              XCTAssertNil(token);
+                                              XCTAssertNotNil(error);
+                                              XCTAssertFalse([reported containsIndex:index]);
+                                              [reported addIndex:index];
+                                          }
+                                              completion:^(NSArray *results) {
+                                                  XCTAssertEqual(results.count, cards.count);
+                                                  XCTAssertEqual(reported.count, cards.count);
+                                                  for (NSUInteger i = 2; i < results.count; i++) {
+                                                      NSError *error = results[i];
+                                                      XCTAssertTrue([error isKindOfClass:[NSError class]]);
+                                                      XCTAssertEqual(error.code, NSURLErrorCancelled);
+                                                  }
+                                                  [expectation fulfill];
+                                              }];
+    [progress cancel];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(progress.completedUnitCount, (int64_t)cards.count);
 }
 
 @end
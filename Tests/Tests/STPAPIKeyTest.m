@@ -0,0 +1,49 @@
+//
+//  STPAPIKeyTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "STPAPIKey.h"
+
+@interface STPAPIKeyTest : XCTestCase
+@end
+
+@implementation STPAPIKeyTest
+
+- (void)testParsing {
+    STPAPIKey *key = [STPAPIKey keyWithString:@"pk_test_123"];
+    XCTAssertEqual(key.type, STPAPIKeyTypePublishable);
+    XCTAssertTrue(key.testmode);
+    XCTAssertFalse(key.livemode);
+
+    key = [STPAPIKey keyWithString:@"PK_LIVE_123"];
+    XCTAssertEqual(key.type, STPAPIKeyTypePublishable);
+    XCTAssertFalse(key.testmode);
+    XCTAssertTrue(key.livemode);
+
+    key = [STPAPIKey keyWithString:@"sk_live_123"];
+    XCTAssertEqual(key.type, STPAPIKeyTypeSecret);
+    XCTAssertTrue(key.livemode);
+
+    key = [STPAPIKey keyWithString:@"rk_test_123"];
+    XCTAssertEqual(key.type, STPAPIKeyTypeRestricted);
+    XCTAssertTrue(key.testmode);
+
+    key = [STPAPIKey keyWithString:@"foo"];
+    XCTAssertEqual(key.type, STPAPIKeyTypeUnknown);
+    XCTAssertFalse(key.testmode);
+    XCTAssertFalse(key.livemode);
+}
+
+- (void)testKeysAreShared {
+    NSString *string = [NSString stringWithFormat:@"pk_test_%@", @"456"];
+    STPAPIKey *key = [STPAPIKey keyWithString:string];
+    XCTAssertEqual(key, [STPAPIKey keyWithString:@"pk_test_456"]);
+    XCTAssertEqualObjects(key.string, @"pk_test_456");
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+//  STPAPIRequestMetricsTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <OCMock/OCMock.h>
+#import <XCTest/XCTest.h>
+
+#import "STPAPIRequestMetrics+Private.h"
+#import "STPURLSessionPool.h"
+
+@interface STPAPIRequestMetricsTest : XCTestCase
+
+@end
+
+@implementation STPAPIRequestMetricsTest
+
+- (void)testDurationsAreDerivedFromTimestamps {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://api.stripe.com/v1/sources"]];
+    request.HTTPMethod = @"POST";
+    STPAPIRequestMetrics *metrics = [[STPAPIRequestMetrics alloc] initWithRequest:request endpoint:@"sources"];
+    metrics.startTime = 100;
+    metrics.decodeStartTime = 101;
+    metrics.decodeEndTime = 101.25;
+    metrics.completionTime = 101.5;
+
+    XCTAssertEqualObjects(metrics.HTTPMethod, @"POST");
+    XCTAssertEqualObjects(metrics.endpoint, @"sources");
+    XCTAssertEqualWithAccuracy(metrics.decodeDuration, 0.25, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.completionDispatchDelay, 0.25, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.totalDuration, 1.5, 0.0001);
+}
+
+- (void)testNetworkDurationsAreZeroWithoutTaskMetrics {
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://api.stripe.com/v1/tokens"]];
+    STPAPIRequestMetrics *metrics = [[STPAPIRequestMetrics alloc] initWithRequest:request endpoint:@"tokens"];
+
+    XCTAssertEqualObjects(metrics.HTTPMethod, @"GET");
+    XCTAssertFalse(metrics.reusedConnection);
+    XCTAssertEqualWithAccuracy(metrics.domainLookupDuration, 0, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.connectDuration, 0, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.secureConnectionDuration, 0, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.timeToFirstByte, 0, 0.0001);
+    XCTAssertEqualWithAccuracy(metrics.transferDuration, 0, 0.0001);
+}
+
+- (id)transactionWithFetchType:(NSURLSessionTaskMetricsResourceFetchType)fetchType hasResponse:(BOOL)hasResponse NS_AVAILABLE_IOS(10_0) {
+    id transaction = OCMClassMock([NSURLSessionTaskTransactionMetrics class]);
+    OCMStub([transaction resourceFetchType]).andReturn(fetchType);
+    OCMStub([transaction response]).andReturn(hasResponse ? [NSURLResponse new] : nil);
+    return transaction;
+}
+
+- (void)testResponseTransactionSkipsAttemptsThatDidNotProduceTheResponse {
+    if (![NSURLSessionTaskMetrics class]) {
+        return;
+    }
+    id network = [self transactionWithFetchType:NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad hasResponse:YES];
+    id failedRetry = [self transactionWithFetchType:NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad hasResponse:NO];
+    id cached = [self transactionWithFetchType:NSURLSessionTaskMetricsResourceFetchTypeLocalCache hasResponse:YES];
+    id taskMetrics = OCMClassMock([NSURLSessionTaskMetrics class]);
+    OCMStub([taskMetrics transactionMetrics]).andReturn((@[network, cached, failedRetry]));
+
+    XCTAssertEqual(STPResponseTransactionMetrics(taskMetrics), network);
+}
+
+- (void)testResponseTransactionFallsBackToAnyTransactionWithAResponse {
+    if (![NSURLSessionTaskMetrics class]) {
+        return;
+    }
+    id cached = [self transactionWithFetchType:NSURLSessionTaskMetricsResourceFetchTypeLocalCache hasResponse:YES];
+    id failed = [self transactionWithFetchType:NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad hasResponse:NO];
+    id taskMetrics = OCMClassMock([NSURLSessionTaskMetrics class]);
+    OCMStub([taskMetrics transactionMetrics]).andReturn((@[cached, failed]));
+
+    XCTAssertEqual(STPResponseTransactionMetrics(taskMetrics), cached);
+    XCTAssertNil(STPResponseTransactionMetrics(nil));
+}
+
+@end
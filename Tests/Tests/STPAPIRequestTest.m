@@ -0,0 +1,62 @@
+//
+//  STPAPIRequestTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPAPIRequest.h"
+
+@interface STPAPIRequest (Testing)
++ (BOOL)shouldRetryResponse:(NSURLResponse *)response error:(NSError *)error;
++ (NSTimeInterval)retryDelayAfterAttempt:(NSUInteger)attempt;
+@end
+
+@interface STPAPIRequestTest : XCTestCase
+
+@end
+
+@implementation STPAPIRequestTest
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://api.stripe.com/v1/tokens"]
+                                       statusCode:statusCode
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:nil];
+}
+
+- (void)testRetriesDroppedConnectionsAndTimeouts {
+    NSError *lost = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNetworkConnectionLost userInfo:nil];
+    NSError *timedOut = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    XCTAssertTrue([STPAPIRequest shouldRetryResponse:nil error:lost]);
+    XCTAssertTrue([STPAPIRequest shouldRetryResponse:nil error:timedOut]);
+}
+
+- (void)testDoesNotRetryCancelledRequests {
+    NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    XCTAssertFalse([STPAPIRequest shouldRetryResponse:nil error:cancelled]);
+}
+
+- (void)testRetriesOnlyServerErrors {
+    XCTAssertTrue([STPAPIRequest shouldRetryResponse:[self responseWithStatusCode:500] error:nil]);
+    XCTAssertTrue([STPAPIRequest shouldRetryResponse:[self responseWithStatusCode:503] error:nil]);
+    XCTAssertFalse([STPAPIRequest shouldRetryResponse:[self responseWithStatusCode:200] error:nil]);
+    XCTAssertFalse([STPAPIRequest shouldRetryResponse:[self responseWithStatusCode:402] error:nil]);
+    XCTAssertFalse([STPAPIRequest shouldRetryResponse:[self responseWithStatusCode:429] error:nil]);
+}
+
+- (void)testRetryDelayIsBoundedByBackoff {
+    for (NSUInteger i = 0; i < 100; i++) {
+        NSTimeInterval first = [STPAPIRequest retryDelayAfterAttempt:1];
+        NSTimeInterval second = [STPAPIRequest retryDelayAfterAttempt:2];
+        NSTimeInterval tenth = [STPAPIRequest retryDelayAfterAttempt:10];
+        XCTAssertTrue(first >= 0 && first <= 0.5);
+        XCTAssertTrue(second >= 0 && second <= 1);
+        XCTAssertTrue(tenth >= 0 && tenth <= 4);
+    }
+}
+
+@end
@@ -30,7 +30,10 @@
 @implementation STPAddCardViewControllerTest
 
 - (STPAddCardViewController *)buildAddCardViewController {
-    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    return [self buildAddCardViewControllerWithConfiguration:[STPFixtures paymentConfiguration]];
+}
+
+- (STPAddCardViewController *)buildAddCardViewControllerWithConfiguration:(STPPaymentConfiguration *)config {
     STPTheme *theme = [STPTheme defaultTheme];
     STPAddCardViewController *vc = [[STPAddCardViewController alloc] initWithConfiguration:config
                                                                                      theme:theme];
@@ -38,6 +41,17 @@
     return vc;
 }
 
+- (void)testPrepareForReuse {
+    STPAddCardViewController *sut = [self buildAddCardViewController];
+    sut.paymentCell.paymentField.cardParams = [STPFixtures cardParams];
+    sut.loading = YES;
+    XCTAssertFalse(sut.paymentCell.isEmpty);
+
+    [sut prepareForReuse];
+    XCTAssertTrue(sut.paymentCell.isEmpty);
+    XCTAssertFalse(sut.loading);
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
 
@@ -70,6 +84,36 @@
     [self waitForExpectationsWithTimeout:2 handler:nil];
 }
 
+- (void)testPrepareForReuseCancelsTokenCreation {
+    STPAddCardViewController *sut = [self buildAddCardViewController];
+    sut.paymentCell.paymentField.cardParams = [STPFixtures cardParams];
+
+    id mockAPIClient = OCMClassMock([STPAPIClient class]);
+    id mockTask = OCMClassMock([NSURLSessionDataTask class]);
+    sut.apiClient = mockAPIClient;
+    __block STPTokenCompletionBlock tokenCompletion;
+    OCMStub([mockAPIClient createTokenWithCard:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPTokenCompletionBlock completion;
+        [invocation getArgument:&completion atIndex:3];
+        tokenCompletion = completion;
+    })
+    .andReturn(mockTask);
+
+    // tap next button
+    UIBarButtonItem *nextButton = sut.navigationItem.rightBarButtonItem;
+    [nextButton.target performSelector:nextButton.action withObject:nextButton];
+    XCTAssertNotNil(tokenCompletion);
+
+    [sut prepareForReuse];
+    OCMVerify([mockTask cancel]);
+
+    NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    tokenCompletion(nil, cancelled);
+    XCTAssertFalse(sut.loading);
+    XCTAssertNil(sut.presentedViewController);
+}
+
 - (void)testNextWithCreateTokenSuccessAndDidCreateTokenError {
     STPAddCardViewController *sut = [self buildAddCardViewController];
 
@@ -163,6 +207,80 @@
     [self waitForExpectationsWithTimeout:2 handler:nil];
 }
 
+- (void)testSpeculativeTokenIsHandedOverOnDone {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.speculativeTokenizationEnabled = YES;
+    STPAddCardViewController *sut = [self buildAddCardViewControllerWithConfiguration:config];
+
+    id mockAPIClient = OCMClassMock([STPAPIClient class]);
+    id mockDelegate = OCMProtocolMock(@protocol(STPAddCardViewControllerDelegate));
+    sut.apiClient = mockAPIClient;
+    sut.delegate = mockDelegate;
+    STPToken *expectedToken = [STPToken new];
+    expectedToken.tokenId = @"tok_123";
+    __block NSUInteger createTokenCount = 0;
+    OCMStub([mockAPIClient createTokenWithCard:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPTokenCompletionBlock completion;
+        [invocation getArgument:&completion atIndex:3];
+        createTokenCount++;
+        XCTAssertFalse(sut.loading);
+        completion(expectedToken, nil);
+    });
+
+    // Entering a valid card starts the request before Done is tapped
+    sut.paymentCell.paymentField.cardParams = [STPFixtures cardParams];
+    XCTAssertEqual(createTokenCount, (NSUInteger)1);
+
+    XCTestExpectation *didCreateTokenExp = [self expectationWithDescription:@"didCreateToken"];
+    OCMStub([mockDelegate addCardViewController:[OCMArg any] didCreateToken:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPToken *token;
+        STPErrorBlock completion;
+        [invocation getArgument:&token atIndex:3];
+        [invocation getArgument:&completion atIndex:4];
+        XCTAssertEqualObjects(token.tokenId, expectedToken.tokenId);
+        completion(nil);
+        [didCreateTokenExp fulfill];
+    });
+
+    // tap next button
+    UIBarButtonItem *nextButton = sut.navigationItem.rightBarButtonItem;
+    [nextButton.target performSelector:nextButton.action withObject:nextButton];
+
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertEqual(createTokenCount, (NSUInteger)1);
+    XCTAssertFalse(sut.loading);
+}
+
+- (void)testEditingDiscardsSpeculativeToken {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.speculativeTokenizationEnabled = YES;
+    STPAddCardViewController *sut = [self buildAddCardViewControllerWithConfiguration:config];
+
+    id mockAPIClient = OCMClassMock([STPAPIClient class]);
+    id mockTask = OCMClassMock([NSURLSessionDataTask class]);
+    sut.apiClient = mockAPIClient;
+    NSMutableArray<NSString *> *numbers = [NSMutableArray array];
+    OCMStub([mockAPIClient createTokenWithCard:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPCardParams *cardParams;
+        [invocation getArgument:&cardParams atIndex:2];
+        [numbers addObject:cardParams.number];
+    })
+    .andReturn(mockTask);
+
+    sut.paymentCell.paymentField.cardParams = [STPFixtures cardParams];
+    XCTAssertEqual(numbers.count, (NSUInteger)1);
+
+    STPCardParams *otherCard = [STPFixtures cardParams];
+    otherCard.number = @"5555555555554444";
+    sut.paymentCell.paymentField.cardParams = otherCard;
+    OCMVerify([mockTask cancel]);
+    XCTAssertEqual(numbers.count, (NSUInteger)2);
+    XCTAssertEqualObjects(numbers.lastObject, @"5555555555554444");
+}
+
 #pragma clang diagnostic pop
 
 @end
@@ -11,6 +11,7 @@
 #import <PassKit/PassKit.h>
 #import <Contacts/Contacts.h>
 #import "STPAddress.h"
+#import "STPAddress+Private.h"
 
 @interface STPAddressTests : XCTestCase
 
@@ -145,6 +146,22 @@
     XCTAssertNil(address.country);
 }
 
+- (void)testImportAddressFromCNContact {
+    CNMutableContact *contact = [CNMutableContact new];
+    contact.givenName = @"John";
+    contact.phoneNumbers = @[[CNLabeledValue labeledValueWithLabel:CNLabelPhoneNumberMain
+                                                             value:[CNPhoneNumber phoneNumberWithStringValue:@"888-555-1212"]]];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"import"];
+    [STPAddress importAddressFromCNContact:[contact copy] completion:^(STPAddress *address) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertEqualObjects(@"John", address.name);
+        XCTAssertEqualObjects(@"8885551212", address.phone);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
 - (void)testInitWithABRecord_complete {
     ABRecordRef record = ABPersonCreate();
     ABRecordSetValue(record, kABPersonFirstNameProperty, CFSTR("John"), nil);
@@ -314,6 +331,64 @@
     XCTAssertEqualObjects(postalAddress.country, @"US");
 }
 
+- (void)testCachedPKContactValue {
+    STPAddress *address = [STPAddress new];
+    address.name = @"John Smith Doe";
+    address.line1 = @"55 John St";
+    address.postalCode = @"10002";
+
+    PKContact *contact = [address cachedPKContactValue];
+    XCTAssertEqualObjects(contact.postalAddress.postalCode, @"10002");
+    XCTAssertEqual([address cachedPKContactValue], contact);
+
+    address.postalCode = @"10003";
+    PKContact *changedContact = [address cachedPKContactValue];
+    XCTAssertNotEqual(changedContact, contact);
+    XCTAssertEqualObjects(changedContact.postalAddress.postalCode, @"10003");
+}
+
+- (void)testCachedABRecordValue {
+    STPAddress *address = [STPAddress new];
+    address.name = @"John Smith Doe";
+    ABRecordRef record = [address cachedABRecordValue];
+    XCTAssertEqual([address cachedABRecordValue], record);
+
+    address.name = @"Jane Doe";
+    record = [address cachedABRecordValue];
+    NSString *firstName = (__bridge_transfer NSString *)ABRecordCopyValue(record, kABPersonFirstNameProperty);
+    XCTAssertEqualObjects(firstName, @"Jane");
+}
+
+- (void)testInitWithPKContact_previousContact {
+    PKContact *previousContact = [PKContact new];
+    NSPersonNameComponents *name = [NSPersonNameComponents new];
+    name.givenName = @"John";
+    name.familyName = @"Doe";
+    previousContact.name = name;
+    previousContact.phoneNumber = [CNPhoneNumber phoneNumberWithStringValue:@"888-555-1212"];
+    CNMutablePostalAddress *postalAddress = [CNMutablePostalAddress new];
+    postalAddress.street = @"55 John St";
+    postalAddress.postalCode = @"10002";
+    previousContact.postalAddress = postalAddress.copy;
+    STPAddress *previousAddress = [[STPAddress alloc] initWithPKContact:previousContact];
+
+    PKContact *contact = [PKContact new];
+    contact.name = name;
+    contact.phoneNumber = previousContact.phoneNumber;
+    contact.emailAddress = @"foo@example.com";
+    postalAddress.postalCode = @"10003";
+    contact.postalAddress = postalAddress.copy;
+
+    STPAddress *address = [[STPAddress alloc] initWithPKContact:contact
+                                                previousContact:previousContact
+                                                previousAddress:previousAddress];
+    STPAddress *convertedAddress = [[STPAddress alloc] initWithPKContact:contact];
+    for (NSString *key in @[@"name", @"phone", @"email", @"line1", @"city", @"state", @"postalCode", @"country"]) {
+        XCTAssertEqualObjects([address valueForKey:key], [convertedAddress valueForKey:key], @"%@", key);
+    }
+    XCTAssertEqualObjects(address.postalCode, @"10003");
+}
+
 - (void)testContainsRequiredFieldsNone {
     STPAddress *address = [STPAddress new];
     XCTAssertTrue([address containsRequiredFields:STPBillingAddressFieldsNone]);
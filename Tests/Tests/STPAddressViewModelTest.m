@@ -140,4 +140,24 @@
     XCTAssertTrue(sut.isValid);
 }
 
+- (void)testPostalCodeCellIsReusedAcrossCountryChanges {
+    STPAddressViewModel *sut = [[STPAddressViewModel alloc] initWithRequiredBillingFields:STPBillingAddressFieldsFull];
+    STPAddressFieldTableViewCell *countryCell = sut.addressCells.lastObject;
+    countryCell.contents = @"US";
+    [sut setValue:@"US" forKey:@"addressFieldTableViewCountryCode"];
+    XCTAssertEqual(sut.addressCells.count, 7U);
+    STPAddressFieldTableViewCell *zipCell = sut.addressCells[5];
+    XCTAssertEqual(zipCell.type, STPAddressFieldTypeZip);
+    zipCell.contents = @"10002";
+
+    [sut setValue:@"AE" forKey:@"addressFieldTableViewCountryCode"];
+    XCTAssertEqual(sut.addressCells.count, 6U);
+
+    [sut setValue:@"US" forKey:@"addressFieldTableViewCountryCode"];
+    XCTAssertEqual(sut.addressCells.count, 7U);
+    XCTAssertEqual(sut.addressCells[5], zipCell);
+    XCTAssertEqualObjects(zipCell.contents, @"");
+    XCTAssertFalse(zipCell.lastInList);
+}
+
 @end
@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "STPAnalyticsClient.h"
+#import "STPAnalyticsUploader.h"
 #import "STPFixtures.h"
 #import "STPFormEncoder.h"
 
@@ -17,6 +18,7 @@
 
 @interface STPAnalyticsClient (Testing)
 + (BOOL)shouldCollectAnalytics;
++ (NSMutableDictionary *)commonPayload;
 @end
 
 @interface STPAnalyticsClientTest : XCTestCase
@@ -43,4 +45,25 @@
     XCTAssertEqualObjects([STPAnalyticsClient tokenTypeFromParameters:applePayDict], @"apple_pay");
 }
 
+- (void)testCommonPayloadIncludesAppMetadata {
+    NSDictionary *payload = [STPAnalyticsClient commonPayload];
+    NSDictionary *infoDictionary = [NSBundle mainBundle].infoDictionary;
+    XCTAssertEqualObjects(payload[@"app_name"], infoDictionary[(NSString *)kCFBundleNameKey]);
+    XCTAssertEqualObjects(payload[@"app_version"], infoDictionary[@"CFBundleShortVersionString"]);
+    XCTAssertEqualObjects(payload[@"app_bundle_identifier"], [NSBundle mainBundle].bundleIdentifier);
+}
+
+- (void)testUploaderPersistsPendingPayloads {
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    STPAnalyticsUploader *uploader = [[STPAnalyticsUploader alloc] initWithURLSession:session fileURL:fileURL];
+    [uploader enqueuePayload:@{@"event": @"one"}];
+    [uploader enqueuePayload:@{@"event": @"two"}];
+    XCTAssertEqualObjects(uploader.pendingPayloads, (@[@{@"event": @"one"}, @{@"event": @"two"}]));
+
+    STPAnalyticsUploader *relaunchedUploader = [[STPAnalyticsUploader alloc] initWithURLSession:session fileURL:fileURL];
+    XCTAssertEqualObjects(relaunchedUploader.pendingPayloads, uploader.pendingPayloads);
+    [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+}
+
 @end
@@ -0,0 +1,78 @@
+//
+//  STPBankAccountValidatorTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "STPBankAccountValidator.h"
+
+@interface STPBankAccountValidatorTest : XCTestCase
+
+@end
+
+@implementation STPBankAccountValidatorTest
+
+- (void)testUSRoutingNumbers {
+    NSArray *tests = @[
+                       @[@"", @(STPCardValidationStateIncomplete)],
+                       @[@"1", @(STPCardValidationStateIncomplete)],
+                       @[@"1100", @(STPCardValidationStateIncomplete)],
+                       @[@"110000000", @(STPCardValidationStateValid)],
+                       @[@"021000021", @(STPCardValidationStateValid)],
+                       @[@"021-000-021", @(STPCardValidationStateValid)],
+                       @[@"110000001", @(STPCardValidationStateInvalid)],
+                       @[@"1100000000", @(STPCardValidationStateInvalid)],
+                       @[@"11000a", @(STPCardValidationStateInvalid)],
+                       @[@"4", @(STPCardValidationStateInvalid)],
+                       @[@"13", @(STPCardValidationStateInvalid)],
+                       @[@"9", @(STPCardValidationStateInvalid)],
+                       ];
+    for (NSArray *test in tests) {
+        XCTAssertEqualObjects(@([STPBankAccountValidator validationStateForRoutingNumber:test[0] country:@"us"]), test[1], @"%@", test[0]);
+    }
+}
+
+- (void)testOtherRoutingNumbers {
+    XCTAssertEqual([STPBankAccountValidator validationStateForRoutingNumber:@"12-34-56" country:@"GB"], STPCardValidationStateValid);
+    XCTAssertEqual([STPBankAccountValidator validationStateForRoutingNumber:@"12-34" country:@"GB"], STPCardValidationStateIncomplete);
+    XCTAssertEqual([STPBankAccountValidator validationStateForRoutingNumber:@"1234567" country:@"AU"], STPCardValidationStateInvalid);
+    XCTAssertEqual([STPBankAccountValidator validationStateForRoutingNumber:@"11000-000" country:@"CA"], STPCardValidationStateValid);
+    XCTAssertEqual([STPBankAccountValidator validationStateForRoutingNumber:nil country:@"CA"], STPCardValidationStateIncomplete);
+}
+
+- (void)testIBANs {
+    NSArray *tests = @[
+                       @[@"", @(STPCardValidationStateIncomplete)],
+                       @[@"D", @(STPCardValidationStateIncomplete)],
+                       @[@"DE89 3704", @(STPCardValidationStateIncomplete)],
+                       @[@"DE89 3704 0044 0532 0130 00", @(STPCardValidationStateValid)],
+                       @[@"de89370400440532013000", @(STPCardValidationStateValid)],
+                       @[@"GB82 WEST 1234 5698 7654 32", @(STPCardValidationStateValid)],
+                       @[@"FR14 2004 1010 0505 0001 3M02 606", @(STPCardValidationStateValid)],
+                       @[@"NL91ABNA0417164300", @(STPCardValidationStateValid)],
+                       @[@"DE89 3704 0044 0532 0130 01", @(STPCardValidationStateInvalid)],
+                       @[@"DE89 3704 0044 0532 0130 000", @(STPCardValidationStateInvalid)],
+                       @[@"DE00", @(STPCardValidationStateInvalid)],
+                       @[@"DEX", @(STPCardValidationStateInvalid)],
+                       @[@"1", @(STPCardValidationStateInvalid)],
+                       @[@"ZZ", @(STPCardValidationStateInvalid)],
+                       @[@"DE89 3704-0044", @(STPCardValidationStateInvalid)],
+                       @[@"LC55HEMM000100010012001200023015LC55", @(STPCardValidationStateInvalid)],
+                       ];
+    for (NSArray *test in tests) {
+        XCTAssertEqualObjects(@([STPBankAccountValidator validationStateForIBAN:test[0]]), test[1], @"%@", test[0]);
+    }
+    XCTAssertEqual([STPBankAccountValidator validationStateForIBAN:nil], STPCardValidationStateIncomplete);
+}
+
+- (void)testIBANLengths {
+    XCTAssertEqual([STPBankAccountValidator lengthOfIBANForCountry:@"DE"], (NSUInteger)22);
+    XCTAssertEqual([STPBankAccountValidator lengthOfIBANForCountry:@"no"], (NSUInteger)15);
+    XCTAssertEqual([STPBankAccountValidator lengthOfIBANForCountry:@"US"], (NSUInteger)0);
+    XCTAssertEqual([STPBankAccountValidator lengthOfIBANForCountry:nil], (NSUInteger)0);
+}
+
+@end
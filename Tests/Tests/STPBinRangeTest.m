@@ -116,6 +116,18 @@
     XCTAssertEqual(binRanges.count, 1U);
 }
 
+- (void)testBinRangesForNumberMatchesStringComparison {
+    NSArray<NSString *> *numbers = @[@"", @"0", @"2", @"22", @"2221", @"27209", @"272100", @"3", @"34", @"3782822463",
+                                     @"4", @"41", @"4136", @"41360", @"413600", @"4136000000008", @"4929", @"492930",
+                                     @"492931", @"5", @"6", @"60", @"6011", @"6012", @"622", @"65", @"66", @"9999999"];
+    for (NSString *number in numbers) {
+        NSArray *expected = [[STPBINRange allRanges] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(STPBINRange *range, __unused NSDictionary *bindings) {
+            return [range matchesNumber:number];
+        }]];
+        XCTAssertEqualObjects([STPBINRange binRangesForNumber:number], expected, @"%@", number);
+    }
+}
+
 - (void)testBinRangesForBrand {
     NSArray *allBrands = @[@(STPCardBrandVisa),
                            @(STPCardBrandAmex),
@@ -132,6 +144,34 @@
     }
 }
 
+- (void)testBuiltInRangesAreUnique {
+    [STPBINRange installAdditionalRanges:@[]];
+    NSMutableSet<NSString *> *seen = [NSMutableSet set];
+    for (STPBINRange *range in [STPBINRange allRanges]) {
+        NSString *key = [NSString stringWithFormat:@"%@-%@-%lu-%ld", range.qRangeLow, range.qRangeHigh, (unsigned long)range.length, (long)range.brand];
+        XCTAssertFalse([seen containsObject:key], @"%@", key);
+        [seen addObject:key];
+    }
+    XCTAssertEqualObjects([STPBINRange allRanges].firstObject.qRangeLow, @"");
+}
+
+- (void)testBrandLengthsMatchRanges {
+    NSArray<STPBINRange *> *additionalRanges = @[[[STPBINRange alloc] initWithQRangeLow:@"6060" qRangeHigh:@"6060" length:19 brand:STPCardBrandDiscover]];
+    for (NSArray<STPBINRange *> *ranges in @[@[], additionalRanges]) {
+        XCTAssertTrue([STPBINRange installAdditionalRanges:ranges]);
+        for (NSInteger brand = STPCardBrandVisa; brand <= STPCardBrandUnknown; brand++) {
+            NSSet *expectedLengths = [NSSet setWithArray:[[STPBINRange binRangesForBrand:brand] valueForKey:@"length"]];
+            XCTAssertEqualObjects([STPBINRange lengthsForBrand:brand], expectedLengths);
+            XCTAssertEqual([STPBINRange maxLengthForBrand:brand], [[expectedLengths valueForKeyPath:@"@max.self"] integerValue]);
+        }
+    }
+    XCTAssertEqual([STPBINRange maxLengthForBrand:STPCardBrandDiscover], 19);
+    [STPBINRange installAdditionalRanges:@[]];
+    XCTAssertEqual([STPBINRange maxLengthForBrand:STPCardBrandDiscover], 16);
+    XCTAssertEqualObjects([STPBINRange binRangesForBrand:(STPCardBrand)100], @[]);
+    XCTAssertEqual([STPBINRange maxLengthForBrand:(STPCardBrand)100], -1);
+}
+
 - (void)testMostSpecificBinRangeForNumber {
     STPBINRange *binRange;
     
@@ -149,6 +189,13 @@
     binRange = [STPBINRange mostSpecificBINRangeForNumber:@"4242424242424242"];
     XCTAssertEqual(binRange.brand, STPCardBrandVisa);
     XCTAssertEqual(binRange.length, 16U);
+
+    binRange = [STPBINRange mostSpecificBINRangeForNumber:@"2221000000000009"];
+    XCTAssertEqual(binRange.brand, STPCardBrandMasterCard);
+    XCTAssertEqual(binRange.qRangeLow.length, 6U);
+
+    binRange = [STPBINRange mostSpecificBINRangeForNumber:@"1234"];
+    XCTAssertEqual(binRange.brand, STPCardBrandUnknown);
 }
 
 @end
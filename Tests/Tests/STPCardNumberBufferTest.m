@@ -0,0 +1,83 @@
+//
+//  STPCardNumberBufferTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPCardNumberBuffer.h"
+#import "STPCardParams+Private.h"
+#import "STPFormEncoder.h"
+#import "STPPaymentCardTextFieldViewModel.h"
+
+@interface STPCardNumberBufferTest : XCTestCase
+@end
+
+@implementation STPCardNumberBufferTest
+
+- (void)testReadsDigits {
+    STPCardNumberBuffer *buffer = [[STPCardNumberBuffer alloc] initWithString:@"4242 4242-4242 4242"];
+    XCTAssertEqual(buffer.length, (NSUInteger)16);
+    XCTAssertEqualObjects([buffer stringValue], @"4242424242424242");
+    XCTAssertEqual(buffer.brand, STPCardBrandVisa);
+
+    [buffer setString:@"12345678901234567890"];
+    XCTAssertEqualObjects([buffer stringValue], @"1234567890123456789");
+
+    [buffer truncateToLength:4];
+    XCTAssertEqualObjects([buffer stringValue], @"1234");
+    XCTAssertEqual(buffer.digits->values[4], 0);
+}
+
+- (void)testClearZeroesDigits {
+    STPCardNumberBuffer *buffer = [[STPCardNumberBuffer alloc] initWithString:@"4242424242424242"];
+    STPCardNumberBuffer *copy = [buffer copy];
+    [buffer clear];
+    XCTAssertEqual(buffer.length, (NSUInteger)0);
+    XCTAssertEqualObjects([buffer stringValue], @"");
+    for (NSUInteger i = 0; i < STPCardNumberMaxDigits; i++) {
+        XCTAssertEqual(buffer.digits->values[i], 0);
+    }
+    XCTAssertEqualObjects([copy stringValue], @"4242424242424242");
+}
+
+- (void)testAppendToData {
+    STPCardNumberBuffer *buffer = [[STPCardNumberBuffer alloc] initWithString:@"4242424242424242"];
+    NSMutableData *data = [NSMutableData dataWithBytes:"x" length:1];
+    [buffer appendToData:data];
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"x4242424242424242");
+}
+
+- (void)testCardParamsEncodeBuffer {
+    STPCardParams *params = [STPCardParams new];
+    params.numberBuffer = [[STPCardNumberBuffer alloc] initWithString:@"4242424242424242"];
+    XCTAssertEqualObjects(params.number, @"4242424242424242");
+    XCTAssertEqualObjects(params.last4, @"4242");
+    NSDictionary *parameters = [STPFormEncoder dictionaryForObject:params];
+    XCTAssertTrue([[STPFormEncoder queryStringFromParameters:parameters] containsString:@"card%5Bnumber%5D=4242424242424242"]);
+
+    params.number = @"4000 0000 0000 0077";
+    XCTAssertNil(params.numberBuffer);
+    XCTAssertEqualObjects(params.number, @"4000 0000 0000 0077");
+    parameters = [STPFormEncoder dictionaryForObject:params];
+    XCTAssertTrue([[STPFormEncoder queryStringFromParameters:parameters] containsString:@"card%5Bnumber%5D=4000%200000%200000%200077"]);
+}
+
+- (void)testViewModelClear {
+    STPPaymentCardTextFieldViewModel *viewModel = [STPPaymentCardTextFieldViewModel new];
+    XCTAssertNil(viewModel.cardNumber);
+    viewModel.cardNumber = @"4242424242424242";
+    STPCardNumberBuffer *buffer = viewModel.cardNumberBuffer;
+    XCTAssertEqual(buffer.length, (NSUInteger)16);
+
+    [viewModel clear];
+    XCTAssertEqual(buffer.length, (NSUInteger)0);
+    XCTAssertEqualObjects(viewModel.cardNumber, @"");
+    XCTAssertEqual(viewModel.brand, STPCardBrandUnknown);
+    XCTAssertEqual([viewModel validationStateForField:STPCardFieldTypeNumber], STPCardValidationStateIncomplete);
+}
+
+@end
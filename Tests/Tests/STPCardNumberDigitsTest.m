@@ -0,0 +1,90 @@
+//
+//  STPCardNumberDigitsTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPCardNumberDigits.h"
+
+@interface STPCardNumberDigitsTest : XCTestCase
+@end
+
+@implementation STPCardNumberDigitsTest
+
+- (NSString *)formattedNumber:(NSString *)number brand:(STPCardBrand)brand {
+    STPCardNumberDigits digits;
+    STPCardNumberDigitsRead(number, YES, &digits);
+    unichar characters[STPCardNumberMaxFormattedLength];
+    NSUInteger length = STPCardNumberDigitsFormat(&digits, brand, characters);
+    return [NSString stringWithCharacters:characters length:length];
+}
+
+- (void)testRead {
+    STPCardNumberDigits digits;
+    XCTAssertEqual(STPCardNumberDigitsRead(@"4242 4242\t4242 4242", NO, &digits), STPCardNumberDigitsReadResultOK);
+    XCTAssertEqual(digits.count, (NSUInteger)16);
+    XCTAssertEqual(digits.values[0], 4);
+    XCTAssertEqual(digits.values[1], 2);
+
+    XCTAssertEqual(STPCardNumberDigitsRead(@"", NO, &digits), STPCardNumberDigitsReadResultOK);
+    XCTAssertEqual(digits.count, (NSUInteger)0);
+    XCTAssertEqual(STPCardNumberDigitsRead(nil, NO, &digits), STPCardNumberDigitsReadResultOK);
+    XCTAssertEqual(digits.count, (NSUInteger)0);
+
+    XCTAssertEqual(STPCardNumberDigitsRead(@"4242-4242", NO, &digits), STPCardNumberDigitsReadResultInvalidCharacter);
+    XCTAssertEqual(STPCardNumberDigitsRead(@"4242-4242", YES, &digits), STPCardNumberDigitsReadResultOK);
+    XCTAssertEqual(digits.count, (NSUInteger)8);
+
+    XCTAssertEqual(STPCardNumberDigitsRead(@"12345678901234567890", NO, &digits), STPCardNumberDigitsReadResultTooLong);
+    XCTAssertEqual(digits.count, STPCardNumberMaxDigits);
+}
+
+- (void)testLuhn {
+    NSArray<NSString *> *valid = @[@"4242424242424242", @"378282246310005", @"6011111111111117", @"0"];
+    NSArray<NSString *> *invalid = @[@"4242424242424241", @"378282246310006", @"1"];
+    STPCardNumberDigits digits;
+    for (NSString *number in valid) {
+        STPCardNumberDigitsRead(number, NO, &digits);
+        XCTAssertTrue(STPCardNumberDigitsAreValidLuhn(&digits), @"%@", number);
+    }
+    for (NSString *number in invalid) {
+        STPCardNumberDigitsRead(number, NO, &digits);
+        XCTAssertFalse(STPCardNumberDigitsAreValidLuhn(&digits), @"%@", number);
+    }
+}
+
+- (void)testBrand {
+    NSDictionary<NSString *, NSNumber *> *brands = @{
+                                                     @"4242424242424242": @(STPCardBrandVisa),
+                                                     @"4": @(STPCardBrandVisa),
+                                                     @"378282246310005": @(STPCardBrandAmex),
+                                                     @"5555555555554444": @(STPCardBrandMasterCard),
+                                                     @"6011111111111117": @(STPCardBrandDiscover),
+                                                     @"3530111333300000": @(STPCardBrandJCB),
+                                                     @"30569309025904": @(STPCardBrandDinersClub),
+                                                     // Could still be several brands
+                                                     @"3": @(STPCardBrandUnknown),
+                                                     @"": @(STPCardBrandUnknown),
+                                                     @"9999": @(STPCardBrandUnknown),
+                                                     };
+    [brands enumerateKeysAndObjectsUsingBlock:^(NSString *number, NSNumber *brand, __unused BOOL *stop) {
+        STPCardNumberDigits digits;
+        STPCardNumberDigitsRead(number, NO, &digits);
+        XCTAssertEqual(STPCardNumberDigitsBrand(&digits), (STPCardBrand)brand.integerValue, @"%@", number);
+    }];
+}
+
+- (void)testFormat {
+    XCTAssertEqualObjects([self formattedNumber:@"4242424242424242" brand:STPCardBrandVisa], @"4242 4242 4242 4242");
+    XCTAssertEqualObjects([self formattedNumber:@"378282246310005" brand:STPCardBrandAmex], @"3782 822463 10005");
+    XCTAssertEqualObjects([self formattedNumber:@"42424" brand:STPCardBrandVisa], @"4242 4");
+    XCTAssertEqualObjects([self formattedNumber:@"4242" brand:STPCardBrandVisa], @"4242");
+    XCTAssertEqualObjects([self formattedNumber:@"4242424242424242123" brand:STPCardBrandVisa], @"4242 4242 4242 4242123");
+    XCTAssertEqualObjects([self formattedNumber:@"" brand:STPCardBrandUnknown], @"");
+}
+
+@end
@@ -0,0 +1,84 @@
+//
+//  STPCardNumberSessionTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPCardNumberSession.h"
+#import "STPCardValidator.h"
+
+@interface STPCardNumberSessionTest : XCTestCase <STPCardNumberSessionDelegate>
+@property (nonatomic) NSUInteger brandChangeCount;
+@property (nonatomic) NSUInteger validationStateChangeCount;
+@end
+
+@implementation STPCardNumberSessionTest
+
+- (void)cardNumberSessionDidChangeBrand:(__unused STPCardNumberSession *)session {
+    self.brandChangeCount++;
+}
+
+- (void)cardNumberSessionDidChangeValidationState:(__unused STPCardNumberSession *)session {
+    self.validationStateChangeCount++;
+}
+
+- (void)assertSession:(STPCardNumberSession *)session matchesValidatorForNumber:(NSString *)number {
+    XCTAssertEqualObjects(session.number, number);
+    XCTAssertEqual(session.brand, [STPCardValidator brandForNumber:number]);
+    XCTAssertEqual(session.maxLength, [STPCardValidator maxLengthForCardBrand:[STPCardValidator brandForNumber:number]]);
+    XCTAssertEqual(session.validationState, [STPCardValidator validationStateForNumber:number validatingCardBrand:YES]);
+}
+
+- (void)testTypingAndDeletingMatchesValidator {
+    STPCardNumberSession *session = [STPCardNumberSession new];
+    [self assertSession:session matchesValidatorForNumber:@""];
+    for (NSString *number in @[@"4242424242424242", @"378282246310005", @"6011111111111117", @"2221000000000009", @"30569309025904"]) {
+        for (NSUInteger i = 1; i <= number.length; i++) {
+            [session appendDigits:[number substringWithRange:NSMakeRange(i - 1, 1)]];
+            [self assertSession:session matchesValidatorForNumber:[number substringToIndex:i]];
+        }
+        for (NSUInteger i = number.length; i > 0; i--) {
+            [session deleteDigits:1];
+            [self assertSession:session matchesValidatorForNumber:[number substringToIndex:i - 1]];
+        }
+    }
+}
+
+- (void)testSetNumber {
+    STPCardNumberSession *session = [STPCardNumberSession new];
+    [session setNumber:@"4242 4242 4242 4242"];
+    [self assertSession:session matchesValidatorForNumber:@"4242424242424242"];
+    [session setNumber:@"378282246310005"];
+    [self assertSession:session matchesValidatorForNumber:@"378282246310005"];
+    [session setNumber:@"3782"];
+    [self assertSession:session matchesValidatorForNumber:@"3782"];
+    [session deleteDigits:10];
+    [self assertSession:session matchesValidatorForNumber:@""];
+}
+
+- (void)testDelegateOnlyHearsAboutChanges {
+    STPCardNumberSession *session = [STPCardNumberSession new];
+    session.delegate = self;
+
+    [session appendDigits:@"4"];
+    XCTAssertEqual(self.brandChangeCount, 1U);
+    [session appendDigits:@"24242424242"];
+    XCTAssertEqual(self.brandChangeCount, 1U);
+    XCTAssertEqual(self.validationStateChangeCount, 0U);
+
+    [session appendDigits:@"4242"];
+    XCTAssertEqual(session.validationState, STPCardValidationStateValid);
+    XCTAssertEqual(self.validationStateChangeCount, 1U);
+
+    [session deleteDigits:15];
+    XCTAssertEqual(self.brandChangeCount, 1U);
+    XCTAssertEqual(self.validationStateChangeCount, 2U);
+    [session deleteDigits:1];
+    XCTAssertEqual(self.brandChangeCount, 2U);
+}
+
+@end
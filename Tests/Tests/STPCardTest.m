@@ -93,6 +93,20 @@
     XCTAssertEqualObjects(card1, card2, @"cards with equal data should be equal");
 }
 
+- (void)testCardHashMatchesIdentifier {
+    STPCard *decoded = [STPCard decodedObjectFromAPIResponse:[self completeAttributeDictionary]];
+    STPCard *initialized = [[STPCard alloc] initWithID:decoded.cardId brand:STPCardBrandVisa last4:@"4242" expMonth:12 expYear:2030 funding:STPCardFundingTypeCredit];
+    XCTAssertEqual(decoded.hash, decoded.cardId.hash);
+    XCTAssertEqual(initialized.hash, decoded.hash);
+    XCTAssertEqualObjects(initialized, decoded);
+
+    NSMutableDictionary *otherResponse = [[self completeAttributeDictionary] mutableCopy];
+    otherResponse[@"id"] = @"card_other";
+    STPCard *other = [STPCard decodedObjectFromAPIResponse:otherResponse];
+    XCTAssertNotEqualObjects(other, decoded);
+    XCTAssertEqual([NSSet setWithObjects:decoded, initialized, other, nil].count, 2U);
+}
+
 - (void)testAddress {
     NSMutableDictionary *apiResponse = [[self completeAttributeDictionary] mutableCopy];
     STPCard *card = [STPCard decodedObjectFromAPIResponse:apiResponse];
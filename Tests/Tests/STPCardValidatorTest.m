@@ -11,6 +11,8 @@
 
 #import "STPCardValidationState.h"
 #import "STPCardValidator.h"
+#import "STPCardValidator+Private.h"
+#import "STPValidationClock.h"
 
 @interface STPCardValidatorTest : XCTestCase
 @end
@@ -44,13 +46,44 @@
                        @[@"XXXXXX", @""],
                        @[@"424242424242424X", @"424242424242424"],
                        @[@"X4242", @"4242"],
-                       @[@"4242 4242 4242 4242", @"4242424242424242"]
+                       @[@"4242 4242 4242 4242", @"4242424242424242"],
+                       @[@"4242-4242-4242-4242 4242-4242-4242-4242 4242-4242-4242-4242 4242-4242-4242-4242X",
+                         @"4242424242424242424242424242424242424242424242424242424242424242"],
                        ];
     for (NSArray *test in tests) {
         XCTAssertEqualObjects([STPCardValidator sanitizedNumericStringForString:test[0]], test[1]);
     }
 }
 
+- (void)testNumberSanitizationMatchesCharacterScan {
+    // Covers runs of every length around the eight-character blocks the
+    // vector path works on, and characters just outside '0'...'9'.
+    NSArray<NSString *> *fillers = @[@"/", @":", @" ", @"-", @"\u0664", @"\uFF14", @"\U0001F4B3"];
+    NSMutableSet<NSString *> *seen = [NSMutableSet set];
+    for (NSUInteger length = 0; length < 40; length++) {
+        for (NSString *filler in fillers) {
+            for (NSUInteger step = 1; step < 11; step++) {
+                NSMutableString *string = [NSMutableString string];
+                NSMutableString *expected = [NSMutableString string];
+                for (NSUInteger i = 0; i < length; i++) {
+                    if (i % step == step - 1) {
+                        [string appendString:filler];
+                    } else {
+                        NSString *digit = [NSString stringWithFormat:@"%lu", (unsigned long)(i % 10)];
+                        [string appendString:digit];
+                        [expected appendString:digit];
+                    }
+                }
+                NSString *sanitized = [STPCardValidator sanitizedNumericStringForString:string];
+                XCTAssertEqualObjects(sanitized, expected, @"%@", string);
+                [seen addObject:string];
+            }
+        }
+    }
+    XCTAssertGreaterThan(seen.count, 1000U);
+    XCTAssertEqualObjects([STPCardValidator sanitizedNumericStringForString:@""], @"");
+}
+
 - (void)testNumberValidation {
     NSMutableArray *tests = [@[] mutableCopy];
     
@@ -60,6 +93,7 @@
     
     [tests addObject:@[@(STPCardValidationStateValid), @"4242 4242 4242 4242"]];
     [tests addObject:@[@(STPCardValidationStateValid), @"4136000000008"]];
+    [tests addObject:@[@(STPCardValidationStateValid), @" 4242\t4242 4242 4242 "]];
 
     NSArray *badCardNumbers = @[
                                 @"0000000000000000",
@@ -70,6 +104,8 @@
                                 @"9999999999999999999999",
                                 @"42424242424242424242",
                                 @"4242-4242-4242-4242",
+                                @"4242424242424241",
+                                @"4242 4242 4242 4242 4",
                                 ];
     
     for (NSString *card in badCardNumbers) {
@@ -83,7 +119,8 @@
                                      @"",
                                      @"    ",
                                      @"6011",
-                                     @"4012888888881"
+                                     @"4012888888881",
+                                     @"  4242                                              ",
                                      ];
 
     for (NSString *card in possibleCardNumbers) {
@@ -254,5 +291,54 @@
     }
 }
 
+- (NSDate *)dateWithYear:(NSInteger)year month:(NSInteger)month {
+    NSDateComponents *components = [NSDateComponents new];
+    components.year = year;
+    components.month = month;
+    components.day = 1;
+    NSCalendar *calendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+    return [calendar dateFromComponents:components];
+}
+
+- (void)testValidationClock {
+    STPValidationClock *clock = [[STPValidationClock alloc] initWithDate:[self dateWithYear:2015 month:8]];
+    XCTAssertEqual(clock.currentYear, 15);
+    XCTAssertEqual(clock.currentMonth, 8);
+
+    XCTAssertEqual([STPCardValidator validationStateForExpirationYear:@"15" inMonth:@"08" clock:clock], STPCardValidationStateValid);
+    XCTAssertEqual([STPCardValidator validationStateForExpirationYear:@"15" inMonth:@"07" clock:clock], STPCardValidationStateInvalid);
+    XCTAssertEqual([STPCardValidator validationStateForExpirationYear:@"14" inMonth:@"12" clock:clock], STPCardValidationStateInvalid);
+
+    STPValidationClock *sharedClock = [STPValidationClock sharedClock];
+    NSDateComponents *now = [[[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian] components:(NSCalendarUnitYear | NSCalendarUnitMonth) fromDate:[NSDate date]];
+    XCTAssertEqual(sharedClock.currentYear, now.year % 100);
+    XCTAssertEqual(sharedClock.currentMonth, now.month);
+}
+
+- (void)testValidationStatesForCards {
+    NSArray *tests = @[
+                       @[@"4242424242424242", @(12), @(15), @"123", @(STPCardValidationStateValid)],
+                       @[@"4242424242424242", @(7), @(15), @"123", @(STPCardValidationStateInvalid)],
+                       @[@"4242424242424242", @(12), @(15), @"", @(STPCardValidationStateIncomplete)],
+                       @[@"378282246310005", @(12), @(15), @"1234", @(STPCardValidationStateValid)],
+                       @[@"1234567812345678", @(12), @(15), @"123", @(STPCardValidationStateInvalid)],
+                       ];
+    NSMutableArray<STPCardParams *> *cards = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *expected = [NSMutableArray array];
+    for (NSArray *test in tests) {
+        STPCardParams *card = [[STPCardParams alloc] init];
+        card.number = test[0];
+        card.expMonth = [test[1] integerValue];
+        card.expYear = [test[2] integerValue];
+        card.cvc = test[3];
+        [cards addObject:card];
+        [expected addObject:test[4]];
+    }
+
+    NSDate *referenceDate = [self dateWithYear:2015 month:8];
+
+    XCTAssertEqualObjects([STPCardValidator validationStatesForCards:cards referenceDate:referenceDate], expected);
+    XCTAssertEqualObjects([STPCardValidator validationStatesForCards:@[] referenceDate:referenceDate], @[]);
+}
 
 @end
@@ -0,0 +1,141 @@
+//
+//  STPCheckoutAPIClientTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPCheckoutAPIClient.h"
+#import "STPCheckoutAccountSession.h"
+#import "STPCheckoutBootstrapResponse.h"
+
+@interface STPCheckoutAPIClient (Testing)
+@property(nonatomic)STPCheckoutAccountSession *credentials;
+@property(nonatomic, readonly)BOOL bootstrapExpired;
++ (dispatch_queue_t)bootstrapCacheQueue;
+- (NSMutableURLRequest *)accountRequestWithURL:(NSURL *)url;
+- (void)handleAccountResponse:(NSURLResponse *)response;
+- (BOOL)restoreSavedBootstrapWithURLSession:(NSURLSession *)urlSession;
+- (void)finishBootstrap:(STPCheckoutBootstrapResponse *)bootstrap
+            credentials:(STPCheckoutAccountSession *)credentials
+             URLSession:(NSURLSession *)urlSession
+                   date:(NSDate *)date;
+- (void)saveBootstrap;
+@end
+
+@interface STPCheckoutAPIClientTest : XCTestCase
+@property(nonatomic)NSURL *cacheURL;
+@end
+
+@implementation STPCheckoutAPIClientTest
+
+- (void)setUp {
+    [super setUp];
+    NSString *name = [[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"plist"];
+    self.cacheURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.cacheURL error:NULL];
+    [super tearDown];
+}
+
+- (NSURL *)checkoutURL {
+    return [NSURL URLWithString:@"https://checkout.stripe.com/api"];
+}
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:[self checkoutURL] statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:headers];
+}
+
+- (STPCheckoutBootstrapResponse *)bootstrapResponse {
+    return [STPCheckoutBootstrapResponse bootstrapResponseWithJSON:@{
+                                                                     @"checkoutPublishableKey": @"pk_test_checkout_token",
+                                                                     @"sessionID": @"session_123",
+                                                                     @"securityToken": @"csrf",
+                                                                     @"accountsDisabled": @NO,
+                                                                     @"apiEndpoint": @"https://api.stripe.com",
+                                                                     @"livemode": @NO,
+                                                                     }];
+}
+
+- (void)testAccountRequestsCarrySessionHeaders {
+    STPCheckoutAPIClient *client = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:nil];
+    client.credentials = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL]
+                                                               response:[self responseWithStatusCode:200 headers:@{@"Set-Cookie": @"session=abc; Path=/"}]
+                                                              csrfToken:@"csrf"];
+    NSMutableURLRequest *request = [client accountRequestWithURL:[NSURL URLWithString:@"https://checkout.stripe.com/api/account"]];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Cookie"], @"session=abc");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-CSRF-Token"], @"csrf");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-Stripe-Client"], @"iossdk");
+    XCTAssertFalse(request.HTTPShouldHandleCookies);
+}
+
+- (void)testAccountResponsesRotateSession {
+    STPCheckoutAccountSession *session = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL]
+                                                                               response:[self responseWithStatusCode:200 headers:@{@"Set-Cookie": @"session=abc; Path=/"}]
+                                                                              csrfToken:@"csrf"];
+    NSHTTPURLResponse *rotation = [self responseWithStatusCode:200 headers:@{@"Set-Cookie": @"session=def; Path=/", @"X-CSRF-Token": @"csrf2"}];
+    XCTAssertTrue([session updateWithResponse:rotation]);
+    XCTAssertFalse([session updateWithResponse:rotation]);
+    XCTAssertFalse([session updateWithResponse:[self responseWithStatusCode:200 headers:@{}]]);
+    NSDictionary *headers = [session requestHeaders];
+    XCTAssertEqualObjects(headers[@"Cookie"], @"session=def");
+    XCTAssertEqualObjects(headers[@"X-CSRF-Token"], @"csrf2");
+}
+
+- (void)testSessionPropertyListRoundTrips {
+    STPCheckoutAccountSession *session = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL]
+                                                                               response:[self responseWithStatusCode:200 headers:@{@"Set-Cookie": @"session=abc; Path=/"}]
+                                                                              csrfToken:@"csrf"];
+    NSDictionary *propertyList = [session propertyListValue];
+    XCTAssertTrue([NSPropertyListSerialization propertyList:propertyList isValidForFormat:NSPropertyListBinaryFormat_v1_0]);
+    STPCheckoutAccountSession *restored = [STPCheckoutAccountSession sessionWithPropertyList:propertyList URL:[self checkoutURL]];
+    XCTAssertEqualObjects([restored requestHeaders], [session requestHeaders]);
+    XCTAssertNil([STPCheckoutAccountSession sessionWithPropertyList:@{} URL:[self checkoutURL]]);
+}
+
+- (void)testRestoresSavedBootstrap {
+    STPCheckoutAPIClient *client = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:self.cacheURL];
+    STPCheckoutAccountSession *credentials = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL]
+                                                                                   response:[self responseWithStatusCode:200 headers:@{@"Set-Cookie": @"session=abc; Path=/"}]
+                                                                                  csrfToken:@"csrf"];
+    [client finishBootstrap:[self bootstrapResponse] credentials:credentials URLSession:[NSURLSession sharedSession] date:[NSDate date]];
+    [client saveBootstrap];
+    dispatch_sync([STPCheckoutAPIClient bootstrapCacheQueue], ^{});
+
+    STPCheckoutAPIClient *nextClient = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:self.cacheURL];
+    XCTAssertTrue([nextClient restoreSavedBootstrapWithURLSession:[NSURLSession sharedSession]]);
+    XCTAssertTrue(nextClient.readyForLookups);
+    NSMutableURLRequest *request = [nextClient accountRequestWithURL:[NSURL URLWithString:@"https://checkout.stripe.com/api/account"]];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Cookie"], @"session=abc");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"X-CSRF-Token"], @"csrf");
+}
+
+- (void)testIgnoresOldSavedBootstrap {
+    STPCheckoutAPIClient *client = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:self.cacheURL];
+    STPCheckoutAccountSession *credentials = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL] response:nil csrfToken:@"csrf"];
+    [client finishBootstrap:[self bootstrapResponse] credentials:credentials URLSession:[NSURLSession sharedSession] date:[NSDate dateWithTimeIntervalSinceNow:-31 * 60]];
+    [client saveBootstrap];
+    dispatch_sync([STPCheckoutAPIClient bootstrapCacheQueue], ^{});
+
+    STPCheckoutAPIClient *nextClient = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:self.cacheURL];
+    XCTAssertFalse([nextClient restoreSavedBootstrapWithURLSession:[NSURLSession sharedSession]]);
+}
+
+- (void)testRejectedSessionIsNotRestored {
+    STPCheckoutAPIClient *client = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_checkout" bootstrapCacheURL:self.cacheURL];
+    STPCheckoutAccountSession *credentials = [[STPCheckoutAccountSession alloc] initWithURL:[self checkoutURL] response:nil csrfToken:@"csrf"];
+    [client finishBootstrap:[self bootstrapResponse] credentials:credentials URLSession:[NSURLSession sharedSession] date:[NSDate date]];
+    [client saveBootstrap];
+    [client handleAccountResponse:[self responseWithStatusCode:403 headers:@{}]];
+    dispatch_sync([STPCheckoutAPIClient bootstrapCacheQueue], ^{});
+
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.cacheURL.path]);
+    XCTAssertTrue(client.bootstrapExpired);
+}
+
+@end
@@ -0,0 +1,195 @@
+//
+//  STPConcurrencySoakTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+#import <stdatomic.h>
+
+#import "STPAPIClient+Private.h"
+#import "STPNetworkReplayProtocol.h"
+#import "STPPromise.h"
+#import "STPTestUtils.h"
+
+// Run by the StripeiOSSoakTests scheme, which also turns on Thread Sanitizer
+static NSString *const STPSoakTestsEnvironmentKey = @"STP_SOAK_TESTS";
+
+static NSUInteger const STPSoakPollerCount = 200;
+static NSUInteger const STPSoakPromiseCount = 500;
+static NSUInteger const STPSoakCallbacksPerPromise = 8;
+
+@interface STPAPIClient (Soak)
+@property (nonatomic, readwrite) NSMutableDictionary<NSString *, NSObject *> *sourcePollers;
+@property (nonatomic, readwrite) dispatch_queue_t sourcePollersQueue;
+@end
+
+/**
+ Long-running concurrency tests for source polling and promises. They're
+ skipped unless STP_SOAK_TESTS is set.
+ */
+@interface STPConcurrencySoakTest : XCTestCase
+@end
+
+@implementation STPConcurrencySoakTest
+
++ (XCTestSuite *)defaultTestSuite {
+    if ([NSProcessInfo processInfo].environment[STPSoakTestsEnvironmentKey] == nil) {
+        return [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+    }
+    return [super defaultTestSuite];
+}
+
+- (void)setUp {
+    [super setUp];
+    [STPNetworkReplayProtocol reset];
+}
+
+- (void)tearDown {
+    [STPNetworkReplayProtocol reset];
+    [super tearDown];
+}
+
+- (void)waitForRunLoopInterval:(NSTimeInterval)interval {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:interval]];
+}
+
+- (void)postLifecycleNotificationStorm:(NSUInteger)iterations {
+    NSArray<NSString *> *names = @[
+                                   UIApplicationWillResignActiveNotification,
+                                   UIApplicationDidEnterBackgroundNotification,
+                                   UIApplicationWillEnterForegroundNotification,
+                                   UIApplicationDidBecomeActiveNotification,
+                                   ];
+    // UIKit posts these on the main thread, spread over the run loop.
+    for (NSUInteger i = 0; i < iterations; i++) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(i * 5 * NSEC_PER_MSEC)), dispatch_get_main_queue(), ^{
+            [[NSNotificationCenter defaultCenter] postNotificationName:names[i % names.count] object:nil];
+        });
+    }
+}
+
+- (void)testConcurrentPollersWithLifecycleStorm {
+    STPAPIClient *apiClient = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_soak"];
+    apiClient.urlSession = [STPNetworkReplayProtocol session];
+
+    NSDictionary *pending = [STPTestUtils jsonNamed:@"3DSSource"];
+    NSMutableDictionary *chargeable = [pending mutableCopy];
+    chargeable[@"status"] = @"chargeable";
+    NSMutableArray<NSString *> *identifiers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < STPSoakPollerCount; i++) {
+        NSString *identifier = [NSString stringWithFormat:@"src_soak_%lu", (unsigned long)i];
+        NSMutableDictionary *pendingSource = [pending mutableCopy];
+        pendingSource[@"id"] = identifier;
+        NSMutableDictionary *chargeableSource = [chargeable mutableCopy];
+        chargeableSource[@"id"] = identifier;
+        [STPNetworkReplayProtocol stubMethod:@"GET"
+                                        path:[@"/v1/sources/" stringByAppendingString:identifier]
+                             withJSONObjects:@[pendingSource, pendingSource, chargeableSource]];
+        [identifiers addObject:identifier];
+    }
+
+    // Every fourth poller is stopped from a background queue while it runs.
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray array];
+    for (NSUInteger i = 0; i < STPSoakPollerCount; i++) {
+        if (i % 4 != 3) {
+            [expectations addObject:[self expectationWithDescription:identifiers[i]]];
+        }
+    }
+    __block _Atomic(long) completionCount = 0;
+    NSDate *start = [NSDate date];
+    [self postLifecycleNotificationStorm:200];
+    dispatch_apply(STPSoakPollerCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        NSString *identifier = identifiers[i];
+        XCTestExpectation *expectation = (i % 4 != 3) ? expectations[i - i / 4] : nil;
+        [apiClient startPollingSourceWithId:identifier
+                               clientSecret:pending[@"client_secret"]
+                                    timeout:60
+                                 completion:^(STPSource *source, NSError *error) {
+                                     XCTAssertTrue([NSThread isMainThread]);
+                                     if (expectation) {
+                                         XCTAssertNil(error);
+                                         XCTAssertEqual(source.status, STPSourceStatusChargeable);
+                                         [expectation fulfill];
+                                     }
+                                     atomic_fetch_add(&completionCount, 1);
+                                 }];
+        if (!expectation) {
+            [apiClient stopPollingSourceWithId:identifier];
+        }
+    });
+    [self waitForExpectationsWithTimeout:120 handler:nil];
+    NSTimeInterval elapsed = [[NSDate date] timeIntervalSinceDate:start];
+
+    NSUInteger requestCount = 0;
+    for (NSString *identifier in identifiers) {
+        requestCount += [STPNetworkReplayProtocol requestCountForMethod:@"GET" path:[@"/v1/sources/" stringByAppendingString:identifier]];
+    }
+    NSLog(@"Soak: %lu pollers finished %lu polls in %.2fs (%.0f polls/s)",
+          (unsigned long)atomic_load(&completionCount), (unsigned long)requestCount, elapsed, requestCount / elapsed);
+
+    // Finished and stopped pollers must all be released.
+    [self waitForRunLoopInterval:0.5];
+    __block NSUInteger remainingPollers = 0;
+    dispatch_sync(apiClient.sourcePollersQueue, ^{
+        remainingPollers = apiClient.sourcePollers.count;
+    });
+    XCTAssertEqual(remainingPollers, 0U);
+}
+
+- (void)testConcurrentPromiseChains {
+    dispatch_queue_t queue = dispatch_queue_create("com.stripe.soaktest", DISPATCH_QUEUE_CONCURRENT);
+    __block _Atomic(long) callbackCount = 0;
+    NSHashTable *promises = [NSHashTable weakObjectsHashTable];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"chains"];
+    NSUInteger expectedCallbacks = STPSoakPromiseCount * STPSoakCallbacksPerPromise;
+    NSDate *start = [NSDate date];
+
+    @autoreleasepool {
+        NSMutableArray<STPPromise *> *roots = [NSMutableArray array];
+        for (NSUInteger i = 0; i < STPSoakPromiseCount; i++) {
+            STPPromise *root = [STPPromise new];
+            [roots addObject:root];
+            [promises addObject:root];
+        }
+        // Callbacks are added from many threads while the promises complete.
+        dispatch_apply(STPSoakPromiseCount, queue, ^(size_t i) {
+            STPPromise *root = roots[i];
+            for (NSUInteger j = 0; j < STPSoakCallbacksPerPromise; j++) {
+                if (j == STPSoakCallbacksPerPromise / 2) {
+                    dispatch_async(queue, ^{
+                        if (i % 2 == 0) {
+                            [root succeed:@(i)];
+                        } else {
+                            [root fail:[NSError errorWithDomain:@"soak" code:(NSInteger)i userInfo:nil]];
+                        }
+                    });
+                }
+                STPPromise *chained = [[root map:^id(id value) {
+                    return value;
+                } onQueue:queue] flatMap:^STPPromise *(id value) {
+                    return [STPPromise promiseWithValue:value];
+                } onQueue:queue];
+                [chained onCompletion:^(id value, NSError *error) {
+                    XCTAssertTrue((value == nil) != (error == nil));
+                    if (atomic_fetch_add(&callbackCount, 1) + 1 == (long)expectedCallbacks) {
+                        [expectation fulfill];
+                    }
+                } onQueue:queue];
+            }
+        });
+        [self waitForExpectationsWithTimeout:60 handler:nil];
+    }
+    NSTimeInterval elapsed = [[NSDate date] timeIntervalSinceDate:start];
+    NSLog(@"Soak: %lu promise callbacks in %.2fs (%.0f callbacks/s)",
+          (unsigned long)expectedCallbacks, elapsed, expectedCallbacks / elapsed);
+
+    XCTAssertEqual(atomic_load(&callbackCount), (long)expectedCallbacks);
+    [self waitForRunLoopInterval:0.5];
+    XCTAssertEqual(promises.allObjects.count, 0U, @"Completed promises should be released");
+}
+
+@end
@@ -0,0 +1,46 @@
+//
+//  STPCoreTableViewControllerTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPCoreTableViewController+Private.h"
+#import "STPTheme.h"
+
+@interface STPCoreTableViewControllerTest : XCTestCase
+@end
+
+@implementation STPCoreTableViewControllerTest
+
+- (void)testCachedHeights {
+    STPCoreTableViewController *sut = [[STPCoreTableViewController alloc] initWithTheme:[STPTheme defaultTheme]];
+    __block NSUInteger computations = 0;
+    CGFloat (^height)(NSString *, CGFloat) = ^CGFloat(NSString *contentKey, CGFloat width) {
+        return [sut cachedHeightForContentKey:contentKey width:width computation:^CGFloat{
+            computations++;
+            return width / 10;
+        }];
+    };
+
+    XCTAssertEqualWithAccuracy(height(@"header", 320), 32, 0.001);
+    XCTAssertEqualWithAccuracy(height(@"header", 320), 32, 0.001);
+    XCTAssertEqual(computations, 1U);
+
+    XCTAssertEqualWithAccuracy(height(@"header", 375), 37.5, 0.001);
+    height(@"other header", 320);
+    XCTAssertEqual(computations, 3U);
+
+    sut.theme = [STPTheme new];
+    height(@"header", 320);
+    XCTAssertEqual(computations, 4U);
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIContentSizeCategoryDidChangeNotification object:nil];
+    height(@"header", 320);
+    XCTAssertEqual(computations, 5U);
+}
+
+@end
@@ -0,0 +1,59 @@
+//
+//  STPCountryListTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPCountryList.h"
+#import "STPLocalizationUtils.h"
+
+@interface STPCountryListTest : XCTestCase
+@end
+
+@implementation STPCountryListTest
+
+- (void)testCurrentList {
+    STPCountryList *list = [STPCountryList currentList];
+    NSString *countryCode = [[NSLocale currentLocale] objectForKey:NSLocaleCountryCode];
+    XCTAssertEqual(list.countryCodes.count, list.displayNames.count);
+    XCTAssertEqualObjects(list.countryCodes.firstObject, @"");
+    XCTAssertEqualObjects(list.displayNames.firstObject, @"");
+    if (countryCode) {
+        XCTAssertEqualObjects(list.countryCodes[1], countryCode);
+    }
+    NSSet *codes = [NSSet setWithArray:list.countryCodes];
+    XCTAssertEqual(codes.count, [NSLocale ISOCountryCodes].count + 1);
+
+    NSUInteger first = countryCode ? 2 : 1;
+    for (NSUInteger i = first + 1; i < list.displayNames.count; i++) {
+        XCTAssertNotEqual([list.displayNames[i - 1] compare:list.displayNames[i]], NSOrderedDescending);
+    }
+    NSUInteger us = [list.countryCodes indexOfObject:@"US"];
+    XCTAssertEqualObjects(list.displayNames[us], [STPCountryList displayNameForCountryCode:@"US"]);
+}
+
+- (void)testListIsShared {
+    [STPCountryList prepareCurrentList];
+    XCTAssertEqual([STPCountryList currentList], [STPCountryList currentList]);
+}
+
+- (void)testDisplayNameForCountryCode {
+    XCTAssertNotNil([STPCountryList displayNameForCountryCode:@"US"]);
+    XCTAssertNil([STPCountryList displayNameForCountryCode:@""]);
+    XCTAssertNil([STPCountryList displayNameForCountryCode:nil]);
+    XCTAssertNil([STPCountryList displayNameForCountryCode:@"not a country"]);
+}
+
+- (void)testNamesFollowStringsLanguage {
+    [STPLocalizationUtils overrideLanguageTo:@"de"];
+    XCTAssertEqualObjects([STPCountryList displayNameForCountryCode:@"DE"], @"Deutschland");
+    STPCountryList *list = [STPCountryList currentList];
+    XCTAssertEqualObjects(list.displayNames[[list.countryCodes indexOfObject:@"DE"]], @"Deutschland");
+    [STPLocalizationUtils overrideLanguageTo:nil];
+}
+
+@end
@@ -0,0 +1,141 @@
+//
+//  STPCustomerCacheTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPCardTuple.h"
+#import "STPCustomerCache.h"
+#import "STPFixtures.h"
+#import "STPPaymentContext+Private.h"
+#import "STPTestUtils.h"
+
+@interface STPDeferredAPIAdapter : NSObject<STPBackendAPIAdapter>
+@property(nonatomic)STPCustomer *customer;
+@property(nonatomic)BOOL deferred;
+@property(nonatomic, copy)STPCustomerCompletionBlock pendingCompletion;
+@property(nonatomic)NSUInteger retrieveCount;
+@end
+
+@implementation STPDeferredAPIAdapter
+
+- (void)retrieveCustomer:(STPCustomerCompletionBlock)completion {
+    self.retrieveCount++;
+    if (self.deferred) {
+        self.pendingCompletion = completion;
+    } else {
+        completion(self.customer, nil);
+    }
+}
+
+- (void)attachSourceToCustomer:(__unused id<STPSourceProtocol>)source completion:(STPErrorBlock)completion {
+    completion(nil);
+}
+
+- (void)selectDefaultCustomerSource:(__unused id<STPSourceProtocol>)source completion:(STPErrorBlock)completion {
+    completion(nil);
+}
+
+@end
+
+@interface STPCustomerCacheTest : XCTestCase
+
+@end
+
+@implementation STPCustomerCacheTest
+
+- (void)tearDown {
+    [[STPCustomerCache sharedCache] removeAllCustomers];
+    [super tearDown];
+}
+
+- (void)testRetrieveRemembersCustomerPerAdapter {
+    STPDeferredAPIAdapter *adapter = [STPDeferredAPIAdapter new];
+    adapter.customer = [STPFixtures customerWithSingleCardTokenSource];
+    STPDeferredAPIAdapter *otherAdapter = [STPDeferredAPIAdapter new];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"retrieve"];
+    [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:adapter completion:^(STPCustomer *customer, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(customer, adapter.customer);
+        expectation.fulfill();
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    XCTAssertEqual([[STPCustomerCache sharedCache] customerForAPIAdapter:adapter], adapter.customer);
+    XCTAssertNil([[STPCustomerCache sharedCache] customerForAPIAdapter:otherAdapter]);
+}
+
+- (void)testCardTupleEquality {
+    STPCustomer *customer = [STPFixtures customerWithSingleCardTokenSource];
+    STPCardTuple *tuple = [STPCardTuple tupleWithCustomer:customer];
+    XCTAssertEqual(tuple.cards.count, 1U);
+    XCTAssertNotNil(tuple.selectedCard);
+    XCTAssertTrue([tuple isEqualToCardTuple:[STPCardTuple tupleWithCustomer:customer]]);
+    XCTAssertFalse([tuple isEqualToCardTuple:[STPCardTuple tupleWithSelectedCard:nil cards:nil]]);
+}
+
+- (void)testPaymentContextShowsCachedCustomerWhileRevalidating {
+    STPDeferredAPIAdapter *adapter = [STPDeferredAPIAdapter new];
+    adapter.customer = [STPFixtures customerWithSingleCardTokenSource];
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.customerCachingEnabled = YES;
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"initial load"];
+    STPPaymentContext *firstContext = [[STPPaymentContext alloc] initWithAPIAdapter:adapter configuration:config theme:[STPTheme defaultTheme]];
+    [firstContext.currentValuePromise onSuccess:^(__unused STPPaymentMethodTuple *tuple) {
+        expectation.fulfill();
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    adapter.deferred = YES;
+    STPPaymentContext *sut = [[STPPaymentContext alloc] initWithAPIAdapter:adapter configuration:config theme:[STPTheme defaultTheme]];
+    XCTAssertNotNil(adapter.pendingCompletion);
+    // The cached customer is shown as soon as its tuple is built, without
+    // waiting for the adapter.
+    XCTestExpectation *cachedLoad = [self expectationWithDescription:@"cached load"];
+    [sut.currentValuePromise onSuccess:^(__unused STPPaymentMethodTuple *tuple) {
+        [cachedLoad fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertFalse(sut.loading);
+    XCTAssertEqual(sut.paymentMethods.count, 1U);
+
+    STPCustomerDeserializer *deserializer = [[STPCustomerDeserializer alloc] initWithJSONResponse:[STPTestUtils jsonNamed:@"Customer"]];
+    adapter.pendingCompletion(deserializer.customer, nil);
+    XCTAssertEqualObjects([[STPCustomerCache sharedCache] customerForAPIAdapter:adapter], deserializer.customer);
+    NSUInteger expectedCount = [STPCardTuple tupleWithCustomer:deserializer.customer].cards.count;
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(STPPaymentContext *context, __unused NSDictionary *bindings) {
+        return context.paymentMethods.count == expectedCount;
+    }] evaluatedWithObject:sut handler:nil];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testConcurrentRetrievesShareOneRequest {
+    STPDeferredAPIAdapter *adapter = [STPDeferredAPIAdapter new];
+    adapter.customer = [STPFixtures customerWithSingleCardTokenSource];
+    adapter.deferred = YES;
+
+    __block NSUInteger completions = 0;
+    STPCustomerCompletionBlock completion = ^(STPCustomer *customer, __unused NSError *error) {
+        XCTAssertEqual(customer, adapter.customer);
+        completions++;
+    };
+    [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:adapter completion:completion];
+    [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:adapter completion:completion];
+    XCTAssertEqual(adapter.retrieveCount, 1U);
+
+    adapter.pendingCompletion(adapter.customer, nil);
+    XCTAssertEqual(completions, 2U);
+
+    [[STPCustomerCache sharedCache] retrieveCustomerWithAPIAdapter:adapter completion:completion];
+    XCTAssertEqual(adapter.retrieveCount, 2U);
+    [[STPCustomerCache sharedCache] refreshCustomerWithAPIAdapter:adapter completion:completion];
+    XCTAssertEqual(adapter.retrieveCount, 3U);
+}
+
+@end
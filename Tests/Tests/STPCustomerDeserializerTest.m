@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "STPCustomer.h"
+#import "STPFixtures.h"
 #import "StripeError.h"
 #import "STPTestUtils.h"
 #import "STPSourceProtocol.h"
@@ -88,4 +89,49 @@
     XCTAssertEqualObjects(sut.customer.sources[3].stripeID, threeDSSource[@"id"]);
 }
 
+- (void)testInitWithJSONResponse_hasMoreSources {
+    NSMutableDictionary *customer = [[STPTestUtils jsonNamed:@"Customer"] mutableCopy];
+    STPCustomerDeserializer *sut = [[STPCustomerDeserializer alloc] initWithJSONResponse:customer];
+    XCTAssertFalse(sut.customer.hasMoreSources);
+
+    NSMutableDictionary *sources = [customer[@"sources"] mutableCopy];
+    sources[@"has_more"] = @YES;
+    customer[@"sources"] = sources;
+    sut = [[STPCustomerDeserializer alloc] initWithJSONResponse:customer];
+    XCTAssertTrue(sut.customer.hasMoreSources);
+}
+
+- (void)testInitWithJSONResponse_largeWallet {
+    STPCustomer *customer = [STPFixtures customerWithSourceCount:1000];
+    XCTAssertEqual(customer.sources.count, 1000U);
+    XCTAssertEqualObjects(customer.defaultSource.stripeID, @"card_0");
+    XCTAssertEqualObjects(customer.sources[999].stripeID, @"src_999");
+}
+
+- (void)testSourcesDeserializer_validJSON {
+    NSMutableDictionary *card = [[STPTestUtils jsonNamed:@"Card"] mutableCopy];
+    card[@"id"] = @"card_123";
+    NSMutableDictionary *applePayCard = [card mutableCopy];
+    applePayCard[@"id"] = @"card_apple_pay";
+    applePayCard[@"tokenization_method"] = @"apple_pay";
+    NSDictionary *cardSource = [STPTestUtils jsonNamed:@"CardSource"];
+
+    NSDictionary *json = @{@"object": @"list",
+                           @"data": @[card, applePayCard, cardSource],
+                           @"has_more": @YES};
+    STPCustomerSourcesDeserializer *sut = [[STPCustomerSourcesDeserializer alloc] initWithJSONResponse:json];
+    XCTAssertNil(sut.error);
+    XCTAssertTrue(sut.hasMore);
+    XCTAssertTrue(sut.sources.count == 2);
+    XCTAssertEqualObjects(sut.sources[0].stripeID, card[@"id"]);
+    XCTAssertEqualObjects(sut.sources[1].stripeID, cardSource[@"id"]);
+}
+
+- (void)testSourcesDeserializer_invalidJSON {
+    STPCustomerSourcesDeserializer *sut = [[STPCustomerSourcesDeserializer alloc] initWithJSONResponse:@{@"data": @"nope"}];
+    XCTAssertNil(sut.sources);
+    XCTAssertFalse(sut.hasMore);
+    XCTAssertEqualObjects(sut.error, [NSError stp_genericFailedToParseResponseError]);
+}
+
 @end
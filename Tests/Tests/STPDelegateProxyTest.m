@@ -29,6 +29,11 @@
 
 @end
 
+@interface PartialTestDelegate : NSObject<TestDelegate>
+@end
+@implementation PartialTestDelegate
+@end
+
 @interface TestClass : NSObject
 @property (nonatomic, weak) id<TestDelegate> delegate;
 @end
@@ -70,4 +75,21 @@
     XCTAssertEqualObjects([sut invokeDelegate2], @"bar");
 }
 
+- (void)testChangingDelegateInvalidatesResolvedTargets {
+    TestDelegateProxy *proxy = [TestDelegateProxy new];
+    PartialTestDelegate *partialDelegate = [PartialTestDelegate new];
+    proxy.delegate = partialDelegate;
+    XCTAssertFalse([proxy respondsToSelector:@selector(delegateMethod1)]);
+    XCTAssertTrue([proxy respondsToSelector:@selector(delegateMethod2)]);
+
+    ConcreteTestDelegate *delegate = [ConcreteTestDelegate new];
+    proxy.delegate = delegate;
+    XCTAssertTrue([proxy respondsToSelector:@selector(delegateMethod1)]);
+    XCTAssertEqualObjects([(id<TestDelegate>)proxy delegateMethod1], @"foo");
+    XCTAssertEqualObjects([(id<TestDelegate>)proxy delegateMethod2], @"bar");
+
+    proxy.delegate = nil;
+    XCTAssertFalse([proxy respondsToSelector:@selector(delegateMethod1)]);
+}
+
 @end
@@ -20,6 +20,8 @@
                              @"test+thing@test.com.nz",
                              @"a@b.c",
                              @"A@b.c",
+                             @"first.last@sub-domain.example.co",
+                             @"o'hara!#$%&*/=?^_`{|}~-@x1.y2",
                              ];
     for (NSString *email in validEmails) {
         XCTAssert([STPEmailAddressValidator stringIsValidEmailAddress:email]);
@@ -31,11 +33,32 @@
                                @"",
                                @"google.com",
                                @"asdf",
-                               @"asdg@c"
+                               @"asdg@c",
+                               @".test@test.com",
+                               @"test.@test.com",
+                               @"te..st@test.com",
+                               @"test@@test.com",
+                               @"test@test..com",
+                               @"test@-test.com",
+                               @"test@test-.com",
+                               @"test@test.com-",
+                               @"test@test.com.",
+                               @"té@test.com",
+                               @"test@test.com ",
                                ];
     for (NSString *email in invalidEmails) {
         XCTAssertFalse([STPEmailAddressValidator stringIsValidEmailAddress:email]);
     }
 }
 
+- (void)testPartialEmails {
+    for (NSString *email in @[@"", @"test", @"test@", @"test@test.com"]) {
+        XCTAssertTrue([STPEmailAddressValidator stringIsValidPartialEmailAddress:email]);
+    }
+    for (NSString *email in @[@"@@", @"test@test@", @"test@test.com@"]) {
+        XCTAssertFalse([STPEmailAddressValidator stringIsValidPartialEmailAddress:email]);
+    }
+    XCTAssertTrue([STPEmailAddressValidator stringIsValidPartialEmailAddress:nil]);
+}
+
 @end
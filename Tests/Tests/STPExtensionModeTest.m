@@ -0,0 +1,40 @@
+//
+//  STPExtensionModeTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPAnalyticsClient.h"
+#import "STPExtensionMode.h"
+
+@interface STPExtensionModeTest : XCTestCase
+@end
+
+@implementation STPExtensionModeTest
+
+- (void)tearDown {
+    stpSetExtensionModeEnabled(NO);
+    [super tearDown];
+}
+
+- (void)testSharedApplication {
+    XCTAssertNotNil(stpSharedApplication());
+    stpSetExtensionModeEnabled(YES);
+    XCTAssertNil(stpSharedApplication());
+}
+
+- (void)testAnalyticsClientDoesNotUpload {
+    stpSetExtensionModeEnabled(YES);
+    STPAnalyticsClient *client = [STPAnalyticsClient new];
+    XCTAssertNil([client valueForKey:@"uploader"]);
+    XCTAssertNil([client valueForKey:@"urlSession"]);
+    // Reports of API requests are ignored rather than queued
+    [client apiRequestDidStart];
+    [client apiRequestDidFinish];
+}
+
+@end
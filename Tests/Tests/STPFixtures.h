@@ -39,6 +39,20 @@
  */
 + (STPCustomer *)customerWithSingleCardTokenSource;
 
+/**
+ The JSON for a Customer object with `sourceCount` sources, for measuring how
+ decoding and the payment method UI scale with the size of a wallet. Sources
+ alternate between card tokens and card sources, cycle through the card
+ brands, and have distinct IDs and last 4 digits. default_source is the first
+ source.
+ */
++ (NSDictionary *)customerJSONWithSourceCount:(NSUInteger)sourceCount;
+
+/**
+ The Customer object decoded from `customerJSONWithSourceCount:`.
+ */
++ (STPCustomer *)customerWithSourceCount:(NSUInteger)sourceCount;
+
 /**
  A Source object with type iDEAL
  */
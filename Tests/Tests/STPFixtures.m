@@ -49,6 +49,45 @@
     return deserializer.customer;
 }
 
++ (NSDictionary *)customerJSONWithSourceCount:(NSUInteger)sourceCount {
+    NSDictionary *card = [STPTestUtils jsonNamed:@"Card"];
+    NSDictionary *cardSource = [STPTestUtils jsonNamed:@"CardSource"];
+    NSArray<NSString *> *brands = @[@"Visa", @"MasterCard", @"American Express", @"Discover", @"JCB", @"Diners Club"];
+    NSMutableArray<NSDictionary *> *data = [NSMutableArray arrayWithCapacity:sourceCount];
+    for (NSUInteger i = 0; i < sourceCount; i++) {
+        NSString *last4 = [NSString stringWithFormat:@"%04lu", (unsigned long)(i % 10000)];
+        NSString *brand = brands[i % brands.count];
+        if (i % 2 == 0) {
+            NSMutableDictionary *json = [card mutableCopy];
+            json[@"id"] = [NSString stringWithFormat:@"card_%lu", (unsigned long)i];
+            json[@"brand"] = brand;
+            json[@"last4"] = last4;
+            [data addObject:json];
+        } else {
+            NSMutableDictionary *json = [cardSource mutableCopy];
+            NSMutableDictionary *details = [json[@"card"] mutableCopy];
+            details[@"brand"] = brand;
+            details[@"last4"] = last4;
+            json[@"id"] = [NSString stringWithFormat:@"src_%lu", (unsigned long)i];
+            json[@"card"] = details;
+            [data addObject:json];
+        }
+    }
+
+    NSMutableDictionary *customer = [[STPTestUtils jsonNamed:@"Customer"] mutableCopy];
+    NSMutableDictionary *sources = [customer[@"sources"] mutableCopy];
+    sources[@"data"] = data;
+    sources[@"total_count"] = @(sourceCount);
+    customer[@"sources"] = sources;
+    customer[@"default_source"] = data.firstObject[@"id"] ?: [NSNull null];
+    return customer;
+}
+
++ (STPCustomer *)customerWithSourceCount:(NSUInteger)sourceCount {
+    STPCustomerDeserializer *deserializer = [[STPCustomerDeserializer alloc] initWithJSONResponse:[self customerJSONWithSourceCount:sourceCount]];
+    return deserializer.customer;
+}
+
 + (STPSource *)iDEALSource {
     return [STPSource decodedObjectFromAPIResponse:[STPTestUtils jsonNamed:@"iDEALSource"]];
 }
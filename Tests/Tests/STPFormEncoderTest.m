@@ -9,6 +9,7 @@
 @import XCTest;
 #import "STPFormEncoder.h"
 #import "STPFormEncodable.h"
+#import "STPCardParams.h"
 
 @interface STPTestFormEncodableObject : NSObject<STPFormEncodable>
 @property(nonatomic) NSString *testProperty;
@@ -127,6 +128,23 @@
     XCTAssertEqualObjects([self encodeObject:testObject], @"test_property=success");
 }
 
+- (void)testFormEncoding_scalarProperties {
+    STPCardParams *cardParams = [STPCardParams new];
+    cardParams.number = @"4242424242424242";
+    cardParams.expMonth = 12;
+    cardParams.expYear = 2020;
+    NSDictionary *card = [STPFormEncoder dictionaryForObject:cardParams][@"card"];
+    XCTAssertEqualObjects(card[@"number"], @"4242424242424242");
+    XCTAssertEqualObjects(card[@"exp_month"], @12);
+    XCTAssertEqualObjects(card[@"exp_year"], @2020);
+    XCTAssertNil(card[@"cvc"]);
+
+    // The cached encoding plan is reused for later objects of the same class
+    cardParams.expMonth = 1;
+    card = [STPFormEncoder dictionaryForObject:cardParams][@"card"];
+    XCTAssertEqualObjects(card[@"exp_month"], @1);
+}
+
 - (void)testQueryStringFromParameters {
     NSDictionary *params = @{
                              @"foo": @"bar",
@@ -138,4 +156,41 @@
     XCTAssertEqualObjects(result, @"baz%5Bqux%5D=1&foo=bar");
 }
 
+- (void)testQueryStringFromParameters_arraysAndNull {
+    NSDictionary *params = @{
+                             @"list": @[@"a", @{@"b": @"c"}],
+                             @"empty": [NSNull null],
+                             };
+    NSString *result = [STPFormEncoder queryStringFromParameters:params];
+    XCTAssertEqualObjects(result, @"empty&list%5B%5D=a&list%5B%5D%5Bb%5D=c");
+}
+
+- (void)testStringByURLEncoding {
+    XCTAssertEqualObjects([STPFormEncoder stringByURLEncoding:@"azAZ09-._~/?"], @"azAZ09-._~/?");
+    XCTAssertEqualObjects([STPFormEncoder stringByURLEncoding:@":#[]@!$&'()*+,;= "], @"%3A%23%5B%5D%40%21%24%26%27%28%29%2A%2B%2C%3B%3D%20");
+    XCTAssertEqualObjects([STPFormEncoder stringByURLEncoding:@"caf\u00e9 \U0001F474\U0001F3FB"], @"caf%C3%A9%20%F0%9F%91%B4%F0%9F%8F%BB");
+
+    NSString *longString = [@"" stringByPaddingToLength:1000 withString:@"a&" startingAtIndex:0];
+    NSString *expected = [@"" stringByPaddingToLength:2000 withString:@"a%26" startingAtIndex:0];
+    XCTAssertEqualObjects([STPFormEncoder stringByURLEncoding:longString], expected);
+}
+
+- (void)testAppendFormDataFromParameters {
+    NSMutableData *data = [NSMutableData data];
+    [STPFormEncoder appendFormDataFromParameters:@{@"foo": @"bar"} toData:data];
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"foo=bar");
+
+    data.length = 0;
+    [STPFormEncoder appendFormDataFromParameters:@{@"foo": @"baz qux"} toData:data];
+    XCTAssertEqualObjects(data, [STPFormEncoder formDataFromParameters:@{@"foo": @"baz qux"}]);
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"foo=baz%20qux");
+}
+
+- (void)testQueryStringFromParameters_dataValue {
+    NSString *json = @"{\"data\":\"caf\u00e9 1+1\"}";
+    NSData *data = [json dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects([STPFormEncoder queryStringFromParameters:@{@"pk_token": data}],
+                          [STPFormEncoder queryStringFromParameters:@{@"pk_token": json}]);
+}
+
 @end
@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "STPFormTextField.h"
+#import "STPFormTextField+Private.h"
 
 @interface STPFormTextFieldTest : XCTestCase
 
@@ -63,4 +64,50 @@
     XCTAssertNil(value);
 }
 
+- (void)testCaretMapping {
+    STPFormTextFieldAutoFormattingBehavior phone = STPFormTextFieldAutoFormattingBehaviorPhoneNumbers;
+    NSString *formatted = @"(123) 456-789";
+    // After the "4", whether from just before or after the separators
+    XCTAssertEqual([STPFormTextField unformattedOffsetForOffset:7 inString:formatted behavior:phone], 4U);
+    XCTAssertEqual([STPFormTextField unformattedOffsetForOffset:6 inString:formatted behavior:phone], 3U);
+    XCTAssertEqual([STPFormTextField offsetForUnformattedOffset:4 inString:formatted behavior:phone], 7U);
+    XCTAssertEqual([STPFormTextField offsetForUnformattedOffset:3 inString:formatted behavior:phone], 4U);
+    XCTAssertEqual([STPFormTextField offsetForUnformattedOffset:0 inString:formatted behavior:phone], 0U);
+    XCTAssertEqual([STPFormTextField offsetForUnformattedOffset:20 inString:formatted behavior:phone], formatted.length);
+    XCTAssertEqual([STPFormTextField unformattedOffsetForOffset:100 inString:formatted behavior:phone], 9U);
+
+    // Every raw offset survives a round trip through a long formatted string
+    NSMutableString *pasted = [NSMutableString string];
+    for (NSUInteger i = 0; i < 100; i++) {
+        [pasted appendFormat:@"%lu-", (unsigned long)(i % 10)];
+    }
+    for (NSUInteger i = 0; i <= 100; i++) {
+        NSUInteger offset = [STPFormTextField offsetForUnformattedOffset:i inString:pasted behavior:phone];
+        XCTAssertEqual([STPFormTextField unformattedOffsetForOffset:offset inString:pasted behavior:phone], i);
+    }
+
+    STPFormTextFieldAutoFormattingBehavior none = STPFormTextFieldAutoFormattingBehaviorNone;
+    XCTAssertEqual([STPFormTextField unformattedOffsetForOffset:5 inString:formatted behavior:none], 5U);
+    XCTAssertEqual([STPFormTextField offsetForUnformattedOffset:5 inString:formatted behavior:none], 5U);
+}
+
+- (void)testSettingSameTextKeepsSelection {
+    STPFormTextField *sut = [STPFormTextField new];
+    sut.autoFormattingBehavior = STPFormTextFieldAutoFormattingBehaviorPhoneNumbers;
+    sut.text = @"123456789";
+    UITextPosition *position = [sut positionFromPosition:sut.beginningOfDocument offset:3];
+    sut.selectedTextRange = [sut textRangeFromPosition:position toPosition:position];
+    sut.text = @"123456789";
+    XCTAssertEqualObjects(sut.text, @"(123) 456-789");
+    XCTAssertEqual([sut offsetFromPosition:sut.beginningOfDocument toPosition:sut.selectedTextRange.start], 3);
+}
+
+- (void)testKeyCommandsAreShared {
+    STPFormTextField *sut = [STPFormTextField new];
+    NSArray *keyCommands = sut.keyCommands;
+    XCTAssertEqual(keyCommands.count, 1U);
+    XCTAssertEqual(sut.keyCommands, keyCommands);
+    XCTAssertEqual([STPFormTextField new].keyCommands, keyCommands);
+}
+
 @end
@@ -0,0 +1,55 @@
+//
+//  STPFormValidityTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPFormValidity.h"
+
+@interface STPFormValidityTest : XCTestCase
+@end
+
+@implementation STPFormValidityTest
+
+- (void)testValidOnceEverySectionIs {
+    STPFormValidity *validity = [[STPFormValidity alloc] initWithSectionCount:3];
+    XCTAssertFalse(validity.isValid);
+    [validity setValid:YES forSection:0];
+    [validity setValid:YES forSection:2];
+    XCTAssertFalse(validity.isValid);
+    XCTAssertTrue([validity isSectionValid:2]);
+    XCTAssertFalse([validity isSectionValid:1]);
+
+    [validity setValid:YES forSection:1];
+    XCTAssertTrue(validity.isValid);
+    [validity setValid:NO forSection:0];
+    XCTAssertFalse(validity.isValid);
+}
+
+- (void)testChangeHandlerOnlyRunsForChanges {
+    STPFormValidity *validity = [[STPFormValidity alloc] initWithSectionCount:2];
+    NSMutableArray<NSNumber *> *changes = [NSMutableArray array];
+    validity.changeHandler = ^(__unused STPFormValidity *changed, NSUInteger section) {
+        [changes addObject:@(section)];
+    };
+    [validity setValid:NO forSection:0];
+    [validity setValid:YES forSection:1];
+    [validity setValid:YES forSection:1];
+    [validity setValid:NO forSection:1];
+    XCTAssertEqualObjects(changes, (@[@1, @1]));
+}
+
+- (void)testSixtyFourSections {
+    STPFormValidity *validity = [[STPFormValidity alloc] initWithSectionCount:64];
+    for (NSUInteger section = 0; section < 64; section++) {
+        XCTAssertFalse(validity.isValid);
+        [validity setValid:YES forSection:section];
+    }
+    XCTAssertTrue(validity.isValid);
+}
+
+@end
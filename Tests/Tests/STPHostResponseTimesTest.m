@@ -0,0 +1,60 @@
+//
+//  STPHostResponseTimesTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPHostResponseTimes.h"
+
+@interface STPHostResponseTimesTest : XCTestCase
+
+@end
+
+@implementation STPHostResponseTimesTest
+
+- (void)testUnknownHostKeepsDefaults {
+    STPHostResponseTimes *responseTimes = [STPHostResponseTimes new];
+    XCTAssertEqual([responseTimes timeoutIntervalForHost:@"api.stripe.com" defaultTimeout:60], 60);
+    XCTAssertEqual([responseTimes hedgeDelayForHost:@"api.stripe.com"], 0);
+}
+
+- (void)testFastHostGetsMinimumTimeout {
+    STPHostResponseTimes *responseTimes = [STPHostResponseTimes new];
+    for (NSUInteger i = 0; i < 10; i++) {
+        [responseTimes recordResponseTime:0.1 forHost:@"api.stripe.com"];
+    }
+    XCTAssertEqual([responseTimes timeoutIntervalForHost:@"api.stripe.com" defaultTimeout:60], 15);
+    XCTAssertEqual([responseTimes hedgeDelayForHost:@"api.stripe.com"], 0.5);
+    // Shorter defaults are never lengthened
+    XCTAssertEqual([responseTimes timeoutIntervalForHost:@"api.stripe.com" defaultTimeout:5], 5);
+}
+
+- (void)testSlowHostIsCappedAtDefaults {
+    STPHostResponseTimes *responseTimes = [STPHostResponseTimes new];
+    [responseTimes recordResponseTime:8 forHost:@"api.stripe.com"];
+    XCTAssertEqual([responseTimes timeoutIntervalForHost:@"api.stripe.com" defaultTimeout:60], 60);
+    XCTAssertEqual([responseTimes hedgeDelayForHost:@"api.stripe.com"], 5);
+}
+
+- (void)testVariableResponsesLengthenTimeout {
+    STPHostResponseTimes *steady = [STPHostResponseTimes new];
+    STPHostResponseTimes *variable = [STPHostResponseTimes new];
+    for (NSUInteger i = 0; i < 20; i++) {
+        [steady recordResponseTime:0.5 forHost:@"api.stripe.com"];
+        [variable recordResponseTime:(i % 2 ? 0.1 : 0.9) forHost:@"api.stripe.com"];
+    }
+    XCTAssertLessThan([steady hedgeDelayForHost:@"api.stripe.com"], [variable hedgeDelayForHost:@"api.stripe.com"]);
+}
+
+- (void)testHostsAreTrackedSeparately {
+    STPHostResponseTimes *responseTimes = [STPHostResponseTimes new];
+    [responseTimes recordResponseTime:0.2 forHost:@"API.stripe.com"];
+    XCTAssertGreaterThan([responseTimes hedgeDelayForHost:@"api.stripe.com"], 0);
+    XCTAssertEqual([responseTimes hedgeDelayForHost:@"q.stripe.com"], 0);
+}
+
+@end
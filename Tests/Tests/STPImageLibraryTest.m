@@ -9,6 +9,7 @@
 #import <XCTest/XCTest.h>
 #import "STPCardBrand.h"
 #import "STPImageLibrary.h"
+#import "STPImageLibrary+Private.h"
 
 @interface STPImageLibraryTest : XCTestCase
 @property NSArray<NSNumber *> *cardBrands;
@@ -53,6 +54,19 @@
     }
 }
 
+- (void)testBrandImagesAreCutFromAtlas {
+    CGFloat scale = [UIScreen mainScreen].scale;
+    for (NSNumber *brand in self.cardBrands) {
+        UIImage *image = [STPImageLibrary brandImageForCardBrand:[brand integerValue] template:NO];
+        XCTAssertEqual(image.scale, scale);
+        XCTAssertTrue(CGSizeEqualToSize(image.size, CGSizeMake(32, 20)));
+        XCTAssertEqual(CGImageGetWidth(image.CGImage), (size_t)(32 * scale));
+    }
+    UIImage *templateImage = [STPImageLibrary brandImageForCardBrand:STPCardBrandVisa template:YES];
+    XCTAssertTrue(CGSizeEqualToSize(templateImage.size, CGSizeMake(26, 18)));
+    XCTAssertEqual(templateImage.renderingMode, UIImageRenderingModeAlwaysTemplate);
+}
+
 - (void)testCVCImageForCardBrand {
     for (NSNumber *brand in self.cardBrands) {
         UIImage *image = [STPImageLibrary cvcImageForCardBrand:[brand integerValue]];
@@ -60,4 +74,34 @@
     }
 }
 
+- (void)testRenderedImagesAreCached {
+    for (NSNumber *brand in self.cardBrands) {
+        UIImage *image = [STPImageLibrary brandImageForCardBrand:[brand integerValue]];
+        XCTAssertEqual(image, [STPImageLibrary brandImageForCardBrand:[brand integerValue]]);
+    }
+    UIImage *image = [STPImageLibrary leftChevronIcon];
+    UIImage *tinted = [STPImageLibrary imageWithTintColor:[UIColor redColor] forImage:image];
+    XCTAssertEqual(tinted, [STPImageLibrary imageWithTintColor:[UIColor redColor] forImage:image]);
+    XCTAssertNotEqual(tinted, [STPImageLibrary imageWithTintColor:[UIColor blueColor] forImage:image]);
+    UIImage *padded = [STPImageLibrary paddedImageWithInsets:UIEdgeInsetsMake(1, 2, 3, 4) forImage:image];
+    XCTAssertEqual(padded, [STPImageLibrary paddedImageWithInsets:UIEdgeInsetsMake(1, 2, 3, 4) forImage:image]);
+    XCTAssertTrue(CGSizeEqualToSize(padded.size, CGSizeMake(image.size.width + 6, image.size.height + 4)));
+}
+
+- (void)testPrepareThumbnails {
+    UIImage *image = [STPImageLibrary templatedBrandImageForCardBrand:STPCardBrandVisa];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"thumbnails"];
+    [STPImageLibrary prepareThumbnailsForImages:@[image] scale:2 completion:^{
+        XCTAssertTrue([NSThread isMainThread]);
+        UIImage *thumbnail = [STPImageLibrary thumbnailForImage:image scale:2];
+        XCTAssertNotNil(thumbnail);
+        XCTAssertEqual(thumbnail.scale, 2);
+        XCTAssertTrue(CGSizeEqualToSize(thumbnail.size, image.size));
+        XCTAssertEqual(thumbnail.renderingMode, UIImageRenderingModeAlwaysTemplate);
+        XCTAssertNil([STPImageLibrary thumbnailForImage:image scale:3]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
 @end
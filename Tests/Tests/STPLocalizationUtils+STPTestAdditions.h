@@ -9,5 +9,11 @@
 #import "STPLocalizationUtils.h"
 
 @interface STPLocalizationUtils (TestAdditions)
-+ (void)overrideLanguageTo:(nullable NSString *)string;
+
+/**
+ Reads the Stripe string table for `language` straight from disk, bypassing
+ the cache.
+ */
++ (nonnull NSDictionary<NSString *, NSString *> *)stringTableForLanguage:(nonnull NSString *)language;
+
 @end
@@ -11,32 +11,12 @@
 
 @implementation STPLocalizationUtils (TestAdditions)
 
-static NSString *languageOverride = nil;
-
-+ (void)overrideLanguageTo:(NSString *)string {
-    languageOverride = string;
-}
-
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wobjc-protocol-method-implementation"
-
-
-/**
- Clobber the real implementation with this one that lets us change
- the lproj
- */
-+ (NSString *)localizedStripeStringForKey:(NSString *)key {
-    NSBundle *bundle = [STPBundleLocator stripeResourcesBundle];
-    
-    if (languageOverride) {
-        
-        NSString *lprojPath = [bundle pathForResource:languageOverride ofType:@"lproj"];
-        if (lprojPath) {
-            bundle = [NSBundle bundleWithPath:lprojPath];
-        }
-    }
-    return [bundle localizedStringForKey:key value:nil table:nil];
++ (NSDictionary<NSString *, NSString *> *)stringTableForLanguage:(NSString *)language {
+    NSString *path = [[STPBundleLocator stripeResourcesBundle] pathForResource:@"Localizable"
+                                                                        ofType:@"strings"
+                                                                   inDirectory:nil
+                                                               forLocalization:language];
+    return [NSDictionary dictionaryWithContentsOfFile:path] ?: @{};
 }
-#pragma clang diagnostic pop
 
 @end
@@ -0,0 +1,39 @@
+//
+//  STPLocalizationUtilsTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPLocalizationUtils.h"
+#import "STPLocalizationUtils+STPTestAdditions.h"
+
+@interface STPLocalizationUtilsTest : XCTestCase
+@end
+
+@implementation STPLocalizationUtilsTest
+
+- (void)tearDown {
+    [STPLocalizationUtils overrideLanguageTo:nil];
+    [super tearDown];
+}
+
+- (void)testOverrideLanguageSwapsStringTable {
+    for (NSString *language in @[@"de", @"ja", @"en"]) {
+        [STPLocalizationUtils overrideLanguageTo:language];
+        NSDictionary<NSString *, NSString *> *table = [STPLocalizationUtils stringTableForLanguage:language];
+        XCTAssertTrue(table.count > 0);
+        [table enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, __unused BOOL *stop) {
+            XCTAssertEqualObjects(STPLocalizedString(key, nil), value);
+        }];
+    }
+}
+
+- (void)testMissingKeyReturnsKey {
+    XCTAssertEqualObjects(STPLocalizedString(@"stp_not_a_real_key", nil), @"stp_not_a_real_key");
+}
+
+@end
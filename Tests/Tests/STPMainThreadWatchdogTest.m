@@ -0,0 +1,106 @@
+//
+//  STPMainThreadWatchdogTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPAPIClient.h"
+#import "STPDispatchFunctions.h"
+#import "STPMainThreadWatchdog.h"
+
+@interface STPMainThreadWatchdogTest : XCTestCase <STPMainThreadWatchdogDelegate>
+@property (nonatomic) NSMutableArray<NSString *> *labels;
+@end
+
+@implementation STPMainThreadWatchdogTest
+
+- (void)setUp {
+    [super setUp];
+    self.labels = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    [Stripe setMainThreadWatchdogDelegate:nil budget:0];
+    [super tearDown];
+}
+
+- (void)mainThreadWatchdogDidObserveWork:(NSString *)label duration:(__unused NSTimeInterval)duration {
+    XCTAssertTrue([NSThread isMainThread]);
+    [self.labels addObject:label];
+}
+
+- (void)testReportsWorkOverBudget {
+    [Stripe setMainThreadWatchdogDelegate:self budget:0.005];
+    stpDispatchToMainThreadIfNecessary(^{
+        [NSThread sleepForTimeInterval:0.01];
+    });
+    XCTAssertEqual(self.labels.count, (NSUInteger)1);
+    XCTAssertTrue([self.labels.firstObject containsString:@"testReportsWorkOverBudget"]);
+
+    stpDispatchToMainThreadIfNecessary(^{});
+    XCTAssertEqual(self.labels.count, (NSUInteger)1);
+}
+
+- (void)testReportsMainQueueBlocks {
+    [Stripe setMainThreadWatchdogDelegate:self budget:0];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"reported"];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        stpDispatchToMainThreadIfNecessary(^{
+            [NSThread sleepForTimeInterval:0.001];
+        });
+        stpDispatchToMainThreadIfNecessary(^{
+            [expectation fulfill];
+        });
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertTrue(self.labels.count >= 1U);
+}
+
+- (void)testMethodLabels {
+    [Stripe setMainThreadWatchdogDelegate:self budget:0];
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
+    [NSThread sleepForTimeInterval:0.001];
+    STPMainThreadWatchdogEnd(start, self, @selector(testMethodLabels));
+    XCTAssertEqualObjects(self.labels, @[@"-[STPMainThreadWatchdogTest testMethodLabels]"]);
+}
+
+- (void)testOffWithoutDelegate {
+    [Stripe setMainThreadWatchdogDelegate:self budget:0];
+    [Stripe setMainThreadWatchdogDelegate:nil budget:0];
+    XCTAssertEqual(STPMainThreadWatchdogBegin(), (CFAbsoluteTime)0);
+    stpDispatchToMainThreadIfNecessary(^{
+        [NSThread sleepForTimeInterval:0.001];
+    });
+    XCTAssertEqual(self.labels.count, (NSUInteger)0);
+}
+
+- (void)testDurationObserverCountsOutermostWork {
+    __block NSUInteger observed = 0;
+    [STPMainThreadWatchdog setDurationObserver:^(__unused NSTimeInterval duration) {
+        observed++;
+    }];
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
+    stpDispatchToMainThreadIfNecessary(^{});
+    STPMainThreadWatchdogEnd(start, self, _cmd);
+    [STPMainThreadWatchdog setDurationObserver:nil];
+
+    XCTAssertEqual(observed, (NSUInteger)1);
+    XCTAssertEqual(self.labels.count, (NSUInteger)0);
+    XCTAssertEqual(STPMainThreadWatchdogBegin(), (CFAbsoluteTime)0);
+}
+
+- (void)testOffThreadWorkIsNotMeasured {
+    [Stripe setMainThreadWatchdogDelegate:self budget:0];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"measured"];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        XCTAssertEqual(STPMainThreadWatchdogBegin(), (CFAbsoluteTime)0);
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+@end
@@ -0,0 +1,176 @@
+//
+//  STPMemoryAccountingTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <QuartzCore/QuartzCore.h>
+
+#import "STPCheckoutAPIClient.h"
+#import "STPFixtures.h"
+#import "STPMemoryAccounting.h"
+
+// How far above the starting footprint presenting one screen may go
+static uint64_t const STPScreenMemoryBudget = 24 * 1024 * 1024;
+
+@interface STPMemoryAccountingTest : XCTestCase
+
+@property (nonatomic) UIWindow *window;
+
+@end
+
+@implementation STPMemoryAccountingTest
+
+- (void)setUp {
+    [super setUp];
+    [STPMemoryAccounting setEnabled:YES];
+    self.window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 375, 667)];
+    self.window.hidden = NO;
+}
+
+- (void)tearDown {
+    self.window.hidden = YES;
+    self.window = nil;
+    [STPMemoryAccounting setEnabled:NO];
+    [super tearDown];
+}
+
+- (void)drainMainRunLoop {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+}
+
+#pragma mark - Accounting
+
+- (void)testTrackedObjectsAreCountedWhileAlive {
+    NSUInteger before = [[STPMemoryAccounting snapshot] liveCountForCategory:@"test objects"];
+    @autoreleasepool {
+        NSObject *object = [NSObject new];
+        [STPMemoryAccounting trackObject:object category:@"test objects"];
+        XCTAssertEqual([[STPMemoryAccounting snapshot] liveCountForCategory:@"test objects"], before + 1);
+    }
+    XCTAssertEqual([[STPMemoryAccounting snapshot] liveCountForCategory:@"test objects"], before);
+}
+
+- (void)testNothingIsTrackedWhileDisabled {
+    [STPMemoryAccounting setEnabled:NO];
+    NSObject *object = [NSObject new];
+    [STPMemoryAccounting trackObject:object category:@"disabled objects"];
+    XCTAssertEqual([[STPMemoryAccounting snapshot] liveCountForCategory:@"disabled objects"], 0U);
+}
+
+- (void)testFootprintIsReported {
+    XCTAssertGreaterThan([STPMemoryAccounting currentFootprint], 0U);
+}
+
+- (void)testCheckoutClientsAreReleased {
+    NSUInteger before = [[STPMemoryAccounting snapshot] liveCountForCategory:STPMemoryCategoryCheckoutClients];
+    @autoreleasepool {
+        STPCheckoutAPIClient *client = [[STPCheckoutAPIClient alloc] initWithPublishableKey:@"pk_test_memory"];
+        XCTAssertNotNil(client);
+        XCTAssertEqual([[STPMemoryAccounting snapshot] liveCountForCategory:STPMemoryCategoryCheckoutClients], before + 1);
+    }
+    XCTAssertEqual([[STPMemoryAccounting snapshot] liveCountForCategory:STPMemoryCategoryCheckoutClients], before);
+}
+
+#pragma mark - Screens
+
+- (UIViewController *)paymentMethodsViewController {
+    return [[STPPaymentMethodsViewController alloc] initWithConfiguration:[STPFixtures paymentConfiguration]
+                                                                    theme:[STPTheme defaultTheme]
+                                                               apiAdapter:[STPFixtures staticAPIAdapter]
+                                                                 delegate:OCMProtocolMock(@protocol(STPPaymentMethodsViewControllerDelegate))];
+}
+
+- (UIViewController *)addCardViewController {
+    return [[STPAddCardViewController alloc] initWithConfiguration:[STPFixtures paymentConfiguration]
+                                                             theme:[STPTheme defaultTheme]];
+}
+
+- (UIViewController *)shippingAddressViewController {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.requiredShippingAddressFields = PKAddressFieldAll;
+    return [[STPShippingAddressViewController alloc] initWithConfiguration:config
+                                                                     theme:[STPTheme defaultTheme]
+                                                                  currency:nil
+                                                           shippingAddress:nil
+                                                    selectedShippingMethod:nil
+                                                      prefilledInformation:nil];
+}
+
+/**
+ Shows the view controller from `build` in a navigation controller, then
+ removes it. Fails if the screen goes over its budget or leaves any view
+ controllers or pollers behind.
+ */
+- (void)checkScreenNamed:(NSString *)name build:(UIViewController *(^)(void))build {
+    [self drainMainRunLoop];
+    STPMemorySnapshot *before = [STPMemoryAccounting snapshot];
+    uint64_t highWater = before.footprint;
+    @autoreleasepool {
+        UINavigationController *navigationController = [[UINavigationController alloc] initWithRootViewController:build()];
+        self.window.rootViewController = navigationController;
+        [navigationController.view layoutIfNeeded];
+        highWater = MAX(highWater, [STPMemoryAccounting currentFootprint]);
+        [CATransaction flush];
+        [self drainMainRunLoop];
+        STPMemorySnapshot *presented = [STPMemoryAccounting snapshot];
+        highWater = MAX(highWater, presented.footprint);
+        XCTAssertGreaterThan([presented liveCountForCategory:STPMemoryCategoryViewControllers],
+                             [before liveCountForCategory:STPMemoryCategoryViewControllers]);
+        self.window.rootViewController = nil;
+    }
+    [self drainMainRunLoop];
+    STPMemorySnapshot *after = [STPMemoryAccounting snapshot];
+    uint64_t cost = highWater > before.footprint ? highWater - before.footprint : 0;
+    NSLog(@"%@: high-water mark %.1f MB above baseline; after dismissal %@", name, cost / (1024.0 * 1024.0), after);
+
+    XCTAssertEqual([after liveCountForCategory:STPMemoryCategoryViewControllers],
+                   [before liveCountForCategory:STPMemoryCategoryViewControllers],
+                   @"%@ left view controllers behind", name);
+    XCTAssertEqual([after liveCountForCategory:STPMemoryCategorySourcePollers],
+                   [before liveCountForCategory:STPMemoryCategorySourcePollers],
+                   @"%@ left source pollers behind", name);
+    XCTAssertLessThanOrEqual(cost, STPScreenMemoryBudget, @"%@ went over its memory budget", name);
+}
+
+- (void)testPaymentMethodsScreenIsReleased {
+    [self checkScreenNamed:@"Payment methods" build:^UIViewController *{
+        return [self paymentMethodsViewController];
+    }];
+}
+
+- (void)testAddCardScreenIsReleased {
+    [self checkScreenNamed:@"Add card" build:^UIViewController *{
+        return [self addCardViewController];
+    }];
+}
+
+- (void)testShippingAddressScreenIsReleased {
+    [self checkScreenNamed:@"Shipping address" build:^UIViewController *{
+        return [self shippingAddressViewController];
+    }];
+}
+
+- (void)testCheckoutScreensMemoryMetric {
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new]] block:^{
+            for (UIViewController *(^build)(void) in @[^{ return [self paymentMethodsViewController]; },
+                                                       ^{ return [self addCardViewController]; },
+                                                       ^{ return [self shippingAddressViewController]; }]) {
+                @autoreleasepool {
+                    self.window.rootViewController = [[UINavigationController alloc] initWithRootViewController:build()];
+                    [self.window.rootViewController.view layoutIfNeeded];
+                    [CATransaction flush];
+                    self.window.rootViewController = nil;
+                }
+            }
+        }];
+    }
+#endif
+}
+
+@end
@@ -0,0 +1,209 @@
+//
+//  STPNetworkBenchmarkTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <Stripe/Stripe.h>
+
+#import "STPAPIClient+Private.h"
+#import "STPCustomerCache.h"
+#import "STPFixtures.h"
+#import "STPNetworkReplayProtocol.h"
+#import "STPPromise.h"
+#import "STPTestUtils.h"
+
+static NSString *const STPBenchmarkCustomerURL = @"https://example.com/customer";
+
+@interface STPPaymentContext (Benchmark)
+@property(nonatomic)STPPromise<id> *loadingPromise;
+@end
+
+/**
+ A merchant backend that serves Customer.json through the replay session.
+ */
+@interface STPReplayBackendAdapter : NSObject <STPBackendAPIAdapter>
+@end
+
+@implementation STPReplayBackendAdapter
+
+- (void)retrieveCustomer:(STPCustomerCompletionBlock)completion {
+    NSURL *url = [NSURL URLWithString:STPBenchmarkCustomerURL];
+    [[[STPNetworkReplayProtocol session] dataTaskWithURL:url completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        STPCustomerDeserializer *deserializer = [[STPCustomerDeserializer alloc] initWithData:data urlResponse:response error:error];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(deserializer.customer, deserializer.error);
+        });
+    }] resume];
+}
+
+- (void)attachSourceToCustomer:(__unused id<STPSourceProtocol>)source completion:(STPErrorBlock)completion {
+    completion(nil);
+}
+
+- (void)selectDefaultCustomerSource:(__unused id<STPSourceProtocol>)source completion:(STPErrorBlock)completion {
+    completion(nil);
+}
+
+@end
+
+/**
+ Latency benchmarks for the SDK's networked flows, served from fixtures by
+ STPNetworkReplayProtocol. The instant profile measures the SDK's own
+ overhead; the others show how it behaves on slower connections.
+ */
+@interface STPNetworkBenchmarkTest : XCTestCase
+
+@property (nonatomic) STPAPIClient *apiClient;
+
+@end
+
+@implementation STPNetworkBenchmarkTest
+
+- (void)setUp {
+    [super setUp];
+    [STPNetworkReplayProtocol reset];
+    self.apiClient = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_replay"];
+    self.apiClient.urlSession = [STPNetworkReplayProtocol session];
+
+    NSDictionary *token = @{
+                            @"id": @"tok_replay",
+                            @"object": @"token",
+                            @"livemode": @NO,
+                            @"created": @1483228800,
+                            @"used": @NO,
+                            @"type": @"card",
+                            @"card": [STPTestUtils jsonNamed:@"Card"],
+                            };
+    [STPNetworkReplayProtocol stubMethod:@"POST" path:@"/v1/tokens" withJSONObjects:@[token]];
+    [STPNetworkReplayProtocol stubMethod:@"GET" path:@"/customer" withJSONObjects:@[[STPTestUtils jsonNamed:@"Customer"]]];
+}
+
+- (void)tearDown {
+    [STPNetworkReplayProtocol reset];
+    [super tearDown];
+}
+
+- (void)stubSourcePolls {
+    NSDictionary *pending = [STPTestUtils jsonNamed:@"3DSSource"];
+    NSMutableDictionary *chargeable = [pending mutableCopy];
+    chargeable[@"status"] = @"chargeable";
+    NSString *path = [NSString stringWithFormat:@"/v1/sources/%@", pending[@"id"]];
+    [STPNetworkReplayProtocol stubMethod:@"GET" path:path withJSONObjects:@[pending, pending, chargeable]];
+}
+
+- (void)createToken {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"token"];
+    [self.apiClient createTokenWithCard:[STPFixtures cardParams] completion:^(STPToken *token, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(token.tokenId, @"tok_replay");
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+- (void)pollSource {
+    [self stubSourcePolls];
+    NSDictionary *json = [STPTestUtils jsonNamed:@"3DSSource"];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"poll"];
+    [self.apiClient startPollingSourceWithId:json[@"id"]
+                                clientSecret:json[@"client_secret"]
+                                     timeout:10
+                                  completion:^(STPSource *source, NSError *error) {
+                                      XCTAssertNil(error);
+                                      XCTAssertEqual(source.status, STPSourceStatusChargeable);
+                                      [expectation fulfill];
+                                  }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+- (void)loadPaymentContext {
+    [[STPCustomerCache sharedCache] removeAllCustomers];
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.customerCachingEnabled = NO;
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPReplayBackendAdapter new]
+                                                                 configuration:config
+                                                                         theme:[STPTheme defaultTheme]];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"load"];
+    [context.loadingPromise onCompletion:^(__unused id value, NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertFalse(context.loading);
+}
+
+#pragma mark - SDK overhead
+
+- (void)testTokenCreationOverhead {
+    [self measureBlock:^{
+        [self createToken];
+    }];
+}
+
+- (void)testSourcePollingOverhead {
+    [self measureBlock:^{
+        [self pollSource];
+    }];
+}
+
+- (void)testPaymentContextLoadingOverhead {
+    [self measureBlock:^{
+        [self loadPaymentContext];
+    }];
+}
+
+#pragma mark - Network profiles
+
+- (void)testTokenCreationOnLTE {
+    [STPNetworkReplayProtocol setProfile:[STPNetworkProfile lteProfile]];
+    [self measureBlock:^{
+        [self createToken];
+    }];
+}
+
+- (void)testSourcePollingOnLTE {
+    [STPNetworkReplayProtocol setProfile:[STPNetworkProfile lteProfile]];
+    [self measureBlock:^{
+        [self pollSource];
+    }];
+}
+
+- (void)testPaymentContextLoadingOnEdge {
+    [STPNetworkReplayProtocol setProfile:[STPNetworkProfile edgeProfile]];
+    [self measureBlock:^{
+        [self loadPaymentContext];
+    }];
+}
+
+#pragma mark - Harness
+
+- (void)testReplayServesStubsInOrderAndCountsRequests {
+    [self pollSource];
+    NSString *path = [NSString stringWithFormat:@"/v1/sources/%@", [STPTestUtils jsonNamed:@"3DSSource"][@"id"]];
+    XCTAssertEqual([STPNetworkReplayProtocol requestCountForMethod:@"GET" path:path], 3U);
+}
+
+- (void)testProfileLatencyIsApplied {
+    STPNetworkProfile *profile = [STPNetworkProfile instantProfile];
+    profile.latency = 0.3;
+    [STPNetworkReplayProtocol setProfile:profile];
+    NSDate *start = [NSDate date];
+    [self createToken];
+    XCTAssertGreaterThanOrEqual([[NSDate date] timeIntervalSinceDate:start], 0.3);
+}
+
+- (void)testUnstubbedRequestsFail {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"source"];
+    [self.apiClient retrieveSourceWithId:@"src_missing" clientSecret:@"secret" completion:^(STPSource *source, NSError *error) {
+        XCTAssertNil(source);
+        XCTAssertNotNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+@end
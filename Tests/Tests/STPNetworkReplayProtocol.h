@@ -0,0 +1,129 @@
+//
+//  STPNetworkReplayProtocol.h
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ The conditions a replayed response is delivered under. Delays are simulated
+ from a seeded generator, so a given profile always produces the same timings
+ for the same sequence of requests.
+ */
+@interface STPNetworkProfile : NSObject
+
+/**
+ Time before the first byte of a response arrives.
+ */
+@property (nonatomic) NSTimeInterval latency;
+
+/**
+ Download rate for response bodies. 0 means bodies arrive all at once.
+ */
+@property (nonatomic) NSUInteger bytesPerSecond;
+
+/**
+ Chance, from 0 to 1, that each packet of a response has to be resent.
+ */
+@property (nonatomic) double lossRate;
+
+/**
+ Extra delay for every packet that's resent.
+ */
+@property (nonatomic) NSTimeInterval retransmissionDelay;
+
+/**
+ Seed for the loss simulation.
+ */
+@property (nonatomic) uint32_t seed;
+
+/**
+ No latency, no bandwidth limit and no loss. Use this to measure the SDK's own
+ overhead.
+ */
++ (instancetype)instantProfile;
+
+/**
+ A good Wi-Fi connection.
+ */
++ (instancetype)wifiProfile;
+
+/**
+ A typical LTE connection.
+ */
++ (instancetype)lteProfile;
+
+/**
+ A slow, lossy EDGE connection.
+ */
++ (instancetype)edgeProfile;
+
+@end
+
+typedef NS_ENUM(NSInteger, STPNetworkReplayMode) {
+    /**
+     Requests are answered from stubs. Unstubbed requests get a 404.
+     */
+    STPNetworkReplayModeReplay,
+    /**
+     Requests go to the network. Response bodies are kept in
+     `recordedResponses` and, if `recordingDirectory` is set, written there so
+     that they can be added as fixtures.
+     */
+    STPNetworkReplayModeRecord,
+};
+
+/**
+ An NSURLProtocol that serves canned responses with simulated network
+ conditions. Use `+session`, or set it as the `urlSession` of an STPAPIClient,
+ to route requests through it.
+ */
+@interface STPNetworkReplayProtocol : NSURLProtocol
+
+/**
+ A session whose requests are all handled by this protocol.
+ */
++ (NSURLSession *)session;
+
++ (void)setProfile:(STPNetworkProfile *)profile;
++ (void)setMode:(STPNetworkReplayMode)mode;
++ (void)setRecordingDirectory:(NSURL *)directory;
+
+/**
+ Answers requests for `path` (e.g. `/v1/tokens`) with `objects`, in order. Once
+ they've all been served, the last one is repeated.
+ */
++ (void)stubMethod:(NSString *)method
+              path:(NSString *)path
+   withJSONObjects:(NSArray<NSDictionary *> *)objects;
+
+/**
+ Like `stubMethod:path:withJSONObjects:`, with a status code and extra header
+ fields for every response.
+ */
++ (void)stubMethod:(NSString *)method
+              path:(NSString *)path
+        statusCode:(NSInteger)statusCode
+           headers:(NSDictionary<NSString *, NSString *> *)headers
+       JSONObjects:(NSArray<NSDictionary *> *)objects;
+
+/**
+ Removes all stubs and recordings and resets request counts, the profile and
+ the mode.
+ */
++ (void)reset;
+
+/**
+ The number of requests answered for `path` since the last reset.
+ */
++ (NSUInteger)requestCountForMethod:(NSString *)method path:(NSString *)path;
+
+/**
+ Response bodies seen in record mode, keyed by "METHOD path".
+ */
++ (NSDictionary<NSString *, NSData *> *)recordedResponses;
+
+@end
@@ -0,0 +1,403 @@
+//
+//  STPNetworkReplayProtocol.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import "STPNetworkReplayProtocol.h"
+
+// Bodies are delivered in chunks of this size, so slow profiles trickle in.
+static NSUInteger const STPReplayChunkSize = 16 * 1024;
+// Loss is simulated per TCP segment.
+static NSUInteger const STPReplayPacketSize = 1460;
+
+@implementation STPNetworkProfile
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _seed = 1;
+    }
+    return self;
+}
+
++ (instancetype)profileWithLatency:(NSTimeInterval)latency
+                    bytesPerSecond:(NSUInteger)bytesPerSecond
+                          lossRate:(double)lossRate
+               retransmissionDelay:(NSTimeInterval)retransmissionDelay {
+    STPNetworkProfile *profile = [self new];
+    profile.latency = latency;
+    profile.bytesPerSecond = bytesPerSecond;
+    profile.lossRate = lossRate;
+    profile.retransmissionDelay = retransmissionDelay;
+    return profile;
+}
+
++ (instancetype)instantProfile {
+    return [self profileWithLatency:0 bytesPerSecond:0 lossRate:0 retransmissionDelay:0];
+}
+
++ (instancetype)wifiProfile {
+    return [self profileWithLatency:0.02 bytesPerSecond:3000000 lossRate:0 retransmissionDelay:0.05];
+}
+
++ (instancetype)lteProfile {
+    return [self profileWithLatency:0.06 bytesPerSecond:1000000 lossRate:0.005 retransmissionDelay:0.1];
+}
+
++ (instancetype)edgeProfile {
+    return [self profileWithLatency:0.4 bytesPerSecond:30000 lossRate:0.02 retransmissionDelay:0.6];
+}
+
+@end
+
+@interface STPNetworkReplayStub : NSObject
+
+@property (nonatomic) NSInteger statusCode;
+@property (nonatomic, copy) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, copy) NSArray<NSData *> *bodies;
+@property (nonatomic) NSUInteger servedCount;
+
+@end
+
+@implementation STPNetworkReplayStub
+@end
+
+#pragma mark - Shared state
+
+static NSMutableDictionary<NSString *, STPNetworkReplayStub *> *stp_replayStubs;
+static NSMutableDictionary<NSString *, NSNumber *> *stp_replayRequestCounts;
+static NSMutableDictionary<NSString *, NSData *> *stp_replayRecordings;
+static STPNetworkProfile *stp_replayProfile;
+static STPNetworkReplayMode stp_replayMode;
+static NSURL *stp_replayRecordingDirectory;
+static uint32_t stp_replayRequestIndex;
+
+// Guards the state above
+static dispatch_queue_t stp_replayStateQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.tests.networkreplay", DISPATCH_QUEUE_SERIAL);
+        stp_replayStubs = [NSMutableDictionary dictionary];
+        stp_replayRequestCounts = [NSMutableDictionary dictionary];
+        stp_replayRecordings = [NSMutableDictionary dictionary];
+        stp_replayProfile = [STPNetworkProfile instantProfile];
+    });
+    return queue;
+}
+
+static NSString *stp_replayKey(NSString *method, NSString *path) {
+    return [NSString stringWithFormat:@"%@ %@", method.uppercaseString, path];
+}
+
+static uint32_t stp_nextRandom(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static NSData *stp_dataFromStream(NSInputStream *stream) {
+    NSMutableData *data = [NSMutableData data];
+    uint8_t buffer[4096];
+    [stream open];
+    while ([stream hasBytesAvailable]) {
+        NSInteger length = [stream read:buffer maxLength:sizeof(buffer)];
+        if (length <= 0) {
+            break;
+        }
+        [data appendBytes:buffer length:(NSUInteger)length];
+    }
+    [stream close];
+    return data;
+}
+
+#pragma mark - Protocol
+
+@interface STPNetworkReplayProtocol ()
+
+@property (nonatomic) NSThread *clientThread;
+@property (nonatomic, copy) NSArray<NSString *> *runLoopModes;
+@property (nonatomic) NSURLSessionDataTask *recordingTask;
+@property (atomic) BOOL stopped;
+
+@end
+
+@implementation STPNetworkReplayProtocol
+
++ (NSURLSession *)session {
+    static NSURLSession *session;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        configuration.protocolClasses = @[self];
+        configuration.URLCache = nil;
+        session = [NSURLSession sessionWithConfiguration:configuration];
+    });
+    return session;
+}
+
+// Doesn't go through this protocol, so record mode reaches the network
++ (NSURLSession *)recordingSession {
+    static NSURLSession *session;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    });
+    return session;
+}
+
++ (void)setProfile:(STPNetworkProfile *)profile {
+    dispatch_sync(stp_replayStateQueue(), ^{
+        stp_replayProfile = profile ?: [STPNetworkProfile instantProfile];
+    });
+}
+
++ (void)setMode:(STPNetworkReplayMode)mode {
+    dispatch_sync(stp_replayStateQueue(), ^{
+        stp_replayMode = mode;
+    });
+}
+
++ (void)setRecordingDirectory:(NSURL *)directory {
+    dispatch_sync(stp_replayStateQueue(), ^{
+        stp_replayRecordingDirectory = directory;
+    });
+}
+
++ (void)stubMethod:(NSString *)method
+              path:(NSString *)path
+   withJSONObjects:(NSArray<NSDictionary *> *)objects {
+    [self stubMethod:method path:path statusCode:200 headers:nil JSONObjects:objects];
+}
+
++ (void)stubMethod:(NSString *)method
+              path:(NSString *)path
+        statusCode:(NSInteger)statusCode
+           headers:(NSDictionary<NSString *, NSString *> *)headers
+       JSONObjects:(NSArray<NSDictionary *> *)objects {
+    NSCAssert(objects.count > 0, @"A stub needs at least one response");
+    NSMutableArray<NSData *> *bodies = [NSMutableArray arrayWithCapacity:objects.count];
+    for (NSDictionary *object in objects) {
+        [bodies addObject:[NSJSONSerialization dataWithJSONObject:object options:(NSJSONWritingOptions)0 error:nil]];
+    }
+    STPNetworkReplayStub *stub = [STPNetworkReplayStub new];
+    stub.statusCode = statusCode;
+    stub.headers = headers;
+    stub.bodies = bodies;
+    NSString *key = stp_replayKey(method, path);
+    dispatch_sync(stp_replayStateQueue(), ^{
+        stp_replayStubs[key] = stub;
+    });
+}
+
++ (void)reset {
+    dispatch_sync(stp_replayStateQueue(), ^{
+        [stp_replayStubs removeAllObjects];
+        [stp_replayRequestCounts removeAllObjects];
+        [stp_replayRecordings removeAllObjects];
+        stp_replayProfile = [STPNetworkProfile instantProfile];
+        stp_replayMode = STPNetworkReplayModeReplay;
+        stp_replayRecordingDirectory = nil;
+        stp_replayRequestIndex = 0;
+    });
+}
+
++ (NSUInteger)requestCountForMethod:(NSString *)method path:(NSString *)path {
+    NSString *key = stp_replayKey(method, path);
+    __block NSUInteger count = 0;
+    dispatch_sync(stp_replayStateQueue(), ^{
+        count = stp_replayRequestCounts[key].unsignedIntegerValue;
+    });
+    return count;
+}
+
++ (NSDictionary<NSString *, NSData *> *)recordedResponses {
+    __block NSDictionary *recordings;
+    dispatch_sync(stp_replayStateQueue(), ^{
+        recordings = [stp_replayRecordings copy];
+    });
+    return recordings;
+}
+
+#pragma mark NSURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    NSString *scheme = request.URL.scheme.lowercaseString;
+    return [scheme isEqualToString:@"https"] || [scheme isEqualToString:@"http"];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    self.clientThread = [NSThread currentThread];
+    self.runLoopModes = @[NSRunLoopCommonModes];
+    __block STPNetworkReplayMode mode;
+    dispatch_sync(stp_replayStateQueue(), ^{
+        mode = stp_replayMode;
+    });
+    if (mode == STPNetworkReplayModeRecord) {
+        [self startRecording];
+    } else {
+        [self startReplaying];
+    }
+}
+
+- (void)stopLoading {
+    self.stopped = YES;
+    [self.recordingTask cancel];
+}
+
+#pragma mark Replay
+
+- (void)startReplaying {
+    NSURLRequest *request = self.request;
+    NSString *key = stp_replayKey(request.HTTPMethod ?: @"GET", request.URL.path);
+    __block NSInteger statusCode = 404;
+    __block NSDictionary *stubHeaders;
+    __block NSData *body;
+    __block STPNetworkProfile *profile;
+    __block uint32_t randomState;
+    dispatch_sync(stp_replayStateQueue(), ^{
+        STPNetworkReplayStub *stub = stp_replayStubs[key];
+        if (stub) {
+            statusCode = stub.statusCode;
+            stubHeaders = stub.headers;
+            body = stub.bodies[MIN(stub.servedCount, stub.bodies.count - 1)];
+            stub.servedCount++;
+        }
+        stp_replayRequestCounts[key] = @(stp_replayRequestCounts[key].unsignedIntegerValue + 1);
+        profile = stp_replayProfile;
+        // Each request gets its own stream, so timings don't depend on
+        // how responses interleave.
+        randomState = profile.seed ^ (stp_replayRequestIndex++ * 2654435761u);
+    });
+    if (randomState == 0) {
+        randomState = 0x9E3779B9;
+    }
+    if (!body) {
+        NSDictionary *error = @{@"error": @{@"type": @"invalid_request_error",
+                                            @"message": [NSString stringWithFormat:@"No replay stub for %@", key]}};
+        body = [NSJSONSerialization dataWithJSONObject:error options:(NSJSONWritingOptions)0 error:nil];
+    }
+
+    NSMutableDictionary *headerFields = [NSMutableDictionary dictionaryWithDictionary:@{
+                                                                                      @"Content-Type": @"application/json",
+                                                                                      @"Content-Length": [NSString stringWithFormat:@"%lu", (unsigned long)body.length],
+                                                                                      }];
+    [headerFields addEntriesFromDictionary:stubHeaders];
+    // Act like an API that honors long polls
+    NSString *prefer = [request valueForHTTPHeaderField:@"Prefer"];
+    if (prefer && headerFields[@"Preference-Applied"] == nil) {
+        headerFields[@"Preference-Applied"] = prefer;
+    }
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                                              statusCode:statusCode
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:headerFields];
+
+    NSMutableArray<dispatch_block_t> *events = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *delays = [NSMutableArray array];
+    [events addObject:^{
+        [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    }];
+    [delays addObject:@(profile.latency)];
+    for (NSUInteger offset = 0; offset < body.length; offset += STPReplayChunkSize) {
+        NSData *chunk = [body subdataWithRange:NSMakeRange(offset, MIN(STPReplayChunkSize, body.length - offset))];
+        NSTimeInterval delay = profile.bytesPerSecond > 0 ? (double)chunk.length / profile.bytesPerSecond : 0;
+        NSUInteger packets = (chunk.length + STPReplayPacketSize - 1) / STPReplayPacketSize;
+        for (NSUInteger i = 0; i < packets && profile.lossRate > 0; i++) {
+            if ((double)stp_nextRandom(&randomState) / UINT32_MAX < profile.lossRate) {
+                delay += profile.retransmissionDelay;
+            }
+        }
+        [events addObject:^{
+            [self.client URLProtocol:self didLoadData:chunk];
+        }];
+        [delays addObject:@(delay)];
+    }
+    [events addObject:^{
+        [self.client URLProtocolDidFinishLoading:self];
+    }];
+    [delays addObject:@0];
+    [self performEvents:events delays:delays index:0];
+}
+
+- (void)performEvents:(NSArray<dispatch_block_t> *)events
+               delays:(NSArray<NSNumber *> *)delays
+                index:(NSUInteger)index {
+    if (index >= events.count) {
+        return;
+    }
+    dispatch_time_t when = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delays[index].doubleValue * NSEC_PER_SEC));
+    dispatch_after(when, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self performOnClientThread:^{
+            if (self.stopped) {
+                return;
+            }
+            events[index]();
+            [self performEvents:events delays:delays index:index + 1];
+        }];
+    });
+}
+
+// NSURLProtocol clients expect to be called on the thread that started loading.
+- (void)performOnClientThread:(dispatch_block_t)block {
+    [self performSelector:@selector(runBlock:)
+                 onThread:self.clientThread
+               withObject:[block copy]
+            waitUntilDone:NO
+                    modes:self.runLoopModes];
+}
+
+- (void)runBlock:(dispatch_block_t)block {
+    block();
+}
+
+#pragma mark Record
+
+- (void)startRecording {
+    NSMutableURLRequest *request = [self.request mutableCopy];
+    if (!request.HTTPBody && request.HTTPBodyStream) {
+        request.HTTPBody = stp_dataFromStream(request.HTTPBodyStream);
+    }
+    NSString *key = stp_replayKey(request.HTTPMethod ?: @"GET", request.URL.path);
+    NSString *fileName = [NSString stringWithFormat:@"%@%@.json",
+                          request.HTTPMethod ?: @"GET",
+                          [request.URL.path stringByReplacingOccurrencesOfString:@"/" withString:@"_"]];
+    self.recordingTask = [[[self class] recordingSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        if (data && response) {
+            dispatch_sync(stp_replayStateQueue(), ^{
+                stp_replayRecordings[key] = data;
+                stp_replayRequestCounts[key] = @(stp_replayRequestCounts[key].unsignedIntegerValue + 1);
+                if (stp_replayRecordingDirectory) {
+                    [data writeToURL:[stp_replayRecordingDirectory URLByAppendingPathComponent:fileName] atomically:YES];
+                }
+            });
+        }
+        [self performOnClientThread:^{
+            if (self.stopped) {
+                return;
+            }
+            if (error) {
+                [self.client URLProtocol:self didFailWithError:error];
+                return;
+            }
+            [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+            if (data) {
+                [self.client URLProtocol:self didLoadData:data];
+            }
+            [self.client URLProtocolDidFinishLoading:self];
+        }];
+    }];
+    [self.recordingTask resume];
+}
+
+@end
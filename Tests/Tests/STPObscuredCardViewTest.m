@@ -0,0 +1,47 @@
+//
+//  STPObscuredCardViewTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+
+#import "STPObscuredCardView.h"
+#import "STPTestUtils.h"
+
+@interface STPObscuredCardViewTest : XCTestCase
+@property(nonatomic)STPObscuredCardView *cardView;
+@end
+
+@implementation STPObscuredCardViewTest
+
+- (void)setUp {
+    [super setUp];
+    self.cardView = [[STPObscuredCardView alloc] initWithFrame:CGRectMake(0, 0, 320, 44)];
+    [self.cardView configureWithCard:[STPCard decodedObjectFromAPIResponse:[STPTestUtils jsonNamed:@"Card"]]];
+}
+
+- (void)testDrawsWithoutSubviews {
+    XCTAssertFalse([self.cardView isEmpty]);
+    XCTAssertEqual(self.cardView.subviews.count, (NSUInteger)0);
+    XCTAssertTrue([self.cardView canBecomeFirstResponder]);
+}
+
+- (void)testDeletingClears {
+    id delegate = OCMProtocolMock(@protocol(STPObscuredCardViewDelegate));
+    self.cardView.delegate = delegate;
+    OCMExpect([delegate obscuredCardViewDidClear:self.cardView]);
+
+    id<UIKeyInput> keyInput = (id<UIKeyInput>)self.cardView;
+    [keyInput insertText:@"1"];
+    XCTAssertFalse([self.cardView isEmpty]);
+    [keyInput deleteBackward];
+    XCTAssertTrue([self.cardView isEmpty]);
+    XCTAssertFalse([keyInput hasText]);
+    OCMVerifyAll(delegate);
+}
+
+@end
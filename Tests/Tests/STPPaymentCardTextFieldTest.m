@@ -28,6 +28,19 @@
 @property(nonatomic, assign)BOOL numberFieldShrunk;
 + (UIImage *)cvcImageForCardBrand:(STPCardBrand)cardBrand;
 + (UIImage *)brandImageForCardBrand:(STPCardBrand)cardBrand;
+- (void)updateImageForFieldType:(STPCardFieldType)fieldType;
+@end
+
+@interface STPInsetPaymentCardTextField : STPPaymentCardTextField
+@property(nonatomic)CGFloat brandImageInset;
+@end
+
+@implementation STPInsetPaymentCardTextField
+
+- (CGRect)brandImageRectForBounds:(CGRect)bounds {
+    return CGRectOffset([super brandImageRectForBounds:bounds], self.brandImageInset, 0);
+}
+
 @end
 
 @interface STPPaymentCardTextFieldTest : XCTestCase
@@ -55,6 +68,21 @@
     XCTAssertEqualWithAccuracy(textField.intrinsicContentSize.width, 497, 0.1);
 }
 
+- (void)testIntrinsicContentSizeWithSharedMeasurements {
+    STPPaymentCardTextField *avenirField = [STPPaymentCardTextField new];
+    avenirField.font = [UIFont fontWithName:@"Avenir" size:44];
+    STPPaymentCardTextField *helveticaField = [STPPaymentCardTextField new];
+    helveticaField.font = [UIFont fontWithName:@"HelveticaNeue" size:18];
+
+    XCTAssertEqualWithAccuracy(avenirField.intrinsicContentSize.width, 497, 0.1);
+    XCTAssertEqualWithAccuracy(helveticaField.intrinsicContentSize.width, 266, 0.1);
+    XCTAssertEqualWithAccuracy(avenirField.intrinsicContentSize.width, 497, 0.1);
+
+    STPPaymentCardTextField *secondAvenirField = [STPPaymentCardTextField new];
+    secondAvenirField.font = [UIFont fontWithName:@"Avenir" size:44];
+    XCTAssertEqualWithAccuracy(secondAvenirField.intrinsicContentSize.width, 497, 0.1);
+}
+
 - (void)testSetCard_numberUnknown {
     STPPaymentCardTextField *sut = [STPPaymentCardTextField new];
     STPCardParams *card = [STPCardParams new];
@@ -316,6 +344,123 @@
     XCTAssertEqual((int)params.expYear, 99);
 }
 
+- (void)testSetCard_notifiesOnce {
+    STPPaymentCardTextField *sut = [STPPaymentCardTextField new];
+    id delegate = OCMProtocolMock(@protocol(STPPaymentCardTextFieldDelegate));
+    sut.delegate = delegate;
+    __block NSInteger changes = 0;
+    OCMStub([delegate paymentCardTextFieldDidChange:sut]).andDo(^(__unused NSInvocation *invocation) {
+        changes++;
+    });
+    STPCardParams *card = [STPCardParams new];
+    card.number = @"4242424242424242";
+    card.expMonth = 10;
+    card.expYear = 99;
+    card.cvc = @"123";
+
+    [sut setCardParams:card];
+    XCTAssertEqual(changes, 1);
+    XCTAssertTrue(sut.isValid);
+
+    [sut setCardParams:card];
+    XCTAssertEqual(changes, 1);
+
+    [sut clear];
+    XCTAssertEqual(changes, 2);
+    XCTAssertFalse(sut.isValid);
+    XCTAssertEqual(sut.numberField.text.length, (NSUInteger)0);
+}
+
+- (void)testLayoutSkippedWhenNothingChanged {
+    STPPaymentCardTextField *sut = [[STPPaymentCardTextField alloc] initWithFrame:CGRectMake(0, 0, 320, 44)];
+    [sut layoutIfNeeded];
+    CGRect numberFrame = sut.numberField.frame;
+
+    id mock = OCMPartialMock(sut);
+    OCMReject([mock numberFieldRectForBounds:sut.bounds]);
+    [sut setNeedsLayout];
+    [sut layoutIfNeeded];
+    OCMVerifyAll(mock);
+    [mock stopMocking];
+    XCTAssertTrue(CGRectEqualToRect(sut.numberField.frame, numberFrame));
+
+    sut.frame = CGRectMake(0, 0, 320, 60);
+    [sut layoutIfNeeded];
+    XCTAssertEqual(CGRectGetHeight(sut.numberField.frame), 60);
+
+    sut.font = [UIFont systemFontOfSize:30];
+    [sut layoutIfNeeded];
+    XCTAssertGreaterThan(CGRectGetWidth(sut.numberField.frame), CGRectGetWidth(numberFrame));
+}
+
+- (void)testLayoutNotSkippedWhenRectMethodsOverridden {
+    STPInsetPaymentCardTextField *sut = [[STPInsetPaymentCardTextField alloc] initWithFrame:CGRectMake(0, 0, 320, 44)];
+    [sut layoutIfNeeded];
+    CGFloat brandImageX = CGRectGetMinX(sut.brandImageView.frame);
+
+    sut.brandImageInset = 10;
+    [sut setNeedsLayout];
+    [sut layoutIfNeeded];
+    XCTAssertEqualWithAccuracy(CGRectGetMinX(sut.brandImageView.frame), brandImageX + 10, 0.1);
+}
+
+- (void)testShrinkingMovesFieldsWithTransforms {
+    STPPaymentCardTextField *sut = [[STPPaymentCardTextField alloc] initWithFrame:CGRectMake(0, 0, 320, 44)];
+    [sut layoutIfNeeded];
+    CGRect expandedNumberFrame = sut.numberField.frame;
+    XCTAssertTrue(CGAffineTransformIsIdentity(sut.numberField.transform));
+
+    STPCardParams *card = [STPCardParams new];
+    card.number = @"4242424242424242";
+    sut.cardParams = card;
+    XCTAssertTrue(sut.numberFieldShrunk);
+    XCTAssertFalse(CGAffineTransformIsIdentity(sut.numberField.transform));
+    XCTAssertFalse(CGAffineTransformIsIdentity(sut.cvcField.transform));
+    XCTAssertTrue(CGRectEqualToRect(sut.numberField.frame, [sut numberFieldRectForBounds:sut.bounds]));
+    XCTAssertTrue(CGRectEqualToRect(sut.cvcField.frame, [sut cvcFieldRectForBounds:sut.bounds]));
+    XCTAssertLessThan(CGRectGetMinX(sut.numberField.frame), CGRectGetMinX(expandedNumberFrame));
+
+    [sut clear];
+    XCTAssertFalse(sut.numberFieldShrunk);
+    XCTAssertTrue(CGAffineTransformIsIdentity(sut.numberField.transform));
+    XCTAssertTrue(CGRectEqualToRect(sut.numberField.frame, expandedNumberFrame));
+}
+
+- (void)testBrandImageIsReusedWithoutTransition {
+    id classMock = OCMClassMock([STPPaymentCardTextField class]);
+    OCMStub([classMock brandImageForCardBrand:STPCardBrandUnknown]).andDo(^(NSInvocation *invocation) {
+        UIGraphicsBeginImageContextWithOptions(CGSizeMake(1, 1), NO, 1);
+        __autoreleasing UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+        UIGraphicsEndImageContext();
+        [invocation setReturnValue:&image];
+    });
+    STPPaymentCardTextField *sut = [STPPaymentCardTextField new];
+
+    [sut updateImageForFieldType:STPCardFieldTypeNumber];
+    UIImage *image = sut.brandImageView.image;
+    [sut.brandImageView.layer removeAllAnimations];
+
+    // Each call to the class method returns a new image, but the field keeps
+    // showing the one it already has.
+    [sut updateImageForFieldType:STPCardFieldTypeNumber];
+    XCTAssertEqual(sut.brandImageView.image, image);
+    XCTAssertEqual(sut.brandImageView.layer.animationKeys.count, (NSUInteger)0);
+    [classMock stopMocking];
+}
+
+- (void)testSetCard_invalidFieldsMarked {
+    STPPaymentCardTextField *sut = [STPPaymentCardTextField new];
+    STPCardParams *card = [STPCardParams new];
+    card.number = @"4242424242424241";
+    card.cvc = @"123";
+    [sut setCardParams:card];
+    XCTAssertFalse(sut.numberField.validText);
+    XCTAssertTrue(sut.cvcField.validText);
+
+    [sut clear];
+    XCTAssertTrue(sut.numberField.validText);
+}
+
 @end
 
 @interface STPPaymentCardTextFieldUITests : XCTestCase
@@ -13,6 +13,7 @@
 
 @interface STPPaymentCardTextFieldViewModelTest : XCTestCase
 @property(nonatomic)STPPaymentCardTextFieldViewModel *viewModel;
+@property(nonatomic)NSMutableArray<NSString *> *observedKeyPaths;
 @end
 
 @implementation STPPaymentCardTextFieldViewModelTest
@@ -37,6 +38,24 @@
     }
 }
 
+- (void)testBrandFollowsPrefix {
+    XCTAssertEqual(self.viewModel.brand, STPCardBrandUnknown);
+    NSArray *tests = @[
+                       @[@"4", @(STPCardBrandVisa)],
+                       @[@"424242", @(STPCardBrandVisa)],
+                       @[@"4242424242", @(STPCardBrandVisa)],
+                       @[@"3782", @(STPCardBrandAmex)],
+                       @[@"378282246310005", @(STPCardBrandAmex)],
+                       @[@"5555", @(STPCardBrandMasterCard)],
+                       @[@"", @(STPCardBrandUnknown)],
+                       ];
+    for (NSArray *test in tests) {
+        self.viewModel.cardNumber = test[0];
+        XCTAssertEqual(self.viewModel.brand, [test[1] integerValue]);
+        XCTAssertEqual(self.viewModel.brand, [STPCardValidator brandForNumber:self.viewModel.cardNumber]);
+    }
+}
+
 - (void)testRawExpiration {
     NSArray *tests = @[
                        @[@"", @"", @"", @"", @(STPCardValidationStateIncomplete)],
@@ -95,4 +114,36 @@
     XCTAssertFalse([self.viewModel isValid]);
 }
 
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(__unused id)object
+                        change:(__unused NSDictionary<NSKeyValueChangeKey, id> *)change
+                       context:(__unused void *)context {
+    [self.observedKeyPaths addObject:keyPath];
+}
+
+- (void)testDerivedStateNotifiesOnlyOnChange {
+    self.observedKeyPaths = [NSMutableArray array];
+    [self.viewModel addObserver:self forKeyPath:@"valid" options:0 context:nil];
+    [self.viewModel addObserver:self forKeyPath:@"brand" options:0 context:nil];
+
+    self.viewModel.cardNumber = @"4";
+    self.viewModel.cardNumber = @"42";
+    self.viewModel.cardNumber = @"4242424242424242";
+    self.viewModel.rawExpiration = @"12/99";
+    XCTAssertEqualObjects(self.observedKeyPaths, @[@"brand"]);
+
+    self.viewModel.cvc = @"1";
+    self.viewModel.cvc = @"12";
+    self.viewModel.cvc = @"123";
+    XCTAssertEqualObjects(self.observedKeyPaths, (@[@"brand", @"valid"]));
+    XCTAssertEqual([self.viewModel validationStateForField:STPCardFieldTypeCVC], STPCardValidationStateValid);
+
+    self.viewModel.cardNumber = @"378282246310005";
+    XCTAssertEqualObjects(self.observedKeyPaths, (@[@"brand", @"valid", @"brand"]));
+    XCTAssertEqual([self.viewModel validationStateForField:STPCardFieldTypeNumber], STPCardValidationStateValid);
+
+    [self.viewModel removeObserver:self forKeyPath:@"valid"];
+    [self.viewModel removeObserver:self forKeyPath:@"brand"];
+}
+
 @end
@@ -0,0 +1,51 @@
+//
+//  STPPaymentConfigurationTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPPaymentConfiguration+Private.h"
+
+@interface STPPaymentConfigurationTest : XCTestCase
+@end
+
+@implementation STPPaymentConfigurationTest
+
+- (void)testSnapshotIsReusedUntilChanged {
+    STPPaymentConfiguration *configuration = [STPPaymentConfiguration new];
+    configuration.publishableKey = @"pk_test_1";
+    configuration.companyName = @"Test Company";
+    STPPaymentConfiguration *snapshot = [configuration configurationSnapshot];
+    XCTAssertNotEqual(snapshot, configuration);
+    XCTAssertEqual([configuration configurationSnapshot], snapshot);
+    XCTAssertEqual([snapshot configurationSnapshot], snapshot);
+    XCTAssertEqualObjects(snapshot.publishableKey, @"pk_test_1");
+    XCTAssertEqualObjects(snapshot.companyName, @"Test Company");
+
+    NSUInteger changeCount = configuration.changeCount;
+    configuration.publishableKey = @"pk_test_2";
+    XCTAssertNotEqual(configuration.changeCount, changeCount);
+    XCTAssertEqualObjects(snapshot.publishableKey, @"pk_test_1");
+    STPPaymentConfiguration *newSnapshot = [configuration configurationSnapshot];
+    XCTAssertNotEqual(newSnapshot, snapshot);
+    XCTAssertEqualObjects(newSnapshot.publishableKey, @"pk_test_2");
+}
+
+- (void)testSnapshotKeepsIneligibility {
+    STPPaymentConfiguration *configuration = [STPPaymentConfiguration new];
+    configuration.ineligibleForSmsAutofill = YES;
+    STPPaymentConfiguration *snapshot = [configuration configurationSnapshot];
+    XCTAssertTrue(snapshot.ineligibleForSmsAutofill);
+    XCTAssertTrue(snapshot.smsAutofillDisabled);
+}
+
+- (void)testSnapshotsCantBeChanged {
+    STPPaymentConfiguration *snapshot = [[STPPaymentConfiguration new] configurationSnapshot];
+    XCTAssertThrows(snapshot.publishableKey = @"pk_test_1");
+}
+
+@end
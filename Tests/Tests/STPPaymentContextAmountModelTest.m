@@ -0,0 +1,56 @@
+//
+//  STPPaymentContextAmountModelTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "STPPaymentContextAmountModel.h"
+
+@interface STPPaymentContextAmountModelTest : XCTestCase
+@end
+
+@implementation STPPaymentContextAmountModelTest
+
+- (PKShippingMethod *)shippingMethodWithAmount:(NSString *)amount {
+    PKShippingMethod *method = [PKShippingMethod summaryItemWithLabel:@"Shipping"
+                                                               amount:[NSDecimalNumber decimalNumberWithString:amount]];
+    method.identifier = @"ship";
+    return method;
+}
+
+- (void)testSummaryItemsAreReusedForSameInputs {
+    STPPaymentContextAmountModel *model = [[STPPaymentContextAmountModel alloc] initWithAmount:1000];
+    PKShippingMethod *method = [self shippingMethodWithAmount:@"5.00"];
+    NSArray *first = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:method];
+    NSArray *second = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:method];
+    XCTAssertEqual(first, second);
+    XCTAssertEqualObjects(first.lastObject.amount, [NSDecimalNumber decimalNumberWithString:@"15.00"]);
+}
+
+- (void)testSummaryItemsAreRebuiltWhenShippingChanges {
+    STPPaymentContextAmountModel *model = [[STPPaymentContextAmountModel alloc] initWithAmount:1000];
+    PKShippingMethod *method = [self shippingMethodWithAmount:@"5.00"];
+    NSArray *first = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:method];
+
+    PKShippingMethod *otherMethod = [self shippingMethodWithAmount:@"7.00"];
+    NSArray *second = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:otherMethod];
+    XCTAssertNotEqual(first, second);
+    XCTAssertEqualObjects(second.lastObject.amount, [NSDecimalNumber decimalNumberWithString:@"17.00"]);
+
+    otherMethod.amount = [NSDecimalNumber decimalNumberWithString:@"9.00"];
+    NSArray *third = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:otherMethod];
+    XCTAssertEqualObjects(third.lastObject.amount, [NSDecimalNumber decimalNumberWithString:@"19.00"]);
+}
+
+- (void)testSummaryItemsAreRebuiltWhenCompanyNameChanges {
+    STPPaymentContextAmountModel *model = [[STPPaymentContextAmountModel alloc] initWithAmount:1000];
+    NSArray *first = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Acme" shippingMethod:nil];
+    NSArray *second = [model paymentSummaryItemsWithCurrency:@"usd" companyName:@"Other" shippingMethod:nil];
+    XCTAssertEqualObjects(first.lastObject.label, @"Acme");
+    XCTAssertEqualObjects(second.lastObject.label, @"Other");
+}
+
+@end
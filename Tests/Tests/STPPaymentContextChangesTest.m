@@ -0,0 +1,93 @@
+//
+//  STPPaymentContextChangesTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+
+#import "STPApplePayPaymentMethod.h"
+#import "STPFixtures.h"
+#import "STPPaymentContext.h"
+
+@interface STPPaymentContext (Testing)
+@property(nonatomic)id<STPPaymentMethod> selectedPaymentMethod;
+@property(nonatomic)NSArray<id<STPPaymentMethod>> *paymentMethods;
+@property(nonatomic)NSArray<PKShippingMethod *> *shippingMethods;
+@property(nonatomic)STPPaymentContextChanges pendingChanges;
+@end
+
+/**
+ Only implements the required change callback.
+ */
+@interface STPPaymentContextChangeCounter : NSObject<STPPaymentContextDelegate>
+@property(nonatomic)NSUInteger changeCount;
+@end
+
+@implementation STPPaymentContextChangeCounter
+
+- (void)paymentContext:(__unused STPPaymentContext *)paymentContext didFailToLoadWithError:(__unused NSError *)error {
+}
+
+- (void)paymentContextDidChange:(__unused STPPaymentContext *)paymentContext {
+    self.changeCount++;
+}
+
+- (void)paymentContext:(__unused STPPaymentContext *)paymentContext didCreatePaymentResult:(__unused STPPaymentResult *)paymentResult completion:(__unused STPErrorBlock)completion {
+}
+
+- (void)paymentContext:(__unused STPPaymentContext *)paymentContext didFinishWithStatus:(__unused STPPaymentStatus)status error:(__unused NSError *)error {
+}
+
+@end
+
+@interface STPPaymentContextChangesTest : XCTestCase
+
+@end
+
+@implementation STPPaymentContextChangesTest
+
+- (STPPaymentContext *)buildPaymentContext {
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                                                 configuration:[STPFixtures paymentConfiguration]
+                                                                         theme:[STPTheme defaultTheme]];
+    // Let the customer load first
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    return context;
+}
+
+- (void)testChangesInOneTurnAreDeliveredTogether {
+    STPPaymentContext *context = [self buildPaymentContext];
+    context.pendingChanges = 0;
+    id delegate = OCMProtocolMock(@protocol(STPPaymentContextDelegate));
+    context.delegate = delegate;
+    STPPaymentContextChanges expected = STPPaymentContextChangePaymentMethods | STPPaymentContextChangeSelectedPaymentMethod | STPPaymentContextChangeShippingMethods;
+    OCMExpect([delegate paymentContext:context didChange:expected]);
+    [[delegate reject] paymentContextDidChange:[OCMArg any]];
+
+    STPApplePayPaymentMethod *applePay = [STPApplePayPaymentMethod new];
+    context.paymentMethods = @[applePay];
+    context.selectedPaymentMethod = [STPApplePayPaymentMethod new];
+    context.shippingMethods = @[];
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    OCMVerifyAll(delegate);
+}
+
+- (void)testDelegatesWithoutChangeSetsAreToldOnce {
+    STPPaymentContext *context = [self buildPaymentContext];
+    STPPaymentContextChangeCounter *delegate = [STPPaymentContextChangeCounter new];
+    context.delegate = delegate;
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    delegate.changeCount = 0;
+
+    context.paymentMethods = @[];
+    context.selectedPaymentMethod = [STPApplePayPaymentMethod new];
+    XCTAssertEqual(delegate.changeCount, 0U);
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqual(delegate.changeCount, 1U);
+}
+
+@end
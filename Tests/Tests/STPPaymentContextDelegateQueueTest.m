@@ -0,0 +1,65 @@
+//
+//  STPPaymentContextDelegateQueueTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+
+#import "STPApplePayPaymentMethod.h"
+#import "STPFixtures.h"
+#import "STPPaymentContext.h"
+
+@interface STPPaymentContext (Testing)
+@property(nonatomic)id<STPPaymentMethod> selectedPaymentMethod;
+@end
+
+static void *STPDelegateQueueKey = &STPDelegateQueueKey;
+
+@interface STPPaymentContextDelegateQueueTest : XCTestCase
+
+@end
+
+@implementation STPPaymentContextDelegateQueueTest
+
+- (STPPaymentContext *)buildPaymentContext {
+    return [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                           configuration:[STPFixtures paymentConfiguration]
+                                                   theme:[STPTheme defaultTheme]];
+}
+
+- (void)testDelegateQueueDefaultsToMainQueue {
+    STPPaymentContext *context = [self buildPaymentContext];
+    XCTAssertEqual(context.delegateQueue, dispatch_get_main_queue());
+    context.delegateQueue = dispatch_queue_create("com.stripe.test", DISPATCH_QUEUE_SERIAL);
+    context.delegateQueue = nil;
+    XCTAssertEqual(context.delegateQueue, dispatch_get_main_queue());
+}
+
+- (void)testDelegateIsCalledOnDelegateQueue {
+    STPPaymentContext *context = [self buildPaymentContext];
+    dispatch_queue_t queue = dispatch_queue_create("com.stripe.test", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(queue, STPDelegateQueueKey, STPDelegateQueueKey, NULL);
+    context.delegateQueue = queue;
+
+    id delegate = OCMProtocolMock(@protocol(STPPaymentContextDelegate));
+    context.delegate = delegate;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"didChange"];
+    // Loading the customer may change the context too; these are all
+    // delivered on the serial delegate queue.
+    __block BOOL fulfilled = NO;
+    OCMStub([delegate paymentContext:context didChange:0]).ignoringNonObjectArgs().andDo(^(__unused NSInvocation *invocation) {
+        XCTAssertEqual(dispatch_get_specific(STPDelegateQueueKey), STPDelegateQueueKey);
+        if (!fulfilled) {
+            fulfilled = YES;
+            [expectation fulfill];
+        }
+    });
+    context.selectedPaymentMethod = [STPApplePayPaymentMethod new];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+@end
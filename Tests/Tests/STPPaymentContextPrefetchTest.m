@@ -0,0 +1,99 @@
+//
+//  STPPaymentContextPrefetchTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+
+#import "STPFixtures.h"
+#import "STPPaymentContext.h"
+
+@interface STPPaymentContext (Testing)
+@property(nonatomic)STPAPIClient *apiClient;
+@property(nonatomic)STPPaymentMethodsViewController *preparedPaymentMethodsViewController;
+- (STPPaymentMethodsViewController *)dequeuePaymentMethodsViewController;
+- (void)paymentMethodsViewController:(STPPaymentMethodsViewController *)paymentMethodsViewController
+              didSelectPaymentMethod:(id<STPPaymentMethod>)paymentMethod;
+@end
+
+@interface STPPaymentContextPrefetchTest : XCTestCase
+
+@end
+
+@implementation STPPaymentContextPrefetchTest
+
+- (void)testSettingHostViewControllerPrewarmsConnection {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.smsAutofillDisabled = YES;
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                                                 configuration:config
+                                                                         theme:[STPTheme defaultTheme]];
+    id apiClient = OCMPartialMock(context.apiClient);
+    OCMExpect([apiClient prewarmConnection]);
+    UIViewController *hostViewController = [UIViewController new];
+    context.hostViewController = hostViewController;
+    OCMVerifyAll(apiClient);
+}
+
+- (void)testPreparePaymentMethodsViewController {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.smsAutofillDisabled = YES;
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                                                 configuration:config
+                                                                         theme:[STPTheme defaultTheme]];
+    context.hostViewController = [UIViewController new];
+    [context preparePaymentMethodsViewController];
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"preparedPaymentMethodsViewController != nil"]
+              evaluatedWithObject:context
+                          handler:nil];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    STPPaymentMethodsViewController *prepared = context.preparedPaymentMethodsViewController;
+    XCTAssertTrue(prepared.isViewLoaded);
+    XCTAssertEqual([context dequeuePaymentMethodsViewController], prepared);
+    XCTAssertNil(context.preparedPaymentMethodsViewController);
+    XCTAssertNotEqual([context dequeuePaymentMethodsViewController], prepared);
+}
+
+- (void)testPreparedPaymentMethodsViewControllerNeedsSamePrefilledInformation {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.smsAutofillDisabled = YES;
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                                                 configuration:config
+                                                                         theme:[STPTheme defaultTheme]];
+    context.hostViewController = [UIViewController new];
+    [context preparePaymentMethodsViewController];
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"preparedPaymentMethodsViewController != nil"]
+              evaluatedWithObject:context
+                          handler:nil];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    STPPaymentMethodsViewController *prepared = context.preparedPaymentMethodsViewController;
+    context.prefilledInformation = [STPUserInformation new];
+    STPPaymentMethodsViewController *shown = [context dequeuePaymentMethodsViewController];
+    XCTAssertNotEqual(shown, prepared);
+    XCTAssertEqual(shown.prefilledInformation, context.prefilledInformation);
+}
+
+- (void)testPreparedPaymentMethodsViewControllerDroppedWhenPaymentMethodsChange {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.smsAutofillDisabled = YES;
+    STPPaymentContext *context = [[STPPaymentContext alloc] initWithAPIAdapter:[STPFixtures staticAPIAdapter]
+                                                                 configuration:config
+                                                                         theme:[STPTheme defaultTheme]];
+    [context preparePaymentMethodsViewController];
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"preparedPaymentMethodsViewController != nil"]
+              evaluatedWithObject:context
+                          handler:nil];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    [context paymentMethodsViewController:context.preparedPaymentMethodsViewController
+                   didSelectPaymentMethod:[STPApplePayPaymentMethod new]];
+    XCTAssertNil(context.preparedPaymentMethodsViewController);
+}
+
+@end
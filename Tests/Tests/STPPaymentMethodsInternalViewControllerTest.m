@@ -0,0 +1,53 @@
+//
+//  STPPaymentMethodsInternalViewControllerTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPCoreTableViewController+Private.h"
+#import "STPFixtures.h"
+#import "STPPaymentMethodsInternalViewController.h"
+#import "STPTestUtils.h"
+
+@interface STPPaymentMethodsInternalViewControllerTest : XCTestCase
+
+@end
+
+@implementation STPPaymentMethodsInternalViewControllerTest
+
+- (STPCard *)cardWithID:(NSString *)cardID {
+    NSMutableDictionary *json = [[STPTestUtils jsonNamed:@"Card"] mutableCopy];
+    json[@"id"] = cardID;
+    return [STPCard decodedObjectFromAPIResponse:json];
+}
+
+- (void)testUpdateAppliesRowChanges {
+    STPCard *card1 = [self cardWithID:@"card_1"];
+    STPCard *card2 = [self cardWithID:@"card_2"];
+    STPCard *card3 = [self cardWithID:@"card_3"];
+    STPPaymentMethodTuple *tuple = [STPPaymentMethodTuple tupleWithPaymentMethods:@[card1, card2] selectedPaymentMethod:card1];
+    STPPaymentMethodsInternalViewController *sut = [[STPPaymentMethodsInternalViewController alloc] initWithConfiguration:[STPFixtures paymentConfiguration]
+                                                                                                                      theme:[STPTheme defaultTheme]
+                                                                                                       prefilledInformation:nil
+                                                                                                            shippingAddress:nil
+                                                                                                         paymentMethodTuple:tuple
+                                                                                                                   delegate:OCMProtocolMock(@protocol(STPPaymentMethodsInternalViewControllerDelegate))];
+    sut.view.frame = CGRectMake(0, 0, 320, 750);
+    [sut.view layoutIfNeeded];
+    UITableView *tableView = sut.tableView;
+    XCTAssertEqual([tableView numberOfRowsInSection:0], 2);
+
+    // One card removed, one added, and the selection moved.
+    [sut updateWithPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:@[card1, card3] selectedPaymentMethod:card3]];
+    XCTAssertEqual([tableView numberOfRowsInSection:0], 2);
+
+    // A reordering falls back to reloading the section.
+    [sut updateWithPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:@[card3, card1, card2] selectedPaymentMethod:card3]];
+    XCTAssertEqual([tableView numberOfRowsInSection:0], 3);
+}
+
+@end
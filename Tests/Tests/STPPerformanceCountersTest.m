@@ -0,0 +1,54 @@
+//
+//  STPPerformanceCountersTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPAPIClient.h"
+#import "STPBINRange.h"
+#import "STPImageLibrary.h"
+#import "STPPerformanceCounters.h"
+
+@interface STPPerformanceCountersTest : XCTestCase
+@end
+
+@implementation STPPerformanceCountersTest
+
+- (void)testCounterForEndpoint {
+    XCTAssertEqual(STPPerformanceCounterForEndpoint(@"tokens"), STPPerformanceCounterTokensRequests);
+    XCTAssertEqual(STPPerformanceCounterForEndpoint(@"sources"), STPPerformanceCounterSourcesRequests);
+    XCTAssertEqual(STPPerformanceCounterForEndpoint(@"sources/src_123"), STPPerformanceCounterSourcesRequests);
+    XCTAssertEqual(STPPerformanceCounterForEndpoint(@"sourcesfoo"), STPPerformanceCounterOtherRequests);
+    XCTAssertEqual(STPPerformanceCounterForEndpoint(@"customers/cus_123"), STPPerformanceCounterOtherRequests);
+}
+
+- (void)testSnapshotDifference {
+    STPPerformanceSnapshot *before = [Stripe performanceSnapshot];
+    STPPerformanceCounterIncrement(STPPerformanceCounterTokensRequests);
+    STPPerformanceCounterAdd(STPPerformanceCounterBytesSent, 100);
+    STPPerformanceCounterAdd(STPPerformanceCounterDecodeMicroseconds, 2500);
+    STPPerformanceSnapshot *difference = [[Stripe performanceSnapshot] snapshotBySubtractingSnapshot:before];
+    XCTAssertEqualObjects(difference.requestCounts[@"tokens"], @1);
+    XCTAssertEqualObjects(difference.requestCounts[STPPerformanceEndpointOther], @0);
+    XCTAssertEqual(difference.bytesSent, (uint64_t)100);
+    XCTAssertEqualWithAccuracy(difference.decodeDuration, 0.0025, 0.00001);
+
+    // Never wraps around
+    XCTAssertEqual([before snapshotBySubtractingSnapshot:[Stripe performanceSnapshot]].bytesSent, (uint64_t)0);
+}
+
+- (void)testLookupsAreCounted {
+    STPPerformanceSnapshot *before = [Stripe performanceSnapshot];
+    [STPBINRange mostSpecificBINRangeForNumber:@"4242"];
+    [STPImageLibrary visaCardImage];
+    [STPImageLibrary visaCardImage];
+    STPPerformanceSnapshot *difference = [[Stripe performanceSnapshot] snapshotBySubtractingSnapshot:before];
+    XCTAssertGreaterThanOrEqual(difference.binRangeLookupCount, (uint64_t)1);
+    XCTAssertGreaterThanOrEqual(difference.imageCacheHitCount, (uint64_t)1);
+}
+
+@end
@@ -0,0 +1,57 @@
+//
+//  STPPerformanceHUDTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPCoreViewController.h"
+#import "STPMainThreadWatchdog.h"
+#import "STPPerformanceHUD+Private.h"
+
+@interface STPPerformanceHUDTest : XCTestCase
+@end
+
+@implementation STPPerformanceHUDTest
+
+- (void)tearDown {
+    [STPPerformanceHUD hide];
+    [super tearDown];
+}
+
+- (void)testShowsEverySection {
+    [STPPerformanceHUD show];
+    NSString *text = [STPPerformanceHUD currentText];
+    for (NSString *section in @[@"Requests", @"Source polls", @"Analytics:", @"Images:", @"Card brand lookups:", @"Main thread:"]) {
+        XCTAssertTrue([text containsString:section], @"%@", section);
+    }
+}
+
+- (void)testMainThreadTimeStartsOverForNewScreen {
+    [STPPerformanceHUD show];
+    STPCoreViewController *screen = [STPCoreViewController new];
+    [STPPerformanceHUD noteCurrentScreen:screen];
+    CFAbsoluteTime start = STPMainThreadWatchdogBegin();
+    [NSThread sleepForTimeInterval:0.01];
+    STPMainThreadWatchdogEnd(start, self, _cmd);
+    XCTAssertFalse([[STPPerformanceHUD currentText] containsString:@"Main thread: 0 ms in STPCoreViewController"]);
+
+    // Appearing again doesn't start over
+    [STPPerformanceHUD noteCurrentScreen:screen];
+    XCTAssertFalse([[STPPerformanceHUD currentText] containsString:@"Main thread: 0 ms"]);
+
+    STPCoreViewController *otherScreen = [STPCoreViewController new];
+    [STPPerformanceHUD noteCurrentScreen:otherScreen];
+    XCTAssertTrue([[STPPerformanceHUD currentText] containsString:@"Main thread: 0 ms in STPCoreViewController"]);
+}
+
+- (void)testHideStopsMeasuring {
+    [STPPerformanceHUD show];
+    [STPPerformanceHUD hide];
+    XCTAssertEqual(STPMainThreadWatchdogBegin(), (CFAbsoluteTime)0);
+}
+
+@end
@@ -0,0 +1,169 @@
+//
+//  STPPerformanceTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPBINRange.h"
+#import "STPCardTuple.h"
+#import "STPCardValidator.h"
+#import "STPCustomer.h"
+#import "STPFixtures.h"
+#import "STPFormEncoder.h"
+#import "STPPaymentMethodTuple.h"
+#import "STPPhoneNumberValidator.h"
+#import "STPTestUtils.h"
+
+// Repeat each operation enough times that it's well above timer noise.
+static NSUInteger const STPPerformanceTestIterations = 10000;
+
+/**
+ Timings for the validation, encoding and decoding hot paths. Run these on a
+ device and set a baseline in Xcode's test navigator to catch regressions.
+ */
+@interface STPPerformanceTest : XCTestCase
+
+@property (nonatomic) NSArray<NSString *> *cardNumbers;
+
+@end
+
+@implementation STPPerformanceTest
+
+- (void)setUp {
+    [super setUp];
+    self.cardNumbers = @[
+                         @"4242424242424242",
+                         @"4000056655665556",
+                         @"5555555555554444",
+                         @"378282246310005",
+                         @"6011111111111117",
+                         @"30569309025904",
+                         @"3530111333300000",
+                         @"6200000000000005",
+                         @"1234567812345678",
+                         @"42424",
+                         ];
+}
+
+- (void)testBrandForNumberPerformance {
+    NSArray<NSString *> *numbers = self.cardNumbers;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < STPPerformanceTestIterations; i++) {
+            [STPCardValidator brandForNumber:numbers[i % numbers.count]];
+        }
+    }];
+}
+
+- (void)testLuhnValidationPerformance {
+    NSArray<NSString *> *numbers = self.cardNumbers;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < STPPerformanceTestIterations; i++) {
+            [STPCardValidator validationStateForNumber:numbers[i % numbers.count] validatingCardBrand:NO];
+        }
+    }];
+}
+
+- (void)testMostSpecificBINRangePerformance {
+    NSArray<NSString *> *numbers = self.cardNumbers;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < STPPerformanceTestIterations; i++) {
+            [STPBINRange mostSpecificBINRangeForNumber:numbers[i % numbers.count]];
+        }
+    }];
+}
+
+- (void)testQueryStringFromLargeNestedParametersPerformance {
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < 50; i++) {
+        parameters[[NSString stringWithFormat:@"key_%lu", (unsigned long)i]] = @{
+                                                                                 @"name": @"Jenny Rosen",
+                                                                                 @"address": @{
+                                                                                         @"line1": @"123 Fake St",
+                                                                                         @"city": @"San Francisco",
+                                                                                         @"postal_code": @"94107",
+                                                                                         },
+                                                                                 @"items": @[@"a b", @"c&d", @(i)],
+                                                                                 };
+    }
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100; i++) {
+            [STPFormEncoder queryStringFromParameters:parameters];
+        }
+    }];
+}
+
+- (void)testFormattedSanitizedPhoneNumberPerformance {
+    NSArray<NSString *> *phoneNumbers = @[@"5555555555", @"(555) 555-5555", @"555", @"+1 555 555 5555"];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < STPPerformanceTestIterations; i++) {
+            [STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:phoneNumbers[i % phoneNumbers.count]];
+        }
+    }];
+}
+
+- (void)testCustomerDecodingPerformance {
+    NSDictionary *customer = [STPTestUtils jsonNamed:@"Customer"];
+    NSData *data = [NSJSONSerialization dataWithJSONObject:customer options:(NSJSONWritingOptions)kNilOptions error:nil];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 1000; i++) {
+            __unused STPCustomerDeserializer *deserializer = [[STPCustomerDeserializer alloc] initWithData:data urlResponse:nil error:nil];
+        }
+    }];
+}
+
+#pragma mark - Wallet size
+
+// Compare these between sizes to see how costs grow with the customer's
+// wallet; each size repeats the work so the totals stay comparable.
+- (void)measureCustomerDecodingWithSourceCount:(NSUInteger)sourceCount {
+    NSDictionary *customer = [STPFixtures customerJSONWithSourceCount:sourceCount];
+    NSData *data = [NSJSONSerialization dataWithJSONObject:customer options:(NSJSONWritingOptions)kNilOptions error:nil];
+    NSUInteger repeats = 10000 / sourceCount;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < repeats; i++) {
+            __unused STPCustomerDeserializer *deserializer = [[STPCustomerDeserializer alloc] initWithData:data urlResponse:nil error:nil];
+        }
+    }];
+}
+
+- (void)testCustomerDecodingPerformanceWith10Sources {
+    [self measureCustomerDecodingWithSourceCount:10];
+}
+
+- (void)testCustomerDecodingPerformanceWith100Sources {
+    [self measureCustomerDecodingWithSourceCount:100];
+}
+
+- (void)testCustomerDecodingPerformanceWith1000Sources {
+    [self measureCustomerDecodingWithSourceCount:1000];
+}
+
+// What STPPaymentContext's retryLoading does with a loaded customer
+- (void)measurePaymentMethodTuplesWithSourceCount:(NSUInteger)sourceCount {
+    STPCustomer *customer = [STPFixtures customerWithSourceCount:sourceCount];
+    NSUInteger repeats = 10000 / sourceCount;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < repeats; i++) {
+            STPCardTuple *cardTuple = [STPCardTuple tupleWithCustomer:customer];
+            __unused STPPaymentMethodTuple *tuple = [STPPaymentMethodTuple tupleWithCardTuple:cardTuple applePayEnabled:NO];
+        }
+    }];
+}
+
+- (void)testPaymentMethodTuplePerformanceWith10Sources {
+    [self measurePaymentMethodTuplesWithSourceCount:10];
+}
+
+- (void)testPaymentMethodTuplePerformanceWith100Sources {
+    [self measurePaymentMethodTuplesWithSourceCount:100];
+}
+
+- (void)testPaymentMethodTuplePerformanceWith1000Sources {
+    [self measurePaymentMethodTuplesWithSourceCount:1000];
+}
+
+@end
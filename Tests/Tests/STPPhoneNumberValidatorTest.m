@@ -43,6 +43,16 @@ static NSString *const kUKCountryCode = @"UK";
                           @"5555555555123");
 }
 
+- (void)testFormattedSanitizedPhoneNumberForOtherRegions {
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"6" forCountryCode:@"FR"], @"6");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"06" forCountryCode:@"FR"], @"06 ");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"0612345678" forCountryCode:@"FR"], @"06 12 34 56 78");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"06123456789" forCountryCode:@"FR"], @"06 12 34 56 789");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"07700 900-123" forCountryCode:@"GB"], @"07700 900123");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"61312345678" forCountryCode:@"CA"], @"(613) 123-4567");
+    XCTAssertEqualObjects([STPPhoneNumberValidator formattedSanitizedPhoneNumberForString:@"A-12345" forCountryCode:@"JP"], @"12345");
+}
+
 - (void)testFormattedRedactedPhoneNumberForString {
     XCTAssertEqualObjects([STPPhoneNumberValidator formattedRedactedPhoneNumberForString:@"+1******1234"], @"+1 (•••) •••-1234");
     XCTAssertEqualObjects([STPPhoneNumberValidator formattedRedactedPhoneNumberForString:@"+86******1234" forCountryCode:kUKCountryCode], @"+86 ••••••1234");
@@ -61,4 +61,23 @@
     }   
 }
 
+- (void)testPostalCodeTypeForCountryCode {
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:@"US"], STPCountryPostalCodeTypeNumericOnly);
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:@"IE"], STPCountryPostalCodeTypeNotRequired);
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:@"ZW"], STPCountryPostalCodeTypeNotRequired);
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:@"CA"], STPCountryPostalCodeTypeAlphanumeric);
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:@"GB"], STPCountryPostalCodeTypeAlphanumeric);
+    XCTAssertEqual([STPPostalCodeValidator postalCodeTypeForCountryCode:nil], STPCountryPostalCodeTypeAlphanumeric);
+}
+
+- (void)testFormattedSanitizedPostalCode {
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"k1a" countryCode:@"CA"], @"K1A");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"k1a0" countryCode:@"CA"], @"K1A 0");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"K1A 0B1X" countryCode:@"CA"], @"K1A 0B1");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"sw1a1aa" countryCode:@"GB"], @"SW1A 1AA");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"m11ae" countryCode:@"GB"], @"M1 1AE");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"SW1" countryCode:@"GB"], @"SW1");
+    XCTAssertEqualObjects([STPPostalCodeValidator formattedSanitizedPostalCodeFromString:@"10002-1234" countryCode:@"US"], @"10002-1234");
+}
+
 @end
@@ -0,0 +1,150 @@
+//
+//  STPPromiseTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import <objc/runtime.h>
+
+#import "STPCoreViewController.h"
+#import "STPPromise.h"
+#import "UIViewController+Stripe_Promises.h"
+
+@interface STPPromiseTest : XCTestCase
+
+@end
+
+@implementation STPPromiseTest
+
+- (void)testCallbacksRunInOrder {
+    STPPromise<NSString *> *promise = [STPPromise new];
+    NSMutableArray *calls = [NSMutableArray array];
+    [promise onSuccess:^(__unused NSString *value) { [calls addObject:@1]; }];
+    [promise onFailure:^(__unused NSError *error) { [calls addObject:@2]; }];
+    [promise onCompletion:^(__unused NSString *value, __unused NSError *error) { [calls addObject:@3]; }];
+    [promise succeed:@"foo"];
+    XCTAssertEqualObjects(calls, (@[@1, @3]));
+    XCTAssertTrue(promise.completed);
+    XCTAssertEqualObjects(promise.value, @"foo");
+    XCTAssertNil(promise.error);
+
+    [promise fail:[NSError errorWithDomain:@"foo" code:0 userInfo:nil]];
+    XCTAssertEqualObjects(promise.value, @"foo");
+    XCTAssertNil(promise.error);
+}
+
+- (void)testConcurrentRegistrationAndCompletion {
+    STPPromise<NSNumber *> *promise = [STPPromise new];
+    NSUInteger callbackCount = 1000;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"callbacks"];
+    __block NSUInteger calls = 0;
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    dispatch_apply(callbackCount, queue, ^(size_t i) {
+        [promise onSuccess:^(__unused NSNumber *value) {
+            // Callbacks always run on the main thread
+            calls++;
+            if (calls == callbackCount) {
+                [expectation fulfill];
+            }
+        }];
+        if (i == callbackCount / 2) {
+            [promise succeed:@1];
+        }
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(calls, callbackCount);
+}
+
+
+- (void)testCallbackQueues {
+    STPPromise<NSNumber *> *promise = [STPPromise new];
+    dispatch_queue_t queue = dispatch_queue_create("com.stripe.promisetest", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *mapExpectation = [self expectationWithDescription:@"map"];
+    XCTestExpectation *mainExpectation = [self expectationWithDescription:@"main"];
+    __block BOOL ranImmediately = NO;
+    [promise onSuccess:^(__unused NSNumber *value) {
+        ranImmediately = YES;
+    } onQueue:STPPromiseImmediateQueue()];
+    [[promise map:^id(NSNumber *value) {
+        XCTAssertFalse([NSThread isMainThread]);
+        [mapExpectation fulfill];
+        return @(value.integerValue + 1);
+    } onQueue:queue] onSuccess:^(id value) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertEqualObjects(value, @2);
+        [mainExpectation fulfill];
+    }];
+    dispatch_sync(queue, ^{
+        [promise succeed:@1];
+        XCTAssertTrue(ranImmediately);
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+
+- (void)testAll {
+    STPPromise *first = [STPPromise new];
+    STPPromise *second = [STPPromise new];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"all"];
+    [[STPPromise all:@[first, second]] onSuccess:^(NSArray *values) {
+        XCTAssertEqualObjects(values, (@[@1, @2]));
+        [expectation fulfill];
+    }];
+    [second succeed:@2];
+    [first succeed:@1];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    NSError *error = [NSError errorWithDomain:@"foo" code:0 userInfo:nil];
+    XCTestExpectation *failureExpectation = [self expectationWithDescription:@"all failure"];
+    [[STPPromise all:@[[STPPromise new], [STPPromise promiseWithError:error]]] onFailure:^(NSError *allError) {
+        XCTAssertEqualObjects(allError, error);
+        [failureExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testRace {
+    STPPromise *slow = [STPPromise new];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"race"];
+    [[STPPromise race:@[slow, [STPPromise promiseWithValue:@"fast"]]] onSuccess:^(id value) {
+        XCTAssertEqualObjects(value, @"fast");
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testTimeout {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"timeout"];
+    [[[STPPromise new] timeout:0.1] onFailure:^(NSError *error) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorTimedOut);
+        [expectation fulfill];
+    }];
+    XCTestExpectation *valueExpectation = [self expectationWithDescription:@"value"];
+    [[[STPPromise promiseWithValue:@1] timeout:0.1] onSuccess:^(id value) {
+        XCTAssertEqualObjects(value, @1);
+        [valueExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testCoreViewControllerAppearancePromises {
+    STPCoreViewController *viewController = [STPCoreViewController new];
+    Class originalClass = object_getClass(viewController);
+    STPVoidPromise *willAppear = viewController.stp_willAppearPromise;
+    STPVoidPromise *didAppear = viewController.stp_didAppearPromise;
+    XCTAssertEqual(viewController.stp_willAppearPromise, willAppear);
+    XCTAssertFalse(willAppear.completed);
+    [viewController viewWillAppear:NO];
+    XCTAssertTrue(willAppear.completed);
+    XCTAssertFalse(didAppear.completed);
+    [viewController viewDidAppear:NO];
+    XCTAssertTrue(didAppear.completed);
+    XCTAssertEqual(object_getClass(viewController), originalClass);
+}
+
+@end
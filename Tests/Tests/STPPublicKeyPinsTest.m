@@ -0,0 +1,59 @@
+//
+//  STPPublicKeyPinsTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPPublicKeyPins.h"
+#import "STPURLSessionPool.h"
+
+@interface STPPublicKeyPinsTest : XCTestCase
+
+@end
+
+@implementation STPPublicKeyPinsTest
+
+- (void)testPinsAreSetPerHost {
+    if (&SecKeyCopyExternalRepresentation == NULL) {
+        return;
+    }
+    STPPublicKeyPins *pins = [STPPublicKeyPins new];
+    XCTAssertFalse([pins hasPinsForHost:@"api.stripe.com"]);
+    [pins setPinnedHashes:@[@"47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU="] forHost:@"API.stripe.com"];
+    XCTAssertTrue([pins hasPinsForHost:@"api.stripe.com"]);
+    XCTAssertFalse([pins hasPinsForHost:@"q.stripe.com"]);
+}
+
+- (void)testEmptyPinsRemovePinning {
+    STPPublicKeyPins *pins = [STPPublicKeyPins new];
+    [pins setPinnedHashes:@[@"47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU="] forHost:@"api.stripe.com"];
+    [pins setPinnedHashes:@[] forHost:@"api.stripe.com"];
+    XCTAssertFalse([pins hasPinsForHost:@"api.stripe.com"]);
+    [pins setPinnedHashes:@[@"47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU="] forHost:@"api.stripe.com"];
+    [pins setPinnedHashes:nil forHost:@"api.stripe.com"];
+    XCTAssertFalse([pins hasPinsForHost:@"api.stripe.com"]);
+}
+
+- (void)testConnectionFailsWithWrongPin {
+    if (&SecKeyCopyExternalRepresentation == NULL) {
+        return;
+    }
+    NSString *host = @"api.stripe.com";
+    [[STPPublicKeyPins sharedPins] setPinnedHashes:@[@"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA="] forHost:host];
+    // A session of its own, so no connection is already open
+    NSURLSession *session = [[STPURLSessionPool sharedPool] sessionForHost:host additionalHeaders:@{@"X-Test": [NSUUID UUID].UUIDString}];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Request"];
+    [[session dataTaskWithURL:[NSURL URLWithString:@"https://api.stripe.com/v1/tokens"] completionHandler:^(__unused NSData *data, __unused NSURLResponse *response, NSError *error) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [expectation fulfill];
+    }] resume];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    [[STPPublicKeyPins sharedPins] setPinnedHashes:nil forHost:host];
+}
+
+@end
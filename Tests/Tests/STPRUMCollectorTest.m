@@ -0,0 +1,112 @@
+//
+//  STPRUMCollectorTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPRUMCollector.h"
+
+@interface STPRUMCollectorTest : XCTestCase
+@property (nonatomic) NSMutableArray<NSDictionary *> *summaries;
+@property (nonatomic) STPRUMCollector *collector;
+@end
+
+@implementation STPRUMCollectorTest
+
+- (void)setUp {
+    [super setUp];
+    NSMutableArray<NSDictionary *> *summaries = [NSMutableArray array];
+    self.summaries = summaries;
+    self.collector = [[STPRUMCollector alloc] initWithReportInterval:1000 reporter:^(NSDictionary *summary) {
+        [summaries addObject:summary];
+    }];
+}
+
+- (void)testReportSummarizesEachMetric {
+    for (NSUInteger i = 1; i <= 100; i++) {
+        [self.collector recordDuration:i / 1000.0 forMetric:@"tokens.ttfb" category:STPRUMCategoryNetwork];
+    }
+    [self.collector recordDuration:0.25 forMetric:@"add_card.submit" category:STPRUMCategoryInterface];
+    [self.collector report];
+
+    XCTAssertEqual(self.summaries.count, (NSUInteger)2);
+    NSDictionary *submit = self.summaries[0];
+    XCTAssertEqualObjects(submit[@"metric"], @"add_card.submit");
+    XCTAssertEqualObjects(submit[@"category"], @"interface");
+    XCTAssertEqualObjects(submit[@"count"], @1);
+    XCTAssertEqualWithAccuracy([submit[@"p50_ms"] doubleValue], 250, 0.001);
+
+    NSDictionary *ttfb = self.summaries[1];
+    XCTAssertEqualObjects(ttfb[@"event"], @"rum.stripeios.summary");
+    XCTAssertEqualObjects(ttfb[@"metric"], @"tokens.ttfb");
+    XCTAssertEqualObjects(ttfb[@"category"], @"network");
+    XCTAssertEqualObjects(ttfb[@"count"], @100);
+    XCTAssertEqualWithAccuracy([ttfb[@"min_ms"] doubleValue], 1, 0.001);
+    XCTAssertEqualWithAccuracy([ttfb[@"max_ms"] doubleValue], 100, 0.001);
+    XCTAssertEqualWithAccuracy([ttfb[@"mean_ms"] doubleValue], 50.5, 0.001);
+    // Bucketed, so only within the bucket holding the true value
+    XCTAssertGreaterThanOrEqual([ttfb[@"p50_ms"] doubleValue], 20);
+    XCTAssertLessThanOrEqual([ttfb[@"p50_ms"] doubleValue], 50);
+    XCTAssertGreaterThanOrEqual([ttfb[@"p99_ms"] doubleValue], 50);
+    XCTAssertLessThanOrEqual([ttfb[@"p99_ms"] doubleValue], 100);
+
+    NSArray<NSString *> *buckets = [ttfb[@"buckets"] componentsSeparatedByString:@","];
+    XCTAssertEqual(buckets.count, [STPRUMCollector bucketUpperBounds].count + 1);
+    NSInteger total = 0;
+    for (NSString *bucket in buckets) {
+        total += bucket.integerValue;
+    }
+    XCTAssertEqual(total, 100);
+}
+
+- (void)testReportStartsANewPeriod {
+    [self.collector recordDuration:0.1 forMetric:@"tokens.total" category:STPRUMCategoryNetwork];
+    [self.collector report];
+    XCTAssertEqual(self.summaries.count, (NSUInteger)1);
+
+    [self.collector report];
+    XCTAssertEqual(self.summaries.count, (NSUInteger)1);
+
+    [self.collector recordDuration:0.1 forMetric:@"tokens.total" category:STPRUMCategoryNetwork];
+    [self.collector report];
+    XCTAssertEqual(self.summaries.count, (NSUInteger)2);
+    XCTAssertEqualObjects(self.summaries[1][@"count"], @1);
+}
+
+- (void)testSampleRates {
+    XCTAssertEqual([self.collector sampleRateForCategory:STPRUMCategoryNetwork], 1);
+    [self.collector setSampleRate:0 forCategory:STPRUMCategoryNetwork];
+    [self.collector setSampleRate:7 forCategory:STPRUMCategoryInterface];
+    XCTAssertEqual([self.collector sampleRateForCategory:STPRUMCategoryNetwork], 0);
+    XCTAssertEqual([self.collector sampleRateForCategory:STPRUMCategoryInterface], 1);
+
+    [self.collector recordDuration:0.1 forMetric:@"tokens.total" category:STPRUMCategoryNetwork];
+    [self.collector recordDuration:0.1 forMetric:@"add_card.appear" category:STPRUMCategoryInterface];
+    [self.collector report];
+    XCTAssertEqual(self.summaries.count, (NSUInteger)1);
+    XCTAssertEqualObjects(self.summaries[0][@"metric"], @"add_card.appear");
+    XCTAssertEqualObjects(self.summaries[0][@"sample_rate"], @1);
+}
+
+- (void)testDisabled {
+    self.collector.enabled = NO;
+    [self.collector recordDuration:0.1 forMetric:@"tokens.total" category:STPRUMCategoryNetwork];
+    [self.collector report];
+    XCTAssertEqual(self.summaries.count, (NSUInteger)0);
+}
+
+- (void)testReportsAfterInterval {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"reported"];
+    STPRUMCollector *collector = [[STPRUMCollector alloc] initWithReportInterval:0.1 reporter:^(NSDictionary *summary) {
+        XCTAssertEqualObjects(summary[@"metric"], @"tokens.total");
+        [expectation fulfill];
+    }];
+    [collector recordDuration:0.1 forMetric:@"tokens.total" category:STPRUMCategoryNetwork];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+@end
@@ -190,6 +190,31 @@
     OCMVerify([sut unsubscribeFromNotificationsAndDismissPresentedViewControllers]);
 }
 
+/**
+ After preparing a SafariViewController redirect flow,
+ starting it should present the prepared view controller.
+ */
+- (void)testSafariViewControllerRedirectFlow_presentsPreparedViewController {
+    id mockVC = OCMClassMock([UIViewController class]);
+    STPSource *source = [STPFixtures iDEALSource];
+    STPRedirectContext *context = [[STPRedirectContext alloc] initWithSource:source completion:^(__unused NSString *sourceID, __unused NSString *clientSecret, __unused NSError *error) {
+        XCTFail(@"completion called");
+    }];
+
+    [context prepareSafariViewControllerRedirectFlow];
+    SFSafariViewController *preparedVC = [context valueForKey:@"safariVC"];
+    XCTAssertNotNil(preparedVC);
+    XCTAssertEqual(context.state, STPRedirectContextStateNotStarted);
+
+    [context startSafariViewControllerRedirectFlowFromViewController:mockVC];
+
+    XCTAssertEqual(context.state, STPRedirectContextStateInProgress);
+    OCMVerify([mockVC presentViewController:preparedVC
+                                   animated:YES
+                                 completion:[OCMArg any]]);
+    [context cancel];
+}
+
 /**
  After starting a SafariViewController redirect flow,
  when the RedirectContext is dealloc'd, its dismiss method should be called.
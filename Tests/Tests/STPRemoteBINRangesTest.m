@@ -0,0 +1,72 @@
+//
+//  STPRemoteBINRangesTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPBINRange.h"
+#import "STPCardValidator.h"
+#import "STPRemoteBINRanges.h"
+
+@interface STPRemoteBINRangesTest : XCTestCase
+@end
+
+@implementation STPRemoteBINRangesTest
+
+- (void)tearDown {
+    [STPBINRange installAdditionalRanges:@[]];
+    [super tearDown];
+}
+
+- (NSArray<STPBINRange *> *)testRanges {
+    return @[
+             [[STPBINRange alloc] initWithQRangeLow:@"6200" qRangeHigh:@"6209" length:19 brand:STPCardBrandDiscover],
+             [[STPBINRange alloc] initWithQRangeLow:@"000001" qRangeHigh:@"000002" length:16 brand:STPCardBrandVisa],
+             ];
+}
+
+- (void)testRoundTrip {
+    NSData *data = [STPRemoteBINRanges dataWithRanges:[self testRanges]];
+    XCTAssertEqual(data.length, 48U + 12U * 2);
+    NSArray<STPBINRange *> *ranges = [STPRemoteBINRanges rangesFromData:data];
+    XCTAssertEqual(ranges.count, 2U);
+    XCTAssertEqualObjects(ranges[0].qRangeLow, @"6200");
+    XCTAssertEqualObjects(ranges[0].qRangeHigh, @"6209");
+    XCTAssertEqual(ranges[0].length, 19U);
+    XCTAssertEqual(ranges[0].brand, STPCardBrandDiscover);
+    XCTAssertEqualObjects(ranges[1].qRangeLow, @"000001");
+    XCTAssertEqual(ranges[1].brand, STPCardBrandVisa);
+}
+
+- (void)testRejectsCorruptTables {
+    NSMutableData *data = [[STPRemoteBINRanges dataWithRanges:[self testRanges]] mutableCopy];
+    ((uint8_t *)data.mutableBytes)[data.length - 1] ^= 1;
+    XCTAssertNil([STPRemoteBINRanges rangesFromData:data]);
+    XCTAssertNil([STPRemoteBINRanges rangesFromData:[data subdataWithRange:NSMakeRange(0, 40)]]);
+    XCTAssertNil([STPRemoteBINRanges rangesFromData:[NSData data]]);
+}
+
+- (void)testInstallSavedRanges {
+    NSURL *fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+    [[STPRemoteBINRanges dataWithRanges:[self testRanges]] writeToURL:fileURL atomically:YES];
+    STPRemoteBINRanges *remoteRanges = [[STPRemoteBINRanges alloc] initWithURLSession:[NSURLSession sharedSession]
+                                                                             remoteURL:[NSURL URLWithString:@"https://example.com/bins"]
+                                                                               fileURL:fileURL];
+    NSUInteger builtInCount = [STPBINRange allRanges].count;
+    XCTAssertEqual([STPBINRange mostSpecificBINRangeForNumber:@"6205000000000000000"].length, 16U);
+
+    XCTAssertTrue([remoteRanges installSavedRanges]);
+    XCTAssertEqual([STPBINRange allRanges].count, builtInCount + 2);
+    STPBINRange *range = [STPBINRange mostSpecificBINRangeForNumber:@"6205000000000000000"];
+    XCTAssertEqual(range.brand, STPCardBrandDiscover);
+    XCTAssertEqual(range.length, 19U);
+    XCTAssertEqual([STPCardValidator brandForNumber:@"000001"], STPCardBrandVisa);
+
+    [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+}
+
+@end
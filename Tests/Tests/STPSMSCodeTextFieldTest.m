@@ -0,0 +1,69 @@
+//
+//  STPSMSCodeTextFieldTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+#import "STPSMSCodeTextField.h"
+
+@interface STPSMSCodeTextFieldTest : XCTestCase
+@end
+
+@implementation STPSMSCodeTextFieldTest
+
+- (void)testTypingAndDeleting {
+    STPSMSCodeTextField *sut = [STPSMSCodeTextField new];
+    id delegate = OCMProtocolMock(@protocol(STPSMSCodeTextFieldDelegate));
+    sut.delegate = delegate;
+    [[delegate reject] codeTextField:[OCMArg any] didEnterCode:[OCMArg any]];
+
+    XCTAssertFalse(sut.hasText);
+    [sut insertText:@"1"];
+    [sut insertText:@"a"];
+    [sut insertText:@"23"];
+    XCTAssertEqualObjects(sut.code, @"123");
+    [sut deleteBackward];
+    XCTAssertEqualObjects(sut.code, @"12");
+    [sut deleteBackward];
+    [sut deleteBackward];
+    [sut deleteBackward];
+    XCTAssertEqualObjects(sut.code, @"");
+    XCTAssertFalse(sut.hasText);
+    OCMVerifyAll(delegate);
+}
+
+- (void)testCompletingCodeNotifiesDelegate {
+    STPSMSCodeTextField *sut = [STPSMSCodeTextField new];
+    id delegate = OCMProtocolMock(@protocol(STPSMSCodeTextFieldDelegate));
+    sut.delegate = delegate;
+    [sut insertText:@"12345"];
+    [sut insertText:@"678"];
+    XCTAssertEqualObjects(sut.code, @"123456");
+    OCMVerify([delegate codeTextField:sut didEnterCode:@"123456"]);
+}
+
+- (void)testSetCode {
+    STPSMSCodeTextField *sut = [STPSMSCodeTextField new];
+    sut.code = @"1234567";
+    XCTAssertEqualObjects(sut.code, @"123456");
+    sut.code = @"12";
+    XCTAssertEqualObjects(sut.code, @"12");
+    [sut insertText:@"3"];
+    XCTAssertEqualObjects(sut.code, @"123");
+}
+
+- (void)testAccessibility {
+    STPSMSCodeTextField *sut = [STPSMSCodeTextField new];
+    XCTAssertTrue(sut.isAccessibilityElement);
+    XCTAssertEqualObjects(sut.accessibilityLabel, @"Verification Code");
+    XCTAssertEqualObjects(sut.accessibilityValue, @"");
+    XCTAssertEqual(sut.accessibilityTraits & [UITextField new].accessibilityTraits, [UITextField new].accessibilityTraits);
+    [sut insertText:@"12"];
+    XCTAssertEqualObjects(sut.accessibilityValue, @"12");
+}
+
+@end
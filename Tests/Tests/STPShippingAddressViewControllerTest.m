@@ -0,0 +1,61 @@
+//
+//  STPShippingAddressViewControllerTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+#import <Stripe/Stripe.h>
+#import "STPAddressViewModel.h"
+#import "STPFixtures.h"
+
+@interface STPShippingAddressViewController (Testing) <STPAddressViewModelDelegate>
+@property(nonatomic)STPAddressViewModel *addressViewModel;
+- (void)next:(id)sender;
+@end
+
+@interface STPShippingAddressViewControllerTest : XCTestCase
+@end
+
+@implementation STPShippingAddressViewControllerTest
+
+- (void)testNextUsesPrefetchedShippingMethods {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.requiredShippingAddressFields = PKAddressFieldEmail;
+    config.shippingMethodsPrefetchingEnabled = YES;
+    STPAddress *address = [STPAddress new];
+    address.email = @"test@example.com";
+    STPShippingAddressViewController *sut = [[STPShippingAddressViewController alloc] initWithConfiguration:config
+                                                                                                      theme:[STPTheme defaultTheme]
+                                                                                                   currency:nil
+                                                                                            shippingAddress:address
+                                                                                     selectedShippingMethod:nil
+                                                                                       prefilledInformation:nil];
+    XCTAssertNotNil(sut.view);
+    id mockDelegate = OCMProtocolMock(@protocol(STPShippingAddressViewControllerDelegate));
+    sut.delegate = mockDelegate;
+
+    __block NSUInteger enterAddressCount = 0;
+    XCTestExpectation *prefetchExp = [self expectationWithDescription:@"prefetch"];
+    OCMStub([mockDelegate shippingAddressViewController:[OCMArg any] didEnterAddress:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPShippingMethodsCompletionBlock completion;
+        [invocation getArgument:&completion atIndex:4];
+        completion(STPShippingStatusValid, nil, @[], nil);
+        if (++enterAddressCount == 1) {
+            [prefetchExp fulfill];
+        }
+    });
+    [sut addressViewModelDidChange:sut.addressViewModel];
+    [sut addressViewModelDidChange:sut.addressViewModel];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    [sut next:nil];
+    OCMVerify([mockDelegate shippingAddressViewController:sut didFinishWithAddress:[OCMArg any] shippingMethod:nil]);
+    XCTAssertEqual(enterAddressCount, 1U);
+}
+
+@end
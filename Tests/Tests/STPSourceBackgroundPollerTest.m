@@ -0,0 +1,86 @@
+//
+//  STPSourceBackgroundPollerTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+
+#import "STPAPIClient+Private.h"
+#import "STPSource.h"
+#import "STPSourceBackgroundPoller.h"
+#import "STPTestUtils.h"
+
+@interface STPSourceBackgroundPollerTest : XCTestCase
+@property (nonatomic) NSURL *fileURL;
+@end
+
+@implementation STPSourceBackgroundPollerTest
+
+- (void)setUp {
+    [super setUp];
+    NSString *fileName = [NSString stringWithFormat:@"%@.json", [NSUUID UUID].UUIDString];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    [super tearDown];
+}
+
+- (STPSourceBackgroundPoller *)newPoller {
+    NSString *identifier = [@"com.stripe.sourcepolling.test." stringByAppendingString:[NSUUID UUID].UUIDString];
+    return [[STPSourceBackgroundPoller alloc] initWithSessionIdentifier:identifier fileURL:self.fileURL];
+}
+
+- (void)testOnlyHandlesStripeSessions {
+    XCTAssertEqualObjects([STPSourceBackgroundPoller sessionIdentifierForPublishableKey:@"pk_test"], @"com.stripe.sourcepolling.pk_test");
+    XCTAssertFalse([Stripe handleEventsForBackgroundURLSession:@"com.example.downloads" completionHandler:^{}]);
+    XCTAssertFalse([Stripe handleEventsForBackgroundURLSession:@"com.stripe.sourcepolling." completionHandler:^{}]);
+}
+
+- (void)testResultsSurviveRelaunch {
+    // Without a client nothing can be delivered, so the result stays saved.
+    STPSourceBackgroundPoller *poller = [self newPoller];
+    NSDictionary *json = [STPTestUtils jsonNamed:@"iDEALSource"];
+    [poller finishSourceWithId:json[@"id"] JSON:json];
+    XCTAssertEqualObjects(poller.undeliveredSourceIdentifiers, @[json[@"id"]]);
+    XCTAssertEqualObjects(poller.pendingSourceIdentifiers, @[]);
+
+    STPSourceBackgroundPoller *relaunchedPoller = [self newPoller];
+    XCTAssertEqualObjects(relaunchedPoller.undeliveredSourceIdentifiers, @[json[@"id"]]);
+}
+
+- (void)testResultsAreDeliveredToDelegate {
+    STPSourceBackgroundPoller *poller = [self newPoller];
+    NSDictionary *json = [STPTestUtils jsonNamed:@"iDEALSource"];
+    [poller finishSourceWithId:json[@"id"] JSON:json];
+
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test"];
+    id delegate = OCMProtocolMock(@protocol(STPAPIClientBackgroundPollingDelegate));
+    client.backgroundPollingDelegate = delegate;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"delivered"];
+    OCMStub([delegate apiClient:client didFinishPollingSourceInBackground:[OCMArg checkWithBlock:^BOOL(STPSource *source) {
+        return [source.stripeID isEqualToString:json[@"id"]];
+    }]]).andDo(^(__unused NSInvocation *invocation) {
+        [expectation fulfill];
+    });
+    poller.apiClient = client;
+    [poller start];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertEqualObjects(poller.undeliveredSourceIdentifiers, @[]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+}
+
+- (void)testNoDeliveryWithoutDelegate {
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test"];
+    STPSource *source = [STPSource decodedObjectFromAPIResponse:[STPTestUtils jsonNamed:@"iDEALSource"]];
+    XCTAssertNil(client.sourceBackgroundPoller);
+    XCTAssertFalse([client startBackgroundPollingSourceWithId:source.stripeID clientSecret:@"secret" deadline:[NSDate date]]);
+    XCTAssertFalse([client deliverBackgroundPolledSource:source]);
+}
+
+@end
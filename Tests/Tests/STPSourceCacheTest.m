@@ -0,0 +1,63 @@
+//
+//  STPSourceCacheTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPSource.h"
+#import "STPSourceCache.h"
+#import "STPTestUtils.h"
+
+@interface STPSourceCacheTest : XCTestCase
+@end
+
+@implementation STPSourceCacheTest
+
+- (STPSource *)sourceWithId:(NSString *)identifier {
+    NSMutableDictionary *json = [[STPTestUtils jsonNamed:@"3DSSource"] mutableCopy];
+    json[@"id"] = identifier;
+    json[@"client_secret"] = @"secret";
+    return [STPSource decodedObjectFromAPIResponse:json];
+}
+
+- (void)testDropsLeastRecentlyUsed {
+    STPSourceCache *cache = [[STPSourceCache alloc] initWithCapacity:2 timeToLive:60];
+    [cache addSource:[self sourceWithId:@"src_1"]];
+    [cache addSource:[self sourceWithId:@"src_2"]];
+    XCTAssertNotNil([cache sourceWithId:@"src_1" clientSecret:@"secret"]);
+
+    [cache addSource:[self sourceWithId:@"src_3"]];
+    XCTAssertNotNil([cache sourceWithId:@"src_1" clientSecret:@"secret"]);
+    XCTAssertNil([cache sourceWithId:@"src_2" clientSecret:@"secret"]);
+    XCTAssertNotNil([cache sourceWithId:@"src_3" clientSecret:@"secret"]);
+}
+
+- (void)testReplacesOlderCopy {
+    STPSourceCache *cache = [[STPSourceCache alloc] initWithCapacity:2 timeToLive:60];
+    [cache addSource:[self sourceWithId:@"src_1"]];
+    STPSource *newer = [self sourceWithId:@"src_1"];
+    [cache addSource:newer];
+    XCTAssertEqual([cache sourceWithId:@"src_1" clientSecret:@"secret"], newer);
+}
+
+- (void)testExpires {
+    STPSourceCache *cache = [[STPSourceCache alloc] initWithCapacity:2 timeToLive:0];
+    [cache addSource:[self sourceWithId:@"src_1"]];
+    XCTAssertNil([cache sourceWithId:@"src_1" clientSecret:@"secret"]);
+}
+
+- (void)testRequiresClientSecret {
+    STPSourceCache *cache = [[STPSourceCache alloc] initWithCapacity:2 timeToLive:60];
+    [cache addSource:[self sourceWithId:@"src_1"]];
+    XCTAssertNil([cache sourceWithId:@"src_1" clientSecret:@"other_secret"]);
+    XCTAssertNotNil([cache sourceWithId:@"src_1" clientSecret:@"secret"]);
+
+    [cache removeAllSources];
+    XCTAssertNil([cache sourceWithId:@"src_1" clientSecret:@"secret"]);
+}
+
+@end
@@ -0,0 +1,76 @@
+//
+//  STPSourceCreationQueueTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPSourceCreationQueue.h"
+
+@interface STPSourceCreationQueue (Testing)
++ (NSTimeInterval)retryDelayAfterNetworkErrors:(NSUInteger)errorCount;
+@end
+
+@interface STPSourceCreationQueueTest : XCTestCase
+@property (nonatomic) NSURL *fileURL;
+@end
+
+@implementation STPSourceCreationQueueTest
+
+- (void)setUp {
+    [super setUp];
+    NSString *fileName = [NSString stringWithFormat:@"%@.json", [NSUUID UUID].UUIDString];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    [super tearDown];
+}
+
+- (void)testQueuedRequestsSurviveRelaunch {
+    // Without a client nothing is sent, so everything stays queued.
+    STPSourceCreationQueue *queue = [[STPSourceCreationQueue alloc] initWithAPIClient:nil
+                                                                             endpoint:@"sources"
+                                                                              fileURL:self.fileURL];
+    NSString *first = [queue enqueueFormData:[@"type=sepa_debit" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSString *second = [queue enqueueFormData:[@"type=sofort" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertNotEqualObjects(first, second);
+    NSArray *expected = @[first, second];
+    XCTAssertEqualObjects(queue.pendingIdentifiers, expected);
+
+    STPSourceCreationQueue *relaunchedQueue = [[STPSourceCreationQueue alloc] initWithAPIClient:nil
+                                                                                       endpoint:@"sources"
+                                                                                        fileURL:self.fileURL];
+    [relaunchedQueue start];
+    XCTAssertEqualObjects(relaunchedQueue.pendingIdentifiers, expected);
+}
+
+- (void)testNetworkFailuresKeepRequestsQueued {
+    NSError *offline = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    NSError *lost = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNetworkConnectionLost userInfo:nil];
+    NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    XCTAssertTrue([STPSourceCreationQueue shouldKeepRequestWithResponse:nil error:offline]);
+    XCTAssertTrue([STPSourceCreationQueue shouldKeepRequestWithResponse:nil error:lost]);
+    XCTAssertFalse([STPSourceCreationQueue shouldKeepRequestWithResponse:nil error:cancelled]);
+}
+
+- (void)testNetworkErrorRetriesBackOff {
+    XCTAssertEqualWithAccuracy([STPSourceCreationQueue retryDelayAfterNetworkErrors:1], 2, 0.0001);
+    XCTAssertEqualWithAccuracy([STPSourceCreationQueue retryDelayAfterNetworkErrors:2], 4, 0.0001);
+    XCTAssertEqualWithAccuracy([STPSourceCreationQueue retryDelayAfterNetworkErrors:10], 30, 0.0001);
+}
+
+- (void)testOnlyServerErrorsKeepAnsweredRequestsQueued {
+    NSURL *url = [NSURL URLWithString:@"https://api.stripe.com/v1/sources"];
+    NSError *error = [NSError errorWithDomain:@"com.stripe.lib" code:50 userInfo:nil];
+    NSHTTPURLResponse *serverError = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:503 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    NSHTTPURLResponse *badRequest = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:400 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    XCTAssertTrue([STPSourceCreationQueue shouldKeepRequestWithResponse:serverError error:error]);
+    XCTAssertFalse([STPSourceCreationQueue shouldKeepRequestWithResponse:badRequest error:error]);
+}
+
+@end
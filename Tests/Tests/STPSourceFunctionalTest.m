@@ -264,6 +264,32 @@ static NSString *const apiKey = @"pk_test_vOo1umqsYxSrP5UXfOeL3ecm";
     [self waitForExpectationsWithTimeout:5.0f handler:nil];
 }
 
+- (void)testCreateThreeDSecureSourceWithCard {
+    STPCardParams *card = [[STPCardParams alloc] init];
+    card.number = @"4000000000003063";
+    card.expMonth = 6;
+    card.expYear = 2018;
+    card.currency = @"usd";
+
+    STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:apiKey];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Card and 3DS Source creation"];
+    [client createThreeDSecureSourceWithCard:card
+                                      amount:1099
+                                    currency:@"eur"
+                                   returnURL:@"https://shop.example.com/crtABC"
+                                  completion:^(STPSource *cardSource, STPSource *threeDSecureSource, NSTimeInterval cardSourceDuration, NSTimeInterval threeDSecureSourceDuration, NSError *error) {
+                                      XCTAssertTrue([NSThread isMainThread]);
+                                      XCTAssertNil(error);
+                                      XCTAssertEqual(cardSource.type, STPSourceTypeCard);
+                                      XCTAssertEqual(threeDSecureSource.type, STPSourceTypeThreeDSecure);
+                                      XCTAssertEqual(threeDSecureSource.redirect.status, STPSourceRedirectStatusPending);
+                                      XCTAssertGreaterThan(cardSourceDuration, 0);
+                                      XCTAssertGreaterThan(threeDSecureSourceDuration, 0);
+                                      [expectation fulfill];
+                                  }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
 - (void)testRetrieveSource_sofort {
     STPAPIClient *client = [[STPAPIClient alloc] initWithPublishableKey:@"pk_test_vOo1umqsYxSrP5UXfOeL3ecm"];
     STPSourceParams *params = [STPSourceParams new];
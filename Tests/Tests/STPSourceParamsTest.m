@@ -83,4 +83,51 @@
 
 }
 
+- (void)testFormParametersAreReusedUntilChanged {
+    STPCardParams *card = [STPCardParams new];
+    card.number = @"4242424242424242";
+    card.expMonth = 6;
+    card.expYear = 2024;
+    STPSourceParams *sourceParams = [STPSourceParams cardParamsWithCard:card];
+
+    NSDictionary *parameters = [sourceParams formParameters];
+    XCTAssertEqualObjects(parameters, [STPFormEncoder dictionaryForObject:sourceParams]);
+    XCTAssertEqual([sourceParams formParameters], parameters);
+
+    // Copies keep every field, and share the encoding
+    STPSourceParams *copy = [sourceParams copy];
+    XCTAssertEqualObjects(copy.additionalAPIParameters, sourceParams.additionalAPIParameters);
+    XCTAssertEqual([copy formParameters], parameters);
+
+    sourceParams.redirectMerchantName = @"bar";
+    sourceParams.redirectMerchantName = @"bar";
+    NSDictionary *named = [sourceParams formParameters];
+    sourceParams.redirectMerchantName = @"bar";
+    XCTAssertEqual([sourceParams formParameters], named);
+
+    sourceParams.metadata = @{@"order": @"1"};
+    XCTAssertEqualObjects([sourceParams formParameters][@"metadata"], @{@"order": @"1"});
+    XCTAssertNil([copy formParameters][@"metadata"]);
+}
+
+- (void)testRedirectMerchantNameURLIsReused {
+    STPSourceParams *sourceParams = [STPSourceParams sofortParamsWithAmount:1000
+                                                                  returnURL:@"test://reused?value=baz"
+                                                                    country:@"DE"
+                                                        statementDescriptor:nil];
+    sourceParams.redirectMerchantName = @"bar";
+    NSString *first = [STPFormEncoder dictionaryForObject:sourceParams][@"redirect"][@"return_url"];
+    STPSourceParams *secondParams = [sourceParams copy];
+    secondParams.redirectMerchantName = @"bar";
+    NSString *second = [STPFormEncoder dictionaryForObject:secondParams][@"redirect"][@"return_url"];
+    XCTAssertEqualObjects(first, @"test://reused?value=baz&redirect_merchant_name=bar");
+    XCTAssertEqualObjects(second, first);
+
+    sourceParams.redirectMerchantName = @"Other Name";
+    NSString *renamed = [STPFormEncoder dictionaryForObject:sourceParams][@"redirect"][@"return_url"];
+    XCTAssertEqualObjects([self redirectMerchantNameQueryItemValueFromURLString:renamed], @"Other Name");
+    // The redirect as set is left alone
+    XCTAssertEqualObjects(sourceParams.redirect[@"return_url"], @"test://reused?value=baz");
+}
+
 @end
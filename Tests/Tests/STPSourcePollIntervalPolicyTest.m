@@ -0,0 +1,60 @@
+//
+//  STPSourcePollIntervalPolicyTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPSource.h"
+#import "STPSourcePollIntervalPolicy.h"
+
+@interface STPSourcePollIntervalPolicyTest : XCTestCase
+
+@end
+
+@implementation STPSourcePollIntervalPolicyTest
+
+- (STPSource *)sourceWithFlow:(NSString *)flow {
+    return [STPSource decodedObjectFromAPIResponse:@{
+                                                     @"id": @"src_123",
+                                                     @"livemode": @NO,
+                                                     @"status": @"pending",
+                                                     @"type": @"bitcoin",
+                                                     @"flow": flow,
+                                                     }];
+}
+
+- (void)testDefaultPolicy {
+    STPSourcePollDefaultIntervalPolicy *policy = [STPSourcePollDefaultIntervalPolicy new];
+    STPSource *redirectSource = [self sourceWithFlow:@"redirect"];
+    STPSource *receiverSource = [self sourceWithFlow:@"receiver"];
+
+    NSTimeInterval defaultInterval = [policy pollIntervalForSource:redirectSource
+                                                     redirectState:STPRedirectContextStateNotStarted
+                                             redirectCompletedDate:nil];
+    NSTimeInterval inProgressInterval = [policy pollIntervalForSource:redirectSource
+                                                        redirectState:STPRedirectContextStateInProgress
+                                                redirectCompletedDate:nil];
+    NSTimeInterval returnedInterval = [policy pollIntervalForSource:redirectSource
+                                                      redirectState:STPRedirectContextStateCompleted
+                                              redirectCompletedDate:[NSDate date]];
+    NSTimeInterval longReturnedInterval = [policy pollIntervalForSource:redirectSource
+                                                          redirectState:STPRedirectContextStateCompleted
+                                                  redirectCompletedDate:[NSDate dateWithTimeIntervalSinceNow:-60]];
+    NSTimeInterval receiverInterval = [policy pollIntervalForSource:receiverSource
+                                                      redirectState:STPRedirectContextStateNotStarted
+                                              redirectCompletedDate:nil];
+
+    XCTAssertGreaterThan(inProgressInterval, defaultInterval);
+    XCTAssertLessThan(returnedInterval, defaultInterval);
+    XCTAssertEqual(longReturnedInterval, defaultInterval);
+    XCTAssertGreaterThan(receiverInterval, defaultInterval);
+    XCTAssertEqual([policy pollIntervalForSource:nil
+                                   redirectState:STPRedirectContextStateNotStarted
+                           redirectCompletedDate:nil], defaultInterval);
+}
+
+@end
@@ -0,0 +1,81 @@
+//
+//  STPSourcePollerStateStoreTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPSource.h"
+#import "STPSourcePollerStateStore.h"
+#import "STPTestUtils.h"
+
+@interface STPSourcePollerStateStoreTest : XCTestCase
+@property (nonatomic) NSURL *fileURL;
+@end
+
+@implementation STPSourcePollerStateStoreTest
+
+- (void)setUp {
+    [super setUp];
+    NSString *fileName = [NSString stringWithFormat:@"%@.json", [NSUUID UUID].UUIDString];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    [super tearDown];
+}
+
+- (STPSourcePollerState *)stateWithStartTime:(NSDate *)startTime {
+    STPSourcePollerState *state = [STPSourcePollerState new];
+    state.latestSource = [STPSource decodedObjectFromAPIResponse:[STPTestUtils jsonNamed:@"iDEALSource"]];
+    state.startTime = startTime;
+    state.pollInterval = 3;
+    state.retryCount = 2;
+    state.redirectState = STPRedirectContextStateCompleted;
+    state.redirectCompletedDate = [startTime dateByAddingTimeInterval:10];
+    return state;
+}
+
+- (void)testStatesSurviveRelaunch {
+    STPSourcePollerStateStore *store = [[STPSourcePollerStateStore alloc] initWithFileURL:self.fileURL];
+    NSDate *startTime = [NSDate dateWithTimeIntervalSinceNow:-30];
+    [store saveState:[self stateWithStartTime:startTime] forSourceWithId:@"src_1"];
+    // Reading waits for the save to be written
+    XCTAssertNotNil([store stateForSourceWithId:@"src_1"]);
+
+    STPSourcePollerStateStore *relaunchedStore = [[STPSourcePollerStateStore alloc] initWithFileURL:self.fileURL];
+    STPSourcePollerState *state = [relaunchedStore stateForSourceWithId:@"src_1"];
+    XCTAssertEqualObjects(state.latestSource.stripeID, [STPTestUtils jsonNamed:@"iDEALSource"][@"id"]);
+    XCTAssertEqualWithAccuracy([state.startTime timeIntervalSinceDate:startTime], 0, 0.001);
+    XCTAssertEqualWithAccuracy(state.pollInterval, 3, 0.001);
+    XCTAssertEqual(state.retryCount, 2);
+    XCTAssertEqual(state.redirectState, STPRedirectContextStateCompleted);
+    XCTAssertEqualWithAccuracy([state.redirectCompletedDate timeIntervalSinceDate:startTime], 10, 0.001);
+    XCTAssertFalse(state.finished);
+    XCTAssertNil([relaunchedStore stateForSourceWithId:@"src_2"]);
+}
+
+- (void)testRemovingLastStateDeletesFile {
+    STPSourcePollerStateStore *store = [[STPSourcePollerStateStore alloc] initWithFileURL:self.fileURL];
+    [store saveState:[self stateWithStartTime:[NSDate date]] forSourceWithId:@"src_1"];
+    [store removeStateForSourceWithId:@"src_1"];
+    XCTAssertNil([store stateForSourceWithId:@"src_1"]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+}
+
+- (void)testOldStatesAreDropped {
+    STPSourcePollerStateStore *store = [[STPSourcePollerStateStore alloc] initWithFileURL:self.fileURL];
+    [store saveState:[self stateWithStartTime:[NSDate dateWithTimeIntervalSinceNow:-60*60*25]] forSourceWithId:@"src_old"];
+    [store saveState:[self stateWithStartTime:[NSDate date]] forSourceWithId:@"src_new"];
+    XCTAssertNotNil([store stateForSourceWithId:@"src_old"]);
+
+    STPSourcePollerStateStore *relaunchedStore = [[STPSourcePollerStateStore alloc] initWithFileURL:self.fileURL];
+    XCTAssertNil([relaunchedStore stateForSourceWithId:@"src_old"]);
+    XCTAssertNotNil([relaunchedStore stateForSourceWithId:@"src_new"]);
+}
+
+@end
@@ -8,6 +8,7 @@
 
 @import XCTest;
 
+#import "STPSource+Private.h"
 #import "Stripe.h"
 
 @interface STPSourceTest : XCTestCase
@@ -135,4 +136,31 @@
     XCTAssertEqualObjects(source.details, response[@"sepa_debit"]);
 }
 
+- (void)testUpdatingSourceSharesUnchangedFields {
+    NSDictionary *response = [self buildTestResponse_sepa_debit];
+    STPSource *source = [STPSource decodedObjectFromAPIResponse:response];
+    XCTAssertEqual([source updatedObjectFromAPIResponse:[response copy]], source);
+
+    NSMutableDictionary *changed = [response mutableCopy];
+    changed[@"status"] = @"consumed";
+    STPSource *updated = [source updatedObjectFromAPIResponse:changed];
+    XCTAssertNotEqual(updated, source);
+    XCTAssertEqual(updated.status, STPSourceStatusConsumed);
+    XCTAssertEqual(updated.owner, source.owner);
+    XCTAssertEqual(updated.sepaDebitDetails, source.sepaDebitDetails);
+    XCTAssertFalse([updated hasSameFieldsAsSource:source]);
+    XCTAssertTrue([updated hasSameFieldsAsSource:[STPSource decodedObjectFromAPIResponse:changed]]);
+
+    changed[@"owner"] = @{@"name": @"Jenny Rosen"};
+    STPSource *renamed = [updated updatedObjectFromAPIResponse:changed];
+    XCTAssertNotEqual(renamed.owner, updated.owner);
+    XCTAssertEqualObjects(renamed.owner.name, @"Jenny Rosen");
+    XCTAssertNil(renamed.owner.address.city);
+
+    NSMutableDictionary *other = [response mutableCopy];
+    other[@"id"] = @"src_456";
+    STPSource *otherSource = [source updatedObjectFromAPIResponse:other];
+    XCTAssertNotEqual(otherSource.owner, source.owner);
+}
+
 @end
@@ -77,5 +77,18 @@
                                }];
 }
 
+- (void)testTaggedStringTemplate {
+    NSSet *tags = [NSSet setWithArray:@[@"a", @"b", @"c"]];
+    STPTaggedStringTemplate *template = [STPTaggedStringTemplate templateWithString:@"<a>Test</a> <b>string</b>" tags:tags];
+    XCTAssertEqualObjects(template.string, @"Test string");
+    XCTAssertTrue(NSEqualRanges([template rangeForTag:@"a"], NSMakeRange(0, 4)));
+    XCTAssertTrue(NSEqualRanges([template rangeForTag:@"b"], NSMakeRange(5, 6)));
+    XCTAssertEqual([template rangeForTag:@"c"].location, (NSUInteger)NSNotFound);
+    XCTAssertEqual([template rangeForTag:@"d"].location, (NSUInteger)NSNotFound);
+
+    STPTaggedStringTemplate *otherTemplate = [STPTaggedStringTemplate templateWithString:@"<a>Test</a> <b>string</b>" tags:tags];
+    XCTAssertEqual(template, otherTemplate);
+}
+
 
 @end
@@ -10,6 +10,11 @@
 
 @interface STPTestUtils : NSObject
 
+/**
+ The parsed contents of the test bundle's `name`.json. Each file is read and
+ parsed once; later calls return the same immutable dictionary, so use
+ `mutableCopy` to build variations of it.
+ */
 + (NSDictionary *)jsonNamed:(NSString *)name;
 
 @end
@@ -14,12 +14,41 @@
     return [NSBundle bundleForClass:[STPTestUtils class]];
 }
 
++ (dispatch_queue_t)jsonCacheQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.stripe.testutils.json", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// Only touched on +jsonCacheQueue
++ (NSMutableDictionary<NSString *, NSDictionary *> *)jsonCache {
+    static NSMutableDictionary *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [NSMutableDictionary dictionary];
+    });
+    return cache;
+}
+
 + (NSDictionary *)jsonNamed:(NSString *)name {
-    NSData *data = [self dataFromJSONFile:name];
-    if (data != nil) {
-        return [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:nil];
-    }
-    return nil;
+    __block NSDictionary *json;
+    dispatch_sync([self jsonCacheQueue], ^{
+        json = [self jsonCache][name];
+        if (json) {
+            return;
+        }
+        NSData *data = [self dataFromJSONFile:name];
+        if (data != nil) {
+            // Without mutable options, every container in it is immutable,
+            // so it can be handed out again.
+            json = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)kNilOptions error:nil];
+            [self jsonCache][name] = json;
+        }
+    });
+    return json;
 }
 
 + (NSData *)dataFromJSONFile:(NSString *)name {
@@ -0,0 +1,115 @@
+//
+//  STPThemeTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <OCMock/OCMock.h>
+#import <XCTest/XCTest.h>
+
+#import "STPTheme+Private.h"
+
+@interface STPThemeTest : XCTestCase
+@end
+
+@implementation STPThemeTest
+
+- (void)testDerivedColorsAreCachedUntilChanged {
+    STPTheme *theme = [STPTheme new];
+    UIColor *tertiary = theme.tertiaryBackgroundColor;
+    XCTAssertEqual(theme.tertiaryBackgroundColor, tertiary);
+
+    theme.primaryBackgroundColor = [UIColor blackColor];
+    XCTAssertNotEqualObjects(theme.tertiaryBackgroundColor, tertiary);
+}
+
+- (void)testDerivedFontsFollowFont {
+    STPTheme *theme = [STPTheme new];
+    theme.font = [UIFont systemFontOfSize:20];
+    XCTAssertEqualWithAccuracy(theme.smallFont.pointSize, 18, 0.01);
+    XCTAssertEqualWithAccuracy(theme.largeFont.pointSize, 35, 0.01);
+
+    theme.font = [UIFont systemFontOfSize:10];
+    XCTAssertEqualWithAccuracy(theme.smallFont.pointSize, 8, 0.01);
+}
+
+- (void)testFontsFollowContentSizeCategory {
+    STPTheme *theme = [STPTheme new];
+    theme.font = [UIFont systemFontOfSize:20];
+    UIFont *font = theme.font;
+    XCTAssertEqual(theme.font, font);
+
+    id mockDescriptor = OCMClassMock([UIFontDescriptor class]);
+    OCMStub(ClassMethod([mockDescriptor preferredFontDescriptorWithTextStyle:UIFontTextStyleBody])).andReturn([UIFontDescriptor fontDescriptorWithName:@"Helvetica" size:34]);
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIContentSizeCategoryDidChangeNotification object:nil];
+    XCTAssertEqual(theme.font, font);
+
+    theme.adjustsFontsForContentSizeCategory = YES;
+    NSUInteger token = theme.changeToken;
+    XCTAssertEqualWithAccuracy(theme.font.pointSize, 40, 0.01);
+    XCTAssertEqualWithAccuracy(theme.smallFont.pointSize, 36, 0.01);
+    XCTAssertEqual(theme.font, theme.font);
+    XCTAssertEqual(theme.changeToken, token);
+    STPTheme *copyTheme = [theme copy];
+    XCTAssertEqualWithAccuracy(copyTheme.font.pointSize, 40, 0.01);
+
+    [mockDescriptor stopMocking];
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIContentSizeCategoryDidChangeNotification object:nil];
+    CGFloat pointSize = theme.font.pointSize;
+    XCTAssertNotEqual(theme.changeToken, token);
+    XCTAssertEqualWithAccuracy(pointSize, 20 * [UIFontDescriptor preferredFontDescriptorWithTextStyle:UIFontTextStyleBody].pointSize / 17, 0.01);
+}
+
+- (void)testChangeTokenFollowsContentSizeCategory {
+    STPTheme *theme = [STPTheme new];
+    theme.adjustsFontsForContentSizeCategory = YES;
+    NSUInteger token = theme.changeToken;
+
+    id mockDescriptor = OCMClassMock([UIFontDescriptor class]);
+    OCMStub(ClassMethod([mockDescriptor preferredFontDescriptorWithTextStyle:UIFontTextStyleBody])).andReturn([UIFontDescriptor fontDescriptorWithName:@"Helvetica" size:34]);
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIContentSizeCategoryDidChangeNotification object:nil];
+    XCTAssertNotEqual(theme.changeToken, token);
+    token = theme.changeToken;
+    XCTAssertEqual(theme.changeToken, token);
+
+    [mockDescriptor stopMocking];
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIContentSizeCategoryDidChangeNotification object:nil];
+    XCTAssertNotEqual(theme.changeToken, token);
+}
+
+- (void)testBarStyleFollowsSecondaryBackgroundColor {
+    STPTheme *theme = [STPTheme new];
+    XCTAssertEqual(theme.barStyle, UIBarStyleDefault);
+    theme.secondaryBackgroundColor = [UIColor blackColor];
+    XCTAssertEqual(theme.barStyle, UIBarStyleBlack);
+    theme.barStyle = UIBarStyleDefault;
+    XCTAssertEqual(theme.barStyle, UIBarStyleDefault);
+}
+
+- (void)testChangeToken {
+    STPTheme *theme = [STPTheme new];
+    STPTheme *otherTheme = [STPTheme new];
+    NSUInteger token = theme.changeToken;
+    XCTAssertNotEqual(token, otherTheme.changeToken);
+
+    (void)theme.tertiaryForegroundColor;
+    XCTAssertEqual(theme.changeToken, token);
+
+    theme.accentColor = [UIColor redColor];
+    XCTAssertNotEqual(theme.changeToken, token);
+}
+
+- (void)testChangesFromTheme {
+    STPTheme *theme = [STPTheme new];
+    XCTAssertEqual([theme changesFromTheme:nil], STPThemeChangeAll);
+    XCTAssertEqual([theme changesFromTheme:[theme copy]], STPThemeChangeNone);
+
+    STPTheme *otherTheme = [theme copy];
+    otherTheme.primaryForegroundColor = [UIColor redColor];
+    otherTheme.font = [UIFont systemFontOfSize:30];
+    XCTAssertEqual([otherTheme changesFromTheme:theme], STPThemeChangePrimaryForegroundColor | STPThemeChangeFont);
+}
+
+@end
@@ -0,0 +1,148 @@
+//
+//  STPThreeDSecureFlowTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@import XCTest;
+
+#import "STPFixtures.h"
+#import "STPTestUtils.h"
+
+@interface STPThreeDSecureFlowTest : XCTestCase
+@property (nonatomic) id mockAPIClient;
+@property (nonatomic) STPThreeDSecureFlow *flow;
+@end
+
+@implementation STPThreeDSecureFlowTest
+
+- (void)setUp {
+    [super setUp];
+    self.mockAPIClient = OCMClassMock([STPAPIClient class]);
+    self.flow = [[STPThreeDSecureFlow alloc] initWithAPIClient:self.mockAPIClient
+                                                        amount:1099
+                                                      currency:@"usd"
+                                                     returnURL:@"test://redirect"
+                                            redirectCompletion:^(__unused NSString *sourceID, __unused NSString *clientSecret, __unused NSError *error) {}];
+    self.flow.preparesSafariViewController = NO;
+}
+
+- (STPSource *)cardSourceWithThreeDSecure:(NSString *)threeDSecure {
+    NSMutableDictionary *json = [[STPTestUtils jsonNamed:@"CardSource"] mutableCopy];
+    NSMutableDictionary *card = [json[@"card"] mutableCopy];
+    card[@"three_d_secure"] = threeDSecure;
+    json[@"card"] = card;
+    return [STPSource decodedObjectFromAPIResponse:json];
+}
+
+/**
+ Answers card source requests with `cardSource` and 3D Secure source requests
+ with a redirect source, and returns the params of every request.
+ */
+- (NSMutableArray<STPSourceParams *> *)stubSourcesWithCardSource:(STPSource *)cardSource {
+    NSMutableArray<STPSourceParams *> *requests = [NSMutableArray array];
+    STPSource *threeDSecureSource = [STPSource decodedObjectFromAPIResponse:[STPTestUtils jsonNamed:@"3DSSource"]];
+    OCMStub([self.mockAPIClient createSourceWithParams:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPSourceParams *params;
+        STPSourceCompletionBlock completion;
+        [invocation getArgument:&params atIndex:2];
+        [invocation getArgument:&completion atIndex:3];
+        [requests addObject:params];
+        completion(params.type == STPSourceTypeCard ? cardSource : threeDSecureSource, nil);
+    });
+    return requests;
+}
+
+- (void)testCreatesSourcesBeforeFinishing {
+    NSMutableArray<STPSourceParams *> *requests = [self stubSourcesWithCardSource:[self cardSourceWithThreeDSecure:@"required"]];
+
+    [self.flow updateCardParams:[STPFixtures cardParams]];
+    XCTAssertEqual(requests.count, (NSUInteger)2);
+    XCTAssertEqual(requests[0].type, STPSourceTypeCard);
+    XCTAssertEqual(requests[1].type, STPSourceTypeThreeDSecure);
+    XCTAssertEqualObjects(requests[1].amount, @1099);
+    XCTAssertEqual(self.flow.threeDSecureStatus, STPSourceCard3DSecureStatusRequired);
+    XCTAssertNotNil(self.flow.redirectContext);
+
+    __block BOOL finished = NO;
+    [self.flow finishWithCardParams:[STPFixtures cardParams] completion:^(STPSource *cardSource, STPRedirectContext *redirectContext, NSError *error) {
+        XCTAssertEqualObjects(cardSource.stripeID, @"src_123");
+        XCTAssertEqual(redirectContext, self.flow.redirectContext);
+        XCTAssertNil(error);
+        finished = YES;
+    }];
+    XCTAssertTrue(finished);
+    XCTAssertEqual(requests.count, (NSUInteger)2);
+}
+
+- (void)testSkipsThreeDSecureWhenNotNeeded {
+    NSMutableArray<STPSourceParams *> *requests = [self stubSourcesWithCardSource:[self cardSourceWithThreeDSecure:@"optional"]];
+
+    [self.flow updateCardParams:[STPFixtures cardParams]];
+    XCTAssertEqual(requests.count, (NSUInteger)1);
+    XCTAssertEqual(self.flow.threeDSecureStatus, STPSourceCard3DSecureStatusOptional);
+    XCTAssertNil(self.flow.redirectContext);
+
+    __block BOOL finished = NO;
+    [self.flow finishWithCardParams:[STPFixtures cardParams] completion:^(STPSource *cardSource, STPRedirectContext *redirectContext, NSError *error) {
+        XCTAssertNotNil(cardSource);
+        XCTAssertNil(redirectContext);
+        XCTAssertNil(error);
+        finished = YES;
+    }];
+    XCTAssertTrue(finished);
+}
+
+- (void)testOnlyCardChangesStartOver {
+    NSMutableArray<STPSourceParams *> *requests = [self stubSourcesWithCardSource:[self cardSourceWithThreeDSecure:@"not_supported"]];
+
+    STPCardParams *incomplete = [STPFixtures cardParams];
+    incomplete.cvc = nil;
+    [self.flow updateCardParams:incomplete];
+    XCTAssertEqual(requests.count, (NSUInteger)0);
+
+    STPCardParams *cardParams = [STPFixtures cardParams];
+    [self.flow updateCardParams:cardParams];
+    XCTAssertEqual(requests.count, (NSUInteger)1);
+    XCTAssertEqual([requests[0].owner[@"address"] count], (NSUInteger)0);
+
+    cardParams.addressLine1 = @"123 Main St";
+    cardParams.addressZip = @"94107";
+    [self.flow updateCardParams:cardParams];
+    XCTAssertEqual(requests.count, (NSUInteger)1);
+
+    cardParams.number = @"5555555555554444";
+    [self.flow updateCardParams:cardParams];
+    XCTAssertEqual(requests.count, (NSUInteger)2);
+    XCTAssertEqualObjects(requests[1].additionalAPIParameters[@"card"][@"number"], @"5555555555554444");
+}
+
+- (void)testFinishWaitsForPendingRequest {
+    id mockTask = OCMClassMock([NSURLSessionDataTask class]);
+    __block STPSourceCompletionBlock pendingCompletion;
+    OCMStub([self.mockAPIClient createSourceWithParams:[OCMArg any] completion:[OCMArg any]])
+    .andDo(^(NSInvocation *invocation){
+        STPSourceCompletionBlock completion;
+        [invocation getArgument:&completion atIndex:3];
+        pendingCompletion = [completion copy];
+    })
+    .andReturn(mockTask);
+
+    [self.flow updateCardParams:[STPFixtures cardParams]];
+    __block BOOL finished = NO;
+    [self.flow finishWithCardParams:[STPFixtures cardParams] completion:^(STPSource *cardSource, __unused STPRedirectContext *redirectContext, NSError *error) {
+        XCTAssertNil(cardSource);
+        XCTAssertNotNil(error);
+        finished = YES;
+    }];
+    XCTAssertFalse(finished);
+
+    pendingCompletion(nil, [NSError errorWithDomain:StripeDomain code:STPAPIError userInfo:nil]);
+    XCTAssertTrue(finished);
+    XCTAssertNil(self.flow.cardSource);
+}
+
+@end
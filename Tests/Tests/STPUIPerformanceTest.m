@@ -0,0 +1,228 @@
+//
+//  STPUIPerformanceTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <QuartzCore/QuartzCore.h>
+
+#import "STPAddressViewModel.h"
+#import "STPCardTuple.h"
+#import "STPCoreTableViewController+Private.h"
+#import "STPFixtures.h"
+#import "STPFormTextField.h"
+#import "STPPaymentMethodTuple.h"
+#import "STPPaymentMethodsInternalViewController.h"
+#import "STPSignpost.h"
+#import "STPTestUtils.h"
+
+// Work that takes longer than one 60Hz frame counts towards the hitch ratio.
+static CFTimeInterval const STPFrameBudget = 1.0 / 60.0;
+static NSUInteger const STPScrolledCardCount = 50;
+
+@interface STPPaymentCardTextField (UIPerformance)
+@property(nonatomic, readwrite, weak)STPFormTextField *numberField;
+@end
+
+@interface STPShippingAddressViewController (UIPerformance)
+@property(nonatomic) STPAddressViewModel *addressViewModel;
+@end
+
+/**
+ Frame time for the SDK's heaviest UI interactions. Each test runs the
+ interaction as a series of frames, logs a hitch ratio (ms of overrun per
+ second), and records clock, CPU and memory metrics, plus the duration of each
+ "UI frame" signpost when built against the iOS 13 SDK. Set baselines for them
+ in Xcode's test navigator on a reference device.
+ */
+@interface STPUIPerformanceTest : XCTestCase
+
+@property (nonatomic) UIWindow *window;
+@property (nonatomic) CFTimeInterval frameTime;
+@property (nonatomic) CFTimeInterval hitchTime;
+
+@end
+
+@implementation STPUIPerformanceTest
+
+- (void)setUp {
+    [super setUp];
+    self.window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 375, 667)];
+    self.window.hidden = NO;
+}
+
+- (void)tearDown {
+    self.window.hidden = YES;
+    self.window = nil;
+    [super tearDown];
+}
+
+/**
+ Runs `step` as one frame's worth of work, committing any pending layer
+ changes the way the run loop would at the end of a frame.
+ */
+- (void)performFrame:(dispatch_block_t)step {
+    STPSignpostIntervalBegin("UI frame", self);
+    CFTimeInterval start = CACurrentMediaTime();
+    step();
+    [CATransaction flush];
+    CFTimeInterval duration = CACurrentMediaTime() - start;
+    STPSignpostIntervalEnd("UI frame", self);
+    self.frameTime += duration;
+    self.hitchTime += MAX(duration - STPFrameBudget, 0);
+}
+
+- (void)measureFrames:(dispatch_block_t)block {
+    self.frameTime = 0;
+    self.hitchTime = 0;
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000
+    if (@available(iOS 13.0, *)) {
+        NSArray<id<XCTMetric>> *metrics = @[
+                                            [XCTClockMetric new],
+                                            [XCTCPUMetric new],
+                                            [XCTMemoryMetric new],
+                                            [[XCTOSSignpostMetric alloc] initWithSubsystem:@"com.stripe.sdk"
+                                                                                  category:@"PointsOfInterest"
+                                                                                      name:@"UI frame"],
+                                            ];
+        [self measureWithMetrics:metrics block:block];
+    } else {
+        [self measureBlock:block];
+    }
+#else
+    [self measureBlock:block];
+#endif
+    if (self.frameTime > 0) {
+        NSLog(@"%@ hitch ratio: %.1f ms/s", self.name, (self.hitchTime * 1000) / self.frameTime);
+    }
+}
+
+#pragma mark - Card entry
+
+- (void)testTypingCardNumber {
+    STPPaymentCardTextField *textField = [[STPPaymentCardTextField alloc] initWithFrame:CGRectMake(16, 100, 343, 44)];
+    [self.window addSubview:textField];
+    [textField layoutIfNeeded];
+    NSArray<NSString *> *numbers = @[@"4242424242424242", @"378282246310005", @"5555555555554444"];
+
+    [self measureFrames:^{
+        for (NSString *number in numbers) {
+            [textField clear];
+            STPFormTextField *numberField = textField.numberField;
+            for (NSUInteger i = 0; i < number.length; i++) {
+                NSString *digit = [number substringWithRange:NSMakeRange(i, 1)];
+                [self performFrame:^{
+                    NSRange range = NSMakeRange(numberField.text.length, 0);
+                    if ([numberField.delegate textField:numberField shouldChangeCharactersInRange:range replacementString:digit]) {
+                        [numberField insertText:digit];
+                    }
+                    [numberField sendActionsForControlEvents:UIControlEventEditingChanged];
+                    [textField layoutIfNeeded];
+                }];
+            }
+        }
+    }];
+}
+
+#pragma mark - Payment methods
+
+- (void)testScrollingPaymentMethods {
+    NSMutableArray<STPCard *> *cards = [NSMutableArray array];
+    NSArray<NSString *> *brands = @[@"Visa", @"MasterCard", @"American Express", @"Discover"];
+    for (NSUInteger i = 0; i < STPScrolledCardCount; i++) {
+        NSMutableDictionary *json = [[STPTestUtils jsonNamed:@"Card"] mutableCopy];
+        json[@"id"] = [NSString stringWithFormat:@"card_%lu", (unsigned long)i];
+        json[@"brand"] = brands[i % brands.count];
+        json[@"last4"] = [NSString stringWithFormat:@"%04lu", (unsigned long)i];
+        [cards addObject:[STPCard decodedObjectFromAPIResponse:json]];
+    }
+    [self measureScrollingPaymentMethodTuple:[STPPaymentMethodTuple tupleWithPaymentMethods:cards selectedPaymentMethod:cards.firstObject]];
+}
+
+- (void)testScrollingLargeWalletPaymentMethods {
+    STPCardTuple *cardTuple = [STPCardTuple tupleWithCustomer:[STPFixtures customerWithSourceCount:1000]];
+    [self measureScrollingPaymentMethodTuple:[STPPaymentMethodTuple tupleWithCardTuple:cardTuple applePayEnabled:NO]];
+}
+
+- (void)measureScrollingPaymentMethodTuple:(STPPaymentMethodTuple *)tuple {
+    STPPaymentMethodsInternalViewController *viewController = [[STPPaymentMethodsInternalViewController alloc] initWithConfiguration:[STPFixtures paymentConfiguration]
+                                                                                                                                theme:[STPTheme defaultTheme]
+                                                                                                                 prefilledInformation:nil
+                                                                                                                      shippingAddress:nil
+                                                                                                                   paymentMethodTuple:tuple
+                                                                                                                             delegate:OCMProtocolMock(@protocol(STPPaymentMethodsInternalViewControllerDelegate))];
+    self.window.rootViewController = viewController;
+    [viewController.view layoutIfNeeded];
+    UITableView *tableView = viewController.tableView;
+
+    [self measureFrames:^{
+        CGFloat maxOffset = MAX(tableView.contentSize.height - tableView.bounds.size.height, 0);
+        // Roughly a fast flick: 40pt per frame, down and back up
+        for (CGFloat offset = 0; offset <= maxOffset; offset += 40) {
+            [self performFrame:^{
+                tableView.contentOffset = CGPointMake(0, offset);
+                [tableView layoutIfNeeded];
+            }];
+        }
+        for (CGFloat offset = maxOffset; offset >= 0; offset -= 40) {
+            [self performFrame:^{
+                tableView.contentOffset = CGPointMake(0, offset);
+                [tableView layoutIfNeeded];
+            }];
+        }
+    }];
+}
+
+#pragma mark - Shipping address
+
+- (STPShippingAddressViewController *)buildShippingAddressViewController {
+    STPPaymentConfiguration *config = [STPFixtures paymentConfiguration];
+    config.requiredShippingAddressFields = PKAddressFieldAll;
+    return [[STPShippingAddressViewController alloc] initWithConfiguration:config
+                                                                     theme:[STPTheme defaultTheme]
+                                                                  currency:nil
+                                                           shippingAddress:nil
+                                                    selectedShippingMethod:nil
+                                                      prefilledInformation:nil];
+}
+
+- (void)testPushingShippingAddressViewController {
+    UINavigationController *navigationController = [[UINavigationController alloc] initWithRootViewController:[UIViewController new]];
+    self.window.rootViewController = navigationController;
+    [navigationController.view layoutIfNeeded];
+
+    [self measureFrames:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            [self performFrame:^{
+                [navigationController pushViewController:[self buildShippingAddressViewController] animated:NO];
+                [navigationController.view layoutIfNeeded];
+            }];
+            [navigationController popToRootViewControllerAnimated:NO];
+            [navigationController.view layoutIfNeeded];
+        }
+    }];
+}
+
+- (void)testChangingShippingCountry {
+    STPShippingAddressViewController *viewController = [self buildShippingAddressViewController];
+    UINavigationController *navigationController = [[UINavigationController alloc] initWithRootViewController:viewController];
+    self.window.rootViewController = navigationController;
+    [navigationController.view layoutIfNeeded];
+    // Ireland has no postal codes, so switching to and from it adds and
+    // removes a row.
+    NSArray<NSString *> *countries = @[@"US", @"GB", @"IE", @"JP", @"CA", @"IE"];
+
+    [self measureFrames:^{
+        for (NSString *country in countries) {
+            [self performFrame:^{
+                [viewController.addressViewModel setValue:country forKey:@"addressFieldTableViewCountryCode"];
+                [viewController.tableView layoutIfNeeded];
+            }];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,80 @@
+//
+//  STPURLCallbackHandlerTest.m
+//  Stripe
+//
+//  Created by Stripe on 10/14/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "STPURLCallbackHandler.h"
+
+@interface STPTestURLCallbackListener : NSObject <STPURLCallbackListener>
+@property (nonatomic) NSUInteger callCount;
+@end
+
+@implementation STPTestURLCallbackListener
+
+- (BOOL)handleURLCallback:(__unused NSURL *)url {
+    self.callCount++;
+    return YES;
+}
+
+@end
+
+@interface STPURLCallbackHandlerTest : XCTestCase
+
+@end
+
+@implementation STPURLCallbackHandlerTest
+
+- (void)testOnlyMatchingListenersAreCalled {
+    STPURLCallbackHandler *handler = [STPURLCallbackHandler new];
+    STPTestURLCallbackListener *redirectListener = [STPTestURLCallbackListener new];
+    STPTestURLCallbackListener *otherPathListener = [STPTestURLCallbackListener new];
+    STPTestURLCallbackListener *queryListener = [STPTestURLCallbackListener new];
+    [handler registerListener:redirectListener forURL:[NSURL URLWithString:@"foo://bar/redirect"]];
+    [handler registerListener:otherPathListener forURL:[NSURL URLWithString:@"foo://bar/other"]];
+    [handler registerListener:queryListener forURL:[NSURL URLWithString:@"foo://bar/redirect?source=src_123"]];
+
+    XCTAssertTrue([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect?source=src_456"]]);
+    XCTAssertEqual(redirectListener.callCount, 1U);
+    XCTAssertEqual(otherPathListener.callCount, 0U);
+    XCTAssertEqual(queryListener.callCount, 0U);
+
+    XCTAssertTrue([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect?source=src_123"]]);
+    XCTAssertEqual(redirectListener.callCount, 2U);
+    XCTAssertEqual(queryListener.callCount, 1U);
+
+    XCTAssertFalse([handler handleURLCallback:[NSURL URLWithString:@"foo://baz/redirect"]]);
+}
+
+- (void)testEveryRegisteredQueryItemMustMatch {
+    STPURLCallbackHandler *handler = [STPURLCallbackHandler new];
+    STPTestURLCallbackListener *listener = [STPTestURLCallbackListener new];
+    [handler registerListener:listener forURL:[NSURL URLWithString:@"foo://bar/redirect?source=src_123&client_secret=abc"]];
+
+    XCTAssertFalse([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect?source=src_123"]]);
+    XCTAssertFalse([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect?source=src_123&client_secret=def"]]);
+    XCTAssertTrue([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect?client_secret=abc&extra=1&source=src_123"]]);
+    XCTAssertEqual(listener.callCount, 1U);
+}
+
+- (void)testUnregisteredListenersAreNotCalled {
+    STPURLCallbackHandler *handler = [STPURLCallbackHandler new];
+    STPTestURLCallbackListener *listener = [STPTestURLCallbackListener new];
+    STPTestURLCallbackListener *otherListener = [STPTestURLCallbackListener new];
+    [handler registerListener:listener forURL:[NSURL URLWithString:@"foo://bar/redirect"]];
+    [handler registerListener:listener forURL:[NSURL URLWithString:@"foo://bar/other"]];
+    [handler registerListener:otherListener forURL:[NSURL URLWithString:@"foo://bar/redirect"]];
+
+    [handler unregisterListener:listener];
+
+    XCTAssertTrue([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/redirect"]]);
+    XCTAssertFalse([handler handleURLCallback:[NSURL URLWithString:@"foo://bar/other"]]);
+    XCTAssertEqual(listener.callCount, 0U);
+    XCTAssertEqual(otherListener.callCount, 1U);
+}
+
+@end
@@ -21,6 +21,11 @@
     XCTAssertNil(error);
 }
 
+- (void)testMalformedErrorResponse {
+    XCTAssertNil([NSError stp_errorFromStripeResponse:@{@"error": @"oops"}]);
+    XCTAssertNil([NSError stp_errorFromStripeResponse:(NSDictionary *)@[]]);
+}
+
 - (void)testResponseWithUnknownTypeAndNoMessage {
     NSDictionary *response = @{
                                @"error": @{
@@ -0,0 +1,71 @@
+#!/usr/bin/env ruby
+
+# Generates Stripe/STPBINRangeData.h from Stripe/STPBINRanges.csv, as a sorted
+# C array with duplicate ranges removed. Run with --check to fail instead if
+# the checked-in header is out of date.
+
+SOURCE = "Stripe/STPBINRanges.csv"
+HEADER = "Stripe/STPBINRangeData.h"
+BRANDS = %w(Visa Amex MasterCard Discover JCB DinersClub Unknown)
+MAX_PREFIX_LENGTH = 6
+
+ranges = File.readlines(SOURCE).each_with_index.map do |line, index|
+  line = line.strip
+  next if line.empty? || line.start_with?("#")
+  low, high, length, brand = line.split(",", -1)
+  location = "#{SOURCE}:#{index + 1}"
+  abort("#{location}: expected low,high,length,brand") if brand.nil?
+  abort("#{location}: prefixes must be digits of the same length") unless low =~ /\A\d*\z/ && high =~ /\A\d*\z/ && low.length == high.length
+  abort("#{location}: prefixes are limited to #{MAX_PREFIX_LENGTH} digits") if low.length > MAX_PREFIX_LENGTH
+  abort("#{location}: #{low} is above #{high}") if low.to_i > high.to_i
+  abort("#{location}: unknown brand #{brand}") unless BRANDS.include?(brand)
+  abort("#{location}: bad length #{length}") unless length =~ /\A\d+\z/
+  { prefix_length: low.length, low: low.to_i, high: high.to_i, length: length.to_i, brand: brand }
+end.compact
+
+duplicates = ranges.length - ranges.uniq.length
+ranges = ranges.uniq.sort_by { |r| [r[:prefix_length], r[:low], r[:high], r[:length], BRANDS.index(r[:brand])] }
+abort("#{SOURCE}: the catch-all range (an empty prefix) is missing") unless ranges.count { |r| r[:prefix_length] == 0 } == 1
+
+rows = ranges.map do |r|
+  "    {#{r[:prefix_length]}, #{r[:low]}, #{r[:high]}, #{r[:length]}, STPCardBrand#{r[:brand]}},"
+end
+
+header = <<-HEADER
+//
+//  STPBINRangeData.h
+//  Stripe
+//
+//  Generated by ci_scripts/generate_bin_ranges.rb from STPBINRanges.csv.
+//  Do not edit.
+//
+
+#import "STPCardBrand.h"
+
+/**
+ A built-in BIN range in integer form. Sorted by prefix length, then bounds,
+ so the catch-all comes first.
+ */
+typedef struct {
+    uint8_t prefixLength;
+    uint32_t low;
+    uint32_t high;
+    uint8_t length;
+    STPCardBrand brand;
+} STPBINRangeData;
+
+static const STPBINRangeData STPBINRangeBuiltInData[] = {
+#{rows.join("\n")}
+};
+HEADER
+
+if ARGV.include?("--check")
+  puts "Checking BIN ranges..."
+  unless File.exist?(HEADER) && File.read(HEADER) == header
+    abort("#{HEADER} is out of date. Run ./ci_scripts/generate_bin_ranges.rb and commit the result.")
+  end
+  puts "BIN ranges look good!"
+else
+  File.write(HEADER, header)
+  puts "Wrote #{ranges.length} ranges to #{HEADER}" + (duplicates > 0 ? ", skipping #{duplicates} duplicate(s)" : "")
+end
@@ -0,0 +1,194 @@
+#!/usr/bin/env ruby
+
+# Packs the card brand images in Stripe/BrandImages into one atlas per scale,
+# Stripe/Resources/Images/stp_card_brands{,@2x,@3x}.png, and writes where each
+# image is in the atlas to Stripe/STPImageAtlasData.h. Run with --check to fail
+# instead if the checked-in atlas or header is out of date.
+
+require 'zlib'
+
+SOURCE = "Stripe/BrandImages"
+ATLAS_NAME = "stp_card_brands"
+ATLAS_DIRECTORY = "Stripe/Resources/Images"
+HEADER = "Stripe/STPImageAtlasData.h"
+SCALES = [1, 2, 3]
+PNG_SIGNATURE = "\x89PNG\r\n\x1a\n".b
+
+# Decodes an 8-bit, non-interlaced PNG to rows of RGBA bytes.
+def read_png(path)
+  data = File.binread(path)
+  abort("#{path}: not a PNG") unless data.start_with?(PNG_SIGNATURE)
+  offset = PNG_SIGNATURE.length
+  header = nil
+  palette = nil
+  alphas = "".b
+  compressed = "".b
+  while offset < data.length
+    length, type = data[offset, 8].unpack("Na4")
+    body = data[offset + 8, length]
+    offset += length + 12
+    case type
+    when "IHDR" then header = body.unpack("NNCCCCC")
+    when "PLTE" then palette = body.bytes.each_slice(3).to_a
+    when "tRNS" then alphas = body
+    when "IDAT" then compressed << body
+    when "IEND" then break
+    end
+  end
+  width, height, depth, color_type, _, _, interlace = header
+  abort("#{path}: only 8-bit images are supported") unless depth == 8
+  abort("#{path}: interlaced images aren't supported") unless interlace == 0
+  channels = { 3 => 1, 6 => 4 }[color_type] or abort("#{path}: only palette and RGBA images are supported")
+
+  raw = Zlib::Inflate.inflate(compressed).bytes
+  stride = width * channels
+  previous = Array.new(stride, 0)
+  rows = (0...height).map do |y|
+    filter = raw[y * (stride + 1)]
+    row = raw[y * (stride + 1) + 1, stride]
+    row.each_index do |i|
+      left = i >= channels ? row[i - channels] : 0
+      up = previous[i]
+      upper_left = i >= channels ? previous[i - channels] : 0
+      predictor = case filter
+                  when 0 then 0
+                  when 1 then left
+                  when 2 then up
+                  when 3 then (left + up) / 2
+                  when 4 then paeth(left, up, upper_left)
+                  else abort("#{path}: bad filter #{filter}")
+                  end
+      row[i] = (row[i] + predictor) & 0xff
+    end
+    previous = row
+    if channels == 1
+      row.flat_map { |index| palette[index] + [index < alphas.bytesize ? alphas.getbyte(index) : 255] }
+    else
+      row
+    end
+  end
+  { width: width, height: height, rows: rows }
+end
+
+def paeth(a, b, c)
+  p = a + b - c
+  pa = (p - a).abs
+  pb = (p - b).abs
+  pc = (p - c).abs
+  return a if pa <= pb && pa <= pc
+  pb <= pc ? b : c
+end
+
+def chunk(type, body)
+  [body.bytesize].pack("N") + type + body + [Zlib.crc32(type + body)].pack("N")
+end
+
+# Encodes rows of RGBA bytes, picking each row's filter by the usual minimum
+# sum of absolute differences heuristic.
+def write_png(width, rows)
+  stride = width * 4
+  previous = Array.new(stride, 0)
+  raw = "".b
+  rows.each do |row|
+    candidates = (0..4).map do |filter|
+      filtered = row.each_index.map do |i|
+        left = i >= 4 ? row[i - 4] : 0
+        up = previous[i]
+        upper_left = i >= 4 ? previous[i - 4] : 0
+        predictor = [0, left, up, (left + up) / 2, paeth(left, up, upper_left)][filter]
+        (row[i] - predictor) & 0xff
+      end
+      [filter, filtered]
+    end
+    filter, filtered = candidates.min_by { |_, bytes| bytes.sum { |b| b < 128 ? b : 256 - b } }
+    raw << filter.chr << filtered.pack("C*")
+    previous = row
+  end
+  PNG_SIGNATURE +
+    chunk("IHDR", [width, rows.length, 8, 6, 0, 0, 0].pack("NNCCCCC")) +
+    chunk("IDAT", Zlib::Deflate.deflate(raw, Zlib::BEST_COMPRESSION)) +
+    chunk("IEND", "")
+end
+
+names = Dir.glob("#{SOURCE}/*.png").map { |path| File.basename(path, ".png").sub(/@\dx\z/, "") }.uniq.sort
+abort("#{SOURCE}: no images") if names.empty?
+
+images = names.map do |name|
+  scaled = SCALES.map do |scale|
+    path = "#{SOURCE}/#{name}#{scale == 1 ? "" : "@#{scale}x"}.png"
+    abort("#{path} is missing") unless File.exist?(path)
+    read_png(path)
+  end
+  base = scaled.first
+  scaled.each_with_index do |image, index|
+    scale = SCALES[index]
+    unless image[:width] == base[:width] * scale && image[:height] == base[:height] * scale
+      abort("#{SOURCE}/#{name}@#{scale}x.png isn't #{scale} times the size of #{name}.png")
+    end
+  end
+  { name: name, width: base[:width], height: base[:height], scaled: scaled }
+end
+
+# Stacked top to bottom, so each image's frame is the same in points at every
+# scale.
+atlas_width = images.map { |image| image[:width] }.max
+y = 0
+images.each do |image|
+  image[:y] = y
+  y += image[:height]
+end
+
+atlases = SCALES.each_with_index.map do |scale, index|
+  rows = []
+  images.each do |image|
+    image[:scaled][index][:rows].each do |row|
+      rows << row + Array.new((atlas_width * scale * 4) - row.length, 0)
+    end
+  end
+  ["#{ATLAS_DIRECTORY}/#{ATLAS_NAME}#{scale == 1 ? "" : "@#{scale}x"}.png", write_png(atlas_width * scale, rows)]
+end
+
+entries = images.map do |image|
+  "    {\"#{image[:name]}\", {{0, #{image[:y]}}, {#{image[:width]}, #{image[:height]}}}},"
+end
+
+header = <<-HEADER
+//
+//  STPImageAtlasData.h
+//  Stripe
+//
+//  Generated by ci_scripts/generate_brand_atlas.rb from Stripe/BrandImages.
+//  Do not edit.
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+
+static NSString * const STPImageAtlasName = @"#{ATLAS_NAME}";
+
+/**
+ Where an image is in the atlas, in points.
+ */
+typedef struct {
+    const char *name;
+    CGRect frame;
+} STPImageAtlasEntry;
+
+// Sorted by name
+static const STPImageAtlasEntry STPImageAtlasEntries[] = {
+#{entries.join("\n")}
+};
+HEADER
+
+if ARGV.include?("--check")
+  puts "Checking brand image atlas..."
+  outputs = atlases + [[HEADER, header]]
+  stale = outputs.select { |path, contents| !File.exist?(path) || File.binread(path) != contents.b }
+  unless stale.empty?
+    abort("#{stale.map(&:first).join(", ")} out of date. Run ./ci_scripts/generate_brand_atlas.rb and commit the result.")
+  end
+  puts "Brand image atlas looks good!"
+else
+  atlases.each { |path, contents| File.binwrite(path, contents) }
+  File.write(HEADER, header)
+  puts "Packed #{images.length} images into #{ATLAS_DIRECTORY}/#{ATLAS_NAME}.png"
+end